@@ -0,0 +1,473 @@
+/***********************************************************************************************************************************
+Archive WAL Bundle
+***********************************************************************************************************************************/
+#include "build.auto.h"
+
+#include <string.h>
+
+#include "command/archive/bundle.h"
+#include "command/archive/common.h"
+#include "common/debug.h"
+#include "common/io/io.h"
+#include "common/log.h"
+#include "common/memContext.h"
+#include "common/type/pack.h"
+#include "storage/helper.h"
+
+/***********************************************************************************************************************************
+Bundle constants
+***********************************************************************************************************************************/
+STRING_EXTERN(WAL_SEGMENT_BUNDLE_FILE_REGEXP_STR,                   WAL_SEGMENT_BUNDLE_FILE_REGEXP);
+
+// Bundle format version
+#define WAL_BUNDLE_FORMAT                                           2U
+
+// Size of the footer that stores the size of the index
+#define WAL_BUNDLE_FOOTER_SIZE                                      4
+
+// Size of the first read of a bundle index. This is large enough to read the index of most bundles in a single request.
+#define WAL_BUNDLE_INDEX_READ                                       65536
+
+// Maximum bundle indexes to cache
+#define WAL_BUNDLE_CACHE_MAX                                        64
+
+/***********************************************************************************************************************************
+Cache of bundle indexes
+***********************************************************************************************************************************/
+typedef struct WalBundleCache
+{
+    const Storage *storage;                                         // Storage the bundle was read from
+    String *file;                                                   // Bundle path/file
+    List *fileList;                                                 // Files stored in the bundle
+} WalBundleCache;
+
+static struct WalBundleLocal
+{
+    List *cacheList;                                                // Bundle indexes read by this process
+} walBundleLocal;
+
+/**********************************************************************************************************************************/
+FN_EXTERN bool
+walIsBundle(const String *const file)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(STRING, file);
+    FUNCTION_TEST_END();
+
+    ASSERT(file != NULL);
+
+    FUNCTION_TEST_RETURN(BOOL, strEndsWithZ(file, WAL_BUNDLE_EXT));
+}
+
+/**********************************************************************************************************************************/
+FN_EXTERN String *
+walBundleName(const String *const walSegmentFirst, const String *const walSegmentLast)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(STRING, walSegmentFirst);
+        FUNCTION_TEST_PARAM(STRING, walSegmentLast);
+    FUNCTION_TEST_END();
+
+    ASSERT(walSegmentFirst != NULL);
+    ASSERT(walSegmentLast != NULL);
+    ASSERT(strncmp(strZ(walSegmentFirst), strZ(walSegmentLast), 16) == 0);
+
+    FUNCTION_TEST_RETURN(STRING, strNewFmt("%s-%s" WAL_BUNDLE_EXT, strZ(walSegmentFirst), strZ(walSegmentLast)));
+}
+
+/**********************************************************************************************************************************/
+FN_EXTERN String *
+walBundleSegmentLast(const String *const file)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(STRING, file);
+    FUNCTION_TEST_END();
+
+    ASSERT(file != NULL);
+
+    FUNCTION_TEST_RETURN(
+        STRING, strSubN(file, walIsBundle(file) ? WAL_SEGMENT_NAME_SIZE + 1 : 0, WAL_SEGMENT_NAME_SIZE));
+}
+
+/***********************************************************************************************************************************
+Read a bundle index
+***********************************************************************************************************************************/
+static List *
+walBundleIndexRead(const Storage *const storage, const String *const file)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(STORAGE, storage);
+        FUNCTION_LOG_PARAM(STRING, file);
+    FUNCTION_LOG_END();
+
+    ASSERT(storage != NULL);
+    ASSERT(file != NULL);
+
+    List *const result = lstNewP(sizeof(WalBundleFile), .comparator = lstComparatorStr);
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        // Get the bundle size since the index is stored at the end of the bundle
+        const uint64_t bundleSize = storageInfoP(storage, file).size;
+
+        if (bundleSize < WAL_BUNDLE_FOOTER_SIZE)
+            THROW_FMT(FormatError, "bundle '%s' is missing the index footer", strZ(file));
+
+        // Read the footer and as much of the index as fits in the first read
+        const uint64_t readSize = bundleSize < WAL_BUNDLE_INDEX_READ ? bundleSize : WAL_BUNDLE_INDEX_READ;
+        const Buffer *buffer = storageGetP(
+            storageNewReadP(storage, file, .offset = bundleSize - readSize, .limit = VARUINT64(readSize)),
+            .exactSize = (size_t)readSize);
+
+        const unsigned char *const footer = bufPtrConst(buffer) + bufUsed(buffer) - WAL_BUNDLE_FOOTER_SIZE;
+        const size_t indexSize =
+            (size_t)footer[0] << 24 | (size_t)footer[1] << 16 | (size_t)footer[2] << 8 | (size_t)footer[3];
+
+        if (indexSize > bundleSize - WAL_BUNDLE_FOOTER_SIZE)
+            THROW_FMT(FormatError, "bundle '%s' has an index larger than the bundle", strZ(file));
+
+        const unsigned char *index = footer - indexSize;
+
+        // Read the rest of the index if it did not fit in the first read
+        if (readSize - WAL_BUNDLE_FOOTER_SIZE < indexSize)
+        {
+            buffer = storageGetP(
+                storageNewReadP(
+                    storage, file, .offset = bundleSize - WAL_BUNDLE_FOOTER_SIZE - indexSize, .limit = VARUINT64(indexSize)),
+                .exactSize = indexSize);
+            index = bufPtrConst(buffer);
+        }
+
+        // Read the index. Segments are stored in the order of the index starting at the beginning of the bundle.
+        PackRead *const pack = pckReadNewC(index, indexSize);
+        const unsigned int format = pckReadU32P(pack);
+
+        if (format != WAL_BUNDLE_FORMAT)
+            THROW_FMT(FormatError, "bundle '%s' has format %u but %u is required", strZ(file), format, WAL_BUNDLE_FORMAT);
+
+        const String *const bundle = strBase(file);
+        uint64_t offset = 0;
+
+        pckReadArrayBeginP(pack);
+
+        while (!pckReadNullP(pack))
+        {
+            pckReadObjBeginP(pack);
+
+            MEM_CONTEXT_BEGIN(lstMemContext(result))
+            {
+                WalBundleFile bundleFile = {.name = pckReadStrP(pack), .bundle = strDup(bundle), .offset = offset};
+                bundleFile.size = pckReadU64P(pack);
+
+                lstAdd(result, &bundleFile);
+                offset += bundleFile.size;
+            }
+            MEM_CONTEXT_END();
+
+            pckReadObjEndP(pack);
+        }
+
+        pckReadArrayEndP(pack);
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_LOG_RETURN(LIST, result);
+}
+
+/**********************************************************************************************************************************/
+FN_EXTERN const List *
+walBundleIndex(const Storage *const storage, const String *const path, const String *const bundle)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(STORAGE, storage);
+        FUNCTION_LOG_PARAM(STRING, path);
+        FUNCTION_LOG_PARAM(STRING, bundle);
+    FUNCTION_LOG_END();
+
+    ASSERT(storage != NULL);
+    ASSERT(path != NULL);
+    ASSERT(bundle != NULL);
+
+    const List *result = NULL;
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        const String *const file = strNewFmt("%s/%s", strZ(path), strZ(bundle));
+
+        // Check the cache
+        if (walBundleLocal.cacheList != NULL)
+        {
+            for (unsigned int cacheIdx = 0; cacheIdx < lstSize(walBundleLocal.cacheList); cacheIdx++)
+            {
+                const WalBundleCache *const cache = lstGet(walBundleLocal.cacheList, cacheIdx);
+
+                if (cache->storage == storage && strEq(cache->file, file))
+                {
+                    result = cache->fileList;
+                    break;
+                }
+            }
+        }
+        else
+        {
+            MEM_CONTEXT_BEGIN(memContextTop())
+            {
+                walBundleLocal.cacheList = lstNewP(sizeof(WalBundleCache));
+            }
+            MEM_CONTEXT_END();
+        }
+
+        // Else read the index from the repo
+        if (result == NULL)
+        {
+            // Remove the oldest index when the cache is full
+            if (lstSize(walBundleLocal.cacheList) == WAL_BUNDLE_CACHE_MAX)
+            {
+                WalBundleCache *const cache = lstGet(walBundleLocal.cacheList, 0);
+
+                strFree(cache->file);
+                lstFree(cache->fileList);
+                lstRemoveIdx(walBundleLocal.cacheList, 0);
+            }
+
+            MEM_CONTEXT_BEGIN(lstMemContext(walBundleLocal.cacheList))
+            {
+                const WalBundleCache cache =
+                {
+                    .storage = storage,
+                    .file = strDup(file),
+                    .fileList = walBundleIndexRead(storage, file),
+                };
+
+                lstAdd(walBundleLocal.cacheList, &cache);
+                result = cache.fileList;
+            }
+            MEM_CONTEXT_END();
+        }
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_LOG_RETURN_CONST(LIST, result);
+}
+
+/**********************************************************************************************************************************/
+FN_EXTERN const WalBundleFile *
+walBundleFind(
+    const Storage *const storage, const String *const path, const StringList *const fileList, const String *const walSegment)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(STORAGE, storage);
+        FUNCTION_LOG_PARAM(STRING, path);
+        FUNCTION_LOG_PARAM(STRING_LIST, fileList);
+        FUNCTION_LOG_PARAM(STRING, walSegment);
+    FUNCTION_LOG_END();
+
+    ASSERT(storage != NULL);
+    ASSERT(path != NULL);
+    ASSERT(fileList != NULL);
+    ASSERT(walSegment != NULL);
+
+    const WalBundleFile *result = NULL;
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        // Partial segments are never stored in bundles
+        if (!walIsPartial(walSegment))
+        {
+            const String *const segment = strSubN(walSegment, 0, WAL_SEGMENT_NAME_SIZE);
+            const String *const segmentPrefix = strNewFmt("%s-", strZ(segment));
+
+            for (unsigned int fileIdx = 0; fileIdx < strLstSize(fileList); fileIdx++)
+            {
+                const String *const file = strLstGet(fileList, fileIdx);
+
+                // Only search bundles with a range that includes the segment
+                if (!walIsBundle(file) || strCmp(strSubN(file, 0, WAL_SEGMENT_NAME_SIZE), segment) > 0 ||
+                    strCmp(walBundleSegmentLast(file), segment) < 0)
+                {
+                    continue;
+                }
+
+                const List *const bundleFileList = walBundleIndex(storage, path, file);
+
+                for (unsigned int bundleFileIdx = 0; bundleFileIdx < lstSize(bundleFileList); bundleFileIdx++)
+                {
+                    const WalBundleFile *const bundleFile = lstGet(bundleFileList, bundleFileIdx);
+
+                    if (strBeginsWith(bundleFile->name, segmentPrefix))
+                    {
+                        result = bundleFile;
+                        break;
+                    }
+                }
+
+                if (result != NULL)
+                    break;
+            }
+        }
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_LOG_RETURN_CONST_P(VOID, result);
+}
+
+/**********************************************************************************************************************************/
+FN_EXTERN List *
+walBundleList(const Storage *const storage, const String *const path, const StringList *const fileList)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(STORAGE, storage);
+        FUNCTION_LOG_PARAM(STRING, path);
+        FUNCTION_LOG_PARAM(STRING_LIST, fileList);
+    FUNCTION_LOG_END();
+
+    ASSERT(storage != NULL);
+    ASSERT(path != NULL);
+    ASSERT(fileList != NULL);
+
+    List *const result = lstNewP(sizeof(WalBundleFile), .comparator = lstComparatorStr);
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        for (unsigned int fileIdx = 0; fileIdx < strLstSize(fileList); fileIdx++)
+        {
+            const String *const file = strLstGet(fileList, fileIdx);
+
+            if (walIsBundle(file))
+            {
+                const List *const bundleFileList = walBundleIndex(storage, path, file);
+
+                MEM_CONTEXT_BEGIN(lstMemContext(result))
+                {
+                    for (unsigned int bundleFileIdx = 0; bundleFileIdx < lstSize(bundleFileList); bundleFileIdx++)
+                    {
+                        const WalBundleFile *const bundleFile = lstGet(bundleFileList, bundleFileIdx);
+                        const WalBundleFile bundleFileCopy =
+                        {
+                            .name = strDup(bundleFile->name),
+                            .bundle = strDup(bundleFile->bundle),
+                            .offset = bundleFile->offset,
+                            .size = bundleFile->size,
+                        };
+
+                        lstAdd(result, &bundleFileCopy);
+                    }
+                }
+                MEM_CONTEXT_END();
+            }
+        }
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_LOG_RETURN(LIST, lstSort(result, sortOrderAsc));
+}
+
+/**********************************************************************************************************************************/
+FN_EXTERN StorageRead *
+walBundleReadNew(const Storage *const storage, const String *const path, const WalBundleFile *const file, const bool compressible)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(STORAGE, storage);
+        FUNCTION_LOG_PARAM(STRING, path);
+        FUNCTION_LOG_PARAM_P(VOID, file);
+        FUNCTION_LOG_PARAM(BOOL, compressible);
+    FUNCTION_LOG_END();
+
+    ASSERT(storage != NULL);
+    ASSERT(path != NULL);
+    ASSERT(file != NULL);
+
+    StorageRead *result;
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        const String *const bundleFile = strNewFmt("%s/%s", strZ(path), strZ(file->bundle));
+        const Variant *const limit = varNewUInt64(file->size);
+
+        MEM_CONTEXT_PRIOR_BEGIN()
+        {
+            result = storageNewReadP(storage, bundleFile, .offset = file->offset, .limit = limit, .compressible = compressible);
+        }
+        MEM_CONTEXT_PRIOR_END();
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_LOG_RETURN(STORAGE_READ, result);
+}
+
+/**********************************************************************************************************************************/
+FN_EXTERN void
+walBundleWrite(IoWrite *const write, const StringList *const nameList, const List *const readList)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(IO_WRITE, write);
+        FUNCTION_LOG_PARAM(STRING_LIST, nameList);
+        FUNCTION_LOG_PARAM(LIST, readList);
+    FUNCTION_LOG_END();
+
+    ASSERT(write != NULL);
+    ASSERT(nameList != NULL);
+    ASSERT(readList != NULL);
+    ASSERT(strLstSize(nameList) == lstSize(readList));
+    ASSERT(!strLstEmpty(nameList));
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        PackWrite *const pack = pckWriteNewP();
+
+        pckWriteU32P(pack, WAL_BUNDLE_FORMAT);
+        pckWriteArrayBeginP(pack);
+
+        // Copy each segment into the bundle and add it to the index. Only one segment is open at a time and it is copied a buffer
+        // at a time so memory usage does not depend on the size or number of segments.
+        Buffer *const buffer = bufNew(ioBufferSize());
+
+        ioWriteOpen(write);
+
+        for (unsigned int readIdx = 0; readIdx < lstSize(readList); readIdx++)
+        {
+            IoRead *const read = *(IoRead **)lstGet(readList, readIdx);
+            uint64_t size = 0;
+
+            ioReadOpen(read);
+
+            do
+            {
+                ioRead(read, buffer);
+                ioWrite(write, buffer);
+
+                size += bufUsed(buffer);
+                bufUsedZero(buffer);
+            }
+            while (!ioReadEof(read));
+
+            ioReadClose(read);
+
+            pckWriteObjBeginP(pack);
+            pckWriteStrP(pack, strLstGet(nameList, readIdx));
+            pckWriteU64P(pack, size);
+            pckWriteObjEndP(pack);
+        }
+
+        pckWriteArrayEndP(pack);
+        pckWriteEndP(pack);
+
+        // Write the index and the footer with the index size
+        const Buffer *const index = pckToBuf(pckWriteResult(pack));
+        const size_t indexSize = bufUsed(index);
+        Buffer *const footer = bufNew(WAL_BUNDLE_FOOTER_SIZE);
+
+        bufPtr(footer)[0] = (unsigned char)(indexSize >> 24);
+        bufPtr(footer)[1] = (unsigned char)(indexSize >> 16);
+        bufPtr(footer)[2] = (unsigned char)(indexSize >> 8);
+        bufPtr(footer)[3] = (unsigned char)indexSize;
+        bufUsedSet(footer, WAL_BUNDLE_FOOTER_SIZE);
+
+        ioWrite(write, index);
+        ioWrite(write, footer);
+        ioWriteClose(write);
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_LOG_RETURN_VOID();
+}
@@ -0,0 +1,77 @@
+/***********************************************************************************************************************************
+Archive WAL Bundle
+
+A bundle stores several WAL segments from the same WAL path in a single repository file to reduce the number of requests made to
+object stores. Each segment is stored exactly as it would be outside a bundle (compressed and encrypted with the archive settings)
+and the segments are followed by an index of the file names (segment, checksum, and extension) and sizes of the stored segments.
+The index is at the end so segments can be streamed into the bundle without knowing their stored sizes in advance. The last four
+bytes of the bundle store the size of the index. The bundle is named for the first and last segment it contains so the segments it
+may contain are known from a listing.
+
+The index is not encrypted since it contains only the names that would be visible in a listing if the segments were not bundled.
+***********************************************************************************************************************************/
+#ifndef COMMAND_ARCHIVE_BUNDLE_H
+#define COMMAND_ARCHIVE_BUNDLE_H
+
+#include "common/compress/helper.h"
+#include "common/io/write.h"
+#include "common/type/list.h"
+#include "common/type/string.h"
+#include "storage/storage.h"
+
+/***********************************************************************************************************************************
+Bundle constants
+***********************************************************************************************************************************/
+#define WAL_BUNDLE_EXT                                              ".bundle"
+
+// Match on a bundle
+#define WAL_BUNDLE_REGEXP                                           "^[0-F]{24}-[0-F]{24}\\" WAL_BUNDLE_EXT "$"
+
+// Match on a WAL segment or a bundle
+#define WAL_SEGMENT_BUNDLE_FILE_REGEXP                                                                                             \
+    "^[0-F]{24}-([0-f]{40}" COMPRESS_TYPE_REGEXP "{0,1}|[0-F]{24}\\" WAL_BUNDLE_EXT ")$"
+STRING_DECLARE(WAL_SEGMENT_BUNDLE_FILE_REGEXP_STR);
+
+/***********************************************************************************************************************************
+File stored in a bundle
+***********************************************************************************************************************************/
+typedef struct WalBundleFile
+{
+    const String *name;                                             // File name the segment would have outside a bundle
+    const String *bundle;                                           // Bundle the segment is stored in
+    uint64_t offset;                                                // Offset of the segment in the bundle
+    uint64_t size;                                                  // Size of the segment in the bundle
+} WalBundleFile;
+
+/***********************************************************************************************************************************
+Functions
+***********************************************************************************************************************************/
+// Is the file a bundle?
+FN_EXTERN bool walIsBundle(const String *file);
+
+// Bundle name for the first and last segments stored in it
+FN_EXTERN String *walBundleName(const String *walSegmentFirst, const String *walSegmentLast);
+
+// Last segment of a WAL file. This is the segment itself unless the file is a bundle.
+FN_EXTERN String *walBundleSegmentLast(const String *file);
+
+// Get the files stored in a bundle. Indexes are cached since bundles are never modified after they are written so the result is
+// only valid until the next call.
+FN_EXTERN const List *walBundleIndex(const Storage *storage, const String *path, const String *bundle);
+
+// Find a WAL segment in the bundles of a path listing. Files that are not bundles are ignored. Returns NULL when the segment is not
+// stored in a bundle. The result is only valid until the next call.
+FN_EXTERN const WalBundleFile *walBundleFind(
+    const Storage *storage, const String *path, const StringList *fileList, const String *walSegment);
+
+// Get the files stored in the bundles of a path listing. Files that are not bundles are ignored.
+FN_EXTERN List *walBundleList(const Storage *storage, const String *path, const StringList *fileList);
+
+// Open a file stored in a bundle for read
+FN_EXTERN StorageRead *walBundleReadNew(const Storage *storage, const String *path, const WalBundleFile *file, bool compressible);
+
+// Write a bundle. Each read (IoRead *) provides a segment as it would be stored outside a bundle, i.e. with compression and
+// encryption filters, and is stored with the name at the same index. Reads are opened and copied one at a time.
+FN_EXTERN void walBundleWrite(IoWrite *write, const StringList *nameList, const List *readList);
+
+#endif
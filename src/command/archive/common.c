@@ -10,6 +10,7 @@ Archive Common
 #include <unistd.h>
 
 #include "command/archive/common.h"
+#include "common/crypto/cipherBlock.h"
 #include "common/debug.h"
 #include "common/fork.h"
 #include "common/log.h"
@@ -40,6 +41,21 @@ STRING_STATIC(STATUS_FILE_GLOBAL_STR,                               STATUS_FILE_
 #define STATUS_FILE_GLOBAL_ERROR                                    STATUS_FILE_GLOBAL STATUS_EXT_ERROR
 STRING_STATIC(STATUS_FILE_GLOBAL_ERROR_STR,                         STATUS_FILE_GLOBAL_ERROR);
 
+/***********************************************************************************************************************************
+Cache of compression dictionaries
+***********************************************************************************************************************************/
+typedef struct ArchiveDictCache
+{
+    unsigned int repoIdx;                                           // Repo idx
+    const String *archiveId;                                        // Archive id
+    const Buffer *dict;                                             // Dictionary (NULL if the archive id does not have one)
+} ArchiveDictCache;
+
+static struct ArchiveDictLocal
+{
+    List *cacheList;                                                // Dictionaries read or written by this process
+} archiveDictLocal;
+
 /***********************************************************************************************************************************
 Get the correct spool queue based on the archive mode
 ***********************************************************************************************************************************/
@@ -293,6 +309,146 @@ archiveAsyncExec(const ArchiveMode archiveMode, const StringList *const commandE
     FUNCTION_LOG_RETURN_VOID();
 }
 
+/***********************************************************************************************************************************
+Add a dictionary to the cache
+***********************************************************************************************************************************/
+static const Buffer *
+archiveDictCacheAdd(const unsigned int repoIdx, const String *const archiveId, const Buffer *const dict)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(UINT, repoIdx);
+        FUNCTION_TEST_PARAM(STRING, archiveId);
+        FUNCTION_TEST_PARAM(BUFFER, dict);
+    FUNCTION_TEST_END();
+
+    ASSERT(archiveId != NULL);
+
+    if (archiveDictLocal.cacheList == NULL)
+    {
+        MEM_CONTEXT_BEGIN(memContextTop())
+        {
+            archiveDictLocal.cacheList = lstNewP(sizeof(ArchiveDictCache));
+        }
+        MEM_CONTEXT_END();
+    }
+
+    const Buffer *result;
+
+    MEM_CONTEXT_BEGIN(lstMemContext(archiveDictLocal.cacheList))
+    {
+        const ArchiveDictCache cache =
+        {
+            .repoIdx = repoIdx,
+            .archiveId = strDup(archiveId),
+            .dict = dict == NULL ? NULL : bufDup(dict),
+        };
+
+        lstAdd(archiveDictLocal.cacheList, &cache);
+        result = cache.dict;
+    }
+    MEM_CONTEXT_END();
+
+    FUNCTION_TEST_RETURN_CONST(BUFFER, result);
+}
+
+/**********************************************************************************************************************************/
+FN_EXTERN const Buffer *
+archiveDictGet(
+    const unsigned int repoIdx, const String *const archiveId, const CipherType cipherType, const String *const cipherPass)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(UINT, repoIdx);
+        FUNCTION_LOG_PARAM(STRING, archiveId);
+        FUNCTION_LOG_PARAM(STRING_ID, cipherType);
+        FUNCTION_TEST_PARAM(STRING, cipherPass);                    // Use FUNCTION_TEST so passphrase is not logged
+    FUNCTION_LOG_END();
+
+    ASSERT(archiveId != NULL);
+
+    const Buffer *result = NULL;
+    bool found = false;
+
+    // Check the cache
+    if (archiveDictLocal.cacheList != NULL)
+    {
+        for (unsigned int cacheIdx = 0; cacheIdx < lstSize(archiveDictLocal.cacheList); cacheIdx++)
+        {
+            const ArchiveDictCache *const cache = lstGet(archiveDictLocal.cacheList, cacheIdx);
+
+            if (cache->repoIdx == repoIdx && strEq(cache->archiveId, archiveId))
+            {
+                result = cache->dict;
+                found = true;
+                break;
+            }
+        }
+    }
+
+    // Else read the dictionary from the repo
+    if (!found)
+    {
+        MEM_CONTEXT_TEMP_BEGIN()
+        {
+            StorageRead *const read = storageNewReadP(
+                storageRepoIdx(repoIdx), strNewFmt(STORAGE_REPO_ARCHIVE "/%s/" ARCHIVE_DICT_FILE, strZ(archiveId)),
+                .ignoreMissing = true);
+            cipherBlockFilterGroupAdd(ioReadFilterGroup(storageReadIo(read)), cipherType, cipherModeDecrypt, cipherPass);
+
+            result = archiveDictCacheAdd(repoIdx, archiveId, storageGetP(read));
+        }
+        MEM_CONTEXT_TEMP_END();
+    }
+
+    FUNCTION_LOG_RETURN_CONST(BUFFER, result);
+}
+
+/**********************************************************************************************************************************/
+FN_EXTERN void
+archiveDictPut(
+    const unsigned int repoIdx, const String *const archiveId, const CipherType cipherType, const String *const cipherPass,
+    const Buffer *const dict)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(UINT, repoIdx);
+        FUNCTION_LOG_PARAM(STRING, archiveId);
+        FUNCTION_LOG_PARAM(STRING_ID, cipherType);
+        FUNCTION_TEST_PARAM(STRING, cipherPass);                    // Use FUNCTION_TEST so passphrase is not logged
+        FUNCTION_LOG_PARAM(BUFFER, dict);
+    FUNCTION_LOG_END();
+
+    ASSERT(archiveId != NULL);
+    ASSERT(dict != NULL);
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        StorageWrite *const write = storageNewWriteP(
+            storageRepoIdxWrite(repoIdx), strNewFmt(STORAGE_REPO_ARCHIVE "/%s/" ARCHIVE_DICT_FILE, strZ(archiveId)));
+        cipherBlockFilterGroupAdd(ioWriteFilterGroup(storageWriteIo(write)), cipherType, cipherModeEncrypt, cipherPass);
+
+        storagePutP(write, dict);
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    // Replace any cached result for the archive id
+    if (archiveDictLocal.cacheList != NULL)
+    {
+        for (unsigned int cacheIdx = 0; cacheIdx < lstSize(archiveDictLocal.cacheList); cacheIdx++)
+        {
+            const ArchiveDictCache *const cache = lstGet(archiveDictLocal.cacheList, cacheIdx);
+
+            if (cache->repoIdx == repoIdx && strEq(cache->archiveId, archiveId))
+            {
+                lstRemoveIdx(archiveDictLocal.cacheList, cacheIdx);
+                break;
+            }
+        }
+    }
+
+    archiveDictCacheAdd(repoIdx, archiveId, dict);
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
 /**********************************************************************************************************************************/
 FN_EXTERN int
 archiveIdComparator(const void *const archiveId1, const void *const archiveId2)
@@ -20,6 +20,7 @@ typedef enum
 } ArchiveMode;
 
 #include "common/compress/helper.h"
+#include "common/crypto/common.h"
 #include "common/type/stringList.h"
 #include "storage/storage.h"
 
@@ -62,9 +63,25 @@ STRING_DECLARE(WAL_SEGMENT_FILE_REGEXP_STR);
 #define WAL_TIMELINE_HISTORY_REGEXP                                 "^[0-F]{8}.history$"
 STRING_DECLARE(WAL_TIMELINE_HISTORY_REGEXP_STR);
 
+/***********************************************************************************************************************************
+Compression dictionary stored in the archive id path. The dictionary is trained from WAL when the stanza is created or upgraded and
+is never modified once it exists, so every segment in the archive id compressed with a dictionary uses the same one. The dictionary
+id is stored in the header of each compressed segment.
+***********************************************************************************************************************************/
+#define ARCHIVE_DICT_FILE                                           "archive.dict"
+
 /***********************************************************************************************************************************
 Functions
 ***********************************************************************************************************************************/
+// Get the compression dictionary for an archive id or NULL if the archive id does not have one. Results are cached for the life of
+// the process since the dictionary may be required for every segment.
+FN_EXTERN const Buffer *archiveDictGet(
+    unsigned int repoIdx, const String *archiveId, CipherType cipherType, const String *cipherPass);
+
+// Save the compression dictionary for an archive id
+FN_EXTERN void archiveDictPut(
+    unsigned int repoIdx, const String *archiveId, CipherType cipherType, const String *cipherPass, const Buffer *dict);
+
 // Remove errors for an archive file. This should be done before forking the async process to prevent a race condition where an old
 // error may be reported rather than waiting for the async process to succeed or fail.
 FN_EXTERN void archiveAsyncErrorClear(ArchiveMode archiveMode, const String *archiveFile);
@@ -3,6 +3,7 @@ Archive Segment Find
 ***********************************************************************************************************************************/
 #include "build.auto.h"
 
+#include "command/archive/bundle.h"
 #include "command/archive/common.h"
 #include "command/archive/find.h"
 #include "common/debug.h"
@@ -23,6 +24,7 @@ struct WalSegmentFind
     TimeMSec timeout;                                               // Timeout for each segment
     String *prefix;                                                 // Current list prefix
     StringList *list;                                               // List of found segments
+    StringList *bundleList;                                         // List of found bundles
 };
 
 /***********************************************************************************************************************************
@@ -100,18 +102,48 @@ walSegmentFind(WalSegmentFind *const this, const String *const walSegment)
                         this->prefix = strDup(prefix);
                     }
 
-                    // Free list
+                    // Free lists
                     strLstFree(this->list);
+                    strLstFree(this->bundleList);
 
                     // Get list
                     this->list = strLstSort(
                         storageListP(this->storage, path, .expression = this->single ? expression : NULL), sortOrderAsc);
+
+                    // When finding a single WAL the segment may be stored in a bundle. Bundles are only listed when the segment was
+                    // not found since a bundle listing cannot be limited by prefix and would list the entire WAL path.
+                    if (this->single)
+                    {
+                        this->bundleList =
+                            strLstEmpty(this->list) ?
+                                strLstSort(
+                                    storageListP(this->storage, path, .expression = STRDEF(WAL_BUNDLE_REGEXP)), sortOrderAsc) :
+                                strLstNew();
+                    }
+                    // Else move bundles to a separate list so they are not matched as segments
+                    else
+                    {
+                        this->bundleList = strLstNew();
+
+                        unsigned int listIdx = 0;
+
+                        while (listIdx < strLstSize(this->list))
+                        {
+                            if (walIsBundle(strLstGet(this->list, listIdx)))
+                            {
+                                strLstAdd(this->bundleList, strLstGet(this->list, listIdx));
+                                strLstRemoveIdx(this->list, listIdx);
+                            }
+                            else
+                                listIdx++;
+                        }
+                    }
                 }
                 MEM_CONTEXT_OBJ_END();
             }
 
             // If there are results
-            if (!strLstEmpty(this->list))
+            if (!strLstEmpty(this->list) || !strLstEmpty(this->bundleList))
             {
                 // By default the match size is the list size since filtering happened above. When not finding a single WAL then
                 // non-matching entries before the matching WAL will need to be removed and then the matching WAL counted.
@@ -132,10 +164,21 @@ walSegmentFind(WalSegmentFind *const this, const String *const walSegment)
 
                     while (match < strLstSize(this->list) && regExpMatch(regExp, strLstGet(this->list, match)))
                         match++;
+
+                    // Remove bundles that end before the WAL segment since later finds will not be looking for earlier segments
+                    while (
+                        !strLstEmpty(this->bundleList) &&
+                        strCmp(walBundleSegmentLast(strLstGet(this->bundleList, 0)), strSubN(walSegment, 0, 24)) < 0)
+                    {
+                        strLstRemoveIdx(this->bundleList, 0);
+                    }
                 }
 
+                // Check for the WAL segment in bundles
+                const WalBundleFile *const bundleFile = walBundleFind(this->storage, path, this->bundleList, walSegment);
+
                 // Error if there is more than one match
-                if (match > 1)
+                if (match + (bundleFile != NULL ? 1 : 0) > 1)
                 {
                     // Build list of duplicate WAL
                     StringList *const matchList = strLstNew();
@@ -143,9 +186,14 @@ walSegmentFind(WalSegmentFind *const this, const String *const walSegment)
                     for (unsigned int matchIdx = 0; matchIdx < match; matchIdx++)
                         strLstAdd(matchList, strLstGet(this->list, matchIdx));
 
-                    // Clear list for next find
+                    if (bundleFile != NULL)
+                        strLstAdd(matchList, strNewFmt("%s/%s", strZ(bundleFile->bundle), strZ(bundleFile->name)));
+
+                    // Clear lists for next find
                     strLstFree(this->list);
                     this->list = NULL;
+                    strLstFree(this->bundleList);
+                    this->bundleList = NULL;
 
                     THROW_FMT(
                         ArchiveDuplicateError,
@@ -154,12 +202,13 @@ walSegmentFind(WalSegmentFind *const this, const String *const walSegment)
                         strZ(walSegment), strZ(strLstJoin(matchList, ", ")));
                 }
 
-                // On match copy file name of WAL segment found into the prior context
-                if (match == 1)
+                // On match copy file name of WAL segment found into the prior context. A segment stored in a bundle is returned
+                // with the name it would have outside the bundle.
+                if (match == 1 || bundleFile != NULL)
                 {
                     MEM_CONTEXT_PRIOR_BEGIN()
                     {
-                        result = strDup(strLstGet(this->list, 0));
+                        result = strDup(match == 1 ? strLstGet(this->list, 0) : bundleFile->name);
                     }
                     MEM_CONTEXT_PRIOR_END();
                 }
@@ -174,11 +223,13 @@ walSegmentFind(WalSegmentFind *const this, const String *const walSegment)
                 }
             }
 
-            // Clear list for next find
-            if (this->single || strLstEmpty(this->list))
+            // Clear lists for next find
+            if (this->single || (strLstEmpty(this->list) && strLstEmpty(this->bundleList)))
             {
                 strLstFree(this->list);
                 this->list = NULL;
+                strLstFree(this->bundleList);
+                this->bundleList = NULL;
             }
         }
         while (result == NULL && waitMore(wait));
@@ -36,7 +36,12 @@ buildArchiveGetPipeLine(IoFilterGroup *const group, const ArchiveGetFile *const
 
     if (compressType != compressTypeNone)
     {
-        ioFilterGroupAdd(group, decompressFilterP(compressType));
+        // Get the archive dictionary in case the segment was compressed with it. Only zst supports dictionaries.
+        const Buffer *const dict =
+            compressType == compressTypeZst ?
+                archiveDictGet(file->repoIdx, file->archiveId, file->cipherType, file->cipherPassArchive) : NULL;
+
+        ioFilterGroupAdd(group, decompressFilterP(compressType, .dict = dict));
         compressible = false;
     }
 
@@ -103,11 +108,15 @@ archiveGetFile(
                     ioFilterGroupAdd(ioWriteFilterGroup(storageWriteIo(destination)),
                                      walFilterNew(pgControl, actual));
                 }
-                // Copy the file
+                // Copy the file. If the file is stored in a bundle then read only the part of the bundle that contains the file.
                 storageCopyP(
-                    storageNewReadP(
-                        storageRepoIdx(actual->repoIdx), strNewFmt(STORAGE_REPO_ARCHIVE "/%s", strZ(actual->file)),
-                        .compressible = compressible),
+                    actual->bundle != NULL ?
+                        storageNewReadP(
+                            storageRepoIdx(actual->repoIdx), strNewFmt(STORAGE_REPO_ARCHIVE "/%s", strZ(actual->bundle)),
+                            .offset = actual->bundleOffset, .limit = VARUINT64(actual->bundleSize), .compressible = compressible) :
+                        storageNewReadP(
+                            storageRepoIdx(actual->repoIdx), strNewFmt(STORAGE_REPO_ARCHIVE "/%s", strZ(actual->file)),
+                            .compressible = compressible),
                     destination);
             }
             MEM_CONTEXT_TEMP_END();
@@ -15,6 +15,9 @@ Functions
 typedef struct ArchiveGetFile
 {
     const String *file;                                             // File in the repo (with path, checksum, ext, etc.)
+    const String *bundle;                                           // Bundle the file is stored in (NULL if not bundled)
+    uint64_t bundleOffset;                                          // Offset of the file in the bundle
+    uint64_t bundleSize;                                            // Size of the file in the bundle
     unsigned int repoIdx;                                           // Repo idx
     const String *archiveId;                                        // Repo archive id
     CipherType cipherType;                                          // Repo cipher type
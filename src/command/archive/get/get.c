@@ -9,6 +9,7 @@ Archive Get Command
 #include <sys/types.h>
 #include <unistd.h>
 
+#include "command/archive/bundle.h"
 #include "command/archive/common.h"
 #include "command/archive/get/file.h"
 #include "command/archive/get/protocol.h"
@@ -17,7 +18,9 @@ Archive Get Command
 #include "common/log.h"
 #include "common/memContext.h"
 #include "common/regExp.h"
+#include "common/time.h"
 #include "common/wait.h"
+#include "common/walFilter/walFilter.h"
 #include "config/config.h"
 #include "config/exec.h"
 #include "config/load.h"
@@ -149,16 +152,19 @@ archiveGetFind(
                     // If a WAL segment then search among the possible file names
                     if (isSegment)
                     {
-                        StringList *segmentList;
+                        const String *const archivePath = strNewFmt(
+                            STORAGE_REPO_ARCHIVE "/%s/%s", strZ(cacheArchive->archiveId), strZ(path));
+                        const StringList *fileList;
 
-                        // If a single file is requested then optimize by adding a restrictive expression to reduce bandwidth
+                        // If a single file is requested then optimize by adding a restrictive expression to reduce bandwidth.
+                        // Bundles are also listed since the segment may be stored in one.
                         if (single)
                         {
-                            segmentList = storageListP(
-                                storageRepoIdx(cacheRepo->repoIdx),
-                                strNewFmt(STORAGE_REPO_ARCHIVE "/%s/%s", strZ(cacheArchive->archiveId), strZ(path)),
+                            fileList = storageListP(
+                                storageRepoIdx(cacheRepo->repoIdx), archivePath,
                                 .expression = strNewFmt(
-                                    "^%s%s-[0-f]{40}" COMPRESS_TYPE_REGEXP "{0,1}$", strZ(strSubN(archiveFileRequest, 0, 24)),
+                                    "^%s(%s%s-[0-f]{40}" COMPRESS_TYPE_REGEXP "{0,1}|[0-F]{8}-[0-F]{24}\\" WAL_BUNDLE_EXT ")$",
+                                    strZ(path), strZ(strSubN(archiveFileRequest, 16, 8)),
                                     walIsPartial(archiveFileRequest) ? WAL_SEGMENT_PARTIAL_EXT : ""));
                         }
                         // Else multiple files will be requested so cache list results
@@ -178,10 +184,11 @@ archiveGetFind(
                                     {
                                         .path = strDup(path),
                                         .fileList = storageListP(
-                                            storageRepoIdx(cacheRepo->repoIdx),
-                                            strNewFmt(STORAGE_REPO_ARCHIVE "/%s/%s", strZ(cacheArchive->archiveId), strZ(path)),
+                                            storageRepoIdx(cacheRepo->repoIdx), archivePath,
                                             .expression = strNewFmt(
-                                                "^%s[0-F]{8}-[0-f]{40}" COMPRESS_TYPE_REGEXP "{0,1}$", strZ(path))),
+                                                "^%s[0-F]{8}-([0-f]{40}" COMPRESS_TYPE_REGEXP "{0,1}|[0-F]{24}\\" WAL_BUNDLE_EXT
+                                                ")$",
+                                                strZ(path))),
                                     };
 
                                     cachePath = lstAdd(cacheArchive->pathList, &archiveGetFindCachePath);
@@ -189,14 +196,18 @@ archiveGetFind(
                                 MEM_CONTEXT_END();
                             }
 
-                            // Get a list of all WAL segments that match
-                            segmentList = strLstNew();
+                            fileList = cachePath->fileList;
+                        }
 
-                            for (unsigned int fileIdx = 0; fileIdx < strLstSize(cachePath->fileList); fileIdx++)
-                            {
-                                if (strBeginsWith(strLstGet(cachePath->fileList, fileIdx), archiveFileRequest))
-                                    strLstAdd(segmentList, strLstGet(cachePath->fileList, fileIdx));
-                            }
+                        // Get a list of all WAL segments that match
+                        StringList *const segmentList = strLstNew();
+
+                        for (unsigned int fileIdx = 0; fileIdx < strLstSize(fileList); fileIdx++)
+                        {
+                            const String *const file = strLstGet(fileList, fileIdx);
+
+                            if (!walIsBundle(file) && strBeginsWith(file, archiveFileRequest))
+                                strLstAdd(segmentList, file);
                         }
 
                         // Add segments to match list
@@ -219,6 +230,36 @@ archiveGetFind(
                             }
                             MEM_CONTEXT_END();
                         }
+
+                        // If the segment was not found then check bundles
+                        if (strLstEmpty(segmentList))
+                        {
+                            const WalBundleFile *const bundleFile = walBundleFind(
+                                storageRepoIdx(cacheRepo->repoIdx), archivePath, fileList, archiveFileRequest);
+
+                            if (bundleFile != NULL)
+                            {
+                                MEM_CONTEXT_BEGIN(lstMemContext(getCheckResult->archiveFileMapList))
+                                {
+                                    const ArchiveGetFile archiveGetFile =
+                                    {
+                                        .file = strNewFmt(
+                                            "%s/%s/%s", strZ(cacheArchive->archiveId), strZ(path), strZ(bundleFile->name)),
+                                        .bundle = strNewFmt(
+                                            "%s/%s/%s", strZ(cacheArchive->archiveId), strZ(path), strZ(bundleFile->bundle)),
+                                        .bundleOffset = bundleFile->offset,
+                                        .bundleSize = bundleFile->size,
+                                        .repoIdx = cacheRepo->repoIdx,
+                                        .archiveId = cacheArchive->archiveId,
+                                        .cipherType = cacheRepo->cipherType,
+                                        .cipherPassArchive = cacheRepo->cipherPassArchive,
+                                    };
+
+                                    lstAdd(matchList, &archiveGetFile);
+                                }
+                                MEM_CONTEXT_END();
+                            }
+                        }
                     }
                     // Else if not a WAL segment, see if it exists in the archiveId path
                     else if (
@@ -423,6 +464,9 @@ archiveGetCheck(const StringList *const archiveRequestList)
                 }
                 MEM_CONTEXT_END();
 
+                // WAL is decrypted with the cipher type stored in archive.info
+                cacheRepo.cipherType = infoArchiveCipherType(info);
+
                 // Loop through pg history and determine which archiveIds to use
                 const StringList *archivePathList = NULL;
 
@@ -531,6 +575,193 @@ archiveGetCheck(const StringList *const archiveRequestList)
     FUNCTION_LOG_RETURN_STRUCT(result);
 }
 
+/***********************************************************************************************************************************
+Statistics used to size the queue when archive-get-queue-adapt is enabled. The foreground process records the average interval
+between WAL segments found in the queue, i.e. the rate at which PostgreSQL replays WAL, and the async process records the average
+time taken to get the first WAL segment, i.e. how long PostgreSQL would wait for a WAL segment that is not in the queue. Each file
+has a single writer and both are removed with the rest of the archive spool path by restore.
+***********************************************************************************************************************************/
+#define ARCHIVE_GET_STAT_REPLAY_FILE                                STORAGE_SPOOL_ARCHIVE "/get-replay.stat"
+#define ARCHIVE_GET_STAT_FETCH_FILE                                 STORAGE_SPOOL_ARCHIVE "/get-fetch.stat"
+
+// Replay stat values
+#define ARCHIVE_GET_STAT_REPLAY_LAST                                0
+#define ARCHIVE_GET_STAT_REPLAY_INTERVAL                            1
+#define ARCHIVE_GET_STAT_REPLAY_TOTAL                               2
+
+// Fetch stat values
+#define ARCHIVE_GET_STAT_FETCH_LATENCY                              0
+#define ARCHIVE_GET_STAT_FETCH_TOTAL                                1
+
+// Intervals longer than this are assumed to be a pause in recovery rather than the replay rate
+#define ARCHIVE_GET_STAT_INTERVAL_MAX                               (60 * MSEC_PER_SEC)
+
+// Load stat values. Values are zero when the file is missing or invalid since the stats are only used as an estimate.
+static void
+archiveGetStatLoad(const String *const file, TimeMSec *const valueList, const unsigned int valueTotal)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(STRING, file);
+        FUNCTION_TEST_PARAM_P(VOID, valueList);
+        FUNCTION_TEST_PARAM(UINT, valueTotal);
+    FUNCTION_TEST_END();
+
+    ASSERT(file != NULL);
+    ASSERT(valueList != NULL);
+
+    for (unsigned int valueIdx = 0; valueIdx < valueTotal; valueIdx++)
+        valueList[valueIdx] = 0;
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        const Buffer *const buffer = storageGetP(storageNewReadP(storageSpool(), file, .ignoreMissing = true));
+
+        if (buffer != NULL)
+        {
+            const StringList *const stat = strLstNewSplitZ(strNewBuf(buffer), "\n");
+
+            if (strLstSize(stat) == valueTotal)
+            {
+                TRY_BEGIN()
+                {
+                    for (unsigned int valueIdx = 0; valueIdx < valueTotal; valueIdx++)
+                        valueList[valueIdx] = cvtZToUInt64(strZ(strLstGet(stat, valueIdx)));
+                }
+                CATCH(FormatError)
+                {
+                    for (unsigned int valueIdx = 0; valueIdx < valueTotal; valueIdx++)
+                        valueList[valueIdx] = 0;
+                }
+                TRY_END();
+            }
+        }
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+// Save stat values. The file does not need to be synced since it is recreated if lost.
+static void
+archiveGetStatSave(const String *const file, const TimeMSec *const valueList, const unsigned int valueTotal)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(STRING, file);
+        FUNCTION_TEST_PARAM_P(VOID, valueList);
+        FUNCTION_TEST_PARAM(UINT, valueTotal);
+    FUNCTION_TEST_END();
+
+    ASSERT(file != NULL);
+    ASSERT(valueList != NULL);
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        String *const stat = strNew();
+
+        for (unsigned int valueIdx = 0; valueIdx < valueTotal; valueIdx++)
+            strCatFmt(stat, "%s%" PRIu64, valueIdx == 0 ? "" : "\n", valueList[valueIdx]);
+
+        storagePutP(storageNewWriteP(storageSpoolWrite(), file, .noSyncFile = true, .noSyncPath = true), BUFSTR(stat));
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+// Add a sample to an average. Recent samples are weighted more heavily so the average follows changes in the rate.
+static TimeMSec
+archiveGetStatAvg(const TimeMSec average, const TimeMSec sample)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(TIME_MSEC, average);
+        FUNCTION_TEST_PARAM(TIME_MSEC, sample);
+    FUNCTION_TEST_END();
+
+    FUNCTION_TEST_RETURN(TIME_MSEC, average == 0 ? sample : (average * 3 + sample) / 4);
+}
+
+// Record that a WAL segment was found in the queue. The interval is only sampled when PostgreSQL did not have to wait for the WAL
+// segment, otherwise the interval would measure the time taken to get the WAL segment rather than the replay rate.
+static void
+archiveGetStatReplay(const bool sample)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(BOOL, sample);
+    FUNCTION_TEST_END();
+
+    TimeMSec stat[ARCHIVE_GET_STAT_REPLAY_TOTAL];
+    archiveGetStatLoad(STRDEF(ARCHIVE_GET_STAT_REPLAY_FILE), stat, ARCHIVE_GET_STAT_REPLAY_TOTAL);
+
+    const TimeMSec timeNow = timeMSec();
+    const TimeMSec replayLast = stat[ARCHIVE_GET_STAT_REPLAY_LAST];
+
+    if (sample && replayLast != 0 && timeNow > replayLast && timeNow - replayLast <= ARCHIVE_GET_STAT_INTERVAL_MAX)
+    {
+        stat[ARCHIVE_GET_STAT_REPLAY_INTERVAL] = archiveGetStatAvg(
+            stat[ARCHIVE_GET_STAT_REPLAY_INTERVAL], timeNow - replayLast);
+    }
+
+    stat[ARCHIVE_GET_STAT_REPLAY_LAST] = timeNow;
+    archiveGetStatSave(STRDEF(ARCHIVE_GET_STAT_REPLAY_FILE), stat, ARCHIVE_GET_STAT_REPLAY_TOTAL);
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+// Record the time taken to get the first WAL segment
+static void
+archiveGetStatFetch(const TimeMSec latency)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(TIME_MSEC, latency);
+    FUNCTION_TEST_END();
+
+    TimeMSec stat[ARCHIVE_GET_STAT_FETCH_TOTAL];
+    archiveGetStatLoad(STRDEF(ARCHIVE_GET_STAT_FETCH_FILE), stat, ARCHIVE_GET_STAT_FETCH_TOTAL);
+
+    stat[ARCHIVE_GET_STAT_FETCH_LATENCY] = archiveGetStatAvg(stat[ARCHIVE_GET_STAT_FETCH_LATENCY], latency);
+    archiveGetStatSave(STRDEF(ARCHIVE_GET_STAT_FETCH_FILE), stat, ARCHIVE_GET_STAT_FETCH_TOTAL);
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Get the size of the queue. When archive-get-queue-adapt is enabled the queue holds enough WAL segments to cover the time taken to
+get a WAL segment at the current replay rate, up to archive-get-queue-max. The async process is started when the queue is half
+empty so the number of WAL segments is doubled, and one WAL segment is added for the WAL segment being replayed. Until both rates
+have been measured the queue is filled to archive-get-queue-max.
+***********************************************************************************************************************************/
+static uint64_t
+archiveGetQueueSize(const size_t walSegmentSize)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(SIZE, walSegmentSize);
+    FUNCTION_TEST_END();
+
+    uint64_t result = cfgOptionUInt64(cfgOptArchiveGetQueueMax);
+
+    if (cfgOptionBool(cfgOptArchiveGetQueueAdapt))
+    {
+        TimeMSec replay[ARCHIVE_GET_STAT_REPLAY_TOTAL];
+        TimeMSec fetch[ARCHIVE_GET_STAT_FETCH_TOTAL];
+
+        archiveGetStatLoad(STRDEF(ARCHIVE_GET_STAT_REPLAY_FILE), replay, ARCHIVE_GET_STAT_REPLAY_TOTAL);
+        archiveGetStatLoad(STRDEF(ARCHIVE_GET_STAT_FETCH_FILE), fetch, ARCHIVE_GET_STAT_FETCH_TOTAL);
+
+        const TimeMSec replayInterval = replay[ARCHIVE_GET_STAT_REPLAY_INTERVAL];
+        const TimeMSec fetchLatency = fetch[ARCHIVE_GET_STAT_FETCH_LATENCY];
+
+        if (replayInterval != 0 && fetchLatency != 0)
+        {
+            const uint64_t queueSize = ((fetchLatency + replayInterval - 1) / replayInterval + 1) * 2 * walSegmentSize;
+
+            if (queueSize < result)
+                result = queueSize;
+        }
+    }
+
+    FUNCTION_TEST_RETURN(UINT64, result);
+}
+
 /***********************************************************************************************************************************
 Clean the queue and prepare a list of WAL segments that the async process should get
 ***********************************************************************************************************************************/
@@ -566,9 +797,28 @@ queueNeed(
             walSegmentQueueTotal = 2;
 
         // Build the ideal queue -- the WAL segments we want in the queue after the async process has run
-        const StringList *const idealQueue = strLstSort(
+        StringList *const idealQueue = strLstSort(
             walSegmentRange(walSegmentFirst, walSegmentSize, pgVersion, walSegmentQueueTotal), sortOrderAsc);
 
+        // Remove WAL segments after the recovery target since PostgreSQL will stop recovery before it needs them. The requested WAL
+        // segment is always kept. Only the position of the WAL segments is compared since the timeline of the target is not known.
+        if (cfgOptionTest(cfgOptArchiveGetQueueTarget))
+        {
+            const String *const walSegmentTarget = strSub(
+                pgLsnToWalSegment(
+                    1, pgLsnFromStr(cfgOptionStr(cfgOptArchiveGetQueueTarget)), (unsigned int)walSegmentSize), 8);
+
+            while (!strLstEmpty(idealQueue))
+            {
+                const String *const walSegmentLast = strLstGet(idealQueue, strLstSize(idealQueue) - 1);
+
+                if (strEq(walSegmentLast, walSegment) || strCmp(strSub(walSegmentLast, 8), walSegmentTarget) <= 0)
+                    break;
+
+                strLstRemoveIdx(idealQueue, strLstSize(idealQueue) - 1);
+            }
+        }
+
         // Get the list of files actually in the queue
         const StringList *const actualQueue = strLstSort(
             storageListP(storageSpool(), STORAGE_SPOOL_ARCHIVE_IN_STR, .errorOnMissing = true), sortOrderAsc);
@@ -596,6 +846,10 @@ queueNeed(
             }
         }
 
+        // Remove WAL filter fragments that will not be needed by segments in the queue
+        if (cfgOptionTest(cfgOptFilter))
+            walFilterFragmentClean(walSegment, walSegmentSize);
+
         // Generate a list of the WAL that are needed by removing kept WAL from the ideal queue
         strLstSort(keepQueue, sortOrderAsc);
 
@@ -713,6 +967,10 @@ cmdArchiveGet(void)
                     LOG_INFO_FMT(FOUND_IN_ARCHIVE_MSG " asynchronously", strZ(walSegment));
                     result = 0;
 
+                    // Record the replay rate. The interval is only sampled when the WAL segment was already in the queue.
+                    if (cfgOptionBool(cfgOptArchiveGetQueueAdapt))
+                        archiveGetStatReplay(first);
+
                     // Get a list of WAL segments left in the queue
                     const StringList *const queue = storageListP(
                         storageSpool(), STORAGE_SPOOL_ARCHIVE_IN_STR, .expression = WAL_SEGMENT_REGEXP_STR, .errorOnMissing = true);
@@ -723,7 +981,7 @@ cmdArchiveGet(void)
                         const uint64_t walSegmentSize = storageInfoP(storageLocal(), walDestination).size;
 
                         // Use WAL segment size to estimate queue size and determine if the async process should be launched
-                        queueFull = strLstSize(queue) * walSegmentSize > cfgOptionUInt64(cfgOptArchiveGetQueueMax) / 2;
+                        queueFull = strLstSize(queue) * walSegmentSize > archiveGetQueueSize(walSegmentSize) / 2;
                     }
                 }
 
@@ -751,7 +1009,7 @@ cmdArchiveGet(void)
                     // Clean the current queue using the list of WAL that we ideally want in the queue. queueNeed() will return the
                     // list of WAL needed to fill the queue and this will be passed to the async process.
                     const StringList *const queue = queueNeed(
-                        walSegment, found, cfgOptionUInt64(cfgOptArchiveGetQueueMax), pgControl.walSegmentSize,
+                        walSegment, found, archiveGetQueueSize(pgControl.walSegmentSize), pgControl.walSegmentSize,
                         pgControl.version);
 
                     for (unsigned int queueIdx = 0; queueIdx < strLstSize(queue); queueIdx++)
@@ -763,8 +1021,9 @@ cmdArchiveGet(void)
                     // Release the lock so the child process can acquire it
                     lockRelease(true);
 
-                    // Execute the async process
-                    archiveAsyncExec(archiveModeGet, commandExec);
+                    // Execute the async process unless the queue already holds all the WAL needed to reach the recovery target
+                    if (!strLstEmpty(queue))
+                        archiveAsyncExec(archiveModeGet, commandExec);
 
                     // Mark the async process as forked so it doesn't get forked again. A single run of the async process should be
                     // enough to do the job, running it again won't help anything.
@@ -888,6 +1147,9 @@ archiveGetAsyncCallback(void *const data, const unsigned int clientIdx)
                 const ArchiveGetFile *const actual = lstGet(archiveFileMap->actualList, actualIdx);
 
                 pckWriteStrP(param, actual->file);
+                pckWriteStrP(param, actual->bundle);
+                pckWriteU64P(param, actual->bundleOffset);
+                pckWriteU64P(param, actual->bundleSize);
                 pckWriteU32P(param, actual->repoIdx);
                 pckWriteStrP(param, actual->archiveId);
                 pckWriteU64P(param, actual->cipherType);
@@ -915,6 +1177,9 @@ cmdArchiveGetAsync(void)
     {
         TRY_BEGIN()
         {
+            // Begin timing the first WAL segment, which includes checking the repositories
+            const TimeMSec fetchBegin = timeMSec();
+
             // PostgreSQL must be local
             pgIsLocalVerify();
 
@@ -942,9 +1207,11 @@ cmdArchiveGetAsync(void)
             {
                 // Create the parallel executor
                 ArchiveGetAsyncData jobData = {.archiveFileMapList = checkResult.archiveFileMapList};
+                bool fetchRecord = cfgOptionBool(cfgOptArchiveGetQueueAdapt);
 
-                ProtocolParallel *const parallelExec = protocolParallelNew(
-                    cfgOptionUInt64(cfgOptProtocolTimeout) / 2, archiveGetAsyncCallback, &jobData);
+                ProtocolParallel *const parallelExec = protocolParallelNewP(
+                    cfgOptionUInt64(cfgOptProtocolTimeout) / 2, archiveGetAsyncCallback, &jobData,
+                    .jobMax = cfgOptionUInt(cfgOptProcessJobMax));
 
                 for (unsigned int processIdx = 1; processIdx <= cfgOptionUInt(cfgOptProcessMax); processIdx++)
                     protocolParallelClientAdd(parallelExec, protocolLocalGet(protocolStorageTypeRepo, 0, processIdx));
@@ -1010,6 +1277,13 @@ cmdArchiveGetAsync(void)
                                         strNewFmt(STORAGE_SPOOL_ARCHIVE_IN "/%s." STORAGE_FILE_TEMP_EXT, strZ(walSegment))),
                                     storageNewWriteP(
                                         storageSpoolWrite(), strNewFmt(STORAGE_SPOOL_ARCHIVE_IN "/%s", strZ(walSegment))));
+
+                                // Record the time taken to get the first WAL segment
+                                if (fetchRecord)
+                                {
+                                    archiveGetStatFetch(timeMSec() - fetchBegin);
+                                    fetchRecord = false;
+                                }
                             }
                             // Else the job errored
                             else
@@ -36,6 +36,9 @@ archiveGetFileProtocol(PackRead *const param, ProtocolServer *const server)
         while (!pckReadNullP(param))
         {
             ArchiveGetFile actual = {.file = pckReadStrP(param)};
+            actual.bundle = pckReadStrP(param);
+            actual.bundleOffset = pckReadU64P(param);
+            actual.bundleSize = pckReadU64P(param);
             actual.repoIdx = pckReadU32P(param);
             actual.archiveId = pckReadStrP(param);
             actual.cipherType = pckReadU64P(param);
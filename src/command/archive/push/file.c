@@ -3,6 +3,7 @@ Archive Push File
 ***********************************************************************************************************************************/
 #include "build.auto.h"
 
+#include "command/archive/bundle.h"
 #include "command/archive/common.h"
 #include "command/archive/find.h"
 #include "command/archive/push/file.h"
@@ -97,7 +98,7 @@ FN_EXTERN ArchivePushFileResult
 archivePushFile(
     const String *const walSource, const bool headerCheck, const bool modeCheck, const unsigned int pgVersion,
     const uint64_t pgSystemId, const String *const archiveFile, const CompressType compressType, const int compressLevel,
-    const List *const repoList, const StringList *const priorErrorList)
+    const bool compressDict, const List *const repoList, const StringList *const priorErrorList)
 {
     FUNCTION_LOG_BEGIN(logLevelDebug);
         FUNCTION_LOG_PARAM(STRING, walSource);
@@ -108,6 +109,7 @@ archivePushFile(
         FUNCTION_LOG_PARAM(STRING, archiveFile);
         FUNCTION_LOG_PARAM(ENUM, compressType);
         FUNCTION_LOG_PARAM(INT, compressLevel);
+        FUNCTION_LOG_PARAM(BOOL, compressDict);
         FUNCTION_LOG_PARAM_P(VOID, repoList);
         FUNCTION_LOG_PARAM(STRING_LIST, priorErrorList);
     FUNCTION_LOG_END();
@@ -150,6 +152,7 @@ archivePushFile(
         // Assume that all repos need a copy of the archive file
         bool destinationCopyAny = true;
         bool *const destinationCopy = memNew(sizeof(bool) * lstSize(repoList));
+        const Buffer **const destinationDict = memNewPtrArray(lstSize(repoList));
 
         for (unsigned int repoListIdx = 0; repoListIdx < lstSize(repoList); repoListIdx++)
             destinationCopy[repoListIdx] = true;
@@ -179,6 +182,13 @@ archivePushFile(
                 TRY_BEGIN()
                 {
                     walSegmentFile = walSegmentFindOne(storageRepoIdx(repoData->repoIdx), repoData->archiveId, archiveFile, 0);
+
+                    // Get the compression dictionary for the archive id. Only zst supports dictionaries.
+                    if (compressDict && compressType == compressTypeZst)
+                    {
+                        destinationDict[repoListIdx] = archiveDictGet(
+                            repoData->repoIdx, repoData->archiveId, repoData->cipherType, repoData->cipherPass);
+                    }
                 }
                 CATCH_ANY()
                 {
@@ -244,8 +254,34 @@ archivePushFile(
             // If the file will be compressed then add compression filter
             if (isSegment && compressType != compressTypeNone)
             {
+                // The segment is compressed once for all repos so a dictionary can only be used when all repos that need the
+                // segment have the same dictionary
+                const Buffer *dict = NULL;
+
+                if (compressDict)
+                {
+                    // Start with the dictionary of the first repo that needs the segment
+                    unsigned int dictIdx = 0;
+
+                    while (!destinationCopy[dictIdx])
+                        dictIdx++;
+
+                    dict = destinationDict[dictIdx];
+
+                    // Do not use a dictionary if any other repo that needs the segment has a different dictionary
+                    for (unsigned int repoListIdx = dictIdx + 1; dict != NULL && repoListIdx < lstSize(repoList); repoListIdx++)
+                    {
+                        if (destinationCopy[repoListIdx] &&
+                            (destinationDict[repoListIdx] == NULL || !bufEq(dict, destinationDict[repoListIdx])))
+                        {
+                            dict = NULL;
+                        }
+                    }
+                }
+
                 compressExtCat(archiveDestination, compressType);
-                ioFilterGroupAdd(ioReadFilterGroup(storageReadIo(source)), compressFilterP(compressType, compressLevel));
+                ioFilterGroupAdd(
+                    ioReadFilterGroup(storageReadIo(source)), compressFilterP(compressType, compressLevel, .dict = dict));
                 compressible = false;
             }
 
@@ -339,3 +375,210 @@ archivePushFile(
 
     FUNCTION_LOG_RETURN_STRUCT(result);
 }
+
+/**********************************************************************************************************************************/
+FN_EXTERN ArchivePushFileResult
+archivePushBundle(
+    const String *const walPath, const StringList *const walFileList, const bool headerCheck, const bool modeCheck,
+    const unsigned int pgVersion, const uint64_t pgSystemId, const CompressType compressType, const int compressLevel,
+    const bool compressDict, const List *const repoList, const StringList *const priorErrorList)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(STRING, walPath);
+        FUNCTION_LOG_PARAM(STRING_LIST, walFileList);
+        FUNCTION_LOG_PARAM(BOOL, headerCheck);
+        FUNCTION_LOG_PARAM(BOOL, modeCheck);
+        FUNCTION_LOG_PARAM(UINT, pgVersion);
+        FUNCTION_LOG_PARAM(UINT64, pgSystemId);
+        FUNCTION_LOG_PARAM(ENUM, compressType);
+        FUNCTION_LOG_PARAM(INT, compressLevel);
+        FUNCTION_LOG_PARAM(BOOL, compressDict);
+        FUNCTION_LOG_PARAM_P(VOID, repoList);
+        FUNCTION_LOG_PARAM(STRING_LIST, priorErrorList);
+    FUNCTION_LOG_END();
+
+    FUNCTION_AUDIT_STRUCT();
+
+    ASSERT(walPath != NULL);
+    ASSERT(walFileList != NULL);
+    ASSERT(!strLstEmpty(walFileList));
+    ASSERT(repoList != NULL);
+    ASSERT(priorErrorList != NULL);
+    ASSERT(lstSize(repoList) > 0);
+
+    ArchivePushFileResult result = {.warnList = strLstNew()};
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        StringList *const errorList = strLstDup(priorErrorList);
+        const String *const walSegmentPath = strSubN(strLstGet(walFileList, 0), 0, 16);
+
+        // Compare archive version and systemId to the WAL header and generate a sha1 checksum for each WAL segment. Segments are
+        // streamed rather than loaded so memory usage does not depend on the size of the bundle.
+        StringList *const checksumList = strLstNew();
+
+        for (unsigned int walFileIdx = 0; walFileIdx < strLstSize(walFileList); walFileIdx++)
+        {
+            const String *const walFile = strLstGet(walFileList, walFileIdx);
+            const String *const walSource = strNewFmt("%s/%s", strZ(walPath), strZ(walFile));
+
+            ASSERT(walIsSegment(walFile) && !walIsPartial(walFile));
+            ASSERT(strEq(strSubN(walFile, 0, 16), walSegmentPath));
+
+            if (headerCheck)
+            {
+                const PgWal walInfo = pgWalFromFile(walSource, storageLocal(), cfgOptionStrNull(cfgOptPgVersionForce));
+
+                if (walInfo.version != pgVersion || walInfo.systemId != pgSystemId)
+                {
+                    THROW_FMT(
+                        ArchiveMismatchError,
+                        "WAL file '%s' version %s, system-id %" PRIu64 " do not match stanza version %s, system-id %" PRIu64,
+                        strZ(walSource), strZ(pgVersionToStr(walInfo.version)), walInfo.systemId,
+                        strZ(pgVersionToStr(pgVersion)), pgSystemId);
+                }
+            }
+
+            IoRead *const read = storageReadIo(storageNewReadP(storageLocal(), walSource));
+            ioFilterGroupAdd(ioReadFilterGroup(read), cryptoHashNew(hashTypeSha1));
+            ioReadDrain(read);
+
+            strLstAdd(
+                checksumList,
+                strNewEncode(encodingHex, pckReadBinP(ioFilterGroupResultP(ioReadFilterGroup(read), CRYPTO_HASH_FILTER_TYPE))));
+        }
+
+        // Write a bundle to each repo
+        for (unsigned int repoListIdx = 0; repoListIdx < lstSize(repoList); repoListIdx++)
+        {
+            const ArchivePushFileRepoData *const repoData = lstGet(repoList, repoListIdx);
+
+            MEM_CONTEXT_TEMP_BEGIN()
+            {
+                // Check if the WAL segments already exist in the repo
+                StringList *const walSegmentFileList = strLstNew();
+                const Buffer *dict = NULL;
+                bool repoError = false;
+
+                TRY_BEGIN()
+                {
+                    WalSegmentFind *const find = walSegmentFindNew(
+                        storageRepoIdx(repoData->repoIdx), repoData->archiveId, false, 0);
+
+                    for (unsigned int walFileIdx = 0; walFileIdx < strLstSize(walFileList); walFileIdx++)
+                    {
+                        const String *const walSegmentFile = walSegmentFind(find, strLstGet(walFileList, walFileIdx));
+                        strLstAdd(walSegmentFileList, walSegmentFile == NULL ? EMPTY_STR : walSegmentFile);
+                    }
+
+                    // Get the compression dictionary for the archive id. Only zst supports dictionaries.
+                    if (compressDict && compressType == compressTypeZst)
+                        dict = archiveDictGet(repoData->repoIdx, repoData->archiveId, repoData->cipherType, repoData->cipherPass);
+                }
+                CATCH_ANY()
+                {
+                    archivePushErrorAdd(errorList, repoData->repoIdx);
+                    repoError = true;
+                }
+                TRY_END();
+
+                // Add a read for each WAL segment that is not already in the repo. The reads compress and encrypt the segments as
+                // they are copied into the bundle.
+                StringList *const nameList = strLstNew();
+                List *const readList = lstNewP(sizeof(IoRead *));
+
+                for (unsigned int walFileIdx = 0; !repoError && walFileIdx < strLstSize(walFileList); walFileIdx++)
+                {
+                    const String *const walFile = strLstGet(walFileList, walFileIdx);
+                    const String *const walSegmentFile = strLstGet(walSegmentFileList, walFileIdx);
+                    const String *const walSegmentChecksum = strLstGet(checksumList, walFileIdx);
+
+                    // If the WAL segment was found validate the checksum
+                    if (!strEmpty(walSegmentFile))
+                    {
+                        const String *const walSegmentRepoChecksum = strSubN(
+                            walSegmentFile, strSize(walFile) + 1, HASH_TYPE_SHA1_SIZE_HEX);
+
+                        // If the checksums are the same then succeed but warn if archive-mode-check is enabled in case this is a
+                        // symptom of some other issue
+                        if (strEq(walSegmentChecksum, walSegmentRepoChecksum))
+                        {
+                            if (modeCheck)
+                            {
+                                // Add warning to the result that will be returned to the main process
+                                strLstAddFmt(
+                                    result.warnList,
+                                    "WAL file '%s' already exists in the %s archive with the same checksum"
+                                    "\nHINT: this is valid in some recovery scenarios but may also indicate a problem.",
+                                    strZ(walFile), cfgOptionGroupName(cfgOptGrpRepo, repoData->repoIdx));
+                            }
+
+                            continue;
+                        }
+
+                        // Else error so we don't overwrite the existing segment
+                        THROW_FMT(
+                            ArchiveDuplicateError, "WAL file '%s' already exists in the %s archive with a different checksum",
+                            strZ(walFile), cfgOptionGroupName(cfgOptGrpRepo, repoData->repoIdx));
+                    }
+
+                    // Store the segment in the bundle exactly as it would be stored outside the bundle
+                    IoRead *const read = storageReadIo(
+                        storageNewReadP(storageLocal(), strNewFmt("%s/%s", strZ(walPath), strZ(walFile))));
+                    String *const name = strNewFmt("%s-%s", strZ(walFile), strZ(walSegmentChecksum));
+
+                    if (compressType != compressTypeNone)
+                    {
+                        ioFilterGroupAdd(ioReadFilterGroup(read), compressFilterP(compressType, compressLevel, .dict = dict));
+                        compressExtCat(name, compressType);
+                    }
+
+                    if (repoData->cipherType != cipherTypeNone)
+                    {
+                        ioFilterGroupAdd(
+                            ioReadFilterGroup(read),
+                            cipherBlockNewP(cipherModeEncrypt, repoData->cipherType, BUFSTR(repoData->cipherPass)));
+                    }
+
+                    strLstAdd(nameList, name);
+                    lstAdd(readList, &read);
+                }
+
+                // Write the bundle if the repo needs any of the WAL segments
+                if (!strLstEmpty(nameList))
+                {
+                    TRY_BEGIN()
+                    {
+                        walBundleWrite(
+                            storageWriteIo(
+                                storageNewWriteP(
+                                    storageRepoIdxWrite(repoData->repoIdx),
+                                    strNewFmt(
+                                        STORAGE_REPO_ARCHIVE "/%s/%s/%s", strZ(repoData->archiveId), strZ(walSegmentPath),
+                                        strZ(
+                                            walBundleName(
+                                                strSubN(strLstGet(nameList, 0), 0, WAL_SEGMENT_NAME_SIZE),
+                                                strSubN(
+                                                    strLstGet(nameList, strLstSize(nameList) - 1), 0, WAL_SEGMENT_NAME_SIZE)))),
+                                    .compressible = compressType == compressTypeNone && repoData->cipherType == cipherTypeNone)),
+                            nameList, readList);
+                    }
+                    CATCH_ANY()
+                    {
+                        archivePushErrorAdd(errorList, repoData->repoIdx);
+                    }
+                    TRY_END();
+                }
+            }
+            MEM_CONTEXT_TEMP_END();
+        }
+
+        // Throw any errors, even if some pushes were successful. It is important that PostgreSQL receives an error so it does not
+        // remove the files.
+        if (strLstSize(errorList) > 0)
+            THROW_FMT(CommandError, CFGCMD_ARCHIVE_PUSH " command encountered error(s):\n%s", strZ(strLstJoin(errorList, "\n")));
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_LOG_RETURN_STRUCT(result);
+}
@@ -29,10 +29,18 @@ typedef struct ArchivePushFileResult
     StringList *warnList;                                           // Warnings from a successful operation
 } ArchivePushFileResult;
 
-// Copy a file from the source to the archive
+// Copy a file from the source to the archive. When compressDict is set WAL segments are compressed with the archive dictionary if
+// all repos that need the segment have the same dictionary.
 FN_EXTERN ArchivePushFileResult archivePushFile(
     const String *walSource, bool headerCheck, bool modeCheck, unsigned int pgVersion, uint64_t pgSystemId,
-    const String *archiveFile, CompressType compressType, int compressLevel, const List *repoList,
+    const String *archiveFile, CompressType compressType, int compressLevel, bool compressDict, const List *repoList,
+    const StringList *priorErrorList);
+
+// Copy consecutive WAL segments from the same WAL path to a bundle in the archive. The segments are compressed (and encrypted) the
+// same way as archivePushFile() would store them but the archive dictionary of each repo is used.
+FN_EXTERN ArchivePushFileResult archivePushBundle(
+    const String *walPath, const StringList *walFileList, bool headerCheck, bool modeCheck, unsigned int pgVersion,
+    uint64_t pgSystemId, CompressType compressType, int compressLevel, bool compressDict, const List *repoList,
     const StringList *priorErrorList);
 
 #endif
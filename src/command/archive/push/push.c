@@ -6,6 +6,7 @@ Archive Push Command
 #include <string.h>
 #include <unistd.h>
 
+#include "command/archive/bundle.h"
 #include "command/archive/common.h"
 #include "command/archive/push/file.h"
 #include "command/archive/push/protocol.h"
@@ -37,6 +38,11 @@ Ready file extension constants
 #define STATUS_EXT_READY                                            ".ready"
 #define STATUS_EXT_READY_SIZE                                       (sizeof(STATUS_EXT_READY) - 1)
 
+/***********************************************************************************************************************************
+Time to sleep between checks for new WAL files while the async process lingers
+***********************************************************************************************************************************/
+#define ARCHIVE_PUSH_LINGER_SLEEP                                   100
+
 /***********************************************************************************************************************************
 Format the warning when a file is dropped
 ***********************************************************************************************************************************/
@@ -268,7 +274,7 @@ archivePushCheck(const bool pgPathSet)
                     {
                         .repoIdx = repoIdx,
                         .archiveId = strDup(archiveId),
-                        .cipherType = repoCipherType,
+                        .cipherType = infoArchiveCipherType(info),
                         .cipherPass = strDup(infoArchiveCipherPass(info)),
                     };
 
@@ -413,7 +419,8 @@ cmdArchivePush(void)
                 const ArchivePushFileResult fileResult = archivePushFile(
                     walFile, cfgOptionBool(cfgOptArchiveHeaderCheck), cfgOptionBool(cfgOptArchiveModeCheck), archiveInfo.pgVersion,
                     archiveInfo.pgSystemId, archiveFile, compressTypeEnum(cfgOptionStrId(cfgOptCompressType)),
-                    cfgOptionInt(cfgOptCompressLevel), archiveInfo.repoList, archiveInfo.errorList);
+                    cfgOptionInt(cfgOptCompressLevel), cfgOptionBool(cfgOptArchiveDict), archiveInfo.repoList,
+                    archiveInfo.errorList);
 
                 // If a warning was returned then log it
                 for (unsigned int warnIdx = 0; warnIdx < strLstSize(fileResult.warnList); warnIdx++)
@@ -437,9 +444,67 @@ typedef struct ArchivePushAsyncData
     unsigned int walFileIdx;                                        // Current index in the list to be processed
     CompressType compressType;                                      // Type of compression for WAL segments
     int compressLevel;                                              // Compression level for wal files
+    bool compressDict;                                              // Compress wal files with the archive dictionary?
+    bool bundle;                                                    // Bundle wal segments?
+    uint64_t bundleSize;                                            // Size of wal segments to store in a bundle
     ArchivePushCheckResult archiveInfo;                             // Archive info
 } ArchivePushAsyncData;
 
+/***********************************************************************************************************************************
+Get the WAL files to push in the next job. When bundling, consecutive WAL segments in the same WAL path are pushed in a single job
+until the bundle size is reached. Other files, e.g. partial and history files, are always pushed in a job of their own. The full
+parameter is set to false when more WAL segments could be added to the bundle if they were ready.
+***********************************************************************************************************************************/
+static StringList *
+archivePushAsyncJobList(
+    const ArchivePushAsyncData *const jobData, const StringList *const walFileList, const unsigned int walFileIdx, bool *const full)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, jobData);
+        FUNCTION_TEST_PARAM(STRING_LIST, walFileList);
+        FUNCTION_TEST_PARAM(UINT, walFileIdx);
+        FUNCTION_TEST_PARAM_P(BOOL, full);
+    FUNCTION_TEST_END();
+
+    ASSERT(jobData != NULL);
+    ASSERT(walFileList != NULL);
+    ASSERT(walFileIdx < strLstSize(walFileList));
+    ASSERT(full != NULL);
+
+    StringList *const result = strLstNew();
+    const String *const walFile = strLstGet(walFileList, walFileIdx);
+
+    strLstAdd(result, walFile);
+    *full = true;
+
+    if (jobData->bundle && walIsSegment(walFile) && !walIsPartial(walFile))
+    {
+        MEM_CONTEXT_TEMP_BEGIN()
+        {
+            const String *const walSegmentPath = strSubN(walFile, 0, 16);
+            uint64_t bundleSize = storageInfoP(storageLocal(), strNewFmt("%s/%s", strZ(jobData->walPath), strZ(walFile))).size;
+            unsigned int bundleIdx = walFileIdx + 1;
+
+            while (bundleSize < jobData->bundleSize && bundleIdx < strLstSize(walFileList))
+            {
+                const String *const bundleFile = strLstGet(walFileList, bundleIdx);
+
+                if (!walIsSegment(bundleFile) || walIsPartial(bundleFile) || !strEq(strSubN(bundleFile, 0, 16), walSegmentPath))
+                    break;
+
+                strLstAdd(result, bundleFile);
+                bundleSize += storageInfoP(storageLocal(), strNewFmt("%s/%s", strZ(jobData->walPath), strZ(bundleFile))).size;
+                bundleIdx++;
+            }
+
+            *full = bundleSize >= jobData->bundleSize || bundleIdx < strLstSize(walFileList);
+        }
+        MEM_CONTEXT_TEMP_END();
+    }
+
+    FUNCTION_TEST_RETURN(STRING_LIST, result);
+}
+
 static ProtocolParallelJob *
 archivePushAsyncCallback(void *const data, const unsigned int clientIdx)
 {
@@ -460,20 +525,38 @@ archivePushAsyncCallback(void *const data, const unsigned int clientIdx)
 
         if (jobData->walFileIdx < strLstSize(jobData->walFileList))
         {
-            const String *const walFile = strLstGet(jobData->walFileList, jobData->walFileIdx);
-            jobData->walFileIdx++;
+            bool full;
+            const StringList *const walFileList = archivePushAsyncJobList(
+                jobData, jobData->walFileList, jobData->walFileIdx, &full);
+            const String *const walFile = strLstGet(walFileList, 0);
+            const bool bundle = strLstSize(walFileList) > 1;
+
+            jobData->walFileIdx += strLstSize(walFileList);
 
-            ProtocolCommand *const command = protocolCommandNew(PROTOCOL_COMMAND_ARCHIVE_PUSH_FILE);
+            // Push a bundle when there is more than one WAL segment, else push the file
+            ProtocolCommand *const command = protocolCommandNew(
+                bundle ? PROTOCOL_COMMAND_ARCHIVE_PUSH_BUNDLE : PROTOCOL_COMMAND_ARCHIVE_PUSH_FILE);
             PackWrite *const param = protocolCommandParam(command);
 
-            pckWriteStrP(param, strNewFmt("%s/%s", strZ(jobData->walPath), strZ(walFile)));
+            if (bundle)
+            {
+                pckWriteStrP(param, jobData->walPath);
+                pckWriteStrLstP(param, walFileList);
+            }
+            else
+                pckWriteStrP(param, strNewFmt("%s/%s", strZ(jobData->walPath), strZ(walFile)));
+
             pckWriteBoolP(param, cfgOptionBool(cfgOptArchiveHeaderCheck));
             pckWriteBoolP(param, cfgOptionBool(cfgOptArchiveModeCheck));
             pckWriteU32P(param, jobData->archiveInfo.pgVersion);
             pckWriteU64P(param, jobData->archiveInfo.pgSystemId);
-            pckWriteStrP(param, walFile);
+
+            if (!bundle)
+                pckWriteStrP(param, walFile);
+
             pckWriteU32P(param, jobData->compressType);
             pckWriteI32P(param, jobData->compressLevel);
+            pckWriteBoolP(param, jobData->compressDict);
             pckWriteStrLstP(param, jobData->archiveInfo.errorList);
 
             // Add data for each repo to push to
@@ -493,9 +576,12 @@ archivePushAsyncCallback(void *const data, const unsigned int clientIdx)
 
             pckWriteArrayEndP(param);
 
+            // The job key is the list of WAL files when pushing a bundle
+            const Variant *const jobKey = bundle ? varNewVarLst(varLstNewStrLst(walFileList)) : VARSTR(walFile);
+
             MEM_CONTEXT_PRIOR_BEGIN()
             {
-                result = protocolParallelJobNew(VARSTR(walFile), command);
+                result = protocolParallelJobNew(jobKey, command);
             }
             MEM_CONTEXT_PRIOR_END();
         }
@@ -505,6 +591,151 @@ archivePushAsyncCallback(void *const data, const unsigned int clientIdx)
     FUNCTION_TEST_RETURN(PROTOCOL_PARALLEL_JOB, result);
 }
 
+/***********************************************************************************************************************************
+Push a list of WAL files with the parallel executor. Returns false if any file could not be pushed.
+***********************************************************************************************************************************/
+static bool
+archivePushAsyncProcess(ArchivePushAsyncData *const jobData)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM_P(VOID, jobData);
+    FUNCTION_LOG_END();
+
+    ASSERT(jobData != NULL);
+
+    bool result = true;
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        // Create the parallel executor. Local processes are cached by the protocol helper so they are reused on each call.
+        ProtocolParallel *const parallelExec = protocolParallelNewP(
+            cfgOptionUInt64(cfgOptProtocolTimeout) / 2, archivePushAsyncCallback, jobData,
+            .jobMax = cfgOptionUInt(cfgOptProcessJobMax));
+
+        for (unsigned int processIdx = 1; processIdx <= cfgOptionUInt(cfgOptProcessMax); processIdx++)
+            protocolParallelClientAdd(parallelExec, protocolLocalGet(protocolStorageTypeRepo, 0, processIdx));
+
+        // WAL segments in bundles that could not be pushed. These are retried individually so one bad segment does not prevent the
+        // other segments in the bundle from being archived.
+        StringList *const retryList = strLstNew();
+
+        // Process jobs
+        MEM_CONTEXT_TEMP_RESET_BEGIN()
+        {
+            do
+            {
+                const unsigned int completed = protocolParallelProcess(parallelExec);
+
+                for (unsigned int jobIdx = 0; jobIdx < completed; jobIdx++)
+                {
+                    protocolKeepAlive();
+
+                    // Get the job and job key. A bundle job key is the list of WAL files in the bundle.
+                    ProtocolParallelJob *const job = protocolParallelResult(parallelExec);
+                    const unsigned int processId = protocolParallelJobProcessId(job);
+                    const Variant *const jobKey = protocolParallelJobKey(job);
+                    StringList *const walFileList =
+                        varType(jobKey) == varTypeString ? strLstNew() : strLstNewVarLst(varVarLst(jobKey));
+
+                    if (varType(jobKey) == varTypeString)
+                        strLstAdd(walFileList, varStr(jobKey));
+
+                    // The job was successful
+                    if (protocolParallelJobErrorCode(job) == 0)
+                    {
+                        // Output file warnings
+                        const StringList *const fileWarnList = pckReadStrLstP(protocolParallelJobResult(job));
+
+                        for (unsigned int warnIdx = 0; warnIdx < strLstSize(fileWarnList); warnIdx++)
+                            LOG_WARN_PID(processId, strZ(strLstGet(fileWarnList, warnIdx)));
+
+                        // Log success and write the status files. Bundled files are only acknowledged after the bundle has been
+                        // written to all repos.
+                        for (unsigned int walFileIdx = 0; walFileIdx < strLstSize(walFileList); walFileIdx++)
+                        {
+                            const String *const walFile = strLstGet(walFileList, walFileIdx);
+
+                            LOG_DETAIL_PID_FMT(processId, "pushed WAL file '%s' to the archive", strZ(walFile));
+
+                            archiveAsyncStatusOkWrite(
+                                archiveModePush, walFile, strLstEmpty(fileWarnList) ? NULL : strLstJoin(fileWarnList, "\n"));
+                        }
+                    }
+                    // Else the bundle errored so retry the WAL segments individually
+                    else if (strLstSize(walFileList) > 1)
+                    {
+                        LOG_WARN_PID_FMT(
+                            processId,
+                            "could not push WAL bundle '%s' to the archive (segments will be pushed individually): [%d] %s",
+                            strZ(walBundleName(strLstGet(walFileList, 0), strLstGet(walFileList, strLstSize(walFileList) - 1))),
+                            protocolParallelJobErrorCode(job), strZ(protocolParallelJobErrorMessage(job)));
+
+                        for (unsigned int walFileIdx = 0; walFileIdx < strLstSize(walFileList); walFileIdx++)
+                            strLstAdd(retryList, strLstGet(walFileList, walFileIdx));
+                    }
+                    // Else the job errored
+                    else
+                    {
+                        for (unsigned int walFileIdx = 0; walFileIdx < strLstSize(walFileList); walFileIdx++)
+                        {
+                            const String *const walFile = strLstGet(walFileList, walFileIdx);
+
+                            LOG_WARN_PID_FMT(
+                                processId,
+                                "could not push WAL file '%s' to the archive (will be retried): [%d] %s", strZ(walFile),
+                                protocolParallelJobErrorCode(job), strZ(protocolParallelJobErrorMessage(job)));
+
+                            archiveAsyncStatusErrorWrite(
+                                archiveModePush, walFile, protocolParallelJobErrorCode(job), protocolParallelJobErrorMessage(job));
+                        }
+
+                        result = false;
+                    }
+
+                    protocolParallelJobFree(job);
+                }
+
+                // Reset the memory context occasionally so we don't use too much memory or slow down processing
+                MEM_CONTEXT_TEMP_RESET(1000);
+            }
+            while (!protocolParallelDone(parallelExec));
+        }
+        MEM_CONTEXT_TEMP_END();
+
+        // Push the WAL segments from failed bundles individually
+        if (!strLstEmpty(retryList))
+        {
+            ArchivePushAsyncData retryData = *jobData;
+            retryData.walFileList = retryList;
+            retryData.walFileIdx = 0;
+            retryData.bundle = false;
+
+            if (!archivePushAsyncProcess(&retryData))
+                result = false;
+        }
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_LOG_RETURN(BOOL, result);
+}
+
+/***********************************************************************************************************************************
+Keep local and remote processes alive while the async process is waiting for more WAL files to push
+***********************************************************************************************************************************/
+static void
+archivePushAsyncKeepAlive(void)
+{
+    FUNCTION_LOG_VOID(logLevelTrace);
+
+    protocolKeepAlive();
+
+    for (unsigned int processIdx = 1; processIdx <= cfgOptionUInt(cfgOptProcessMax); processIdx++)
+        protocolClientNoOp(protocolLocalGet(protocolStorageTypeRepo, 0, processIdx));
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+/**********************************************************************************************************************************/
 FN_EXTERN void
 cmdArchivePushAsync(void)
 {
@@ -528,6 +759,9 @@ cmdArchivePushAsync(void)
             .walPath = strLstGet(commandParam, 0),
             .compressType = compressTypeEnum(cfgOptionStrId(cfgOptCompressType)),
             .compressLevel = cfgOptionInt(cfgOptCompressLevel),
+            .compressDict = cfgOptionBool(cfgOptArchiveDict),
+            .bundle = cfgOptionBool(cfgOptArchivePushBundle),
+            .bundleSize = cfgOptionTest(cfgOptArchivePushBundleSize) ? cfgOptionUInt64(cfgOptArchivePushBundleSize) : 0,
         };
 
         TRY_BEGIN()
@@ -542,91 +776,136 @@ cmdArchivePushAsync(void)
             if (strLstEmpty(jobData.walFileList))
                 THROW(AssertError, "no WAL files to process");
 
-            LOG_INFO_FMT(
-                "push %u WAL file(s) to archive: %s%s", strLstSize(jobData.walFileList), strZ(strLstGet(jobData.walFileList, 0)),
-                strLstSize(jobData.walFileList) == 1 ?
-                    "" : zNewFmt("...%s", strZ(strLstGet(jobData.walFileList, strLstSize(jobData.walFileList) - 1))));
-
-            // Drop files if queue max has been exceeded
-            if (cfgOptionTest(cfgOptArchivePushQueueMax) && archivePushDrop(jobData.walPath, jobData.walFileList))
+            // When lingering, the process keeps checking for new WAL files until none have been found for the linger time. The
+            // local/remote processes stay running so the next WAL files are pushed without startup overhead.
+            const TimeMSec linger = cfgOptionUInt64(cfgOptArchivePushLinger);
+            const TimeMSec keepAliveTime = cfgOptionUInt64(cfgOptProtocolTimeout) / 2;
+            TimeMSec lingerBegin = 0;
+            TimeMSec keepAliveBegin = 0;
+            bool lingerEnd = false;
+
+            // WAL segments that would not fill a bundle are held until the bundle delay expires so more segments can be added
+            const TimeMSec bundleDelay =
+                cfgOptionTest(cfgOptArchivePushBundleDelay) ? cfgOptionUInt64(cfgOptArchivePushBundleDelay) : 0;
+            TimeMSec holdBegin = 0;
+            bool walFileHeld = false;
+
+            MEM_CONTEXT_TEMP_RESET_BEGIN()
             {
-                for (unsigned int walFileIdx = 0; walFileIdx < strLstSize(jobData.walFileList); walFileIdx++)
+                do
                 {
-                    const String *const walFile = strLstGet(jobData.walFileList, walFileIdx);
-                    const String *const warning = archivePushDropWarning(walFile, cfgOptionUInt64(cfgOptArchivePushQueueMax));
+                    // Wait for more WAL files when lingering or holding WAL segments for a bundle
+                    if (lingerBegin != 0 || walFileHeld)
+                    {
+                        sleepMSec(ARCHIVE_PUSH_LINGER_SLEEP);
 
-                    archiveAsyncStatusOkWrite(archiveModePush, walFile, warning);
-                    LOG_WARN(strZ(warning));
-                }
-            }
-            // Else continue processing
-            else
-            {
-                // Check archive info for each repo
-                jobData.archiveInfo = archivePushCheck(true);
+                        // Stop lingering if the stop file has been created
+                        lockStopTest();
+
+                        // Keep local and remote processes alive
+                        if (timeMSec() - keepAliveBegin >= keepAliveTime)
+                        {
+                            archivePushAsyncKeepAlive();
+                            keepAliveBegin = timeMSec();
+                        }
 
-                // Create the parallel executor
-                ProtocolParallel *const parallelExec = protocolParallelNew(
-                    cfgOptionUInt64(cfgOptProtocolTimeout) / 2, archivePushAsyncCallback, &jobData);
+                        jobData.walFileList = archivePushProcessList(jobData.walPath);
+                    }
 
-                for (unsigned int processIdx = 1; processIdx <= cfgOptionUInt(cfgOptProcessMax); processIdx++)
-                    protocolParallelClientAdd(parallelExec, protocolLocalGet(protocolStorageTypeRepo, 0, processIdx));
+                    // Find WAL segments at the end of the list that would not fill a bundle and hold them until the delay expires
+                    walFileHeld = false;
 
-                // Process jobs
-                MEM_CONTEXT_TEMP_RESET_BEGIN()
-                {
-                    do
+                    if (bundleDelay > 0)
                     {
-                        const unsigned int completed = protocolParallelProcess(parallelExec);
+                        unsigned int walFileIdx = 0;
+                        bool full = true;
 
-                        for (unsigned int jobIdx = 0; jobIdx < completed; jobIdx++)
+                        while (walFileIdx < strLstSize(jobData.walFileList))
                         {
-                            protocolKeepAlive();
+                            const StringList *const walFileList = archivePushAsyncJobList(
+                                &jobData, jobData.walFileList, walFileIdx, &full);
 
-                            // Get the job and job key
-                            ProtocolParallelJob *const job = protocolParallelResult(parallelExec);
-                            const unsigned int processId = protocolParallelJobProcessId(job);
-                            const String *const walFile = varStr(protocolParallelJobKey(job));
+                            if (full)
+                                walFileIdx += strLstSize(walFileList);
+                            else
+                                break;
+                        }
 
-                            // The job was successful
-                            if (protocolParallelJobErrorCode(job) == 0)
-                            {
-                                // Output file warnings
-                                const StringList *const fileWarnList = pckReadStrLstP(protocolParallelJobResult(job));
+                        if (full)
+                            holdBegin = 0;
+                        else
+                        {
+                            if (holdBegin == 0)
+                                holdBegin = timeMSec();
 
-                                for (unsigned int warnIdx = 0; warnIdx < strLstSize(fileWarnList); warnIdx++)
-                                    LOG_WARN_PID(processId, strZ(strLstGet(fileWarnList, warnIdx)));
+                            if (timeMSec() - holdBegin < bundleDelay)
+                            {
+                                StringList *const walFileList = strLstNew();
 
-                                // Log success
-                                LOG_DETAIL_PID_FMT(processId, "pushed WAL file '%s' to the archive", strZ(walFile));
+                                for (unsigned int walFileHoldIdx = 0; walFileHoldIdx < walFileIdx; walFileHoldIdx++)
+                                    strLstAdd(walFileList, strLstGet(jobData.walFileList, walFileHoldIdx));
 
-                                // Write the status file
-                                archiveAsyncStatusOkWrite(
-                                    archiveModePush, walFile, strLstEmpty(fileWarnList) ? NULL : strLstJoin(fileWarnList, "\n"));
+                                jobData.walFileList = walFileList;
+                                walFileHeld = true;
                             }
-                            // Else the job errored
                             else
+                                holdBegin = 0;
+                        }
+                    }
+
+                    if (!strLstEmpty(jobData.walFileList))
+                    {
+                        LOG_INFO_FMT(
+                            "push %u WAL file(s) to archive: %s%s", strLstSize(jobData.walFileList),
+                            strZ(strLstGet(jobData.walFileList, 0)),
+                            strLstSize(jobData.walFileList) == 1 ?
+                                "" :
+                                zNewFmt("...%s", strZ(strLstGet(jobData.walFileList, strLstSize(jobData.walFileList) - 1))));
+
+                        // Drop files if queue max has been exceeded
+                        if (cfgOptionTest(cfgOptArchivePushQueueMax) && archivePushDrop(jobData.walPath, jobData.walFileList))
+                        {
+                            for (unsigned int walFileIdx = 0; walFileIdx < strLstSize(jobData.walFileList); walFileIdx++)
                             {
-                                LOG_WARN_PID_FMT(
-                                    processId,
-                                    "could not push WAL file '%s' to the archive (will be retried): [%d] %s", strZ(walFile),
-                                    protocolParallelJobErrorCode(job), strZ(protocolParallelJobErrorMessage(job)));
-
-                                archiveAsyncStatusErrorWrite(
-                                    archiveModePush, walFile, protocolParallelJobErrorCode(job),
-                                    protocolParallelJobErrorMessage(job));
+                                const String *const walFile = strLstGet(jobData.walFileList, walFileIdx);
+                                const String *const warning = archivePushDropWarning(
+                                    walFile, cfgOptionUInt64(cfgOptArchivePushQueueMax));
+
+                                archiveAsyncStatusOkWrite(archiveModePush, walFile, warning);
+                                LOG_WARN(strZ(warning));
                             }
+                        }
+                        // Else continue processing
+                        else
+                        {
+                            // Check archive info for each repo before every batch. A stanza-upgrade may happen while the process
+                            // lingers and WAL must then be pushed to the new archive id. The result is only used for this batch
+                            // so it is freed when the memory context is reset.
+                            jobData.archiveInfo = archivePushCheck(true);
 
-                            protocolParallelJobFree(job);
+                            // Push the files. Stop lingering if any files could not be pushed so the error is reported and the
+                            // files are retried by a new async process.
+                            jobData.walFileIdx = 0;
+
+                            if (!archivePushAsyncProcess(&jobData))
+                                lingerEnd = true;
                         }
 
-                        // Reset the memory context occasionally so we don't use too much memory or slow down processing
-                        MEM_CONTEXT_TEMP_RESET(1000);
+                        // Restart the linger time
+                        lingerBegin = timeMSec();
+                        keepAliveBegin = lingerBegin;
                     }
-                    while (!protocolParallelDone(parallelExec));
+
+                    // Stop when the linger time has expired and no WAL segments are being held
+                    if (!walFileHeld && timeMSec() - lingerBegin >= linger)
+                        lingerEnd = true;
+
+                    // Reset the memory context occasionally so we don't use too much memory while lingering
+                    MEM_CONTEXT_TEMP_RESET(1000);
                 }
-                MEM_CONTEXT_TEMP_END();
+                while (!lingerEnd);
             }
+            MEM_CONTEXT_TEMP_END();
         }
         // On any global error write a single error file to cover all unprocessed files
         CATCH_FATAL()
@@ -8,8 +8,10 @@ Backup Command
 #include <time.h>
 #include <unistd.h>
 
+#include "command/archive/common.h"
 #include "command/archive/find.h"
 #include "command/backup/backup.h"
+#include "command/backup/blockIndex.h"
 #include "command/backup/common.h"
 #include "command/backup/file.h"
 #include "command/backup/protocol.h"
@@ -19,6 +21,8 @@ Backup Command
 #include "common/compress/helper.h"
 #include "common/crypto/cipherBlock.h"
 #include "common/debug.h"
+#include "common/io/bufferRead.h"
+#include "common/io/bufferWrite.h"
 #include "common/io/filter/size.h"
 #include "common/lock.h"
 #include "common/log.h"
@@ -687,6 +691,7 @@ backupBuildIncr(
 
             // Set the cipher subpass from prior manifest since we want a single subpass for the entire backup set
             manifestCipherSubPassSet(manifest, manifestCipherSubPass(manifestPrior));
+            manifestCipherTypeSet(manifest, manifestCipherType(manifestPrior));
 
             // Incremental was built
             result = true;
@@ -697,6 +702,150 @@ backupBuildIncr(
     FUNCTION_LOG_RETURN(BOOL, result);
 }
 
+/***********************************************************************************************************************************
+Save and replay the manifest journal
+
+Saving the full manifest copy is O(n) in the number of files in the cluster, which is expensive to repeat during processing when
+the cluster has millions of files. Instead, files completed since the last save are written to a new segment in the journal path.
+Segments are written as separate files because repository storage does not support append. The journal is replayed onto the
+manifest copy when the backup is resumed and removed whenever the full manifest copy is saved.
+***********************************************************************************************************************************/
+#define BACKUP_MANIFEST_JOURNAL_PATH                                BACKUP_MANIFEST_FILE ".journal"
+
+static void
+backupManifestJournalSave(
+    const Manifest *const manifest, const String *const cipherPassBackup, const StringList *const fileList,
+    const unsigned int segmentIdx)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(MANIFEST, manifest);
+        FUNCTION_TEST_PARAM(STRING, cipherPassBackup);
+        FUNCTION_LOG_PARAM(STRING_LIST, fileList);
+        FUNCTION_LOG_PARAM(UINT, segmentIdx);
+    FUNCTION_LOG_END();
+
+    ASSERT(manifest != NULL);
+    ASSERT(fileList != NULL);
+
+    // The journal is only useful for resume, so only save it when resume is enabled
+    if (cfgOptionBool(cfgOptResume) && !strLstEmpty(fileList))
+    {
+        MEM_CONTEXT_TEMP_BEGIN()
+        {
+            IoWrite *const write = storageWriteIo(
+                storageNewWriteP(
+                    storageRepoWrite(),
+                    strNewFmt(
+                        STORAGE_REPO_BACKUP "/%s/" BACKUP_MANIFEST_JOURNAL_PATH "/%08u", strZ(manifestData(manifest)->backupLabel),
+                        segmentIdx)));
+
+            cipherBlockFilterGroupAdd(
+                ioWriteFilterGroup(write), cfgOptionStrId(cfgOptRepoCipherType), cipherModeEncrypt, cipherPassBackup);
+            ioWriteOpen(write);
+
+            // Write the fields updated when a file is copied
+            PackWrite *const pack = pckWriteNewIo(write);
+
+            for (unsigned int fileIdx = 0; fileIdx < strLstSize(fileList); fileIdx++)
+            {
+                const ManifestFile file = manifestFileFind(manifest, strLstGet(fileList, fileIdx));
+
+                pckWriteObjBeginP(pack);
+                pckWriteStrP(pack, file.name);
+                pckWriteU64P(pack, file.size);
+                pckWriteU64P(pack, file.sizeRepo);
+                pckWriteBinP(pack, BUF(file.checksumSha1, HASH_TYPE_SHA1_SIZE));
+                pckWriteBinP(pack, file.checksumRepoSha1 != NULL ? BUF(file.checksumRepoSha1, HASH_TYPE_SHA1_SIZE) : NULL);
+                pckWriteBinP(pack, file.checksumFast != NULL ? BUF(file.checksumFast, MANIFEST_CHECKSUM_FAST_SIZE) : NULL);
+                pckWriteBinP(
+                    pack, file.checksumRepoFast != NULL ? BUF(file.checksumRepoFast, MANIFEST_CHECKSUM_FAST_SIZE) : NULL);
+                pckWriteBoolP(pack, file.checksumPageError);
+                pckWriteStrP(pack, file.checksumPageErrorList);
+                pckWriteU64P(pack, file.bundleId);
+                pckWriteU64P(pack, file.bundleOffset);
+                pckWriteU64P(pack, file.blockIncrMapSize);
+                pckWriteObjEndP(pack);
+            }
+
+            pckWriteEndP(pack);
+            ioWriteClose(write);
+        }
+        MEM_CONTEXT_TEMP_END();
+    }
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+static void
+backupManifestJournalLoad(Manifest *const manifest, const String *const cipherPassBackup)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(MANIFEST, manifest);
+        FUNCTION_TEST_PARAM(STRING, cipherPassBackup);
+    FUNCTION_LOG_END();
+
+    ASSERT(manifest != NULL);
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        const String *const journalPath = strNewFmt(
+            STORAGE_REPO_BACKUP "/%s/" BACKUP_MANIFEST_JOURNAL_PATH, strZ(manifestData(manifest)->backupLabel));
+
+        // Segments must be replayed in the order they were written since a file may be updated in more than one segment
+        const StringList *const segmentList = strLstSort(
+            storageListP(storageRepo(), journalPath, .expression = STRDEF("^[0-9]{8}$")), sortOrderAsc);
+
+        for (unsigned int segmentIdx = 0; segmentIdx < strLstSize(segmentList); segmentIdx++)
+        {
+            StorageRead *const read = storageNewReadP(
+                storageRepo(), strNewFmt("%s/%s", strZ(journalPath), strZ(strLstGet(segmentList, segmentIdx))));
+
+            cipherBlockFilterGroupAdd(
+                ioReadFilterGroup(storageReadIo(read)), cfgOptionStrId(cfgOptRepoCipherType), cipherModeDecrypt,
+                cipherPassBackup);
+            ioReadOpen(storageReadIo(read));
+
+            PackRead *const pack = pckReadNewIo(storageReadIo(read));
+
+            while (!pckReadNullP(pack))
+            {
+                pckReadObjBeginP(pack);
+
+                ManifestFile file = manifestFileFind(manifest, pckReadStrP(pack));
+
+                file.size = pckReadU64P(pack);
+                file.sizeRepo = pckReadU64P(pack);
+                file.checksumSha1 = bufPtrConst(pckReadBinP(pack));
+
+                const Buffer *const checksumRepoSha1 = pckReadBinP(pack);
+                file.checksumRepoSha1 = checksumRepoSha1 != NULL ? bufPtrConst(checksumRepoSha1) : NULL;
+
+                const Buffer *const checksumFast = pckReadBinP(pack);
+                file.checksumFast = checksumFast != NULL ? bufPtrConst(checksumFast) : NULL;
+
+                const Buffer *const checksumRepoFast = pckReadBinP(pack);
+                file.checksumRepoFast = checksumRepoFast != NULL ? bufPtrConst(checksumRepoFast) : NULL;
+
+                file.reference = NULL;
+                file.checksumPageError = pckReadBoolP(pack);
+                file.checksumPageErrorList = pckReadStrP(pack);
+                file.bundleId = pckReadU64P(pack);
+                file.bundleOffset = pckReadU64P(pack);
+                file.blockIncrMapSize = pckReadU64P(pack);
+
+                pckReadObjEndP(pack);
+
+                manifestFileUpdate(manifest, &file);
+            }
+
+            pckReadEndP(pack);
+        }
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
 /***********************************************************************************************************************************
 Check for a backup that can be resumed and merge into the manifest if found
 ***********************************************************************************************************************************/
@@ -727,10 +876,13 @@ backupResumeClean(
         {
             const StorageInfo info = storageItrNext(storageItr);
 
-            // Skip backup.manifest.copy -- it must be preserved to allow resume again if this process throws an error before
-            // writing the manifest for the first time
-            if (manifestParentName == NULL && strEqZ(info.name, BACKUP_MANIFEST_FILE INFO_COPY_EXT))
+            // Skip backup.manifest.copy and the manifest journal -- they must be preserved to allow resume again if this process
+            // throws an error before writing the manifest for the first time
+            if (manifestParentName == NULL &&
+                (strEqZ(info.name, BACKUP_MANIFEST_FILE INFO_COPY_EXT) || strEqZ(info.name, BACKUP_MANIFEST_JOURNAL_PATH)))
+            {
                 continue;
+            }
 
             // Build the name used to lookup files in the manifest
             const String *manifestName =
@@ -816,6 +968,8 @@ backupResumeClean(
                                 file.sizeRepo = fileResume.sizeRepo;
                                 file.checksumSha1 = fileResume.checksumSha1;
                                 file.checksumRepoSha1 = fileResume.checksumRepoSha1;
+                                file.checksumFast = fileResume.checksumFast;
+                                file.checksumRepoFast = fileResume.checksumRepoFast;
                                 file.blockIncrSize = fileResume.blockIncrSize;
                                 file.blockIncrChecksumSize = fileResume.blockIncrChecksumSize;
                                 file.blockIncrMapSize = fileResume.blockIncrMapSize;
@@ -918,6 +1072,9 @@ backupResumeFind(const Manifest *const manifest, const String *const cipherPassB
                             {
                                 manifestResume = manifestLoadFile(
                                     storageRepo(), manifestFile, cfgOptionStrId(cfgOptRepoCipherType), cipherPassBackup);
+
+                                // Replay files completed since the manifest copy was saved
+                                backupManifestJournalLoad(manifestResume, cipherPassBackup);
                             }
                             CATCH_ANY()
                             {
@@ -1026,6 +1183,7 @@ backupResume(Manifest *const manifest, const String *const cipherPassBackup)
 
             // Copy cipher subpass since it was used to encrypt the resumable files
             manifestCipherSubPassSet(manifest, manifestCipherSubPass(manifestResume));
+            manifestCipherTypeSet(manifest, manifestCipherType(manifestResume));
 
             // Clean resumed backup
             const String *const backupPath = strNewFmt(STORAGE_REPO_BACKUP "/%s", strZ(manifestData(manifest)->backupLabel));
@@ -1396,16 +1554,20 @@ Log the results of a job and throw errors
 static void
 backupJobResult(
     Manifest *const manifest, const String *const host, const Storage *const storagePg, StringList *const fileRemove,
-    ProtocolParallelJob *const job, const bool bundle, const PgPageSize pageSize, const uint64_t sizeTotal,
-    uint64_t *const sizeProgress, unsigned int *const currentPercentComplete)
+    StringList *const fileJournal, ProtocolParallelJob *const job, const bool bundle, BlockIndex *const blockIndex,
+    List *const blockIndexPendingList, const PgPageSize pageSize, const uint64_t sizeTotal, uint64_t *const sizeProgress,
+    unsigned int *const currentPercentComplete)
 {
     FUNCTION_LOG_BEGIN(logLevelDebug);
         FUNCTION_LOG_PARAM(MANIFEST, manifest);
         FUNCTION_LOG_PARAM(STRING, host);
         FUNCTION_LOG_PARAM(STORAGE, storagePg);
         FUNCTION_LOG_PARAM(STRING_LIST, fileRemove);
+        FUNCTION_LOG_PARAM(STRING_LIST, fileJournal);
         FUNCTION_LOG_PARAM(PROTOCOL_PARALLEL_JOB, job);
         FUNCTION_LOG_PARAM(BOOL, bundle);
+        FUNCTION_LOG_PARAM(BLOCK_INDEX, blockIndex);
+        FUNCTION_LOG_PARAM(LIST, blockIndexPendingList);
         FUNCTION_LOG_PARAM(ENUM, pageSize);
         FUNCTION_LOG_PARAM(UINT64, sizeTotal);
         FUNCTION_LOG_PARAM_P(UINT64, sizeProgress);
@@ -1436,9 +1598,12 @@ backupJobResult(
                 const uint64_t copySize = pckReadU64P(jobResult);
                 const uint64_t bundleOffset = pckReadU64P(jobResult);
                 const uint64_t blockIncrMapSize = pckReadU64P(jobResult);
+                const Buffer *const blockIndexResult = pckReadBinP(jobResult);
                 const uint64_t repoSize = pckReadU64P(jobResult);
                 const Buffer *const copyChecksum = pckReadBinP(jobResult);
                 const Buffer *const repoChecksum = pckReadBinP(jobResult);
+                const Buffer *const copyChecksumFast = pckReadBinP(jobResult);
+                const Buffer *const repoChecksumFast = pckReadBinP(jobResult);
                 PackRead *const checksumPageResult = pckReadPackReadP(jobResult);
 
                 // Increment backup copy progress. Use the original size since the size may have changed during the copy but for the
@@ -1587,6 +1752,8 @@ backupJobResult(
                     file.sizeRepo = repoSize;
                     file.checksumSha1 = bufPtrConst(copyChecksum);
                     file.checksumRepoSha1 = repoChecksum != NULL ? bufPtrConst(repoChecksum) : NULL;
+                    file.checksumFast = copyChecksumFast != NULL ? bufPtrConst(copyChecksumFast) : NULL;
+                    file.checksumRepoFast = repoChecksumFast != NULL ? bufPtrConst(repoChecksumFast) : NULL;
                     file.reference = NULL;
                     file.checksumPageError = checksumPageError;
                     file.checksumPageErrorList =
@@ -1596,7 +1763,25 @@ backupJobResult(
                     file.bundleOffset = bundleOffset;
                     file.blockIncrMapSize = blockIncrMapSize;
 
+                    // Add the file to the journal before the update since the update frees the file name
+                    strLstAdd(fileJournal, file.name);
                     manifestFileUpdate(manifest, &file);
+
+                    // Add blocks stored by the file to the block index so they can be referenced by later files and backups
+                    if (blockIndex != NULL && blockIndexResult != NULL)
+                    {
+                        blockIndexAddRead(blockIndex, ioBufferReadNewOpen(blockIndexResult));
+
+                        // Also add the blocks to the blocks pending for other processes. The process that stored the blocks has
+                        // already added them to its index.
+                        for (unsigned int clientIdx = 0; clientIdx < lstSize(blockIndexPendingList); clientIdx++)
+                        {
+                            BlockIndex *const blockIndexPending = *(BlockIndex **)lstGet(blockIndexPendingList, clientIdx);
+
+                            if (blockIndexPending != NULL && clientIdx + 1 != processId)
+                                blockIndexAddRead(blockIndexPending, ioBufferReadNewOpen(blockIndexResult));
+                        }
+                    }
                 }
             }
 
@@ -1653,6 +1838,12 @@ backupManifestSaveCopy(Manifest *const manifest, const String *const cipherPassB
 
             // Save file
             manifestSave(manifest, write);
+
+            // The manifest copy includes all files in the journal so the journal is no longer needed
+            storagePathRemoveP(
+                storageRepoWrite(),
+                strNewFmt(STORAGE_REPO_BACKUP "/%s/" BACKUP_MANIFEST_JOURNAL_PATH, strZ(manifestData(manifest)->backupLabel)),
+                .recurse = true);
         }
         MEM_CONTEXT_TEMP_END();
     }
@@ -1698,13 +1889,22 @@ typedef struct BackupJobData
     const PgPageSize pageSize;                                      // Page size
     const CompressType compressType;                                // Backup compression type
     const int compressLevel;                                        // Compress level if backup is compressed
+    const unsigned int compressThread;                              // Max threads used to compress large files
+    const bool compressLong;                                        // Long distance matching for large files?
     const bool delta;                                               // Is this a checksum delta backup?
+    const bool checksumFast;                                        // Store fast checksums for delta/resume?
+    const InfoBackup *deltaLsnInfo;                                 // Backup info to find prior start LSNs (NULL if no delta-lsn)
+    RegExp *deltaLsnExp;                                            // Identify relation files that may be checked with page LSNs
+    const String *deltaLsnTimeline;                                 // Timeline of this backup used to check prior backups
     const bool bundle;                                              // Bundle files?
     uint64_t bundleSize;                                            // Target bundle size
     uint64_t bundleLimit;                                           // Limit on files to bundle
     uint64_t bundleId;                                              // Bundle id
     const bool blockIncr;                                           // Block incremental?
     size_t blockIncrSizeSuper;                                      // Super block size
+    const bool blockIncrDedup;                                      // Deduplicate blocks?
+    BlockIndex *blockIndex;                                         // Block index for the backup (NULL if no dedup)
+    List *blockIndexPendingList;                                    // Blocks not yet sent to each process (NULL before first job)
 
     List *queueList;                                                // List of processing queues
 } BackupJobData;
@@ -1725,6 +1925,52 @@ backupProcessFilePrimary(RegExp *const standbyExp, const String *const name)
         BOOL, strEqZ(name, MANIFEST_TARGET_PGDATA "/" PG_PATH_GLOBAL "/" PG_FILE_PGCONTROL) || !regExpMatch(standbyExp, name));
 }
 
+// Is the timeline of the WAL segment equal to the timeline? A missing segment never matches.
+static bool
+backupTimelineEq(const String *const timeline, const String *const walSegment)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(STRING, timeline);
+        FUNCTION_TEST_PARAM(STRING, walSegment);
+    FUNCTION_TEST_END();
+
+    ASSERT(timeline != NULL);
+
+    FUNCTION_TEST_RETURN(BOOL, walSegment != NULL && strBeginsWith(walSegment, timeline));
+}
+
+// Get the LSN limit used to determine if a file has changed by checking page LSNs, or 0 if page LSNs cannot be used for the file.
+// The limit is the start LSN of the backup that holds the prior copy of the file. Backups from a standby are excluded since there
+// is no guarantee that all pages up to the start LSN had been written to disk when files were copied from the standby. Backups on
+// another timeline are also excluded since after a PITR pages may be rewritten with LSNs lower than the start LSN of the backup.
+static uint64_t
+backupProcessFileLsnLimit(const BackupJobData *const jobData, const ManifestFile *const file)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, jobData);
+        FUNCTION_TEST_PARAM(MANIFEST_FILE, file);
+    FUNCTION_TEST_END();
+
+    ASSERT(jobData != NULL);
+    ASSERT(file != NULL);
+
+    uint64_t result = 0;
+
+    if (jobData->deltaLsnInfo != NULL && file->delta && file->reference != NULL && regExpMatch(jobData->deltaLsnExp, file->name))
+    {
+        const InfoBackupData *const backupData = infoBackupDataByLabel(jobData->deltaLsnInfo, file->reference);
+
+        if (backupData->backupLsnStart != NULL && !backupData->optionBackupStandby &&
+            backupTimelineEq(jobData->deltaLsnTimeline, backupData->backupArchiveStart) &&
+            backupTimelineEq(jobData->deltaLsnTimeline, backupData->backupArchiveStop))
+        {
+            result = pgLsnFromStr(backupData->backupLsnStart);
+        }
+    }
+
+    FUNCTION_TEST_RETURN(UINT64, result);
+}
+
 // Comparator to order ManifestFile objects by size, date, and name
 static const Manifest *backupProcessQueueComparatorManifest = NULL;
 static bool backupProcessQueueComparatorBundle;
@@ -1926,6 +2172,71 @@ backupJobQueueNext(const unsigned int clientIdx, int queueIdx, const unsigned in
 }
 
 // Callback to fetch backup jobs for the parallel executor
+/***********************************************************************************************************************************
+Send blocks stored in the backup set to a process. The first job sent to a process includes the entire block index and later jobs
+include only blocks stored by other processes since the prior job. This allows blocks stored by a file to be referenced by files
+backed up later in other processes without sending the entire index with every job.
+***********************************************************************************************************************************/
+static void
+backupJobBlockIndex(BackupJobData *const jobData, const unsigned int clientIdx, PackWrite *const param)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, jobData);
+        FUNCTION_TEST_PARAM(UINT, clientIdx);
+        FUNCTION_TEST_PARAM(PACK_WRITE, param);
+    FUNCTION_TEST_END();
+
+    ASSERT(jobData != NULL);
+    ASSERT(param != NULL);
+
+    // Nothing to send when not deduplicating
+    if (!jobData->blockIncrDedup)
+    {
+        pckWriteBoolP(param, false);
+        pckWriteBinP(param, NULL);
+    }
+    else
+    {
+        MEM_CONTEXT_TEMP_BEGIN()
+        {
+            while (lstSize(jobData->blockIndexPendingList) <= clientIdx)
+                lstAdd(jobData->blockIndexPendingList, &(BlockIndex *){NULL});
+
+            BlockIndex **const blockIndexPending = lstGet(jobData->blockIndexPendingList, clientIdx);
+            const bool reset = *blockIndexPending == NULL;
+            BlockIndex *const blockIndexSend = reset ? jobData->blockIndex : *blockIndexPending;
+            Buffer *update = NULL;
+
+            if (blockIndexSize(blockIndexSend) > 0)
+            {
+                update = bufNew(0);
+                IoWrite *const write = ioBufferWriteNewOpen(update);
+
+                blockIndexWrite(blockIndexSend, write, 0);
+                ioWriteClose(write);
+            }
+
+            pckWriteBoolP(param, reset);
+            pckWriteBinP(param, update);
+
+            // Start collecting blocks for the next job
+            if (reset || update != NULL)
+            {
+                blockIndexFree(*blockIndexPending);
+
+                MEM_CONTEXT_BEGIN(lstMemContext(jobData->blockIndexPendingList))
+                {
+                    *blockIndexPending = blockIndexNew();
+                }
+                MEM_CONTEXT_END();
+            }
+        }
+        MEM_CONTEXT_TEMP_END();
+    }
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
 static ProtocolParallelJob *
 backupJobCallback(void *const data, const unsigned int clientIdx)
 {
@@ -2005,13 +2316,18 @@ backupJobCallback(void *const data, const unsigned int clientIdx)
 
                     // Provide the backup reference
                     pckWriteU64P(param, strLstSize(manifestReferenceList(jobData->manifest)) - 1);
+                    pckWriteBoolP(param, jobData->blockIncrDedup);
+                    backupJobBlockIndex(jobData, clientIdx, param);
 
                     pckWriteU32P(param, jobData->compressType);
                     pckWriteI32P(param, jobData->compressLevel);
-                    pckWriteU64P(param, jobData->cipherSubPass == NULL ? cipherTypeNone : cipherTypeAes256Cbc);
+                    pckWriteU32P(param, jobData->compressThread);
+                    pckWriteBoolP(param, jobData->compressLong);
+                    pckWriteU64P(param, jobData->cipherSubPass == NULL ? cipherTypeNone : jobData->cipherType);
                     pckWriteStrP(param, jobData->cipherSubPass);
                     pckWriteU32P(param, jobData->pageSize);
                     pckWriteStrP(param, cfgOptionStrNull(cfgOptPgVersionForce));
+                    pckWriteBoolP(param, jobData->checksumFast);
                 }
 
                 pckWriteStrP(param, manifestPathPg(file.name));
@@ -2021,8 +2337,10 @@ backupJobCallback(void *const data, const unsigned int clientIdx)
                 pckWriteU64P(param, file.sizePrior);
                 pckWriteBoolP(param, !backupProcessFilePrimary(jobData->standbyExp, file.name));
                 pckWriteBinP(param, file.checksumSha1 != NULL ? BUF(file.checksumSha1, HASH_TYPE_SHA1_SIZE) : NULL);
+                pckWriteBinP(param, file.checksumFast != NULL ? BUF(file.checksumFast, MANIFEST_CHECKSUM_FAST_SIZE) : NULL);
                 pckWriteBoolP(param, file.checksumPage);
                 pckWriteBoolP(param, cfgOptionBool(cfgOptPageHeaderCheck));
+                pckWriteU64P(param, backupProcessFileLsnLimit(jobData, &file));
 
                 // If block incremental then provide the location of the prior map when available
                 if (blockIncr)
@@ -2048,6 +2366,8 @@ backupJobCallback(void *const data, const unsigned int clientIdx)
 
                 pckWriteStrP(param, file.name);
                 pckWriteBinP(param, file.checksumRepoSha1 != NULL ? BUF(file.checksumRepoSha1, HASH_TYPE_SHA1_SIZE) : NULL);
+                pckWriteBinP(
+                    param, file.checksumRepoFast != NULL ? BUF(file.checksumRepoFast, MANIFEST_CHECKSUM_FAST_SIZE) : NULL);
                 pckWriteU64P(param, file.sizeRepo);
                 pckWriteBoolP(param, file.resume);
                 pckWriteBoolP(param, file.reference != NULL);
@@ -2090,11 +2410,15 @@ backupJobCallback(void *const data, const unsigned int clientIdx)
 }
 
 static void
-backupProcess(const BackupData *const backupData, Manifest *const manifest, const String *const cipherPassBackup)
+backupProcess(
+    const BackupData *const backupData, const InfoBackup *const infoBackup, Manifest *const manifest,
+    const String *const archiveStart, const String *const cipherPassBackup)
 {
     FUNCTION_LOG_BEGIN(logLevelDebug);
         FUNCTION_LOG_PARAM(BACKUP_DATA, backupData);
+        FUNCTION_LOG_PARAM(INFO_BACKUP, infoBackup);
         FUNCTION_LOG_PARAM(MANIFEST, manifest);
+        FUNCTION_LOG_PARAM(STRING, archiveStart);
         FUNCTION_TEST_PARAM(STRING, cipherPassBackup);
     FUNCTION_LOG_END();
 
@@ -2118,13 +2442,17 @@ backupProcess(const BackupData *const backupData, Manifest *const manifest, cons
             .backupStandby = backupStandby,
             .compressType = compressTypeEnum(cfgOptionStrId(cfgOptCompressType)),
             .compressLevel = cfgOptionInt(cfgOptCompressLevel),
+            .compressThread = cfgOptionUInt(cfgOptCompressThread),
+            .compressLong = cfgOptionBool(cfgOptCompressLong),
             .cipherType = cfgOptionStrId(cfgOptRepoCipherType),
             .cipherSubPass = manifestCipherSubPass(manifest),
             .pageSize = backupData->pageSize,
             .delta = cfgOptionBool(cfgOptDelta),
+            .checksumFast = cfgOptionBool(cfgOptChecksumFast),
             .bundle = cfgOptionBool(cfgOptRepoBundle),
             .bundleId = 1,
             .blockIncr = cfgOptionBool(cfgOptRepoBlock),
+            .blockIncrDedup = cfgOptionBool(cfgOptRepoBlock) && cfgOptionBool(cfgOptRepoBlockDedup),
 
             // Build expression to identify files that can be copied from the standby when standby backup is supported
             .standbyExp = regExpNew(
@@ -2134,6 +2462,24 @@ backupProcess(const BackupData *const backupData, Manifest *const manifest, cons
                     strZ(pgXactPath(backupData->version)))),
         };
 
+        // Check page LSNs of relation main forks during delta when requested. Page LSNs are not used when copying files from a
+        // standby since the standby may not have written all pages up to the start LSN to disk. Page LSNs are also not used after a
+        // timeline switch since the prior backup. Timelines of the backups referenced by files are checked as each file is queued.
+        const InfoBackupData *const backupPrior =
+            manifestData(manifest)->backupLabelPrior != NULL ?
+                infoBackupDataByLabel(infoBackup, manifestData(manifest)->backupLabelPrior) : NULL;
+
+        if (jobData.delta && cfgOptionBool(cfgOptDeltaLsn) && !backupStandby && archiveStart != NULL && backupPrior != NULL &&
+            backupTimelineEq(strSubN(archiveStart, 0, 8), backupPrior->backupArchiveStop))
+        {
+            jobData.deltaLsnInfo = infoBackup;
+            jobData.deltaLsnTimeline = strSubN(archiveStart, 0, 8);
+            jobData.deltaLsnExp = regExpNew(
+                STRDEF(
+                    "^(" MANIFEST_TARGET_PGDATA "/(" PG_PATH_BASE "/[0-9]+|" PG_PATH_GLOBAL ")|" MANIFEST_TARGET_PGTBLSPC
+                    "/[0-9]+/[^/]+/[0-9]+)/[0-9]+(\\.[0-9]+)?$"));
+        }
+
         if (jobData.bundle)
         {
             jobData.bundleSize = cfgOptionUInt64(cfgOptRepoBundleSize);
@@ -2146,6 +2492,33 @@ backupProcess(const BackupData *const backupData, Manifest *const manifest, cons
             jobData.blockIncrSizeSuper =
                 backupType == backupTypeFull ?
                     (size_t)cfgOptionUInt64(cfgOptRepoBlockSizeSuperFull) : (size_t)cfgOptionUInt64(cfgOptRepoBlockSizeSuper);
+
+            // Load the block index of the prior backup when deduplicating. Blocks in the prior index are stored in backups that
+            // this backup depends on so they cannot be expired while this backup exists. The index of this backup starts as a
+            // copy of the prior index and blocks stored by this backup are added as files complete and sent to the processes with
+            // later jobs.
+            if (jobData.blockIncrDedup)
+            {
+                jobData.blockIndex = blockIndexNew();
+                jobData.blockIndexPendingList = lstNewP(sizeof(BlockIndex *));
+
+                if (manifestData(manifest)->backupLabelPrior != NULL)
+                {
+                    const String *const blockIndexFile = strNewFmt(
+                        STORAGE_REPO_BACKUP "/%s/" BLOCK_INDEX_FILE, strZ(manifestData(manifest)->backupLabelPrior));
+
+                    if (storageExistsP(storageRepo(), blockIndexFile))
+                    {
+                        StorageRead *const read = storageNewReadP(storageRepo(), blockIndexFile);
+
+                        cipherBlockFilterGroupAdd(
+                            ioReadFilterGroup(storageReadIo(read)), jobData.cipherType, cipherModeDecrypt, jobData.cipherSubPass);
+                        ioReadOpen(storageReadIo(read));
+
+                        blockIndexAddRead(jobData.blockIndex, storageReadIo(read));
+                    }
+                }
+            }
         }
 
         // If this is a full backup or hard-linked and paths are supported then create all paths explicitly so that empty paths will
@@ -2189,8 +2562,9 @@ backupProcess(const BackupData *const backupData, Manifest *const manifest, cons
         sizeTotal = backupProcessQueue(backupData, manifest, &jobData);
 
         // Create the parallel executor
-        ProtocolParallel *const parallelExec = protocolParallelNew(
-            cfgOptionUInt64(cfgOptProtocolTimeout) / 2, backupJobCallback, &jobData);
+        ProtocolParallel *const parallelExec = protocolParallelNewP(
+            cfgOptionUInt64(cfgOptProtocolTimeout) / 2, backupJobCallback, &jobData,
+            .jobMax = cfgOptionUInt(cfgOptProcessJobMax));
 
         // First client is always on the primary
         protocolParallelClientAdd(parallelExec, protocolLocalGet(protocolStorageTypePg, backupData->pgIdxPrimary, 1));
@@ -2206,7 +2580,11 @@ backupProcess(const BackupData *const backupData, Manifest *const manifest, cons
         // Maintain a list of files that need to be removed from the manifest when the backup is complete
         StringList *const fileRemove = strLstNew();
 
-        // Determine how often the manifest will be saved (every one percent or threshold size, whichever is greater)
+        // Maintain a list of files completed since the manifest journal was last saved
+        StringList *fileJournal = strLstNew();
+        unsigned int fileJournalSegment = 0;
+
+        // Determine how often the manifest journal will be saved (every one percent or threshold size, whichever is greater)
         uint64_t manifestSaveLast = 0;
         uint64_t manifestSaveSize = sizeTotal / 100;
 
@@ -2236,7 +2614,8 @@ backupProcess(const BackupData *const backupData, Manifest *const manifest, cons
                         manifest,
                         backupStandby && protocolParallelJobProcessId(job) > 1 ? backupData->hostStandby : backupData->hostPrimary,
                         protocolParallelJobProcessId(job) > 1 ? storagePgIdx(pgIdx) : backupData->storagePrimary,
-                        fileRemove, job, jobData.bundle, jobData.pageSize, sizeTotal, &sizeProgress, &currentPercentComplete);
+                        fileRemove, fileJournal, job, jobData.bundle, jobData.blockIndex, jobData.blockIndexPendingList,
+                        jobData.pageSize, sizeTotal, &sizeProgress, &currentPercentComplete);
                 }
 
                 // A keep-alive is required here for the remote holding open the backup connection
@@ -2245,11 +2624,20 @@ backupProcess(const BackupData *const backupData, Manifest *const manifest, cons
                 // Check that the clusters are alive and correctly configured during the backup
                 backupDbPing(backupData, false);
 
-                // Save the manifest periodically to preserve checksums for resume
+                // Save the manifest journal periodically to preserve checksums for resume
                 if (sizeProgress - manifestSaveLast >= manifestSaveSize)
                 {
-                    backupManifestSaveCopy(manifest, cipherPassBackup, false);
+                    backupManifestJournalSave(manifest, cipherPassBackup, fileJournal, fileJournalSegment);
                     manifestSaveLast = sizeProgress;
+                    fileJournalSegment++;
+
+                    strLstFree(fileJournal);
+
+                    MEM_CONTEXT_PRIOR_BEGIN()
+                    {
+                        fileJournal = strLstNew();
+                    }
+                    MEM_CONTEXT_PRIOR_END();
                 }
 
                 // Reset the memory context occasionally so we don't use too much memory or slow down processing
@@ -2270,6 +2658,18 @@ backupProcess(const BackupData *const backupData, Manifest *const manifest, cons
         for (unsigned int fileRemoveIdx = 0; fileRemoveIdx < strLstSize(fileRemove); fileRemoveIdx++)
             manifestFileRemove(manifest, strLstGet(fileRemove, fileRemoveIdx));
 
+        // Save the block index for the next backup
+        if (jobData.blockIndex != NULL)
+        {
+            IoWrite *const write = storageWriteIo(
+                storageNewWriteP(storageRepoWrite(), strNewFmt("%s/" BLOCK_INDEX_FILE, strZ(backupPathExp))));
+
+            cipherBlockFilterGroupAdd(ioWriteFilterGroup(write), jobData.cipherType, cipherModeEncrypt, jobData.cipherSubPass);
+            ioWriteOpen(write);
+            blockIndexWrite(jobData.blockIndex, write, 0);
+            ioWriteClose(write);
+        }
+
         // Log references or create hardlinks for all files
         const char *const compressExt = strZ(compressExtStr(jobData.compressType));
 
@@ -2389,11 +2789,21 @@ backupArchiveCheckCopy(const BackupData *const backupData, Manifest *const manif
                             filterGroup, cfgOptionStrId(cfgOptRepoCipherType), cipherModeDecrypt,
                             infoArchiveCipherPass(backupData->archiveInfo));
 
-                        // Compress/decompress if archive and backup do not have the same compression settings
-                        if (archiveCompressType != backupCompressType)
+                        // Get the archive dictionary in case the segment was compressed with it. Only zst supports dictionaries.
+                        const Buffer *const archiveDict =
+                            archiveCompressType == compressTypeZst ?
+                                archiveDictGet(
+                                    cfgOptionGroupIdxDefault(cfgOptGrpRepo), backupData->archiveId,
+                                    cfgOptionStrId(cfgOptRepoCipherType), infoArchiveCipherPass(backupData->archiveInfo)) :
+                                NULL;
+
+                        // Compress/decompress if archive and backup do not have the same compression settings. Segments that may
+                        // have been compressed with the archive dictionary are always recompressed since the backup does not store
+                        // the dictionary.
+                        if (archiveCompressType != backupCompressType || archiveDict != NULL)
                         {
                             if (archiveCompressType != compressTypeNone)
-                                ioFilterGroupAdd(filterGroup, decompressFilterP(archiveCompressType));
+                                ioFilterGroupAdd(filterGroup, decompressFilterP(archiveCompressType, .dict = archiveDict));
 
                             if (backupCompressType != compressTypeNone)
                             {
@@ -2479,6 +2889,22 @@ backupComplete(InfoBackup *const infoBackup, Manifest *const manifest)
             storageNewWriteP(
                 storageRepoWrite(), strNewFmt(STORAGE_REPO_BACKUP "/%s/" BACKUP_MANIFEST_FILE, strZ(backupLabel))));
 
+        // Save the binary manifest. This must happen after backup.manifest is saved since the binary manifest is preferred when
+        // loading and must not exist for a backup that is not complete.
+        if (cfgOptionBool(cfgOptManifestBinary))
+        {
+            IoWrite *const write = storageWriteIo(
+                storageNewWriteP(
+                    storageRepoWrite(),
+                    strNewFmt(STORAGE_REPO_BACKUP "/%s/" BACKUP_MANIFEST_FILE MANIFEST_BIN_EXT, strZ(backupLabel))));
+
+            cipherBlockFilterGroupAdd(
+                ioWriteFilterGroup(write), cfgOptionStrId(cfgOptRepoCipherType), cipherModeEncrypt,
+                infoPgCipherPass(infoBackupPg(infoBackup)));
+
+            manifestSaveBin(manifest, write);
+        }
+
         // Copy a compressed version of the manifest to history. If the repo is encrypted then the passphrase to open the manifest
         // is required. We can't just do a straight copy since the destination needs to be compressed and that must happen before
         // encryption in order to be efficient. Compression will always be gz for compatibility and since it is always available.
@@ -2590,7 +3016,10 @@ cmdBackup(void)
 
         // Build an incremental backup if type is not full (manifestPrior will be freed in this call)
         if (!backupBuildIncr(infoBackup, manifest, manifestPrior, backupStartResult.walSegmentName))
+        {
             manifestCipherSubPassSet(manifest, cipherPassGen(cfgOptionStrId(cfgOptRepoCipherType)));
+            manifestCipherTypeSet(manifest, cfgOptionStrId(cfgOptRepoCipherType));
+        }
 
         // Set delta if it is not already set and the manifest requires it
         if (!cfgOptionBool(cfgOptDelta) && varBool(manifestData(manifest)->backupOptionDelta))
@@ -2609,7 +3038,7 @@ cmdBackup(void)
         backupManifestSaveCopy(manifest, cipherPassBackup, false);
 
         // Process the backup manifest
-        backupProcess(backupData, manifest, cipherPassBackup);
+        backupProcess(backupData, infoBackup, manifest, backupStartResult.walSegmentName, cipherPassBackup);
 
         // Check that the clusters are alive and correctly configured after the backup
         backupDbPing(backupData, true);
@@ -4,6 +4,7 @@ Block Incremental Filter
 #include "build.auto.h"
 
 #include "command/backup/blockIncr.h"
+#include "command/backup/blockIndex.h"
 #include "command/backup/blockMap.h"
 #include "common/compress/helper.h"
 #include "common/crypto/cipherBlock.h"
@@ -18,9 +19,20 @@ Block Incremental Filter
 #include "common/type/object.h"
 #include "common/type/pack.h"
 
+/***********************************************************************************************************************************
+Number of recently stored blocks remembered to deduplicate blocks within the file
+***********************************************************************************************************************************/
+#define BLOCK_INCR_DEDUP_RECENT_SIZE                                256
+
 /***********************************************************************************************************************************
 Object type
 ***********************************************************************************************************************************/
+typedef struct BlockIncrDedup
+{
+    unsigned int blockMapIdx;                                       // Index of the stored block in the output map plus one
+    unsigned char checksum[XX_HASH_SIZE_MAX];                       // 128-bit xxHash of the block
+} BlockIncrDedup;
+
 typedef struct BlockIncr
 {
     unsigned int reference;                                         // Current backup reference
@@ -28,6 +40,7 @@ typedef struct BlockIncr
 
     StringId compressType;                                          // Compress filter type
     const Pack *compressParam;                                      // Compress filter parameters
+    StringId encryptType;                                           // Encrypt filter type
     const Pack *encryptParam;                                       // Encrypt filter parameters
 
     unsigned int blockNo;                                           // Block number
@@ -49,6 +62,11 @@ typedef struct BlockIncr
     uint64_t blockMapOutSize;                                       // Output block map size (if any)
     bool blockMapWrite;                                             // Write block map (at least one new/changed block)
 
+    bool dedup;                                                     // Deduplicate blocks?
+    BlockIndex *blockIndex;                                         // Index of blocks stored in prior backups (if any)
+    BlockIncrDedup dedupRecent[BLOCK_INCR_DEDUP_RECENT_SIZE];       // Blocks recently stored for this file (by checksum byte)
+    List *dedupOutList;                                             // Blocks stored for this file that can be indexed
+
     size_t inputOffset;                                             // Input offset
     bool inputSame;                                                 // Input the same data
     bool done;                                                      // Is the filter done?
@@ -68,6 +86,35 @@ blockIncrToLog(const BlockIncr *const this, StringStatic *const debugLog)
 #define FUNCTION_LOG_BLOCK_INCR_FORMAT(value, buffer, bufferSize)                                                                  \
     FUNCTION_LOG_OBJECT_FORMAT(value, blockIncrToLog, buffer, bufferSize)
 
+/***********************************************************************************************************************************
+Find a stored block that is identical to the current block, first in the blocks recently stored for this file and then in the index
+of blocks stored in prior backups
+***********************************************************************************************************************************/
+static const BlockMapItem *
+blockIncrDedupFind(BlockIncr *const this, const Buffer *const checksum)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(BLOCK_INCR, this);
+        FUNCTION_TEST_PARAM(BUFFER, checksum);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+    ASSERT(checksum != NULL);
+    ASSERT(bufUsed(checksum) == XX_HASH_SIZE_MAX);
+
+    const BlockMapItem *result = NULL;
+    const BlockIncrDedup *const blockDedup =
+        &this->dedupRecent[bufPtrConst(checksum)[XX_HASH_SIZE_MAX - 1] % BLOCK_INCR_DEDUP_RECENT_SIZE];
+
+    // The block map index is offset by one so zero indicates an empty slot
+    if (blockDedup->blockMapIdx != 0 && memcmp(blockDedup->checksum, bufPtrConst(checksum), XX_HASH_SIZE_MAX) == 0)
+        result = blockMapGet(this->blockMapOut, blockDedup->blockMapIdx - 1);
+    else if (this->blockIndex != NULL)
+        result = blockIndexFind(this->blockIndex, this->blockSize, bufPtrConst(checksum));
+
+    FUNCTION_TEST_RETURN_TYPE_CONST_P(BlockMapItem, result);
+}
+
 /***********************************************************************************************************************************
 Generate block incremental
 ***********************************************************************************************************************************/
@@ -121,16 +168,44 @@ blockIncrProcess(THIS_VOID, const Buffer *const input, Buffer *const output)
         {
             MEM_CONTEXT_TEMP_BEGIN()
             {
-                // Get block checksum
-                const Buffer *const checksum = xxHashOne(this->checksumSize, this->block);
+                // Get block checksum. Full blocks are deduplicated using the 128-bit checksum, which also provides the block
+                // checksum since the block checksum is a prefix of the 128-bit checksum.
+                const bool dedup = this->dedup && bufUsed(this->block) == this->blockSize;
+                const Buffer *const checksumFull = xxHashOne(dedup ? XX_HASH_SIZE_MAX : this->checksumSize, this->block);
+                const Buffer *const checksum = BUF(bufPtrConst(checksumFull), this->checksumSize);
 
                 // Does the block exist in the input map?
                 const BlockMapItem *const blockMapItemIn =
                     this->blockMapPrior != NULL && this->blockNo < blockMapSize(this->blockMapPrior) ?
                         blockMapGet(this->blockMapPrior, this->blockNo) : NULL;
 
-                // If the block is new or has changed then write it
-                if (blockMapItemIn == NULL || memcmp(blockMapItemIn->checksum, bufPtrConst(checksum), this->checksumSize) != 0)
+                // If the block is new or has changed then check if an identical block has already been stored
+                const bool blockChanged =
+                    blockMapItemIn == NULL || memcmp(blockMapItemIn->checksum, bufPtrConst(checksum), this->checksumSize) != 0;
+                const BlockMapItem *const blockMapItemDedup = blockChanged && dedup ? blockIncrDedupFind(this, checksumFull) : NULL;
+
+                // If an identical block has been stored then write a reference to it
+                if (blockMapItemDedup != NULL)
+                {
+                    BlockMapItem blockMapItem = *blockMapItemDedup;
+                    memcpy(blockMapItem.checksum, bufPtrConst(checksum), this->checksumSize);
+
+                    const unsigned int blockMapItemIdx = blockMapSize(this->blockMapOut);
+                    blockMapAdd(this->blockMapOut, &blockMapItem);
+                    bufUsedZero(this->block);
+
+                    // If the block is in the super block being written then the size must be updated when the super block is done
+                    if (this->blockOutWrite != NULL && blockMapItem.reference == this->reference &&
+                        blockMapItem.bundleId == this->bundleId && blockMapItem.offset == this->blockOffset)
+                    {
+                        lstAdd(this->blockOutList, &blockMapItemIdx);
+                    }
+
+                    // Block map must be written since the block has changed
+                    this->blockMapWrite = true;
+                }
+                // Else if the block is new or has changed then write it
+                else if (blockChanged)
                 {
                     // Begin the super block
                     if (this->blockOutWrite == NULL)
@@ -152,7 +227,11 @@ blockIncrProcess(THIS_VOID, const Buffer *const input, Buffer *const output)
 
                         // Add encrypt filter
                         if (this->encryptParam != NULL)
-                            ioFilterGroupAdd(ioWriteFilterGroup(this->blockOutWrite), cipherBlockNewPack(this->encryptParam));
+                        {
+                            ioFilterGroupAdd(
+                                ioWriteFilterGroup(this->blockOutWrite),
+                                cipherBlockFilterPack(this->encryptType, this->encryptParam));
+                        }
 
                         // Add size filter
                         ioFilterGroupAdd(ioWriteFilterGroup(this->blockOutWrite), ioSizeNew());
@@ -180,6 +259,19 @@ blockIncrProcess(THIS_VOID, const Buffer *const input, Buffer *const output)
                     blockMapAdd(this->blockMapOut, &blockMapItem);
                     lstAdd(this->blockOutList, &blockMapItemIdx);
 
+                    // Remember the block so identical blocks can reference it
+                    if (dedup)
+                    {
+                        BlockIncrDedup blockDedup = {.blockMapIdx = blockMapItemIdx + 1};
+                        memcpy(blockDedup.checksum, bufPtrConst(checksumFull), XX_HASH_SIZE_MAX);
+
+                        this->dedupRecent[blockDedup.checksum[XX_HASH_SIZE_MAX - 1] % BLOCK_INCR_DEDUP_RECENT_SIZE] = blockDedup;
+
+                        // Blocks that are bundled can also be indexed for use by later backups
+                        if (this->bundleId != 0)
+                            lstAdd(this->dedupOutList, &blockDedup);
+                    }
+
                     // Increment super block no
                     this->superBlockNo++;
                 }
@@ -246,7 +338,7 @@ blockIncrProcess(THIS_VOID, const Buffer *const input, Buffer *const output)
                 IoWrite *const write = ioBufferWriteNew(this->blockOut);
 
                 if (this->encryptParam != NULL)
-                    ioFilterGroupAdd(ioWriteFilterGroup(write), cipherBlockNewPack(this->encryptParam));
+                    ioFilterGroupAdd(ioWriteFilterGroup(write), cipherBlockFilterPack(this->encryptType, this->encryptParam));
 
                 // Write the map
                 ioWriteOpen(write);
@@ -293,7 +385,7 @@ blockIncrProcess(THIS_VOID, const Buffer *const input, Buffer *const output)
 }
 
 /***********************************************************************************************************************************
-The result is the size of the block map
+The result is the size of the block map and, when deduplicating, an index of the blocks stored for this file
 ***********************************************************************************************************************************/
 static Pack *
 blockIncrResult(THIS_VOID)
@@ -313,6 +405,29 @@ blockIncrResult(THIS_VOID)
         PackWrite *const packWrite = pckWriteNewP();
 
         pckWriteU64P(packWrite, this->blockMapOutSize);
+
+        if (this->dedup)
+        {
+            BlockIndex *const blockIndex = blockIndexNew();
+
+            for (unsigned int dedupIdx = 0; dedupIdx < lstSize(this->dedupOutList); dedupIdx++)
+            {
+                const BlockIncrDedup *const blockDedup = lstGet(this->dedupOutList, dedupIdx);
+                BlockMapItem blockMapItem = *blockMapGet(this->blockMapOut, blockDedup->blockMapIdx - 1);
+
+                memcpy(blockMapItem.checksum, blockDedup->checksum, XX_HASH_SIZE_MAX);
+                blockIndexAdd(blockIndex, this->blockSize, &blockMapItem);
+            }
+
+            Buffer *const blockIndexOut = bufNew(0);
+            IoWrite *const write = ioBufferWriteNewOpen(blockIndexOut);
+
+            blockIndexWrite(blockIndex, write, 0);
+            ioWriteClose(write);
+
+            pckWriteBinP(packWrite, blockIndexOut);
+        }
+
         pckWriteEndP(packWrite);
 
         result = pckMove(pckWriteResult(packWrite), memContextPrior());
@@ -360,8 +475,8 @@ blockIncrInputSame(const THIS_VOID)
 FN_EXTERN IoFilter *
 blockIncrNew(
     const uint64_t superBlockSize, const size_t blockSize, const size_t checksumSize, const unsigned int reference,
-    const uint64_t bundleId, const uint64_t bundleOffset, const Buffer *const blockMapPrior, const IoFilter *const compress,
-    const IoFilter *const encrypt)
+    const uint64_t bundleId, const uint64_t bundleOffset, const Buffer *const blockMapPrior, const bool dedup,
+    const Buffer *const blockIndex, const IoFilter *const compress, const IoFilter *const encrypt)
 {
     FUNCTION_LOG_BEGIN(logLevelTrace);
         FUNCTION_LOG_PARAM(UINT64, superBlockSize);
@@ -371,6 +486,8 @@ blockIncrNew(
         FUNCTION_LOG_PARAM(UINT64, bundleId);
         FUNCTION_LOG_PARAM(UINT64, bundleOffset);
         FUNCTION_LOG_PARAM(BUFFER, blockMapPrior);
+        FUNCTION_LOG_PARAM(BOOL, dedup);
+        FUNCTION_LOG_PARAM(BUFFER, blockIndex);
         FUNCTION_LOG_PARAM(IO_FILTER, compress);
         FUNCTION_LOG_PARAM(IO_FILTER, encrypt);
     FUNCTION_LOG_END();
@@ -388,8 +505,14 @@ blockIncrNew(
             .block = bufNew(blockSize),
             .blockOut = bufNew(0),
             .blockMapOut = blockMapNew(),
+            .dedup = dedup,
         };
 
+        ASSERT(dedup || blockIndex == NULL);
+
+        if (dedup)
+            this->dedupOutList = lstNewP(sizeof(BlockIncrDedup));
+
         // Duplicate compress filter
         if (compress != NULL)
         {
@@ -399,7 +522,10 @@ blockIncrNew(
 
         // Duplicate encrypt filter
         if (encrypt != NULL)
+        {
+            this->encryptType = ioFilterType(encrypt);
             this->encryptParam = pckDup(ioFilterParamList(encrypt));
+        }
 
         // Load prior block map
         if (blockMapPrior)
@@ -416,6 +542,22 @@ blockIncrNew(
             }
             MEM_CONTEXT_TEMP_END();
         }
+
+        // Load index of blocks stored in prior backups
+        if (blockIndex != NULL)
+        {
+            MEM_CONTEXT_TEMP_BEGIN()
+            {
+                IoRead *const read = ioBufferReadNewOpen(blockIndex);
+
+                MEM_CONTEXT_PRIOR_BEGIN()
+                {
+                    this->blockIndex = blockIndexNewRead(read);
+                }
+                MEM_CONTEXT_PRIOR_END();
+            }
+            MEM_CONTEXT_TEMP_END();
+        }
     }
     OBJ_NEW_END();
 
@@ -433,6 +575,8 @@ blockIncrNew(
         pckWriteU64P(packWrite, bundleId);
         pckWriteU64P(packWrite, bundleOffset);
         pckWriteBinP(packWrite, blockMapPrior);
+        pckWriteBoolP(packWrite, dedup);
+        pckWriteBinP(packWrite, blockIndex);
         pckWritePackP(packWrite, this->compressParam);
 
         if (this->compressParam != NULL)
@@ -440,6 +584,9 @@ blockIncrNew(
 
         pckWritePackP(packWrite, this->encryptParam);
 
+        if (this->encryptParam != NULL)
+            pckWriteStrIdP(packWrite, this->encryptType);
+
         pckWriteEndP(packWrite);
 
         paramList = pckMove(pckWriteResult(packWrite), memContextPrior());
@@ -468,6 +615,8 @@ blockIncrNewPack(const Pack *const paramList)
         const uint64_t bundleId = pckReadU64P(paramListPack);
         const uint64_t bundleOffset = pckReadU64P(paramListPack);
         const Buffer *blockMapPrior = pckReadBinP(paramListPack);
+        const bool dedup = pckReadBoolP(paramListPack);
+        const Buffer *const blockIndex = pckReadBinP(paramListPack);
 
         // Create compress filter
         const Pack *const compressParam = pckReadPackP(paramListPack);
@@ -481,11 +630,12 @@ blockIncrNewPack(const Pack *const paramList)
         const IoFilter *encrypt = NULL;
 
         if (encryptParam != NULL)
-            encrypt = cipherBlockNewPack(encryptParam);
+            encrypt = cipherBlockFilterPack(pckReadStrIdP(paramListPack), encryptParam);
 
         result = ioFilterMove(
             blockIncrNew(
-                superBlockSize, blockSize, checksumSize, reference, bundleId, bundleOffset, blockMapPrior, compress, encrypt),
+                superBlockSize, blockSize, checksumSize, reference, bundleId, bundleOffset, blockMapPrior, dedup, blockIndex,
+                compress, encrypt),
             memContextPrior());
     }
     MEM_CONTEXT_TEMP_END();
@@ -17,6 +17,10 @@ backup. However, the block map may reference super block lists (or parts thereof
 
 The block incremental should be read using BlockDelta since reconstructing the delta is quite involved.
 
+When deduplication is enabled a changed block that is identical to a block already stored for the file, or to a block in the index
+of blocks stored in prior backups (see BlockIndex), is stored as a reference to that block. The filter result then also contains an
+index of the bundled blocks stored for the file so they can be added to the index for the current backup.
+
 The xxHash algorithm is used to determine which blocks have changed. A 128-bit xxHash is generated and then checksumSize bytes are
 used from the hash depending on the size of the block. xxHash claims to have excellent dispersion characteristics, which has been
 verified by testing with SMHasher and a custom test suite. xxHash-32 is used for up to 4MiB content blocks in lz4 and the lower
@@ -40,7 +44,8 @@ Constructors
 ***********************************************************************************************************************************/
 FN_EXTERN IoFilter *blockIncrNew(
     uint64_t superBlockSize, size_t blockSize, size_t checksumSize, unsigned int reference, uint64_t bundleId,
-    uint64_t bundleOffset, const Buffer *blockMapPrior, const IoFilter *compress, const IoFilter *encrypt);
+    uint64_t bundleOffset, const Buffer *blockMapPrior, bool dedup, const Buffer *blockIndex, const IoFilter *compress,
+    const IoFilter *encrypt);
 FN_EXTERN IoFilter *blockIncrNewPack(const Pack *paramList);
 
 #endif
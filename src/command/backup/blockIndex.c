@@ -0,0 +1,353 @@
+/***********************************************************************************************************************************
+Block Incremental Index
+
+The block index is stored as a header followed by a list of items sorted by block size and checksum:
+
+- Varint-128 flag that contains the version (currently always 0).
+
+- Varint-128 sample level.
+
+- Varint-128 item total.
+
+- List of items:
+
+  - Varint-128 block size.
+
+  - 128-bit xxHash of the block.
+
+  - Varint-128 encoded reference, bundle id, offset, size, super block size, and block no where the block is stored.
+***********************************************************************************************************************************/
+#include "build.auto.h"
+
+#include "command/backup/blockIndex.h"
+#include "common/debug.h"
+#include "common/log.h"
+
+/***********************************************************************************************************************************
+Sampling uses the first 32 bits of the checksum
+***********************************************************************************************************************************/
+#define BLOCK_INDEX_SAMPLE_LEVEL_MAX                                32
+
+/***********************************************************************************************************************************
+Object type
+***********************************************************************************************************************************/
+typedef struct BlockIndexItem
+{
+    uint64_t blockSize;                                             // Block size
+    BlockMapItem location;                                          // Location of the block (checksum is the 128-bit xxHash)
+} BlockIndexItem;
+
+struct BlockIndex
+{
+    BlockIndexPub pub;                                              // Publicly accessible variables
+    bool sorted;                                                    // Is the item list sorted with no duplicates?
+};
+
+/***********************************************************************************************************************************
+Compare items by block size and checksum
+***********************************************************************************************************************************/
+static int
+blockIndexItemComparator(const void *const item1, const void *const item2)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, item1);
+        FUNCTION_TEST_PARAM_P(VOID, item2);
+    FUNCTION_TEST_END();
+
+    ASSERT(item1 != NULL);
+    ASSERT(item2 != NULL);
+
+    const BlockIndexItem *const indexItem1 = item1;
+    const BlockIndexItem *const indexItem2 = item2;
+    int result = LST_COMPARATOR_CMP(indexItem1->blockSize, indexItem2->blockSize);
+
+    if (result == 0)
+        result = memcmp(indexItem1->location.checksum, indexItem2->location.checksum, XX_HASH_SIZE_MAX);
+
+    FUNCTION_TEST_RETURN(INT, result);
+}
+
+/***********************************************************************************************************************************
+Does the checksum fit the sample level?
+***********************************************************************************************************************************/
+static bool
+blockIndexSampled(const unsigned char *const checksum, const unsigned int sampleLevel)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(UCHARDATA, checksum);
+        FUNCTION_TEST_PARAM(UINT, sampleLevel);
+    FUNCTION_TEST_END();
+
+    ASSERT(checksum != NULL);
+
+    const uint64_t sample =
+        (uint64_t)checksum[0] | (uint64_t)checksum[1] << 8 | (uint64_t)checksum[2] << 16 | (uint64_t)checksum[3] << 24;
+
+    FUNCTION_TEST_RETURN(BOOL, (sample & (((uint64_t)1 << sampleLevel) - 1)) == 0);
+}
+
+/***********************************************************************************************************************************
+Remove items that do not fit the sample level and, when sorting, duplicate items. When there are duplicates the item with the
+lowest reference is kept so the block stays in the oldest backup where it is stored.
+***********************************************************************************************************************************/
+static void
+blockIndexCompact(BlockIndex *const this, const bool sort)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(BLOCK_INDEX, this);
+        FUNCTION_TEST_PARAM(BOOL, sort);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+
+    if (sort)
+        lstSort(this->pub.itemList, sortOrderAsc);
+
+    unsigned int itemTotal = 0;
+
+    for (unsigned int itemIdx = 0; itemIdx < lstSize(this->pub.itemList); itemIdx++)
+    {
+        const BlockIndexItem *const item = lstGet(this->pub.itemList, itemIdx);
+
+        if (!blockIndexSampled(item->location.checksum, this->pub.sampleLevel))
+            continue;
+
+        // Replace the prior item when this item is a duplicate with a lower reference
+        if (sort && itemTotal > 0)
+        {
+            BlockIndexItem *const itemPrior = lstGet(this->pub.itemList, itemTotal - 1);
+
+            if (blockIndexItemComparator(itemPrior, item) == 0)
+            {
+                if (item->location.reference < itemPrior->location.reference)
+                    *itemPrior = *item;
+
+                continue;
+            }
+        }
+
+        if (itemTotal != itemIdx)
+            *(BlockIndexItem *)lstGet(this->pub.itemList, itemTotal) = *item;
+
+        itemTotal++;
+    }
+
+    // Remove items that are no longer in use from the end of the list. The list is still sorted since the order of the remaining
+    // items has not changed.
+    while (lstSize(this->pub.itemList) > itemTotal)
+        lstRemoveLast(this->pub.itemList);
+
+    if (sort)
+        this->sorted = true;
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+/**********************************************************************************************************************************/
+FN_EXTERN BlockIndex *
+blockIndexNew(void)
+{
+    FUNCTION_TEST_VOID();
+
+    OBJ_NEW_BEGIN(BlockIndex, .childQty = MEM_CONTEXT_QTY_MAX)
+    {
+        *this = (BlockIndex)
+        {
+            .pub =
+            {
+                .itemList = lstNewP(sizeof(BlockIndexItem), .comparator = blockIndexItemComparator),
+            },
+            .sorted = true,
+        };
+    }
+    OBJ_NEW_END();
+
+    FUNCTION_TEST_RETURN(BLOCK_INDEX, this);
+}
+
+/**********************************************************************************************************************************/
+FN_EXTERN BlockIndex *
+blockIndexNewRead(IoRead *const read)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(IO_READ, read);
+    FUNCTION_LOG_END();
+
+    ASSERT(read != NULL);
+
+    BlockIndex *const this = blockIndexNew();
+    blockIndexAddRead(this, read);
+
+    FUNCTION_LOG_RETURN(BLOCK_INDEX, this);
+}
+
+/**********************************************************************************************************************************/
+FN_EXTERN void
+blockIndexAdd(BlockIndex *const this, const size_t blockSize, const BlockMapItem *const item)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(BLOCK_INDEX, this);
+        FUNCTION_TEST_PARAM(SIZE, blockSize);
+        FUNCTION_TEST_PARAM_P(VOID, item);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+    ASSERT(blockSize > 0);
+    ASSERT(item != NULL);
+    ASSERT(item->bundleId != 0);
+
+    if (blockIndexSampled(item->checksum, this->pub.sampleLevel))
+    {
+        lstAdd(this->pub.itemList, &(BlockIndexItem){.blockSize = blockSize, .location = *item});
+        this->sorted = false;
+
+        // If the index is too large then first remove duplicates (e.g. the same block stored by many files) and then increase the
+        // sample level until the index fits
+        if (lstSize(this->pub.itemList) > BLOCK_INDEX_SIZE_MAX)
+        {
+            blockIndexCompact(this, true);
+
+            while (lstSize(this->pub.itemList) > BLOCK_INDEX_SIZE_MAX && this->pub.sampleLevel < BLOCK_INDEX_SAMPLE_LEVEL_MAX)
+            {
+                this->pub.sampleLevel++;
+                blockIndexCompact(this, false);
+            }
+        }
+    }
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+/**********************************************************************************************************************************/
+FN_EXTERN void
+blockIndexAddRead(BlockIndex *const this, IoRead *const read)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(BLOCK_INDEX, this);
+        FUNCTION_LOG_PARAM(IO_READ, read);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(read != NULL);
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        // Read flags. Currently the version must always be zero.
+        CHECK(FormatError, ioReadVarIntU64(read) == 0, "block index version must be zero");
+
+        // Use the highest sample level so the index never holds items that would have been discarded by either index
+        const unsigned int sampleLevel = (unsigned int)ioReadVarIntU64(read);
+
+        if (sampleLevel > this->pub.sampleLevel)
+        {
+            this->pub.sampleLevel = sampleLevel;
+            blockIndexCompact(this, false);
+        }
+
+        // Read items
+        const uint64_t itemTotal = ioReadVarIntU64(read);
+        Buffer *const checksum = bufNew(XX_HASH_SIZE_MAX);
+
+        for (uint64_t itemIdx = 0; itemIdx < itemTotal; itemIdx++)
+        {
+            const size_t blockSize = (size_t)ioReadVarIntU64(read);
+
+            bufUsedZero(checksum);
+            ioRead(read, checksum);
+
+            BlockMapItem item = {.reference = (unsigned int)ioReadVarIntU64(read)};
+            memcpy(item.checksum, bufPtrConst(checksum), XX_HASH_SIZE_MAX);
+
+            item.bundleId = ioReadVarIntU64(read);
+            item.offset = ioReadVarIntU64(read);
+            item.size = ioReadVarIntU64(read);
+            item.superBlockSize = ioReadVarIntU64(read);
+            item.block = ioReadVarIntU64(read);
+
+            blockIndexAdd(this, blockSize, &item);
+        }
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+/**********************************************************************************************************************************/
+FN_EXTERN const BlockMapItem *
+blockIndexFind(BlockIndex *const this, const size_t blockSize, const unsigned char *const checksum)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(BLOCK_INDEX, this);
+        FUNCTION_TEST_PARAM(SIZE, blockSize);
+        FUNCTION_TEST_PARAM_P(UCHARDATA, checksum);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+    ASSERT(checksum != NULL);
+
+    if (!this->sorted)
+        blockIndexCompact(this, true);
+
+    BlockIndexItem item = {.blockSize = blockSize};
+    memcpy(item.location.checksum, checksum, XX_HASH_SIZE_MAX);
+
+    const BlockIndexItem *const result = lstFind(this->pub.itemList, &item);
+
+    FUNCTION_TEST_RETURN_TYPE_CONST_P(BlockMapItem, result == NULL ? NULL : &result->location);
+}
+
+/**********************************************************************************************************************************/
+FN_EXTERN void
+blockIndexWrite(BlockIndex *const this, IoWrite *const output, const size_t blockSize)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(BLOCK_INDEX, this);
+        FUNCTION_LOG_PARAM(IO_WRITE, output);
+        FUNCTION_LOG_PARAM(SIZE, blockSize);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(output != NULL);
+
+    if (!this->sorted)
+        blockIndexCompact(this, true);
+
+    // Determine the range of items to write. Items are sorted by block size so items with the same block size are contiguous.
+    unsigned int itemBegin = 0;
+    unsigned int itemEnd = lstSize(this->pub.itemList);
+
+    if (blockSize != 0)
+    {
+        const List *const itemList = this->pub.itemList;
+
+        while (itemBegin < itemEnd && ((const BlockIndexItem *)lstGet(itemList, itemBegin))->blockSize < blockSize)
+            itemBegin++;
+
+        itemEnd = itemBegin;
+
+        while (itemEnd < lstSize(itemList) && ((const BlockIndexItem *)lstGet(itemList, itemEnd))->blockSize == blockSize)
+            itemEnd++;
+    }
+
+    // Write header
+    ioWriteVarIntU64(output, 0);
+    ioWriteVarIntU64(output, this->pub.sampleLevel);
+    ioWriteVarIntU64(output, itemEnd - itemBegin);
+
+    // Write items
+    for (unsigned int itemIdx = itemBegin; itemIdx < itemEnd; itemIdx++)
+    {
+        const BlockIndexItem *const item = lstGet(this->pub.itemList, itemIdx);
+
+        ioWriteVarIntU64(output, item->blockSize);
+        ioWrite(output, BUF(item->location.checksum, XX_HASH_SIZE_MAX));
+        ioWriteVarIntU64(output, item->location.reference);
+        ioWriteVarIntU64(output, item->location.bundleId);
+        ioWriteVarIntU64(output, item->location.offset);
+        ioWriteVarIntU64(output, item->location.size);
+        ioWriteVarIntU64(output, item->location.superBlockSize);
+        ioWriteVarIntU64(output, item->location.block);
+    }
+
+    FUNCTION_LOG_RETURN_VOID();
+}
@@ -0,0 +1,107 @@
+/***********************************************************************************************************************************
+Block Incremental Index
+
+The block index maps the content of stored blocks to the location where they can be found so a block that has already been stored
+in the backup set can be referenced rather than stored again. Content is identified by the block size and the full 128-bit xxHash of
+the block, which makes collisions negligible even across a large number of blocks (the checksums stored in the block map are
+generally shorter since they only need to detect changes to a block at a known position).
+
+Only blocks stored in a bundle are indexed since the repository path of a non-bundled block depends on the name of the file that
+stored it and cannot be referenced from another file.
+
+The index is bounded to BLOCK_INDEX_SIZE_MAX items. When the limit is exceeded the index is sampled by only keeping items with
+checksums that have a number of low-order zero bits equal to the sample level. The level is increased until the index fits. Since
+sampling depends only on block content the same blocks are kept (or discarded) consistently across backups. The limit is not scaled
+to the size of the cluster, so once the backup set stores more than BLOCK_INDEX_SIZE_MAX bundled blocks only a sample can be found
+and the rate of deduplication falls in proportion.
+
+During a backup the main process merges the blocks stored by each job into the index and sends the blocks stored since the prior
+job to each local process, so blocks can be deduplicated across files and processes in the same backup as well as against prior
+backups.
+***********************************************************************************************************************************/
+#ifndef COMMAND_BACKUP_BLOCKINDEX_H
+#define COMMAND_BACKUP_BLOCKINDEX_H
+
+/***********************************************************************************************************************************
+Object type
+***********************************************************************************************************************************/
+typedef struct BlockIndex BlockIndex;
+
+#include "command/backup/blockMap.h"
+#include "common/io/read.h"
+#include "common/io/write.h"
+
+/***********************************************************************************************************************************
+Index constants
+***********************************************************************************************************************************/
+// Name of the index file stored in the backup path
+#define BLOCK_INDEX_FILE                                            "block.index"
+
+// Maximum items in the index
+#define BLOCK_INDEX_SIZE_MAX                                        32768
+
+/***********************************************************************************************************************************
+Constructors
+***********************************************************************************************************************************/
+FN_EXTERN BlockIndex *blockIndexNew(void);
+
+// New block index from IO
+FN_EXTERN BlockIndex *blockIndexNewRead(IoRead *read);
+
+/***********************************************************************************************************************************
+Functions
+***********************************************************************************************************************************/
+// Add a block. The item checksum must contain the full 128-bit xxHash of the block. Items that do not fit the current sample level
+// are ignored.
+FN_EXTERN void blockIndexAdd(BlockIndex *this, size_t blockSize, const BlockMapItem *item);
+
+// Add all items from an index read from IO
+FN_EXTERN void blockIndexAddRead(BlockIndex *this, IoRead *read);
+
+// Find a block by size and 128-bit xxHash. Returns NULL when the block is not in the index.
+FN_EXTERN const BlockMapItem *blockIndexFind(BlockIndex *this, size_t blockSize, const unsigned char *checksum);
+
+// Write index to IO. When blockSize is not zero only items with that block size are written.
+FN_EXTERN void blockIndexWrite(BlockIndex *this, IoWrite *output, size_t blockSize);
+
+/***********************************************************************************************************************************
+Getters/Setters
+***********************************************************************************************************************************/
+typedef struct BlockIndexPub
+{
+    List *itemList;                                                 // Index items
+    unsigned int sampleLevel;                                       // Low-order checksum bits that must be zero to be indexed
+} BlockIndexPub;
+
+// Sample level
+FN_INLINE_ALWAYS unsigned int
+blockIndexSampleLevel(const BlockIndex *const this)
+{
+    return THIS_PUB(BlockIndex)->sampleLevel;
+}
+
+// Index size
+FN_INLINE_ALWAYS unsigned int
+blockIndexSize(const BlockIndex *const this)
+{
+    return lstSize(THIS_PUB(BlockIndex)->itemList);
+}
+
+/***********************************************************************************************************************************
+Destructor
+***********************************************************************************************************************************/
+FN_INLINE_ALWAYS void
+blockIndexFree(BlockIndex *const this)
+{
+    objFree(this);
+}
+
+/***********************************************************************************************************************************
+Macros for function logging
+***********************************************************************************************************************************/
+#define FUNCTION_LOG_BLOCK_INDEX_TYPE                                                                                              \
+    BlockIndex *
+#define FUNCTION_LOG_BLOCK_INDEX_FORMAT(value, buffer, bufferSize)                                                                 \
+    objNameToLog(value, "BlockIndex", buffer, bufferSize)
+
+#endif
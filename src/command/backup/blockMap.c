@@ -26,6 +26,23 @@ The block map is stored as a flag and a series of reference, super block, and bl
       - Checksum.
 
 References, super blocks, and blocks are encoded with a bit that indicates when the last one has been reached.
+
+The packed format depends on each reference being stored in a single bundle with super blocks in ascending order and blocks in
+ascending order within each super block. This is always true unless blocks have been deduplicated (see BlockIndex), in which case
+blocks may be referenced from any bundle in any order and the same block may be referenced more than once. Maps that cannot be
+packed are stored with the version flag set and an explicit list of blocks:
+
+- Varint-128 block total.
+
+- List of blocks:
+
+  - Varint-128 flag that indicates if the block is in the same super block as the prior block.
+
+  - Varint-128 encoded reference, bundle id, offset, size, and super block size when the super block has changed.
+
+  - Varint-128 encoded block number.
+
+  - Checksum.
 ***********************************************************************************************************************************/
 #include "build.auto.h"
 
@@ -48,9 +65,11 @@ References, super blocks, and blocks are encoded with a bit that indicates when
 #define BLOCK_MAP_FLAG_BLOCK_TOTAL_OFFSET                           1   // Block total has an offset
 #define BLOCK_MAP_BLOCK_TOTAL_SHIFT                                 1   // Shift bits for block total
 
+#define BLOCK_MAP_FLAG_SUPER_BLOCK_SAME                             1   // Block is in the same super block as the prior block
+
 typedef enum
 {
-    blockMapFlagVersion = 0,                                        // Version (currently always 0)
+    blockMapFlagVersion = 0,                                        // Version (0 for packed, 1 for explicit)
 } BlockMapFlag;
 
 // Stores current information about a reference to avoid needed to encode it again
@@ -82,16 +101,58 @@ lstComparatorBlockMapReference(const void *const blockMapRef1, const void *const
     FUNCTION_TEST_RETURN(INT, LST_COMPARATOR_CMP(reference1, reference2));
 }
 
-FN_EXTERN BlockMap *
-blockMapNewRead(IoRead *const map, const size_t blockSize, const size_t checksumSize)
+// Read map in explicit format
+static BlockMap *
+blockMapNewReadExplicit(IoRead *const map, const size_t checksumSize)
 {
-    FUNCTION_LOG_BEGIN(logLevelTrace);
-        FUNCTION_LOG_PARAM(IO_READ, map);
-    FUNCTION_LOG_END();
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(IO_READ, map);
+        FUNCTION_TEST_PARAM(SIZE, checksumSize);
+    FUNCTION_TEST_END();
+
+    BlockMap *const this = blockMapNew();
+    Buffer *const checksum = bufNew(checksumSize);
+    const uint64_t blockTotal = ioReadVarIntU64(map);
+    BlockMapItem blockMapItem = {0};
+
+    for (uint64_t blockIdx = 0; blockIdx < blockTotal; blockIdx++)
+    {
+        // Read super block when it has changed
+        const uint64_t blockEncoded = ioReadVarIntU64(map);
+
+        if (!(blockEncoded & BLOCK_MAP_FLAG_SUPER_BLOCK_SAME))
+        {
+            blockMapItem.reference = (unsigned int)ioReadVarIntU64(map);
+            blockMapItem.bundleId = ioReadVarIntU64(map);
+            blockMapItem.offset = ioReadVarIntU64(map);
+            blockMapItem.size = ioReadVarIntU64(map);
+            blockMapItem.superBlockSize = ioReadVarIntU64(map);
+        }
+
+        // Read block no and checksum
+        blockMapItem.block = ioReadVarIntU64(map);
+
+        bufUsedZero(checksum);
+        ioRead(map, checksum);
+        memcpy(blockMapItem.checksum, bufPtr(checksum), bufUsed(checksum));
+
+        lstAdd((List *)this, &blockMapItem);
+    }
+
+    bufFree(checksum);
 
-    // Read flags. Currently the version flag must always be zero. This may be used in the future to indicate if the map version
-    // has changed.
-    CHECK(FormatError, (ioReadVarIntU64(map) & (1 << blockMapFlagVersion)) == 0, "block map version must be zero");
+    FUNCTION_TEST_RETURN(BLOCK_MAP, this);
+}
+
+// Read map in packed format
+static BlockMap *
+blockMapNewReadPacked(IoRead *const map, const size_t blockSize, const size_t checksumSize)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(IO_READ, map);
+        FUNCTION_TEST_PARAM(SIZE, blockSize);
+        FUNCTION_TEST_PARAM(SIZE, checksumSize);
+    FUNCTION_TEST_END();
 
     // Read all references in packed format
     BlockMap *const this = blockMapNew();
@@ -262,24 +323,159 @@ blockMapNewRead(IoRead *const map, const size_t blockSize, const size_t checksum
     lstFree(refList);
     bufFree(checksum);
 
-    FUNCTION_LOG_RETURN(BLOCK_MAP, this);
+    FUNCTION_TEST_RETURN(BLOCK_MAP, this);
 }
 
 /**********************************************************************************************************************************/
-FN_EXTERN void
-blockMapWrite(const BlockMap *const this, IoWrite *const output, const size_t blockSize, const size_t checksumSize)
+FN_EXTERN BlockMap *
+blockMapNewRead(IoRead *const map, const size_t blockSize, const size_t checksumSize)
 {
     FUNCTION_LOG_BEGIN(logLevelTrace);
-        FUNCTION_LOG_PARAM(BLOCK_MAP, this);
-        FUNCTION_LOG_PARAM(IO_WRITE, output);
+        FUNCTION_LOG_PARAM(IO_READ, map);
         FUNCTION_LOG_PARAM(SIZE, blockSize);
         FUNCTION_LOG_PARAM(SIZE, checksumSize);
     FUNCTION_LOG_END();
 
+    // Read flags. The version flag determines if the map is in packed or explicit format.
+    const bool mapExplicit = ioReadVarIntU64(map) & (1 << blockMapFlagVersion);
+
+    FUNCTION_LOG_RETURN(
+        BLOCK_MAP, mapExplicit ? blockMapNewReadExplicit(map, checksumSize) : blockMapNewReadPacked(map, blockSize, checksumSize));
+}
+
+/**********************************************************************************************************************************/
+// Can the map be written in the packed format? This mirrors the assumptions made by the packed format about the order of
+// references, super blocks, and blocks.
+static bool
+blockMapPacked(const BlockMap *const this)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(BLOCK_MAP, this);
+    FUNCTION_TEST_END();
+
     ASSERT(this != NULL);
-    ASSERT(blockMapSize(this) > 0);
-    ASSERT(blockSize > 0);
-    ASSERT(output != NULL);
+
+    bool result = true;
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        List *const refList = lstNewP(sizeof(BlockMapReference), .comparator = lstComparatorBlockMapReference);
+
+        for (unsigned int blockMapIdx = 0; blockMapIdx < blockMapSize(this); blockMapIdx++)
+        {
+            const BlockMapItem *const blockMapItem = blockMapGet(this, blockMapIdx);
+            const BlockMapItem *const blockMapItemPrior = blockMapIdx == 0 ? NULL : blockMapGet(this, blockMapIdx - 1);
+            BlockMapReference *const referenceData = lstFind(
+                refList, &(BlockMapReference){.reference = blockMapItem->reference});
+
+            // Blocks for a reference must be in a single bundle
+            if (referenceData != NULL && referenceData->bundleId != blockMapItem->bundleId)
+                result = false;
+            // Blocks in the same super block must be consecutive
+            else if (
+                blockMapItemPrior != NULL && blockMapItemPrior->reference == blockMapItem->reference &&
+                blockMapItemPrior->offset == blockMapItem->offset)
+            {
+                if (blockMapItem->block != blockMapItemPrior->block + 1)
+                    result = false;
+            }
+            // Super blocks in the same run of a reference must be contiguous
+            else if (
+                blockMapItemPrior != NULL && blockMapItemPrior->reference == blockMapItem->reference &&
+                blockMapItem->offset != blockMapItemPrior->offset + blockMapItemPrior->size)
+            {
+                result = false;
+            }
+            // A reference that appeared before may only continue its last super block or start a new super block after it
+            else if (referenceData != NULL)
+            {
+                if (blockMapItem->offset == referenceData->offset)
+                {
+                    if (blockMapItem->block < referenceData->block || blockMapItem->superBlockSize != referenceData->superBlockSize)
+                        result = false;
+                }
+                else if (blockMapItem->offset < referenceData->offset + referenceData->size)
+                    result = false;
+            }
+
+            if (!result)
+                break;
+
+            // Update reference
+            const BlockMapReference referenceUpdate =
+            {
+                .reference = blockMapItem->reference,
+                .superBlockSize = blockMapItem->superBlockSize,
+                .bundleId = blockMapItem->bundleId,
+                .offset = blockMapItem->offset,
+                .size = blockMapItem->size,
+                .block = blockMapItem->block + 1,
+            };
+
+            if (referenceData == NULL)
+                lstAdd(refList, &referenceUpdate);
+            else
+                *referenceData = referenceUpdate;
+        }
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_TEST_RETURN(BOOL, result);
+}
+
+// Write map in explicit format
+static void
+blockMapWriteExplicit(const BlockMap *const this, IoWrite *const output, const size_t checksumSize)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(BLOCK_MAP, this);
+        FUNCTION_TEST_PARAM(IO_WRITE, output);
+        FUNCTION_TEST_PARAM(SIZE, checksumSize);
+    FUNCTION_TEST_END();
+
+    ioWriteVarIntU64(output, 1 << blockMapFlagVersion);
+    ioWriteVarIntU64(output, blockMapSize(this));
+
+    for (unsigned int blockMapIdx = 0; blockMapIdx < blockMapSize(this); blockMapIdx++)
+    {
+        const BlockMapItem *const blockMapItem = blockMapGet(this, blockMapIdx);
+        const BlockMapItem *const blockMapItemPrior = blockMapIdx == 0 ? NULL : blockMapGet(this, blockMapIdx - 1);
+
+        // Write super block when it has changed
+        if (blockMapItemPrior != NULL && blockMapItemPrior->reference == blockMapItem->reference &&
+            blockMapItemPrior->bundleId == blockMapItem->bundleId && blockMapItemPrior->offset == blockMapItem->offset &&
+            blockMapItemPrior->size == blockMapItem->size && blockMapItemPrior->superBlockSize == blockMapItem->superBlockSize)
+        {
+            ioWriteVarIntU64(output, BLOCK_MAP_FLAG_SUPER_BLOCK_SAME);
+        }
+        else
+        {
+            ioWriteVarIntU64(output, 0);
+            ioWriteVarIntU64(output, blockMapItem->reference);
+            ioWriteVarIntU64(output, blockMapItem->bundleId);
+            ioWriteVarIntU64(output, blockMapItem->offset);
+            ioWriteVarIntU64(output, blockMapItem->size);
+            ioWriteVarIntU64(output, blockMapItem->superBlockSize);
+        }
+
+        // Write block no and checksum
+        ioWriteVarIntU64(output, blockMapItem->block);
+        ioWrite(output, BUF(blockMapItem->checksum, checksumSize));
+    }
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+// Write map in packed format
+static void
+blockMapWritePacked(const BlockMap *const this, IoWrite *const output, const size_t blockSize, const size_t checksumSize)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(BLOCK_MAP, this);
+        FUNCTION_TEST_PARAM(IO_WRITE, output);
+        FUNCTION_TEST_PARAM(SIZE, blockSize);
+        FUNCTION_TEST_PARAM(SIZE, checksumSize);
+    FUNCTION_TEST_END();
 
     // Write flags
     ioWriteVarIntU64(output, 0);
@@ -494,5 +690,29 @@ blockMapWrite(const BlockMap *const this, IoWrite *const output, const size_t bl
 
     lstFree(refList);
 
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+FN_EXTERN void
+blockMapWrite(const BlockMap *const this, IoWrite *const output, const size_t blockSize, const size_t checksumSize)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(BLOCK_MAP, this);
+        FUNCTION_LOG_PARAM(IO_WRITE, output);
+        FUNCTION_LOG_PARAM(SIZE, blockSize);
+        FUNCTION_LOG_PARAM(SIZE, checksumSize);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(blockMapSize(this) > 0);
+    ASSERT(blockSize > 0);
+    ASSERT(output != NULL);
+
+    // Write the map in explicit format when it cannot be packed
+    if (blockMapPacked(this))
+        blockMapWritePacked(this, output, blockSize, checksumSize);
+    else
+        blockMapWriteExplicit(this, output, checksumSize);
+
     FUNCTION_LOG_RETURN_VOID();
 }
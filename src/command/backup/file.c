@@ -6,12 +6,15 @@ Backup File
 #include <string.h>
 
 #include "command/backup/blockIncr.h"
+#include "command/backup/blockIndex.h"
 #include "command/backup/file.h"
 #include "command/backup/pageChecksum.h"
 #include "common/crypto/cipherBlock.h"
 #include "common/crypto/hash.h"
+#include "common/crypto/xxhash.h"
 #include "common/debug.h"
 #include "common/io/bufferRead.h"
+#include "common/io/bufferWrite.h"
 #include "common/io/filter/group.h"
 #include "common/io/filter/size.h"
 #include "common/io/io.h"
@@ -20,8 +23,56 @@ Backup File
 #include "common/type/convert.h"
 #include "common/type/json.h"
 #include "info/manifest.h"
+#include "postgres/interface/static.vendor.h"
 #include "storage/helper.h"
 
+/***********************************************************************************************************************************
+Files at least this size are large enough to be worth compressing on multiple threads
+***********************************************************************************************************************************/
+#define BACKUP_FILE_COMPRESS_LARGE_SIZE                             ((uint64_t)32 * 1024 * 1024)
+
+/***********************************************************************************************************************************
+Index of blocks stored in the backup set. The main process sends the full index with the first job of a backup and after that only
+the blocks stored by other processes since the prior job, so the index is kept for the life of the process.
+***********************************************************************************************************************************/
+static struct BackupFileLocal
+{
+    BlockIndex *blockIndex;                                         // Block index
+} backupFileLocal;
+
+static void
+backupFileBlockIndexUpdate(const bool reset, const Buffer *const update)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(BOOL, reset);
+        FUNCTION_LOG_PARAM(BUFFER, update);
+    FUNCTION_LOG_END();
+
+    ASSERT(reset || backupFileLocal.blockIndex != NULL);
+
+    if (reset)
+    {
+        blockIndexFree(backupFileLocal.blockIndex);
+
+        MEM_CONTEXT_BEGIN(memContextTop())
+        {
+            backupFileLocal.blockIndex = blockIndexNew();
+        }
+        MEM_CONTEXT_END();
+    }
+
+    if (update != NULL)
+    {
+        MEM_CONTEXT_TEMP_BEGIN()
+        {
+            blockIndexAddRead(backupFileLocal.blockIndex, ioBufferReadNewOpen(update));
+        }
+        MEM_CONTEXT_TEMP_END();
+    }
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
 /***********************************************************************************************************************************
 Helper functions
 ***********************************************************************************************************************************/
@@ -36,24 +87,127 @@ segmentNumber(const String *const pgFile)
     FUNCTION_TEST_RETURN(UINT, regExpMatchOne(STRDEF("\\.[0-9]+$"), pgFile) ? cvtZToUInt(strrchr(strZ(pgFile), '.') + 1) : 0);
 }
 
+/***********************************************************************************************************************************
+Check page LSNs to determine if a relation file has changed since the backup that holds the prior copy of the file
+***********************************************************************************************************************************/
+// Page layout version used by all supported versions of PostgreSQL
+#define BACKUP_FILE_PAGE_LAYOUT_VERSION                             4
+
+typedef enum
+{
+    backupFilePageLsnUnknown,                                       // Page LSNs cannot be trusted so a checksum is required
+    backupFilePageLsnChanged,                                       // At least one page is newer than the limit
+    backupFilePageLsnUnchanged,                                     // No page is newer than the limit
+} BackupFilePageLsnResult;
+
+static BackupFilePageLsnResult
+backupFilePageLsn(const BackupFile *const file, const PgPageSize pageSize)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM_P(VOID, file);
+        FUNCTION_LOG_PARAM(ENUM, pageSize);
+    FUNCTION_LOG_END();
+
+    ASSERT(file != NULL);
+    ASSERT(file->pgFileLsnLimit != 0);
+
+    BackupFilePageLsnResult result = backupFilePageLsnUnknown;
+
+    // Only files that contain whole pages can be checked
+    if (file->pgFileSize % pageSize == 0)
+    {
+        MEM_CONTEXT_TEMP_BEGIN()
+        {
+            IoRead *const read = storageReadIo(
+                storageNewReadP(storagePg(), file->pgFile, .ignoreMissing = true, .limit = VARUINT64(file->pgFileSize)));
+
+            // If the file is missing then the checksum delta will report it
+            if (ioReadOpen(read))
+            {
+                // Size the buffer to hold whole pages so pages are never split between reads
+                Buffer *const buffer = bufNew(ioBufferSize() < pageSize ? pageSize : ioBufferSize() / pageSize * pageSize);
+                uint64_t readSize = 0;
+
+                result = backupFilePageLsnUnchanged;
+
+                do
+                {
+                    bufUsedZero(buffer);
+                    ioRead(read, buffer);
+                    readSize += bufUsed(buffer);
+
+                    // Stop if the file was truncated since it is not possible to tell which pages are missing
+                    if (bufUsed(buffer) % pageSize != 0)
+                    {
+                        result = backupFilePageLsnUnknown;
+                        break;
+                    }
+
+                    for (size_t pageIdx = 0; pageIdx < bufUsed(buffer) / pageSize; pageIdx++)
+                    {
+                        const PageHeaderData *const pageHeader = (const PageHeaderData *)(bufPtrConst(buffer) + pageIdx * pageSize);
+
+                        // The LSN can only be trusted on initialized pages with a valid header. New pages have no LSN and pages
+                        // without a header, e.g. GPDB append-optimized segments, have data where the LSN would be.
+                        if (pageHeader->pd_upper == 0 ||
+                            pageHeader->pd_pagesize_version != (pageSize | BACKUP_FILE_PAGE_LAYOUT_VERSION) ||
+                            pageHeader->pd_lower < offsetof(PageHeaderData, pd_linp) ||
+                            pageHeader->pd_lower > pageHeader->pd_upper || pageHeader->pd_upper > pageHeader->pd_special ||
+                            pageHeader->pd_special > pageSize)
+                        {
+                            result = backupFilePageLsnUnknown;
+                            break;
+                        }
+
+                        // The file has changed when a page LSN is newer than the limit so there is no need to check further
+                        if (((uint64_t)pageHeader->pd_lsn.xlogid << 32 | pageHeader->pd_lsn.xrecoff) > file->pgFileLsnLimit)
+                        {
+                            result = backupFilePageLsnChanged;
+                            break;
+                        }
+                    }
+                }
+                while (result == backupFilePageLsnUnchanged && !ioReadEof(read));
+
+                // The file must not have been truncated since the manifest was built
+                if (result == backupFilePageLsnUnchanged && readSize != file->pgFileSize)
+                    result = backupFilePageLsnUnknown;
+
+                ioReadClose(read);
+            }
+        }
+        MEM_CONTEXT_TEMP_END();
+    }
+
+    FUNCTION_LOG_RETURN(ENUM, result);
+}
+
 /**********************************************************************************************************************************/
 FN_EXTERN List *
 backupFile(
     const String *const repoFile, const uint64_t bundleId, const bool bundleRaw, const unsigned int blockIncrReference,
-    const CompressType repoFileCompressType, const int repoFileCompressLevel, const CipherType cipherType,
-    const String *const cipherPass, const String *const pgVersionForce, const PgPageSize pageSize, const List *const fileList)
+    const bool blockIncrDedup, const bool blockIndexReset, const Buffer *const blockIndexUpdate,
+    const CompressType repoFileCompressType, const int repoFileCompressLevel, const unsigned int compressThread,
+    const bool compressLong, const CipherType cipherType, const String *const cipherPass, const String *const pgVersionForce,
+    const PgPageSize pageSize, const bool checksumFast, const List *const fileList)
 {
     FUNCTION_LOG_BEGIN(logLevelDebug);
         FUNCTION_LOG_PARAM(STRING, repoFile);                       // Repo file
         FUNCTION_LOG_PARAM(UINT64, bundleId);                       // Bundle id (0 if none)
         FUNCTION_LOG_PARAM(BOOL, bundleRaw);                        // Raw compress/encrypt format in bundles?
         FUNCTION_LOG_PARAM(UINT, blockIncrReference);               // Block incremental reference to use in map
+        FUNCTION_LOG_PARAM(BOOL, blockIncrDedup);                   // Deduplicate block incremental blocks?
+        FUNCTION_LOG_PARAM(BOOL, blockIndexReset);                  // Start a new block index?
+        FUNCTION_LOG_PARAM(BUFFER, blockIndexUpdate);               // Blocks to add to the block index (NULL if none)
         FUNCTION_LOG_PARAM(ENUM, repoFileCompressType);             // Compress type for repo file
         FUNCTION_LOG_PARAM(INT, repoFileCompressLevel);             // Compression level for repo file
+        FUNCTION_LOG_PARAM(UINT, compressThread);                   // Max threads used to compress large files
+        FUNCTION_LOG_PARAM(BOOL, compressLong);                     // Long distance matching for large files
         FUNCTION_LOG_PARAM(STRING_ID, cipherType);                  // Encryption type
         FUNCTION_TEST_PARAM(STRING, cipherPass);                    // Password to access the repo file if encrypted
         FUNCTION_LOG_PARAM(ENUM, pageSize);                         // Page size
         FUNCTION_LOG_PARAM(STRING, pgVersionForce);                 // Force pg version
+        FUNCTION_LOG_PARAM(BOOL, checksumFast);                     // Generate fast checksums for copied files
         FUNCTION_LOG_PARAM(LIST, fileList);                         // List of files to backup
     FUNCTION_LOG_END();
 
@@ -61,12 +215,17 @@ backupFile(
     ASSERT((cipherType == cipherTypeNone && cipherPass == NULL) || (cipherType != cipherTypeNone && cipherPass != NULL));
     ASSERT(fileList != NULL && !lstEmpty(fileList));
     ASSERT(pgPageSizeValid(pageSize));
+    ASSERT(blockIncrDedup || (!blockIndexReset && blockIndexUpdate == NULL));
 
     // Backup file results
     List *const result = lstNewP(sizeof(BackupFileResult));
 
     MEM_CONTEXT_TEMP_BEGIN()
     {
+        // Add blocks stored since the prior job to the block index
+        if (blockIncrDedup)
+            backupFileBlockIndexUpdate(blockIndexReset, blockIndexUpdate);
+
         // Check files to determine which ones need to be copied
         for (unsigned int fileIdx = 0; fileIdx < lstSize(fileList); fileIdx++)
         {
@@ -84,8 +243,33 @@ backupFile(
                 // Does the file in pg match the checksum and size passed?
                 bool pgFileMatch = false;
 
-                // If delta then check the pg checksum
-                if (file->pgFileDelta)
+                // If delta and page LSNs can be checked then check them before calculating a checksum. The limit is only set for
+                // files that reference a prior backup and have the same size as the prior file.
+                BackupFilePageLsnResult pageLsnResult = backupFilePageLsnUnknown;
+
+                if (file->pgFileDelta && file->pgFileLsnLimit != 0)
+                {
+                    ASSERT(file->manifestFileHasReference);
+
+                    pageLsnResult = backupFilePageLsn(file, pageSize);
+
+                    // If no page has changed then no need to copy the file
+                    if (pageLsnResult == backupFilePageLsnUnchanged)
+                    {
+                        pgFileMatch = true;
+
+                        MEM_CONTEXT_BEGIN(lstMemContext(result))
+                        {
+                            fileResult->backupCopyResult = backupCopyResultNoOp;
+                            fileResult->copySize = file->pgFileSize;
+                            fileResult->copyChecksum = file->pgFileChecksum;
+                        }
+                        MEM_CONTEXT_END();
+                    }
+                }
+
+                // If delta and page LSNs could not be used then check the pg checksum
+                if (file->pgFileDelta && pageLsnResult == backupFilePageLsnUnknown)
                 {
                     // Generate checksum/size for the pg file. Only read as many bytes as passed in pgFileSize. If the file has
                     // grown since the manifest was built we don't need to consider the extra bytes since they will be replayed from
@@ -94,18 +278,24 @@ backupFile(
                         storageNewReadP(
                             storagePg(), file->pgFile, .ignoreMissing = file->pgFileIgnoreMissing,
                             .limit = file->pgFileCopyExactSize ? VARUINT64(file->pgFileSize) : NULL));
-                    ioFilterGroupAdd(ioReadFilterGroup(read), cryptoHashNew(hashTypeSha1));
+
+                    // Use the fast checksum when it was stored since it is much cheaper to calculate than SHA1
+                    const bool pgFast = file->pgFileChecksumFast != NULL;
+
+                    ioFilterGroupAdd(
+                        ioReadFilterGroup(read), pgFast ? xxHashNew(MANIFEST_CHECKSUM_FAST_SIZE) : cryptoHashNew(hashTypeSha1));
                     ioFilterGroupAdd(ioReadFilterGroup(read), ioSizeNew());
 
                     // If the pg file exists check the checksum/size
                     if (ioReadDrain(read))
                     {
                         const Buffer *const pgTestChecksum = pckReadBinP(
-                            ioFilterGroupResultP(ioReadFilterGroup(read), CRYPTO_HASH_FILTER_TYPE));
+                            ioFilterGroupResultP(ioReadFilterGroup(read), pgFast ? XX_HASH_FILTER_TYPE : CRYPTO_HASH_FILTER_TYPE));
                         const uint64_t pgTestSize = pckReadU64P(ioFilterGroupResultP(ioReadFilterGroup(read), SIZE_FILTER_TYPE));
 
                         // Does the pg file match?
-                        if (file->pgFileSize == pgTestSize && bufEq(file->pgFileChecksum, pgTestChecksum))
+                        if (file->pgFileSize == pgTestSize &&
+                            bufEq(pgFast ? file->pgFileChecksumFast : file->pgFileChecksum, pgTestChecksum))
                         {
                             pgFileMatch = true;
 
@@ -142,15 +332,25 @@ backupFile(
                     // Else if the pg file matches or is unknown because delta was not performed then check the repo file
                     else if (!file->pgFileDelta || pgFileMatch)
                     {
+                        // Expected checksums for the repo file. When the repo checksum is missing the repo file was not
+                        // compressed/encrypted so the pg file checksums apply. Use the fast checksum when it was stored.
+                        const Buffer *const repoChecksum =
+                            file->repoFileChecksum != NULL ? file->repoFileChecksum : file->pgFileChecksum;
+                        const Buffer *const repoChecksumFast =
+                            file->repoFileChecksum != NULL ? file->repoFileChecksumFast : file->pgFileChecksumFast;
+
                         // Generate checksum/size for the repo file
                         IoRead *const read = storageReadIo(storageNewReadP(storageRepo(), repoFile));
-                        ioFilterGroupAdd(ioReadFilterGroup(read), cryptoHashNew(hashTypeSha1));
+                        ioFilterGroupAdd(
+                            ioReadFilterGroup(read),
+                            repoChecksumFast != NULL ? xxHashNew(MANIFEST_CHECKSUM_FAST_SIZE) : cryptoHashNew(hashTypeSha1));
                         ioFilterGroupAdd(ioReadFilterGroup(read), ioSizeNew());
                         ioReadDrain(read);
 
                         // Test checksum/size
                         const Buffer *const pgTestChecksum = pckReadBinP(
-                            ioFilterGroupResultP(ioReadFilterGroup(read), CRYPTO_HASH_FILTER_TYPE));
+                            ioFilterGroupResultP(
+                                ioReadFilterGroup(read), repoChecksumFast != NULL ? XX_HASH_FILTER_TYPE : CRYPTO_HASH_FILTER_TYPE));
                         const uint64_t pgTestSize = pckReadU64P(ioFilterGroupResultP(ioReadFilterGroup(read), SIZE_FILTER_TYPE));
 
                         // No need to recopy if checksum/size match. When the repo checksum is missing still compare to repo size
@@ -158,7 +358,7 @@ backupFile(
                         // repo size should match the original size. There is no need to worry about old manifests here since resume
                         // does not work across versions.
                         if (file->repoFileSize == pgTestSize &&
-                            bufEq(file->repoFileChecksum != NULL ? file->repoFileChecksum : file->pgFileChecksum, pgTestChecksum))
+                            bufEq(repoChecksumFast != NULL ? repoChecksumFast : repoChecksum, pgTestChecksum))
                         {
                             MEM_CONTEXT_BEGIN(lstMemContext(result))
                             {
@@ -214,6 +414,10 @@ backupFile(
                     ioFilterGroupAdd(ioReadFilterGroup(readIo), cryptoHashNew(hashTypeSha1));
                     ioFilterGroupAdd(ioReadFilterGroup(readIo), ioSizeNew());
 
+                    // Add fast checksum filter for the pg file
+                    if (checksumFast)
+                        ioFilterGroupAdd(ioReadFilterGroup(readIo), xxHashNew(MANIFEST_CHECKSUM_FAST_SIZE));
+
                     // Add page checksum filter
                     if (file->pgFileChecksumPage)
                     {
@@ -224,11 +428,15 @@ backupFile(
                                 file->pgFilePageHeaderCheck, storagePathP(storagePg(), file->pgFile)));
                     }
 
-                    // Compress filter
+                    // Compress filter. Large files may be compressed on multiple threads so they do not hold up the end of the
+                    // backup, but not with block incremental since blocks are compressed separately.
+                    const bool compressLarge = file->pgFileSize >= BACKUP_FILE_COMPRESS_LARGE_SIZE && file->blockIncrSize == 0;
+
                     IoFilter *const compress =
                         repoFileCompressType != compressTypeNone ?
                             compressFilterP(
-                                repoFileCompressType, repoFileCompressLevel, .raw = bundleRaw || file->blockIncrSize != 0) :
+                                repoFileCompressType, repoFileCompressLevel, .raw = bundleRaw || file->blockIncrSize != 0,
+                                .threadMax = compressLarge ? compressThread : 1, .longMatch = compressLarge && compressLong) :
                             NULL;
 
                     // Encrypt filter
@@ -261,12 +469,24 @@ backupFile(
                             blockMap = storageGetP(blockMapRead);
                         }
 
+                        // Get blocks stored in the backup set with the same block size
+                        Buffer *blockIndex = NULL;
+
+                        if (blockIncrDedup && blockIndexSize(backupFileLocal.blockIndex) > 0)
+                        {
+                            blockIndex = bufNew(0);
+                            IoWrite *const write = ioBufferWriteNewOpen(blockIndex);
+
+                            blockIndexWrite(backupFileLocal.blockIndex, write, file->blockIncrSize);
+                            ioWriteClose(write);
+                        }
+
                         // Add block incremental filter
                         ioFilterGroupAdd(
                             ioReadFilterGroup(readIo),
                             blockIncrNew(
                                 file->blockIncrSuperSize, file->blockIncrSize, file->blockIncrChecksumSize, blockIncrReference,
-                                bundleId, bundleOffset, blockMap, compress, encrypt));
+                                bundleId, bundleOffset, blockMap, blockIncrDedup, blockIndex, compress, encrypt));
 
                         repoChecksum = true;
                     }
@@ -290,8 +510,13 @@ backupFile(
 
                     // Capture checksum of file stored in the repo if filters that modify the output have been applied
                     if (repoChecksum)
+                    {
                         ioFilterGroupAdd(ioReadFilterGroup(readIo), cryptoHashNew(hashTypeSha1));
 
+                        if (checksumFast)
+                            ioFilterGroupAdd(ioReadFilterGroup(readIo), xxHashNew(MANIFEST_CHECKSUM_FAST_SIZE));
+                    }
+
                     // Add size filter last to calculate repo size
                     ioFilterGroupAdd(ioReadFilterGroup(readIo), ioSizeNew());
 
@@ -409,8 +634,15 @@ backupFile(
                                 // Get results of block incremental
                                 if (file->blockIncrSize != 0)
                                 {
-                                    fileResult->blockIncrMapSize = pckReadU64P(
-                                        ioFilterGroupResultP(ioReadFilterGroup(readIo), BLOCK_INCR_FILTER_TYPE));
+                                    PackRead *const blockIncrResult = ioFilterGroupResultP(
+                                        ioReadFilterGroup(readIo), BLOCK_INCR_FILTER_TYPE);
+
+                                    fileResult->blockIncrMapSize = pckReadU64P(blockIncrResult);
+                                    fileResult->blockIndex = pckReadBinP(blockIncrResult);
+
+                                    // Add stored blocks to the block index so later files in this job can reference them
+                                    if (fileResult->blockIndex != NULL)
+                                        blockIndexAddRead(backupFileLocal.blockIndex, ioBufferReadNewOpen(fileResult->blockIndex));
 
                                     // There must be a map because the file should have changed or shrunk
                                     ASSERT(fileResult->blockIncrMapSize > 0);
@@ -422,6 +654,19 @@ backupFile(
                                     fileResult->repoChecksum = pckReadBinP(
                                         ioFilterGroupResultP(ioReadFilterGroup(readIo), CRYPTO_HASH_FILTER_TYPE, .idx = 1));
                                 }
+
+                                // Get fast checksums
+                                if (checksumFast)
+                                {
+                                    fileResult->copyChecksumFast = pckReadBinP(
+                                        ioFilterGroupResultP(ioReadFilterGroup(readIo), XX_HASH_FILTER_TYPE, .idx = 0));
+
+                                    if (repoChecksum)
+                                    {
+                                        fileResult->repoChecksumFast = pckReadBinP(
+                                            ioFilterGroupResultP(ioReadFilterGroup(readIo), XX_HASH_FILTER_TYPE, .idx = 1));
+                                    }
+                                }
                             }
                             MEM_CONTEXT_END();
 
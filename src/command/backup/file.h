@@ -34,8 +34,10 @@ typedef struct BackupFile
     uint64_t pgFileSizePrior;                                       // Prior pg file size (if manifestFileHasReference)
     bool pgFileCopyExactSize;                                       // Copy only pg expected size
     const Buffer *pgFileChecksum;                                   // Expected pg file checksum
+    const Buffer *pgFileChecksumFast;                               // Expected pg file fast checksum (NULL to use pgFileChecksum)
     bool pgFileChecksumPage;                                        // Validate page checksums?
     bool pgFilePageHeaderCheck;                                     // Validate page headers?
+    uint64_t pgFileLsnLimit;                                        // Unchanged if no page LSN is newer than this (0 if disabled)
     size_t blockIncrSize;                                           // Perform block incremental on this file?
     size_t blockIncrChecksumSize;                                   // Block checksum size
     uint64_t blockIncrSuperSize;                                    // Size of the super block
@@ -44,6 +46,7 @@ typedef struct BackupFile
     uint64_t blockIncrMapPriorSize;                                 // Size of prior block incremental map
     const String *manifestFile;                                     // Repo file
     const Buffer *repoFileChecksum;                                 // Expected repo file checksum
+    const Buffer *repoFileChecksumFast;                             // Expected repo file fast checksum (if stored)
     uint64_t repoFileSize;                                          // Expected repo file size
     bool manifestFileResume;                                        // Checksum repo file before copying
     bool manifestFileHasReference;                                  // Reference to prior backup, if any
@@ -57,15 +60,19 @@ typedef struct BackupFileResult
     uint64_t copySize;
     const Buffer *copyChecksum;                                     // Checksum of pg file
     const Buffer *repoChecksum;                                     // Checksum of repo file (including compression, etc.)
+    const Buffer *copyChecksumFast;                                 // Fast checksum of pg file (if requested)
+    const Buffer *repoChecksumFast;                                 // Fast checksum of repo file (if requested and repo differs)
     uint64_t bundleOffset;                                          // Offset in bundle if any
     uint64_t repoSize;
     uint64_t blockIncrMapSize;                                      // Size of block incremental map (0 if no map)
+    const Buffer *blockIndex;                                       // Index of blocks stored for the file (if deduplicating)
     Pack *pageChecksumResult;
 } BackupFileResult;
 
 FN_EXTERN List *backupFile(
-    const String *repoFile, uint64_t bundleId, bool bundleRaw, unsigned int blockIncrReference, CompressType repoFileCompressType,
-    int repoFileCompressLevel, CipherType cipherType, const String *cipherPass, const String *pgVersionForce, PgPageSize pageSize,
-    const List *fileList);
+    const String *repoFile, uint64_t bundleId, bool bundleRaw, unsigned int blockIncrReference, bool blockIncrDedup,
+    bool blockIndexReset, const Buffer *blockIndexUpdate, CompressType repoFileCompressType, int repoFileCompressLevel,
+    unsigned int compressThread, bool compressLong, CipherType cipherType, const String *cipherPass, const String *pgVersionForce,
+    PgPageSize pageSize, bool checksumFast, const List *fileList);
 
 #endif
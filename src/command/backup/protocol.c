@@ -33,12 +33,18 @@ backupFileProtocol(PackRead *const param, ProtocolServer *const server)
         const uint64_t bundleId = pckReadU64P(param);
         const bool bundleRaw = bundleId != 0 ? pckReadBoolP(param) : false;
         const unsigned int blockIncrReference = (unsigned int)pckReadU64P(param);
+        const bool blockIncrDedup = pckReadBoolP(param);
+        const bool blockIndexReset = pckReadBoolP(param);
+        const Buffer *const blockIndexUpdate = pckReadBinP(param);
         const CompressType repoFileCompressType = (CompressType)pckReadU32P(param);
         const int repoFileCompressLevel = pckReadI32P(param);
+        const unsigned int compressThread = pckReadU32P(param);
+        const bool compressLong = pckReadBoolP(param);
         const CipherType cipherType = (CipherType)pckReadU64P(param);
         const String *const cipherPass = pckReadStrP(param);
         const PgPageSize pageSize = pckReadU32P(param);
         const String *const pgVersionForce = pckReadStrP(param);
+        const bool checksumFast = pckReadBoolP(param);
 
         // Build the file list
         List *const fileList = lstNewP(sizeof(BackupFile));
@@ -52,8 +58,10 @@ backupFileProtocol(PackRead *const param, ProtocolServer *const server)
             file.pgFileSizePrior = pckReadU64P(param);
             file.pgFileCopyExactSize = pckReadBoolP(param);
             file.pgFileChecksum = pckReadBinP(param);
+            file.pgFileChecksumFast = pckReadBinP(param);
             file.pgFileChecksumPage = pckReadBoolP(param);
             file.pgFilePageHeaderCheck = pckReadBoolP(param);
+            file.pgFileLsnLimit = pckReadU64P(param);
             file.blockIncrSize = (size_t)pckReadU64P(param);
 
             if (file.blockIncrSize > 0)
@@ -71,6 +79,7 @@ backupFileProtocol(PackRead *const param, ProtocolServer *const server)
 
             file.manifestFile = pckReadStrP(param);
             file.repoFileChecksum = pckReadBinP(param);
+            file.repoFileChecksumFast = pckReadBinP(param);
             file.repoFileSize = pckReadU64P(param);
             file.manifestFileResume = pckReadBoolP(param);
             file.manifestFileHasReference = pckReadBoolP(param);
@@ -80,8 +89,9 @@ backupFileProtocol(PackRead *const param, ProtocolServer *const server)
 
         // Backup file
         const List *const result = backupFile(
-            repoFile, bundleId, bundleRaw, blockIncrReference, repoFileCompressType, repoFileCompressLevel, cipherType, cipherPass,
-            pgVersionForce, pageSize, fileList);
+            repoFile, bundleId, bundleRaw, blockIncrReference, blockIncrDedup, blockIndexReset, blockIndexUpdate,
+            repoFileCompressType, repoFileCompressLevel, compressThread, compressLong, cipherType, cipherPass, pgVersionForce,
+            pageSize, checksumFast, fileList);
 
         // Return result
         PackWrite *const resultPack = protocolPackNew();
@@ -100,9 +110,12 @@ backupFileProtocol(PackRead *const param, ProtocolServer *const server)
             pckWriteU64P(resultPack, fileResult->copySize);
             pckWriteU64P(resultPack, fileResult->bundleOffset);
             pckWriteU64P(resultPack, fileResult->blockIncrMapSize);
+            pckWriteBinP(resultPack, fileResult->blockIndex);
             pckWriteU64P(resultPack, fileResult->repoSize);
             pckWriteBinP(resultPack, fileResult->copyChecksum);
             pckWriteBinP(resultPack, fileResult->repoChecksum);
+            pckWriteBinP(resultPack, fileResult->copyChecksumFast);
+            pckWriteBinP(resultPack, fileResult->repoChecksumFast);
             pckWritePackP(resultPack, fileResult->pageChecksumResult);
         }
 
@@ -3,6 +3,7 @@ Expire Command
 ***********************************************************************************************************************************/
 #include "build.auto.h"
 
+#include "command/archive/bundle.h"
 #include "command/archive/common.h"
 #include "command/backup/common.h"
 #include "command/control/common.h"
@@ -67,7 +68,11 @@ expireBackup(const InfoBackup *const infoBackup, const String *const backupLabel
             // Execute the real expiration and deletion only if the dry-run option is disabled
             if (!cfgOptionValid(cfgOptDryRun) || !cfgOptionBool(cfgOptDryRun))
             {
-                // Remove the manifest files to invalidate the backup
+                // Remove the manifest files to invalidate the backup. The binary manifest is removed first since it is preferred
+                // when loading.
+                storageRemoveP(
+                    storageRepoIdxWrite(repoIdx),
+                    strNewFmt(STORAGE_REPO_BACKUP "/%s/" BACKUP_MANIFEST_FILE MANIFEST_BIN_EXT, strZ(removeBackupLabel)));
                 storageRemoveP(
                     storageRepoIdxWrite(repoIdx),
                     strNewFmt(STORAGE_REPO_BACKUP "/%s/" BACKUP_MANIFEST_FILE, strZ(removeBackupLabel)));
@@ -699,14 +704,17 @@ removeExpiredArchive(const InfoBackup *const infoBackup, const bool timeBasedFul
                                         removeArchive = true;
                                         const String *const walSubPath = strLstGet(walSubPathList, subIdx);
 
+                                        // A bundle contains a range of segments so it is used when any part of the range is used
+                                        const String *const walSegmentFirst = strSubN(walSubPath, 0, 24);
+                                        const String *const walSegmentLast = walBundleSegmentLast(walSubPath);
+
                                         // Determine if the individual archive log is used in a backup
                                         for (unsigned int rangeIdx = 0; rangeIdx < lstSize(archiveRangeList); rangeIdx++)
                                         {
                                             const ArchiveRange *const archiveRange = lstGet(archiveRangeList, rangeIdx);
 
-                                            if (strCmp(strSubN(walSubPath, 0, 24), archiveRange->start) >= 0 &&
-                                                (archiveRange->stop == NULL ||
-                                                 strCmp(strSubN(walSubPath, 0, 24), archiveRange->stop) <= 0))
+                                            if (strCmp(walSegmentLast, archiveRange->start) >= 0 &&
+                                                (archiveRange->stop == NULL || strCmp(walSegmentFirst, archiveRange->stop) <= 0))
                                             {
                                                 removeArchive = false;
                                                 break;
@@ -728,10 +736,10 @@ removeExpiredArchive(const InfoBackup *const infoBackup, const bool timeBasedFul
 
                                             // Track that this archive was removed
                                             archiveExpire.total++;
-                                            archiveExpire.stop = strDup(strSubN(walSubPath, 0, 24));
+                                            archiveExpire.stop = strDup(walSegmentLast);
 
                                             if (archiveExpire.start == NULL)
-                                                archiveExpire.start = strDup(strSubN(walSubPath, 0, 24));
+                                                archiveExpire.start = strDup(walSegmentFirst);
                                         }
                                         else
                                             logExpire(&archiveExpire, archiveId, repoIdx);
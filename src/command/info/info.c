@@ -8,6 +8,7 @@ Info Command
 #include <time.h>
 #include <unistd.h>
 
+#include "command/archive/bundle.h"
 #include "command/archive/common.h"
 #include "command/info/info.h"
 #include "common/crypto/common.h"
@@ -349,7 +350,7 @@ archiveDbList(
             const StringList *const list = strLstSort(
                 storageListP(
                     storageRepo, strNewFmt("%s/%s", strZ(archivePath), strZ(strLstGet(walDir, idx))),
-                    .expression = WAL_SEGMENT_FILE_REGEXP_STR),
+                    .expression = WAL_SEGMENT_BUNDLE_FILE_REGEXP_STR),
                 sortOrderAsc);
 
             // If wal segments are found, get the oldest one as the archive start
@@ -368,13 +369,21 @@ archiveDbList(
             const StringList *const list = strLstSort(
                 storageListP(
                     storageRepo, strNewFmt("%s/%s", strZ(archivePath), strZ(strLstGet(walDir, idx))),
-                    .expression = WAL_SEGMENT_FILE_REGEXP_STR),
+                    .expression = WAL_SEGMENT_BUNDLE_FILE_REGEXP_STR),
                 sortOrderDesc);
 
-            // If wal segments are found, get the newest one as the archive stop
+            // If wal segments are found, get the newest one as the archive stop. Bundles are named for the first segment they
+            // contain so the last segment of each must be checked.
             if (!strLstEmpty(list))
             {
-                archiveStop = strSubN(strLstGet(list, 0), 0, 24);
+                for (unsigned int listIdx = 0; listIdx < strLstSize(list); listIdx++)
+                {
+                    const String *const walSegmentLast = walBundleSegmentLast(strLstGet(list, listIdx));
+
+                    if (archiveStop == NULL || strCmp(walSegmentLast, archiveStop) > 0)
+                        archiveStop = walSegmentLast;
+                }
+
                 break;
             }
         }
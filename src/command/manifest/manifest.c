@@ -236,7 +236,8 @@ cmdManifestBlockDeltaRender(const Manifest *const manifest, const ManifestFile *
                 ioFilterGroupAdd(
                     ioReadFilterGroup(storageReadIo(read)),
                     cipherBlockNewP(
-                        cipherModeDecrypt, cipherTypeAes256Cbc, BUFSTR(manifestCipherSubPass(manifest)), .raw = true));
+                        cipherModeDecrypt, cfgOptionStrId(cfgOptRepoCipherType), BUFSTR(manifestCipherSubPass(manifest)),
+                        .raw = true));
             }
 
             ioReadOpen(storageReadIo(read));
@@ -442,7 +443,7 @@ cmdManifestRender(void)
             storageRepo(), INFO_BACKUP_PATH_FILE_STR, cfgOptionStrId(cfgOptRepoCipherType),
             cfgOptionStrNull(cfgOptRepoCipherPass));
         const String *const cipherPass = infoPgCipherPass(infoBackupPg(infoBackup));
-        const CipherType cipherType = cipherPass == NULL ? cipherTypeNone : cipherTypeAes256Cbc;
+        const CipherType cipherType = cipherPass == NULL ? cipherTypeNone : cfgOptionStrId(cfgOptRepoCipherType);
 
         // Load manifest
         const Manifest *const manifest = manifestLoadFile(
@@ -10,6 +10,7 @@ Remote Command
 #include "command/control/common.h"
 #include "command/restore/blockChecksum.h"
 #include "common/crypto/cipherBlock.h"
+#include "common/crypto/cipherFrame.h"
 #include "common/crypto/hash.h"
 #include "common/debug.h"
 #include "common/io/filter/sink.h"
@@ -40,6 +41,7 @@ static const StorageRemoteFilterHandler storageRemoteFilterHandlerList[] =
     {.type = BLOCK_CHECKSUM_FILTER_TYPE, .handlerParam = blockChecksumNewPack},
     {.type = BLOCK_INCR_FILTER_TYPE, .handlerParam = blockIncrNewPack},
     {.type = CIPHER_BLOCK_FILTER_TYPE, .handlerParam = cipherBlockNewPack},
+    {.type = CIPHER_FRAME_FILTER_TYPE, .handlerParam = cipherFrameNewPack},
     {.type = CRYPTO_HASH_FILTER_TYPE, .handlerParam = cryptoHashNewPack},
     {.type = PAGE_CHECKSUM_FILTER_TYPE, .handlerParam = pageChecksumNewPack},
     {.type = SINK_FILTER_TYPE, .handlerNoParam = ioSinkNew},
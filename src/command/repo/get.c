@@ -117,7 +117,8 @@ storageGetProcess(IoWrite *const destination)
                                 // Find the manifest passphrase
                                 if (!strEq(strLstGet(filePathSplitLst, 2), STRDEF(BACKUP_PATH_HISTORY)) &&
                                     !strEndsWithZ(file, BACKUP_MANIFEST_FILE) &&
-                                    !strEndsWithZ(file, BACKUP_MANIFEST_FILE INFO_COPY_EXT))
+                                    !strEndsWithZ(file, BACKUP_MANIFEST_FILE INFO_COPY_EXT) &&
+                                    !strEndsWithZ(file, BACKUP_MANIFEST_FILE MANIFEST_BIN_EXT))
                                 {
                                     const Manifest *const manifest = manifestLoadFile(
                                         storageRepo(),
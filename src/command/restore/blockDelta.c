@@ -38,7 +38,8 @@ struct BlockDelta
 
     const BlockDeltaSuperBlock *superBlockData;                     // Current super block data
     unsigned int superBlockIdx;                                     // Current super block index
-    IoRead *limitRead;                                              // Limit read for current super block
+    IoRead *limitRead;                                              // Limit read of stored bytes for current super block
+    IoRead *blockRead;                                              // Decrypted/decompressed read for current super block
     const BlockDeltaBlock *blockData;                               // Current block data
     unsigned int blockIdx;                                          // Current block index
     unsigned int blockTotal;                                        // Block total for super block
@@ -54,6 +55,47 @@ typedef struct BlockDeltaReference
     List *blockList;                                                // List of blocks in the block map for the reference
 } BlockDeltaReference;
 
+typedef struct BlockDeltaReferenceBlock
+{
+    uint64_t bundleId;                                              // Bundle where the block is stored
+    uint64_t offset;                                                // Offset of the super block
+    uint64_t block;                                                 // Block no inside of super block
+    unsigned int blockMapIdx;                                       // Index of the block in the block map
+} BlockDeltaReferenceBlock;
+
+// Sort blocks in the order they are stored. Blocks are usually already in this order, but deduplicated blocks (see BlockIndex) may
+// be stored in any order and the same block may be used more than once.
+static int
+blockDeltaReferenceBlockComparator(const void *const item1, const void *const item2)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, item1);
+        FUNCTION_TEST_PARAM_P(VOID, item2);
+    FUNCTION_TEST_END();
+
+    ASSERT(item1 != NULL);
+    ASSERT(item2 != NULL);
+
+    const BlockDeltaReferenceBlock *const block1 = item1;
+    const BlockDeltaReferenceBlock *const block2 = item2;
+    int result = LST_COMPARATOR_CMP(block1->bundleId, block2->bundleId);
+
+    if (result == 0)
+    {
+        result = LST_COMPARATOR_CMP(block1->offset, block2->offset);
+
+        if (result == 0)
+        {
+            result = LST_COMPARATOR_CMP(block1->block, block2->block);
+
+            if (result == 0)
+                result = LST_COMPARATOR_CMP(block1->blockMapIdx, block2->blockMapIdx);
+        }
+    }
+
+    FUNCTION_TEST_RETURN(INT, result);
+}
+
 FN_EXTERN BlockDelta *
 blockDeltaNew(
     const BlockMap *const blockMap, const size_t blockSize, const size_t checksumSize, const Buffer *const blockChecksum,
@@ -111,6 +153,13 @@ blockDeltaNew(
                         BUF(bufPtrConst(blockChecksum) + blockMapIdx * this->checksumSize, this->checksumSize)))
                 {
                     const unsigned int reference = blockMapItem->reference;
+                    const BlockDeltaReferenceBlock referenceBlock =
+                    {
+                        .bundleId = blockMapItem->bundleId,
+                        .offset = blockMapItem->offset,
+                        .block = blockMapItem->block,
+                        .blockMapIdx = blockMapIdx,
+                    };
                     BlockDeltaReference *const referenceData = lstFind(referenceList, &reference);
 
                     // If the reference has not been added
@@ -118,12 +167,17 @@ blockDeltaNew(
                     {
                         const BlockDeltaReference *const referenceData = lstAdd(
                             referenceList,
-                            &(BlockDeltaReference){.reference = reference, .blockList = lstNewP(sizeof(unsigned int))});
-                        lstAdd(referenceData->blockList, &blockMapIdx);
+                            &(BlockDeltaReference)
+                            {
+                                .reference = reference,
+                                .blockList = lstNewP(
+                                    sizeof(BlockDeltaReferenceBlock), .comparator = blockDeltaReferenceBlockComparator),
+                            });
+                        lstAdd(referenceData->blockList, &referenceBlock);
                     }
                     // Else add the new block
                     else
-                        lstAdd(referenceData->blockList, &blockMapIdx);
+                        lstAdd(referenceData->blockList, &referenceBlock);
                 }
             }
 
@@ -138,14 +192,22 @@ blockDeltaNew(
                 const BlockDeltaSuperBlock *blockDeltaSuperBlock = NULL;
                 const BlockMapItem *blockMapItemPrior = NULL;
 
+                lstSort(referenceData->blockList, sortOrderAsc);
+
                 for (unsigned int blockIdx = 0; blockIdx < lstSize(referenceData->blockList); blockIdx++)
                 {
-                    const unsigned int blockMapIdx = *(unsigned int *)lstGet(referenceData->blockList, blockIdx);
+                    const unsigned int blockMapIdx =
+                        ((const BlockDeltaReferenceBlock *)lstGet(referenceData->blockList, blockIdx))->blockMapIdx;
                     const BlockMapItem *const blockMapItem = blockMapGet(blockMap, blockMapIdx);
 
+                    // Determine if the super block has changed
+                    const bool superBlockChanged =
+                        blockMapItemPrior == NULL || blockMapItemPrior->bundleId != blockMapItem->bundleId ||
+                        blockMapItemPrior->offset != blockMapItem->offset;
+
                     // Add read when it has changed
-                    if (blockMapItemPrior == NULL ||
-                        (blockMapItemPrior->offset != blockMapItem->offset &&
+                    if (superBlockChanged &&
+                        (blockMapItemPrior == NULL || blockMapItemPrior->bundleId != blockMapItem->bundleId ||
                          blockMapItemPrior->offset + blockMapItemPrior->size != blockMapItem->offset))
                     {
                         MEM_CONTEXT_OBJ_BEGIN(this->pub.readList)
@@ -164,7 +226,7 @@ blockDeltaNew(
                     }
 
                     // Add super block when it has changed
-                    if (blockMapItemPrior == NULL || blockMapItemPrior->offset != blockMapItem->offset)
+                    if (superBlockChanged)
                     {
                         MEM_CONTEXT_OBJ_BEGIN(blockDeltaRead->superBlockList)
                         {
@@ -227,27 +289,31 @@ blockDeltaNext(BlockDelta *const this, const BlockDeltaRead *const readDelta, Io
         // If the super block read has not begun yet
         if (this->superBlockData == NULL)
         {
-            // Free prior limit read and create limit read for current super block
+            // Free prior reads and create reads for current super block. The stored bytes are limited separately from decoding so
+            // the end of the super block can be skipped without decoding it.
+            ioReadFree(this->blockRead);
             ioReadFree(this->limitRead);
             this->superBlockData = lstGet(readDelta->superBlockList, this->superBlockIdx);
 
             MEM_CONTEXT_OBJ_BEGIN(this)
             {
                 this->limitRead = ioLimitReadNew(readIo, this->superBlockData->size);
+                this->blockRead = ioLimitReadNew(this->limitRead, this->superBlockData->size);
             }
             MEM_CONTEXT_OBJ_END();
 
             if (this->cipherType != cipherTypeNone)
             {
                 ioFilterGroupAdd(
-                    ioReadFilterGroup(this->limitRead),
+                    ioReadFilterGroup(this->blockRead),
                     cipherBlockNewP(cipherModeDecrypt, this->cipherType, BUFSTR(this->cipherPass), .raw = true));
             }
 
             if (this->compressType != compressTypeNone)
-                ioFilterGroupAdd(ioReadFilterGroup(this->limitRead), decompressFilterP(this->compressType, .raw = true));
+                ioFilterGroupAdd(ioReadFilterGroup(this->blockRead), decompressFilterP(this->compressType, .raw = true));
 
             ioReadOpen(this->limitRead);
+            ioReadOpen(this->blockRead);
 
             // Set block info
             this->blockIdx = 0;
@@ -258,14 +324,34 @@ blockDeltaNext(BlockDelta *const this, const BlockDeltaRead *const readDelta, Io
             this->blockData = lstGet(this->superBlockData->blockList, this->blockFindIdx);
         }
 
-        // Find required blocks in the super block
-        while (this->blockIdx < this->blockTotal)
+        // Find required blocks in the super block. Stop once all required blocks have been found since there is no need to decode
+        // the rest of the super block.
+        while (this->blockFindIdx < lstSize(this->superBlockData->blockList))
         {
+            // If the block was the last block read then return it again. This happens when a deduplicated block is used at more
+            // than one offset.
+            if (this->blockIdx > 0 && this->blockData->no == this->blockIdx - 1)
+            {
+                this->write.offset = this->blockData->offset;
+                result = &this->write;
+                this->blockFindIdx++;
+
+                // Get the next block if there are any more to read
+                if (this->blockFindIdx < lstSize(this->superBlockData->blockList))
+                    this->blockData = lstGet(this->superBlockData->blockList, this->blockFindIdx);
+
+                break;
+            }
+
+            // Stop when all blocks in the super block have been read
+            if (this->blockIdx == this->blockTotal)
+                break;
+
             // Clear buffer and read block
             bufUsedZero(this->write.block);
             bufLimitClear(this->write.block);
 
-            ioRead(this->limitRead, this->write.block);
+            ioRead(this->blockRead, this->write.block);
 
             // If the block matches the block we are expecting
             if (this->blockIdx == this->blockData->no)
@@ -293,10 +379,15 @@ blockDeltaNext(BlockDelta *const this, const BlockDeltaRead *const readDelta, Io
         if (result != NULL)
             break;
 
-        // Check that no bytes remain to be written. It is possible that some bytes remain in the super block, however, since we may
-        // have gotten all the bytes we needed but just missed reading something important, e.g. an end of file marker. If we do not
-        // read the remaining bytes then the next read will start too early.
-        ioReadFlushP(this->limitRead, .errorOnBytes = true);
+        // If all blocks were read then check that no bytes remain to be written. It is possible that some bytes remain in the super
+        // block, however, since we may have gotten all the bytes we needed but just missed reading something important, e.g. an end
+        // of file marker.
+        if (this->blockIdx == this->blockTotal)
+            ioReadFlushP(this->blockRead, .errorOnBytes = true);
+
+        // Skip stored bytes that remain in the super block without decoding them. If we do not read the remaining bytes then the
+        // next read will start too early.
+        ioReadFlushP(this->limitRead);
 
         this->superBlockData = NULL;
         this->superBlockIdx++;
@@ -306,7 +397,6 @@ blockDeltaNext(BlockDelta *const this, const BlockDeltaRead *const readDelta, Io
     if (result == NULL)
     {
         ASSERT(this->superBlockIdx == lstSize(readDelta->superBlockList));
-        ASSERT(this->blockIdx == this->blockTotal);
 
         this->superBlockData = NULL;
         this->superBlockIdx = 0;
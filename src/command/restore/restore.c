@@ -210,7 +210,7 @@ typedef struct RestoreBackupData
 
 // Helper function for restoreBackupSet
 static RestoreBackupData
-restoreBackupData(const String *const backupLabel, const unsigned int repoIdx, const String *const backupCipherPass)
+restoreBackupData(const String *const backupLabel, const unsigned int repoIdx, const InfoBackup *const infoBackup)
 {
     ASSERT(backupLabel != NULL);
 
@@ -220,8 +220,8 @@ restoreBackupData(const String *const backupLabel, const unsigned int repoIdx, c
     {
         restoreBackup.backupSet = strDup(backupLabel);
         restoreBackup.repoIdx = repoIdx;
-        restoreBackup.repoCipherType = cfgOptionIdxStrId(cfgOptRepoCipherType, repoIdx);
-        restoreBackup.backupCipherPass = strDup(backupCipherPass);
+        restoreBackup.repoCipherType = infoBackupCipherType(infoBackup);
+        restoreBackup.backupCipherPass = strDup(infoBackupCipherPass(infoBackup));
     }
     MEM_CONTEXT_PRIOR_END();
 
@@ -339,7 +339,7 @@ restoreBackupSet(void)
                         {
                             found = true;
 
-                            result = restoreBackupData(backupData.backupLabel, repoIdx, infoPgCipherPass(infoBackupPg(infoBackup)));
+                            result = restoreBackupData(backupData.backupLabel, repoIdx, infoBackup);
                             break;
                         }
                     }
@@ -366,7 +366,7 @@ restoreBackupSet(void)
                             strZ(latestBackup.backupLabel));
                     }
 
-                    result = restoreBackupData(latestBackup.backupLabel, repoIdx, infoPgCipherPass(infoBackupPg(infoBackup)));
+                    result = restoreBackupData(latestBackup.backupLabel, repoIdx, infoBackup);
                     break;
                 }
             }
@@ -377,7 +377,7 @@ restoreBackupSet(void)
                 {
                     if (strEq(infoBackupData(infoBackup, backupIdx).backupLabel, backupSetRequested))
                     {
-                        result = restoreBackupData(backupSetRequested, repoIdx, infoPgCipherPass(infoBackupPg(infoBackup)));
+                        result = restoreBackupData(backupSetRequested, repoIdx, infoBackup);
                         break;
                     }
                 }
@@ -1364,14 +1364,8 @@ restoreSelectiveExpression(const Manifest *const manifest)
     {
         MEM_CONTEXT_TEMP_BEGIN()
         {
-            // Generate base expression
-            RegExp *const baseRegExp = regExpNew(STRDEF("^" MANIFEST_TARGET_PGDATA "/" PG_PATH_BASE "/[0-9]+/" PG_FILE_PGVERSION));
-
-            // Generate tablespace expression
             const String *const tablespaceId = pgTablespaceId(
                 manifestData(manifest)->pgVersion, manifestData(manifest)->pgCatalogVersion);
-            RegExp *const tablespaceRegExp = regExpNew(
-                strNewFmt("^" MANIFEST_TARGET_PGTBLSPC "/[0-9]+/%s/[0-9]+/" PG_FILE_PGVERSION, strZ(tablespaceId)));
 
             // Generate a list of databases in base or in a tablespace and get all standard system databases, even in cases where
             // users have recreated them
@@ -1394,11 +1388,12 @@ restoreSelectiveExpression(const Manifest *const manifest)
 
             for (unsigned int fileIdx = 0; fileIdx < manifestFileTotal(manifest); fileIdx++)
             {
-                const String *const fileName = manifestFileNameGet(manifest, fileIdx);
+                const ManifestFile file = manifestFileUnpack(manifest, manifestFilePackGet(manifest, fileIdx));
 
-                if (regExpMatch(baseRegExp, fileName) || regExpMatch(tablespaceRegExp, fileName))
+                // Every database path contains a PG_VERSION file
+                if (file.dbId != 0 && strcmp(strBaseZ(file.name), PG_FILE_PGVERSION) == 0)
                 {
-                    const String *const dbId = strBase(strPath(fileName));
+                    const String *const dbId = strNewFmt("%u", file.dbId);
 
                     // In the highly unlikely event that a system database was somehow added after the backup began, it will only be
                     // found in the file list and not the manifest db section, so add it to the system database list
@@ -1617,6 +1612,10 @@ restoreRecoveryOption(const unsigned int pgVersion)
             kvPut(optionReplace, VARSTRDEF(CFGOPT_PROCESS_MAX), NULL);
             kvPut(optionReplace, VARSTRDEF(CFGOPT_CMD), NULL);
 
+            // Let archive-get know where recovery will stop so it does not queue WAL that will not be replayed
+            if (cfgOptionStrId(cfgOptType) == CFGOPTVAL_TYPE_LSN)
+                kvPut(optionReplace, VARSTRDEF(CFGOPT_ARCHIVE_GET_QUEUE_TARGET), VARSTR(cfgOptionStr(cfgOptTarget)));
+
             kvPut(
                 result, VARSTRZ(RESTORE_COMMAND),
                 VARSTR(
@@ -2070,40 +2069,37 @@ restoreProcessQueue(const Manifest *const manifest, List **const queueList)
 
         // Now put all files into the processing queues
         const bool isFilterSet = cfgOptionTest(cfgOptFilter);
+        unsigned int targetIdx = 0;
+
         for (unsigned int fileIdx = 0; fileIdx < manifestFileTotal(manifest); fileIdx++)
         {
             const ManifestFilePack *const filePack = manifestFilePackGet(manifest, fileIdx);
             const ManifestFile file = manifestFileUnpack(manifest, filePack);
 
-            if (isFilterSet)
+            // Skip relations that are not needed. Relations in the global path are always needed.
+            if (isFilterSet && file.dbId != 0 && file.relFileNode != 0 &&
+                !isRelationNeeded(file.dbId, file.tablespaceId, file.relFileNode))
             {
-                Oid dbNode, relNode;
-                Oid spcNode = DEFAULTTABLESPACE_OID;
-                if (
-                    // If this file is located in the default tablespace
-                    sscanf(strZ(file.name), MANIFEST_TARGET_PGDATA "/" PG_PATH_BASE "/%u/%u", &dbNode, &relNode) == 2 ||
-                    // If this file is located in a non-built-in tablespace
-                    sscanf(strZ(file.name), MANIFEST_TARGET_PGTBLSPC "/%u/%*[^/]/%u/%u", &spcNode, &dbNode, &relNode) == 3)
-                {
-                    if (!isRelationNeeded(dbNode, spcNode, relNode))
-                        continue;
-                }
+                continue;
             }
 
-            // Find the target that contains this file
-            unsigned int targetIdx = 0;
-
-            do
+            // Find the target that contains this file. Files are sorted so the target is usually the same as the prior file.
+            if (!strBeginsWith(file.name, strLstGet(targetList, targetIdx)))
             {
-                // A target should always be found
-                CHECK(FormatError, targetIdx < strLstSize(targetList), "backup target not found");
+                targetIdx = 0;
 
-                if (strBeginsWith(file.name, strLstGet(targetList, targetIdx)))
-                    break;
+                do
+                {
+                    // A target should always be found
+                    CHECK(FormatError, targetIdx < strLstSize(targetList), "backup target not found");
 
-                targetIdx++;
+                    if (strBeginsWith(file.name, strLstGet(targetList, targetIdx)))
+                        break;
+
+                    targetIdx++;
+                }
+                while (1);
             }
-            while (1);
 
             // Add file to queue
             lstAdd(*(List **)lstGet(*queueList, targetIdx), &filePack);
@@ -2290,6 +2286,7 @@ typedef struct RestoreJobData
     Manifest *manifest;                                             // Backup manifest
     List *queueList;                                                // List of processing queues
     RegExp *zeroExp;                                                // Identify files that should be sparse zeroed
+    CipherType cipherType;                                          // Cipher type used to encrypt files in the backup
     const String *cipherSubPass;                                    // Passphrase used to decrypt files in the backup
     const String *rootReplaceUser;                                  // User to replace invalid users when root
     const String *rootReplaceGroup;                                 // Group to replace invalid group when root
@@ -2384,6 +2381,7 @@ restoreJobCallback(void *const data, const unsigned int clientIdx)
                     pckWriteBoolP(param, cfgOptionBool(cfgOptDelta));
                     pckWriteBoolP(param, cfgOptionBool(cfgOptDelta) && cfgOptionBool(cfgOptForce));
                     pckWriteBoolP(param, file.bundleId != 0 && manifestData(jobData->manifest)->bundleRaw);
+                    pckWriteU64P(param, jobData->cipherType);
                     pckWriteStrP(param, jobData->cipherSubPass);
                     pckWriteStrLstP(param, manifestReferenceList(jobData->manifest));
 
@@ -2509,8 +2507,9 @@ cmdRestore(void)
         // Validate manifest. Don't use strict mode because we'd rather ignore problems that won't affect a restore.
         manifestValidate(jobData.manifest, false);
 
-        // Get the cipher subpass used to decrypt files in the backup
+        // Get the cipher subpass and type used to decrypt files in the backup
         jobData.cipherSubPass = manifestCipherSubPass(jobData.manifest);
+        jobData.cipherType = manifestCipherType(jobData.manifest);
 
         // Validate the manifest
         restoreManifestValidate(jobData.manifest, backupData.backupSet);
@@ -2555,8 +2554,9 @@ cmdRestore(void)
         manifestSave(jobData.manifest, storageWriteIo(storageNewWriteP(storagePgWrite(), BACKUP_MANIFEST_FILE_STR)));
 
         // Create the parallel executor
-        ProtocolParallel *const parallelExec = protocolParallelNew(
-            cfgOptionUInt64(cfgOptProtocolTimeout) / 2, restoreJobCallback, &jobData);
+        ProtocolParallel *const parallelExec = protocolParallelNewP(
+            cfgOptionUInt64(cfgOptProtocolTimeout) / 2, restoreJobCallback, &jobData,
+            .jobMax = cfgOptionUInt(cfgOptProcessJobMax));
 
         for (unsigned int processIdx = 1; processIdx <= cfgOptionUInt(cfgOptProcessMax); processIdx++)
             protocolParallelClientAdd(parallelExec, protocolLocalGet(protocolStorageTypeRepo, 0, processIdx));
@@ -3,11 +3,14 @@ Stanza Commands Handler
 ***********************************************************************************************************************************/
 #include "build.auto.h"
 
+#include "command/archive/common.h"
 #include "command/check/common.h"
+#include "command/stanza/common.h"
 #include "common/debug.h"
 #include "common/log.h"
 #include "config/config.h"
 #include "db/helper.h"
+#include "info/infoArchive.h"
 #include "info/infoPg.h"
 #include "postgres/interface.h"
 #include "postgres/version.h"
@@ -63,3 +66,170 @@ pgValidate(void)
 
     FUNCTION_TEST_RETURN_TYPE(PgControl, result);
 }
+
+/***********************************************************************************************************************************
+Train the archive compression dictionary from a sample of the most recently modified WAL segments. A single segment only covers a
+short slice of the workload (e.g. one bulk load or vacuum) so the sample is spread across several segments. The total sample size is
+capped so large segment sizes do not require a large amount of memory. Pages are used as samples since WAL is written in pages and
+records of the same type share structure.
+***********************************************************************************************************************************/
+// Max segments to sample and max total size of the sample
+#define STANZA_ARCHIVE_DICT_SEGMENT_MAX                             8
+#define STANZA_ARCHIVE_DICT_SAMPLE_SIZE_MAX                         (16 * 1024 * 1024)
+
+// Segment that can be sampled
+typedef struct StanzaArchiveDictSegment
+{
+    time_t timeModified;                                            // Time segment was last modified
+    const String *name;                                             // Segment name
+} StanzaArchiveDictSegment;
+
+// Comparator to order segments by modification time
+static int
+stanzaArchiveDictSegmentComparator(const void *const item1, const void *const item2)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, item1);
+        FUNCTION_TEST_PARAM_P(VOID, item2);
+    FUNCTION_TEST_END();
+
+    ASSERT(item1 != NULL);
+    ASSERT(item2 != NULL);
+
+    const time_t time1 = ((const StanzaArchiveDictSegment *)item1)->timeModified;
+    const time_t time2 = ((const StanzaArchiveDictSegment *)item2)->timeModified;
+
+    FUNCTION_TEST_RETURN(INT, time1 < time2 ? -1 : time1 > time2 ? 1 : 0);
+}
+
+static Buffer *
+stanzaArchiveDictTrain(const PgControl *const pgControl)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM_P(VOID, pgControl);
+    FUNCTION_LOG_END();
+
+    ASSERT(pgControl != NULL);
+
+    Buffer *result = NULL;
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        // Find complete WAL segments
+        const String *const walPath = pgWalPath(pgControl->version);
+        StorageIterator *const storageItr = storageNewItrP(
+            storagePg(), walPath, .expression = WAL_SEGMENT_REGEXP_STR, .level = storageInfoLevelBasic);
+        List *const segmentList = lstNewP(sizeof(StanzaArchiveDictSegment), .comparator = stanzaArchiveDictSegmentComparator);
+
+        while (storageItrMore(storageItr))
+        {
+            const StorageInfo info = storageItrNext(storageItr);
+
+            if (info.type == storageTypeFile && info.size == pgControl->walSegmentSize)
+            {
+                lstAdd(
+                    segmentList, &(StanzaArchiveDictSegment){.timeModified = info.timeModified, .name = strDup(info.name)});
+            }
+        }
+
+        if (lstEmpty(segmentList))
+        {
+            LOG_WARN_FMT(
+                "unable to create archive dictionary: no WAL segment found in '%s'",
+                strZ(storagePathP(storagePg(), walPath)));
+        }
+        // Else train the dictionary
+        else
+        {
+            // Sample the most recently modified segments, reading the same number of whole pages from the start of each
+            const unsigned int segmentTotal =
+                lstSize(segmentList) < STANZA_ARCHIVE_DICT_SEGMENT_MAX ? lstSize(segmentList) : STANZA_ARCHIVE_DICT_SEGMENT_MAX;
+            uint64_t segmentSampleSize = STANZA_ARCHIVE_DICT_SAMPLE_SIZE_MAX / segmentTotal;
+
+            if (segmentSampleSize > pgControl->walSegmentSize)
+                segmentSampleSize = pgControl->walSegmentSize;
+
+            segmentSampleSize -= segmentSampleSize % pgControl->walPageSize;
+
+            Buffer *const walBuffer = bufNew((size_t)(segmentSampleSize * segmentTotal));
+
+            lstSort(segmentList, sortOrderDesc);
+
+            for (unsigned int segmentIdx = 0; segmentIdx < segmentTotal; segmentIdx++)
+            {
+                const StanzaArchiveDictSegment *const segment = lstGet(segmentList, segmentIdx);
+
+                bufCat(
+                    walBuffer,
+                    storageGetP(
+                        storageNewReadP(
+                            storagePg(), strNewFmt("%s/%s", strZ(walPath), strZ(segment->name)),
+                            .limit = VARUINT64(segmentSampleSize))));
+            }
+
+            result = compressDictTrain(compressTypeZst, walBuffer, pgControl->walPageSize);
+
+            if (result == NULL)
+            {
+                LOG_WARN_FMT(
+                    "unable to create archive dictionary: %u WAL segment(s) do not have enough content to train a dictionary",
+                    segmentTotal);
+            }
+            else
+                result = bufMove(result, memContextPrior());
+        }
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_LOG_RETURN(BUFFER, result);
+}
+
+/**********************************************************************************************************************************/
+FN_EXTERN void
+stanzaArchiveDictCreate(const PgControl *const pgControl)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM_P(VOID, pgControl);
+    FUNCTION_LOG_END();
+
+    ASSERT(pgControl != NULL);
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        // The dictionary is trained once and stored on every repo that needs it
+        const Buffer *dict = NULL;
+        bool dictTrained = false;
+
+        for (unsigned int repoIdx = 0; repoIdx < cfgOptionGroupIdxTotal(cfgOptGrpRepo); repoIdx++)
+        {
+            const CipherType cipherType = cfgOptionIdxStrId(cfgOptRepoCipherType, repoIdx);
+            const InfoArchive *const infoArchive = infoArchiveLoadFile(
+                storageRepoIdx(repoIdx), INFO_ARCHIVE_PATH_FILE_STR, cipherType,
+                cfgOptionIdxStrNull(cfgOptRepoCipherPass, repoIdx));
+            const String *const archiveId = infoArchiveId(infoArchive);
+            const String *const cipherPass = infoArchiveCipherPass(infoArchive);
+
+            // The dictionary is never replaced since segments already in the archive may have been compressed with it
+            if (archiveDictGet(repoIdx, archiveId, cipherType, cipherPass) == NULL)
+            {
+                if (!dictTrained)
+                {
+                    dict = stanzaArchiveDictTrain(pgControl);
+                    dictTrained = true;
+                }
+
+                if (dict != NULL)
+                {
+                    archiveDictPut(repoIdx, archiveId, cipherType, cipherPass, dict);
+
+                    LOG_INFO_FMT(
+                        "archive dictionary created for archive id '%s' on %s", strZ(archiveId),
+                        cfgOptionGroupName(cfgOptGrpRepo, repoIdx));
+                }
+            }
+        }
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_LOG_RETURN_VOID();
+}
@@ -16,4 +16,8 @@ FN_EXTERN String *cipherPassGen(CipherType cipherType);
 // Validate and return database information
 FN_EXTERN PgControl pgValidate(void);
 
+// Create the archive compression dictionary for the current archive id on each repo that does not already have one. The dictionary
+// is trained from the most recently modified WAL segment in the PostgreSQL WAL directory.
+FN_EXTERN void stanzaArchiveDictCreate(const PgControl *pgControl);
+
 #endif
@@ -152,6 +152,10 @@ cmdStanzaCreate(void)
                     cfgOptionGroupName(cfgOptGrpRepo, repoIdx));
             }
         }
+
+        // Create the archive compression dictionary
+        if (cfgOptionBool(cfgOptArchiveDict))
+            stanzaArchiveDictCreate(&pgControl);
     }
     MEM_CONTEXT_TEMP_END();
 
@@ -104,6 +104,10 @@ cmdStanzaUpgrade(void)
                     cfgOptionGroupName(cfgOptGrpRepo, repoIdx));
             }
         }
+
+        // Create the archive compression dictionary
+        if (cfgOptionBool(cfgOptArchiveDict))
+            stanzaArchiveDictCreate(&pgControl);
     }
     MEM_CONTEXT_TEMP_END();
 
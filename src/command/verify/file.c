@@ -3,6 +3,7 @@ Verify File
 ***********************************************************************************************************************************/
 #include "build.auto.h"
 
+#include "command/archive/common.h"
 #include "command/verify/file.h"
 #include "common/crypto/cipherBlock.h"
 #include "common/crypto/hash.h"
@@ -11,14 +12,98 @@ Verify File
 #include "common/io/filter/sink.h"
 #include "common/io/filter/size.h"
 #include "common/io/io.h"
+#include "common/io/limitRead.h"
 #include "common/log.h"
+#include "config/config.h"
 #include "storage/helper.h"
 
+/***********************************************************************************************************************************
+Add the filters required to verify a file to a read
+***********************************************************************************************************************************/
+static void
+verifyFileFilterAdd(
+    IoRead *const read, const CompressType compressType, const CipherType cipherType, const String *const cipherPass,
+    const String *const archiveId)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(IO_READ, read);
+        FUNCTION_TEST_PARAM(ENUM, compressType);
+        FUNCTION_TEST_PARAM(STRING_ID, cipherType);
+        FUNCTION_TEST_PARAM(STRING, cipherPass);
+        FUNCTION_TEST_PARAM(STRING, archiveId);
+    FUNCTION_TEST_END();
+
+    ASSERT(read != NULL);
+
+    IoFilterGroup *const filterGroup = ioReadFilterGroup(read);
+
+    // Add decryption filter
+    if (cipherPass != NULL)
+        ioFilterGroupAdd(filterGroup, cipherBlockNewP(cipherModeDecrypt, cipherType, BUFSTR(cipherPass)));
+
+    // Add decompression filter
+    if (compressType != compressTypeNone)
+    {
+        // Get the archive dictionary in case the WAL segment was compressed with it. Only zst supports dictionaries.
+        const Buffer *const dict =
+            archiveId != NULL && compressType == compressTypeZst ?
+                archiveDictGet(cfgOptionGroupIdxDefault(cfgOptGrpRepo), archiveId, cipherType, cipherPass) :
+                NULL;
+
+        ioFilterGroupAdd(filterGroup, decompressFilterP(compressType, .dict = dict));
+    }
+
+    // Add sha1 filter
+    ioFilterGroupAdd(filterGroup, cryptoHashNew(hashTypeSha1));
+
+    // Add size filter
+    ioFilterGroupAdd(filterGroup, ioSizeNew());
+
+    // Add IoSink so the file data is not transmitted from the remote
+    ioFilterGroupAdd(filterGroup, ioSinkNew());
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Check the checksum and size of a file that has been read
+***********************************************************************************************************************************/
+static VerifyResult
+verifyFileFilterResult(IoRead *const read, const Buffer *const fileChecksum, const uint64_t fileSize)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(IO_READ, read);
+        FUNCTION_TEST_PARAM(BUFFER, fileChecksum);
+        FUNCTION_TEST_PARAM(UINT64, fileSize);
+    FUNCTION_TEST_END();
+
+    ASSERT(read != NULL);
+    ASSERT(fileChecksum != NULL);
+
+    VerifyResult result = verifyOk;
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        // Validate checksum
+        if (!bufEq(fileChecksum, pckReadBinP(ioFilterGroupResultP(ioReadFilterGroup(read), CRYPTO_HASH_FILTER_TYPE))))
+        {
+            result = verifyChecksumMismatch;
+        }
+        // If the size can be checked, do so
+        else if (fileSize != pckReadU64P(ioFilterGroupResultP(ioReadFilterGroup(read), SIZE_FILTER_TYPE)))
+            result = verifySizeInvalid;
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_TEST_RETURN(ENUM, result);
+}
+
 /**********************************************************************************************************************************/
 FN_EXTERN VerifyResult
 verifyFile(
     const String *const filePathName, const uint64_t offset, const Variant *const limit, const CompressType compressType,
-    const Buffer *const fileChecksum, const uint64_t fileSize, const String *const cipherPass)
+    const Buffer *const fileChecksum, const uint64_t fileSize, const CipherType cipherType, const String *const cipherPass,
+    const String *const archiveId)
 {
     FUNCTION_LOG_BEGIN(logLevelDebug);
         FUNCTION_LOG_PARAM(STRING, filePathName);                   // Fully qualified file name
@@ -27,12 +112,15 @@ verifyFile(
         FUNCTION_LOG_PARAM(ENUM, compressType);                     // Compression type
         FUNCTION_LOG_PARAM(BUFFER, fileChecksum);                   // Checksum for the file
         FUNCTION_LOG_PARAM(UINT64, fileSize);                       // Size of file
+        FUNCTION_LOG_PARAM(STRING_ID, cipherType);                  // Cipher type used to encrypt the repo file
         FUNCTION_TEST_PARAM(STRING, cipherPass);                    // Password to access the repo file if encrypted
+        FUNCTION_LOG_PARAM(STRING, archiveId);                      // Archive id when the file is a WAL segment
     FUNCTION_LOG_END();
 
     ASSERT(filePathName != NULL);
     ASSERT(fileChecksum != NULL);
     ASSERT(limit == NULL || varType(limit) == varTypeUInt64);
+    ASSERT((cipherType == cipherTypeNone && cipherPass == NULL) || (cipherType != cipherTypeNone && cipherPass != NULL));
 
     // Is the file valid?
     VerifyResult result = verifyOk;
@@ -42,41 +130,131 @@ verifyFile(
         // Prepare the file for reading
         IoRead *const read = storageReadIo(
             storageNewReadP(storageRepo(), filePathName, .ignoreMissing = true, .offset = offset, .limit = limit));
-        IoFilterGroup *const filterGroup = ioReadFilterGroup(read);
 
-        // Add decryption filter
-        if (cipherPass != NULL)
-            ioFilterGroupAdd(filterGroup, cipherBlockNewP(cipherModeDecrypt, cipherTypeAes256Cbc, BUFSTR(cipherPass)));
+        verifyFileFilterAdd(read, compressType, cipherType, cipherPass, archiveId);
 
-        // Add decompression filter
-        if (compressType != compressTypeNone)
-            ioFilterGroupAdd(filterGroup, decompressFilterP(compressType));
+        // If the file exists check the checksum/size
+        if (ioReadDrain(read))
+            result = verifyFileFilterResult(read, fileChecksum, fileSize);
+        else
+            result = verifyFileMissing;
+    }
+    MEM_CONTEXT_TEMP_END();
 
-        // Add sha1 filter
-        ioFilterGroupAdd(filterGroup, cryptoHashNew(hashTypeSha1));
+    FUNCTION_LOG_RETURN_STRUCT(result);
+}
 
-        // Add size filter
-        ioFilterGroupAdd(filterGroup, ioSizeNew());
+/**********************************************************************************************************************************/
+FN_EXTERN List *
+verifyBundle(const String *const bundlePathName, const List *const fileList)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(STRING, bundlePathName);                 // Fully qualified bundle name
+        FUNCTION_LOG_PARAM(LIST, fileList);                         // Files to verify in the bundle
+    FUNCTION_LOG_END();
 
-        // Add IoSink so the file data is not transmitted from the remote
-        ioFilterGroupAdd(filterGroup, ioSinkNew());
+    ASSERT(bundlePathName != NULL);
+    ASSERT(fileList != NULL);
 
-        // If the file exists check the checksum/size
-        if (ioReadDrain(read))
+    List *const result = lstNewP(sizeof(VerifyBundleResult));
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        StorageRead *bundleRead = NULL;
+        uint64_t bundleLimit = 0;
+        bool bundleExists = false;
+
+        for (unsigned int fileIdx = 0; fileIdx < lstSize(fileList); fileIdx++)
         {
-            // Validate checksum
-            if (!bufEq(fileChecksum, pckReadBinP(ioFilterGroupResultP(filterGroup, CRYPTO_HASH_FILTER_TYPE))))
+            // Use a per-file mem context to reduce memory usage
+            MEM_CONTEXT_TEMP_BEGIN()
             {
-                result = verifyChecksumMismatch;
+                const VerifyBundleFile *const file = lstGet(fileList, fileIdx);
+                VerifyBundleResult fileResult = {.result = verifyOk};
+                bool fileError = false;
+
+                ASSERT(file->checksum != NULL);
+                ASSERT(file->sizeRepo != 0);
+                ASSERT(
+                    (file->cipherType == cipherTypeNone && file->cipherPass == NULL) ||
+                    (file->cipherType != cipherTypeNone && file->cipherPass != NULL));
+
+                // If no bundle read is open then open one that includes this file and all the files stored contiguously after it
+                if (bundleLimit == 0)
+                {
+                    bundleLimit = file->sizeRepo;
+
+                    for (unsigned int fileNextIdx = fileIdx + 1; fileNextIdx < lstSize(fileList); fileNextIdx++)
+                    {
+                        const VerifyBundleFile *const fileNext = lstGet(fileList, fileNextIdx);
+
+                        // Break if the offset is not the first file's offset + size of all additional files so far
+                        if (fileNext->offset != file->offset + bundleLimit)
+                            break;
+
+                        bundleLimit += fileNext->sizeRepo;
+                    }
+
+                    // Create and open the bundle read. It needs to be created in the prior context because it will live longer
+                    // than a single loop when more than one file is being read.
+                    MEM_CONTEXT_PRIOR_BEGIN()
+                    {
+                        bundleRead = storageNewReadP(
+                            storageRepo(), bundlePathName, .ignoreMissing = true, .offset = file->offset,
+                            .limit = VARUINT64(bundleLimit));
+                        bundleExists = ioReadOpen(storageReadIo(bundleRead));
+                    }
+                    MEM_CONTEXT_PRIOR_END();
+                }
+
+                // If the bundle exists then read the file from the bundle and check the checksum/size. An error, e.g. a
+                // decompression or decryption error, is recorded for this file only so the other files in the bundle are still
+                // verified.
+                if (bundleExists)
+                {
+                    TRY_BEGIN()
+                    {
+                        IoRead *const read = ioLimitReadNew(storageReadIo(bundleRead), file->sizeRepo);
+
+                        verifyFileFilterAdd(read, file->compressType, file->cipherType, file->cipherPass, NULL);
+                        ioReadDrain(read);
+
+                        fileResult.result = verifyFileFilterResult(read, file->checksum, file->size);
+                    }
+                    CATCH_ANY()
+                    {
+                        fileResult.result = verifyOtherError;
+                        fileResult.errorCode = errorCode();
+                        fileError = true;
+
+                        MEM_CONTEXT_BEGIN(lstMemContext(result))
+                        {
+                            fileResult.errorMessage = strNewZ(errorMessage());
+                        }
+                        MEM_CONTEXT_END();
+                    }
+                    TRY_END();
+                }
+                else
+                    fileResult.result = verifyFileMissing;
+
+                lstAdd(result, &fileResult);
+
+                // Free the bundle read when all the files it includes have been read. After an error the position of the read is
+                // unknown so it is also freed and a new read is opened at the offset of the next file.
+                bundleLimit -= file->sizeRepo;
+
+                if (bundleLimit == 0 || fileError)
+                {
+                    storageReadFree(bundleRead);
+                    bundleRead = NULL;
+                    bundleLimit = 0;
+                }
             }
-            // If the size can be checked, do so
-            else if (fileSize != pckReadU64P(ioFilterGroupResultP(ioReadFilterGroup(read), SIZE_FILTER_TYPE)))
-                result = verifySizeInvalid;
+            MEM_CONTEXT_TEMP_END();
         }
-        else
-            result = verifyFileMissing;
     }
     MEM_CONTEXT_TEMP_END();
 
-    FUNCTION_LOG_RETURN_STRUCT(result);
+    FUNCTION_LOG_RETURN(LIST, result);
 }
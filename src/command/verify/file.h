@@ -6,6 +6,7 @@ Verify File
 
 #include "common/compress/helper.h"
 #include "common/crypto/common.h"
+#include "common/type/list.h"
 
 /***********************************************************************************************************************************
 File result
@@ -19,12 +20,41 @@ typedef enum
     verifyOtherError,
 } VerifyResult;
 
+/***********************************************************************************************************************************
+File stored in a bundle
+***********************************************************************************************************************************/
+typedef struct VerifyBundleFile
+{
+    uint64_t offset;                                                // Offset of the file in the bundle
+    uint64_t sizeRepo;                                              // Size of the file in the bundle
+    CompressType compressType;                                      // Compression type
+    const Buffer *checksum;                                         // Checksum for the file
+    uint64_t size;                                                  // Size of the file
+    CipherType cipherType;                                          // Cipher type used to encrypt the file
+    const String *cipherPass;                                       // Password to access the file if encrypted
+} VerifyBundleFile;
+
+/***********************************************************************************************************************************
+Result for a file stored in a bundle
+***********************************************************************************************************************************/
+typedef struct VerifyBundleResult
+{
+    VerifyResult result;                                            // Result for the file
+    int errorCode;                                                  // Error code when the result is verifyOtherError
+    const String *errorMessage;                                     // Error message when the result is verifyOtherError
+} VerifyBundleResult;
+
 /***********************************************************************************************************************************
 Functions
 ***********************************************************************************************************************************/
-// Verify a file in the pgBackRest repository
+// Verify a file in the pgBackRest repository. The archive id is required for WAL segments so the archive dictionary can be loaded.
 FN_EXTERN VerifyResult verifyFile(
     const String *filePathName, uint64_t offset, const Variant *limit, CompressType compressType, const Buffer *fileChecksum,
-    uint64_t fileSize, const String *cipherPass);
+    uint64_t fileSize, CipherType cipherType, const String *cipherPass, const String *archiveId);
+
+// Verify files stored in a bundle. Files stored contiguously in the bundle are verified with a single read rather than a read per
+// file. An error reading a file, e.g. a decompression or decryption error, is returned as verifyOtherError for that file only.
+// Returns a list of VerifyBundleResult in the order of the file list.
+FN_EXTERN List *verifyBundle(const String *bundlePathName, const List *fileList);
 
 #endif
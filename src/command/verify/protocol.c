@@ -41,9 +41,12 @@ verifyFileProtocol(PackRead *const param, ProtocolServer *const server)
         const CompressType compressType = (CompressType)pckReadU32P(param);
         const Buffer *const fileChecksum = pckReadBinP(param);
         const uint64_t fileSize = pckReadU64P(param);
+        const CipherType cipherType = (CipherType)pckReadU64P(param);
         const String *const cipherPass = pckReadStrP(param);
+        const String *const archiveId = pckReadStrP(param);
 
-        const VerifyResult result = verifyFile(filePathName, offset, limit, compressType, fileChecksum, fileSize, cipherPass);
+        const VerifyResult result = verifyFile(
+            filePathName, offset, limit, compressType, fileChecksum, fileSize, cipherType, cipherPass, archiveId);
 
         // Return result
         protocolServerDataPut(server, pckWriteU32P(protocolPackNew(), result));
@@ -53,3 +56,68 @@ verifyFileProtocol(PackRead *const param, ProtocolServer *const server)
 
     FUNCTION_LOG_RETURN_VOID();
 }
+
+/**********************************************************************************************************************************/
+FN_EXTERN void
+verifyBundleProtocol(PackRead *const param, ProtocolServer *const server)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(PACK_READ, param);
+        FUNCTION_LOG_PARAM(PROTOCOL_SERVER, server);
+    FUNCTION_LOG_END();
+
+    ASSERT(param != NULL);
+    ASSERT(server != NULL);
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        // Verify bundle
+        const String *const bundlePathName = pckReadStrP(param);
+        List *const fileList = lstNewP(sizeof(VerifyBundleFile));
+
+        pckReadArrayBeginP(param);
+
+        while (!pckReadNullP(param))
+        {
+            pckReadObjBeginP(param);
+
+            VerifyBundleFile file = {.offset = pckReadU64P(param)};
+            file.sizeRepo = pckReadU64P(param);
+            file.compressType = (CompressType)pckReadU32P(param);
+            file.checksum = pckReadBinP(param);
+            file.size = pckReadU64P(param);
+            file.cipherType = (CipherType)pckReadU64P(param);
+            file.cipherPass = pckReadStrP(param);
+
+            lstAdd(fileList, &file);
+
+            pckReadObjEndP(param);
+        }
+
+        pckReadArrayEndP(param);
+
+        const List *const result = verifyBundle(bundlePathName, fileList);
+
+        // Return a result for each file in the order of the file list. An error code and message follow each verifyOtherError.
+        PackWrite *const resultPack = protocolPackNew();
+
+        for (unsigned int resultIdx = 0; resultIdx < lstSize(result); resultIdx++)
+        {
+            const VerifyBundleResult *const fileResult = lstGet(result, resultIdx);
+
+            pckWriteU32P(resultPack, fileResult->result, .defaultWrite = true);
+
+            if (fileResult->result == verifyOtherError)
+            {
+                pckWriteI32P(resultPack, fileResult->errorCode);
+                pckWriteStrP(resultPack, fileResult->errorMessage);
+            }
+        }
+
+        protocolServerDataPut(server, resultPack);
+        protocolServerDataEndPut(server);
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_LOG_RETURN_VOID();
+}
@@ -9,6 +9,7 @@ Verify contents of the repository.
 #include <string.h>
 #include <unistd.h>
 
+#include "command/archive/bundle.h"
 #include "command/archive/common.h"
 #include "command/check/common.h"
 #include "command/verify/file.h"
@@ -116,9 +117,12 @@ typedef struct VerifyJobData
     StringList *archiveIdList;                                      // List of archive ids to verify
     StringList *walPathList;                                        // WAL path list for a single archive id
     StringList *walFileList;                                        // WAL file list for a single WAL path
+    List *walBundleFileList;                                        // WAL files stored in bundles for a single WAL path
     StringList *backupList;                                         // List of backups to verify
     Manifest *manifest;                                             // Manifest contents with list of files to verify
     unsigned int manifestFileIdx;                                   // Index of the file within the manifest file list to process
+    List *bundleFileList;                                           // Files stored in bundles for the manifest being processed
+    List *bundleJobList;                                            // Bundles to verify once the manifest has been processed
     String *currentBackup;                                          // In progress backup, if any
     const InfoPg *pgHistory;                                        // Database history list
     bool backupProcessing;                                          // Are we processing WAL or are we processing backups
@@ -130,6 +134,22 @@ typedef struct VerifyJobData
     List *backupResultList;                                         // Backup results
 } VerifyJobData;
 
+// File stored in a bundle to be verified with the other files in the bundle
+typedef struct VerifyBundleJobFile
+{
+    String *bundlePathName;                                         // Repo path/name of the bundle
+    VerifyBundleFile file;                                          // File to verify
+    String *key;                                                    // Job key for the file
+} VerifyBundleJobFile;
+
+// Bundle to verify with a single job
+typedef struct VerifyBundleJob
+{
+    uint64_t size;                                                  // Size of the files to verify in the bundle
+    unsigned int fileIdx;                                           // Index of the first file in the bundle file list
+    unsigned int fileTotal;                                         // Total files to verify in the bundle
+} VerifyBundleJob;
+
 /***********************************************************************************************************************************
 Helper function to add a file to an invalid file list
 ***********************************************************************************************************************************/
@@ -164,17 +184,17 @@ verifyInvalidFileAdd(List *const invalidFileList, const VerifyResult reason, con
 Load a file into memory
 ***********************************************************************************************************************************/
 static StorageRead *
-verifyFileLoad(const String *const pathFileName, const String *const cipherPass)
+verifyFileLoadRead(
+    StorageRead *const result, const CompressType compressType, const String *const cipherPass, const Buffer *const dict)
 {
     FUNCTION_TEST_BEGIN();
-        FUNCTION_TEST_PARAM(STRING, pathFileName);                  // Fully qualified path/file name
+        FUNCTION_TEST_PARAM(STORAGE_READ, result);                  // File to read
+        FUNCTION_TEST_PARAM(ENUM, compressType);                    // Compress type of the file
         FUNCTION_TEST_PARAM(STRING, cipherPass);                    // Password to open file if encrypted
+        FUNCTION_TEST_PARAM(BUFFER, dict);                          // Dictionary the file may be compressed with
     FUNCTION_TEST_END();
 
-    ASSERT(pathFileName != NULL);
-
-    // Read the file and error if missing
-    StorageRead *const result = storageNewReadP(storageRepo(), pathFileName);
+    ASSERT(result != NULL);
 
     // *read points to a location within result so update result with contents based on necessary filters
     IoRead *const read = storageReadIo(result);
@@ -184,12 +204,29 @@ verifyFileLoad(const String *const pathFileName, const String *const cipherPass)
     ioFilterGroupAdd(ioReadFilterGroup(read), cryptoHashNew(hashTypeSha1));
 
     // If the file is compressed, add a decompression filter
-    if (compressTypeFromName(pathFileName) != compressTypeNone)
-        ioFilterGroupAdd(ioReadFilterGroup(read), decompressFilterP(compressTypeFromName(pathFileName)));
+    if (compressType != compressTypeNone)
+        ioFilterGroupAdd(ioReadFilterGroup(read), decompressFilterP(compressType, .dict = dict));
 
     FUNCTION_TEST_RETURN(STORAGE_READ, result);
 }
 
+static StorageRead *
+verifyFileLoad(const String *const pathFileName, const String *const cipherPass, const Buffer *const dict)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(STRING, pathFileName);                  // Fully qualified path/file name
+        FUNCTION_TEST_PARAM(STRING, cipherPass);                    // Password to open file if encrypted
+        FUNCTION_TEST_PARAM(BUFFER, dict);                          // Dictionary the file may be compressed with
+    FUNCTION_TEST_END();
+
+    ASSERT(pathFileName != NULL);
+
+    // Read the file and error if missing
+    FUNCTION_TEST_RETURN(
+        STORAGE_READ,
+        verifyFileLoadRead(storageNewReadP(storageRepo(), pathFileName), compressTypeFromName(pathFileName), cipherPass, dict));
+}
+
 /***********************************************************************************************************************************
 Get status of info files in the repository
 ***********************************************************************************************************************************/
@@ -212,7 +249,7 @@ verifyInfoFile(const String *const pathFileName, const bool keepFile, const Stri
     {
         TRY_BEGIN()
         {
-            IoRead *const infoRead = storageReadIo(verifyFileLoad(pathFileName, cipherPass));
+            IoRead *const infoRead = storageReadIo(verifyFileLoad(pathFileName, cipherPass, NULL));
 
             // If directed to keep the loaded file in memory, then move the file into the result, else drain the io and close it
             if (keepFile)
@@ -702,17 +739,35 @@ verifyArchive(VerifyJobData *const jobData)
                     // Get the WAL files for the first item in the WAL paths list and initialize WAL info and ranges
                     if (strLstEmpty(jobData->walFileList))
                     {
-                        // Free the old WAL file list
+                        // Free the old WAL file lists
                         strLstFree(jobData->walFileList);
+                        lstFree(jobData->walBundleFileList);
 
-                        // Get WAL file list
+                        // Get WAL file list. Files stored in bundles are listed with the names they would have outside the bundle
+                        // so they are verified like any other WAL file.
                         const String *const walFilePath = strNewFmt(
                             STORAGE_REPO_ARCHIVE "/%s/%s", strZ(archiveResult->archiveId), strZ(walPath));
+                        const StringList *const fileList = storageListP(
+                            storageRepo(), walFilePath, .expression = WAL_SEGMENT_BUNDLE_FILE_REGEXP_STR);
 
                         MEM_CONTEXT_BEGIN(jobData->memContext)
                         {
-                            jobData->walFileList = strLstSort(
-                                storageListP(storageRepo(), walFilePath, .expression = WAL_SEGMENT_FILE_REGEXP_STR), sortOrderAsc);
+                            jobData->walFileList = strLstNew();
+                            jobData->walBundleFileList = walBundleList(storageRepo(), walFilePath, fileList);
+
+                            for (unsigned int fileIdx = 0; fileIdx < strLstSize(fileList); fileIdx++)
+                            {
+                                if (!walIsBundle(strLstGet(fileList, fileIdx)))
+                                    strLstAdd(jobData->walFileList, strLstGet(fileList, fileIdx));
+                            }
+
+                            for (unsigned int fileIdx = 0; fileIdx < lstSize(jobData->walBundleFileList); fileIdx++)
+                            {
+                                const WalBundleFile *const file = lstGet(jobData->walBundleFileList, fileIdx);
+                                strLstAdd(jobData->walFileList, file->name);
+                            }
+
+                            strLstSort(jobData->walFileList, sortOrderAsc);
                         }
                         MEM_CONTEXT_END();
 
@@ -720,12 +775,23 @@ verifyArchive(VerifyJobData *const jobData)
                         {
                             if (archiveResult->pgWalInfo.size == 0)
                             {
-                                // Initialize the WAL segment size from the first WAL
-                                StorageRead *const walRead = verifyFileLoad(
-                                    strNewFmt(
-                                        STORAGE_REPO_ARCHIVE "/%s/%s/%s", strZ(archiveResult->archiveId), strZ(walPath),
-                                        strZ(strLstGet(jobData->walFileList, 0))),
-                                    jobData->walCipherPass);
+                                // Initialize the WAL segment size from the first WAL. Get the archive dictionary in case the WAL
+                                // was compressed with it. Only zst supports dictionaries.
+                                const String *const walFile = strLstGet(jobData->walFileList, 0);
+                                const Buffer *const walDict =
+                                    compressTypeFromName(walFile) == compressTypeZst ?
+                                        archiveDictGet(
+                                            cfgOptionGroupIdxDefault(cfgOptGrpRepo), archiveResult->archiveId,
+                                            cfgOptionStrId(cfgOptRepoCipherType), jobData->walCipherPass) :
+                                        NULL;
+                                const WalBundleFile *const walBundleFile = lstFind(jobData->walBundleFileList, &walFile);
+                                StorageRead *const walRead =
+                                    walBundleFile != NULL ?
+                                        verifyFileLoadRead(
+                                            walBundleReadNew(storageRepo(), walFilePath, walBundleFile, false),
+                                            compressTypeFromName(walFile), jobData->walCipherPass, walDict) :
+                                        verifyFileLoad(
+                                            strNewFmt("%s/%s", strZ(walFilePath), strZ(walFile)), jobData->walCipherPass, walDict);
 
                                 const PgWal walInfo = pgWalFromBuffer(
                                     storageGetP(walRead, .exactSize = PG_WAL_HEADER_SIZE), cfgOptionStrNull(cfgOptPgVersionForce));
@@ -752,17 +818,37 @@ verifyArchive(VerifyJobData *const jobData)
                             STORAGE_REPO_ARCHIVE "/%s/%s/%s", strZ(archiveResult->archiveId), strZ(walPath), strZ(fileName));
                         const Buffer *const checksum = bufNewDecode(
                             encodingHex, strSubN(fileName, WAL_SEGMENT_NAME_SIZE + 1, HASH_TYPE_SHA1_SIZE_HEX));
+                        const WalBundleFile *const walBundleFile = lstFind(jobData->walBundleFileList, &fileName);
 
                         // Set up the job
                         ProtocolCommand *const command = protocolCommandNew(PROTOCOL_COMMAND_VERIFY_FILE);
                         PackWrite *const param = protocolCommandParam(command);
 
-                        pckWriteStrP(param, filePathName);
-                        pckWriteBoolP(param, false);
+                        // If the file is stored in a bundle then verify only the part of the bundle that contains the file
+                        if (walBundleFile != NULL)
+                        {
+                            pckWriteStrP(
+                                param,
+                                strNewFmt(
+                                    STORAGE_REPO_ARCHIVE "/%s/%s/%s", strZ(archiveResult->archiveId), strZ(walPath),
+                                    strZ(walBundleFile->bundle)));
+                            pckWriteBoolP(param, true);
+                            pckWriteU64P(param, walBundleFile->offset);
+                            pckWriteU64P(param, walBundleFile->size);
+                        }
+                        else
+                        {
+                            pckWriteStrP(param, filePathName);
+                            pckWriteBoolP(param, false);
+                        }
+
                         pckWriteU32P(param, compressTypeFromName(filePathName));
                         pckWriteBinP(param, checksum);
                         pckWriteU64P(param, archiveResult->pgWalInfo.size);
+                        pckWriteU64P(
+                            param, jobData->walCipherPass == NULL ? cipherTypeNone : cfgOptionStrId(cfgOptRepoCipherType));
                         pckWriteStrP(param, jobData->walCipherPass);
+                        pckWriteStrP(param, archiveResult->archiveId);
 
                         // Assign job to result, prepending the archiveId to the key for consistency with backup processing
                         const String *const jobKey = strNewFmt("%s/%s", strZ(archiveResult->archiveId), strZ(filePathName));
@@ -816,6 +902,232 @@ verifyArchive(VerifyJobData *const jobData)
     FUNCTION_TEST_RETURN(PROTOCOL_PARALLEL_JOB, result);
 }
 
+/***********************************************************************************************************************************
+Comparator to sort bundle files by bundle and offset so the files in each bundle are contiguous and in the order they are stored
+***********************************************************************************************************************************/
+static int
+verifyBundleJobFileComparator(const void *const item1, const void *const item2)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, item1);
+        FUNCTION_TEST_PARAM_P(VOID, item2);
+    FUNCTION_TEST_END();
+
+    ASSERT(item1 != NULL);
+    ASSERT(item2 != NULL);
+
+    const VerifyBundleJobFile *const file1 = item1;
+    const VerifyBundleJobFile *const file2 = item2;
+    int result = strCmp(file1->bundlePathName, file2->bundlePathName);
+
+    if (result == 0)
+        result = LST_COMPARATOR_CMP(file1->file.offset, file2->file.offset);
+
+    FUNCTION_TEST_RETURN(INT, result);
+}
+
+/***********************************************************************************************************************************
+Comparator to sort bundle jobs by size. The file index makes the order deterministic when sizes are equal.
+***********************************************************************************************************************************/
+static int
+verifyBundleJobComparator(const void *const item1, const void *const item2)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, item1);
+        FUNCTION_TEST_PARAM_P(VOID, item2);
+    FUNCTION_TEST_END();
+
+    ASSERT(item1 != NULL);
+    ASSERT(item2 != NULL);
+
+    const VerifyBundleJob *const job1 = item1;
+    const VerifyBundleJob *const job2 = item2;
+    int result = LST_COMPARATOR_CMP(job1->size, job2->size);
+
+    if (result == 0)
+        result = LST_COMPARATOR_CMP(job2->fileIdx, job1->fileIdx);
+
+    FUNCTION_TEST_RETURN(INT, result);
+}
+
+/***********************************************************************************************************************************
+Add a file stored in a bundle so it can be verified with the other files in the bundle once the manifest has been processed
+***********************************************************************************************************************************/
+static void
+verifyBundleFileAdd(
+    VerifyJobData *const jobData, const String *const bundlePathName, const String *const key, const VerifyBundleFile *const file)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, jobData);
+        FUNCTION_TEST_PARAM(STRING, bundlePathName);
+        FUNCTION_TEST_PARAM(STRING, key);
+        FUNCTION_TEST_PARAM_P(VOID, file);
+    FUNCTION_TEST_END();
+
+    ASSERT(jobData != NULL);
+    ASSERT(bundlePathName != NULL);
+    ASSERT(key != NULL);
+    ASSERT(file != NULL);
+
+    if (jobData->bundleFileList == NULL)
+    {
+        MEM_CONTEXT_BEGIN(jobData->memContext)
+        {
+            jobData->bundleFileList = lstNewP(sizeof(VerifyBundleJobFile), .comparator = verifyBundleJobFileComparator);
+        }
+        MEM_CONTEXT_END();
+    }
+
+    MEM_CONTEXT_BEGIN(lstMemContext(jobData->bundleFileList))
+    {
+        const VerifyBundleJobFile bundleFile =
+        {
+            .bundlePathName = strDup(bundlePathName),
+            .file =
+            {
+                .offset = file->offset,
+                .sizeRepo = file->sizeRepo,
+                .compressType = file->compressType,
+                .checksum = bufDup(file->checksum),
+                .size = file->size,
+                .cipherType = file->cipherType,
+                .cipherPass = strDup(file->cipherPass),
+            },
+            .key = strDup(key),
+        };
+
+        lstAdd(jobData->bundleFileList, &bundleFile);
+    }
+    MEM_CONTEXT_END();
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Create a job for each bundle once the manifest has been processed. Jobs are sorted by size so the largest bundles are verified
+first, which balances the bytes read by each process better than verifying bundles in the order they were found.
+***********************************************************************************************************************************/
+static void
+verifyBundleJobListCreate(VerifyJobData *const jobData)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, jobData);
+    FUNCTION_TEST_END();
+
+    ASSERT(jobData != NULL);
+    ASSERT(jobData->bundleFileList != NULL);
+    ASSERT(jobData->bundleJobList == NULL);
+
+    lstSort(jobData->bundleFileList, sortOrderAsc);
+
+    MEM_CONTEXT_BEGIN(jobData->memContext)
+    {
+        jobData->bundleJobList = lstNewP(sizeof(VerifyBundleJob), .comparator = verifyBundleJobComparator);
+    }
+    MEM_CONTEXT_END();
+
+    for (unsigned int fileIdx = 0; fileIdx < lstSize(jobData->bundleFileList); fileIdx++)
+    {
+        const VerifyBundleJobFile *const file = lstGet(jobData->bundleFileList, fileIdx);
+        VerifyBundleJob *const bundleJob = lstEmpty(jobData->bundleJobList) ? NULL : lstGetLast(jobData->bundleJobList);
+
+        // Add the file to the last job when it is in the same bundle
+        if (bundleJob != NULL &&
+            strEq(
+                file->bundlePathName,
+                ((const VerifyBundleJobFile *)lstGet(jobData->bundleFileList, bundleJob->fileIdx))->bundlePathName))
+        {
+            bundleJob->size += file->file.sizeRepo;
+            bundleJob->fileTotal++;
+        }
+        // Else create a job for the bundle
+        else
+        {
+            lstAdd(
+                jobData->bundleJobList,
+                &(VerifyBundleJob){.size = file->file.sizeRepo, .fileIdx = fileIdx, .fileTotal = 1});
+        }
+    }
+
+    // Jobs are removed from the end of the list so the largest job is last
+    lstSort(jobData->bundleJobList, sortOrderAsc);
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Create a job to verify the largest bundle remaining
+***********************************************************************************************************************************/
+static ProtocolParallelJob *
+verifyBundleJob(VerifyJobData *const jobData)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, jobData);
+    FUNCTION_TEST_END();
+
+    ASSERT(jobData != NULL);
+    ASSERT(jobData->bundleJobList != NULL);
+    ASSERT(!lstEmpty(jobData->bundleJobList));
+
+    ProtocolParallelJob *result = NULL;
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        const VerifyBundleJob *const bundleJob = lstGetLast(jobData->bundleJobList);
+        ProtocolCommand *const command = protocolCommandNew(PROTOCOL_COMMAND_VERIFY_BUNDLE);
+        PackWrite *const param = protocolCommandParam(command);
+        StringList *const keyList = strLstNew();
+
+        pckWriteStrP(param, ((const VerifyBundleJobFile *)lstGet(jobData->bundleFileList, bundleJob->fileIdx))->bundlePathName);
+        pckWriteArrayBeginP(param);
+
+        for (unsigned int fileIdx = bundleJob->fileIdx; fileIdx < bundleJob->fileIdx + bundleJob->fileTotal; fileIdx++)
+        {
+            const VerifyBundleJobFile *const bundleFile = lstGet(jobData->bundleFileList, fileIdx);
+
+            pckWriteObjBeginP(param);
+            pckWriteU64P(param, bundleFile->file.offset);
+            pckWriteU64P(param, bundleFile->file.sizeRepo);
+            pckWriteU32P(param, bundleFile->file.compressType);
+            pckWriteBinP(param, bundleFile->file.checksum);
+            pckWriteU64P(param, bundleFile->file.size);
+            pckWriteU64P(param, bundleFile->file.cipherType);
+            pckWriteStrP(param, bundleFile->file.cipherPass);
+            pckWriteObjEndP(param);
+
+            strLstAdd(keyList, bundleFile->key);
+        }
+
+        pckWriteArrayEndP(param);
+
+        // Track the files verified in order to determine when the processing of the backup is complete
+        ((VerifyBackupResult *)lstGetLast(jobData->backupResultList))->totalFileVerify += bundleJob->fileTotal;
+
+        // The job key is the list of keys for the files in the bundle
+        const Variant *const jobKey = varNewVarLst(varLstNewStrLst(keyList));
+
+        MEM_CONTEXT_PRIOR_BEGIN()
+        {
+            result = protocolParallelJobNew(jobKey, command);
+        }
+        MEM_CONTEXT_PRIOR_END();
+
+        // Remove the job and free the bundle lists when all bundles have been sent for processing
+        lstRemoveLast(jobData->bundleJobList);
+
+        if (lstEmpty(jobData->bundleJobList))
+        {
+            lstFree(jobData->bundleJobList);
+            lstFree(jobData->bundleFileList);
+            jobData->bundleJobList = NULL;
+            jobData->bundleFileList = NULL;
+        }
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_TEST_RETURN(PROTOCOL_PARALLEL_JOB, result);
+}
+
 /***********************************************************************************************************************************
 Verify the job data backups
 ***********************************************************************************************************************************/
@@ -830,8 +1142,18 @@ verifyBackup(VerifyJobData *const jobData)
 
     MEM_CONTEXT_TEMP_BEGIN()
     {
+        // Verify the bundles of the last manifest processed before processing the next backup
+        if (jobData->bundleJobList != NULL)
+        {
+            MEM_CONTEXT_PRIOR_BEGIN()
+            {
+                result = verifyBundleJob(jobData);
+            }
+            MEM_CONTEXT_PRIOR_END();
+        }
+
         // Process backup files, if any
-        while (!strLstEmpty(jobData->backupList))
+        while (result == NULL && !strLstEmpty(jobData->backupList))
         {
             // If result list is empty or the last processed is not equal to the backup being processed, then initialize the backup
             // data and results
@@ -913,8 +1235,9 @@ verifyBackup(VerifyJobData *const jobData)
                 {
                     const ManifestFile fileData = manifestFile(jobData->manifest, jobData->manifestFileIdx);
 
-                    // Track the files verified in order to determine when the processing of the backup is complete
-                    backupResult->totalFileVerify++;
+                    // Track the files verified in order to determine when the processing of the backup is complete. Files verified
+                    // with a bundle are tracked when the bundle job is created.
+                    bool bundleFile = false;
 
                     // Check the file if it is not zero-length or not bundled
                     if (fileData.size != 0 || !manifestData(jobData->manifest)->bundle)
@@ -979,57 +1302,71 @@ verifyBackup(VerifyJobData *const jobData)
                         // If backup label is not null then send it off for processing
                         if (fileBackupLabel != NULL)
                         {
-                            // Set up the job
-                            ProtocolCommand *const command = protocolCommandNew(PROTOCOL_COMMAND_VERIFY_FILE);
-                            PackWrite *const param = protocolCommandParam(command);
                             const String *const filePathName = backupFileRepoPathP(
-                                fileBackupLabel, .manifestName = fileData.name, .bundleId = fileData.bundleId,
+                                fileBackupLabel, .manifestName = fileData.name,
                                 .compressType = manifestData(jobData->manifest)->backupOptionCompressType,
                                 .blockIncr = fileData.blockIncrMapSize != 0);
-
-                            pckWriteStrP(param, filePathName);
-
-                            if (fileData.bundleId != 0)
-                            {
-                                pckWriteBoolP(param, true);
-                                pckWriteU64P(param, fileData.bundleOffset);
-                                pckWriteU64P(param, fileData.sizeRepo);
-                            }
-                            else
-                                pckWriteBoolP(param, false);
+                            VerifyBundleFile file = {.offset = fileData.bundleOffset, .sizeRepo = fileData.sizeRepo};
 
                             // Use the repo checksum when present
                             if (fileData.checksumRepoSha1 != NULL)
                             {
-                                pckWriteU32P(param, compressTypeNone);
-                                pckWriteBinP(param, BUF(fileData.checksumRepoSha1, HASH_TYPE_SHA1_SIZE));
-                                pckWriteU64P(param, fileData.sizeRepo);
-                                pckWriteStrP(param, NULL);
+                                file.compressType = compressTypeNone;
+                                file.checksum = BUF(fileData.checksumRepoSha1, HASH_TYPE_SHA1_SIZE);
+                                file.size = fileData.sizeRepo;
+                                file.cipherType = cipherTypeNone;
                             }
                             // Else use the file checksum, which may require additional filters, e.g. decompression
                             else
                             {
-                                pckWriteU32P(param, manifestData(jobData->manifest)->backupOptionCompressType);
-                                pckWriteBinP(param, BUF(fileData.checksumSha1, HASH_TYPE_SHA1_SIZE));
-                                pckWriteU64P(param, fileData.size);
-                                pckWriteStrP(param, jobData->backupCipherPass);
+                                file.compressType = manifestData(jobData->manifest)->backupOptionCompressType;
+                                file.checksum = BUF(fileData.checksumSha1, HASH_TYPE_SHA1_SIZE);
+                                file.size = fileData.size;
+                                file.cipherType =
+                                    jobData->backupCipherPass == NULL ? cipherTypeNone : cfgOptionStrId(cfgOptRepoCipherType);
+                                file.cipherPass = jobData->backupCipherPass;
                             }
 
-                            // Assign job to result (prepend backup label being processed to the key since some files are in a prior
-                            // backup)
+                            // Job key (prepend backup label being processed to the key since some files are in a prior backup)
                             const String *const jobKey = strNewFmt("%s/%s", strZ(backupResult->backupLabel), strZ(filePathName));
 
-                            MEM_CONTEXT_PRIOR_BEGIN()
+                            // If the file is stored in a bundle then verify it with the other files in the bundle so the bundle is
+                            // read once rather than once per file
+                            if (fileData.bundleId != 0)
                             {
-                                result = protocolParallelJobNew(VARSTR(jobKey), command);
+                                verifyBundleFileAdd(
+                                    jobData, backupFileRepoPathP(fileBackupLabel, .bundleId = fileData.bundleId), jobKey, &file);
+                                bundleFile = true;
+                            }
+                            // Else set up the job
+                            else
+                            {
+                                ProtocolCommand *const command = protocolCommandNew(PROTOCOL_COMMAND_VERIFY_FILE);
+                                PackWrite *const param = protocolCommandParam(command);
+
+                                pckWriteStrP(param, filePathName);
+                                pckWriteBoolP(param, false);
+                                pckWriteU32P(param, file.compressType);
+                                pckWriteBinP(param, file.checksum);
+                                pckWriteU64P(param, file.size);
+                                pckWriteU64P(param, file.cipherType);
+                                pckWriteStrP(param, file.cipherPass);
+
+                                MEM_CONTEXT_PRIOR_BEGIN()
+                                {
+                                    result = protocolParallelJobNew(VARSTR(jobKey), command);
+                                }
+                                MEM_CONTEXT_PRIOR_END();
                             }
-                            MEM_CONTEXT_PRIOR_END();
                         }
                     }
                     // Else mark the zero-length file as valid
                     else
                         backupResult->totalFileValid++;
 
+                    if (!bundleFile)
+                        backupResult->totalFileVerify++;
+
                     // Increment the index to point to the next file
                     jobData->manifestFileIdx++;
 
@@ -1040,6 +1377,10 @@ verifyBackup(VerifyJobData *const jobData)
                         manifestFree(jobData->manifest);
                         jobData->manifest = NULL;
                         strLstRemoveIdx(jobData->backupList, 0);
+
+                        // Create the bundle jobs now that all the files stored in bundles are known
+                        if (jobData->bundleFileList != NULL)
+                            verifyBundleJobListCreate(jobData);
                     }
 
                     // If a job was found to be processed then break out to process it
@@ -1047,6 +1388,16 @@ verifyBackup(VerifyJobData *const jobData)
                         break;
                 }
                 while (jobData->manifestFileIdx < backupResult->totalFileManifest);
+
+                // If no other job was found then verify the bundles of the manifest
+                if (result == NULL && jobData->bundleJobList != NULL)
+                {
+                    MEM_CONTEXT_PRIOR_BEGIN()
+                    {
+                        result = verifyBundleJob(jobData);
+                    }
+                    MEM_CONTEXT_PRIOR_END();
+                }
             }
             else
             {
@@ -1566,8 +1917,9 @@ verifyProcess(const bool verboseText)
                     jobData.backupList, backupInfo, jobData.archiveIdList, jobData.pgHistory, &jobData.jobErrorTotal);
 
                 // Create the parallel executor
-                ProtocolParallel *const parallelExec = protocolParallelNew(
-                    cfgOptionUInt64(cfgOptProtocolTimeout) / 2, verifyJobCallback, &jobData);
+                ProtocolParallel *const parallelExec = protocolParallelNewP(
+                    cfgOptionUInt64(cfgOptProtocolTimeout) / 2, verifyJobCallback, &jobData,
+                    .jobMax = cfgOptionUInt(cfgOptProcessJobMax));
 
                 for (unsigned int processIdx = 1; processIdx <= cfgOptionUInt(cfgOptProcessMax); processIdx++)
                     protocolParallelClientAdd(parallelExec, protocolLocalGet(protocolStorageTypeRepo, 0, processIdx));
@@ -1582,106 +1934,116 @@ verifyProcess(const bool verboseText)
                         // Process completed jobs
                         for (unsigned int jobIdx = 0; jobIdx < completed; jobIdx++)
                         {
-                            // Get the job and job key
+                            // Get the job and job keys. A bundle job key is the list of keys for the files in the bundle.
                             ProtocolParallelJob *const job = protocolParallelResult(parallelExec);
                             const unsigned int processId = protocolParallelJobProcessId(job);
-                            StringList *const filePathLst = strLstNewSplit(varStr(protocolParallelJobKey(job)), FSLASH_STR);
-
-                            // Remove the result and file type identifier and recreate the path file name
-                            const String *const resultId = strLstGet(filePathLst, 0);
-                            strLstRemoveIdx(filePathLst, 0);
-                            const String *const fileType = strLstGet(filePathLst, 0);
-                            strLstRemoveIdx(filePathLst, 0);
-                            const String *const filePathName = strLstJoin(filePathLst, "/");
+                            const Variant *const jobKey = protocolParallelJobKey(job);
+                            StringList *const jobKeyList =
+                                varType(jobKey) == varTypeString ? strLstNew() : strLstNewVarLst(varVarLst(jobKey));
 
-                            // Initialize the result sets
-                            VerifyArchiveResult *archiveIdResult = NULL;
-                            VerifyBackupResult *backupResult = NULL;
+                            if (varType(jobKey) == varTypeString)
+                                strLstAdd(jobKeyList, varStr(jobKey));
 
-                            // Get archiveId result data
-                            if (strEq(fileType, STORAGE_REPO_ARCHIVE_STR))
+                            // Process the result for each file. A bundle job returns a result for each file in the order of the
+                            // keys.
+                            for (unsigned int jobKeyIdx = 0; jobKeyIdx < strLstSize(jobKeyList); jobKeyIdx++)
                             {
-                                // Find the archiveId in the list - assert if not found since this should never happen
-                                const unsigned int index = lstFindIdx(jobData.archiveIdResultList, &resultId);
-                                ASSERT(index != LIST_NOT_FOUND);
+                                StringList *const filePathLst = strLstNewSplit(strLstGet(jobKeyList, jobKeyIdx), FSLASH_STR);
 
-                                archiveIdResult = lstGet(jobData.archiveIdResultList, index);
-                            }
-                            // Else get the backup result data
-                            else
-                            {
-                                const unsigned int index = lstFindIdx(jobData.backupResultList, &resultId);
-                                ASSERT(index != LIST_NOT_FOUND);
+                                // Remove the result and file type identifier and recreate the path file name
+                                const String *const resultId = strLstGet(filePathLst, 0);
+                                strLstRemoveIdx(filePathLst, 0);
+                                const String *const fileType = strLstGet(filePathLst, 0);
+                                strLstRemoveIdx(filePathLst, 0);
+                                const String *const filePathName = strLstJoin(filePathLst, "/");
 
-                                backupResult = lstGet(jobData.backupResultList, index);
-                            }
+                                // Initialize the result sets
+                                VerifyArchiveResult *archiveIdResult = NULL;
+                                VerifyBackupResult *backupResult = NULL;
 
-                            // The job was successful
-                            if (protocolParallelJobErrorCode(job) == 0)
-                            {
-                                const VerifyResult verifyResult = (VerifyResult)pckReadU32P(protocolParallelJobResult(job));
-
-                                // Update the result set for the type of file being processed
+                                // Get archiveId result data
                                 if (strEq(fileType, STORAGE_REPO_ARCHIVE_STR))
                                 {
-                                    if (verifyResult == verifyOk)
+                                    // Find the archiveId in the list - assert if not found since this should never happen
+                                    const unsigned int index = lstFindIdx(jobData.archiveIdResultList, &resultId);
+                                    ASSERT(index != LIST_NOT_FOUND);
+
+                                    archiveIdResult = lstGet(jobData.archiveIdResultList, index);
+                                }
+                                // Else get the backup result data
+                                else
+                                {
+                                    const unsigned int index = lstFindIdx(jobData.backupResultList, &resultId);
+                                    ASSERT(index != LIST_NOT_FOUND);
+
+                                    backupResult = lstGet(jobData.backupResultList, index);
+                                }
+
+                                // Get the result for the file. When the job errored every file in the job gets the job error. A
+                                // bundle job returns an error code and message for each file that could not be read.
+                                VerifyResult verifyResult = verifyOtherError;
+                                int errorCode = protocolParallelJobErrorCode(job);
+                                const String *errorMessage = protocolParallelJobErrorMessage(job);
+
+                                if (errorCode == 0)
+                                {
+                                    verifyResult = (VerifyResult)pckReadU32P(protocolParallelJobResult(job));
+
+                                    if (verifyResult == verifyOtherError)
+                                    {
+                                        errorCode = pckReadI32P(protocolParallelJobResult(job));
+                                        errorMessage = pckReadStrP(protocolParallelJobResult(job));
+                                    }
+                                }
+
+                                // The file is valid
+                                if (verifyResult == verifyOk)
+                                {
+                                    if (strEq(fileType, STORAGE_REPO_ARCHIVE_STR))
                                         archiveIdResult->totalValidWal++;
+                                    else
+                                        backupResult->totalFileValid++;
+                                }
+                                // Else the file is invalid
+                                else
+                                {
+                                    // Log a read error and increment the jobErrorTotal
+                                    if (verifyResult == verifyOtherError)
+                                    {
+                                        LOG_INFO_PID_FMT(
+                                            processId, "%s %s: [%d] %s", verifyErrorMsg(verifyOtherError), strZ(filePathName),
+                                            errorCode, strZ(errorMessage));
+
+                                        jobData.jobErrorTotal++;
+                                    }
+                                    // Else log the invalid result
                                     else
                                     {
                                         jobData.jobErrorTotal += verifyLogInvalidResult(
                                             fileType, verifyResult, processId, filePathName);
+                                    }
 
+                                    // Update the result set for the type of file being processed
+                                    if (strEq(fileType, STORAGE_REPO_ARCHIVE_STR))
+                                    {
                                         // Add invalid file to the WAL range
                                         verifyAddInvalidWalFile(
                                             archiveIdResult->walRangeList, verifyResult, filePathName,
-                                            strSubN(
-                                                strLstGet(filePathLst, strLstSize(filePathLst) - 1), 0, WAL_SEGMENT_NAME_SIZE));
+                                            strSubN(strLstGet(filePathLst, strLstSize(filePathLst) - 1), 0, WAL_SEGMENT_NAME_SIZE));
                                     }
-                                }
-                                else
-                                {
-                                    if (verifyResult == verifyOk)
-                                        backupResult->totalFileValid++;
                                     else
                                     {
-                                        jobData.jobErrorTotal += verifyLogInvalidResult(
-                                            fileType, verifyResult, processId, filePathName);
                                         backupResult->status = backupInvalid;
                                         verifyInvalidFileAdd(backupResult->invalidFileList, verifyResult, filePathName);
                                     }
                                 }
-                            }
-                            // Else the job errored
-                            else
-                            {
-                                // Log a protocol error and increment the jobErrorTotal
-                                LOG_INFO_PID_FMT(
-                                    processId,
-                                    "%s %s: [%d] %s", verifyErrorMsg(verifyOtherError), strZ(filePathName),
-                                    protocolParallelJobErrorCode(job), strZ(protocolParallelJobErrorMessage(job)));
-
-                                jobData.jobErrorTotal++;
 
-                                // Add invalid file with "OtherError" reason to invalid file list
-                                if (strEq(fileType, STORAGE_REPO_ARCHIVE_STR))
+                                // Set backup verification complete for a backup if all files have run through verification
+                                if (strEq(fileType, STORAGE_REPO_BACKUP_STR) &&
+                                    backupResult->totalFileVerify == backupResult->totalFileManifest)
                                 {
-                                    // Add invalid file to the WAL range
-                                    verifyAddInvalidWalFile(
-                                        archiveIdResult->walRangeList, verifyOtherError, filePathName,
-                                        strSubN(strLstGet(filePathLst, strLstSize(filePathLst) - 1), 0, WAL_SEGMENT_NAME_SIZE));
+                                    backupResult->fileVerifyComplete = true;
                                 }
-                                else
-                                {
-                                    backupResult->status = backupInvalid;
-                                    verifyInvalidFileAdd(backupResult->invalidFileList, verifyOtherError, filePathName);
-                                }
-                            }
-
-                            // Set backup verification complete for a backup if all files have run through verification
-                            if (strEq(fileType, STORAGE_REPO_BACKUP_STR) &&
-                                backupResult->totalFileVerify == backupResult->totalFileManifest)
-                            {
-                                backupResult->fileVerifyComplete = true;
                             }
 
                             // Free the job
@@ -40,8 +40,11 @@ static const struct CompressHelperLocal
     const String *const ext;                                        // File extension with period prefixed
     StringId compressType;                                          // Type of the compression filter
     IoFilter *(*compressNew)(int, bool);                            // Function to create new compression filter
+    IoFilter *(*compressNewExt)(int, bool, unsigned int, bool, const Buffer *); // Compression filter with threads/long match/dict
     StringId decompressType;                                        // Type of the decompression filter
     IoFilter *(*decompressNew)(bool);                               // Function to create new decompression filter
+    IoFilter *(*decompressNewExt)(bool, const Buffer *);            // Function to create decompression filter with dictionary
+    Buffer *(*dictTrain)(const Buffer *, size_t);                   // Function to train a dictionary
     int levelDefault : 8;                                           // Default compression level
     int levelMin : 8;                                               // Minimum compression level
     int levelMax : 8;                                               // Maximum compression level
@@ -96,9 +99,10 @@ static const struct CompressHelperLocal
         .ext = STRDEF("." ZST_EXT),
 #ifdef HAVE_LIBZST
         .compressType = ZST_COMPRESS_FILTER_TYPE,
-        .compressNew = zstCompressNew,
+        .compressNewExt = zstCompressNew,
         .decompressType = ZST_DECOMPRESS_FILTER_TYPE,
-        .decompressNew = zstDecompressNew,
+        .decompressNewExt = zstDecompressNew,
+        .dictTrain = zstDictTrain,
         .levelDefault = ZST_COMPRESS_LEVEL_DEFAULT,
         .levelMin = ZST_COMPRESS_LEVEL_MIN,
         .levelMax = ZST_COMPRESS_LEVEL_MAX,
@@ -145,7 +149,7 @@ compressTypePresent(const CompressType type)
 
     ASSERT(type < LENGTH_OF(compressHelperLocal));
 
-    if (type != compressTypeNone && compressHelperLocal[type].compressNew == NULL)
+    if (type != compressTypeNone && compressHelperLocal[type].compressType == 0)
         THROW_FMT(OptionInvalidValueError, PROJECT_NAME " not built with %s support", strZ(compressHelperLocal[type].type));
 
     FUNCTION_TEST_RETURN_VOID();
@@ -236,13 +240,23 @@ compressFilter(const CompressType type, const int level, const CompressFilterPar
         FUNCTION_TEST_PARAM(ENUM, type);
         FUNCTION_TEST_PARAM(INT, level);
         FUNCTION_TEST_PARAM(BOOL, param.raw);
+        FUNCTION_TEST_PARAM(UINT, param.threadMax);
+        FUNCTION_TEST_PARAM(BOOL, param.longMatch);
+        FUNCTION_TEST_PARAM(BUFFER, param.dict);
     FUNCTION_TEST_END();
 
     ASSERT(type < LENGTH_OF(compressHelperLocal));
     ASSERT(type != compressTypeNone);
     compressTypePresent(type);
 
-    FUNCTION_TEST_RETURN(IO_FILTER, compressHelperLocal[type].compressNew(level, param.raw));
+    // Threads, long distance matching, and dictionaries are ignored by compression types that do not support them
+    const struct CompressHelperLocal *const compress = &compressHelperLocal[type];
+
+    FUNCTION_TEST_RETURN(
+        IO_FILTER,
+        compress->compressNewExt != NULL ?
+            compress->compressNewExt(level, param.raw, param.threadMax, param.longMatch, param.dict) :
+            compress->compressNew(level, param.raw));
 }
 
 /**********************************************************************************************************************************/
@@ -272,12 +286,28 @@ compressFilterPack(const StringId filterType, const Pack *const filterParam)
                 const int level = pckReadI32P(paramRead);
                 const bool raw = pckReadBoolP(paramRead);
 
-                result = ioFilterMove(compress->compressNew(level, raw), memContextPrior());
+                if (compress->compressNewExt != NULL)
+                {
+                    const unsigned int threadMax = pckReadU32P(paramRead);
+                    const bool longMatch = pckReadBoolP(paramRead);
+                    const Buffer *const dict = pckReadBinP(paramRead);
+
+                    result = ioFilterMove(
+                        compress->compressNewExt(level, raw, threadMax, longMatch, dict), memContextPrior());
+                }
+                else
+                    result = ioFilterMove(compress->compressNew(level, raw), memContextPrior());
                 break;
             }
             else if (filterType == compress->decompressType)
             {
-                result = ioFilterMove(compress->decompressNew(pckReadBoolP(pckReadNew(filterParam))), memContextPrior());
+                PackRead *const paramRead = pckReadNew(filterParam);
+                const bool raw = pckReadBoolP(paramRead);
+
+                if (compress->decompressNewExt != NULL)
+                    result = ioFilterMove(compress->decompressNewExt(raw, pckReadBinP(paramRead)), memContextPrior());
+                else
+                    result = ioFilterMove(compress->decompressNew(raw), memContextPrior());
                 break;
             }
         }
@@ -294,13 +324,40 @@ decompressFilter(const CompressType type, const DecompressFilterParam param)
     FUNCTION_TEST_BEGIN();
         FUNCTION_TEST_PARAM(ENUM, type);
         FUNCTION_TEST_PARAM(BOOL, param.raw);
+        FUNCTION_TEST_PARAM(BUFFER, param.dict);
+    FUNCTION_TEST_END();
+
+    ASSERT(type < LENGTH_OF(compressHelperLocal));
+    ASSERT(type != compressTypeNone);
+    compressTypePresent(type);
+
+    // Dictionaries are ignored by compression types that do not support them
+    const struct CompressHelperLocal *const compress = &compressHelperLocal[type];
+
+    FUNCTION_TEST_RETURN(
+        IO_FILTER,
+        compress->decompressNewExt != NULL ?
+            compress->decompressNewExt(param.raw, param.dict) : compress->decompressNew(param.raw));
+}
+
+/**********************************************************************************************************************************/
+FN_EXTERN Buffer *
+compressDictTrain(const CompressType type, const Buffer *const sample, const size_t sampleSize)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(ENUM, type);
+        FUNCTION_TEST_PARAM(BUFFER, sample);
+        FUNCTION_TEST_PARAM(SIZE, sampleSize);
     FUNCTION_TEST_END();
 
     ASSERT(type < LENGTH_OF(compressHelperLocal));
     ASSERT(type != compressTypeNone);
+    ASSERT(sample != NULL);
     compressTypePresent(type);
 
-    FUNCTION_TEST_RETURN(IO_FILTER, compressHelperLocal[type].decompressNew(param.raw));
+    const struct CompressHelperLocal *const compress = &compressHelperLocal[type];
+
+    FUNCTION_TEST_RETURN(BUFFER, compress->dictTrain != NULL ? compress->dictTrain(sample, sampleSize) : NULL);
 }
 
 /**********************************************************************************************************************************/
@@ -54,6 +54,9 @@ typedef struct CompressFilterParam
 {
     VAR_PARAM_HEADER;
     bool raw;                                                       // Omit headers, checksum, etc. when possible
+    unsigned int threadMax;                                         // Max threads used to compress (zst only)
+    bool longMatch;                                                 // Find matches over a long distance (zst only)
+    const Buffer *dict;                                             // Dictionary trained with compressDictTrain() (zst only)
 } CompressFilterParam;
 
 #define compressFilterP(type, level, ...)                                                                                          \
@@ -70,6 +73,7 @@ typedef struct DecompressFilterParam
 {
     VAR_PARAM_HEADER;
     bool raw;                                                       // Omit headers, checksum, etc. when possible
+    const Buffer *dict;                                             // Dictionary used to compress (zst only)
 } DecompressFilterParam;
 
 #define decompressFilterP(type, ...)                                                                                               \
@@ -77,6 +81,10 @@ typedef struct DecompressFilterParam
 
 FN_EXTERN IoFilter *decompressFilter(CompressType type, DecompressFilterParam param);
 
+// Train a compression dictionary from a buffer split into samples of sampleSize. NULL is returned when the compression type does
+// not support dictionaries or when a dictionary could not be trained from the samples.
+FN_EXTERN Buffer *compressDictTrain(CompressType type, const Buffer *sample, size_t sampleSize);
+
 // Get extension for the current compression type
 FN_EXTERN const String *compressExtStr(CompressType type);
 
@@ -5,6 +5,7 @@ ZST Common
 
 #ifdef HAVE_LIBZST
 
+#include <zdict.h>
 #include <zstd.h>
 
 // Check the version -- this is done in configure but it makes sense to be sure
@@ -14,6 +15,8 @@ ZST Common
 
 #include "common/compress/zst/common.h"
 #include "common/debug.h"
+#include "common/log.h"
+#include "common/memContext.h"
 
 /**********************************************************************************************************************************/
 FN_EXTERN size_t
@@ -29,4 +32,61 @@ zstError(const size_t error)
     FUNCTION_TEST_RETURN(SIZE, error);
 }
 
+/**********************************************************************************************************************************/
+FN_EXTERN Buffer *
+zstDictTrain(const Buffer *const sample, const size_t sampleSize)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(BUFFER, sample);
+        FUNCTION_LOG_PARAM(SIZE, sampleSize);
+    FUNCTION_LOG_END();
+
+    ASSERT(sample != NULL);
+    ASSERT(sampleSize > 0);
+
+    Buffer *result = NULL;
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        // Split the buffer into samples
+        const unsigned int sampleTotal = (unsigned int)((bufUsed(sample) + sampleSize - 1) / sampleSize);
+        size_t *const sampleSizeList = memNew(sizeof(size_t) * (sampleTotal == 0 ? 1 : sampleTotal));
+
+        for (unsigned int sampleIdx = 0; sampleIdx < sampleTotal; sampleIdx++)
+        {
+            sampleSizeList[sampleIdx] =
+                sampleIdx == sampleTotal - 1 ? bufUsed(sample) - (size_t)sampleIdx * sampleSize : sampleSize;
+        }
+
+        // Train the dictionary. Errors are not thrown since failing to train is expected when the samples are not suitable.
+        Buffer *const dict = bufNew(ZST_DICT_SIZE_MAX);
+        const size_t dictSize = ZDICT_trainFromBuffer(
+            bufPtr(dict), bufSize(dict), bufPtrConst(sample), sampleSizeList, sampleTotal);
+
+        if (!ZDICT_isError(dictSize))
+        {
+            bufUsedSet(dict, dictSize);
+            bufResize(dict, dictSize);
+
+            result = bufMove(dict, memContextPrior());
+        }
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_LOG_RETURN(BUFFER, result);
+}
+
+/**********************************************************************************************************************************/
+FN_EXTERN unsigned int
+zstDictId(const Buffer *const dict)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(BUFFER, dict);
+    FUNCTION_TEST_END();
+
+    ASSERT(dict != NULL);
+
+    FUNCTION_TEST_RETURN(UINT, ZSTD_getDictID_fromDict(bufPtrConst(dict), bufUsed(dict)));
+}
+
 #endif // HAVE_LIBZST
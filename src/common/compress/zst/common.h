@@ -8,6 +8,8 @@ Developed using the documentation in https://github.com/facebook/zstd/blob/v1.0.
 
 #include <stddef.h>
 
+#include "common/type/buffer.h"
+
 /***********************************************************************************************************************************
 ZST extension
 ***********************************************************************************************************************************/
@@ -15,11 +17,23 @@ ZST extension
 
 #ifdef HAVE_LIBZST
 
+/***********************************************************************************************************************************
+Max size of a trained dictionary. This is the default used by the zstd command line tool.
+***********************************************************************************************************************************/
+#define ZST_DICT_SIZE_MAX                                           ((size_t)110 * 1024)
+
 /***********************************************************************************************************************************
 Functions
 ***********************************************************************************************************************************/
 FN_EXTERN size_t zstError(size_t error);
 
+// Train a dictionary from a buffer split into samples of sampleSize (the last sample may be smaller). Returns NULL when a
+// dictionary cannot be trained, e.g. when there are too few samples or they do not have enough in common.
+FN_EXTERN Buffer *zstDictTrain(const Buffer *sample, size_t sampleSize);
+
+// Id of a dictionary, which is stored in the header of frames compressed with the dictionary
+FN_EXTERN unsigned int zstDictId(const Buffer *dict);
+
 #endif // HAVE_LIBZST
 
 #endif
@@ -22,6 +22,9 @@ typedef struct ZstCompress
 {
     ZSTD_CStream *context;                                          // Compression context
     int level;                                                      // Compression level
+    unsigned int threadMax;                                         // Worker threads used to compress (0 if none)
+    bool longMatch;                                                 // Is long distance matching enabled?
+    unsigned int dictId;                                            // Dictionary id (0 if none)
     IoFilter *filter;                                               // Filter interface
 
     bool inputSame;                                                 // Is the same input required on the next process call?
@@ -36,7 +39,8 @@ static void
 zstCompressToLog(const ZstCompress *const this, StringStatic *const debugLog)
 {
     strStcFmt(
-        debugLog, "{level: %d, inputSame: %s, inputOffset: %zu, flushing: %s}", this->level, cvtBoolToConstZ(this->inputSame),
+        debugLog, "{level: %d, threadMax: %u, longMatch: %s, dictId: %u, inputSame: %s, inputOffset: %zu, flushing: %s}",
+        this->level, this->threadMax, cvtBoolToConstZ(this->longMatch), this->dictId, cvtBoolToConstZ(this->inputSame),
         this->inputOffset, cvtBoolToConstZ(this->flushing));
 }
 
@@ -109,8 +113,8 @@ zstCompressProcess(THIS_VOID, const Buffer *const uncompressed, Buffer *const co
         // If the input buffer was not entirely consumed then set inputSame and store the offset where processing will restart
         if (in.pos < in.size)
         {
-            // Output buffer should be completely full
-            ASSERT(out.pos == out.size);
+            // Output buffer should be completely full unless worker threads are busy and cannot accept more input yet
+            ASSERT(out.pos == out.size || this->threadMax > 0);
 
             this->inputSame = true;
             this->inputOffset += in.pos;
@@ -164,11 +168,14 @@ zstCompressInputSame(const THIS_VOID)
 
 /**********************************************************************************************************************************/
 FN_EXTERN IoFilter *
-zstCompressNew(const int level, const bool raw)
+zstCompressNew(const int level, const bool raw, const unsigned int threadMax, const bool longMatch, const Buffer *const dict)
 {
     FUNCTION_LOG_BEGIN(logLevelTrace);
         FUNCTION_LOG_PARAM(INT, level);
         (void)raw;                                                  // Raw unsupported
+        FUNCTION_LOG_PARAM(UINT, threadMax);
+        FUNCTION_LOG_PARAM(BOOL, longMatch);
+        FUNCTION_LOG_PARAM(BUFFER, dict);
     FUNCTION_LOG_END();
 
     ASSERT(level >= ZST_COMPRESS_LEVEL_MIN && level <= ZST_COMPRESS_LEVEL_MAX);
@@ -186,6 +193,40 @@ zstCompressNew(const int level, const bool raw)
 
         // Initialize context
         zstError(ZSTD_initCStream(this->context, this->level));
+
+#if ZSTD_VERSION_NUMBER >= 10400
+        // Compress on worker threads when more than one thread is requested. The calling thread only queues input and collects
+        // output so all threads are workers. Threads are not available when libzstd was built without multithreading support.
+        if (threadMax > 1)
+        {
+            const ZSTD_bounds threadBounds = ZSTD_cParam_getBounds(ZSTD_c_nbWorkers);
+
+            if (!ZSTD_isError(threadBounds.error) && threadBounds.upperBound > 0)
+            {
+                const unsigned int threadBoundMax = (unsigned int)threadBounds.upperBound;
+
+                this->threadMax = threadMax < threadBoundMax ? threadMax : threadBoundMax;
+                zstError(ZSTD_CCtx_setParameter(this->context, ZSTD_c_nbWorkers, (int)this->threadMax));
+            }
+        }
+
+        // Enable long distance matching. The window is limited to the largest window the decompressor accepts by default so the
+        // output can be decompressed without special settings.
+        if (longMatch)
+        {
+            this->longMatch = true;
+            zstError(ZSTD_CCtx_setParameter(this->context, ZSTD_c_enableLongDistanceMatching, 1));
+            zstError(ZSTD_CCtx_setParameter(this->context, ZSTD_c_windowLog, ZST_COMPRESS_LONG_WINDOW_LOG));
+        }
+
+        // Compress with a dictionary. The dictionary is copied into the context so it does not need to be kept. The dictionary id
+        // is stored in the frame header so the decompressor can check that the correct dictionary is used.
+        if (dict != NULL)
+        {
+            this->dictId = zstDictId(dict);
+            zstError(ZSTD_CCtx_loadDictionary(this->context, bufPtrConst(dict), bufUsed(dict)));
+        }
+#endif
     }
     OBJ_NEW_END();
 
@@ -197,6 +238,10 @@ zstCompressNew(const int level, const bool raw)
         PackWrite *const packWrite = pckWriteNewP();
 
         pckWriteI32P(packWrite, level);
+        pckWriteBoolP(packWrite, raw);
+        pckWriteU32P(packWrite, threadMax);
+        pckWriteBoolP(packWrite, longMatch);
+        pckWriteBinP(packWrite, dict);
         pckWriteEndP(packWrite);
 
         paramList = pckMove(pckWriteResult(packWrite), memContextPrior());
@@ -22,10 +22,18 @@ Level constants
 #define ZST_COMPRESS_LEVEL_MIN                                      -7
 #define ZST_COMPRESS_LEVEL_MAX                                      22
 
+/***********************************************************************************************************************************
+Window log used for long distance matching. This is the largest window accepted by the decompressor without raising the memory limit
+so files compressed with long distance matching can be decompressed in the usual way.
+***********************************************************************************************************************************/
+#define ZST_COMPRESS_LONG_WINDOW_LOG                                27
+
 /***********************************************************************************************************************************
 Constructors
 ***********************************************************************************************************************************/
-FN_EXTERN IoFilter *zstCompressNew(int level, bool raw);
+// Threads, long distance matching, and dictionaries are ignored when not supported by the libzstd version (all require at least
+// 1.4.0). The dictionary is optional.
+FN_EXTERN IoFilter *zstCompressNew(int level, bool raw, unsigned int threadMax, bool longMatch, const Buffer *dict);
 
 #endif
 
@@ -13,6 +13,7 @@ ZST Decompress
 #include "common/io/filter/filter.h"
 #include "common/log.h"
 #include "common/type/object.h"
+#include "common/type/pack.h"
 
 /***********************************************************************************************************************************
 Object type
@@ -20,8 +21,10 @@ Object type
 typedef struct ZstDecompress
 {
     ZSTD_DStream *context;                                          // Decompression context
+    const Buffer *dict;                                             // Dictionary (NULL if none)
     IoFilter *filter;                                               // Filter interface
 
+    bool dictChecked;                                               // Has the frame been checked for a dictionary?
     bool inputSame;                                                 // Is the same input required on the next process call?
     size_t inputOffset;                                             // Current offset in input buffer
     bool frameDone;                                                 // Has the current frame completed?
@@ -63,6 +66,44 @@ zstDecompressFreeResource(THIS_VOID)
     FUNCTION_LOG_RETURN_VOID();
 }
 
+/***********************************************************************************************************************************
+Load the dictionary when the frame requires it. The dictionary must only be loaded for frames that were compressed with it since a
+frame without a dictionary id would otherwise be decompressed using the dictionary.
+***********************************************************************************************************************************/
+static void
+zstDecompressDict(ZstDecompress *const this, const Buffer *const compressed)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(ZST_DECOMPRESS, this);
+        FUNCTION_LOG_PARAM(BUFFER, compressed);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(compressed != NULL);
+
+    const unsigned int frameDictId = ZSTD_getDictID_fromFrame(bufPtrConst(compressed), bufUsed(compressed));
+
+    if (frameDictId != 0)
+    {
+        if (this->dict == NULL || zstDictId(this->dict) != frameDictId)
+        {
+            THROW_FMT(
+                FormatError, "zst frame requires dictionary %u but %s", frameDictId,
+                this->dict == NULL ? "no dictionary was provided" : zNewFmt("dictionary %u was provided", zstDictId(this->dict)));
+        }
+
+#if ZSTD_VERSION_NUMBER >= 10400
+        zstError(ZSTD_DCtx_loadDictionary(this->context, bufPtrConst(this->dict), bufUsed(this->dict)));
+#else
+        THROW(FormatError, "zst dictionaries require libzstd >= 1.4.0");
+#endif
+    }
+
+    this->dictChecked = true;
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
 /***********************************************************************************************************************************
 Decompress data
 ***********************************************************************************************************************************/
@@ -92,6 +133,10 @@ zstDecompressProcess(THIS_VOID, const Buffer *const compressed, Buffer *const de
     }
     else
     {
+        // Load the dictionary before the first frame is decompressed
+        if (!this->dictChecked)
+            zstDecompressDict(this, compressed);
+
         // Initialize input/output buffer
         ZSTD_inBuffer in = {.src = bufPtrConst(compressed) + this->inputOffset, .size = bufUsed(compressed) - this->inputOffset};
         ZSTD_outBuffer out = {.dst = bufRemainsPtr(decompressed), .size = bufRemains(decompressed)};
@@ -156,10 +201,11 @@ zstDecompressInputSame(const THIS_VOID)
 
 /**********************************************************************************************************************************/
 FN_EXTERN IoFilter *
-zstDecompressNew(const bool raw)
+zstDecompressNew(const bool raw, const Buffer *const dict)
 {
     FUNCTION_LOG_BEGIN(logLevelTrace);
         (void)raw;                                                  // Raw unsupported
+        FUNCTION_LOG_PARAM(BUFFER, dict);
     FUNCTION_LOG_END();
 
     OBJ_NEW_BEGIN(ZstDecompress, .childQty = MEM_CONTEXT_QTY_MAX, .callbackQty = 1)
@@ -167,6 +213,7 @@ zstDecompressNew(const bool raw)
         *this = (ZstDecompress)
         {
             .context = ZSTD_createDStream(),
+            .dict = dict == NULL ? NULL : bufDup(dict),
         };
 
         // Set callback to ensure zst context is freed
@@ -177,10 +224,25 @@ zstDecompressNew(const bool raw)
     }
     OBJ_NEW_END();
 
+    // Create param list
+    Pack *paramList;
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        PackWrite *const packWrite = pckWriteNewP();
+
+        pckWriteBoolP(packWrite, raw);
+        pckWriteBinP(packWrite, dict);
+        pckWriteEndP(packWrite);
+
+        paramList = pckMove(pckWriteResult(packWrite), memContextPrior());
+    }
+    MEM_CONTEXT_TEMP_END();
+
     FUNCTION_LOG_RETURN(
         IO_FILTER,
         ioFilterNewP(
-            ZST_DECOMPRESS_FILTER_TYPE, this, NULL, .done = zstDecompressDone, .inOut = zstDecompressProcess,
+            ZST_DECOMPRESS_FILTER_TYPE, this, paramList, .done = zstDecompressDone, .inOut = zstDecompressProcess,
             .inputSame = zstDecompressInputSame));
 }
 
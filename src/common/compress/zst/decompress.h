@@ -18,7 +18,8 @@ Filter type constant
 /***********************************************************************************************************************************
 Constructors
 ***********************************************************************************************************************************/
-FN_EXTERN IoFilter *zstDecompressNew(bool raw);
+// The dictionary is optional and only used when the frame was compressed with a dictionary that has the same id
+FN_EXTERN IoFilter *zstDecompressNew(bool raw, const Buffer *dict);
 
 #endif
 
@@ -9,20 +9,17 @@ Block Cipher
 #include <openssl/evp.h>
 
 #include "common/crypto/cipherBlock.h"
+#include "common/crypto/cipherFrame.h"
 #include "common/crypto/common.h"
 #include "common/debug.h"
 #include "common/io/filter/filter.h"
+#include "common/io/io.h"
 #include "common/log.h"
 #include "common/type/object.h"
 
 /***********************************************************************************************************************************
 Header constants and sizes
 ***********************************************************************************************************************************/
-// Magic constant for salted encrypt. Only salted encrypt is done here, but this constant is required for compatibility with the
-// openssl command-line tool.
-#define CIPHER_BLOCK_MAGIC                                          "Salted__"
-#define CIPHER_BLOCK_MAGIC_SIZE                                     (sizeof(CIPHER_BLOCK_MAGIC) - 1)
-
 // Total length of cipher header
 #define CIPHER_BLOCK_HEADER_SIZE                                    (CIPHER_BLOCK_MAGIC_SIZE + PKCS5_SALT_LEN)
 
@@ -164,7 +161,13 @@ cipherBlockProcessBlock(CipherBlock *const this, const unsigned char *source, si
                 // The first bytes of the file to decrypt should be equal to the magic. If not then this is not an encrypted file,
                 // or at least not in a format we recognize.
                 if (!this->raw && memcmp(this->header, CIPHER_BLOCK_MAGIC, CIPHER_BLOCK_MAGIC_SIZE) != 0)
+                {
+                    // Give a more useful error when the data was encrypted with frames
+                    if (memcmp(this->header, CIPHER_FRAME_MAGIC, CIPHER_FRAME_MAGIC_SIZE) == 0)
+                        THROW(CryptoError, "cipher header invalid: data is encrypted with aes-256-gcm");
+
                     THROW(CryptoError, "cipher header invalid");
+                }
             }
             // Else copy what was provided into the header buffer and return 0
             else
@@ -397,66 +400,77 @@ cipherBlockNew(const CipherMode mode, const CipherType cipherType, const Buffer
     ASSERT(pass != NULL);
     ASSERT(!bufEmpty(pass));
 
-    // Init crypto subsystem
-    cryptoInit();
+    IoFilter *result;
 
-    // Lookup cipher by name. This means the ciphers passed in must exactly match a name expected by OpenSSL. This is a good thing
-    // since the name required by the openssl command-line tool will match what is used by pgBackRest.
-    String *const cipherTypeStr = strIdToStr(cipherType);
-    const EVP_CIPHER *cipher = EVP_get_cipherbyname(strZ(cipherTypeStr));
+    // Authenticated ciphers are processed in frames by a separate filter, on multiple threads when io-thread is enabled
+    if (cipherType == cipherTypeAes256Gcm)
+    {
+        result = cipherFrameNewP(mode, pass, .raw = param.raw, .threadMax = ioThread() ? CIPHER_FRAME_THREAD_MAX : 1);
+    }
+    // Else use a block cipher
+    else
+    {
+        // Init crypto subsystem
+        cryptoInit();
 
-    if (!cipher)
-        THROW_FMT(AssertError, "unable to load cipher '%s'", strZ(cipherTypeStr));
+        // Lookup cipher by name. This means the ciphers passed in must exactly match a name expected by OpenSSL. This is a good
+        // thing since the name required by the openssl command-line tool will match what is used by pgBackRest.
+        String *const cipherTypeStr = strIdToStr(cipherType);
+        const EVP_CIPHER *cipher = EVP_get_cipherbyname(strZ(cipherTypeStr));
 
-    strFree(cipherTypeStr);
+        if (!cipher)
+            THROW_FMT(AssertError, "unable to load cipher '%s'", strZ(cipherTypeStr));
 
-    // Lookup digest. If not defined it will be set to sha1.
-    const EVP_MD *digest = NULL;
+        strFree(cipherTypeStr);
 
-    if (param.digest)
-        digest = EVP_get_digestbyname(strZ(param.digest));
-    else
-        digest = EVP_sha1();
+        // Lookup digest. If not defined it will be set to sha1.
+        const EVP_MD *digest = NULL;
 
-    if (!digest)
-        THROW_FMT(AssertError, "unable to load digest '%s'", strZ(param.digest));
+        if (param.digest)
+            digest = EVP_get_digestbyname(strZ(param.digest));
+        else
+            digest = EVP_sha1();
 
-    OBJ_NEW_BEGIN(CipherBlock, .childQty = MEM_CONTEXT_QTY_MAX, .callbackQty = 1)
-    {
-        *this = (CipherBlock)
+        if (!digest)
+            THROW_FMT(AssertError, "unable to load digest '%s'", strZ(param.digest));
+
+        OBJ_NEW_BEGIN(CipherBlock, .childQty = MEM_CONTEXT_QTY_MAX, .callbackQty = 1)
         {
-            .mode = mode,
-            .raw = param.raw,
-            .cipher = cipher,
-            .digest = digest,
-            .pass = bufDup(pass),
-        };
-    }
-    OBJ_NEW_END();
+            *this = (CipherBlock)
+            {
+                .mode = mode,
+                .raw = param.raw,
+                .cipher = cipher,
+                .digest = digest,
+                .pass = bufDup(pass),
+            };
+        }
+        OBJ_NEW_END();
 
-    // Create param list
-    Pack *paramList;
+        // Create param list
+        Pack *paramList;
 
-    MEM_CONTEXT_TEMP_BEGIN()
-    {
-        PackWrite *const packWrite = pckWriteNewP();
+        MEM_CONTEXT_TEMP_BEGIN()
+        {
+            PackWrite *const packWrite = pckWriteNewP();
 
-        pckWriteU64P(packWrite, mode);
-        pckWriteU64P(packWrite, cipherType);
-        pckWriteBinP(packWrite, pass);
-        pckWriteStrP(packWrite, param.digest);
-        pckWriteBoolP(packWrite, param.raw);
-        pckWriteEndP(packWrite);
+            pckWriteU64P(packWrite, mode);
+            pckWriteU64P(packWrite, cipherType);
+            pckWriteBinP(packWrite, pass);
+            pckWriteStrP(packWrite, param.digest);
+            pckWriteBoolP(packWrite, param.raw);
+            pckWriteEndP(packWrite);
 
-        paramList = pckMove(pckWriteResult(packWrite), memContextPrior());
-    }
-    MEM_CONTEXT_TEMP_END();
+            paramList = pckMove(pckWriteResult(packWrite), memContextPrior());
+        }
+        MEM_CONTEXT_TEMP_END();
 
-    FUNCTION_LOG_RETURN(
-        IO_FILTER,
-        ioFilterNewP(
+        result = ioFilterNewP(
             CIPHER_BLOCK_FILTER_TYPE, this, paramList, .done = cipherBlockDone, .inOut = cipherBlockProcess,
-            .inputSame = cipherBlockInputSame));
+            .inputSame = cipherBlockInputSame);
+    }
+
+    FUNCTION_LOG_RETURN(IO_FILTER, result);
 }
 
 FN_EXTERN IoFilter *
@@ -480,6 +494,22 @@ cipherBlockNewPack(const Pack *const paramList)
     return result;
 }
 
+/**********************************************************************************************************************************/
+FN_EXTERN IoFilter *
+cipherBlockFilterPack(const StringId filterType, const Pack *const paramList)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(STRING_ID, filterType);
+        FUNCTION_LOG_PARAM(PACK, paramList);
+    FUNCTION_LOG_END();
+
+    ASSERT(filterType == CIPHER_BLOCK_FILTER_TYPE || filterType == CIPHER_FRAME_FILTER_TYPE);
+    ASSERT(paramList != NULL);
+
+    FUNCTION_LOG_RETURN(
+        IO_FILTER, filterType == CIPHER_FRAME_FILTER_TYPE ? cipherFrameNewPack(paramList) : cipherBlockNewPack(paramList));
+}
+
 /**********************************************************************************************************************************/
 FN_EXTERN IoFilterGroup *
 cipherBlockFilterGroupAdd(IoFilterGroup *const filterGroup, const CipherType type, const CipherMode mode, const String *const pass)
@@ -12,6 +12,14 @@ Filter type constant
 ***********************************************************************************************************************************/
 #define CIPHER_BLOCK_FILTER_TYPE                                   STRID5("cipher-blk", 0x16c16e45441230)
 
+/***********************************************************************************************************************************
+Header constants
+***********************************************************************************************************************************/
+// Magic constant for salted encrypt. Only salted encrypt is done here, but this constant is required for compatibility with the
+// openssl command-line tool.
+#define CIPHER_BLOCK_MAGIC                                          "Salted__"
+#define CIPHER_BLOCK_MAGIC_SIZE                                     (sizeof(CIPHER_BLOCK_MAGIC) - 1)
+
 /***********************************************************************************************************************************
 Constructors
 ***********************************************************************************************************************************/
@@ -28,6 +36,9 @@ typedef struct CipherBlockNewParam
 FN_EXTERN IoFilter *cipherBlockNew(CipherMode mode, CipherType cipherType, const Buffer *pass, CipherBlockNewParam param);
 FN_EXTERN IoFilter *cipherBlockNewPack(const Pack *paramList);
 
+// Create a cipher filter from the filter type and parameter list of a filter returned by cipherBlockNew()
+FN_EXTERN IoFilter *cipherBlockFilterPack(StringId filterType, const Pack *paramList);
+
 /***********************************************************************************************************************************
 Helper functions
 ***********************************************************************************************************************************/
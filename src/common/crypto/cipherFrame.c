@@ -0,0 +1,605 @@
+/***********************************************************************************************************************************
+Frame Cipher
+***********************************************************************************************************************************/
+#include "build.auto.h"
+
+#include <string.h>
+
+#include <openssl/evp.h>
+
+#include "common/crypto/cipherBlock.h"
+#include "common/crypto/cipherFrame.h"
+#include "common/debug.h"
+#include "common/log.h"
+#include "common/thread.h"
+#include "common/type/object.h"
+
+/***********************************************************************************************************************************
+Header constants and sizes
+***********************************************************************************************************************************/
+// Key and initialization vector sizes for AES-256-GCM
+#define CIPHER_FRAME_KEY_SIZE                                       32
+#define CIPHER_FRAME_IV_SIZE                                        12
+
+// Max header size
+#define CIPHER_FRAME_HEADER_SIZE                                    (CIPHER_FRAME_MAGIC_SIZE + CIPHER_FRAME_SALT_SIZE)
+
+/***********************************************************************************************************************************
+Object type
+***********************************************************************************************************************************/
+typedef struct CipherFrame
+{
+    CipherMode mode;                                                // Mode encrypt/decrypt
+    bool raw;                                                       // Omit header magic to save space
+    unsigned int threadMax;                                         // Max threads used to process frames
+    const Buffer *pass;                                             // Passphrase used to generate encryption key
+    size_t headerSize;                                              // Size of header read during decrypt
+    unsigned char header[CIPHER_FRAME_HEADER_SIZE];                 // Buffer to hold partial header during decrypt
+    unsigned char initVector[CIPHER_FRAME_IV_SIZE];                 // Initialization vector combined with the frame index
+    EVP_CIPHER_CTX **contextList;                                   // Encrypt/decrypt context for each thread
+    uint64_t frameIdx;                                              // Index of the next frame to process
+
+    Buffer *input;                                                  // Frames waiting to be processed
+    size_t inputOffset;                                             // Offset of the next byte to read from source
+    Buffer *output;                                                 // Processed frames waiting to be copied to destination
+    size_t outputOffset;                                            // Offset of the next byte to copy to destination
+    bool inputSame;                                                 // Is the same input required on next process call?
+    bool flushDone;                                                 // Have the final frames been processed?
+    bool done;                                                      // Is processing done?
+} CipherFrame;
+
+/***********************************************************************************************************************************
+Macros for function logging
+***********************************************************************************************************************************/
+FN_EXTERN void
+cipherFrameToLog(const CipherFrame *const this, StringStatic *const debugLog)
+{
+    strStcFmt(
+        debugLog, "{frameIdx: %" PRIu64 ", inputSame: %s, done: %s}", this->frameIdx, cvtBoolToConstZ(this->inputSame),
+        cvtBoolToConstZ(this->done));
+}
+
+#define FUNCTION_LOG_CIPHER_FRAME_TYPE                                                                                             \
+    CipherFrame *
+#define FUNCTION_LOG_CIPHER_FRAME_FORMAT(value, buffer, bufferSize)                                                                \
+    FUNCTION_LOG_OBJECT_FORMAT(value, cipherFrameToLog, buffer, bufferSize)
+
+/***********************************************************************************************************************************
+Free cipher contexts
+***********************************************************************************************************************************/
+static void
+cipherFrameFreeResource(THIS_VOID)
+{
+    THIS(CipherFrame);
+
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(CIPHER_FRAME, this);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+
+    for (unsigned int contextIdx = 0; contextIdx < this->threadMax; contextIdx++)
+        EVP_CIPHER_CTX_free(this->contextList[contextIdx]);
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Check the magic in the header. If it does not match then this is not data encrypted with frames, or at least not in a format we
+recognize.
+***********************************************************************************************************************************/
+static void
+cipherFrameHeaderCheck(const unsigned char *const header)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(UCHARDATA, header);
+    FUNCTION_TEST_END();
+
+    ASSERT(header != NULL);
+
+    if (memcmp(header, CIPHER_FRAME_MAGIC, CIPHER_FRAME_MAGIC_SIZE) != 0)
+    {
+        // Give a more useful error when the data was encrypted with a block cipher
+        if (memcmp(header, CIPHER_BLOCK_MAGIC, CIPHER_BLOCK_MAGIC_SIZE) == 0)
+            THROW(CryptoError, "cipher header invalid: data is encrypted with aes-256-cbc");
+
+        THROW(CryptoError, "cipher header invalid");
+    }
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Generate the key and initialization vector from the salt and create a context for each thread
+***********************************************************************************************************************************/
+static void
+cipherFrameInit(CipherFrame *const this, const unsigned char *const salt)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(CIPHER_FRAME, this);
+        FUNCTION_LOG_PARAM_P(UCHARDATA, salt);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(this->contextList == NULL);
+    ASSERT(salt != NULL);
+
+    // Generate key and initialization vector. The salt is random for each file so every file has a unique key.
+    unsigned char keyInitVector[CIPHER_FRAME_KEY_SIZE + CIPHER_FRAME_IV_SIZE];
+
+    cryptoError(
+        !PKCS5_PBKDF2_HMAC(
+            (const char *)bufPtrConst(this->pass), (int)bufSize(this->pass), salt, CIPHER_FRAME_SALT_SIZE, 1, EVP_sha256(),
+            sizeof(keyInitVector), keyInitVector),
+        "unable to generate key");
+
+    memcpy(this->initVector, keyInitVector + CIPHER_FRAME_KEY_SIZE, CIPHER_FRAME_IV_SIZE);
+
+    // Create a context for each thread. The key is set once and the initialization vector is set for each frame.
+    MEM_CONTEXT_OBJ_BEGIN(this)
+    {
+        this->contextList = memNew(sizeof(EVP_CIPHER_CTX *) * this->threadMax);
+        memset(this->contextList, 0, sizeof(EVP_CIPHER_CTX *) * this->threadMax);
+    }
+    MEM_CONTEXT_OBJ_END();
+
+    // Set free callback to ensure cipher contexts are freed
+    memContextCallbackSet(objMemContext(this), cipherFrameFreeResource, this);
+
+    for (unsigned int contextIdx = 0; contextIdx < this->threadMax; contextIdx++)
+    {
+        cryptoError(!(this->contextList[contextIdx] = EVP_CIPHER_CTX_new()), "unable to create context");
+        cryptoError(
+            !EVP_CipherInit_ex(
+                this->contextList[contextIdx], EVP_aes_256_gcm(), NULL, keyInitVector, NULL, this->mode == cipherModeEncrypt),
+            "unable to initialize cipher");
+    }
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Frames are processed in jobs so they can be split between threads
+***********************************************************************************************************************************/
+typedef struct CipherFrameJob
+{
+    EVP_CIPHER_CTX *context;                                        // Context for the thread
+    bool encrypt;                                                   // Encrypt or decrypt?
+    const unsigned char *initVector;                                // Initialization vector to combine with the frame index
+    uint64_t frameIdx;                                              // Index of the first frame
+    unsigned int frameTotal;                                        // Total frames to process
+    bool final;                                                     // Is the last frame the final frame?
+    const unsigned char *source;                                    // Frames to process
+    size_t sourceSize;                                              // Size of frames to process
+    unsigned char *destination;                                     // Processed frames
+    bool error;                                                     // Did processing fail?
+} CipherFrameJob;
+
+/***********************************************************************************************************************************
+Encrypt/decrypt frames. This may run on a worker thread so nothing called here may use mem contexts, logging, or error handling,
+which is why the debug macros are not used.
+***********************************************************************************************************************************/
+static void *
+cipherFrameJob(void *const param)
+{
+    CipherFrameJob *const job = param;
+    const unsigned char *source = job->source;
+    size_t sourceRemains = job->sourceSize;
+    unsigned char *destination = job->destination;
+
+    for (unsigned int frameIdx = 0; frameIdx < job->frameTotal && !job->error; frameIdx++)
+    {
+        // Determine the size of the frame and the data it contains
+        const size_t frameSizeMax = job->encrypt ? CIPHER_FRAME_SIZE : CIPHER_FRAME_SIZE + CIPHER_FRAME_TAG_SIZE;
+        const size_t frameSize = sourceRemains < frameSizeMax ? sourceRemains : frameSizeMax;
+        const size_t dataSize = job->encrypt ? frameSize : frameSize - CIPHER_FRAME_TAG_SIZE;
+
+        // The nonce is the initialization vector with the frame index in the last bytes. Since the key is unique for each file the
+        // nonce is never reused for the same key.
+        unsigned char initVector[CIPHER_FRAME_IV_SIZE];
+        const uint64_t frameIdxNonce = job->frameIdx + frameIdx;
+
+        memcpy(initVector, job->initVector, CIPHER_FRAME_IV_SIZE);
+
+        for (unsigned int byteIdx = 0; byteIdx < sizeof(uint64_t); byteIdx++)
+            initVector[CIPHER_FRAME_IV_SIZE - 1 - byteIdx] ^= (unsigned char)(frameIdxNonce >> (byteIdx * 8));
+
+        // Authenticate whether this is the final frame so truncation is detected
+        const unsigned char final = job->final && frameIdx == job->frameTotal - 1;
+        int updateSize;
+
+        if (!EVP_CipherInit_ex(job->context, NULL, NULL, NULL, initVector, -1) ||
+            !EVP_CipherUpdate(job->context, NULL, &updateSize, &final, 1) ||
+            (dataSize > 0 && !EVP_CipherUpdate(job->context, destination, &updateSize, source, (int)dataSize)))
+        {
+            job->error = true;
+        }
+        // Add the tag after the data on encrypt
+        else if (job->encrypt)
+        {
+            job->error =
+                !EVP_CipherFinal_ex(job->context, destination + dataSize, &updateSize) ||
+                !EVP_CIPHER_CTX_ctrl(job->context, EVP_CTRL_GCM_GET_TAG, CIPHER_FRAME_TAG_SIZE, destination + dataSize);
+
+            destination += dataSize + CIPHER_FRAME_TAG_SIZE;
+        }
+        // Else check the tag after the data on decrypt
+        else
+        {
+            job->error =
+                !EVP_CIPHER_CTX_ctrl(job->context, EVP_CTRL_GCM_SET_TAG, CIPHER_FRAME_TAG_SIZE, (void *)(source + dataSize)) ||
+                !EVP_CipherFinal_ex(job->context, destination + dataSize, &updateSize);
+
+            destination += dataSize;
+        }
+
+        source += frameSize;
+        sourceRemains -= frameSize;
+    }
+
+    return NULL;
+}
+
+/***********************************************************************************************************************************
+Process the frames in the input buffer, splitting them between threads when there is more than one frame and more than one thread
+is allowed
+***********************************************************************************************************************************/
+static void
+cipherFrameProcessFrame(CipherFrame *const this, const bool final)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(CIPHER_FRAME, this);
+        FUNCTION_LOG_PARAM(BOOL, final);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(this->contextList != NULL);
+    ASSERT(bufEmpty(this->output));
+
+    const bool encrypt = this->mode == cipherModeEncrypt;
+    const size_t frameSizeMax = encrypt ? CIPHER_FRAME_SIZE : CIPHER_FRAME_SIZE + CIPHER_FRAME_TAG_SIZE;
+    const size_t sourceSize = bufUsed(this->input);
+
+    // There is always at least one frame, even when there is no data
+    const unsigned int frameTotal = sourceSize == 0 ? 1 : (unsigned int)((sourceSize + frameSizeMax - 1) / frameSizeMax);
+
+    // The final frame must at least contain the tag
+    if (!encrypt && sourceSize - (frameTotal - 1) * frameSizeMax < CIPHER_FRAME_TAG_SIZE)
+        THROW(CryptoError, "cipher frame truncated");
+
+    // Make sure there is room for the processed frames in the output buffer
+    const size_t destinationSize = encrypt ?
+        sourceSize + frameTotal * CIPHER_FRAME_TAG_SIZE : sourceSize - frameTotal * CIPHER_FRAME_TAG_SIZE;
+
+    if (bufSize(this->output) < destinationSize)
+        bufResize(this->output, destinationSize);
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        const unsigned int jobTotal = frameTotal < this->threadMax ? frameTotal : this->threadMax;
+        const unsigned int jobFrameTotal = frameTotal / jobTotal;
+        CipherFrameJob *const jobList = memNew(sizeof(CipherFrameJob) * jobTotal);
+        const unsigned char *source = bufPtrConst(this->input);
+        unsigned char *destination = bufPtr(this->output);
+        size_t sourceRemains = sourceSize;
+
+        for (unsigned int jobIdx = 0; jobIdx < jobTotal; jobIdx++)
+        {
+            const unsigned int frameJobTotal = jobIdx == jobTotal - 1 ? frameTotal - jobIdx * jobFrameTotal : jobFrameTotal;
+            const size_t jobSourceSize = jobIdx == jobTotal - 1 ? sourceRemains : frameJobTotal * frameSizeMax;
+
+            jobList[jobIdx] = (CipherFrameJob)
+            {
+                .context = this->contextList[jobIdx],
+                .encrypt = encrypt,
+                .initVector = this->initVector,
+                .frameIdx = this->frameIdx + jobIdx * jobFrameTotal,
+                .frameTotal = frameJobTotal,
+                .final = final && jobIdx == jobTotal - 1,
+                .source = source,
+                .sourceSize = jobSourceSize,
+                .destination = destination,
+            };
+
+            source += jobSourceSize;
+            sourceRemains -= jobSourceSize;
+            destination += encrypt ?
+                jobSourceSize + frameJobTotal * CIPHER_FRAME_TAG_SIZE : jobSourceSize - frameJobTotal * CIPHER_FRAME_TAG_SIZE;
+        }
+
+        // Process jobs with all but the first job on worker threads
+        threadJobRun(cipherFrameJob, jobList, sizeof(CipherFrameJob), jobTotal);
+
+        // Errors can only be reported once all jobs are complete
+        for (unsigned int jobIdx = 0; jobIdx < jobTotal; jobIdx++)
+        {
+            if (jobList[jobIdx].error)
+            {
+                THROW_FMT(
+                    CryptoError, "unable to %s frame %" PRIu64 "-%" PRIu64, encrypt ? "encrypt" : "authenticate",
+                    jobList[jobIdx].frameIdx, jobList[jobIdx].frameIdx + jobList[jobIdx].frameTotal - 1);
+            }
+        }
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    bufUsedSet(this->output, destinationSize);
+    bufUsedZero(this->input);
+    this->frameIdx += frameTotal;
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Copy processed frames to the destination
+***********************************************************************************************************************************/
+static void
+cipherFrameOutput(CipherFrame *const this, Buffer *const destination)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(CIPHER_FRAME, this);
+        FUNCTION_TEST_PARAM(BUFFER, destination);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+    ASSERT(destination != NULL);
+
+    const size_t catSize =
+        bufUsed(this->output) - this->outputOffset < bufRemains(destination) ?
+            bufUsed(this->output) - this->outputOffset : bufRemains(destination);
+
+    bufCatSub(destination, this->output, this->outputOffset, catSize);
+    this->outputOffset += catSize;
+
+    // Reset the output buffer once all frames have been copied
+    if (this->outputOffset == bufUsed(this->output))
+    {
+        bufUsedZero(this->output);
+        this->outputOffset = 0;
+    }
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Process function used by C filter
+***********************************************************************************************************************************/
+static void
+cipherFrameProcess(THIS_VOID, const Buffer *const source, Buffer *const destination)
+{
+    THIS(CipherFrame);
+
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(CIPHER_FRAME, this);
+        FUNCTION_LOG_PARAM(BUFFER, source);
+        FUNCTION_LOG_PARAM(BUFFER, destination);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(destination != NULL);
+    ASSERT(bufRemains(destination) > 0);
+
+    // Copy frames already processed
+    cipherFrameOutput(this, destination);
+
+    // Flush the remaining frames. The last frame is final.
+    if (source == NULL)
+    {
+        if (bufEmpty(this->output) && !this->flushDone)
+        {
+            if (this->contextList == NULL)
+                THROW(CryptoError, "cipher header missing");
+
+            cipherFrameProcessFrame(this, true);
+            cipherFrameOutput(this, destination);
+
+            this->flushDone = true;
+        }
+
+        this->done = this->flushDone && bufEmpty(this->output);
+    }
+    // Else add source to the input buffer
+    else
+    {
+        while (bufEmpty(this->output) && this->inputOffset < bufUsed(source))
+        {
+            // Read the header on decrypt
+            if (this->contextList == NULL)
+            {
+                ASSERT(this->mode == cipherModeDecrypt);
+
+                const size_t headerExpected = cipherFrameHeaderSize(this->raw);
+                const size_t headerCopy =
+                    headerExpected - this->headerSize < bufUsed(source) - this->inputOffset ?
+                        headerExpected - this->headerSize : bufUsed(source) - this->inputOffset;
+
+                memcpy(this->header + this->headerSize, bufPtrConst(source) + this->inputOffset, headerCopy);
+                this->headerSize += headerCopy;
+                this->inputOffset += headerCopy;
+
+                if (this->headerSize == headerExpected)
+                {
+                    // The first bytes of the data to decrypt should be equal to the magic
+                    if (!this->raw)
+                        cipherFrameHeaderCheck(this->header);
+
+                    cipherFrameInit(this, this->header + (this->raw ? 0 : CIPHER_FRAME_MAGIC_SIZE));
+                }
+            }
+            // Process the frames in the input buffer when it is full. These frames cannot be final since there is more input.
+            else if (bufFull(this->input))
+            {
+                cipherFrameProcessFrame(this, false);
+                cipherFrameOutput(this, destination);
+            }
+            // Else copy source into the input buffer
+            else
+            {
+                const size_t catSize =
+                    bufUsed(source) - this->inputOffset < bufRemains(this->input) ?
+                        bufUsed(source) - this->inputOffset : bufRemains(this->input);
+
+                bufCatSub(this->input, source, this->inputOffset, catSize);
+                this->inputOffset += catSize;
+            }
+        }
+
+        // The same input is required until it has all been copied to the input buffer and the output has been copied
+        this->inputSame = !bufEmpty(this->output) || this->inputOffset < bufUsed(source);
+
+        if (!this->inputSame)
+            this->inputOffset = 0;
+    }
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Is cipher done?
+***********************************************************************************************************************************/
+static bool
+cipherFrameDone(const THIS_VOID)
+{
+    THIS(const CipherFrame);
+
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(CIPHER_FRAME, this);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+
+    FUNCTION_TEST_RETURN(BOOL, this->done);
+}
+
+/***********************************************************************************************************************************
+Should the same input be provided again?
+***********************************************************************************************************************************/
+static bool
+cipherFrameInputSame(const THIS_VOID)
+{
+    THIS(const CipherFrame);
+
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(CIPHER_FRAME, this);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+
+    FUNCTION_TEST_RETURN(BOOL, this->inputSame);
+}
+
+/**********************************************************************************************************************************/
+FN_EXTERN IoFilter *
+cipherFrameNew(const CipherMode mode, const Buffer *const pass, const CipherFrameNewParam param)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(STRING_ID, mode);
+        FUNCTION_TEST_PARAM(BUFFER, pass);                          // Use FUNCTION_TEST so passphrase is not logged
+        FUNCTION_LOG_PARAM(BOOL, param.raw);
+        FUNCTION_LOG_PARAM(UINT, param.threadMax);
+        FUNCTION_LOG_PARAM(BUFFER, param.header);
+        FUNCTION_LOG_PARAM(UINT64, param.frameIdx);
+    FUNCTION_LOG_END();
+
+    ASSERT(pass != NULL);
+    ASSERT(!bufEmpty(pass));
+    ASSERT(param.header == NULL || (mode == cipherModeDecrypt && bufUsed(param.header) == cipherFrameHeaderSize(param.raw)));
+    ASSERT(param.frameIdx == 0 || param.header != NULL);
+
+    // Init crypto subsystem
+    cryptoInit();
+
+    OBJ_NEW_BEGIN(CipherFrame, .childQty = MEM_CONTEXT_QTY_MAX, .allocQty = MEM_CONTEXT_QTY_MAX, .callbackQty = 1)
+    {
+        *this = (CipherFrame)
+        {
+            .mode = mode,
+            .raw = param.raw,
+            .threadMax = param.threadMax == 0 ? 1 : param.threadMax,
+            .pass = bufDup(pass),
+            .frameIdx = param.frameIdx,
+        };
+
+        // OpenSSL before 1.1.0 requires locking callbacks to be used on multiple threads
+#if OPENSSL_VERSION_NUMBER < 0x10100000L
+        this->threadMax = 1;
+#endif
+
+        // Buffer enough frames for each thread to process one
+        this->input = bufNew(
+            this->threadMax * (mode == cipherModeEncrypt ? CIPHER_FRAME_SIZE : CIPHER_FRAME_SIZE + CIPHER_FRAME_TAG_SIZE));
+        this->output = bufNew(this->threadMax * (CIPHER_FRAME_SIZE + CIPHER_FRAME_TAG_SIZE) + CIPHER_FRAME_HEADER_SIZE);
+
+        // On encrypt generate the salt and write the header to the output
+        if (mode == cipherModeEncrypt)
+        {
+            if (!this->raw)
+                bufCat(this->output, BUFSTRDEF(CIPHER_FRAME_MAGIC));
+
+            unsigned char *const salt = bufRemainsPtr(this->output);
+
+            cryptoRandomBytes(salt, CIPHER_FRAME_SALT_SIZE);
+            bufUsedInc(this->output, CIPHER_FRAME_SALT_SIZE);
+
+            cipherFrameInit(this, salt);
+        }
+        // Else on decrypt use the header if it was read separately
+        else if (param.header != NULL)
+        {
+            if (!this->raw)
+                cipherFrameHeaderCheck(bufPtrConst(param.header));
+
+            cipherFrameInit(this, bufPtrConst(param.header) + (this->raw ? 0 : CIPHER_FRAME_MAGIC_SIZE));
+        }
+    }
+    OBJ_NEW_END();
+
+    // Create param list
+    Pack *paramList;
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        PackWrite *const packWrite = pckWriteNewP();
+
+        pckWriteU64P(packWrite, mode);
+        pckWriteBinP(packWrite, pass);
+        pckWriteBoolP(packWrite, param.raw);
+        pckWriteU32P(packWrite, param.threadMax);
+        pckWriteBinP(packWrite, param.header);
+        pckWriteU64P(packWrite, param.frameIdx);
+        pckWriteEndP(packWrite);
+
+        paramList = pckMove(pckWriteResult(packWrite), memContextPrior());
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_LOG_RETURN(
+        IO_FILTER,
+        ioFilterNewP(
+            CIPHER_FRAME_FILTER_TYPE, this, paramList, .done = cipherFrameDone, .inOut = cipherFrameProcess,
+            .inputSame = cipherFrameInputSame));
+}
+
+FN_EXTERN IoFilter *
+cipherFrameNewPack(const Pack *const paramList)
+{
+    IoFilter *result = NULL;
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        PackRead *const paramListPack = pckReadNew(paramList);
+        const CipherMode cipherMode = (CipherMode)pckReadU64P(paramListPack);
+        const Buffer *const pass = pckReadBinP(paramListPack);
+        const bool raw = pckReadBoolP(paramListPack);
+        const unsigned int threadMax = pckReadU32P(paramListPack);
+        const Buffer *const header = pckReadBinP(paramListPack);
+        const uint64_t frameIdx = pckReadU64P(paramListPack);
+
+        result = ioFilterMove(
+            cipherFrameNewP(cipherMode, pass, .raw = raw, .threadMax = threadMax, .header = header, .frameIdx = frameIdx),
+            memContextPrior());
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    return result;
+}
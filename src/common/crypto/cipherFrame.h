@@ -0,0 +1,77 @@
+/***********************************************************************************************************************************
+Frame Cipher Header
+
+Authenticated encryption (AES-256-GCM) in fixed size frames. Each frame is encrypted with its own nonce and has its own tag so
+frames can be encrypted/decrypted independently. This allows frames to be processed on multiple threads and allows decryption to
+start at any frame when the header has been read separately, e.g. to read a file from the middle of a bundle.
+
+The format is a header (magic and salt, or only the salt when raw) followed by frames. Each frame contains CIPHER_FRAME_SIZE bytes
+of data except the last, which may contain fewer bytes (or none when there is no data at all). The last frame is authenticated as
+final so truncation at a frame boundary is detected.
+***********************************************************************************************************************************/
+#ifndef COMMON_CRYPTO_CIPHERFRAME_H
+#define COMMON_CRYPTO_CIPHERFRAME_H
+
+#include "common/crypto/common.h"
+#include "common/io/filter/filter.h"
+
+/***********************************************************************************************************************************
+Filter type constant
+***********************************************************************************************************************************/
+#define CIPHER_FRAME_FILTER_TYPE                                   STRID5("cipher-frm", 0x1b236e45441230)
+
+/***********************************************************************************************************************************
+Frame and header sizes
+***********************************************************************************************************************************/
+// Size of the data in a frame (except the last frame, which may be smaller)
+#define CIPHER_FRAME_SIZE                                           ((size_t)64 * 1024)
+
+// Size of the authentication tag appended to each frame
+#define CIPHER_FRAME_TAG_SIZE                                       16
+
+// Magic constant to identify frame encrypted data
+#define CIPHER_FRAME_MAGIC                                          "PgBRgcm1"
+
+// Size of the salt and magic in the header
+#define CIPHER_FRAME_SALT_SIZE                                      16
+#define CIPHER_FRAME_MAGIC_SIZE                                     8
+
+// Max threads used to process frames when io-thread is enabled
+#define CIPHER_FRAME_THREAD_MAX                                     4
+
+/***********************************************************************************************************************************
+Constructors
+***********************************************************************************************************************************/
+typedef struct CipherFrameNewParam
+{
+    VAR_PARAM_HEADER;
+    bool raw;                                                       // Omit header magic to save space
+    unsigned int threadMax;                                         // Max threads used to process frames (defaults to 1)
+    const Buffer *header;                                           // Header read separately (decrypt starts at frameIdx)
+    uint64_t frameIdx;                                              // Frame to start decrypting at (requires header)
+} CipherFrameNewParam;
+
+#define cipherFrameNewP(mode, pass, ...)                                                                                           \
+    cipherFrameNew(mode, pass, (CipherFrameNewParam){VAR_PARAM_INIT, __VA_ARGS__})
+
+FN_EXTERN IoFilter *cipherFrameNew(CipherMode mode, const Buffer *pass, CipherFrameNewParam param);
+FN_EXTERN IoFilter *cipherFrameNewPack(const Pack *paramList);
+
+/***********************************************************************************************************************************
+Functions
+***********************************************************************************************************************************/
+// Size of the header
+FN_INLINE_ALWAYS size_t
+cipherFrameHeaderSize(const bool raw)
+{
+    return (raw ? 0 : CIPHER_FRAME_MAGIC_SIZE) + CIPHER_FRAME_SALT_SIZE;
+}
+
+// Offset of a frame in encrypted data. The frame contains the data starting at frameIdx * CIPHER_FRAME_SIZE.
+FN_INLINE_ALWAYS uint64_t
+cipherFrameOffset(const uint64_t frameIdx, const bool raw)
+{
+    return cipherFrameHeaderSize(raw) + frameIdx * (CIPHER_FRAME_SIZE + CIPHER_FRAME_TAG_SIZE);
+}
+
+#endif
@@ -0,0 +1,248 @@
+/***********************************************************************************************************************************
+I/O Event Loop
+***********************************************************************************************************************************/
+#include "build.auto.h"
+
+#ifdef __sun__                                                      // Illumos needs sys/siginfo for sigset_t inside poll.h
+#include <sys/siginfo.h>
+#endif
+#include <poll.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#define IO_EVENT_EPOLL
+#include <sys/epoll.h>
+#endif
+
+#include "common/debug.h"
+#include "common/io/event.h"
+#include "common/log.h"
+#include "common/type/list.h"
+
+/***********************************************************************************************************************************
+Max ready file descriptors returned by a single epoll_wait(). Any others that are ready will be returned by the next wait.
+***********************************************************************************************************************************/
+#define IO_EVENT_EPOLL_READY_MAX                                    64
+
+/***********************************************************************************************************************************
+Object type
+***********************************************************************************************************************************/
+struct IoEvent
+{
+    IoEventPub pub;                                                 // Publicly accessible variables
+    bool epoll;                                                     // Use epoll()? Else use poll().
+    int epollFd;                                                    // epoll file descriptor
+    List *pollList;                                                 // File descriptors for poll()
+    List *idList;                                                   // Ids for poll() in the same order as pollList
+    unsigned int *readyList;                                        // Ids of file descriptors ready after the last wait
+    unsigned int readyTotal;                                        // Total file descriptors ready after the last wait
+    unsigned int readyMax;                                          // Size of the ready list
+};
+
+/***********************************************************************************************************************************
+Close the epoll file descriptor
+***********************************************************************************************************************************/
+#ifdef IO_EVENT_EPOLL
+
+static void
+ioEventFreeResource(THIS_VOID)
+{
+    THIS(IoEvent);
+
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(IO_EVENT, this);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+
+    close(this->epollFd);
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+#endif // IO_EVENT_EPOLL
+
+/**********************************************************************************************************************************/
+FN_EXTERN IoEvent *
+ioEventNew(void)
+{
+    FUNCTION_LOG_VOID(logLevelTrace);
+
+    OBJ_NEW_BEGIN(IoEvent, .childQty = MEM_CONTEXT_QTY_MAX, .allocQty = 1, .callbackQty = 1)
+    {
+        *this = (IoEvent)
+        {
+            .epollFd = -1,
+            .pollList = lstNewP(sizeof(struct pollfd)),
+            .idList = lstNewP(sizeof(unsigned int)),
+        };
+
+#ifdef IO_EVENT_EPOLL
+        THROW_ON_SYS_ERROR((this->epollFd = epoll_create1(EPOLL_CLOEXEC)) == -1, KernelError, "unable to create epoll");
+        this->epoll = true;
+
+        // Ensure file descriptor is closed
+        memContextCallbackSet(objMemContext(this), ioEventFreeResource, this);
+#endif
+    }
+    OBJ_NEW_END();
+
+    FUNCTION_LOG_RETURN(IO_EVENT, this);
+}
+
+/**********************************************************************************************************************************/
+FN_EXTERN void
+ioEventAdd(IoEvent *const this, const int fd, const unsigned int id)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(IO_EVENT, this);
+        FUNCTION_LOG_PARAM(INT, fd);
+        FUNCTION_LOG_PARAM(UINT, id);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(fd >= 0);
+
+#ifdef IO_EVENT_EPOLL
+    if (this->epoll)
+    {
+        struct epoll_event event = {.events = EPOLLIN, .data.u32 = id};
+
+        THROW_ON_SYS_ERROR_FMT(
+            epoll_ctl(this->epollFd, EPOLL_CTL_ADD, fd, &event) == -1, KernelError, "unable to add fd %d to epoll", fd);
+    }
+    else
+#endif
+    {
+        lstAdd(this->pollList, &(struct pollfd){.fd = fd, .events = POLLIN});
+        lstAdd(this->idList, &id);
+    }
+
+    this->pub.fdTotal++;
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+/**********************************************************************************************************************************/
+FN_EXTERN void
+ioEventRemove(IoEvent *const this, const int fd)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(IO_EVENT, this);
+        FUNCTION_LOG_PARAM(INT, fd);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(fd >= 0);
+
+#ifdef IO_EVENT_EPOLL
+    if (this->epoll)
+    {
+        THROW_ON_SYS_ERROR_FMT(
+            epoll_ctl(this->epollFd, EPOLL_CTL_DEL, fd, NULL) == -1, KernelError, "unable to remove fd %d from epoll", fd);
+    }
+    else
+#endif
+    {
+        unsigned int pollIdx = 0;
+
+        for (; pollIdx < lstSize(this->pollList); pollIdx++)
+        {
+            if (((struct pollfd *)lstGet(this->pollList, pollIdx))->fd == fd)
+                break;
+        }
+
+        if (pollIdx == lstSize(this->pollList))
+            THROW_FMT(AssertError, "unable to find fd %d", fd);
+
+        lstRemoveIdx(this->pollList, pollIdx);
+        lstRemoveIdx(this->idList, pollIdx);
+    }
+
+    this->pub.fdTotal--;
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+/**********************************************************************************************************************************/
+FN_EXTERN unsigned int
+ioEventWait(IoEvent *const this, const TimeMSec timeout)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(IO_EVENT, this);
+        FUNCTION_LOG_PARAM(TIME_MSEC, timeout);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(timeout < INT_MAX);
+
+    // Make sure there is room for every file descriptor to be ready
+    if (this->readyMax < this->pub.fdTotal)
+    {
+        MEM_CONTEXT_OBJ_BEGIN(this)
+        {
+            this->readyMax = this->pub.fdTotal;
+            this->readyList =
+                this->readyList == NULL ?
+                    memNew(this->readyMax * sizeof(unsigned int)) :
+                    memResize(this->readyList, this->readyMax * sizeof(unsigned int));
+        }
+        MEM_CONTEXT_OBJ_END();
+    }
+
+    this->readyTotal = 0;
+
+#ifdef IO_EVENT_EPOLL
+    if (this->epoll)
+    {
+        struct epoll_event eventList[IO_EVENT_EPOLL_READY_MAX];
+        const int result = epoll_wait(this->epollFd, eventList, IO_EVENT_EPOLL_READY_MAX, (int)timeout);
+
+        // An interrupt is reported as a timeout since the caller must already handle that
+        THROW_ON_SYS_ERROR(result == -1 && errno != EINTR, KernelError, "unable to wait on epoll");
+
+        for (int eventIdx = 0; eventIdx < result; eventIdx++)
+            this->readyList[this->readyTotal++] = eventList[eventIdx].data.u32;
+    }
+    else
+#endif
+    {
+        struct pollfd *const pollList = lstEmpty(this->pollList) ? NULL : lstGet(this->pollList, 0);
+        const int result = poll(pollList, lstSize(this->pollList), (int)timeout);
+
+        // An interrupt is reported as a timeout since the caller must already handle that
+        THROW_ON_SYS_ERROR(result == -1 && errno != EINTR, KernelError, "unable to poll");
+
+        for (unsigned int pollIdx = 0; result > 0 && pollIdx < lstSize(this->pollList); pollIdx++)
+        {
+            if (pollList[pollIdx].revents != 0)
+                this->readyList[this->readyTotal++] = *(unsigned int *)lstGet(this->idList, pollIdx);
+        }
+    }
+
+    FUNCTION_LOG_RETURN(UINT, this->readyTotal);
+}
+
+/**********************************************************************************************************************************/
+FN_EXTERN unsigned int
+ioEventReadyId(const IoEvent *const this, const unsigned int readyIdx)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(IO_EVENT, this);
+        FUNCTION_TEST_PARAM(UINT, readyIdx);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+    ASSERT(readyIdx < this->readyTotal);
+
+    FUNCTION_TEST_RETURN(UINT, this->readyList[readyIdx]);
+}
+
+/**********************************************************************************************************************************/
+FN_EXTERN void
+ioEventToLog(const IoEvent *const this, StringStatic *const debugLog)
+{
+    strStcFmt(
+        debugLog, "{type: %s, fdTotal: %u, readyTotal: %u}", this->epoll ? "epoll" : "poll", ioEventFdTotal(this),
+        this->readyTotal);
+}
@@ -0,0 +1,76 @@
+/***********************************************************************************************************************************
+I/O Event Loop
+
+Wait for any of a set of file descriptors to be ready to read. Each file descriptor is added with an id that the caller uses to find
+the object (e.g. a client) that owns it when the file descriptor is ready.
+
+epoll() is used where available so the cost of a wait depends on the number of ready file descriptors rather than the number being
+watched and there is no limit on the file descriptor number, as there is with select(). Otherwise poll() is used.
+***********************************************************************************************************************************/
+#ifndef COMMON_IO_EVENT_H
+#define COMMON_IO_EVENT_H
+
+/***********************************************************************************************************************************
+Object type
+***********************************************************************************************************************************/
+typedef struct IoEvent IoEvent;
+
+#include "common/time.h"
+#include "common/type/object.h"
+
+/***********************************************************************************************************************************
+Constructors
+***********************************************************************************************************************************/
+FN_EXTERN IoEvent *ioEventNew(void);
+
+/***********************************************************************************************************************************
+Getters/Setters
+***********************************************************************************************************************************/
+typedef struct IoEventPub
+{
+    unsigned int fdTotal;                                           // Total file descriptors being watched
+} IoEventPub;
+
+// Total file descriptors being watched
+FN_INLINE_ALWAYS unsigned int
+ioEventFdTotal(const IoEvent *const this)
+{
+    return THIS_PUB(IoEvent)->fdTotal;
+}
+
+/***********************************************************************************************************************************
+Functions
+***********************************************************************************************************************************/
+// Watch a file descriptor. The id will be returned by ioEventReadyId() when the file descriptor is ready to read.
+FN_EXTERN void ioEventAdd(IoEvent *this, int fd, unsigned int id);
+
+// Stop watching a file descriptor. This must be done before the file descriptor is closed.
+FN_EXTERN void ioEventRemove(IoEvent *this, int fd);
+
+// Wait until at least one file descriptor is ready or timeout and return the number of ready file descriptors. An end of file or
+// error on the file descriptor is reported as ready so the caller will get the error on read.
+FN_EXTERN unsigned int ioEventWait(IoEvent *this, TimeMSec timeout);
+
+// Id of a file descriptor that was reported ready by the last ioEventWait()
+FN_EXTERN unsigned int ioEventReadyId(const IoEvent *this, unsigned int readyIdx);
+
+/***********************************************************************************************************************************
+Destructor
+***********************************************************************************************************************************/
+FN_INLINE_ALWAYS void
+ioEventFree(IoEvent *const this)
+{
+    objFree(this);
+}
+
+/***********************************************************************************************************************************
+Macros for function logging
+***********************************************************************************************************************************/
+FN_EXTERN void ioEventToLog(const IoEvent *this, StringStatic *debugLog);
+
+#define FUNCTION_LOG_IO_EVENT_TYPE                                                                                                 \
+    IoEvent *
+#define FUNCTION_LOG_IO_EVENT_FORMAT(value, buffer, bufferSize)                                                                    \
+    FUNCTION_LOG_OBJECT_FORMAT(value, ioEventToLog, buffer, bufferSize)
+
+#endif
@@ -0,0 +1,315 @@
+/***********************************************************************************************************************************
+HTTP Range Read
+***********************************************************************************************************************************/
+#include "build.auto.h"
+
+#include "common/debug.h"
+#include "common/io/http/rangeRead.h"
+#include "common/log.h"
+#include "common/type/convert.h"
+#include "common/type/list.h"
+
+/***********************************************************************************************************************************
+Object type
+***********************************************************************************************************************************/
+struct HttpRangeRead
+{
+    HttpRangeReadNewParam param;                                    // Chunk size, request max, and callbacks
+    HttpResponse *response;                                         // Response currently being read
+    bool range;                                                     // Are ranged requests being used?
+    uint64_t size;                                                  // Total content size (when ranged requests are used)
+    uint64_t readOffset;                                            // Content read so far
+    uint64_t requestOffset;                                         // Offset of the next ranged request
+    uint64_t responseRemains;                                       // Content remaining in the current chunk
+    bool responseRetry;                                             // Has the current chunk been requested again?
+    List *requestList;                                              // Ranged requests in progress, oldest first
+};
+
+/***********************************************************************************************************************************
+Size of the content in a response or NULL when it is not known
+***********************************************************************************************************************************/
+static const String *
+httpRangeReadContentSize(const HttpResponse *const response)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(HTTP_RESPONSE, response);
+    FUNCTION_TEST_END();
+
+    ASSERT(response != NULL);
+
+    FUNCTION_TEST_RETURN_CONST(STRING, httpHeaderGet(httpResponseHeader(response), HTTP_HEADER_CONTENT_LENGTH_STR));
+}
+
+/***********************************************************************************************************************************
+Make sure the server returned the requested range and not the entire content
+***********************************************************************************************************************************/
+static void
+httpRangeReadContentSizeCheck(const HttpResponse *const response, const uint64_t expectedSize)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(HTTP_RESPONSE, response);
+        FUNCTION_TEST_PARAM(UINT64, expectedSize);
+    FUNCTION_TEST_END();
+
+    ASSERT(response != NULL);
+
+    const String *const contentSize = httpRangeReadContentSize(response);
+
+    if (contentSize == NULL || cvtZToUInt64(strZ(contentSize)) != expectedSize)
+    {
+        THROW_FMT(
+            ProtocolError, "expected range response content size %" PRIu64 " but got %s", expectedSize,
+            contentSize == NULL ? "unknown" : strZ(contentSize));
+    }
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Send ranged requests until the max are in progress or all content has been requested
+***********************************************************************************************************************************/
+static void
+httpRangeReadRequest(HttpRangeRead *const this)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(HTTP_RANGE_READ, this);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(this->range);
+
+    // The response being read counts as a request in progress
+    while (lstSize(this->requestList) + 1 < this->param.requestMax && this->requestOffset < this->size)
+    {
+        const uint64_t requestSize = this->size - this->requestOffset < this->param.chunkSize ?
+            this->size - this->requestOffset : this->param.chunkSize;
+
+        MEM_CONTEXT_BEGIN(lstMemContext(this->requestList))
+        {
+            HttpRequest *const request = this->param.requestCallback(this->param.callbackData, this->requestOffset, requestSize);
+            lstAdd(this->requestList, &request);
+        }
+        MEM_CONTEXT_END();
+
+        this->requestOffset += requestSize;
+    }
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Switch to the response for the next chunk
+***********************************************************************************************************************************/
+static void
+httpRangeReadNext(HttpRangeRead *const this)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(HTTP_RANGE_READ, this);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(this->range);
+    ASSERT(this->responseRemains == 0);
+    ASSERT(!lstEmpty(this->requestList));
+
+    // Free the prior response. If it was the first response then it still has unread content so the session will be closed rather
+    // than reused.
+    httpResponseFree(this->response);
+    this->response = NULL;
+
+    // Get the response for the oldest request
+    HttpRequest *const request = *(HttpRequest **)lstGet(this->requestList, 0);
+
+    MEM_CONTEXT_OBJ_BEGIN(this)
+    {
+        this->response = this->param.responseCallback(this->param.callbackData, request);
+    }
+    MEM_CONTEXT_OBJ_END();
+
+    httpRequestFree(request);
+    lstRemoveIdx(this->requestList, 0);
+
+    // Make sure the server returned the requested range and not the entire content
+    const uint64_t expectedSize = this->size - this->readOffset < this->param.chunkSize ?
+        this->size - this->readOffset : this->param.chunkSize;
+
+    httpRangeReadContentSizeCheck(this->response, expectedSize);
+
+    this->responseRemains = expectedSize;
+    this->responseRetry = false;
+
+    // Replace the request that was just completed
+    httpRangeReadRequest(this);
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Request the rest of the current chunk again after a read error. The response to a ranged request may wait unread on a connection
+while earlier chunks are read, so the server may time out and close the connection before the content is read. The new request is
+read right away so it is only retried once.
+***********************************************************************************************************************************/
+static void
+httpRangeReadRetry(HttpRangeRead *const this)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(HTTP_RANGE_READ, this);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(this->range);
+    ASSERT(this->responseRemains > 0);
+    ASSERT(!this->responseRetry);
+
+    httpResponseFree(this->response);
+    this->response = NULL;
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        HttpRequest *const request = this->param.requestCallback(this->param.callbackData, this->readOffset, this->responseRemains);
+
+        MEM_CONTEXT_OBJ_BEGIN(this)
+        {
+            this->response = this->param.responseCallback(this->param.callbackData, request);
+        }
+        MEM_CONTEXT_OBJ_END();
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    httpRangeReadContentSizeCheck(this->response, this->responseRemains);
+    this->responseRetry = true;
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+/**********************************************************************************************************************************/
+FN_EXTERN HttpRangeRead *
+httpRangeReadNew(HttpResponse *const response, const HttpRangeReadNewParam param)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(HTTP_RESPONSE, response);
+        FUNCTION_LOG_PARAM(SIZE, param.chunkSize);
+        FUNCTION_LOG_PARAM(UINT, param.requestMax);
+        FUNCTION_LOG_PARAM(FUNCTIONP, param.requestCallback);
+        FUNCTION_LOG_PARAM(FUNCTIONP, param.responseCallback);
+        FUNCTION_LOG_PARAM_P(VOID, param.callbackData);
+    FUNCTION_LOG_END();
+
+    ASSERT(response != NULL);
+    ASSERT(param.requestMax <= 1 || (param.chunkSize > 0 && param.requestCallback != NULL && param.responseCallback != NULL));
+
+    OBJ_NEW_BEGIN(HttpRangeRead, .childQty = MEM_CONTEXT_QTY_MAX)
+    {
+        *this = (HttpRangeRead)
+        {
+            .param = param,
+            .response = httpResponseMove(response, objMemContext(this)),
+        };
+
+        // Use ranged requests when the content is known to be larger than a chunk
+        const String *const contentSize = httpRangeReadContentSize(response);
+
+        if (param.requestMax > 1 && contentSize != NULL)
+        {
+            this->size = cvtZToUInt64(strZ(contentSize));
+
+            if (this->size > param.chunkSize)
+            {
+                this->range = true;
+                this->requestList = lstNewP(sizeof(HttpRequest *));
+                this->requestOffset = param.chunkSize;
+                this->responseRemains = param.chunkSize;
+
+                httpRangeReadRequest(this);
+            }
+        }
+    }
+    OBJ_NEW_END();
+
+    FUNCTION_LOG_RETURN(HTTP_RANGE_READ, this);
+}
+
+/**********************************************************************************************************************************/
+FN_EXTERN size_t
+httpRangeReadRead(HttpRangeRead *const this, Buffer *const buffer)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(HTTP_RANGE_READ, this);
+        FUNCTION_LOG_PARAM(BUFFER, buffer);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(buffer != NULL && !bufFull(buffer));
+
+    volatile size_t result = 0;                                     // Must be preserved when a read error is retried
+
+    // Without ranged requests read the response to the end
+    if (!this->range)
+    {
+        result = ioRead(httpResponseIoRead(this->response), buffer);
+    }
+    // Else read chunks in order until the buffer is full or all content has been read
+    else
+    {
+        while (!bufFull(buffer) && this->readOffset < this->size)
+        {
+            if (this->responseRemains == 0)
+                httpRangeReadNext(this);
+
+            // Limit the read to the current chunk since the first response has more content than that
+            const size_t bufferUsed = bufUsed(buffer);
+
+            if (bufRemains(buffer) > this->responseRemains)
+                bufLimitSet(buffer, bufferUsed + (size_t)this->responseRemains);
+
+            TRY_BEGIN()
+            {
+                const size_t actualBytes = ioRead(httpResponseIoRead(this->response), buffer);
+
+                // The content size of the response was checked so the response will error if the server sends less than promised
+                ASSERT(actualBytes > 0);
+
+                this->readOffset += actualBytes;
+                this->responseRemains -= actualBytes;
+                result += actualBytes;
+            }
+            CATCH_ANY()
+            {
+                // Rethrow if the chunk has already been requested again since the error is not caused by a stale response
+                if (this->responseRetry)
+                    RETHROW();
+
+                // Discard any content read by the failed read and request the rest of the chunk again
+                bufUsedSet(buffer, bufferUsed);
+                httpRangeReadRetry(this);
+            }
+            TRY_END();
+
+            bufLimitClear(buffer);
+        }
+    }
+
+    FUNCTION_LOG_RETURN(SIZE, result);
+}
+
+/**********************************************************************************************************************************/
+FN_EXTERN bool
+httpRangeReadEof(HttpRangeRead *const this)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(HTTP_RANGE_READ, this);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+
+    FUNCTION_TEST_RETURN(BOOL, this->range ? this->readOffset == this->size : ioReadEof(httpResponseIoRead(this->response)));
+}
+
+/**********************************************************************************************************************************/
+FN_EXTERN void
+httpRangeReadToLog(const HttpRangeRead *const this, StringStatic *const debugLog)
+{
+    strStcFmt(
+        debugLog, "{range: %s, size: %" PRIu64 ", readOffset: %" PRIu64 ", requestTotal: %u}", cvtBoolToConstZ(this->range),
+        this->size, this->readOffset, this->requestList == NULL ? 0 : lstSize(this->requestList));
+}
@@ -0,0 +1,83 @@
+/***********************************************************************************************************************************
+HTTP Range Read
+
+Read the content of a response in chunks using concurrent ranged requests. The first response is read as usual until the end of the
+first chunk, then the rest of the content is read from ranged requests that are sent before they are needed so the latency of each
+request is hidden behind reading the chunks before it. Chunks are always returned in order.
+
+Responses to ranged requests wait unread on their connections until the chunks before them have been read, so the server may time
+out and close a connection first. When reading a chunk fails the rest of the chunk is requested again once.
+
+Ranged requests should be conditional on the first response (e.g. If-Match with its ETag) so that a file replaced during the read
+causes an error rather than content stitched together from two versions.
+
+When fewer than two requests are allowed, the content size is unknown (e.g. chunked encoding), or the content fits in a single chunk
+then the first response is read to the end and no other requests are sent.
+***********************************************************************************************************************************/
+#ifndef COMMON_IO_HTTP_RANGEREAD_H
+#define COMMON_IO_HTTP_RANGEREAD_H
+
+/***********************************************************************************************************************************
+Object type
+***********************************************************************************************************************************/
+typedef struct HttpRangeRead HttpRangeRead;
+
+#include "common/io/http/request.h"
+#include "common/io/http/response.h"
+#include "common/type/object.h"
+
+/***********************************************************************************************************************************
+Callbacks used to send a ranged request and get the response. The offset is relative to the start of the first response content.
+The response must have content that can be read with httpResponseIoRead().
+***********************************************************************************************************************************/
+typedef HttpRequest *HttpRangeReadRequestCallback(void *callbackData, uint64_t offset, uint64_t size);
+typedef HttpResponse *HttpRangeReadResponseCallback(void *callbackData, HttpRequest *request);
+
+/***********************************************************************************************************************************
+Constructors
+***********************************************************************************************************************************/
+typedef struct HttpRangeReadNewParam
+{
+    VAR_PARAM_HEADER;
+    size_t chunkSize;                                               // Size of each ranged request
+    unsigned int requestMax;                                        // Max requests in progress, including the one being read
+    HttpRangeReadRequestCallback *requestCallback;                  // Send a ranged request
+    HttpRangeReadResponseCallback *responseCallback;                // Get the response for a ranged request
+    void *callbackData;                                             // Data passed to callbacks
+} HttpRangeReadNewParam;
+
+#define httpRangeReadNewP(response, ...)                                                                                           \
+    httpRangeReadNew(response, (HttpRangeReadNewParam){VAR_PARAM_INIT, __VA_ARGS__})
+
+// The response is moved to the new object
+FN_EXTERN HttpRangeRead *httpRangeReadNew(HttpResponse *response, HttpRangeReadNewParam param);
+
+/***********************************************************************************************************************************
+Functions
+***********************************************************************************************************************************/
+// Read content into the buffer until it is full or there is no more content. Returns the number of bytes read.
+FN_EXTERN size_t httpRangeReadRead(HttpRangeRead *this, Buffer *buffer);
+
+// Has all content been read?
+FN_EXTERN bool httpRangeReadEof(HttpRangeRead *this);
+
+/***********************************************************************************************************************************
+Destructor
+***********************************************************************************************************************************/
+FN_INLINE_ALWAYS void
+httpRangeReadFree(HttpRangeRead *const this)
+{
+    objFree(this);
+}
+
+/***********************************************************************************************************************************
+Macros for function logging
+***********************************************************************************************************************************/
+FN_EXTERN void httpRangeReadToLog(const HttpRangeRead *this, StringStatic *debugLog);
+
+#define FUNCTION_LOG_HTTP_RANGE_READ_TYPE                                                                                          \
+    HttpRangeRead *
+#define FUNCTION_LOG_HTTP_RANGE_READ_FORMAT(value, buffer, bufferSize)                                                             \
+    FUNCTION_LOG_OBJECT_FORMAT(value, httpRangeReadToLog, buffer, bufferSize)
+
+#endif
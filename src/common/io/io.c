@@ -22,6 +22,9 @@ static size_t bufferSize = (8 * IO_BUFFER_BLOCK_SIZE);
 // I/O timeout in milliseconds
 static TimeMSec timeoutMs = 60000;
 
+// Run filters on worker threads when supported by the filter
+static bool thread = false;
+
 /**********************************************************************************************************************************/
 FN_EXTERN size_t
 ioBufferSize(void)
@@ -62,6 +65,26 @@ ioTimeoutMsSet(const TimeMSec timeoutMsParam)
     FUNCTION_TEST_RETURN_VOID();
 }
 
+/**********************************************************************************************************************************/
+FN_EXTERN bool
+ioThread(void)
+{
+    FUNCTION_TEST_VOID();
+    FUNCTION_TEST_RETURN(BOOL, thread);
+}
+
+FN_EXTERN void
+ioThreadSet(const bool threadParam)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(BOOL, threadParam);
+    FUNCTION_TEST_END();
+
+    thread = threadParam;
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
 /**********************************************************************************************************************************/
 FN_EXTERN Buffer *
 ioReadBuf(IoRead *const read)
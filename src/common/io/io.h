@@ -45,4 +45,8 @@ FN_EXTERN void ioBufferSizeSet(size_t bufferSize);
 FN_EXTERN TimeMSec ioTimeoutMs(void);
 FN_EXTERN void ioTimeoutMsSet(TimeMSec timeout);
 
+// Run filters on worker threads when supported by the filter, e.g. aes-256-gcm frames and WAL record checksums
+FN_EXTERN bool ioThread(void);
+FN_EXTERN void ioThreadSet(bool thread);
+
 #endif
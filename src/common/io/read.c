@@ -427,6 +427,19 @@ ioReadReady(IoRead *const this, const IoReadReadyParam param)
     FUNCTION_LOG_RETURN(BOOL, result);
 }
 
+/**********************************************************************************************************************************/
+FN_EXTERN bool
+ioReadBuffered(const IoRead *const this)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(IO_READ, this);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+
+    FUNCTION_TEST_RETURN(BOOL, this->output != NULL && bufUsed(this->output) > this->outputPos);
+}
+
 /**********************************************************************************************************************************/
 FN_EXTERN uint64_t
 ioReadFlush(IoRead *const this, const IoReadFlushParam param)
@@ -85,6 +85,9 @@ typedef struct IoReadReadyParam
 
 FN_EXTERN bool ioReadReady(IoRead *this, IoReadReadyParam param);
 
+// Are there bytes buffered that can be read without reading from the driver? Buffered bytes are not reported by select() on the fd.
+FN_EXTERN bool ioReadBuffered(const IoRead *this);
+
 // Flush all remaining bytes and return bytes flushed. Optionally error when bytes are flushed.
 typedef struct IoReadFlushParam
 {
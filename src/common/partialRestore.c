@@ -111,6 +111,122 @@ buildFilterList(JsonRead *const json)
     return lstSort(result, sortOrderAsc);
 }
 
+// Relations of the filter are kept in open addressing hash sets with linear probing. Every lookup is a single probe in the common
+// case, no matter how many tables the filter lists. Oid 0 is never valid for a database or a relfilenode (see buildFilterList()) so
+// it marks an empty slot.
+typedef struct Relation
+{
+    Oid dbNode;
+    Oid spcNode;
+    Oid relNode;
+} Relation;
+
+static struct PartialRestoreLocal
+{
+    Oid *dbList;                                                    // Databases in the filter
+    unsigned int dbMask;                                            // Database slot total - 1
+    Relation *relationList;                                         // Tables in the filter
+    unsigned int relationMask;                                      // Relation slot total - 1
+} partialRestoreLocal;
+
+// Slot total is a power of two so the hash can be masked. Keep at least half of the slots empty so probe sequences are short.
+static unsigned int
+filterSetSize(const unsigned int total)
+{
+    unsigned int result = 8;
+
+    while (result < total * 2)
+        result *= 2;
+
+    return result;
+}
+
+// Fibonacci hashing spreads sequential oids, which are typical for relfilenodes, across the whole table
+static inline unsigned int
+filterDbHash(const Oid dbNode)
+{
+    return (unsigned int) ((dbNode * 0x9E3779B97F4A7C15ULL) >> 32);
+}
+
+static inline unsigned int
+filterRelationHash(const Oid dbNode, const Oid spcNode, const Oid relNode)
+{
+    return (unsigned int) (((((uint64_t) dbNode << 32) | relNode) * 0x9E3779B97F4A7C15ULL ^ spcNode * 0xC2B2AE3D27D4EB4FULL) >> 32);
+}
+
+// Build the hash sets from the filter list. A database listed more than once gets the tables of all its entries.
+static void
+filterSetBuild(const List *const filterList)
+{
+    unsigned int relationTotal = 0;
+
+    for (unsigned int dbIdx = 0; dbIdx < lstSize(filterList); dbIdx++)
+        relationTotal += lstSize(((const DataBase *) lstGet(filterList, dbIdx))->tables);
+
+    partialRestoreLocal.dbMask = filterSetSize(lstSize(filterList)) - 1;
+    partialRestoreLocal.dbList = memNew(sizeof(Oid) * (partialRestoreLocal.dbMask + 1));
+    memset(partialRestoreLocal.dbList, 0, sizeof(Oid) * (partialRestoreLocal.dbMask + 1));
+
+    partialRestoreLocal.relationMask = filterSetSize(relationTotal) - 1;
+    partialRestoreLocal.relationList = memNew(sizeof(Relation) * (partialRestoreLocal.relationMask + 1));
+    memset(partialRestoreLocal.relationList, 0, sizeof(Relation) * (partialRestoreLocal.relationMask + 1));
+
+    for (unsigned int dbIdx = 0; dbIdx < lstSize(filterList); dbIdx++)
+    {
+        const DataBase *const db = lstGet(filterList, dbIdx);
+        unsigned int slot = filterDbHash(db->dbOid) & partialRestoreLocal.dbMask;
+
+        while (partialRestoreLocal.dbList[slot] != 0 && partialRestoreLocal.dbList[slot] != db->dbOid)
+            slot = (slot + 1) & partialRestoreLocal.dbMask;
+
+        partialRestoreLocal.dbList[slot] = db->dbOid;
+
+        for (unsigned int tableIdx = 0; tableIdx < lstSize(db->tables); tableIdx++)
+        {
+            const Table *const table = lstGet(db->tables, tableIdx);
+            Relation *relation;
+
+            slot = filterRelationHash(db->dbOid, table->spcNode, table->relNode) & partialRestoreLocal.relationMask;
+
+            while ((relation = &partialRestoreLocal.relationList[slot])->relNode != 0 &&
+                   (relation->dbNode != db->dbOid || relation->spcNode != table->spcNode || relation->relNode != table->relNode))
+            {
+                slot = (slot + 1) & partialRestoreLocal.relationMask;
+            }
+
+            *relation = (Relation){.dbNode = db->dbOid, .spcNode = table->spcNode, .relNode = table->relNode};
+        }
+    }
+}
+
+static inline bool
+filterSetDbExists(const Oid dbNode)
+{
+    for (unsigned int slot = filterDbHash(dbNode) & partialRestoreLocal.dbMask; partialRestoreLocal.dbList[slot] != 0;
+         slot = (slot + 1) & partialRestoreLocal.dbMask)
+    {
+        if (partialRestoreLocal.dbList[slot] == dbNode)
+            return true;
+    }
+
+    return false;
+}
+
+static inline bool
+filterSetRelationExists(const Oid dbNode, const Oid spcNode, const Oid relNode)
+{
+    for (unsigned int slot = filterRelationHash(dbNode, spcNode, relNode) & partialRestoreLocal.relationMask;
+         partialRestoreLocal.relationList[slot].relNode != 0; slot = (slot + 1) & partialRestoreLocal.relationMask)
+    {
+        const Relation *const relation = &partialRestoreLocal.relationList[slot];
+
+        if (relation->relNode == relNode && relation->dbNode == dbNode && relation->spcNode == spcNode)
+            return true;
+    }
+
+    return false;
+}
+
 FN_EXTERN bool
 isRelationNeeded(const Oid dbNode, const Oid spcNode, const Oid relNode)
 {
@@ -120,8 +236,7 @@ isRelationNeeded(const Oid dbNode, const Oid spcNode, const Oid relNode)
     if (pgDbIsSystemId(dbNode) && pgDbIsSystemId(relNode))
         return true;
 
-    static List *filterList = NULL;
-    if (filterList == NULL)
+    if (partialRestoreLocal.dbList == NULL)
     {
         const String *const filter_path = cfgOptionStrNull(cfgOptFilter);
         if (!strBeginsWith(filter_path, FSLASH_STR))
@@ -129,23 +244,24 @@ isRelationNeeded(const Oid dbNode, const Oid spcNode, const Oid relNode)
             THROW(AssertError, "The path to the filter info file is not absolute");
         }
 
-        const Storage *const local_storage = storageLocal();
-        StorageRead *const storageRead = storageNewReadP(local_storage, filter_path);
-        Buffer *const jsonFile = storageGetP(storageRead);
-        JsonRead *const jsonRead = jsonReadNew(strNewBuf(jsonFile));
-
-        filterList = buildFilterList(jsonRead);
+        MEM_CONTEXT_TEMP_BEGIN()
+        {
+            const Buffer *const jsonFile = storageGetP(storageNewReadP(storageLocal(), filter_path));
+            const List *const filterList = buildFilterList(jsonReadNew(strNewBuf(jsonFile)));
 
-        jsonReadFree(jsonRead);
-        bufFree(jsonFile);
-        storageReadFree(storageRead);
+            // The sets are shared by all callers for the life of the process so they must not be allocated in the caller context
+            MEM_CONTEXT_BEGIN(memContextTop())
+            {
+                filterSetBuild(filterList);
+            }
+            MEM_CONTEXT_END();
+        }
+        MEM_CONTEXT_TEMP_END();
     }
 
-    const DataBase *const db = lstFind(filterList, &dbNode);
-    if (db == NULL)
+    // Relations of a database that is not restored are rejected without hashing the relation
+    if (!filterSetDbExists(dbNode))
         return false;
 
-    return
-        pgDbIsSystemId(relNode) ||
-        lstExists(db->tables, &(Table){.spcNode = spcNode, .relNode = relNode});
+    return pgDbIsSystemId(relNode) || filterSetRelationExists(dbNode, spcNode, relNode);
 }
@@ -0,0 +1,270 @@
+/***********************************************************************************************************************************
+Worker Threads
+***********************************************************************************************************************************/
+#include "build.auto.h"
+
+#include <signal.h>
+
+#include "common/debug.h"
+#include "common/log.h"
+#include "common/memContext.h"
+#include "common/thread.h"
+
+/***********************************************************************************************************************************
+Object type
+***********************************************************************************************************************************/
+struct ThreadPool
+{
+    unsigned int threadTotal;                                       // Workers created
+    pthread_t *threadList;                                          // Workers
+
+    pthread_mutex_t mutex;                                          // Protects the variables below
+    pthread_cond_t cond;                                            // Signaled when jobs are queued or on stop
+    pthread_cond_t condDone;                                        // Signaled when the last job is complete
+    bool stop;                                                      // Stop the workers
+    void *(*function)(void *);                                      // Function to run for each job
+    unsigned char *jobList;                                         // Jobs
+    size_t jobSize;                                                 // Size of each job
+    unsigned int jobTotal;                                          // Total jobs
+    unsigned int jobNext;                                           // Next job to run
+    unsigned int jobDone;                                           // Jobs complete
+};
+
+/**********************************************************************************************************************************/
+FN_EXTERN int
+threadCreate(pthread_t *const thread, void *(*const function)(void *), void *const param)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, thread);
+        FUNCTION_TEST_PARAM(FUNCTIONP, function);
+        FUNCTION_TEST_PARAM_P(VOID, param);
+    FUNCTION_TEST_END();
+
+    ASSERT(thread != NULL);
+    ASSERT(function != NULL);
+
+    // Block signals while the worker thread is created so it inherits a mask that blocks all signals
+    sigset_t signalAll;
+    sigset_t signalPrior;
+
+    sigfillset(&signalAll);
+    pthread_sigmask(SIG_SETMASK, &signalAll, &signalPrior);
+
+    const int result = pthread_create(thread, NULL, function, param);
+
+    pthread_sigmask(SIG_SETMASK, &signalPrior, NULL);
+
+    FUNCTION_TEST_RETURN(INT, result);
+}
+
+/**********************************************************************************************************************************/
+FN_EXTERN void
+threadJobRun(void *(*const function)(void *), void *const jobList, const size_t jobSize, const unsigned int jobTotal)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(FUNCTIONP, function);
+        FUNCTION_TEST_PARAM_P(VOID, jobList);
+        FUNCTION_TEST_PARAM(SIZE, jobSize);
+        FUNCTION_TEST_PARAM(UINT, jobTotal);
+    FUNCTION_TEST_END();
+
+    ASSERT(function != NULL);
+    ASSERT(jobList != NULL);
+    ASSERT(jobSize > 0);
+    ASSERT(jobTotal > 0);
+
+    // Run on this thread when there is only one job
+    if (jobTotal == 1)
+    {
+        function(jobList);
+    }
+    // Else run the first job on this thread and the rest on worker threads
+    else
+    {
+        MEM_CONTEXT_TEMP_BEGIN()
+        {
+            pthread_t *const threadList = memNew(sizeof(pthread_t) * jobTotal);
+            bool *const threadCreated = memNew(sizeof(bool) * jobTotal);
+
+            for (unsigned int jobIdx = 0; jobIdx < jobTotal; jobIdx++)
+            {
+                threadCreated[jobIdx] =
+                    jobIdx != 0 && threadCreate(&threadList[jobIdx], function, (unsigned char *)jobList + jobIdx * jobSize) == 0;
+            }
+
+            // Run jobs that are not on a worker thread and wait for the rest
+            for (unsigned int jobIdx = 0; jobIdx < jobTotal; jobIdx++)
+            {
+                if (threadCreated[jobIdx])
+                    pthread_join(threadList[jobIdx], NULL);
+                else
+                    function((unsigned char *)jobList + jobIdx * jobSize);
+            }
+        }
+        MEM_CONTEXT_TEMP_END();
+    }
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Run queued jobs until there are none left. Called with the mutex locked. Nothing called here may use mem contexts, logging, or error
+handling since it runs on workers, which is why the debug macros are not used.
+***********************************************************************************************************************************/
+static void
+threadPoolJobRun(ThreadPool *const this)
+{
+    while (this->jobNext < this->jobTotal)
+    {
+        void *const job = this->jobList + this->jobNext * this->jobSize;
+        this->jobNext++;
+
+        // Run the job without holding the lock so other threads can run jobs
+        pthread_mutex_unlock(&this->mutex);
+        this->function(job);
+        pthread_mutex_lock(&this->mutex);
+
+        this->jobDone++;
+
+        if (this->jobDone == this->jobTotal)
+            pthread_cond_signal(&this->condDone);
+    }
+}
+
+static void *
+threadPoolMain(void *const param)
+{
+    ThreadPool *const this = param;
+
+    pthread_mutex_lock(&this->mutex);
+
+    while (true)
+    {
+        // Wait for jobs or for stop
+        while (this->jobNext == this->jobTotal && !this->stop)
+            pthread_cond_wait(&this->cond, &this->mutex);
+
+        if (this->stop)
+            break;
+
+        threadPoolJobRun(this);
+    }
+
+    pthread_mutex_unlock(&this->mutex);
+
+    return NULL;
+}
+
+/***********************************************************************************************************************************
+Stop the workers and free thread resources
+***********************************************************************************************************************************/
+static void
+threadPoolFreeResource(THIS_VOID)
+{
+    THIS(ThreadPool);
+
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(THREAD_POOL, this);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+
+    pthread_mutex_lock(&this->mutex);
+
+    this->stop = true;
+
+    pthread_cond_broadcast(&this->cond);
+    pthread_mutex_unlock(&this->mutex);
+
+    for (unsigned int threadIdx = 0; threadIdx < this->threadTotal; threadIdx++)
+        pthread_join(this->threadList[threadIdx], NULL);
+
+    pthread_cond_destroy(&this->condDone);
+    pthread_cond_destroy(&this->cond);
+    pthread_mutex_destroy(&this->mutex);
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+/**********************************************************************************************************************************/
+FN_EXTERN ThreadPool *
+threadPoolNew(const unsigned int threadMax)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(UINT, threadMax);
+    FUNCTION_LOG_END();
+
+    ASSERT(threadMax > 0);
+
+    OBJ_NEW_BEGIN(ThreadPool, .allocQty = 1, .callbackQty = 1)
+    {
+        *this = (ThreadPool)
+        {
+            .threadList = memNew(sizeof(pthread_t) * threadMax),
+            .mutex = PTHREAD_MUTEX_INITIALIZER,
+            .cond = PTHREAD_COND_INITIALIZER,
+            .condDone = PTHREAD_COND_INITIALIZER,
+        };
+
+        for (unsigned int threadIdx = 1; threadIdx < threadMax; threadIdx++)
+        {
+            if (threadCreate(&this->threadList[this->threadTotal], threadPoolMain, this) == 0)
+                this->threadTotal++;
+        }
+
+        // Stop the workers and free resources when the object is freed
+        memContextCallbackSet(objMemContext(this), threadPoolFreeResource, this);
+    }
+    OBJ_NEW_END();
+
+    FUNCTION_LOG_RETURN(THREAD_POOL, this);
+}
+
+/**********************************************************************************************************************************/
+FN_EXTERN void
+threadPoolRun(
+    ThreadPool *const this, void *(*const function)(void *), void *const jobList, const size_t jobSize, const unsigned int jobTotal)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(THREAD_POOL, this);
+        FUNCTION_LOG_PARAM(FUNCTIONP, function);
+        FUNCTION_LOG_PARAM_P(VOID, jobList);
+        FUNCTION_LOG_PARAM(SIZE, jobSize);
+        FUNCTION_LOG_PARAM(UINT, jobTotal);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(function != NULL);
+    ASSERT(jobList != NULL);
+    ASSERT(jobSize > 0);
+    ASSERT(jobTotal > 0);
+
+    pthread_mutex_lock(&this->mutex);
+
+    // Queue the jobs and wake the workers
+    this->function = function;
+    this->jobList = jobList;
+    this->jobSize = jobSize;
+    this->jobTotal = jobTotal;
+    this->jobNext = 0;
+    this->jobDone = 0;
+
+    pthread_cond_broadcast(&this->cond);
+
+    // Run jobs on this thread too and then wait for the jobs still running on workers
+    threadPoolJobRun(this);
+
+    while (this->jobDone < this->jobTotal)
+        pthread_cond_wait(&this->condDone, &this->mutex);
+
+    pthread_mutex_unlock(&this->mutex);
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+/**********************************************************************************************************************************/
+FN_EXTERN void
+threadPoolToLog(const ThreadPool *const this, StringStatic *const debugLog)
+{
+    strStcFmt(debugLog, "{threadTotal: %u}", this->threadTotal);
+}
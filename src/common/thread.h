@@ -0,0 +1,62 @@
+/***********************************************************************************************************************************
+Worker Threads
+
+Worker threads are created with all signals blocked so signals are only handled by the main thread, since the handlers are not
+thread-safe. Worker threads must not use mem contexts, logging, or error handling since none of these are thread-safe.
+***********************************************************************************************************************************/
+#ifndef COMMON_THREAD_H
+#define COMMON_THREAD_H
+
+#include <pthread.h>
+#include <stddef.h>
+
+/***********************************************************************************************************************************
+Worker thread pool that runs job lists like threadJobRun() without creating and joining threads for each job list. The workers wait
+for jobs until the pool is freed.
+***********************************************************************************************************************************/
+typedef struct ThreadPool ThreadPool;
+
+#include "common/type/object.h"
+#include "common/type/stringStatic.h"
+
+/***********************************************************************************************************************************
+Constructors
+***********************************************************************************************************************************/
+// Create a pool that can run threadMax jobs at once. The calling thread runs jobs too so threadMax - 1 workers are created. Workers
+// that cannot be created are skipped and their jobs are run by the threads that were created.
+FN_EXTERN ThreadPool *threadPoolNew(unsigned int threadMax);
+
+/***********************************************************************************************************************************
+Functions
+***********************************************************************************************************************************/
+// Create a worker thread. Returns the error code from pthread_create(), i.e. zero on success.
+FN_EXTERN int threadCreate(pthread_t *thread, void *(*function)(void *), void *param);
+
+// Run a list of jobs where each job is passed to the function. The first job is run on the calling thread and the rest on worker
+// threads. A job is run on the calling thread when its worker thread cannot be created. Returns when all jobs are complete.
+FN_EXTERN void threadJobRun(void *(*function)(void *), void *jobList, size_t jobSize, unsigned int jobTotal);
+
+// Run a list of jobs on the pool. The calling thread runs jobs along with the workers. Returns when all jobs are complete.
+FN_EXTERN void threadPoolRun(ThreadPool *this, void *(*function)(void *), void *jobList, size_t jobSize, unsigned int jobTotal);
+
+/***********************************************************************************************************************************
+Destructor
+***********************************************************************************************************************************/
+// Workers are stopped and joined when the pool is freed
+FN_INLINE_ALWAYS void
+threadPoolFree(ThreadPool *const this)
+{
+    objFree(this);
+}
+
+/***********************************************************************************************************************************
+Macros for function logging
+***********************************************************************************************************************************/
+FN_EXTERN void threadPoolToLog(const ThreadPool *this, StringStatic *debugLog);
+
+#define FUNCTION_LOG_THREAD_POOL_TYPE                                                                                              \
+    ThreadPool *
+#define FUNCTION_LOG_THREAD_POOL_FORMAT(value, buffer, bufferSize)                                                                 \
+    FUNCTION_LOG_OBJECT_FORMAT(value, threadPoolToLog, buffer, bufferSize)
+
+#endif
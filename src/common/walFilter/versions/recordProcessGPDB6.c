@@ -380,14 +380,16 @@ validXLogRecordHeaderGPDB6(const XLogRecord *const record, const PgPageSize heap
 }
 
 FN_EXTERN void
-validXLogRecordGPDB6(const XLogRecord *const record, const PgPageSize heapPageSize)
+validXLogRecordGPDB6(const XLogRecord *const record, const PgPageSize heapPageSize, const pg_crc32 *const bodyCrc)
 {
     const uint32 len = record->xl_len;
     uint32 remaining = record->xl_tot_len;
 
     remaining -= (uint32) (SizeOfXLogRecord + len);
     pg_crc32 crc = crc32cInit();
-    crc = crc32cComp(crc, XLogRecGetData(record), len);
+
+    if (bodyCrc == NULL)
+        crc = crc32cComp(crc, XLogRecGetData(record), len);
 
     /* Add in the backup blocks, if any */
     const unsigned char *blk = XLogRecGetData(record) + len;
@@ -413,7 +415,10 @@ validXLogRecordGPDB6(const XLogRecord *const record, const PgPageSize heapPageSi
             THROW_FMT(FormatError, "invalid backup block size in record");
         }
         remaining -= blen;
-        crc = crc32cComp(crc, blk, blen);
+
+        if (bodyCrc == NULL)
+            crc = crc32cComp(crc, blk, blen);
+
         blk += blen;
     }
 
@@ -423,6 +428,10 @@ validXLogRecordGPDB6(const XLogRecord *const record, const PgPageSize heapPageSi
         THROW_FMT(FormatError, "incorrect total length in record");
     }
 
+    /* The data and backup blocks fill the rest of the record so a checksum calculated over the rest of the record is the same */
+    if (bodyCrc != NULL)
+        crc = *bodyCrc;
+
     /* Finally include the record header */
     crc = crc32cComp(crc, (const unsigned char *) record, offsetof(XLogRecord, xl_crc));
     crc = crc32cFinish(crc);
@@ -434,8 +443,12 @@ validXLogRecordGPDB6(const XLogRecord *const record, const PgPageSize heapPageSi
 }
 
 pg_crc32
-xLogRecordChecksumGPDB6(const XLogRecord *record, const PgPageSize heapPageSize)
+xLogRecordChecksumGPDB6(const XLogRecord *record, const PgPageSize heapPageSize, const pg_crc32 *const bodyCrc)
 {
+    /* Only the header is left to checksum when the rest of the record has already been checksummed */
+    if (bodyCrc != NULL)
+        return crc32cFinish(crc32cComp(*bodyCrc, (const unsigned char *) record, offsetof(XLogRecord, xl_crc)));
+
     const uint32 len = record->xl_len;
 
     pg_crc32 crc = crc32cInit();
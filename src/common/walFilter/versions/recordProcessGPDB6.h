@@ -8,6 +8,8 @@
 FN_EXTERN const RelFileNode *getRelFileNodeGPDB6(const XLogRecord *record);
 
 FN_EXTERN void validXLogRecordHeaderGPDB6(const XLogRecord *record, PgPageSize heapPageSize);
-FN_EXTERN void validXLogRecordGPDB6(const XLogRecord *record, PgPageSize heapPageSize);
-FN_EXTERN pg_crc32 xLogRecordChecksumGPDB6(const XLogRecord *record, const PgPageSize heapPageSize);
+// The checksum of the record after the header (bodyCrc) is calculated when NULL, otherwise it must be the unfinished CRC-32C of
+// everything in the record after the header
+FN_EXTERN void validXLogRecordGPDB6(const XLogRecord *record, PgPageSize heapPageSize, const pg_crc32 *bodyCrc);
+FN_EXTERN pg_crc32 xLogRecordChecksumGPDB6(const XLogRecord *record, const PgPageSize heapPageSize, const pg_crc32 *bodyCrc);
 #endif // COMMON_WALFILTER_VERSIONS_RECORDPROCESSGPDB6_H
@@ -1,13 +1,20 @@
 #include "build.auto.h"
 
+#include <stdlib.h>
+
 #include "walFilter.h"
 
 #include "common/debug.h"
 #include "common/log.h"
 #include "common/type/object.h"
 
+#include "command/archive/bundle.h"
+#include "command/archive/common.h"
 #include "common/compress/helper.h"
+#include "common/crypto/hash.h"
+#include "common/io/io.h"
 #include "common/partialRestore.h"
+#include "common/thread.h"
 #include "config/config.h"
 #include "postgres/interface/crc32.h"
 #include "postgres/version.h"
@@ -17,6 +24,18 @@
 
 #define WAL_FILTER_TYPE STRID5("wal-fltr", 0x95186db0370)
 
+// Record fragments at the boundaries of filtered segments are cached in the spool so the filter of a neighbouring segment does not
+// need to read the whole segment from the repo again. Fragments are named by the segment and the checksum of its archive file, so a
+// fragment always matches the contents of the file that would otherwise be read.
+#define WAL_FILTER_FRAGMENT_PATH                                    STORAGE_SPOOL_ARCHIVE "/fragment"
+#define WAL_FILTER_FRAGMENT_EXT_HEAD                                "head"
+#define WAL_FILTER_FRAGMENT_EXT_TAIL                                "tail"
+
+// When io-thread is enabled the records in each input buffer are checksummed on worker threads before they are filtered. Creating
+// threads costs more than checksumming a few pages so each thread gets a minimum number of pages.
+#define WAL_FILTER_THREAD_MAX                                       4
+#define WAL_FILTER_THREAD_PAGE_MIN                                  8
+
 typedef enum
 {
     noStep, // This means that the process of reading the record is in an uninterrupted state.
@@ -38,8 +57,8 @@ typedef struct WalInterface
 
     uint16_t header_magic;
     void (*validXLogRecordHeader)(const XLogRecord *record, PgPageSize heapPageSize);
-    void (*validXLogRecord)(const XLogRecord *record, PgPageSize heapPageSize);
-    pg_crc32 (*xLogRecordChecksum)(const XLogRecord *record, PgPageSize heapPageSize);
+    void (*validXLogRecord)(const XLogRecord *record, PgPageSize heapPageSize, const pg_crc32 *bodyCrc);
+    pg_crc32 (*xLogRecordChecksum)(const XLogRecord *record, PgPageSize heapPageSize, const pg_crc32 *bodyCrc);
 } WalInterface;
 
 static WalInterface interfaces[] = {
@@ -53,6 +72,28 @@ static WalInterface interfaces[] = {
     }
 };
 
+// Checksum of everything after the header of a record in the input buffer
+typedef struct WalFilterCrc
+{
+    const unsigned char *record;                                    // Start of the record in the input buffer
+    pg_crc32 bodyCrc;                                               // Unfinished CRC-32C of the record after the header
+} WalFilterCrc;
+
+// Checksum the records that begin in a range of pages. Jobs run on worker threads so they must not use mem contexts, logging, or
+// error handling. Anything unexpected ends the job and the remaining records are checksummed while they are filtered, which also
+// reports any error.
+typedef struct WalFilterCrcJob
+{
+    const unsigned char *input;                                     // Input buffer
+    size_t inputSize;                                               // Size of the input buffer
+    size_t pageBegin;                                               // Offset of the first page in the range
+    size_t pageEnd;                                                 // Offset of the end of the range
+    PgPageSize walPageSize;                                         // WAL page size
+    uint16_t pageMagic;                                             // Expected page magic
+    WalFilterCrc *crcList;                                          // Checksums of complete records in the range
+    unsigned int crcTotal;                                          // Total checksums
+} WalFilterCrcJob;
+
 typedef struct WalFilter
 {
     ReadStep currentStep;
@@ -90,8 +131,51 @@ typedef struct WalFilter
     bool done;
     bool inputSame;
     bool isSwitchWal;
+
+    // Offset of the current input buffer in the segment
+    size_t inputBegin;
+    // Offset of the page where the current record begins
+    size_t recordBegin;
+
+    // Cache boundary fragments in the spool
+    bool fragmentCache;
+    // Segment and checksum of the file being filtered
+    const String *fragmentName;
+    // Pages at the end of the segment starting from the page where the current record begins
+    Buffer *tail;
+
+    // Max threads used to checksum records and the pool they run on, which lives as long as the filter so threads are not created
+    // for each input buffer
+    unsigned int threadMax;
+    ThreadPool *threadPool;
+    // Input buffer the record checksums were calculated for
+    const Buffer *crcInput;
+    // Checksum jobs and the next checksum to compare with the start of a record
+    WalFilterCrcJob *crcJobList;
+    unsigned int crcJobTotal;
+    unsigned int crcJobIdx;
+    unsigned int crcIdx;
+    // Storage for the checksums of all jobs
+    WalFilterCrc *crcList;
+    size_t crcListSize;
+    // Start of the current record when it begins in the input buffer the checksums were calculated for
+    const unsigned char *recordStart;
+    // Checksum of the current record after the header when it was calculated by a job
+    bool bodyCrcFound;
+    pg_crc32 bodyCrc;
 } WalFilterState;
 
+/***********************************************************************************************************************************
+Local variables
+***********************************************************************************************************************************/
+static struct WalFilterLocal
+{
+    MemContext *memContext;                                         // Mem context for the cached listing
+    String *key;                                                    // Repo and archive path of the cached listing
+    StringList *segmentList;                                        // Cached listing
+    List *bundleFileList;                                           // Segments stored in bundles in the cached listing
+} walFilterLocal;
+
 /***********************************************************************************************************************************
 Render as string for logging
 ***********************************************************************************************************************************/
@@ -136,6 +220,7 @@ getNextPage(WalFilterState *const this, const Buffer *const input)
         ASSERT(this->currentStep != noStep);
         this->inputOffset = 0;
         this->inputSame = false;
+        this->recordStart = NULL;
         return false;
     }
 
@@ -161,6 +246,185 @@ getRecordSize(const unsigned char *const buffer)
     return ((XLogRecord *) (buffer))->xl_tot_len;
 }
 
+// Checksum the records that begin in the page range of the job. Records are followed across pages the same way readRecord() does.
+static void *
+walFilterCrcJob(void *const param)
+{
+    WalFilterCrcJob *const job = param;
+    size_t offset = job->pageBegin;
+    bool recordFound = false;
+
+    job->crcTotal = 0;
+
+    while (offset < job->pageEnd)
+    {
+        // Skip the page header and the part of a record continued from the previous page, which is only expected before the first
+        // record is found
+        if (offset % job->walPageSize == 0)
+        {
+            const XLogPageHeaderData *const header = (const XLogPageHeaderData *) (job->input + offset);
+
+            if (header->xlp_magic != job->pageMagic || (recordFound && header->xlp_info & XLP_FIRST_IS_CONTRECORD))
+                break;
+
+            offset += XLogPageHeaderSize(header);
+
+            if (header->xlp_info & XLP_FIRST_IS_OVERWRITE_CONTRECORD)
+            {
+                offset += job->walPageSize - XLogPageHeaderSize(header);
+                continue;
+            }
+
+            if (header->xlp_info & XLP_FIRST_IS_CONTRECORD)
+            {
+                if (header->xlp_rem_len >= job->walPageSize - XLogPageHeaderSize(header))
+                {
+                    offset += job->walPageSize - XLogPageHeaderSize(header);
+                    continue;
+                }
+
+                offset += MAXALIGN(header->xlp_rem_len);
+
+                if (offset % job->walPageSize == 0)
+                    continue;
+            }
+        }
+
+        // The record must have at least a header. This also ends the job at the unused space at the end of the segment.
+        const unsigned char *const record = job->input + offset;
+        uint32_t recordSize;
+
+        memcpy(&recordSize, record, sizeof(recordSize));
+
+        if (recordSize < SizeOfXLogRecord)
+            break;
+
+        // Checksum the record after the header, skipping the headers of continuation pages
+        const bool headerSplit = job->walPageSize - offset % job->walPageSize < SizeOfXLogRecord;
+        pg_crc32 crc = crc32cInit();
+        size_t recordRead = 0;
+
+        while (true)
+        {
+            const size_t size = Min(job->walPageSize - offset % job->walPageSize, recordSize - recordRead);
+
+            if (recordRead + size > SizeOfXLogRecord)
+            {
+                const size_t skip = recordRead < SizeOfXLogRecord ? SizeOfXLogRecord - recordRead : 0;
+                crc = crc32cComp(crc, job->input + offset + skip, size - skip);
+            }
+
+            recordRead += size;
+            offset += size;
+
+            if (recordRead == recordSize)
+                break;
+
+            // The record must continue on the next page in the input buffer
+            if (offset >= job->inputSize)
+                return NULL;
+
+            const XLogPageHeaderData *const header = (const XLogPageHeaderData *) (job->input + offset);
+
+            if (header->xlp_magic != job->pageMagic || !(header->xlp_info & XLP_FIRST_IS_CONTRECORD) ||
+                header->xlp_info & XLP_FIRST_IS_OVERWRITE_CONTRECORD || header->xlp_rem_len != recordSize - recordRead)
+            {
+                return NULL;
+            }
+
+            offset += XLogPageHeaderSize(header);
+        }
+
+        // The record is filtered with a split header assembled differently so only the size of the record is used
+        if (!headerSplit)
+            job->crcList[job->crcTotal++] = (WalFilterCrc){.record = record, .bodyCrc = crc};
+
+        recordFound = true;
+        offset = MAXALIGN(offset);
+    }
+
+    return NULL;
+}
+
+// Checksum the records in the input buffer on worker threads
+static void
+walFilterCrcRun(WalFilterState *const this, const Buffer *const input)
+{
+    const size_t pageTotal = bufUsed(input) / this->walPageSize;
+    unsigned int jobTotal = (unsigned int) Min(pageTotal / WAL_FILTER_THREAD_PAGE_MIN, this->threadMax);
+
+    this->crcInput = input;
+    this->crcJobTotal = 0;
+    this->crcJobIdx = 0;
+    this->crcIdx = 0;
+
+    // Not enough pages to be worth creating threads so the records are checksummed while they are filtered
+    if (jobTotal < 2)
+        return;
+
+    // Records are at least the size of the header so this is the most checksums a range of pages can hold
+    const size_t jobPageTotal = pageTotal / jobTotal;
+    const size_t jobCrcMax = (pageTotal - jobPageTotal * (jobTotal - 1)) * this->walPageSize / SizeOfXLogRecord + 1;
+
+    if (this->crcListSize < jobCrcMax * jobTotal)
+    {
+        MEM_CONTEXT_OBJ_BEGIN(this)
+        {
+            this->crcList = this->crcList == NULL ?
+                memNew(sizeof(WalFilterCrc) * jobCrcMax * jobTotal) :
+                memResize(this->crcList, sizeof(WalFilterCrc) * jobCrcMax * jobTotal);
+        }
+        MEM_CONTEXT_OBJ_END();
+
+        this->crcListSize = jobCrcMax * jobTotal;
+    }
+
+    for (unsigned int jobIdx = 0; jobIdx < jobTotal; jobIdx++)
+    {
+        this->crcJobList[jobIdx] = (WalFilterCrcJob)
+        {
+            .input = bufPtrConst(input),
+            .inputSize = bufUsed(input),
+            .pageBegin = jobIdx * jobPageTotal * this->walPageSize,
+            .pageEnd = jobIdx == jobTotal - 1 ? pageTotal * this->walPageSize : (jobIdx + 1) * jobPageTotal * this->walPageSize,
+            .walPageSize = this->walPageSize,
+            .pageMagic = this->walInterface->header_magic,
+            .crcList = this->crcList + jobIdx * jobCrcMax,
+        };
+    }
+
+    threadPoolRun(this->threadPool, walFilterCrcJob, this->crcJobList, sizeof(WalFilterCrcJob), jobTotal);
+
+    this->crcJobTotal = jobTotal;
+}
+
+// Find the checksum calculated by a job for the current record. Records are read in order so the search continues from the last
+// checksum found.
+static const pg_crc32 *
+walFilterCrcFind(WalFilterState *const this)
+{
+    if (this->recordStart == NULL)
+        return NULL;
+
+    for (; this->crcJobIdx < this->crcJobTotal; this->crcJobIdx++, this->crcIdx = 0)
+    {
+        const WalFilterCrcJob *const job = &this->crcJobList[this->crcJobIdx];
+
+        for (; this->crcIdx < job->crcTotal; this->crcIdx++)
+        {
+            const WalFilterCrc *const crc = &job->crcList[this->crcIdx];
+
+            if (crc->record == this->recordStart)
+                return &crc->bodyCrc;
+
+            if (crc->record > this->recordStart)
+                return NULL;
+        }
+    }
+
+    return NULL;
+}
+
 // Returns ReadRecordSuccess on success record read and returns ReadRecordNeedBuffer if a new input buffer is needed to continue
 // reading.
 static ReadRecordStatus
@@ -212,6 +476,10 @@ stepBeginOfRecord:
     // Record header can be split between pages but first field xl_tot_len is always on single page
     uint32_t record_size = getRecordSize(((unsigned char *) this->currentPageHeader) + this->pageOffset);
 
+    // Remember where the record begins so the checksum calculated by a job can be found
+    this->recordStart = input == this->crcInput ? ((unsigned char *) this->currentPageHeader) + this->pageOffset : NULL;
+    this->bodyCrcFound = false;
+
     if (this->recBufSize < record_size)
     {
         MEM_CONTEXT_OBJ_BEGIN(this)
@@ -311,7 +579,15 @@ stepReadBody:
         this->pageOffset += MAXALIGN(to_write);
         this->gotLen += to_write;
     }
-    this->walInterface->validXLogRecord(this->record, this->heapPageSize);
+    const pg_crc32 *const bodyCrc = walFilterCrcFind(this);
+
+    this->walInterface->validXLogRecord(this->record, this->heapPageSize, bodyCrc);
+
+    if (bodyCrc != NULL)
+    {
+        this->bodyCrcFound = true;
+        this->bodyCrc = *bodyCrc;
+    }
 
     if (this->record->xl_rmid == RM_XLOG_ID && this->record->xl_info == XLOG_SWITCH)
     {
@@ -330,14 +606,7 @@ filterRecord(WalFilterState *const this)
         return;
     }
 
-    bool isPassTheFilter;
-
-    // isRelationNeeded can allocate memory on the first call. Therefore, we switch the context.
-    MEM_CONTEXT_OBJ_BEGIN(this)
-    isPassTheFilter = isRelationNeeded(node->dbNode, node->spcNode, node->relNode);
-    MEM_CONTEXT_OBJ_END();
-
-    if (isPassTheFilter)
+    if (isRelationNeeded(node->dbNode, node->spcNode, node->relNode))
     {
         return;
     }
@@ -345,7 +614,8 @@ filterRecord(WalFilterState *const this)
     this->record->xl_rmid = RM_XLOG_ID;
     // Save 4 least significant bits which represent backup blocks flags.
     this->record->xl_info = (uint8_t) (XLOG_NOOP | (this->record->xl_info & XLR_INFO_MASK));
-    this->record->xl_crc = this->walInterface->xLogRecordChecksum(this->record, this->heapPageSize);
+    this->record->xl_crc = this->walInterface->xLogRecordChecksum(
+        this->record, this->heapPageSize, this->bodyCrcFound ? &this->bodyCrc : NULL);
 }
 
 static void
@@ -394,26 +664,14 @@ writeRecord(WalFilterState *const this, Buffer *const output, const unsigned cha
     this->gotLen = 0;
 }
 
-static const StorageRead *
-getNearWal (WalFilterState *const this, bool isNext)
+// Find the nearest segment to segno in the list. Returns NULL if the current file is oldest/newest.
+static const String *
+findNearWal(const WalFilterState *const this, const StringList *const segmentList, const uint64_t segno, const bool isNext,
+            uint64_t *const segnoDiff)
 {
-    const String *walSegment = NULL;
-    const TimeLineID timeLine = this->currentPageHeader->xlp_tli;
-    uint64_t segno = this->currentPageHeader->xlp_pageaddr / this->segSize;
-    const String *const path = strNewFmt("%08X%08X", timeLine, (uint32) (segno / XLogSegmentsPerXLogId(this->segSize)));
-
-    const StringList *const segmentList = storageListP(
-        storageRepoIdx(this->archiveInfo->repoIdx),
-        strNewFmt(STORAGE_REPO_ARCHIVE "/%s/%s", strZ(this->archiveInfo->archiveId), strZ(path)),
-        .expression = strNewFmt("^[0-f]{24}-[0-f]{40}" COMPRESS_TYPE_REGEXP "{0,1}$"));
+    const String *result = NULL;
+    *segnoDiff = UINT64_MAX;
 
-    if (strLstEmpty(segmentList))
-    {
-        // an exotic case where we couldn't even find the current file.
-        THROW(FormatError, "no WAL files were found in the repository");
-    }
-
-    uint64_t segnoDiff = UINT64_MAX;
     for (uint32_t i = 0; i < strLstSize(segmentList); i++)
     {
         const String *const file = strSubN(strLstGet(segmentList, i), 0, 24);
@@ -423,76 +681,269 @@ getNearWal (WalFilterState *const this, bool isNext)
 
         if (isNext)
         {
-            if (fileSegNo - segno < segnoDiff && fileSegNo > segno)
+            if (fileSegNo - segno < *segnoDiff && fileSegNo > segno)
             {
-                segnoDiff = fileSegNo - segno;
-                walSegment = strLstGet(segmentList, i);
+                *segnoDiff = fileSegNo - segno;
+                result = strLstGet(segmentList, i);
             }
         }
         else
         {
-            if (segno - fileSegNo < segnoDiff && fileSegNo < segno)
+            if (segno - fileSegNo < *segnoDiff && fileSegNo < segno)
             {
-                segnoDiff = segno - fileSegNo;
-                walSegment = strLstGet(segmentList, i);
+                *segnoDiff = segno - fileSegNo;
+                result = strLstGet(segmentList, i);
             }
         }
     }
 
-    // current file is oldest/newest
-    if (segnoDiff == UINT64_MAX)
+    return result;
+}
+
+// Get the name of the nearest segment in the repo. Returns NULL if the current file is oldest/newest.
+static const String *
+getNearWal(WalFilterState *const this, bool isNext)
+{
+    const String *walSegment = NULL;
+    const TimeLineID timeLine = this->currentPageHeader->xlp_tli;
+    uint64_t segno = this->currentPageHeader->xlp_pageaddr / this->segSize;
+    const String *const path = strNewFmt(
+        STORAGE_REPO_ARCHIVE "/%s/%08X%08X", strZ(this->archiveInfo->archiveId), timeLine,
+        (uint32) (segno / XLogSegmentsPerXLogId(this->segSize)));
+    const String *const key = strNewFmt("%u:%s", this->archiveInfo->repoIdx, strZ(path));
+    uint64_t segnoDiff;
+
+    // Consecutive segments are filtered by the same process when fragments are cached, so try the listing made for the previous
+    // segment first. The listing may be missing segments archived since it was made, so only trust it for the adjacent segment.
+    if (this->fragmentCache && strEq(walFilterLocal.key, key))
+    {
+        walSegment = findNearWal(this, walFilterLocal.segmentList, segno, isNext, &segnoDiff);
+
+        if (segnoDiff == 1)
+            return strNewFmt("%s/%s", strZ(path), strZ(walSegment));
+    }
+
+    const StringList *const fileList = storageListP(
+        storageRepoIdx(this->archiveInfo->repoIdx), path, .expression = WAL_SEGMENT_BUNDLE_FILE_REGEXP_STR);
+
+    if (strLstEmpty(fileList))
     {
-        return NULL;
+        // an exotic case where we couldn't even find the current file.
+        THROW(FormatError, "no WAL files were found in the repository");
+    }
+
+    // Segments stored in bundles are listed with the names they would have outside the bundle. The listing is always stored so the
+    // location of a bundled segment can be found when it is read, but is only keyed for reuse when fragments are cached.
+    if (walFilterLocal.memContext == NULL)
+    {
+        MEM_CONTEXT_BEGIN(memContextTop())
+        {
+            MEM_CONTEXT_NEW_BEGIN(WalFilterLocal, .childQty = MEM_CONTEXT_QTY_MAX)
+            {
+                walFilterLocal.memContext = MEM_CONTEXT_NEW();
+            }
+            MEM_CONTEXT_NEW_END();
+        }
+        MEM_CONTEXT_END();
+    }
+
+    MEM_CONTEXT_BEGIN(walFilterLocal.memContext)
+    {
+        strFree(walFilterLocal.key);
+        strLstFree(walFilterLocal.segmentList);
+        lstFree(walFilterLocal.bundleFileList);
+
+        walFilterLocal.key = this->fragmentCache ? strDup(key) : NULL;
+        walFilterLocal.segmentList = strLstNew();
+        walFilterLocal.bundleFileList = walBundleList(storageRepoIdx(this->archiveInfo->repoIdx), path, fileList);
+
+        for (unsigned int fileIdx = 0; fileIdx < strLstSize(fileList); fileIdx++)
+        {
+            if (!walIsBundle(strLstGet(fileList, fileIdx)))
+                strLstAdd(walFilterLocal.segmentList, strLstGet(fileList, fileIdx));
+        }
+
+        for (unsigned int bundleFileIdx = 0; bundleFileIdx < lstSize(walFilterLocal.bundleFileList); bundleFileIdx++)
+            strLstAdd(walFilterLocal.segmentList, ((WalBundleFile *)lstGet(walFilterLocal.bundleFileList, bundleFileIdx))->name);
     }
+    MEM_CONTEXT_END();
+
+    const StringList *const segmentList = walFilterLocal.segmentList;
 
+    walSegment = findNearWal(this, segmentList, segno, isNext, &segnoDiff);
+
+    return walSegment == NULL ? NULL : strNewFmt("%s/%s", strZ(path), strZ(walSegment));
+}
+
+// Open the segment in the repo
+static const StorageRead *
+getNearWalRead(const WalFilterState *const this, const String *const walSegment)
+{
     const bool compressible =
         this->archiveInfo->cipherType == cipherTypeNone && compressTypeFromName(this->archiveInfo->file) == compressTypeNone;
 
-    const StorageRead *const storageRead = storageNewReadP(
-        storageRepoIdx(this->archiveInfo->repoIdx),
-        strNewFmt(STORAGE_REPO_ARCHIVE "/%s/%s", strZ(this->archiveInfo->archiveId), strZ(walSegment)),
-        .compressible = compressible);
+    // If the segment is stored in a bundle then read only the part of the bundle that contains the segment
+    const String *const name = strBase(walSegment);
+    const WalBundleFile *const bundleFile = lstFind(walFilterLocal.bundleFileList, &name);
+
+    const StorageRead *const storageRead =
+        bundleFile != NULL ?
+            walBundleReadNew(storageRepoIdx(this->archiveInfo->repoIdx), strPath(walSegment), bundleFile, compressible) :
+            storageNewReadP(storageRepoIdx(this->archiveInfo->repoIdx), walSegment, .compressible = compressible);
 
     buildArchiveGetPipeLine(ioReadFilterGroup(storageReadIo(storageRead)), this->archiveInfo);
     return storageRead;
 }
 
+// Name of the fragment cached for the file, i.e. the segment and checksum without path and extension
+static String *
+fragmentName(const String *const file)
+{
+    return strSubN(strBase(file), 0, WAL_SEGMENT_NAME_SIZE + 1 + HASH_TYPE_SHA1_SIZE_HEX);
+}
+
+// Get the fragment of the segment from the spool. Returns NULL if the neighbouring filter has not cached it (yet).
+static Buffer *
+fragmentGet(const WalFilterState *const this, const String *const walSegment, const char *const ext)
+{
+    if (!this->fragmentCache)
+        return NULL;
+
+    Buffer *const result = storageGetP(
+        storageNewReadP(
+            storageSpool(), strNewFmt(WAL_FILTER_FRAGMENT_PATH "/%s.%s", strZ(fragmentName(walSegment)), ext),
+            .ignoreMissing = true));
+
+    // A fragment always holds whole pages
+    if (result != NULL && (bufEmpty(result) || bufUsed(result) % this->walPageSize != 0))
+    {
+        THROW_FMT(
+            FormatError, "invalid WAL fragment '%s.%s' size %zu", strZ(fragmentName(walSegment)), ext, bufUsed(result));
+    }
+
+    return result;
+}
+
+// Store the fragment of the segment being filtered in the spool
+static void
+fragmentPut(const WalFilterState *const this, const Buffer *const fragment, const char *const ext)
+{
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        storagePutP(
+            storageNewWriteP(
+                storageSpoolWrite(), strNewFmt(WAL_FILTER_FRAGMENT_PATH "/%s.%s", strZ(this->fragmentName), ext),
+                .noSyncFile = true, .noSyncPath = true),
+            fragment);
+    }
+    MEM_CONTEXT_TEMP_END();
+}
+
+// Called when the input buffer is exhausted. Keep the pages of the input buffer that may be needed by neighbouring segments.
+static void
+inputDone(WalFilterState *const this, const Buffer *const input)
+{
+    const size_t inputEnd = this->inputBegin + bufUsed(input);
+
+    if (this->fragmentCache)
+    {
+        // The leading partial record continues the last record of the previous segment. Determine how many pages it takes.
+        if (this->inputBegin == 0)
+        {
+            const XLogPageHeaderData *const header = (const XLogPageHeaderData *) bufPtrConst(input);
+
+            if (header->xlp_info & XLP_FIRST_IS_CONTRECORD)
+            {
+                size_t headSize = this->walPageSize;
+                size_t remains = header->xlp_rem_len;
+                size_t space = this->walPageSize - XLogPageHeaderSize(header);
+
+                while (remains > space)
+                {
+                    remains -= space;
+                    space = this->walPageSize - SizeOfXLogShortPHD;
+                    headSize += this->walPageSize;
+                }
+
+                // Like the filter itself, expect the first input buffer to hold the whole leading partial record
+                if (headSize <= bufUsed(input))                     // {uncovered_branch - filter fails on a larger record}
+                    fragmentPut(this, BUF(bufPtrConst(input), headSize), WAL_FILTER_FRAGMENT_EXT_HEAD);
+            }
+        }
+
+        // Keep the pages of the current record since it may be the trailing partial record. The rest of the segment after a switch
+        // record is copied as is so there is nothing to keep.
+        if (this->isSwitchWal)
+            bufUsedZero(this->tail);
+        else if (this->recordBegin >= this->inputBegin)
+        {
+            bufUsedZero(this->tail);
+
+            if (this->recordBegin < inputEnd)
+                bufCatSub(this->tail, input, this->recordBegin - this->inputBegin, inputEnd - this->recordBegin);
+        }
+        else
+            bufCat(this->tail, input);
+    }
+
+    this->inputBegin = inputEnd;
+    this->crcInput = NULL;
+}
+
 static bool
 readBeginOfRecord(WalFilterState *const this)
 {
     bool result = false;
     MEM_CONTEXT_TEMP_BEGIN();
 
-    const StorageRead *const storageRead = getNearWal(this, false);
+    const String *const walSegment = getNearWal(this, false);
 
-    if (storageRead == NULL)
+    if (walSegment == NULL)
     {
         goto end;
     }
 
-    ioReadOpen(storageReadIo(storageRead));
     this->isBegin = true;
     this->inputOffset = 0;
     this->pageOffset = 0;
 
-    Buffer *const buffer = bufNew(this->walPageSize);
-    size_t size = ioRead(storageReadIo(storageRead), buffer);
-    bufUsedSet(buffer, size);
+    // The tail of the previous segment starts at the page where its last record begins so it is read in the same way as the file
+    const Buffer *const fragment = fragmentGet(this, walSegment, WAL_FILTER_FRAGMENT_EXT_TAIL);
 
-    while (!ioReadEof(storageReadIo(storageRead)))
+    if (fragment != NULL)
+    {
+        while (readRecord(this, fragment) == ReadRecordSuccess)
+            lstClearFast(this->pageHeaders);
+
+        lstClearFast(this->pageHeaders);
+    }
+    else
     {
-        if (readRecord(this, buffer) == ReadRecordNeedBuffer)
+        const StorageRead *const storageRead = getNearWalRead(this, walSegment);
+
+        ioReadOpen(storageReadIo(storageRead));
+
+        Buffer *const buffer = bufNew(this->walPageSize);
+        size_t size = ioRead(storageReadIo(storageRead), buffer);
+        bufUsedSet(buffer, size);
+
+        while (!ioReadEof(storageReadIo(storageRead)))
         {
-            bufUsedZero(buffer);
-            size = ioRead(storageReadIo(storageRead), buffer);
-            bufUsedSet(buffer, size);
+            if (readRecord(this, buffer) == ReadRecordNeedBuffer)
+            {
+                bufUsedZero(buffer);
+                size = ioRead(storageReadIo(storageRead), buffer);
+                bufUsedSet(buffer, size);
+            }
+            lstClearFast(this->pageHeaders);
         }
-        lstClearFast(this->pageHeaders);
+
+        ioReadClose(storageReadIo(storageRead));
     }
+
     // If xl_info and xl_rmid is in prev file then nothing to do
     result = this->gotLen < offsetof(XLogRecord, xl_rmid) + SIZE_OF_STRUCT_MEMBER(XLogRecord, xl_rmid);
 
-    ioReadClose(storageReadIo(storageRead));
 end:
     MEM_CONTEXT_TEMP_END();
     return result;
@@ -503,30 +954,44 @@ getEndOfRecord(WalFilterState *const this)
 {
     MEM_CONTEXT_TEMP_BEGIN();
 
-    const StorageRead *const storageRead = getNearWal(this, true);
+    const String *const walSegment = getNearWal(this, true);
 
-    if (storageRead == NULL)
+    if (walSegment == NULL)
     {
         THROW_FMT(FormatError, "The file with the end of the %s record is missing", strZ(pgLsnToStr(this->recPtr)));
     }
 
-    ioReadOpen(storageReadIo(storageRead));
+    // The head of the next segment holds all the pages needed to complete the record
+    const Buffer *const fragment = fragmentGet(this, walSegment, WAL_FILTER_FRAGMENT_EXT_HEAD);
 
-    Buffer *const buffer = bufNew(this->walPageSize);
-    size_t size = ioRead(storageReadIo(storageRead), buffer);
-    bufUsedSet(buffer, size);
-    while (readRecord(this, buffer) == ReadRecordNeedBuffer)
+    if (fragment != NULL)
     {
-        if (ioReadEof(storageReadIo(storageRead)))
-        {
+        if (readRecord(this, fragment) == ReadRecordNeedBuffer)
             THROW_FMT(FormatError, "%s - Unexpected WAL end", strZ(pgLsnToStr(this->recPtr)));
-        }
+    }
+    else
+    {
+        const StorageRead *const storageRead = getNearWalRead(this, walSegment);
 
-        bufUsedZero(buffer);
-        size = ioRead(storageReadIo(storageRead), buffer);
+        ioReadOpen(storageReadIo(storageRead));
+
+        Buffer *const buffer = bufNew(this->walPageSize);
+        size_t size = ioRead(storageReadIo(storageRead), buffer);
         bufUsedSet(buffer, size);
+        while (readRecord(this, buffer) == ReadRecordNeedBuffer)
+        {
+            if (ioReadEof(storageReadIo(storageRead)))
+            {
+                THROW_FMT(FormatError, "%s - Unexpected WAL end", strZ(pgLsnToStr(this->recPtr)));
+            }
+
+            bufUsedZero(buffer);
+            size = ioRead(storageReadIo(storageRead), buffer);
+            bufUsedSet(buffer, size);
+        }
+        ioReadClose(storageReadIo(storageRead));
     }
-    ioReadClose(storageReadIo(storageRead));
+
     MEM_CONTEXT_TEMP_END();
 }
 
@@ -555,6 +1020,10 @@ walFilterProcess(THIS_VOID, const Buffer *const input, Buffer *const output)
         {
             const size_t size_on_page = this->gotLen;
 
+            // The next segment will need the trailing partial record to filter its leading partial record
+            if (this->fragmentCache && !bufEmpty(this->tail))
+                fragmentPut(this, this->tail, WAL_FILTER_FRAGMENT_EXT_TAIL);
+
             // if xl_info and xl_rmid of the header is in current file then read end of record from next file if it exits
             if (this->gotLen >= offsetof(XLogRecord, xl_rmid) + SIZE_OF_STRUCT_MEMBER(XLogRecord, xl_rmid))
             {
@@ -638,8 +1107,25 @@ walFilterProcess(THIS_VOID, const Buffer *const input, Buffer *const output)
         goto end;
     }
 
-    if (readRecord(this, input) == ReadRecordSuccess)
+    // Checksum the records of a new input buffer on worker threads
+    if (this->threadMax > 1 && this->crcInput != input)
+        walFilterCrcRun(this, input);
+
+    // Filter records until the output buffer is full rather than returning to the filter group after each record, which costs more
+    // than filtering a typical small record. Stop at a switch record since the rest of the segment is copied as is.
+    do
     {
+        // Remember the page where the record begins in case it is not complete at the end of the segment
+        if (this->currentStep == noStep)
+        {
+            this->recordBegin =
+                this->pageOffset == 0 || this->pageOffset == this->walPageSize ?
+                    this->inputBegin + this->inputOffset : this->inputBegin + this->inputOffset - this->walPageSize;
+        }
+
+        if (readRecord(this, input) == ReadRecordNeedBuffer)
+            break;
+
         // In the case of overwrite contrecord, we do not need to try to filter it, since the record may not have a body at all.
         if (this->gotLen == this->record->xl_tot_len)
         {
@@ -651,7 +1137,11 @@ walFilterProcess(THIS_VOID, const Buffer *const input, Buffer *const output)
         this->inputSame = true;
         lstClearFast(this->pageHeaders);
     }
+    while (!this->isSwitchWal && !bufFull(output));
 end:
+    if (input != NULL && !this->inputSame)
+        inputDone(this, input);
+
     FUNCTION_LOG_RETURN_VOID();
 }
 
@@ -696,8 +1186,23 @@ walFilterNew(const PgControl pgControl, const ArchiveGetFile *const archiveInfo)
             .heapPageSize = pgControl.pageSize,
             .walPageSize = pgControl.walPageSize,
             .segSize = pgControl.walSegmentSize,
+            // Consecutive segments are filtered into the spool by async archive-get so cache the boundary fragments there
+            .fragmentCache = cfgCommand() == cfgCmdArchiveGet && cfgOptionTest(cfgOptSpoolPath),
+            .threadMax = ioThread() ? WAL_FILTER_THREAD_MAX : 1,
         };
 
+        if (this->threadMax > 1)
+        {
+            this->threadPool = threadPoolNew(this->threadMax);
+            this->crcJobList = memNew(sizeof(WalFilterCrcJob) * this->threadMax);
+        }
+
+        if (this->fragmentCache)
+        {
+            this->fragmentName = fragmentName(archiveInfo->file);
+            this->tail = bufNew(0);
+        }
+
         StringId fork = cfgOptionStrId(cfgOptFork);
         for (unsigned int i = 0; i < LENGTH_OF(interfaces); i++)
         {
@@ -720,3 +1225,48 @@ walFilterNew(const PgControl pgControl, const ArchiveGetFile *const archiveInfo)
             WAL_FILTER_TYPE, this, NULL, .done = WalFilterDone, .inOut = walFilterProcess,
             .inputSame = WalFilterInputSame));
 }
+
+/**********************************************************************************************************************************/
+FN_EXTERN void
+walFilterFragmentClean(const String *const walSegment, const size_t walSegmentSize)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(STRING, walSegment);
+        FUNCTION_LOG_PARAM(SIZE, walSegmentSize);
+    FUNCTION_LOG_END();
+
+    ASSERT(walSegment != NULL);
+    ASSERT(strSize(walSegment) == WAL_SEGMENT_NAME_SIZE);
+    ASSERT(walSegmentSize > 0);
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        // The segment before the requested segment is kept since its tail is needed to filter the first record of the requested
+        // segment
+        const uint32_t timeline = pgTimelineFromWalSegment(walSegment);
+        uint32_t major = (uint32_t)strtol(strZ(strSubN(walSegment, 8, 8)), NULL, 16);
+        uint32_t minor = (uint32_t)strtol(strZ(strSubN(walSegment, 16, 8)), NULL, 16);
+
+        if (minor == 0)
+        {
+            major--;
+            minor = (uint32_t)(UINT32_MAX / walSegmentSize);
+        }
+        else
+            minor--;
+
+        const String *const walSegmentPrior = strNewFmt("%08X%08X%08X", timeline, major, minor);
+        const StringList *const fragmentList = storageListP(storageSpool(), STRDEF(WAL_FILTER_FRAGMENT_PATH));
+
+        for (unsigned int fragmentIdx = 0; fragmentIdx < strLstSize(fragmentList); fragmentIdx++)
+        {
+            const String *const fragment = strLstGet(fragmentList, fragmentIdx);
+
+            if (strCmp(strSubN(fragment, 0, WAL_SEGMENT_NAME_SIZE), walSegmentPrior) < 0)
+                storageRemoveP(storageSpoolWrite(), strNewFmt(WAL_FILTER_FRAGMENT_PATH "/%s", strZ(fragment)));
+        }
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_LOG_RETURN_VOID();
+}
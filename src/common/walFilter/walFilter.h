@@ -6,4 +6,7 @@
 
 FN_EXTERN IoFilter *walFilterNew(PgControl pgControl, const ArchiveGetFile *archiveInfo);
 
+// Remove record fragments cached in the spool for segments older than the segment before the specified segment
+FN_EXTERN void walFilterFragmentClean(const String *walSegment, size_t walSegmentSize);
+
 #endif // COMMON_WALFILTER_WALFILTER_H
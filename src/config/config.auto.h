@@ -48,16 +48,24 @@ Option constants
 #define CFGOPT_ARCHIVE_ASYNC                                        "archive-async"
 #define CFGOPT_ARCHIVE_CHECK                                        "archive-check"
 #define CFGOPT_ARCHIVE_COPY                                         "archive-copy"
+#define CFGOPT_ARCHIVE_DICT                                         "archive-dict"
+#define CFGOPT_ARCHIVE_GET_QUEUE_ADAPT                              "archive-get-queue-adapt"
 #define CFGOPT_ARCHIVE_GET_QUEUE_MAX                                "archive-get-queue-max"
+#define CFGOPT_ARCHIVE_GET_QUEUE_TARGET                             "archive-get-queue-target"
 #define CFGOPT_ARCHIVE_HEADER_CHECK                                 "archive-header-check"
 #define CFGOPT_ARCHIVE_MISSING_RETRY                                "archive-missing-retry"
 #define CFGOPT_ARCHIVE_MODE                                         "archive-mode"
 #define CFGOPT_ARCHIVE_MODE_CHECK                                   "archive-mode-check"
+#define CFGOPT_ARCHIVE_PUSH_BUNDLE                                  "archive-push-bundle"
+#define CFGOPT_ARCHIVE_PUSH_BUNDLE_DELAY                            "archive-push-bundle-delay"
+#define CFGOPT_ARCHIVE_PUSH_BUNDLE_SIZE                             "archive-push-bundle-size"
+#define CFGOPT_ARCHIVE_PUSH_LINGER                                  "archive-push-linger"
 #define CFGOPT_ARCHIVE_PUSH_QUEUE_MAX                               "archive-push-queue-max"
 #define CFGOPT_ARCHIVE_TIMEOUT                                      "archive-timeout"
 #define CFGOPT_BACKUP_STANDBY                                       "backup-standby"
 #define CFGOPT_BETA                                                 "beta"
 #define CFGOPT_BUFFER_SIZE                                          "buffer-size"
+#define CFGOPT_CHECKSUM_FAST                                        "checksum-fast"
 #define CFGOPT_CHECKSUM_PAGE                                        "checksum-page"
 #define CFGOPT_CIPHER_PASS                                          "cipher-pass"
 #define CFGOPT_CMD                                                  "cmd"
@@ -65,6 +73,8 @@ Option constants
 #define CFGOPT_COMPRESS                                             "compress"
 #define CFGOPT_COMPRESS_LEVEL                                       "compress-level"
 #define CFGOPT_COMPRESS_LEVEL_NETWORK                               "compress-level-network"
+#define CFGOPT_COMPRESS_LONG                                        "compress-long"
+#define CFGOPT_COMPRESS_THREAD                                      "compress-thread"
 #define CFGOPT_COMPRESS_TYPE                                        "compress-type"
 #define CFGOPT_CONFIG                                               "config"
 #define CFGOPT_CONFIG_INCLUDE_PATH                                  "config-include-path"
@@ -73,6 +83,7 @@ Option constants
 #define CFGOPT_DB_INCLUDE                                           "db-include"
 #define CFGOPT_DB_TIMEOUT                                           "db-timeout"
 #define CFGOPT_DELTA                                                "delta"
+#define CFGOPT_DELTA_LSN                                            "delta-lsn"
 #define CFGOPT_DRY_RUN                                              "dry-run"
 #define CFGOPT_EXCLUDE                                              "exclude"
 #define CFGOPT_EXEC_ID                                              "exec-id"
@@ -81,6 +92,7 @@ Option constants
 #define CFGOPT_FORCE                                                "force"
 #define CFGOPT_FORK                                                 "fork"
 #define CFGOPT_IGNORE_MISSING                                       "ignore-missing"
+#define CFGOPT_IO_THREAD                                            "io-thread"
 #define CFGOPT_IO_TIMEOUT                                           "io-timeout"
 #define CFGOPT_JOB_RETRY                                            "job-retry"
 #define CFGOPT_JOB_RETRY_INTERVAL                                   "job-retry-interval"
@@ -93,6 +105,7 @@ Option constants
 #define CFGOPT_LOG_PATH                                             "log-path"
 #define CFGOPT_LOG_SUBPROCESS                                       "log-subprocess"
 #define CFGOPT_LOG_TIMESTAMP                                        "log-timestamp"
+#define CFGOPT_MANIFEST_BINARY                                      "manifest-binary"
 #define CFGOPT_MANIFEST_SAVE_THRESHOLD                              "manifest-save-threshold"
 #define CFGOPT_NEUTRAL_UMASK                                        "neutral-umask"
 #define CFGOPT_ONLINE                                               "online"
@@ -101,6 +114,7 @@ Option constants
 #define CFGOPT_PG                                                   "pg"
 #define CFGOPT_PG_VERSION_FORCE                                     "pg-version-force"
 #define CFGOPT_PROCESS                                              "process"
+#define CFGOPT_PROCESS_JOB_MAX                                      "process-job-max"
 #define CFGOPT_PROCESS_MAX                                          "process-max"
 #define CFGOPT_PROTOCOL_TIMEOUT                                     "protocol-timeout"
 #define CFGOPT_RAW                                                  "raw"
@@ -137,7 +151,7 @@ Option constants
 #define CFGOPT_TYPE                                                 "type"
 #define CFGOPT_VERBOSE                                              "verbose"
 
-#define CFG_OPTION_TOTAL                                            181
+#define CFG_OPTION_TOTAL                                            198
 
 /***********************************************************************************************************************************
 Option value constants
@@ -237,6 +251,8 @@ Option value constants
 
 #define CFGOPTVAL_REPO_CIPHER_TYPE_AES_256_CBC                      STRID5("aes-256-cbc", 0xc43dfbbcdcca10)
 #define CFGOPTVAL_REPO_CIPHER_TYPE_AES_256_CBC_Z                    "aes-256-cbc"
+#define CFGOPTVAL_REPO_CIPHER_TYPE_AES_256_GCM                      STRID5("aes-256-gcm", 0x3467dfbbcdcca10)
+#define CFGOPTVAL_REPO_CIPHER_TYPE_AES_256_GCM_Z                    "aes-256-gcm"
 #define CFGOPTVAL_REPO_CIPHER_TYPE_NONE                             STRID5("none", 0x2b9ee0)
 #define CFGOPTVAL_REPO_CIPHER_TYPE_NONE_Z                           "none"
 
@@ -394,16 +410,24 @@ typedef enum
     cfgOptArchiveAsync,
     cfgOptArchiveCheck,
     cfgOptArchiveCopy,
+    cfgOptArchiveDict,
+    cfgOptArchiveGetQueueAdapt,
     cfgOptArchiveGetQueueMax,
+    cfgOptArchiveGetQueueTarget,
     cfgOptArchiveHeaderCheck,
     cfgOptArchiveMissingRetry,
     cfgOptArchiveMode,
     cfgOptArchiveModeCheck,
+    cfgOptArchivePushBundle,
+    cfgOptArchivePushBundleDelay,
+    cfgOptArchivePushBundleSize,
+    cfgOptArchivePushLinger,
     cfgOptArchivePushQueueMax,
     cfgOptArchiveTimeout,
     cfgOptBackupStandby,
     cfgOptBeta,
     cfgOptBufferSize,
+    cfgOptChecksumFast,
     cfgOptChecksumPage,
     cfgOptCipherPass,
     cfgOptCmd,
@@ -411,6 +435,8 @@ typedef enum
     cfgOptCompress,
     cfgOptCompressLevel,
     cfgOptCompressLevelNetwork,
+    cfgOptCompressLong,
+    cfgOptCompressThread,
     cfgOptCompressType,
     cfgOptConfig,
     cfgOptConfigIncludePath,
@@ -419,6 +445,7 @@ typedef enum
     cfgOptDbInclude,
     cfgOptDbTimeout,
     cfgOptDelta,
+    cfgOptDeltaLsn,
     cfgOptDryRun,
     cfgOptExclude,
     cfgOptExecId,
@@ -427,6 +454,7 @@ typedef enum
     cfgOptForce,
     cfgOptFork,
     cfgOptIgnoreMissing,
+    cfgOptIoThread,
     cfgOptIoTimeout,
     cfgOptJobRetry,
     cfgOptJobRetryInterval,
@@ -439,6 +467,7 @@ typedef enum
     cfgOptLogPath,
     cfgOptLogSubprocess,
     cfgOptLogTimestamp,
+    cfgOptManifestBinary,
     cfgOptManifestSaveThreshold,
     cfgOptNeutralUmask,
     cfgOptOnline,
@@ -465,6 +494,7 @@ typedef enum
     cfgOptPgUser,
     cfgOptPgVersionForce,
     cfgOptProcess,
+    cfgOptProcessJobMax,
     cfgOptProcessMax,
     cfgOptProtocolTimeout,
     cfgOptRaw,
@@ -482,6 +512,7 @@ typedef enum
     cfgOptRepoBlock,
     cfgOptRepoBlockAgeMap,
     cfgOptRepoBlockChecksumSizeMap,
+    cfgOptRepoBlockDedup,
     cfgOptRepoBlockSizeMap,
     cfgOptRepoBlockSizeSuper,
     cfgOptRepoBlockSizeSuperFull,
@@ -538,6 +569,8 @@ typedef enum
     cfgOptRepoSftpPublicKeyFile,
     cfgOptRepoStorageCaFile,
     cfgOptRepoStorageCaPath,
+    cfgOptRepoStorageDownloadChunkSize,
+    cfgOptRepoStorageDownloadMax,
     cfgOptRepoStorageHost,
     cfgOptRepoStoragePort,
     cfgOptRepoStorageTag,
@@ -544,6 +544,10 @@ cfgLoad(const unsigned int argListSize, const char *argList[])
             if (cfgOptionValid(cfgOptBufferSize))
                 ioBufferSizeSet(cfgOptionUInt(cfgOptBufferSize));
 
+            // Run filters on threads
+            if (cfgOptionValid(cfgOptIoThread))
+                ioThreadSet(cfgOptionBool(cfgOptIoThread));
+
             // Set IO timeout
             if (cfgOptionValid(cfgOptIoTimeout))
                 ioTimeoutMsSet(cfgOptionUInt64(cfgOptIoTimeout));
@@ -102,7 +102,7 @@ infoNew(const String *const cipherPass)
 
     OBJ_NEW_BEGIN(Info, .childQty = MEM_CONTEXT_QTY_MAX)
     {
-        *this = (Info){};
+        *this = (Info){.pub = {.cipherType = cipherPass == NULL ? cipherTypeNone : cipherTypeAes256Cbc}};
 
         // Cipher used to encrypt/decrypt subsequent dependent files. Value may be NULL.
         infoCipherPassSet(this, cipherPass);
@@ -118,6 +118,7 @@ infoNew(const String *const cipherPass)
 #define INFO_KEY_CHECKSUM                                           "backrest-checksum"
 #define INFO_SECTION_CIPHER                                         "cipher"
 #define INFO_KEY_CIPHER_PASS                                        "cipher-pass"
+#define INFO_KEY_CIPHER_TYPE                                        "cipher-type"
 
 FN_EXTERN Info *
 infoNewLoad(IoRead *const read, InfoLoadNewCallback *const callbackFunction, void *const callbackData)
@@ -136,7 +137,7 @@ infoNewLoad(IoRead *const read, InfoLoadNewCallback *const callbackFunction, voi
 
     OBJ_NEW_BEGIN(Info, .childQty = MEM_CONTEXT_QTY_MAX)
     {
-        *this = (Info){};
+        *this = (Info){.pub = {.cipherType = cipherTypeNone}};
 
         MEM_CONTEXT_TEMP_BEGIN()
         {
@@ -217,6 +218,9 @@ infoNewLoad(IoRead *const read, InfoLoadNewCallback *const callbackFunction, voi
                                 }
                                 MEM_CONTEXT_END();
                             }
+                            // Store cipher type
+                            else if (strEqZ(value->key, INFO_KEY_CIPHER_TYPE))
+                                this->pub.cipherType = strIdFromStr(varStr(jsonToVar(value->value)));
                         }
                         // Else pass to callback for processing
                         else
@@ -248,6 +252,10 @@ infoNewLoad(IoRead *const read, InfoLoadNewCallback *const callbackFunction, voi
                     ChecksumError, "invalid checksum, actual '%s' but expected '%s'", strZ(checksumActual),
                     strZ(checksumExpected));
             }
+
+            // Files written before the cipher type was stored were always encrypted with aes-256-cbc
+            if (this->pub.cipherPass != NULL && this->pub.cipherType == cipherTypeNone)
+                this->pub.cipherType = cipherTypeAes256Cbc;
         }
         MEM_CONTEXT_TEMP_END();
     }
@@ -365,11 +373,18 @@ infoSave(Info *const this, IoWrite *const write, InfoSaveCallback *const callbac
         infoSaveValue(&data, INFO_SECTION_BACKREST, INFO_KEY_FORMAT, jsonFromVar(VARUINT(REPOSITORY_FORMAT)));
         infoSaveValue(&data, INFO_SECTION_BACKREST, INFO_KEY_VERSION, jsonFromVar(VARSTRDEF(PROJECT_VERSION)));
 
-        // Add cipher passphrase if defined
+        // Add cipher passphrase if defined. The cipher type is only stored when it is not aes-256-cbc so files remain readable by
+        // prior versions when the type has not been changed from the original default.
         if (infoCipherPass(this) != NULL)
         {
             callbackFunction(callbackData, STRDEF(INFO_SECTION_CIPHER), &data);
             infoSaveValue(&data, INFO_SECTION_CIPHER, INFO_KEY_CIPHER_PASS, jsonFromVar(VARSTR(infoCipherPass(this))));
+
+            if (infoCipherType(this) != cipherTypeNone && infoCipherType(this) != cipherTypeAes256Cbc)
+            {
+                infoSaveValue(
+                    &data, INFO_SECTION_CIPHER, INFO_KEY_CIPHER_TYPE, jsonFromVar(VARSTR(strIdToStr(infoCipherType(this)))));
+            }
         }
 
         // Flush out any additional sections
@@ -415,6 +430,47 @@ infoCipherPassSet(Info *const this, const String *const cipherPass)
     FUNCTION_TEST_RETURN_VOID();
 }
 
+FN_EXTERN void
+infoCipherTypeSet(Info *const this, const CipherType cipherType)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(INFO, this);
+        FUNCTION_TEST_PARAM(STRING_ID, cipherType);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+
+    this->pub.cipherType = cipherType;
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+/**********************************************************************************************************************************/
+FN_EXTERN void
+infoCipherTypeCheck(const Info *const this, const CipherType cipherType, const String *const fileName)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(INFO, this);
+        FUNCTION_TEST_PARAM(STRING_ID, cipherType);
+        FUNCTION_TEST_PARAM(STRING, fileName);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+    ASSERT(fileName != NULL);
+
+    // An unencrypted file cannot contain a passphrase for an encrypted repo, so there is nothing to check when the type is none
+    if (cipherType != cipherTypeNone && infoCipherPass(this) != NULL && infoCipherType(this) != cipherType)
+    {
+        THROW_FMT(
+            CryptoError,
+            "cipher type '%s' does not match '%s' stored in '%s'\n"
+            "HINT: the repo cipher type cannot be changed after the stanza has been created.",
+            strZ(strIdToStr(cipherType)), strZ(strIdToStr(infoCipherType(this))), strZ(fileName));
+    }
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
 /**********************************************************************************************************************************/
 FN_EXTERN void
 infoLoad(const String *const error, InfoLoadCallback *const callbackFunction, void *const callbackData)
@@ -10,6 +10,7 @@ Object type
 typedef struct Info Info;
 typedef struct InfoSave InfoSave;
 
+#include "common/crypto/common.h"
 #include "common/ini.h"
 #include "storage/storage.h"
 
@@ -49,6 +50,7 @@ typedef struct InfoPub
 {
     const String *backrestVersion;                                  // pgBackRest version
     const String *cipherPass;                                       // Cipher passphrase if set
+    CipherType cipherType;                                          // Cipher type used with the passphrase
 } InfoPub;
 
 // Cipher passphrase if set
@@ -60,6 +62,16 @@ infoCipherPass(const Info *const this)
 
 FN_EXTERN void infoCipherPassSet(Info *this, const String *cipherPass);
 
+// Cipher type used to encrypt dependent files with the passphrase. Files written before the type was stored do not have it so
+// aes-256-cbc is assumed when a passphrase is set.
+FN_INLINE_ALWAYS CipherType
+infoCipherType(const Info *const this)
+{
+    return THIS_PUB(Info)->cipherType;
+}
+
+FN_EXTERN void infoCipherTypeSet(Info *this, CipherType cipherType);
+
 // pgBackRest version
 FN_INLINE_ALWAYS const String *
 infoBackrestVersion(const Info *const this)
@@ -70,6 +82,9 @@ infoBackrestVersion(const Info *const this)
 /***********************************************************************************************************************************
 Functions
 ***********************************************************************************************************************************/
+// Error when the cipher type stored in the file does not match the cipher type used to load it
+FN_EXTERN void infoCipherTypeCheck(const Info *this, CipherType cipherType, const String *fileName);
+
 // Save to file
 FN_EXTERN void infoSave(Info *this, IoWrite *write, InfoSaveCallback *callbackFunction, void *callbackData);
 
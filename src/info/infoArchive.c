@@ -295,6 +295,9 @@ infoArchiveLoadFile(
                 errorMessage());
         }
         TRY_END();
+
+        // Dependent files are encrypted with the stored cipher type so the configured type must match it
+        infoCipherTypeCheck(infoPgInfo(infoArchivePg(data.infoArchive)), cipherType, storagePathP(storage, fileName));
     }
     MEM_CONTEXT_TEMP_END();
 
@@ -320,6 +323,10 @@ infoArchiveSaveFile(
     ASSERT(fileName != NULL);
     ASSERT((cipherType == cipherTypeNone && cipherPass == NULL) || (cipherType != cipherTypeNone && cipherPass != NULL));
 
+    // Store the cipher type used to encrypt dependent files
+    if (infoPgCipherPass(infoArchivePg(infoArchive)) != NULL)
+        infoCipherTypeSet(infoPgInfo(infoArchivePg(infoArchive)), cipherType);
+
     MEM_CONTEXT_TEMP_BEGIN()
     {
         // Write output into a buffer since it needs to be saved to storage twice
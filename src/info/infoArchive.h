@@ -66,6 +66,13 @@ infoArchiveCipherPass(const InfoArchive *const this)
     return infoPgCipherPass(infoArchivePg(this));
 }
 
+// Cipher type
+FN_INLINE_ALWAYS CipherType
+infoArchiveCipherType(const InfoArchive *const this)
+{
+    return infoPgCipherType(infoArchivePg(this));
+}
+
 /***********************************************************************************************************************************
 Functions
 ***********************************************************************************************************************************/
@@ -747,6 +747,9 @@ infoBackupLoadFile(
                 errorMessage());
         }
         TRY_END();
+
+        // Dependent files are encrypted with the stored cipher type so the configured type must match it
+        infoCipherTypeCheck(infoPgInfo(infoBackupPg(data.infoBackup)), cipherType, storagePathP(storage, fileName));
     }
     MEM_CONTEXT_TEMP_END();
 
@@ -877,6 +880,10 @@ infoBackupSaveFile(
     ASSERT(fileName != NULL);
     ASSERT((cipherType == cipherTypeNone && cipherPass == NULL) || (cipherType != cipherTypeNone && cipherPass != NULL));
 
+    // Store the cipher type used to encrypt dependent files
+    if (infoPgCipherPass(infoBackupPg(infoBackup)) != NULL)
+        infoCipherTypeSet(infoPgInfo(infoBackupPg(infoBackup)), cipherType);
+
     MEM_CONTEXT_TEMP_BEGIN()
     {
         // Write output into a buffer since it needs to be saved to storage twice
@@ -3,18 +3,21 @@ Backup Manifest Handler
 ***********************************************************************************************************************************/
 #include "build.auto.h"
 
-#include <ctype.h>
 #include <string.h>
 #include <time.h>
 
 #include "common/crypto/cipherBlock.h"
+#include "common/crypto/hash.h"
 #include "common/debug.h"
+#include "common/io/bufferRead.h"
+#include "common/io/bufferWrite.h"
 #include "common/log.h"
 #include "common/regExp.h"
 #include "common/type/json.h"
 #include "common/type/list.h"
 #include "info/manifest.h"
 #include "postgres/interface.h"
+#include "postgres/interface/static.vendor.h"
 #include "postgres/version.h"
 #include "storage/storage.h"
 #include "version.h"
@@ -115,8 +118,132 @@ typedef enum
     manifestFilePackFlagUserNull,
     manifestFilePackFlagGroup,
     manifestFilePackFlagGroupNull,
+    manifestFilePackFlagRelation,
+    manifestFilePackFlagRelationTablespace,
+    manifestFilePackFlagChecksumFast,
+    manifestFilePackFlagChecksumRepoFast,
 } ManifestFilePackFlag;
 
+// Parse an oid and advance the name past it. Zero is returned when there is no oid since zero is never a valid oid.
+static unsigned int
+manifestFileRelationOid(const char **const name)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_PP(CHARDATA, name);
+    FUNCTION_TEST_END();
+
+    const char *nameEnd = *name;
+    uint64_t result = 0;
+
+    while (*nameEnd >= '0' && *nameEnd <= '9' && result <= UINT_MAX)
+        result = result * 10 + (uint64_t)(*nameEnd++ - '0');
+
+    if (result > UINT_MAX)
+        result = 0;
+
+    if (result != 0)
+        *name = nameEnd;
+
+    FUNCTION_TEST_RETURN(UINT, (unsigned int)result);
+}
+
+// Derive the relation identity of a file from its name. Names are parsed by hand rather than with a regular expression since every
+// file in the manifest is parsed. The tablespace version path is not checked because the manifest only contains the path for the
+// current version.
+static void
+manifestFileRelation(ManifestFile *const file)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(MANIFEST_FILE, file);
+    FUNCTION_TEST_END();
+
+    ASSERT(file != NULL);
+
+    const char *name = strZ(file->name);
+    unsigned int dbId = 0;
+    unsigned int tablespaceId = 0;
+
+    file->dbId = 0;
+    file->tablespaceId = 0;
+    file->relFileNode = 0;
+    file->relSegNo = 0;
+    file->relFork = manifestRelationForkMain;
+
+    // Find the database path (or global path) that contains the file
+    if (strBeginsWithZ(file->name, MANIFEST_TARGET_PGDATA "/" PG_PATH_BASE "/"))
+    {
+        name += sizeof(MANIFEST_TARGET_PGDATA "/" PG_PATH_BASE "/") - 1;
+        dbId = manifestFileRelationOid(&name);
+        tablespaceId = DEFAULTTABLESPACE_OID;
+    }
+    else if (strBeginsWithZ(file->name, MANIFEST_TARGET_PGDATA "/" PG_PATH_GLOBAL "/"))
+    {
+        name += sizeof(MANIFEST_TARGET_PGDATA "/" PG_PATH_GLOBAL) - 1;
+        tablespaceId = GLOBALTABLESPACE_OID;
+    }
+    else if (strBeginsWithZ(file->name, MANIFEST_TARGET_PGTBLSPC "/"))
+    {
+        name += sizeof(MANIFEST_TARGET_PGTBLSPC "/") - 1;
+        tablespaceId = manifestFileRelationOid(&name);
+
+        // Skip the tablespace version path
+        if (tablespaceId != 0 && *name == '/' && (name = strchr(name + 1, '/')) != NULL)
+        {
+            name++;
+            dbId = manifestFileRelationOid(&name);
+        }
+    }
+
+    // The file must be directly in the database path, or in the global path
+    if ((dbId != 0 || tablespaceId == GLOBALTABLESPACE_OID) && *name == '/' && strchr(name + 1, '/') == NULL)
+    {
+        file->dbId = dbId;
+        file->tablespaceId = tablespaceId;
+
+        // The file is a relation if it has an oid followed by an optional fork and an optional segment number
+        name++;
+
+        const unsigned int relFileNode = manifestFileRelationOid(&name);
+        ManifestRelationFork relFork = manifestRelationForkMain;
+        unsigned int relSegNo = 0;
+
+        if (strncmp(name, "_fsm", sizeof("_fsm") - 1) == 0)
+        {
+            name += sizeof("_fsm") - 1;
+            relFork = manifestRelationForkFsm;
+        }
+        else if (strncmp(name, "_vm", sizeof("_vm") - 1) == 0)
+        {
+            name += sizeof("_vm") - 1;
+            relFork = manifestRelationForkVm;
+        }
+        else if (strncmp(name, "_init", sizeof("_init") - 1) == 0)
+        {
+            name += sizeof("_init") - 1;
+            relFork = manifestRelationForkInit;
+        }
+
+        if (*name == '.')
+        {
+            name++;
+            relSegNo = manifestFileRelationOid(&name);
+
+            // Make sure the name does not end here when the segment number is missing
+            if (relSegNo == 0)
+                name--;
+        }
+
+        if (relFileNode != 0 && *name == '\0')
+        {
+            file->relFileNode = relFileNode;
+            file->relSegNo = relSegNo;
+            file->relFork = relFork;
+        }
+    }
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
 // Pack file into a compact format to save memory
 static ManifestFilePack *
 manifestFilePack(const Manifest *const manifest, const ManifestFile *const file)
@@ -141,6 +268,12 @@ manifestFilePack(const Manifest *const manifest, const ManifestFile *const file)
     if (file->checksumRepoSha1 != NULL)
         flag |= 1 << manifestFilePackFlagChecksumRepo;
 
+    if (file->checksumFast != NULL)
+        flag |= 1 << manifestFilePackFlagChecksumFast;
+
+    if (file->checksumRepoFast != NULL)
+        flag |= 1 << manifestFilePackFlagChecksumRepoFast;
+
     if (file->copy)
         flag |= 1 << manifestFilePackFlagCopy;
 
@@ -187,6 +320,18 @@ manifestFilePack(const Manifest *const manifest, const ManifestFile *const file)
     else if (!strEq(file->group, manifest->fileGroupDefault))
         flag |= 1 << manifestFilePackFlagGroup;
 
+    // Relation identity is always derived from the name so it cannot get out of sync when the file is updated
+    ManifestFile relation = {.name = file->name};
+    manifestFileRelation(&relation);
+
+    if (relation.tablespaceId != 0)
+    {
+        flag |= 1 << manifestFilePackFlagRelation;
+
+        if (relation.tablespaceId != DEFAULTTABLESPACE_OID)
+            flag |= 1 << manifestFilePackFlagRelationTablespace;
+    }
+
     cvtUInt64ToVarInt128(flag, buffer, &bufferPos, sizeof(buffer));
 
     // Size
@@ -222,6 +367,20 @@ manifestFilePack(const Manifest *const manifest, const ManifestFile *const file)
         bufferPos += HASH_TYPE_SHA1_SIZE;
     }
 
+    // Fast checksum
+    if (file->checksumFast != NULL)
+    {
+        memcpy((uint8_t *)buffer + bufferPos, file->checksumFast, MANIFEST_CHECKSUM_FAST_SIZE);
+        bufferPos += MANIFEST_CHECKSUM_FAST_SIZE;
+    }
+
+    // Fast repo checksum
+    if (file->checksumRepoFast != NULL)
+    {
+        memcpy((uint8_t *)buffer + bufferPos, file->checksumRepoFast, MANIFEST_CHECKSUM_FAST_SIZE);
+        bufferPos += MANIFEST_CHECKSUM_FAST_SIZE;
+    }
+
     // Reference
     if (file->reference != NULL)
     {
@@ -260,6 +419,17 @@ manifestFilePack(const Manifest *const manifest, const ManifestFile *const file)
         cvtUInt64ToVarInt128(file->blockIncrMapSize, buffer, &bufferPos, sizeof(buffer));
     }
 
+    // Relation
+    if (flag & (1 << manifestFilePackFlagRelation))
+    {
+        cvtUInt64ToVarInt128(relation.dbId, buffer, &bufferPos, sizeof(buffer));
+        cvtUInt64ToVarInt128(relation.relFileNode, buffer, &bufferPos, sizeof(buffer));
+        cvtUInt64ToVarInt128((uint64_t)relation.relSegNo << 2 | relation.relFork, buffer, &bufferPos, sizeof(buffer));
+
+        if (flag & (1 << manifestFilePackFlagRelationTablespace))
+            cvtUInt64ToVarInt128(relation.tablespaceId, buffer, &bufferPos, sizeof(buffer));
+    }
+
     // Allocate memory for the file pack
     const size_t nameSize = strSize(file->name) + 1;
 
@@ -359,6 +529,20 @@ manifestFileUnpack(const Manifest *const manifest, const ManifestFilePack *const
         bufferPos += HASH_TYPE_SHA1_SIZE;
     }
 
+    // Fast checksum
+    if (flag & (1 << manifestFilePackFlagChecksumFast))
+    {
+        result.checksumFast = (const uint8_t *)filePack + bufferPos;
+        bufferPos += MANIFEST_CHECKSUM_FAST_SIZE;
+    }
+
+    // Fast repo checksum
+    if (flag & (1 << manifestFilePackFlagChecksumRepoFast))
+    {
+        result.checksumRepoFast = (const uint8_t *)filePack + bufferPos;
+        bufferPos += MANIFEST_CHECKSUM_FAST_SIZE;
+    }
+
     // Reference
     if (flag & (1 << manifestFilePackFlagReference))
     {
@@ -402,6 +586,22 @@ manifestFileUnpack(const Manifest *const manifest, const ManifestFilePack *const
         result.blockIncrMapSize = cvtUInt64FromVarInt128((const uint8_t *)filePack, &bufferPos, UINT_MAX);
     }
 
+    // Relation
+    if (flag & (1 << manifestFilePackFlagRelation))
+    {
+        result.dbId = (unsigned int)cvtUInt64FromVarInt128((const uint8_t *)filePack, &bufferPos, UINT_MAX);
+        result.relFileNode = (unsigned int)cvtUInt64FromVarInt128((const uint8_t *)filePack, &bufferPos, UINT_MAX);
+
+        const uint64_t relSeg = cvtUInt64FromVarInt128((const uint8_t *)filePack, &bufferPos, UINT_MAX);
+        result.relSegNo = (unsigned int)(relSeg >> 2);
+        result.relFork = (ManifestRelationFork)(relSeg & 3);
+
+        if (flag & (1 << manifestFilePackFlagRelationTablespace))
+            result.tablespaceId = (unsigned int)cvtUInt64FromVarInt128((const uint8_t *)filePack, &bufferPos, UINT_MAX);
+        else
+            result.tablespaceId = DEFAULTTABLESPACE_OID;
+    }
+
     // Checksum page error
     result.checksumPageError = flag & (1 << manifestFilePackFlagChecksumPageError) ? true : false;
 
@@ -1450,10 +1650,11 @@ manifestNewBuild(
             // to check for _init files which will sort after the vast majority of the relation files. We could check storage for
             // each _init file but that would be expensive.
             // -------------------------------------------------------------------------------------------------------------------------
-            RegExp *relationExp = regExpNew(strNewFmt("^" DB_PATH_EXP "/" RELATION_EXP "$", strZ(buildData.tablespaceId)));
             unsigned int fileIdx = 0;
-            char lastRelationFileId[21] = "";                   // Large enough for a 64-bit unsigned integer
-            bool lastRelationFileIdUnlogged = false;
+            unsigned int lastRelationDbId = 0;
+            unsigned int lastRelationTablespaceId = 0;
+            unsigned int lastRelationFileNode = 0;
+            bool lastRelationUnlogged = false;
 
 #ifdef DEBUG_MEM
             // Record the temp context size before the loop begins
@@ -1462,49 +1663,32 @@ manifestNewBuild(
 
             while (fileIdx < manifestFileTotal(this))
             {
-                // If this file looks like a relation. Note that this never matches on _init forks.
-                const String *const filePathName = manifestFileNameGet(this, fileIdx);
+                // If this file is a relation. The _init fork is skipped since it is never removed.
+                const ManifestFile file = manifestFileUnpack(this, manifestFilePackGet(this, fileIdx));
 
-                if (regExpMatch(relationExp, filePathName))
+                if (file.relFileNode != 0 && file.relFork != manifestRelationForkInit)
                 {
-                    // Get the filename (without path)
-                    const char *const fileName = strBaseZ(filePathName);
-                    const size_t fileNameSize = strlen(fileName);
-
-                    // Strip off the numeric part of the relation
-                    char relationFileId[sizeof(lastRelationFileId)];
-                    unsigned int nameIdx = 0;
-
-                    for (; nameIdx < fileNameSize; nameIdx++)
-                    {
-                        if (!isdigit(fileName[nameIdx]))
-                            break;
-
-                        relationFileId[nameIdx] = fileName[nameIdx];
-                    }
-
-                    relationFileId[nameIdx] = '\0';
-
-                    // The filename must have characters
-                    ASSERT(relationFileId[0] != '\0');
-
                     // Store the last relation so it does not need to be found everytime
-                    if (strcmp(lastRelationFileId, relationFileId) != 0)
+                    if (file.relFileNode != lastRelationFileNode || file.dbId != lastRelationDbId ||
+                        file.tablespaceId != lastRelationTablespaceId)
                     {
                         // Determine if the relation is unlogged
+                        const char *const fileName = strBaseZ(file.name);
                         String *const relationInit = strNewFmt(
-                            "%.*s%s_init", (int)(strSize(filePathName) - fileNameSize), strZ(filePathName), relationFileId);
-                        lastRelationFileIdUnlogged = manifestFileExists(this, relationInit);
+                            "%.*s%u_init", (int)(strSize(file.name) - strlen(fileName)), strZ(file.name), file.relFileNode);
+                        lastRelationUnlogged = manifestFileExists(this, relationInit);
                         strFree(relationInit);
 
-                        // Save the file id so we don't need to do the lookup next time if it doesn't change
-                        strcpy(lastRelationFileId, relationFileId);
+                        // Save the relation so we don't need to do the lookup next time if it doesn't change
+                        lastRelationDbId = file.dbId;
+                        lastRelationTablespaceId = file.tablespaceId;
+                        lastRelationFileNode = file.relFileNode;
                     }
 
                     // If relation is unlogged then remove it
-                    if (lastRelationFileIdUnlogged)
+                    if (lastRelationUnlogged)
                     {
-                        manifestFileRemove(this, filePathName);
+                        manifestFileRemove(this, file.name);
                         continue;
                     }
                 }
@@ -1735,6 +1919,8 @@ manifestBuildIncr(
                         file.sizeRepo = filePrior.sizeRepo;
                         file.checksumSha1 = filePrior.checksumSha1;
                         file.checksumRepoSha1 = filePrior.checksumRepoSha1;
+                        file.checksumFast = filePrior.checksumFast;
+                        file.checksumRepoFast = filePrior.checksumRepoFast;
                         file.reference = filePrior.reference != NULL ? filePrior.reference : manifestPrior->pub.data.backupLabel;
                         file.checksumPage = filePrior.checksumPage;
                         file.checksumPageError = filePrior.checksumPageError;
@@ -1909,6 +2095,8 @@ manifestBuildComplete(
 #define MANIFEST_KEY_BUNDLE_OFFSET                                  STRID5("bno", 0x3dc20)
 #define MANIFEST_KEY_CHECKSUM                                       STRID5("checksum", 0x6d66b195030)
 #define MANIFEST_KEY_CHECKSUM_REPO                                  STRID5("rck", 0x2c720)
+#define MANIFEST_KEY_CHECKSUM_FAST                                  STRID5("fck", 0x2c660)
+#define MANIFEST_KEY_CHECKSUM_REPO_FAST                             STRID5("frck", 0x58e460)
 #define MANIFEST_KEY_CHECKSUM_PAGE                                  "checksum-page"
 #define MANIFEST_KEY_CHECKSUM_PAGE_ERROR                            "checksum-page-error"
 #define MANIFEST_KEY_DB_CATALOG_VERSION                             "db-catalog-version"
@@ -2078,6 +2266,13 @@ manifestLoadCallback(void *const callbackData, const String *const section, cons
                 file.checksumPageErrorList = jsonFromVar(jsonReadVar(json));
         }
 
+        // Fast checksums only exist when they were enabled for the backup that copied the file
+        if (jsonReadKeyExpectStrId(json, MANIFEST_KEY_CHECKSUM_FAST))
+            file.checksumFast = bufPtr(bufNewDecode(encodingHex, jsonReadStr(json)));
+
+        if (jsonReadKeyExpectStrId(json, MANIFEST_KEY_CHECKSUM_REPO_FAST))
+            file.checksumRepoFast = bufPtr(bufNewDecode(encodingHex, jsonReadStr(json)));
+
         // Group
         if (jsonReadKeyExpectZ(json, MANIFEST_KEY_GROUP))
             file.group = manifestOwnerGet(jsonReadVar(json));
@@ -2507,6 +2702,7 @@ typedef struct ManifestSaveData
     const Variant *groupDefault;                                    // Default group
     mode_t fileModeDefault;                                         // File default mode
     mode_t pathModeDefault;                                         // Path default mode
+    bool fileSkip;                                                  // Skip the file list (saved separately in binary format)
 } ManifestSaveData;
 
 // Helper to convert the owner MCV to a default. If the input is NULL boolean false should be returned, else the owner string.
@@ -2778,7 +2974,7 @@ manifestSaveCallback(void *const callbackData, const String *const sectionNext,
     }
 
     // -----------------------------------------------------------------------------------------------------------------------------
-    if (infoSaveSection(infoSaveData, MANIFEST_SECTION_TARGET_FILE, sectionNext))
+    if (!saveData->fileSkip && infoSaveSection(infoSaveData, MANIFEST_SECTION_TARGET_FILE, sectionNext))
     {
         MEM_CONTEXT_TEMP_RESET_BEGIN()
         {
@@ -2825,6 +3021,20 @@ manifestSaveCallback(void *const callbackData, const String *const sectionNext,
                         jsonWriteJson(jsonWriteKeyZ(json, MANIFEST_KEY_CHECKSUM_PAGE_ERROR), file.checksumPageErrorList);
                 }
 
+                if (file.checksumFast != NULL)
+                {
+                    jsonWriteStr(
+                        jsonWriteKeyStrId(json, MANIFEST_KEY_CHECKSUM_FAST),
+                        strNewEncode(encodingHex, BUF(file.checksumFast, MANIFEST_CHECKSUM_FAST_SIZE)));
+                }
+
+                if (file.checksumRepoFast != NULL)
+                {
+                    jsonWriteStr(
+                        jsonWriteKeyStrId(json, MANIFEST_KEY_CHECKSUM_REPO_FAST),
+                        strNewEncode(encodingHex, BUF(file.checksumRepoFast, MANIFEST_CHECKSUM_FAST_SIZE)));
+                }
+
                 if (!varEq(manifestOwnerVar(file.group), saveData->groupDefault))
                     jsonWriteVar(jsonWriteKeyZ(json, MANIFEST_KEY_GROUP), manifestOwnerVar(file.group));
 
@@ -2955,12 +3165,13 @@ manifestSaveCallback(void *const callbackData, const String *const sectionNext,
     FUNCTION_TEST_RETURN_VOID();
 }
 
-FN_EXTERN void
-manifestSave(Manifest *const this, IoWrite *const write)
+static void
+manifestSaveInternal(Manifest *const this, IoWrite *const write, const bool fileSkip)
 {
     FUNCTION_LOG_BEGIN(logLevelDebug);
         FUNCTION_LOG_PARAM(MANIFEST, this);
         FUNCTION_LOG_PARAM(IO_WRITE, write);
+        FUNCTION_LOG_PARAM(BOOL, fileSkip);
     FUNCTION_LOG_END();
 
     ASSERT(this != NULL);
@@ -2981,6 +3192,7 @@ manifestSave(Manifest *const this, IoWrite *const write)
             .groupDefault = manifestOwnerVar(pathBase->group),
             .fileModeDefault = pathBase->mode & (S_IRUSR | S_IWUSR | S_IRGRP),
             .pathModeDefault = pathBase->mode,
+            .fileSkip = fileSkip,
         };
 
         // Save manifest
@@ -2991,6 +3203,244 @@ manifestSave(Manifest *const this, IoWrite *const write)
     FUNCTION_LOG_RETURN_VOID();
 }
 
+FN_EXTERN void
+manifestSave(Manifest *const this, IoWrite *const write)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(MANIFEST, this);
+        FUNCTION_TEST_PARAM(IO_WRITE, write);
+    FUNCTION_TEST_END();
+
+    manifestSaveInternal(this, write, false);
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+/**********************************************************************************************************************************/
+/***********************************************************************************************************************************
+Binary manifest
+
+The binary manifest is a pack with the following fields:
+
+- Format version.
+- Text manifest without the file list. This section is small and is loaded with manifestNewLoad() so it does not need a separate
+  encoding.
+- Owner list referenced by index from the file records.
+- File table, a pack with one object per file in name order. Names are front-coded, i.e. only the length of the prefix shared with
+  the prior name and the remaining suffix are stored, and all other fields are stored in native form, so files can be loaded without
+  the JSON and hex parsing required by the text format.
+- SHA1 checksum of the file table. The text manifest has its own checksum.
+***********************************************************************************************************************************/
+#define MANIFEST_BIN_FORMAT                                         1
+
+FN_EXTERN void
+manifestSaveBin(Manifest *const this, IoWrite *const write)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(MANIFEST, this);
+        FUNCTION_LOG_PARAM(IO_WRITE, write);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(write != NULL);
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        // Save everything except the file list as text. This also sorts the file list.
+        Buffer *const header = bufNew(0);
+        manifestSaveInternal(this, ioBufferWriteNew(header), true);
+
+        // Build the file table
+        PackWrite *const fileTable = pckWriteNewP();
+        const String *nameLast = EMPTY_STR;
+
+        for (unsigned int fileIdx = 0; fileIdx < manifestFileTotal(this); fileIdx++)
+        {
+            const ManifestFile file = manifestFile(this, fileIdx);
+
+            // Find the prefix shared with the prior name
+            size_t namePrefix = 0;
+
+            while (
+                namePrefix < strSize(nameLast) && namePrefix < strSize(file.name) &&
+                strZ(nameLast)[namePrefix] == strZ(file.name)[namePrefix])
+            {
+                namePrefix++;
+            }
+
+            pckWriteObjBeginP(fileTable);
+            pckWriteU32P(fileTable, (uint32_t)namePrefix);
+            pckWriteStrP(fileTable, strSub(file.name, namePrefix));
+            pckWriteU64P(fileTable, file.size);
+            pckWriteU64P(fileTable, file.sizeOriginal, .defaultValue = file.size);
+            pckWriteU64P(fileTable, file.sizePrior);
+            pckWriteU64P(fileTable, file.sizeRepo, .defaultValue = file.size);
+            pckWriteTimeP(fileTable, file.timestamp);
+            pckWriteModeP(fileTable, file.mode);
+            pckWriteU32P(fileTable, file.user != NULL ? strLstFindIdxP(this->ownerList, file.user, .required = true) + 1 : 0);
+            pckWriteU32P(fileTable, file.group != NULL ? strLstFindIdxP(this->ownerList, file.group, .required = true) + 1 : 0);
+            pckWriteBinP(fileTable, file.checksumSha1 != NULL ? BUF(file.checksumSha1, HASH_TYPE_SHA1_SIZE) : NULL);
+            pckWriteBinP(fileTable, file.checksumRepoSha1 != NULL ? BUF(file.checksumRepoSha1, HASH_TYPE_SHA1_SIZE) : NULL);
+            pckWriteBinP(fileTable, file.checksumFast != NULL ? BUF(file.checksumFast, MANIFEST_CHECKSUM_FAST_SIZE) : NULL);
+            pckWriteBinP(
+                fileTable, file.checksumRepoFast != NULL ? BUF(file.checksumRepoFast, MANIFEST_CHECKSUM_FAST_SIZE) : NULL);
+            pckWriteBoolP(fileTable, file.checksumPage);
+            pckWriteBoolP(fileTable, file.checksumPageError);
+            pckWriteStrP(fileTable, file.checksumPageErrorList);
+            pckWriteU32P(
+                fileTable,
+                file.reference != NULL ? strLstFindIdxP(this->pub.referenceList, file.reference, .required = true) + 1 : 0);
+            pckWriteU64P(fileTable, file.bundleId);
+            pckWriteU64P(fileTable, file.bundleOffset);
+            pckWriteU64P(fileTable, file.blockIncrSize);
+            pckWriteU64P(fileTable, file.blockIncrChecksumSize);
+            pckWriteU64P(fileTable, file.blockIncrMapSize);
+            pckWriteBoolP(fileTable, file.copy);
+            pckWriteBoolP(fileTable, file.delta);
+            pckWriteBoolP(fileTable, file.resume);
+            pckWriteObjEndP(fileTable);
+
+            nameLast = file.name;
+        }
+
+        pckWriteEndP(fileTable);
+
+        // Write the manifest
+        ioWriteOpen(write);
+
+        PackWrite *const pack = pckWriteNewIo(write);
+
+        pckWriteU32P(pack, MANIFEST_BIN_FORMAT);
+        pckWriteStrP(pack, strNewBuf(header));
+        pckWriteStrLstP(pack, this->ownerList);
+        pckWritePackP(pack, pckWriteResult(fileTable));
+        pckWriteBinP(pack, cryptoHashOne(hashTypeSha1, pckToBuf(pckWriteResult(fileTable))));
+        pckWriteEndP(pack);
+
+        ioWriteClose(write);
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_LOG_RETURN_VOID();
+}
+
+FN_EXTERN Manifest *
+manifestNewLoadBin(IoRead *const read)
+{
+    FUNCTION_LOG_BEGIN(logLevelDebug);
+        FUNCTION_LOG_PARAM(IO_READ, read);
+    FUNCTION_LOG_END();
+
+    ASSERT(read != NULL);
+
+    Manifest *this = NULL;
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        PackRead *const pack = pckReadNewIo(read);
+
+        // Check format
+        const unsigned int format = pckReadU32P(pack);
+
+        if (format != MANIFEST_BIN_FORMAT)
+            THROW_FMT(FormatError, "expected binary manifest format %d but found %u", MANIFEST_BIN_FORMAT, format);
+
+        const String *const header = pckReadStrP(pack);
+        const StringList *const ownerList = pckReadStrLstP(pack);
+        const Pack *const fileTable = pckReadPackP(pack);
+
+        // Check the file table checksum
+        if (!bufEq(pckReadBinP(pack), cryptoHashOne(hashTypeSha1, pckToBuf(fileTable))))
+            THROW(ChecksumError, "invalid binary manifest file table checksum");
+
+        pckReadEndP(pack);
+        ioReadClose(read);
+
+        // Load everything except the file list from text
+        IoRead *const headerRead = ioBufferReadNew(BUFSTR(header));
+
+        MEM_CONTEXT_PRIOR_BEGIN()
+        {
+            this = manifestNewLoad(headerRead);
+        }
+        MEM_CONTEXT_PRIOR_END();
+
+        // Load the file list
+        PackRead *const fileRead = pckReadNew(fileTable);
+        String *const name = strNew();
+
+        MEM_CONTEXT_TEMP_RESET_BEGIN()
+        {
+            while (!pckReadNullP(fileRead))
+            {
+                pckReadObjBeginP(fileRead);
+
+                // Rebuild the name from the prefix shared with the prior name
+                strTruncIdx(name, (int)pckReadU32P(fileRead));
+                strCat(name, pckReadStrP(fileRead));
+
+                ManifestFile file = {.name = name};
+
+                file.size = pckReadU64P(fileRead);
+                file.sizeOriginal = pckReadU64P(fileRead, .defaultValue = file.size);
+                file.sizePrior = pckReadU64P(fileRead);
+                file.sizeRepo = pckReadU64P(fileRead, .defaultValue = file.size);
+                file.timestamp = pckReadTimeP(fileRead);
+                file.mode = pckReadModeP(fileRead);
+
+                const unsigned int userIdx = pckReadU32P(fileRead);
+                file.user = userIdx != 0 ? strLstGet(ownerList, userIdx - 1) : NULL;
+
+                const unsigned int groupIdx = pckReadU32P(fileRead);
+                file.group = groupIdx != 0 ? strLstGet(ownerList, groupIdx - 1) : NULL;
+
+                const Buffer *const checksumSha1 = pckReadBinP(fileRead);
+                file.checksumSha1 = checksumSha1 != NULL ? bufPtrConst(checksumSha1) : NULL;
+
+                const Buffer *const checksumRepoSha1 = pckReadBinP(fileRead);
+                file.checksumRepoSha1 = checksumRepoSha1 != NULL ? bufPtrConst(checksumRepoSha1) : NULL;
+
+                const Buffer *const checksumFast = pckReadBinP(fileRead);
+                file.checksumFast = checksumFast != NULL ? bufPtrConst(checksumFast) : NULL;
+
+                const Buffer *const checksumRepoFast = pckReadBinP(fileRead);
+                file.checksumRepoFast = checksumRepoFast != NULL ? bufPtrConst(checksumRepoFast) : NULL;
+
+                file.checksumPage = pckReadBoolP(fileRead);
+                file.checksumPageError = pckReadBoolP(fileRead);
+                file.checksumPageErrorList = pckReadStrP(fileRead);
+
+                const unsigned int referenceIdx = pckReadU32P(fileRead);
+                file.reference = referenceIdx != 0 ? strLstGet(this->pub.referenceList, referenceIdx - 1) : NULL;
+
+                file.bundleId = pckReadU64P(fileRead);
+                file.bundleOffset = pckReadU64P(fileRead);
+                file.blockIncrSize = (size_t)pckReadU64P(fileRead);
+                file.blockIncrChecksumSize = (size_t)pckReadU64P(fileRead);
+                file.blockIncrMapSize = pckReadU64P(fileRead);
+                file.copy = pckReadBoolP(fileRead);
+                file.delta = pckReadBoolP(fileRead);
+                file.resume = pckReadBoolP(fileRead);
+
+                pckReadObjEndP(fileRead);
+
+                manifestFileAdd(this, &file);
+
+                MEM_CONTEXT_TEMP_RESET(1000);
+            }
+        }
+        MEM_CONTEXT_TEMP_END();
+
+        pckReadEndP(fileRead);
+
+        // Sort the file list in case this system has a different collation than the system that saved the manifest
+        lstSort(this->pub.fileList, sortOrderAsc);
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_LOG_RETURN(MANIFEST, this);
+}
+
 /**********************************************************************************************************************************/
 FN_EXTERN void
 manifestValidate(Manifest *const this, const bool strict)
@@ -3383,25 +3833,60 @@ manifestLoadFileCallback(void *const data, const unsigned int try)
     ASSERT(data != NULL);
 
     ManifestLoadFileData *const loadData = data;
-    bool result = false;
+    volatile bool result = false;
 
     if (try < 2)
     {
         MEM_CONTEXT_TEMP_BEGIN()
         {
-            // Construct filename based on try
-            const String *const fileName = try == 0 ? loadData->fileName : strNewFmt("%s" INFO_COPY_EXT, strZ(loadData->fileName));
+            // Prefer the binary manifest on the first try since it can be loaded without parsing text. The binary manifest is
+            // optional so it is not an error when it is missing. If it cannot be loaded then fall back to the text manifest before
+            // trying the copy.
+            if (try == 0)
+            {
+                IoRead *const read = storageReadIo(
+                    storageNewReadP(
+                        loadData->storage, strNewFmt("%s" MANIFEST_BIN_EXT, strZ(loadData->fileName)), .ignoreMissing = true));
+                cipherBlockFilterGroupAdd(ioReadFilterGroup(read), loadData->cipherType, cipherModeDecrypt, loadData->cipherPass);
 
-            // Attempt to load the file
-            IoRead *const read = storageReadIo(storageNewReadP(loadData->storage, fileName));
-            cipherBlockFilterGroupAdd(ioReadFilterGroup(read), loadData->cipherType, cipherModeDecrypt, loadData->cipherPass);
+                if (ioReadOpen(read))
+                {
+                    TRY_BEGIN()
+                    {
+                        MEM_CONTEXT_BEGIN(loadData->memContext)
+                        {
+                            loadData->manifest = manifestNewLoadBin(read);
+                            result = true;
+                        }
+                        MEM_CONTEXT_END();
+                    }
+                    CATCH_ANY()
+                    {
+                        LOG_WARN_FMT(
+                            "unable to load '%s" MANIFEST_BIN_EXT "', loading text manifest instead: %s", strZ(loadData->fileName),
+                            errorMessage());
+                    }
+                    TRY_END();
+                }
+            }
 
-            MEM_CONTEXT_BEGIN(loadData->memContext)
+            // Else load the text manifest or the copy based on try
+            if (!result)
             {
-                loadData->manifest = manifestNewLoad(read);
-                result = true;
+                const String *const fileName =
+                    try == 0 ? loadData->fileName : strNewFmt("%s" INFO_COPY_EXT, strZ(loadData->fileName));
+
+                IoRead *const read = storageReadIo(storageNewReadP(loadData->storage, fileName));
+                cipherBlockFilterGroupAdd(ioReadFilterGroup(read), loadData->cipherType, cipherModeDecrypt, loadData->cipherPass);
+
+                // Attempt to load the file
+                MEM_CONTEXT_BEGIN(loadData->memContext)
+                {
+                    loadData->manifest = manifestNewLoad(read);
+                    result = true;
+                }
+                MEM_CONTEXT_END();
             }
-            MEM_CONTEXT_END();
         }
         MEM_CONTEXT_TEMP_END();
     }
@@ -3440,6 +3925,9 @@ manifestLoadFile(
         infoLoad(
             strNewFmt("unable to load backup manifest file '%s' or '%s" INFO_COPY_EXT "'", fileNamePath, fileNamePath),
             manifestLoadFileCallback, &data);
+
+        // Backup files are encrypted with the stored cipher type so the configured type must match it
+        infoCipherTypeCheck(data.manifest->pub.info, cipherType, storagePathP(storage, fileName));
     }
     MEM_CONTEXT_TEMP_END();
 
@@ -19,6 +19,9 @@ Constants
 #define BACKUP_MANIFEST_FILE                                        "backup" BACKUP_MANIFEST_EXT
 STRING_DECLARE(BACKUP_MANIFEST_FILE_STR);
 
+// Extension of the binary copy of the manifest
+#define MANIFEST_BIN_EXT                                            ".bin"
+
 #define MANIFEST_PATH_BUNDLE                                        "bundle"
 STRING_DECLARE(MANIFEST_PATH_BUNDLE_STR);
 
@@ -30,6 +33,9 @@ STRING_DECLARE(MANIFEST_TARGET_PGTBLSPC_STR);
 // Minimum size for the block incremental checksum
 #define BLOCK_INCR_CHECKSUM_SIZE_MIN                                6
 
+// Size of the fast (xxHash) checksum used for delta and resume
+#define MANIFEST_CHECKSUM_FAST_SIZE                                 XX_HASH_SIZE_MAX
+
 /***********************************************************************************************************************************
 Object type
 ***********************************************************************************************************************************/
@@ -39,6 +45,7 @@ typedef struct Manifest Manifest;
 #include "common/compress/helper.h"
 #include "common/crypto/common.h"
 #include "common/crypto/hash.h"
+#include "common/crypto/xxhash.h"
 #include "common/type/object.h"
 #include "common/type/variant.h"
 #include "info/info.h"
@@ -137,6 +144,14 @@ typedef struct ManifestDb
 /***********************************************************************************************************************************
 File type
 ***********************************************************************************************************************************/
+typedef enum
+{
+    manifestRelationForkMain,                                       // Main fork (no suffix)
+    manifestRelationForkFsm,                                        // Free space map fork (_fsm)
+    manifestRelationForkVm,                                         // Visibility map fork (_vm)
+    manifestRelationForkInit,                                       // Init fork of an unlogged relation (_init)
+} ManifestRelationFork;
+
 typedef struct ManifestFile
 {
     const String *name;                                             // File name (must be first member in struct)
@@ -148,6 +163,8 @@ typedef struct ManifestFile
     mode_t mode;                                                    // File mode
     const uint8_t *checksumSha1;                                    // SHA1 checksum
     const uint8_t *checksumRepoSha1;                                // SHA1 checksum as stored in repo (including compression, etc.)
+    const uint8_t *checksumFast;                                    // Fast checksum for delta/resume (NULL if not stored)
+    const uint8_t *checksumRepoFast;                                // Fast checksum as stored in repo (NULL if not stored)
     const String *checksumPageErrorList;                            // List of page checksum errors if there are any
     const String *user;                                             // User name
     const String *group;                                            // Group name
@@ -162,6 +179,13 @@ typedef struct ManifestFile
     uint64_t sizePrior;                                             // Prior size (valid if reference is set, backup only)
     uint64_t sizeRepo;                                              // Size in repo
     time_t timestamp;                                               // Original timestamp
+
+    // Relation identity derived from the file name when the file is packed so callers do not need to parse the name
+    unsigned int dbId;                                              // Database id (0 if not directly in a database path)
+    unsigned int tablespaceId;                                      // Tablespace id (0 if not in a database or global path)
+    unsigned int relFileNode;                                       // Relation file node (0 if not a relation)
+    unsigned int relSegNo;                                          // Relation segment number
+    ManifestRelationFork relFork;                                   // Relation fork
 } ManifestFile;
 
 /***********************************************************************************************************************************
@@ -217,6 +241,9 @@ FN_EXTERN Manifest *manifestNewBuild(
 // Load a manifest from IO
 FN_EXTERN Manifest *manifestNewLoad(IoRead *read);
 
+// Load a manifest from IO in binary format. The read must already be open.
+FN_EXTERN Manifest *manifestNewLoadBin(IoRead *read);
+
 /***********************************************************************************************************************************
 Getters/Setters
 ***********************************************************************************************************************************/
@@ -246,6 +273,19 @@ manifestCipherSubPassSet(Manifest *const this, const String *const cipherSubPass
     infoCipherPassSet(THIS_PUB(Manifest)->info, cipherSubPass);
 }
 
+// Get/set the cipher type used with the subpassphrase
+FN_INLINE_ALWAYS CipherType
+manifestCipherType(const Manifest *const this)
+{
+    return infoCipherType(THIS_PUB(Manifest)->info);
+}
+
+FN_INLINE_ALWAYS void
+manifestCipherTypeSet(Manifest *const this, const CipherType cipherType)
+{
+    infoCipherTypeSet(THIS_PUB(Manifest)->info, cipherType);
+}
+
 // Get manifest configuration and options
 FN_INLINE_ALWAYS const ManifestData *
 manifestData(const Manifest *const this)
@@ -295,6 +335,9 @@ manifestMove(Manifest *const this, MemContext *const parentNew)
 // Manifest save
 FN_EXTERN void manifestSave(Manifest *this, IoWrite *write);
 
+// Manifest save in binary format
+FN_EXTERN void manifestSaveBin(Manifest *this, IoWrite *write);
+
 // Validate a completed manifest. Use strict mode only when saving the manifest after a backup.
 FN_EXTERN void manifestValidate(Manifest *this, bool strict);
 
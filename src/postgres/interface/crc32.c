@@ -1,8 +1,24 @@
 /***********************************************************************************************************************************
 CRC-32 Calculation
+
+CRC-32C is calculated with hardware instructions when the CPU supports them (SSE4.2 on x86-64, ARMv8 CRC on aarch64), otherwise a
+portable slicing-by-8 implementation is used. The implementation is selected on first use.
 ***********************************************************************************************************************************/
 #include "build.auto.h"
 
+#include <pthread.h>
+#include <string.h>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define CRC32C_X86_64
+#include <nmmintrin.h>
+#include <wmmintrin.h>
+#elif defined(__aarch64__) && defined(__GNUC__) && defined(__linux__)
+#define CRC32C_AARCH64
+#include <arm_acle.h>
+#include <sys/auxv.h>
+#endif
+
 #include "postgres/interface/crc32.h"
 
 /**********************************************************************************************************************************/
@@ -90,15 +106,214 @@ static const uint32_t crc32c_lookup[256] =
     0x79B737BA, 0x8BDCB4B9, 0x988C474D, 0x6AE7C44E, 0xBE2DA0A5, 0x4C4623A6, 0x5F16D052, 0xAD7D5351,
 };
 
-FN_EXTERN uint32_t
-crc32cOne(const unsigned char *data, size_t size)
+/***********************************************************************************************************************************
+Load 8 bytes for the hardware implementations. memcpy() keeps the load valid under strict aliasing and for unaligned data, and is
+optimized to a single instruction.
+***********************************************************************************************************************************/
+#if defined(CRC32C_X86_64) || defined(CRC32C_AARCH64)
+
+static inline uint64_t
+crc32cLoad64(const unsigned char *const data)
 {
-    uint32_t result = 0xffffffff;
+    uint64_t result;
+    memcpy(&result, data, sizeof(result));
+
+    return result;
+}
+
+#endif
+
+/***********************************************************************************************************************************
+Slicing-by-8 tables. The first table is crc32c_lookup and the remaining tables are generated from it when the implementation is
+selected.
+***********************************************************************************************************************************/
+static uint32_t crc32cSliceLookup[7][256];
+
+static void
+crc32cSliceLookupInit(void)
+{
+    for (unsigned int idx = 0; idx < 256; idx++)
+    {
+        uint32_t crc = crc32c_lookup[idx];
+
+        for (unsigned int sliceIdx = 0; sliceIdx < 7; sliceIdx++)
+        {
+            crc = crc32c_lookup[crc & 0xFF] ^ (crc >> 8);
+            crc32cSliceLookup[sliceIdx][idx] = crc;
+        }
+    }
+}
+
+// Portable slicing-by-8 implementation
+static uint32_t
+crc32cCompSb8(uint32_t crc, const unsigned char *data, size_t size)
+{
+    // Process 8 bytes at a time. Bytes are assembled explicitly so the result does not depend on the platform byte order.
+    for (; size >= 8; size -= 8, data += 8)
+    {
+        const uint32_t low =
+            crc ^ ((uint32_t)data[0] | (uint32_t)data[1] << 8 | (uint32_t)data[2] << 16 | (uint32_t)data[3] << 24);
+
+        crc =
+            crc32cSliceLookup[6][low & 0xFF] ^ crc32cSliceLookup[5][(low >> 8) & 0xFF] ^
+            crc32cSliceLookup[4][(low >> 16) & 0xFF] ^ crc32cSliceLookup[3][low >> 24] ^ crc32cSliceLookup[2][data[4]] ^
+            crc32cSliceLookup[1][data[5]] ^ crc32cSliceLookup[0][data[6]] ^ crc32c_lookup[data[7]];
+    }
 
+    // Process remaining bytes
     while (size--)
-        result = crc32c_lookup[(result ^ *data++) & 0xFF] ^ (result >> 8);
+        crc = crc32c_lookup[(crc ^ *data++) & 0xFF] ^ (crc >> 8);
 
-    return result ^ 0xffffffff;
+    return crc;
+}
+
+/***********************************************************************************************************************************
+x86-64 implementation using the SSE4.2 crc32 instruction. When PCLMULQDQ is also available, larger buffers are split into three
+streams that are calculated in parallel (the crc32 instruction has a latency of three cycles but a throughput of one per cycle) and
+then combined by shifting the stream CRCs with carry-less multiplication.
+***********************************************************************************************************************************/
+#ifdef CRC32C_X86_64
+
+// Size of each stream processed in parallel
+#define CRC32C_STREAM_SIZE                                          256
+
+// Constants to shift a CRC over one and two streams, i.e. x^(8 * size - 33) mod P (bit-reflected). Generated on selection.
+static uint64_t crc32cShift1;
+static uint64_t crc32cShift2;
+
+// Calculate x^bits mod P (bit-reflected)
+static uint32_t
+crc32cPow(unsigned int bits)
+{
+    uint32_t result = 0x80000000;                                   // x^0
+
+    while (bits--)
+        result = (result >> 1) ^ (result & 1 ? 0x82F63B78 : 0);
+
+    return result;
+}
+
+__attribute__((target("sse4.2"))) static uint32_t
+crc32cCompSse42(uint32_t crc, const unsigned char *data, size_t size)
+{
+    // Process 8 bytes at a time
+    uint64_t crc64 = crc;
+
+    for (; size >= 8; size -= 8, data += 8)
+        crc64 = _mm_crc32_u64(crc64, crc32cLoad64(data));
+
+    crc = (uint32_t)crc64;
+
+    // Process remaining bytes
+    while (size--)
+        crc = _mm_crc32_u8(crc, *data++);
+
+    return crc;
+}
+
+// Shift a CRC by multiplying it with a constant generated by crc32cPow() and reducing the result
+__attribute__((target("sse4.2,pclmul"))) static inline uint32_t
+crc32cShift(const uint32_t crc, const uint64_t constant)
+{
+    const __m128i product = _mm_clmulepi64_si128(_mm_cvtsi32_si128((int)crc), _mm_cvtsi64_si128((long long)constant), 0);
+
+    return (uint32_t)_mm_crc32_u64(0, (uint64_t)_mm_cvtsi128_si64(product));
+}
+
+__attribute__((target("sse4.2,pclmul"))) static uint32_t
+crc32cCompSse42Clmul(uint32_t crc, const unsigned char *data, size_t size)
+{
+    // Process three streams in parallel
+    for (; size >= CRC32C_STREAM_SIZE * 3; size -= CRC32C_STREAM_SIZE * 3, data += CRC32C_STREAM_SIZE * 3)
+    {
+        uint64_t crc1 = crc;
+        uint64_t crc2 = 0;
+        uint64_t crc3 = 0;
+
+        for (size_t streamIdx = 0; streamIdx < CRC32C_STREAM_SIZE; streamIdx += 8)
+        {
+            crc1 = _mm_crc32_u64(crc1, crc32cLoad64(data + streamIdx));
+            crc2 = _mm_crc32_u64(crc2, crc32cLoad64(data + CRC32C_STREAM_SIZE + streamIdx));
+            crc3 = _mm_crc32_u64(crc3, crc32cLoad64(data + CRC32C_STREAM_SIZE * 2 + streamIdx));
+        }
+
+        crc = crc32cShift((uint32_t)crc1, crc32cShift2) ^ crc32cShift((uint32_t)crc2, crc32cShift1) ^ (uint32_t)crc3;
+    }
+
+    // Process the remainder as a single stream
+    return crc32cCompSse42(crc, data, size);
+}
+
+#endif // CRC32C_X86_64
+
+/***********************************************************************************************************************************
+aarch64 implementation using the ARMv8 CRC extension
+***********************************************************************************************************************************/
+#ifdef CRC32C_AARCH64
+
+#ifndef HWCAP_CRC32
+#define HWCAP_CRC32                                                 (1 << 7)
+#endif
+
+#ifdef __clang__
+__attribute__((target("crc")))
+#else
+__attribute__((target("+crc")))
+#endif
+static uint32_t
+crc32cCompArmv8(uint32_t crc, const unsigned char *data, size_t size)
+{
+    // Process 8 bytes at a time
+    for (; size >= 8; size -= 8, data += 8)
+        crc = __crc32cd(crc, crc32cLoad64(data));
+
+    // Process remaining bytes
+    while (size--)
+        crc = __crc32cb(crc, *data++);
+
+    return crc;
+}
+
+#endif // CRC32C_AARCH64
+
+/***********************************************************************************************************************************
+Select the implementation on first use. pthread_once() is used since the first call may come from more than one worker thread.
+***********************************************************************************************************************************/
+static pthread_once_t crc32cCompOnce = PTHREAD_ONCE_INIT;
+static uint32_t (*crc32cCompImpl)(uint32_t crc, const unsigned char *data, size_t size);
+
+static void
+crc32cCompChoose(void)
+{
+    // Slicing tables are always generated so the portable implementation is available for testing
+    crc32cSliceLookupInit();
+    crc32cCompImpl = crc32cCompSb8;
+
+#if defined(CRC32C_X86_64)
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("sse4.2"))                           // {uncovered_branch - all tested systems have SSE4.2}
+    {
+        crc32cCompImpl = crc32cCompSse42;
+
+        if (__builtin_cpu_supports("pclmul"))                       // {uncovered_branch - all tested systems have PCLMULQDQ}
+        {
+            crc32cShift1 = crc32cPow(CRC32C_STREAM_SIZE * 8 - 33);
+            crc32cShift2 = crc32cPow(CRC32C_STREAM_SIZE * 8 * 2 - 33);
+            crc32cCompImpl = crc32cCompSse42Clmul;
+        }
+    }
+#elif defined(CRC32C_AARCH64)
+    if (getauxval(AT_HWCAP) & HWCAP_CRC32)
+        crc32cCompImpl = crc32cCompArmv8;
+#endif
+}
+
+/**********************************************************************************************************************************/
+FN_EXTERN uint32_t
+crc32cOne(const unsigned char *data, size_t size)
+{
+    return crc32cFinish(crc32cComp(crc32cInit(), data, size));
 }
 
 // crc32c calculation in a few steps. this is needed to calculate the crc32c for XRecord.
@@ -111,9 +326,9 @@ crc32cInit(void)
 FN_EXTERN uint32_t
 crc32cComp(uint32_t crc, const unsigned char *data, size_t size)
 {
-    while (size--)
-        crc = crc32c_lookup[(crc ^ *data++) & 0xFF] ^ (crc >> 8);
-    return crc;
+    pthread_once(&crc32cCompOnce, crc32cCompChoose);
+
+    return crc32cCompImpl(crc, data, size);
 }
 
 FN_EXTERN uint32_t
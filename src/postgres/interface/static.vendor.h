@@ -249,6 +249,7 @@ Types from src/include/access/transam.h
 #define FirstNormalObjectId		16384
 
 #define DEFAULTTABLESPACE_OID	 1663
+#define GLOBALTABLESPACE_OID	 1664
 
 /***********************************************************************************************************************************
 Types from src/include/access/xlog_internal.h
@@ -3,7 +3,10 @@ Protocol Client
 ***********************************************************************************************************************************/
 #include "build.auto.h"
 
+#include <limits.h>
+
 #include "common/debug.h"
+#include "common/io/bufferWrite.h"
 #include "common/log.h"
 #include "common/time.h"
 #include "common/type/json.h"
@@ -33,6 +36,13 @@ typedef enum
     protocolClientStateDataGet = STRID5("data-get", 0xa14fb0d0240),
 } ProtocolClientState;
 
+/***********************************************************************************************************************************
+Max size of commands queued behind the current command. The server does not read queued commands until it is done putting results
+for the current command, and putting results may block until the client reads them. If the client blocked writing a queued command
+at the same time then neither side could make progress, so commands are only queued while they fit in the minimum pipe buffer.
+***********************************************************************************************************************************/
+#define PROTOCOL_CLIENT_QUEUE_SIZE_MAX                              PIPE_BUF
+
 /***********************************************************************************************************************************
 Object type
 ***********************************************************************************************************************************/
@@ -44,6 +54,9 @@ struct ProtocolClient
     const String *name;                                             // Name displayed in logging
     const String *errorPrefix;                                      // Prefix used when throwing error
     TimeMSec keepAliveTime;                                         // Last time data was put to the server
+    unsigned int commandQueueTotal;                                 // Commands queued behind the current command
+    List *commandQueueSizeList;                                     // Size of each queued command
+    size_t commandQueueSize;                                        // Total size of queued commands
 };
 
 /***********************************************************************************************************************************
@@ -210,6 +223,28 @@ protocolClientDataPut(ProtocolClient *const this, PackWrite *const data)
     FUNCTION_LOG_RETURN_VOID();
 }
 
+/**********************************************************************************************************************************/
+// Helper to end the current command. If commands are queued then the next command is already in progress and the client is still
+// getting data.
+static void
+protocolClientCommandEnd(ProtocolClient *const this)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(PROTOCOL_CLIENT, this);
+    FUNCTION_TEST_END();
+
+    if (this->commandQueueTotal > 0)
+    {
+        this->commandQueueTotal--;
+        this->commandQueueSize -= *(size_t *)lstGet(this->commandQueueSizeList, 0);
+        lstRemoveIdx(this->commandQueueSizeList, 0);
+    }
+    else
+        this->state = protocolClientStateIdle;
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
 /**********************************************************************************************************************************/
 // Helper to process errors
 static void
@@ -233,8 +268,8 @@ protocolClientError(ProtocolClient *const this, const ProtocolMessageType type,
             const String *const stack = pckReadStrP(error);
             pckReadEndP(error);
 
-            // Switch state to idle after error (server will do the same)
-            this->state = protocolClientStateIdle;
+            // Switch state to idle after error (server will do the same) unless there are queued commands
+            protocolClientCommandEnd(this);
 
             CHECK(FormatError, message != NULL && stack != NULL, "invalid error data");
 
@@ -312,8 +347,8 @@ protocolClientDataEndGet(ProtocolClient *const this)
 
         pckReadEndP(response);
 
-        // Switch state to idle after successful data end get
-        this->state = protocolClientStateIdle;
+        // Switch state to idle after successful data end get unless there are queued commands
+        protocolClientCommandEnd(this);
     }
     MEM_CONTEXT_TEMP_END();
 
@@ -351,6 +386,71 @@ protocolClientCommandPut(ProtocolClient *const this, ProtocolCommand *const comm
     FUNCTION_LOG_RETURN_VOID();
 }
 
+/**********************************************************************************************************************************/
+FN_EXTERN bool
+protocolClientCommandQueue(ProtocolClient *const this, ProtocolCommand *const command)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(PROTOCOL_CLIENT, this);
+        FUNCTION_LOG_PARAM(PROTOCOL_COMMAND, command);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+    ASSERT(command != NULL);
+
+    bool result = true;
+
+    // If no command is in progress then this is a regular command put
+    if (this->state == protocolClientStateIdle)
+    {
+        protocolClientCommandPut(this, command, false);
+    }
+    // Else queue the command behind the command(s) in progress if it fits
+    else
+    {
+        // Expect data-get state since data cannot be put for a queued command
+        protocolClientStateExpect(this, protocolClientStateDataGet);
+
+        MEM_CONTEXT_TEMP_BEGIN()
+        {
+            // Render the command to get the size
+            Buffer *const commandBuffer = bufNew(0);
+            protocolCommandPut(command, ioBufferWriteNewOpen(commandBuffer));
+
+            if (this->commandQueueSize + bufUsed(commandBuffer) <= PROTOCOL_CLIENT_QUEUE_SIZE_MAX)
+            {
+                // Put command
+                ioWrite(this->write, commandBuffer);
+                ioWriteFlush(this->write);
+
+                // Track the size until the command ends
+                if (this->commandQueueSizeList == NULL)
+                {
+                    MEM_CONTEXT_OBJ_BEGIN(this)
+                    {
+                        this->commandQueueSizeList = lstNewP(sizeof(size_t));
+                    }
+                    MEM_CONTEXT_OBJ_END();
+                }
+
+                const size_t commandSize = bufUsed(commandBuffer);
+
+                lstAdd(this->commandQueueSizeList, &commandSize);
+                this->commandQueueSize += commandSize;
+                this->commandQueueTotal++;
+
+                // Reset the keep alive time
+                this->keepAliveTime = timeMSec();
+            }
+            else
+                result = false;
+        }
+        MEM_CONTEXT_TEMP_END();
+    }
+
+    FUNCTION_LOG_RETURN(BOOL, result);
+}
+
 /**********************************************************************************************************************************/
 FN_EXTERN PackRead *
 protocolClientExecute(ProtocolClient *const this, ProtocolCommand *const command, const bool resultRequired)
@@ -76,6 +76,13 @@ protocolClientIoReadFd(ProtocolClient *const this)
     return ioReadFd(THIS_PUB(ProtocolClient)->read);
 }
 
+// Is data from the server buffered? If so then it can be read without waiting on the read file descriptor.
+FN_INLINE_ALWAYS bool
+protocolClientIoReadBuffered(ProtocolClient *const this)
+{
+    return ioReadBuffered(THIS_PUB(ProtocolClient)->read);
+}
+
 /***********************************************************************************************************************************
 Functions
 ***********************************************************************************************************************************/
@@ -106,6 +113,11 @@ FN_EXTERN void protocolClientDataEndGet(ProtocolClient *this);
 // Put command to the server
 FN_EXTERN void protocolClientCommandPut(ProtocolClient *this, ProtocolCommand *command, const bool dataPut);
 
+// Put command to the server even if prior commands have not ended. The server processes commands in order so results must be read
+// in the order the commands were put. Commands that put data cannot be queued. False is returned when the command is too large to
+// be queued without risking a deadlock, in which case it must be put again after prior commands have ended.
+FN_EXTERN bool protocolClientCommandQueue(ProtocolClient *this, ProtocolCommand *command);
+
 // Put data to the server
 FN_EXTERN void protocolClientDataPut(ProtocolClient *this, PackWrite *data);
 
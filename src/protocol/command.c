@@ -16,6 +16,7 @@ struct ProtocolCommand
 {
     StringId command;
     PackWrite *pack;
+    bool packEnd;
 };
 
 /**********************************************************************************************************************************/
@@ -61,7 +62,13 @@ protocolCommandPut(ProtocolCommand *const this, IoWrite *const write)
         // Write parameters
         if (this->pack != NULL)
         {
-            pckWriteEndP(this->pack);
+            // End the parameters only once since the command may be put more than once, e.g. when it is too large to be queued
+            if (!this->packEnd)
+            {
+                pckWriteEndP(this->pack);
+                this->packEnd = true;
+            }
+
             pckWritePackP(commandPack, pckWriteResult(this->pack));
         }
 
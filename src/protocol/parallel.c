@@ -4,9 +4,9 @@ Protocol Parallel Executor
 #include "build.auto.h"
 
 #include <string.h>
-#include <sys/select.h>
 
 #include "common/debug.h"
+#include "common/io/event.h"
 #include "common/log.h"
 #include "common/macro.h"
 #include "common/type/keyValue.h"
@@ -21,25 +21,31 @@ Object type
 struct ProtocolParallel
 {
     TimeMSec timeout;                                               // Max time to wait for jobs before returning
+    unsigned int jobMax;                                            // Max jobs in progress for each client
     ParallelJobCallback *callbackFunction;                          // Function to get new jobs
     void *callbackData;                                             // Data to pass to callback function
 
     List *clientList;                                               // List of clients to process jobs
     List *jobList;                                                  // List of jobs to be processed
 
-    ProtocolParallelJob **clientJobList;                            // Jobs being processing by each client
+    List **clientJobList;                                           // Jobs being processed by each client in the order sent
+    ProtocolParallelJob **clientJobHold;                            // Job held for each client until its command can be queued
+    IoEvent *event;                                                 // Wait for results from clients that are processing jobs
 
     ProtocolParallelJobState state;                                 // Overall state of job processing
 };
 
 /**********************************************************************************************************************************/
 FN_EXTERN ProtocolParallel *
-protocolParallelNew(TimeMSec timeout, ParallelJobCallback *callbackFunction, void *callbackData)
+protocolParallelNew(
+    const TimeMSec timeout, ParallelJobCallback *const callbackFunction, void *const callbackData,
+    const ProtocolParallelNewParam param)
 {
     FUNCTION_LOG_BEGIN(logLevelTrace);
         FUNCTION_LOG_PARAM(UINT64, timeout);
         FUNCTION_LOG_PARAM(FUNCTIONP, callbackFunction);
         FUNCTION_LOG_PARAM_P(VOID, callbackData);
+        FUNCTION_LOG_PARAM(UINT, param.jobMax);
     FUNCTION_LOG_END();
 
     ASSERT(callbackFunction != NULL);
@@ -50,6 +56,7 @@ protocolParallelNew(TimeMSec timeout, ParallelJobCallback *callbackFunction, voi
         *this = (ProtocolParallel)
         {
             .timeout = timeout,
+            .jobMax = param.jobMax == 0 ? 1 : param.jobMax,
             .callbackFunction = callbackFunction,
             .callbackData = callbackData,
             .clientList = lstNewP(sizeof(ProtocolClient *)),
@@ -104,117 +111,119 @@ protocolParallelProcess(ProtocolParallel *this)
             MEM_CONTEXT_OBJ_BEGIN(this)
             {
                 this->clientJobList = memNewPtrArray(lstSize(this->clientList));
+                this->clientJobHold = memNewPtrArray(lstSize(this->clientList));
+
+                for (unsigned int clientIdx = 0; clientIdx < lstSize(this->clientList); clientIdx++)
+                    this->clientJobList[clientIdx] = lstNewP(sizeof(ProtocolParallelJob *));
+
+                this->event = ioEventNew();
             }
             MEM_CONTEXT_OBJ_END();
 
             this->state = protocolParallelJobStateRunning;
         }
 
-        // Initialize the file descriptor set used for select
-        fd_set selectSet;
-        FD_ZERO(&selectSet);
-        int fdMax = -1;
-
-        // Find clients that are running jobs
-        unsigned int clientRunningTotal = 0;
-
-        for (unsigned int clientIdx = 0; clientIdx < lstSize(this->clientList); clientIdx++)
+        // If clients are running then wait for one to finish. Only clients with jobs in progress are watched. Results for queued
+        // jobs are never left in a client's read buffer (where the wait would not see them) since all buffered results are read
+        // below.
+        if (ioEventFdTotal(this->event) > 0)
         {
-            if (this->clientJobList[clientIdx] != NULL)
-            {
-                int fd = protocolClientIoReadFd(*(ProtocolClient **)lstGet(this->clientList, clientIdx));
-                FD_SET(fd, &selectSet);
+            const unsigned int readyTotal = ioEventWait(this->event, this->timeout);
 
-                // Find the max file descriptor needed for select()
-                MAX_ASSIGN(fdMax, fd);
-
-                clientRunningTotal++;
-            }
-        }
-
-        // If clients are running then wait for one to finish
-        if (clientRunningTotal > 0)
-        {
-            // Initialize timeout struct used for select. Recreate this structure each time since Linux (at least) will modify it.
-            struct timeval timeoutSelect;
-            timeoutSelect.tv_sec = (time_t)(this->timeout / MSEC_PER_SEC);
-            timeoutSelect.tv_usec = (suseconds_t)(this->timeout % MSEC_PER_SEC * 1000);
+            // Get the results from each client that is ready
+            for (unsigned int readyIdx = 0; readyIdx < readyTotal; readyIdx++)
+            {
+                const unsigned int clientIdx = ioEventReadyId(this->event, readyIdx);
+                ProtocolClient *const client = *(ProtocolClient **)lstGet(this->clientList, clientIdx);
+                List *const jobList = this->clientJobList[clientIdx];
 
-            // Determine if there is data to be read
-            int completed = select(fdMax + 1, &selectSet, NULL, NULL, &timeoutSelect);
-            THROW_ON_SYS_ERROR(completed == -1, AssertError, "unable to select from parallel client(s)");
+                ASSERT(!lstEmpty(jobList));
 
-            // If any jobs have completed then get the results
-            if (completed > 0)
-            {
-                for (unsigned int clientIdx = 0; clientIdx < lstSize(this->clientList); clientIdx++)
+                // Get results in the order the jobs were sent until there are no more buffered results
+                do
                 {
-                    ProtocolParallelJob *job = this->clientJobList[clientIdx];
+                    ProtocolParallelJob *const job = *(ProtocolParallelJob **)lstGet(jobList, 0);
 
-                    if (job != NULL &&
-                        FD_ISSET(
-                            protocolClientIoReadFd(*(ProtocolClient **)lstGet(this->clientList, clientIdx)),
-                            &selectSet))
+                    MEM_CONTEXT_TEMP_BEGIN()
                     {
-                        MEM_CONTEXT_TEMP_BEGIN()
+                        TRY_BEGIN()
+                        {
+                            protocolParallelJobResultSet(job, protocolClientDataGet(client));
+                            protocolClientDataEndGet(client);
+                        }
+                        CATCH_ANY()
                         {
-                            TRY_BEGIN()
-                            {
-                                ProtocolClient *const client = *(ProtocolClient **)lstGet(this->clientList, clientIdx);
-
-                                protocolParallelJobResultSet(job, protocolClientDataGet(client));
-                                protocolClientDataEndGet(client);
-                            }
-                            CATCH_ANY()
-                            {
-                                protocolParallelJobErrorSet(job, errorCode(), STR(errorMessage()));
-                            }
-                            TRY_END();
-
-                            protocolParallelJobStateSet(job, protocolParallelJobStateDone);
-                            this->clientJobList[clientIdx] = NULL;
+                            protocolParallelJobErrorSet(job, errorCode(), STR(errorMessage()));
                         }
-                        MEM_CONTEXT_TEMP_END();
+                        TRY_END();
+
+                        protocolParallelJobStateSet(job, protocolParallelJobStateDone);
+                        lstRemoveIdx(jobList, 0);
                     }
+                    MEM_CONTEXT_TEMP_END();
+
+                    result++;
                 }
+                while (!lstEmpty(jobList) && protocolClientIoReadBuffered(client));
 
-                result = (unsigned int)completed;
+                // Stop watching the client when it has no more jobs in progress
+                if (lstEmpty(jobList))
+                    ioEventRemove(this->event, protocolClientIoReadFd(client));
             }
         }
 
         // Find new jobs to be run
         for (unsigned int clientIdx = 0; clientIdx < lstSize(this->clientList); clientIdx++)
         {
-            // If nothing is running for this client
-            if (this->clientJobList[clientIdx] == NULL)
+            List *const jobList = this->clientJobList[clientIdx];
+
+            // While the client has room for more jobs
+            while (lstSize(jobList) < this->jobMax)
             {
-                // Get a new job
-                ProtocolParallelJob *job = NULL;
+                // Get the held job or a new job
+                ProtocolParallelJob *job = this->clientJobHold[clientIdx];
 
-                MEM_CONTEXT_BEGIN(lstMemContext(this->jobList))
+                if (job == NULL)
                 {
-                    job = this->callbackFunction(this->callbackData, clientIdx);
-                }
-                MEM_CONTEXT_END();
+                    MEM_CONTEXT_BEGIN(lstMemContext(this->jobList))
+                    {
+                        job = this->callbackFunction(this->callbackData, clientIdx);
+                    }
+                    MEM_CONTEXT_END();
+
+                    // If no more jobs for this client then free it once all jobs in progress are complete
+                    if (job == NULL)
+                    {
+                        if (lstEmpty(jobList))
+                            protocolLocalFree(clientIdx + 1);
+
+                        break;
+                    }
 
-                // If a new job was found
-                if (job != NULL)
-                {
                     // Add to the job list
                     lstAdd(this->jobList, &job);
+                }
 
-                    // Put command
-                    protocolClientCommandPut(
-                        *(ProtocolClient **)lstGet(this->clientList, clientIdx), protocolParallelJobCommand(job), false);
+                // Put command. If jobs are already in progress then the command is queued behind them, else start watching the
+                // client for results. If the command is too large to queue then hold the job until enough jobs in progress are
+                // done.
+                ProtocolClient *const client = *(ProtocolClient **)lstGet(this->clientList, clientIdx);
 
-                    // Set client id and running state
-                    protocolParallelJobProcessIdSet(job, clientIdx + 1);
-                    protocolParallelJobStateSet(job, protocolParallelJobStateRunning);
-                    this->clientJobList[clientIdx] = job;
+                if (!protocolClientCommandQueue(client, protocolParallelJobCommand(job)))
+                {
+                    this->clientJobHold[clientIdx] = job;
+                    break;
                 }
-                // Else no more jobs for this client so free it
-                else
-                    protocolLocalFree(clientIdx + 1);
+
+                this->clientJobHold[clientIdx] = NULL;
+
+                if (lstEmpty(jobList))
+                    ioEventAdd(this->event, protocolClientIoReadFd(client), clientIdx);
+
+                // Set client id and running state
+                protocolParallelJobProcessIdSet(job, clientIdx + 1);
+                protocolParallelJobStateSet(job, protocolParallelJobStateRunning);
+                lstAdd(jobList, &job);
             }
         }
     }
@@ -18,14 +18,25 @@ typedef struct ProtocolParallel ProtocolParallel;
 Job request callback
 
 Called whenever a new job is required for processing. If no more jobs are available then NULL is returned. Note that NULL must be
-returned to each clientIdx in case job distribution varies by clientIdx.
+returned to each clientIdx in case job distribution varies by clientIdx. When jobMax is greater than one the callback may be called
+several times in a row for the same clientIdx while the jobs already sent to the client are still in progress.
 ***********************************************************************************************************************************/
 typedef ProtocolParallelJob *ParallelJobCallback(void *data, unsigned int clientIdx);
 
 /***********************************************************************************************************************************
 Constructors
 ***********************************************************************************************************************************/
-FN_EXTERN ProtocolParallel *protocolParallelNew(TimeMSec timeout, ParallelJobCallback *callbackFunction, void *callbackData);
+typedef struct ProtocolParallelNewParam
+{
+    VAR_PARAM_HEADER;
+    unsigned int jobMax;                                            // Max jobs in progress for each client (defaults to 1)
+} ProtocolParallelNewParam;
+
+#define protocolParallelNewP(timeout, callbackFunction, callbackData, ...)                                                         \
+    protocolParallelNew(timeout, callbackFunction, callbackData, (ProtocolParallelNewParam){VAR_PARAM_INIT, __VA_ARGS__})
+
+FN_EXTERN ProtocolParallel *protocolParallelNew(
+    TimeMSec timeout, ParallelJobCallback *callbackFunction, void *callbackData, ProtocolParallelNewParam param);
 
 /***********************************************************************************************************************************
 Getters/Setters
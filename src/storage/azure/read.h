@@ -11,6 +11,7 @@ Azure Storage Read
 Constructors
 ***********************************************************************************************************************************/
 FN_EXTERN StorageRead *storageReadAzureNew(
-    StorageAzure *storage, const String *name, bool ignoreMissing, uint64_t offset, const Variant *limit);
+    StorageAzure *storage, const String *name, bool ignoreMissing, uint64_t offset, const Variant *limit, size_t chunkSize,
+    unsigned int requestMax);
 
 #endif
@@ -67,6 +67,8 @@ struct StorageAzure
     const HttpQuery *sasKey;                                        // SAS key
     const String *host;                                             // Host name
     size_t blockSize;                                               // Block size for multi-block upload
+    size_t downloadChunkSize;                                       // Chunk size for ranged reads
+    unsigned int downloadMax;                                       // Max ranged reads in progress for each file
     const String *tag;                                              // Tags to be applied to objects
     const String *pathPrefix;                                       // Account/container prefix
 
@@ -144,6 +146,7 @@ storageAzureAuth(
             // Generate string to sign
             const String *const contentLength = httpHeaderGet(httpHeader, HTTP_HEADER_CONTENT_LENGTH_STR);
             const String *const contentMd5 = httpHeaderGet(httpHeader, HTTP_HEADER_CONTENT_MD5_STR);
+            const String *const ifMatch = httpHeaderGet(httpHeader, HTTP_HEADER_IF_MATCH_STR);
             const String *const range = httpHeaderGet(httpHeader, HTTP_HEADER_RANGE_STR);
 
             const String *const stringToSign = strNewFmt(
@@ -155,7 +158,7 @@ storageAzureAuth(
                 "\n"                                                    // content-type
                 "%s\n"                                                  // date
                 "\n"                                                    // If-Modified-Since
-                "\n"                                                    // If-Match
+                "%s\n"                                                  // If-Match
                 "\n"                                                    // If-None-Match
                 "\n"                                                    // If-Unmodified-Since
                 "%s\n"                                                  // range
@@ -163,8 +166,8 @@ storageAzureAuth(
                 "/%s%s"                                                 // Canonicalized account/path
                 "%s",                                                   // Canonicalized query
                 strZ(verb), strEq(contentLength, ZERO_STR) ? "" : strZ(contentLength), contentMd5 == NULL ? "" : strZ(contentMd5),
-                strZ(dateTime), range == NULL ? "" : strZ(range), strZ(headerCanonical), strZ(this->account), strZ(path),
-                strZ(queryCanonical));
+                strZ(dateTime), ifMatch == NULL ? "" : strZ(ifMatch), range == NULL ? "" : strZ(range), strZ(headerCanonical),
+                strZ(this->account), strZ(path), strZ(queryCanonical));
 
             // Generate authorization header
             httpHeaderPut(
@@ -570,7 +573,9 @@ storageAzureNewRead(THIS_VOID, const String *const file, const bool ignoreMissin
     ASSERT(this != NULL);
     ASSERT(file != NULL);
 
-    FUNCTION_LOG_RETURN(STORAGE_READ, storageReadAzureNew(this, file, ignoreMissing, param.offset, param.limit));
+    FUNCTION_LOG_RETURN(
+        STORAGE_READ,
+        storageReadAzureNew(this, file, ignoreMissing, param.offset, param.limit, this->downloadChunkSize, this->downloadMax));
 }
 
 /**********************************************************************************************************************************/
@@ -711,8 +716,9 @@ FN_EXTERN Storage *
 storageAzureNew(
     const String *const path, const bool write, StoragePathExpressionCallback pathExpressionFunction, const String *const container,
     const String *const account, const StorageAzureKeyType keyType, const String *const key, const size_t blockSize,
-    const KeyValue *const tag, const String *const endpoint, const StorageAzureUriStyle uriStyle, const unsigned int port,
-    const TimeMSec timeout, const bool verifyPeer, const String *const caFile, const String *const caPath)
+    const size_t downloadChunkSize, const unsigned int downloadMax, const KeyValue *const tag, const String *const endpoint,
+    const StorageAzureUriStyle uriStyle, const unsigned int port, const TimeMSec timeout, const bool verifyPeer,
+    const String *const caFile, const String *const caPath)
 {
     FUNCTION_LOG_BEGIN(logLevelDebug);
         FUNCTION_LOG_PARAM(STRING, path);
@@ -723,6 +729,8 @@ storageAzureNew(
         FUNCTION_LOG_PARAM(STRING_ID, keyType);
         FUNCTION_TEST_PARAM(STRING, key);
         FUNCTION_LOG_PARAM(SIZE, blockSize);
+        FUNCTION_LOG_PARAM(SIZE, downloadChunkSize);
+        FUNCTION_LOG_PARAM(UINT, downloadMax);
         FUNCTION_LOG_PARAM(KEY_VALUE, tag);
         FUNCTION_LOG_PARAM(STRING, endpoint);
         FUNCTION_LOG_PARAM(ENUM, uriStyle);
@@ -739,6 +747,8 @@ storageAzureNew(
     ASSERT(endpoint != NULL);
     ASSERT(key != NULL);
     ASSERT(blockSize != 0);
+    ASSERT(downloadChunkSize != 0);
+    ASSERT(downloadMax != 0);
 
     OBJ_NEW_BEGIN(StorageAzure, .childQty = MEM_CONTEXT_QTY_MAX)
     {
@@ -748,6 +758,8 @@ storageAzureNew(
             .container = strDup(container),
             .account = strDup(account),
             .blockSize = blockSize,
+            .downloadChunkSize = downloadChunkSize,
+            .downloadMax = downloadMax,
             .host = uriStyle == storageAzureUriStyleHost ? strNewFmt("%s.%s", strZ(account), strZ(endpoint)) : strDup(endpoint),
             .pathPrefix =
                 uriStyle == storageAzureUriStyleHost ?
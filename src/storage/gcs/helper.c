@@ -24,7 +24,9 @@ storageGcsHelper(const unsigned int repoIdx, const bool write, StoragePathExpres
     Storage *const result = storageGcsNew(
         cfgOptionIdxStr(cfgOptRepoPath, repoIdx), write, pathExpressionCallback, cfgOptionIdxStr(cfgOptRepoGcsBucket, repoIdx),
         (StorageGcsKeyType)cfgOptionIdxStrId(cfgOptRepoGcsKeyType, repoIdx), cfgOptionIdxStrNull(cfgOptRepoGcsKey, repoIdx),
-        (size_t)cfgOptionIdxUInt64(cfgOptRepoStorageUploadChunkSize, repoIdx), cfgOptionIdxKvNull(cfgOptRepoStorageTag, repoIdx),
+        (size_t)cfgOptionIdxUInt64(cfgOptRepoStorageUploadChunkSize, repoIdx),
+        (size_t)cfgOptionIdxUInt64(cfgOptRepoStorageDownloadChunkSize, repoIdx),
+        cfgOptionIdxUInt(cfgOptRepoStorageDownloadMax, repoIdx), cfgOptionIdxKvNull(cfgOptRepoStorageTag, repoIdx),
         cfgOptionIdxStr(cfgOptRepoGcsEndpoint, repoIdx), ioTimeoutMs(), cfgOptionIdxBool(cfgOptRepoStorageVerifyTls, repoIdx),
         cfgOptionIdxStrNull(cfgOptRepoStorageCaFile, repoIdx), cfgOptionIdxStrNull(cfgOptRepoStorageCaPath, repoIdx));
 
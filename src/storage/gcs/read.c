@@ -5,6 +5,7 @@ GCS Storage Read
 
 #include "common/debug.h"
 #include "common/io/http/client.h"
+#include "common/io/http/rangeRead.h"
 #include "common/io/read.h"
 #include "common/log.h"
 #include "common/type/object.h"
@@ -12,9 +13,12 @@ GCS Storage Read
 #include "storage/read.intern.h"
 
 /***********************************************************************************************************************************
-GCS query tokens
+GCS header and query tokens
 ***********************************************************************************************************************************/
+STRING_STATIC(GCS_HEADER_GENERATION_STR,                            "x-goog-generation");
+
 STRING_STATIC(GCS_QUERY_ALT_STR,                                    "alt");
+STRING_STATIC(GCS_QUERY_IF_GENERATION_MATCH_STR,                    "ifGenerationMatch");
 
 /***********************************************************************************************************************************
 Object type
@@ -23,8 +27,11 @@ typedef struct StorageReadGcs
 {
     StorageReadInterface interface;                                 // Interface
     StorageGcs *storage;                                            // Storage that created this object
+    size_t chunkSize;                                               // Size of each ranged request
+    unsigned int requestMax;                                        // Max ranged requests in progress
+    const String *generation;                                       // Generation of the first response, required by ranged requests
 
-    HttpResponse *httpResponse;                                     // HTTP response
+    HttpRangeRead *rangeRead;                                       // Reads content of the HTTP response(s)
 } StorageReadGcs;
 
 /***********************************************************************************************************************************
@@ -35,6 +42,61 @@ Macros for function logging
 #define FUNCTION_LOG_STORAGE_READ_GCS_FORMAT(value, buffer, bufferSize)                                                            \
     objNameToLog(value, "StorageReadGcs", buffer, bufferSize)
 
+/***********************************************************************************************************************************
+Send a request for a range of the file
+***********************************************************************************************************************************/
+static HttpRequest *
+storageReadGcsRangeRequest(void *const data, const uint64_t offset, const uint64_t size)
+{
+    StorageReadGcs *const this = data;
+
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(STORAGE_READ_GCS, this);
+        FUNCTION_LOG_PARAM(UINT64, offset);
+        FUNCTION_LOG_PARAM(UINT64, size);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+
+    HttpRequest *result;
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        const HttpHeader *const header = httpHeaderPutRange(httpHeaderNew(NULL), this->interface.offset + offset, VARUINT64(size));
+        HttpQuery *const query = httpQueryAdd(httpQueryNewP(), GCS_QUERY_ALT_STR, GCS_QUERY_MEDIA_STR);
+
+        // Fail if the file has been replaced since the first request so the content is not stitched together from two versions
+        if (this->generation != NULL)
+            httpQueryAdd(query, GCS_QUERY_IF_GENERATION_MATCH_STR, this->generation);
+
+        MEM_CONTEXT_PRIOR_BEGIN()
+        {
+            result = storageGcsRequestAsyncP(
+                this->storage, HTTP_VERB_GET_STR, .object = this->interface.name, .header = header, .query = query);
+        }
+        MEM_CONTEXT_PRIOR_END();
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_LOG_RETURN(HTTP_REQUEST, result);
+}
+
+/***********************************************************************************************************************************
+Get the response for a range of the file
+***********************************************************************************************************************************/
+static HttpResponse *
+storageReadGcsRangeResponse(void *const data, HttpRequest *const request)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM_P(VOID, data);
+        FUNCTION_LOG_PARAM(HTTP_REQUEST, request);
+    FUNCTION_LOG_END();
+
+    (void)data;                                                     // No data is used
+
+    FUNCTION_LOG_RETURN(HTTP_RESPONSE, storageGcsResponseP(request, .contentIo = true));
+}
+
 /***********************************************************************************************************************************
 Open the file
 ***********************************************************************************************************************************/
@@ -48,22 +110,36 @@ storageReadGcsOpen(THIS_VOID)
     FUNCTION_LOG_END();
 
     ASSERT(this != NULL);
-    ASSERT(this->httpResponse == NULL);
+    ASSERT(this->rangeRead == NULL);
 
     bool result = false;
 
-    // Request the file
-    MEM_CONTEXT_OBJ_BEGIN(this)
+    MEM_CONTEXT_TEMP_BEGIN()
     {
-        this->httpResponse = storageGcsRequestP(
+        // Request the file
+        HttpResponse *const response = storageGcsRequestP(
             this->storage, HTTP_VERB_GET_STR, .object = this->interface.name,
             .header = httpHeaderPutRange(httpHeaderNew(NULL), this->interface.offset, this->interface.limit),
             .allowMissing = true, .contentIo = true,
             .query = httpQueryAdd(httpQueryNewP(), GCS_QUERY_ALT_STR, GCS_QUERY_MEDIA_STR));
+
+        // Read the response, splitting the rest of the file into ranged requests when it is large enough
+        if (httpResponseCodeOk(response))
+        {
+            MEM_CONTEXT_OBJ_BEGIN(this)
+            {
+                this->generation = strDup(httpHeaderGet(httpResponseHeader(response), GCS_HEADER_GENERATION_STR));
+                this->rangeRead = httpRangeReadNewP(
+                    response, .chunkSize = this->chunkSize, .requestMax = this->requestMax,
+                    .requestCallback = storageReadGcsRangeRequest, .responseCallback = storageReadGcsRangeResponse,
+                    .callbackData = this);
+            }
+            MEM_CONTEXT_OBJ_END();
+        }
     }
-    MEM_CONTEXT_OBJ_END();
+    MEM_CONTEXT_TEMP_END();
 
-    if (httpResponseCodeOk(this->httpResponse))
+    if (this->rangeRead != NULL)
     {
         result = true;
     }
@@ -88,11 +164,10 @@ storageReadGcs(THIS_VOID, Buffer *const buffer, const bool block)
         FUNCTION_LOG_PARAM(BOOL, block);
     FUNCTION_LOG_END();
 
-    ASSERT(this != NULL && this->httpResponse != NULL);
-    ASSERT(httpResponseIoRead(this->httpResponse) != NULL);
+    ASSERT(this != NULL && this->rangeRead != NULL);
     ASSERT(buffer != NULL && !bufFull(buffer));
 
-    FUNCTION_LOG_RETURN(SIZE, ioRead(httpResponseIoRead(this->httpResponse), buffer));
+    FUNCTION_LOG_RETURN(SIZE, httpRangeReadRead(this->rangeRead, buffer));
 }
 
 /***********************************************************************************************************************************
@@ -107,17 +182,17 @@ storageReadGcsEof(THIS_VOID)
         FUNCTION_TEST_PARAM(STORAGE_READ_GCS, this);
     FUNCTION_TEST_END();
 
-    ASSERT(this != NULL && this->httpResponse != NULL);
-    ASSERT(httpResponseIoRead(this->httpResponse) != NULL);
+    ASSERT(this != NULL && this->rangeRead != NULL);
 
-    FUNCTION_TEST_RETURN(BOOL, ioReadEof(httpResponseIoRead(this->httpResponse)));
+    FUNCTION_TEST_RETURN(BOOL, httpRangeReadEof(this->rangeRead));
 }
 
 /**********************************************************************************************************************************/
 FN_EXTERN StorageRead *
 storageReadGcsNew(
     StorageGcs *const storage, const String *const name, const bool ignoreMissing, const uint64_t offset,
-    const Variant *const limit)
+    const Variant *const limit, const size_t chunkSize,
+    const unsigned int requestMax)
 {
     FUNCTION_LOG_BEGIN(logLevelTrace);
         FUNCTION_LOG_PARAM(STORAGE_GCS, storage);
@@ -125,6 +200,8 @@ storageReadGcsNew(
         FUNCTION_LOG_PARAM(BOOL, ignoreMissing);
         FUNCTION_LOG_PARAM(UINT64, offset);
         FUNCTION_LOG_PARAM(VARIANT, limit);
+        FUNCTION_LOG_PARAM(SIZE, chunkSize);
+        FUNCTION_LOG_PARAM(UINT, requestMax);
     FUNCTION_LOG_END();
 
     ASSERT(storage != NULL);
@@ -135,6 +212,8 @@ storageReadGcsNew(
         *this = (StorageReadGcs)
         {
             .storage = storage,
+            .chunkSize = chunkSize,
+            .requestMax = requestMax,
 
             .interface = (StorageReadInterface)
             {
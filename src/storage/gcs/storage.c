@@ -101,6 +101,8 @@ struct StorageGcs
     const String *bucket;                                           // Bucket to store data in
     const String *endpoint;                                         // Endpoint
     size_t chunkSize;                                               // Block size for resumable upload
+    size_t downloadChunkSize;                                       // Chunk size for ranged reads
+    unsigned int downloadMax;                                       // Max ranged reads in progress for each file
     unsigned int deleteMax;                                         // Maximum objects that can be deleted in one request
     const Buffer *tag;                                              // Tags to be applied to objects
 
@@ -890,7 +892,9 @@ storageGcsNewRead(THIS_VOID, const String *const file, const bool ignoreMissing,
     ASSERT(this != NULL);
     ASSERT(file != NULL);
 
-    FUNCTION_LOG_RETURN(STORAGE_READ, storageReadGcsNew(this, file, ignoreMissing, param.offset, param.limit));
+    FUNCTION_LOG_RETURN(
+        STORAGE_READ,
+        storageReadGcsNew(this, file, ignoreMissing, param.offset, param.limit, this->downloadChunkSize, this->downloadMax));
 }
 
 /**********************************************************************************************************************************/
@@ -1133,9 +1137,9 @@ static const StorageInterface storageInterfaceGcs =
 FN_EXTERN Storage *
 storageGcsNew(
     const String *const path, const bool write, StoragePathExpressionCallback pathExpressionFunction, const String *const bucket,
-    const StorageGcsKeyType keyType, const String *const key, const size_t chunkSize, const KeyValue *const tag,
-    const String *const endpoint, const TimeMSec timeout, const bool verifyPeer, const String *const caFile,
-    const String *const caPath)
+    const StorageGcsKeyType keyType, const String *const key, const size_t chunkSize, const size_t downloadChunkSize,
+    const unsigned int downloadMax, const KeyValue *const tag, const String *const endpoint, const TimeMSec timeout,
+    const bool verifyPeer, const String *const caFile, const String *const caPath)
 {
     FUNCTION_LOG_BEGIN(logLevelDebug);
         FUNCTION_LOG_PARAM(STRING, path);
@@ -1145,6 +1149,8 @@ storageGcsNew(
         FUNCTION_LOG_PARAM(STRING_ID, keyType);
         FUNCTION_TEST_PARAM(STRING, key);
         FUNCTION_LOG_PARAM(SIZE, chunkSize);
+        FUNCTION_LOG_PARAM(SIZE, downloadChunkSize);
+        FUNCTION_LOG_PARAM(UINT, downloadMax);
         FUNCTION_LOG_PARAM(KEY_VALUE, tag);
         FUNCTION_LOG_PARAM(STRING, endpoint);
         FUNCTION_LOG_PARAM(TIME_MSEC, timeout);
@@ -1157,6 +1163,8 @@ storageGcsNew(
     ASSERT(bucket != NULL);
     ASSERT(keyType == storageGcsKeyTypeAuto || key != NULL);
     ASSERT(chunkSize != 0);
+    ASSERT(downloadChunkSize != 0);
+    ASSERT(downloadMax != 0);
 
     OBJ_NEW_BEGIN(StorageGcs, .childQty = MEM_CONTEXT_QTY_MAX)
     {
@@ -1167,6 +1175,8 @@ storageGcsNew(
             .bucket = strDup(bucket),
             .keyType = keyType,
             .chunkSize = chunkSize,
+            .downloadChunkSize = downloadChunkSize,
+            .downloadMax = downloadMax,
             .deleteMax = STORAGE_GCS_DELETE_MAX,
         };
 
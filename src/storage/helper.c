@@ -192,9 +192,14 @@ storagePgGet(const unsigned int pgIdx, const bool write)
             STORAGE_MODE_FILE_DEFAULT, STORAGE_MODE_PATH_DEFAULT, write, NULL,
             protocolRemoteGet(protocolStorageTypePg, pgIdx), cfgOptionUInt(cfgOptCompressLevelNetwork));
     }
-    // Use Posix storage
+    // Use Posix storage. Listing PGDATA happens before local processes are started so the threads allowed for listing are limited
+    // by process-max.
     else
-        result = storagePosixNewP(cfgOptionIdxStr(cfgOptPgPath, pgIdx), .write = write);
+    {
+        result = storagePosixNewP(
+            cfgOptionIdxStr(cfgOptPgPath, pgIdx), .write = write,
+            .listThreadMax = cfgOptionValid(cfgOptProcessMax) ? cfgOptionUInt(cfgOptProcessMax) : 1);
+    }
 
     FUNCTION_TEST_RETURN(STORAGE, result);
 }
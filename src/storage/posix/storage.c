@@ -15,6 +15,7 @@ Posix Storage
 #include "common/debug.h"
 #include "common/log.h"
 #include "common/regExp.h"
+#include "common/thread.h"
 #include "common/user.h"
 #include "storage/posix/read.h"
 #include "storage/posix/storage.intern.h"
@@ -33,8 +34,58 @@ Object type
 struct StoragePosix
 {
     STORAGE_COMMON_MEMBER;
+    unsigned int listThreadMax;                                     // Max threads used to stat path entries
 };
 
+/***********************************************************************************************************************************
+Set info from stat except for the link destination, which is handled by the caller since it requires the file name
+***********************************************************************************************************************************/
+static void
+storagePosixInfoStat(StorageInfo *const info, const struct stat *const statFile)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM_P(VOID, info);
+        FUNCTION_TEST_PARAM_P(VOID, statFile);
+    FUNCTION_TEST_END();
+
+    FUNCTION_AUDIT_HELPER();
+
+    ASSERT(info != NULL);
+    ASSERT(statFile != NULL);
+
+    // Add type info (no need set file type since it is the default)
+    if (info->level >= storageInfoLevelType && !S_ISREG(statFile->st_mode))
+    {
+        if (S_ISDIR(statFile->st_mode))
+            info->type = storageTypePath;
+        else if (S_ISLNK(statFile->st_mode))
+            info->type = storageTypeLink;
+        else
+            info->type = storageTypeSpecial;
+    }
+
+    // Add basic level info
+    if (info->level >= storageInfoLevelBasic)
+    {
+        info->timeModified = statFile->st_mtime;
+
+        if (info->type == storageTypeFile)
+            info->size = (uint64_t)statFile->st_size;
+    }
+
+    // Add detail level info
+    if (info->level >= storageInfoLevelDetail)
+    {
+        info->groupId = statFile->st_gid;
+        info->group = groupNameFromId(info->groupId);
+        info->userId = statFile->st_uid;
+        info->user = userNameFromId(info->userId);
+        info->mode = statFile->st_mode & (S_IRWXU | S_IRWXG | S_IRWXO);
+    }
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
 /**********************************************************************************************************************************/
 static StorageInfo
 storagePosixInfo(THIS_VOID, const String *const file, const StorageInfoLevel level, const StorageInterfaceInfoParam param)
@@ -67,47 +118,19 @@ storagePosixInfo(THIS_VOID, const String *const file, const StorageInfoLevel lev
     else
     {
         result.exists = true;
+        storagePosixInfoStat(&result, &statFile);
 
-        // Add type info (no need set file type since it is the default)
-        if (result.level >= storageInfoLevelType && !S_ISREG(statFile.st_mode))
-        {
-            if (S_ISDIR(statFile.st_mode))
-                result.type = storageTypePath;
-            else if (S_ISLNK(statFile.st_mode))
-                result.type = storageTypeLink;
-            else
-                result.type = storageTypeSpecial;
-        }
-
-        // Add basic level info
-        if (result.level >= storageInfoLevelBasic)
-        {
-            result.timeModified = statFile.st_mtime;
-
-            if (result.type == storageTypeFile)
-                result.size = (uint64_t)statFile.st_size;
-        }
-
-        // Add detail level info
-        if (result.level >= storageInfoLevelDetail)
+        // Add link destination
+        if (result.level >= storageInfoLevelDetail && result.type == storageTypeLink)
         {
-            result.groupId = statFile.st_gid;
-            result.group = groupNameFromId(result.groupId);
-            result.userId = statFile.st_uid;
-            result.user = userNameFromId(result.userId);
-            result.mode = statFile.st_mode & (S_IRWXU | S_IRWXG | S_IRWXO);
-
-            if (result.type == storageTypeLink)
-            {
-                char linkDestination[PATH_MAX];
-                ssize_t linkDestinationSize = 0;
+            char linkDestination[PATH_MAX];
+            ssize_t linkDestinationSize = 0;
 
-                THROW_ON_SYS_ERROR_FMT(
-                    (linkDestinationSize = readlink(strZ(file), linkDestination, sizeof(linkDestination) - 1)) == -1,
-                    FileReadError, "unable to get destination for link '%s'", strZ(file));
+            THROW_ON_SYS_ERROR_FMT(
+                (linkDestinationSize = readlink(strZ(file), linkDestination, sizeof(linkDestination) - 1)) == -1,
+                FileReadError, "unable to get destination for link '%s'", strZ(file));
 
-                result.linkDestination = strNewZN(linkDestination, (size_t)linkDestinationSize);
-            }
+            result.linkDestination = strNewZN(linkDestination, (size_t)linkDestinationSize);
         }
     }
 
@@ -152,35 +175,151 @@ storagePosixLinkCreate(
     FUNCTION_LOG_RETURN_VOID();
 }
 
-/**********************************************************************************************************************************/
-// Helper function to get info for a file if it exists. This logic can't live directly in storagePosixList() because there is a race
-// condition where a file might exist while listing the directory but it is gone before stat() can be called. In order to get
-// complete test coverage this function must be split out.
+/***********************************************************************************************************************************
+Path entries are read and stat'd in batches to limit memory usage for paths with a very large number of entries. Each thread stats
+at least STORAGE_POSIX_LIST_THREAD_ENTRY_MIN entries since smaller paths are not worth the cost of creating a thread.
+***********************************************************************************************************************************/
+#define STORAGE_POSIX_LIST_BATCH_MAX                                16384
+#define STORAGE_POSIX_LIST_THREAD_ENTRY_MIN                         1024
+
+typedef struct StoragePosixListStat
+{
+    const char *name;                                               // Entry name
+    int errNo;                                                      // Error from fstatat() or 0 on success
+    struct stat statFile;                                           // Entry stat when there was no error
+} StoragePosixListStat;
+
+typedef struct StoragePosixListStatJob
+{
+    int pathFd;                                                     // Path fd that entry names are relative to
+    StoragePosixListStat *statList;                                 // Entries to stat
+    unsigned int statTotal;                                         // Total entries to stat
+} StoragePosixListStatJob;
+
+/***********************************************************************************************************************************
+Stat entries relative to the path fd so the path does not need to be resolved for each entry. This may run on a worker thread so
+nothing called here may use mem contexts, logging, or error handling, which is why the debug macros are not used.
+***********************************************************************************************************************************/
+static void *
+storagePosixListStatJob(void *const param)
+{
+    StoragePosixListStatJob *const job = param;
+
+    for (unsigned int statIdx = 0; statIdx < job->statTotal; statIdx++)
+    {
+        StoragePosixListStat *const entry = &job->statList[statIdx];
+
+        entry->errNo = fstatat(job->pathFd, entry->name, &entry->statFile, AT_SYMLINK_NOFOLLOW) == -1 ? errno : 0;
+    }
+
+    return NULL;
+}
+
+/***********************************************************************************************************************************
+Stat entries, splitting them between threads when there are enough entries and more than one thread is allowed
+***********************************************************************************************************************************/
+static void
+storagePosixListStat(
+    const StoragePosix *const this, const int pathFd, StoragePosixListStat *const statList, const unsigned int statTotal)
+{
+    FUNCTION_TEST_BEGIN();
+        FUNCTION_TEST_PARAM(STORAGE_POSIX, this);
+        FUNCTION_TEST_PARAM(INT, pathFd);
+        FUNCTION_TEST_PARAM_P(VOID, statList);
+        FUNCTION_TEST_PARAM(UINT, statTotal);
+    FUNCTION_TEST_END();
+
+    ASSERT(this != NULL);
+    ASSERT(pathFd >= 0);
+    ASSERT(statList != NULL);
+
+    unsigned int jobTotal = statTotal / STORAGE_POSIX_LIST_THREAD_ENTRY_MIN;
+
+    if (jobTotal > this->listThreadMax)
+        jobTotal = this->listThreadMax;
+
+    // Stat on this thread when there are not enough entries for more than one job
+    if (jobTotal <= 1)
+    {
+        storagePosixListStatJob(&(StoragePosixListStatJob){.pathFd = pathFd, .statList = statList, .statTotal = statTotal});
+    }
+    // Else run the first job on this thread and the rest on worker threads
+    else
+    {
+        MEM_CONTEXT_TEMP_BEGIN()
+        {
+            StoragePosixListStatJob *const jobList = memNew(sizeof(StoragePosixListStatJob) * jobTotal);
+            const unsigned int jobSize = statTotal / jobTotal;
+
+            for (unsigned int jobIdx = 0; jobIdx < jobTotal; jobIdx++)
+            {
+                jobList[jobIdx] = (StoragePosixListStatJob)
+                {
+                    .pathFd = pathFd,
+                    .statList = statList + jobIdx * jobSize,
+                    .statTotal = jobIdx == jobTotal - 1 ? statTotal - jobIdx * jobSize : jobSize,
+                };
+            }
+
+            threadJobRun(storagePosixListStatJob, jobList, sizeof(StoragePosixListStatJob), jobTotal);
+        }
+        MEM_CONTEXT_TEMP_END();
+    }
+
+    FUNCTION_TEST_RETURN_VOID();
+}
+
+/***********************************************************************************************************************************
+Add a stat'd entry to the list if it exists. This logic can't live directly in storagePosixList() because there is a race condition
+where a file might exist while listing the path but it is gone before stat() can be called. In order to get complete test coverage
+this function must be split out.
+***********************************************************************************************************************************/
 static void
 storagePosixListEntry(
-    StoragePosix *const this, StorageList *const list, const String *const path, const char *const name,
+    StorageList *const list, const String *const path, const int pathFd, const StoragePosixListStat *const entry,
     const StorageInfoLevel level)
 {
     FUNCTION_TEST_BEGIN();
-        FUNCTION_TEST_PARAM(STORAGE_POSIX, this);
         FUNCTION_TEST_PARAM(STORAGE_LIST, list);
         FUNCTION_TEST_PARAM(STRING, path);
-        FUNCTION_TEST_PARAM(STRINGZ, name);
+        FUNCTION_TEST_PARAM(INT, pathFd);
+        FUNCTION_TEST_PARAM_P(VOID, entry);
         FUNCTION_TEST_PARAM(ENUM, level);
     FUNCTION_TEST_END();
 
     FUNCTION_AUDIT_HELPER();
 
-    ASSERT(this != NULL);
     ASSERT(list != NULL);
     ASSERT(path != NULL);
-    ASSERT(name != NULL);
+    ASSERT(entry != NULL);
 
-    StorageInfo info = storageInterfaceInfoP(this, strNewFmt("%s/%s", strZ(path), name), level);
-
-    if (info.exists)
+    if (entry->errNo != 0)
     {
-        info.name = STR(name);
+        if (entry->errNo != ENOENT)                                                                                 // {vm_covered}
+        {
+            THROW_SYS_ERROR_CODE_FMT(                                                                               // {vm_covered}
+                entry->errNo, FileOpenError, STORAGE_ERROR_INFO, strZ(strNewFmt("%s/%s", strZ(path), entry->name)));
+        }
+    }
+    // On success the entry exists
+    else
+    {
+        StorageInfo info = {.name = STR(entry->name), .level = level, .exists = true};
+        storagePosixInfoStat(&info, &entry->statFile);
+
+        // Add link destination
+        if (info.level >= storageInfoLevelDetail && info.type == storageTypeLink)
+        {
+            char linkDestination[PATH_MAX];
+            ssize_t linkDestinationSize = 0;
+
+            THROW_ON_SYS_ERROR_FMT(
+                (linkDestinationSize = readlinkat(pathFd, entry->name, linkDestination, sizeof(linkDestination) - 1)) == -1,
+                FileReadError, "unable to get destination for link '%s/%s'", strZ(path), entry->name);
+
+            info.linkDestination = strNewZN(linkDestination, (size_t)linkDestinationSize);
+        }
+
         storageLstAdd(list, &info);
     }
 
@@ -220,19 +359,19 @@ storagePosixList(THIS_VOID, const String *const path, const StorageInfoLevel lev
 
         TRY_BEGIN()
         {
-            MEM_CONTEXT_TEMP_RESET_BEGIN()
+            // If only making a list of files that exist then no need to go get detailed info which requires calling stat() and is
+            // therefore relatively slow
+            if (level == storageInfoLevelExists)
             {
-                // Read the directory entries
-                const struct dirent *dirEntry = readdir(dir);
-
-                while (dirEntry != NULL)
+                MEM_CONTEXT_TEMP_RESET_BEGIN()
                 {
-                    // Always skip . and ..
-                    if (!strEqZ(DOT_STR, dirEntry->d_name) && !strEqZ(DOTDOT_STR, dirEntry->d_name))
+                    // Read the directory entries
+                    const struct dirent *dirEntry = readdir(dir);
+
+                    while (dirEntry != NULL)
                     {
-                        // If only making a list of files that exist then no need to go get detailed info which requires calling
-                        // stat() and is therefore relatively slow
-                        if (level == storageInfoLevelExists)
+                        // Always skip . and ..
+                        if (!strEqZ(DOT_STR, dirEntry->d_name) && !strEqZ(DOTDOT_STR, dirEntry->d_name))
                         {
                             const StorageInfo storageInfo =
                             {
@@ -243,19 +382,51 @@ storagePosixList(THIS_VOID, const String *const path, const StorageInfoLevel lev
 
                             storageLstAdd(result, &storageInfo);
                         }
-                        // Else more info is required which requires a call to stat()
-                        else
-                            storagePosixListEntry(this, result, path, dirEntry->d_name, level);
+
+                        // Get next entry
+                        dirEntry = readdir(dir);
+
+                        // Reset the memory context occasionally so we don't use too much memory or slow down processing
+                        MEM_CONTEXT_TEMP_RESET(1000);
                     }
+                }
+                MEM_CONTEXT_TEMP_END();
+            }
+            // Else stat entries in batches relative to the path fd
+            else
+            {
+                MEM_CONTEXT_TEMP_BEGIN()
+                {
+                    const int pathFd = dirfd(dir);
+                    StoragePosixListStat *const statList = memNew(sizeof(StoragePosixListStat) * STORAGE_POSIX_LIST_BATCH_MAX);
+                    const struct dirent *dirEntry = NULL;
+
+                    do
+                    {
+                        MEM_CONTEXT_TEMP_BEGIN()
+                        {
+                            // Read a batch of directory entries
+                            unsigned int statTotal = 0;
+
+                            while (statTotal < STORAGE_POSIX_LIST_BATCH_MAX && (dirEntry = readdir(dir)) != NULL)
+                            {
+                                // Always skip . and ..
+                                if (!strEqZ(DOT_STR, dirEntry->d_name) && !strEqZ(DOTDOT_STR, dirEntry->d_name))
+                                    statList[statTotal++] = (StoragePosixListStat){.name = strZ(strNewZ(dirEntry->d_name))};
+                            }
 
-                    // Get next entry
-                    dirEntry = readdir(dir);
+                            // Stat the batch and add entries to the list
+                            storagePosixListStat(this, pathFd, statList, statTotal);
 
-                    // Reset the memory context occasionally so we don't use too much memory or slow down processing
-                    MEM_CONTEXT_TEMP_RESET(1000);
+                            for (unsigned int statIdx = 0; statIdx < statTotal; statIdx++)
+                                storagePosixListEntry(result, path, pathFd, &statList[statIdx], level);
+                        }
+                        MEM_CONTEXT_TEMP_END();
+                    }
+                    while (dirEntry != NULL);
                 }
+                MEM_CONTEXT_TEMP_END();
             }
-            MEM_CONTEXT_TEMP_END();
         }
         FINALLY()
         {
@@ -591,7 +762,7 @@ static const StorageInterface storageInterfacePosix =
 FN_EXTERN Storage *
 storagePosixNewInternal(
     const StringId type, const String *const path, const mode_t modeFile, const mode_t modePath, const bool write,
-    StoragePathExpressionCallback pathExpressionFunction, const bool pathSync)
+    StoragePathExpressionCallback pathExpressionFunction, const bool pathSync, const unsigned int listThreadMax)
 {
     FUNCTION_LOG_BEGIN(logLevelDebug);
         FUNCTION_LOG_PARAM(STRING_ID, type);
@@ -601,12 +772,14 @@ storagePosixNewInternal(
         FUNCTION_LOG_PARAM(BOOL, write);
         FUNCTION_LOG_PARAM(FUNCTIONP, pathExpressionFunction);
         FUNCTION_LOG_PARAM(BOOL, pathSync);
+        FUNCTION_LOG_PARAM(UINT, listThreadMax);
     FUNCTION_LOG_END();
 
     ASSERT(type != 0);
     ASSERT(path != NULL);
     ASSERT(modeFile != 0);
     ASSERT(modePath != 0);
+    ASSERT(listThreadMax > 0);
 
     // Initialize user module
     userInit();
@@ -617,6 +790,7 @@ storagePosixNewInternal(
         *this = (StoragePosix)
         {
             .interface = storageInterfacePosix,
+            .listThreadMax = listThreadMax,
         };
 
         // Disable path sync when not supported
@@ -643,11 +817,13 @@ storagePosixNew(const String *const path, const StoragePosixNewParam param)
         FUNCTION_LOG_PARAM(MODE, param.modePath);
         FUNCTION_LOG_PARAM(BOOL, param.write);
         FUNCTION_LOG_PARAM(FUNCTIONP, param.pathExpressionFunction);
+        FUNCTION_LOG_PARAM(UINT, param.listThreadMax);
     FUNCTION_LOG_END();
 
     FUNCTION_LOG_RETURN(
         STORAGE,
         storagePosixNewInternal(
             STORAGE_POSIX_TYPE, path, param.modeFile == 0 ? STORAGE_MODE_FILE_DEFAULT : param.modeFile,
-            param.modePath == 0 ? STORAGE_MODE_PATH_DEFAULT : param.modePath, param.write, param.pathExpressionFunction, true));
+            param.modePath == 0 ? STORAGE_MODE_PATH_DEFAULT : param.modePath, param.write, param.pathExpressionFunction, true,
+            param.listThreadMax == 0 ? 1 : param.listThreadMax));
 }
@@ -21,6 +21,7 @@ typedef struct StoragePosixNewParam
     mode_t modeFile;
     mode_t modePath;
     StoragePathExpressionCallback *pathExpressionFunction;
+    unsigned int listThreadMax;
 } StoragePosixNewParam;
 
 #define storagePosixNewP(path, ...)                                                                                                \
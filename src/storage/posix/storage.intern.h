@@ -16,7 +16,7 @@ Constructors
 ***********************************************************************************************************************************/
 FN_EXTERN Storage *storagePosixNewInternal(
     StringId type, const String *path, mode_t modeFile, mode_t modePath, bool write,
-    StoragePathExpressionCallback pathExpressionFunction, bool pathSync);
+    StoragePathExpressionCallback pathExpressionFunction, bool pathSync, unsigned int listThreadMax);
 
 /***********************************************************************************************************************************
 Macros for function logging
@@ -5,6 +5,7 @@ S3 Storage Read
 
 #include "common/debug.h"
 #include "common/io/http/client.h"
+#include "common/io/http/rangeRead.h"
 #include "common/log.h"
 #include "common/type/object.h"
 #include "storage/read.intern.h"
@@ -20,8 +21,11 @@ typedef struct StorageReadS3
 {
     StorageReadInterface interface;                                 // Interface
     StorageS3 *storage;                                             // Storage that created this object
+    size_t chunkSize;                                               // Size of each ranged request
+    unsigned int requestMax;                                        // Max ranged requests in progress
+    const String *etag;                                             // ETag of the first response, required by ranged requests
 
-    HttpResponse *httpResponse;                                     // HTTP response
+    HttpRangeRead *rangeRead;                                       // Reads content of the HTTP response(s)
 } StorageReadS3;
 
 /***********************************************************************************************************************************
@@ -32,6 +36,60 @@ Macros for function logging
 #define FUNCTION_LOG_STORAGE_READ_S3_FORMAT(value, buffer, bufferSize)                                                             \
     objNameToLog(value, "StorageReadS3", buffer, bufferSize)
 
+/***********************************************************************************************************************************
+Send a request for a range of the file
+***********************************************************************************************************************************/
+static HttpRequest *
+storageReadS3RangeRequest(void *const data, const uint64_t offset, const uint64_t size)
+{
+    StorageReadS3 *const this = data;
+
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM(STORAGE_READ_S3, this);
+        FUNCTION_LOG_PARAM(UINT64, offset);
+        FUNCTION_LOG_PARAM(UINT64, size);
+    FUNCTION_LOG_END();
+
+    ASSERT(this != NULL);
+
+    HttpRequest *result;
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        HttpHeader *const header = httpHeaderPutRange(httpHeaderNew(NULL), this->interface.offset + offset, VARUINT64(size));
+
+        // Fail if the file has been replaced since the first request so the content is not stitched together from two versions
+        if (this->etag != NULL)
+            httpHeaderPut(header, HTTP_HEADER_IF_MATCH_STR, this->etag);
+
+        MEM_CONTEXT_PRIOR_BEGIN()
+        {
+            result = storageS3RequestAsyncP(
+                this->storage, HTTP_VERB_GET_STR, this->interface.name, .header = header, .sseC = true);
+        }
+        MEM_CONTEXT_PRIOR_END();
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_LOG_RETURN(HTTP_REQUEST, result);
+}
+
+/***********************************************************************************************************************************
+Get the response for a range of the file
+***********************************************************************************************************************************/
+static HttpResponse *
+storageReadS3RangeResponse(void *const data, HttpRequest *const request)
+{
+    FUNCTION_LOG_BEGIN(logLevelTrace);
+        FUNCTION_LOG_PARAM_P(VOID, data);
+        FUNCTION_LOG_PARAM(HTTP_REQUEST, request);
+    FUNCTION_LOG_END();
+
+    (void)data;                                                     // No data is used
+
+    FUNCTION_LOG_RETURN(HTTP_RESPONSE, storageS3ResponseP(request, .contentIo = true));
+}
+
 /***********************************************************************************************************************************
 Open the file
 ***********************************************************************************************************************************/
@@ -45,21 +103,35 @@ storageReadS3Open(THIS_VOID)
     FUNCTION_LOG_END();
 
     ASSERT(this != NULL);
-    ASSERT(this->httpResponse == NULL);
+    ASSERT(this->rangeRead == NULL);
 
     bool result = false;
 
-    // Request the file
-    MEM_CONTEXT_OBJ_BEGIN(this)
+    MEM_CONTEXT_TEMP_BEGIN()
     {
-        this->httpResponse = storageS3RequestP(
+        // Request the file
+        HttpResponse *const response = storageS3RequestP(
             this->storage, HTTP_VERB_GET_STR, this->interface.name,
             .header = httpHeaderPutRange(httpHeaderNew(NULL), this->interface.offset, this->interface.limit),
             .allowMissing = true, .contentIo = true, .sseC = true);
+
+        // Read the response, splitting the rest of the file into ranged requests when it is large enough
+        if (httpResponseCodeOk(response))
+        {
+            MEM_CONTEXT_OBJ_BEGIN(this)
+            {
+                this->etag = strDup(httpHeaderGet(httpResponseHeader(response), HTTP_HEADER_ETAG_STR));
+                this->rangeRead = httpRangeReadNewP(
+                    response, .chunkSize = this->chunkSize, .requestMax = this->requestMax,
+                    .requestCallback = storageReadS3RangeRequest, .responseCallback = storageReadS3RangeResponse,
+                    .callbackData = this);
+            }
+            MEM_CONTEXT_OBJ_END();
+        }
     }
-    MEM_CONTEXT_OBJ_END();
+    MEM_CONTEXT_TEMP_END();
 
-    if (httpResponseCodeOk(this->httpResponse))
+    if (this->rangeRead != NULL)
     {
         result = true;
     }
@@ -84,11 +156,10 @@ storageReadS3(THIS_VOID, Buffer *const buffer, const bool block)
         FUNCTION_LOG_PARAM(BOOL, block);
     FUNCTION_LOG_END();
 
-    ASSERT(this != NULL && this->httpResponse != NULL);
-    ASSERT(httpResponseIoRead(this->httpResponse) != NULL);
+    ASSERT(this != NULL && this->rangeRead != NULL);
     ASSERT(buffer != NULL && !bufFull(buffer));
 
-    FUNCTION_LOG_RETURN(SIZE, ioRead(httpResponseIoRead(this->httpResponse), buffer));
+    FUNCTION_LOG_RETURN(SIZE, httpRangeReadRead(this->rangeRead, buffer));
 }
 
 /***********************************************************************************************************************************
@@ -103,16 +174,16 @@ storageReadS3Eof(THIS_VOID)
         FUNCTION_TEST_PARAM(STORAGE_READ_S3, this);
     FUNCTION_TEST_END();
 
-    ASSERT(this != NULL && this->httpResponse != NULL);
-    ASSERT(httpResponseIoRead(this->httpResponse) != NULL);
+    ASSERT(this != NULL && this->rangeRead != NULL);
 
-    FUNCTION_TEST_RETURN(BOOL, ioReadEof(httpResponseIoRead(this->httpResponse)));
+    FUNCTION_TEST_RETURN(BOOL, httpRangeReadEof(this->rangeRead));
 }
 
 /**********************************************************************************************************************************/
 FN_EXTERN StorageRead *
 storageReadS3New(
-    StorageS3 *const storage, const String *const name, const bool ignoreMissing, const uint64_t offset, const Variant *const limit)
+    StorageS3 *const storage, const String *const name, const bool ignoreMissing, const uint64_t offset, const Variant *const limit,
+    const size_t chunkSize, const unsigned int requestMax)
 {
     FUNCTION_LOG_BEGIN(logLevelTrace);
         FUNCTION_LOG_PARAM(STORAGE_S3, storage);
@@ -120,6 +191,8 @@ storageReadS3New(
         FUNCTION_LOG_PARAM(BOOL, ignoreMissing);
         FUNCTION_LOG_PARAM(UINT64, offset);
         FUNCTION_LOG_PARAM(VARIANT, limit);
+        FUNCTION_LOG_PARAM(SIZE, chunkSize);
+        FUNCTION_LOG_PARAM(UINT, requestMax);
     FUNCTION_LOG_END();
 
     ASSERT(storage != NULL);
@@ -131,6 +204,8 @@ storageReadS3New(
         *this = (StorageReadS3)
         {
             .storage = storage,
+            .chunkSize = chunkSize,
+            .requestMax = requestMax,
 
             .interface = (StorageReadInterface)
             {
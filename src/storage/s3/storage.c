@@ -101,6 +101,8 @@ struct StorageS3
     const String *sseCustomerKey;                                   // Base64 of SSE-C encryption key
     const String *sseCustomerKeyMd5;                                // Base64 of MD5 of SSE-C key
     size_t partSize;                                                // Part size for multi-part upload
+    size_t downloadChunkSize;                                       // Chunk size for ranged reads
+    unsigned int downloadMax;                                       // Max ranged reads in progress for each file
     const String *tag;                                              // Tags to be applied to objects
     unsigned int deleteMax;                                         // Maximum objects that can be deleted in one request
     StorageS3UriStyle uriStyle;                                     // Path or host style URIs
@@ -892,7 +894,9 @@ storageS3NewRead(THIS_VOID, const String *const file, const bool ignoreMissing,
     ASSERT(this != NULL);
     ASSERT(file != NULL);
 
-    FUNCTION_LOG_RETURN(STORAGE_READ, storageReadS3New(this, file, ignoreMissing, param.offset, param.limit));
+    FUNCTION_LOG_RETURN(
+        STORAGE_READ,
+        storageReadS3New(this, file, ignoreMissing, param.offset, param.limit, this->downloadChunkSize, this->downloadMax));
 }
 
 /**********************************************************************************************************************************/
@@ -1118,8 +1122,9 @@ storageS3New(
     const String *const endPoint, const StorageS3UriStyle uriStyle, const String *const region, const StorageS3KeyType keyType,
     const String *const accessKey, const String *const secretAccessKey, const String *const securityToken,
     const String *const kmsKeyId, const String *sseCustomerKey, const String *const credRole, const String *const webIdToken,
-    const size_t partSize, const KeyValue *const tag, const String *host, const unsigned int port, const TimeMSec timeout,
-    const bool verifyPeer, const String *const caFile, const String *const caPath)
+    const size_t partSize, const size_t downloadChunkSize, const unsigned int downloadMax, const KeyValue *const tag,
+    const String *host, const unsigned int port, const TimeMSec timeout, const bool verifyPeer, const String *const caFile,
+    const String *const caPath)
 {
     FUNCTION_LOG_BEGIN(logLevelDebug);
         FUNCTION_LOG_PARAM(STRING, path);
@@ -1138,6 +1143,8 @@ storageS3New(
         FUNCTION_TEST_PARAM(STRING, credRole);
         FUNCTION_TEST_PARAM(STRING, webIdToken);
         FUNCTION_LOG_PARAM(SIZE, partSize);
+        FUNCTION_LOG_PARAM(SIZE, downloadChunkSize);
+        FUNCTION_LOG_PARAM(UINT, downloadMax);
         FUNCTION_LOG_PARAM(KEY_VALUE, tag);
         FUNCTION_LOG_PARAM(STRING, host);
         FUNCTION_LOG_PARAM(UINT, port);
@@ -1152,6 +1159,8 @@ storageS3New(
     ASSERT(endPoint != NULL);
     ASSERT(region != NULL);
     ASSERT(partSize != 0);
+    ASSERT(downloadChunkSize != 0);
+    ASSERT(downloadMax != 0);
 
     OBJ_NEW_BEGIN(StorageS3, .childQty = MEM_CONTEXT_QTY_MAX)
     {
@@ -1164,6 +1173,8 @@ storageS3New(
             .kmsKeyId = strDup(kmsKeyId),
             .sseCustomerKey = strDup(sseCustomerKey),
             .partSize = partSize,
+            .downloadChunkSize = downloadChunkSize,
+            .downloadMax = downloadMax,
             .deleteMax = STORAGE_S3_DELETE_MAX,
             .uriStyle = uriStyle,
             .bucketEndpoint =
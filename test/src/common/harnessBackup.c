@@ -95,11 +95,15 @@ hrnBackupScriptSet(const HrnBackupScript *const script, const unsigned int scrip
 
 /**********************************************************************************************************************************/
 static void
-backupProcess(const BackupData *const backupData, Manifest *const manifest, const String *const cipherPassBackup)
+backupProcess(
+    const BackupData *const backupData, const InfoBackup *const infoBackup, Manifest *const manifest,
+    const String *const archiveStart, const String *const cipherPassBackup)
 {
     FUNCTION_HARNESS_BEGIN();
         FUNCTION_HARNESS_PARAM(BACKUP_DATA, backupData);
+        FUNCTION_HARNESS_PARAM(INFO_BACKUP, infoBackup);
         FUNCTION_HARNESS_PARAM(MANIFEST, manifest);
+        FUNCTION_HARNESS_PARAM(STRING, archiveStart);
         FUNCTION_HARNESS_PARAM(STRING, cipherPassBackup);
     FUNCTION_HARNESS_END();
 
@@ -142,7 +146,7 @@ backupProcess(const BackupData *const backupData, Manifest *const manifest, cons
         hrnBackupLocal.scriptSize = 0;
     }
 
-    backupProcess_SHIMMED(backupData, manifest, cipherPassBackup);
+    backupProcess_SHIMMED(backupData, infoBackup, manifest, archiveStart, cipherPassBackup);
 
     FUNCTION_HARNESS_RETURN_VOID();
 }
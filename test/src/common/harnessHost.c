@@ -709,8 +709,8 @@ hrnHostConfig(HrnHost *const this)
 
                         this->pub.repo1Storage = storageAzureNew(
                             hrnHostRepo1Path(this), true, NULL, STRDEF(HRN_HOST_AZURE_CONTAINER), STRDEF(HRN_HOST_AZURE_ACCOUNT),
-                            storageAzureKeyTypeShared, STRDEF(HRN_HOST_AZURE_KEY), 4 * 1024 * 1024, NULL, hrnHostIp(azure),
-                            storageAzureUriStylePath, 443, ioTimeoutMs(), false, NULL, NULL);
+                            storageAzureKeyTypeShared, STRDEF(HRN_HOST_AZURE_KEY), 4 * 1024 * 1024, 16 * 1024 * 1024, 1, NULL,
+                            hrnHostIp(azure), storageAzureUriStylePath, 443, ioTimeoutMs(), false, NULL, NULL);
                     }
                     MEM_CONTEXT_OBJ_END();
 
@@ -731,7 +731,7 @@ hrnHostConfig(HrnHost *const this)
 
                         this->pub.repo1Storage = storageGcsNew(
                             hrnHostRepo1Path(this), true, NULL, STRDEF(HRN_HOST_GCS_BUCKET), storageGcsKeyTypeToken,
-                            STRDEF(HRN_HOST_GCS_KEY), 4 * 1024 * 1024, NULL,
+                            STRDEF(HRN_HOST_GCS_KEY), 4 * 1024 * 1024, 16 * 1024 * 1024, 1, NULL,
                             strNewFmt("%s:%d", strZ(hrnHostIp(gcs)), HRN_HOST_GCS_PORT), ioTimeoutMs(), false, NULL, NULL);
                     }
                     MEM_CONTEXT_OBJ_END();
@@ -755,8 +755,8 @@ hrnHostConfig(HrnHost *const this)
                         this->pub.repo1Storage = storageS3New(
                             hrnHostRepo1Path(this), true, NULL, STRDEF(HRN_HOST_S3_BUCKET), STRDEF(HRN_HOST_S3_ENDPOINT),
                             storageS3UriStyleHost, STR(HRN_HOST_S3_REGION), storageS3KeyTypeShared, STRDEF(HRN_HOST_S3_ACCESS_KEY),
-                            STRDEF(HRN_HOST_S3_ACCESS_SECRET_KEY), NULL, NULL, NULL, NULL, NULL, 5 * 1024 * 1024, NULL,
-                            hrnHostIp(s3), 443, ioTimeoutMs(), false, NULL, NULL);
+                            STRDEF(HRN_HOST_S3_ACCESS_SECRET_KEY), NULL, NULL, NULL, NULL, NULL, 5 * 1024 * 1024,
+                            16 * 1024 * 1024, 1, NULL, hrnHostIp(s3), 443, ioTimeoutMs(), false, NULL, NULL);
                     }
                     MEM_CONTEXT_OBJ_END();
 
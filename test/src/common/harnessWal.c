@@ -36,7 +36,7 @@ hrnGpdbCreateXRecord(uint8_t rmid, uint8_t info, uint32_t bodySize, void *body,
     else
         memcpy((void *) XLogRecGetData(record), body, bodySize);
 
-    record->xl_crc = xLogRecordChecksumGPDB6(record, param.heapPageSize);
+    record->xl_crc = xLogRecordChecksumGPDB6(record, param.heapPageSize, NULL);
 
     return record;
 }
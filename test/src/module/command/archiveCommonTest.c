@@ -1,8 +1,10 @@
 /***********************************************************************************************************************************
 Test Archive Common
 ***********************************************************************************************************************************/
+#include <string.h>
 #include <unistd.h>
 
+#include "common/io/bufferRead.h"
 #include "storage/helper.h"
 #include "storage/posix/storage.h"
 
@@ -10,6 +12,28 @@ Test Archive Common
 #include "common/harnessFork.h"
 #include "common/harnessStorage.h"
 
+/***********************************************************************************************************************************
+Build a list of reads for walBundleWrite() with the same content for each name
+***********************************************************************************************************************************/
+static List *
+testBundleReadList(const StringList *const nameList, const char *const content)
+{
+    FUNCTION_HARNESS_BEGIN();
+        FUNCTION_HARNESS_PARAM(STRING_LIST, nameList);
+        FUNCTION_HARNESS_PARAM(STRINGZ, content);
+    FUNCTION_HARNESS_END();
+
+    List *const result = lstNewP(sizeof(IoRead *));
+
+    for (unsigned int nameIdx = 0; nameIdx < strLstSize(nameList); nameIdx++)
+    {
+        IoRead *const read = ioBufferReadNew(bufNewC(content, strlen(content)));
+        lstAdd(result, &read);
+    }
+
+    FUNCTION_HARNESS_RETURN(LIST, result);
+}
+
 /***********************************************************************************************************************************
 Test Run
 ***********************************************************************************************************************************/
@@ -449,5 +473,270 @@ testRun(void)
         TEST_RESULT_STRLST_Z(strLstSort(list, sortOrderDesc), "11-10\n10-4\n9.4-2\n9.6-1\n", "sort descending");
     }
 
+    // *****************************************************************************************************************************
+    if (testBegin("archiveDictGet() and archiveDictPut()"))
+    {
+        StringList *argList = strLstNew();
+        hrnCfgArgRawZ(argList, cfgOptStanza, "db");
+        hrnCfgArgRawZ(argList, cfgOptPgPath, TEST_PATH "/pg");
+        hrnCfgArgRawZ(argList, cfgOptRepoPath, TEST_PATH "/repo");
+        HRN_CFG_LOAD(cfgCmdArchivePush, argList);
+
+        const Buffer *const dict = BUFSTRDEF("DICTIONARY");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("missing dictionary is cached");
+
+        TEST_RESULT_PTR(archiveDictGet(0, STRDEF("11-1"), cipherTypeNone, NULL), NULL, "no dictionary");
+
+        HRN_STORAGE_PUT(storageTest, "repo/archive/db/11-1/" ARCHIVE_DICT_FILE, dict);
+
+        TEST_RESULT_PTR(archiveDictGet(0, STRDEF("11-1"), cipherTypeNone, NULL), NULL, "still no dictionary from cache");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("get encrypted dictionary");
+
+        HRN_STORAGE_PUT(
+            storageTest, "repo/archive/db/11-2/" ARCHIVE_DICT_FILE, dict, .cipherType = cipherTypeAes256Cbc,
+            .cipherPass = TEST_CIPHER_PASS_ARCHIVE);
+
+        TEST_RESULT_STR_Z(
+            strNewBuf(archiveDictGet(0, STRDEF("11-2"), cipherTypeAes256Cbc, STRDEF(TEST_CIPHER_PASS_ARCHIVE))), "DICTIONARY",
+            "dictionary");
+
+        HRN_STORAGE_REMOVE(storageTest, "repo/archive/db/11-2/" ARCHIVE_DICT_FILE);
+
+        TEST_RESULT_STR_Z(
+            strNewBuf(archiveDictGet(0, STRDEF("11-2"), cipherTypeAes256Cbc, STRDEF(TEST_CIPHER_PASS_ARCHIVE))), "DICTIONARY",
+            "dictionary from cache");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("put dictionary replaces cached result");
+
+        TEST_RESULT_VOID(
+            archiveDictPut(0, STRDEF("11-1"), cipherTypeAes256Cbc, STRDEF(TEST_CIPHER_PASS_ARCHIVE), BUFSTRDEF("NEWDICT")),
+            "put dictionary");
+        TEST_RESULT_STR_Z(
+            strNewBuf(archiveDictGet(0, STRDEF("11-1"), cipherTypeAes256Cbc, STRDEF(TEST_CIPHER_PASS_ARCHIVE))), "NEWDICT",
+            "dictionary from cache");
+        TEST_STORAGE_GET(
+            storageTest, "repo/archive/db/11-1/" ARCHIVE_DICT_FILE, "NEWDICT", .cipherType = cipherTypeAes256Cbc,
+            .cipherPass = TEST_CIPHER_PASS_ARCHIVE, .comment = "dictionary is encrypted in repo");
+    }
+
+    // *****************************************************************************************************************************
+    if (testBegin("walBundleWrite(), walBundleIndex(), walBundleFind(), and walBundleList()"))
+    {
+        StringList *argList = strLstNew();
+        hrnCfgArgRawZ(argList, cfgOptStanza, "db");
+        hrnCfgArgRawZ(argList, cfgOptPgPath, "/path/to/pg");
+        hrnCfgArgRawZ(argList, cfgOptRepoPath, TEST_PATH);
+        HRN_CFG_LOAD(cfgCmdArchiveGet, argList);
+
+        const String *const path = STRDEF(STORAGE_REPO_ARCHIVE "/9.6-1/1234567812345678");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("bundle names");
+
+        TEST_RESULT_BOOL(walIsBundle(STRDEF("123456781234567812345678-12345678123456781234567A.bundle")), true, "bundle");
+        TEST_RESULT_BOOL(
+            walIsBundle(STRDEF("123456781234567812345678-aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa")), false, "not bundle");
+        TEST_RESULT_STR_Z(
+            walBundleName(STRDEF("123456781234567812345678"), STRDEF("12345678123456781234567A")),
+            "123456781234567812345678-12345678123456781234567A.bundle", "bundle name");
+        TEST_RESULT_STR_Z(
+            walBundleSegmentLast(STRDEF("123456781234567812345678-12345678123456781234567A.bundle")), "12345678123456781234567A",
+            "bundle last segment");
+        TEST_RESULT_STR_Z(
+            walBundleSegmentLast(STRDEF("123456781234567812345678-aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa.gz")),
+            "123456781234567812345678", "segment last segment");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("write and read bundle");
+
+        StringList *nameList = strLstNew();
+        strLstAddZ(nameList, "123456781234567812345678-aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa.gz");
+        strLstAddZ(nameList, "12345678123456781234567A-bbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbb.gz");
+
+        List *readList = lstNewP(sizeof(IoRead *));
+        IoRead *read = ioBufferReadNew(BUFSTRDEF("SEG1"));
+        lstAdd(readList, &read);
+        read = ioBufferReadNew(BUFSTRDEF("SEGMENT2"));
+        lstAdd(readList, &read);
+
+        TEST_RESULT_VOID(
+            walBundleWrite(
+                storageWriteIo(
+                    storageNewWriteP(
+                        storageRepoWrite(), strNewFmt("%s/123456781234567812345678-12345678123456781234567A.bundle", strZ(path)))),
+                nameList, readList),
+            "write bundle");
+
+        const List *bundleFileList;
+        TEST_ASSIGN(
+            bundleFileList, walBundleIndex(storageRepo(), path, STRDEF("123456781234567812345678-12345678123456781234567A.bundle")),
+            "read index");
+        TEST_RESULT_UINT(lstSize(bundleFileList), 2, "index size");
+        TEST_RESULT_STR_Z(
+            ((const WalBundleFile *)lstGet(bundleFileList, 1))->name,
+            "12345678123456781234567A-bbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbb.gz", "index name");
+        TEST_RESULT_UINT(((const WalBundleFile *)lstGet(bundleFileList, 1))->size, 8, "index size");
+        TEST_RESULT_PTR(
+            walBundleIndex(storageRepo(), path, STRDEF("123456781234567812345678-12345678123456781234567A.bundle")), bundleFileList,
+            "index from cache");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("find segments in bundle");
+
+        StringList *fileList = strLstNew();
+        strLstAddZ(fileList, "123456781234567812345677-eeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeee");
+        strLstAddZ(fileList, "123456781234567812345678-12345678123456781234567A.bundle");
+
+        TEST_RESULT_PTR(
+            walBundleFind(storageRepo(), path, fileList, STRDEF("123456781234567812345677")), NULL, "segment before bundle");
+        TEST_RESULT_PTR(walBundleFind(storageRepo(), path, fileList, STRDEF("123456781234567812345679")), NULL, "segment in gap");
+        TEST_RESULT_PTR(
+            walBundleFind(storageRepo(), path, fileList, STRDEF("12345678123456781234567B")), NULL, "segment after bundle");
+        TEST_RESULT_PTR(
+            walBundleFind(storageRepo(), path, fileList, STRDEF("12345678123456781234567A.partial")), NULL, "partial segment");
+
+        const WalBundleFile *bundleFile;
+        TEST_ASSIGN(bundleFile, walBundleFind(storageRepo(), path, fileList, STRDEF("12345678123456781234567A")), "find segment");
+        TEST_RESULT_STR_Z(bundleFile->name, "12345678123456781234567A-bbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbb.gz", "name");
+        TEST_RESULT_STR_Z(bundleFile->bundle, "123456781234567812345678-12345678123456781234567A.bundle", "bundle");
+        TEST_RESULT_STR_Z(
+            strNewBuf(storageGetP(walBundleReadNew(storageRepo(), path, bundleFile, false))), "SEGMENT2", "read segment");
+
+        List *bundleList;
+        TEST_ASSIGN(bundleList, walBundleList(storageRepo(), path, fileList), "list bundled segments");
+        TEST_RESULT_UINT(lstSize(bundleList), 2, "list size");
+        TEST_RESULT_STR_Z(
+            strNewBuf(storageGetP(walBundleReadNew(storageRepo(), path, lstGet(bundleList, 0), false))), "SEG1", "read segment");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("find segments in bundle with walSegmentFind()");
+
+        HRN_STORAGE_PUT_EMPTY(
+            storageTest, "archive/db/9.6-1/1234567812345678/123456781234567812345677-eeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeee");
+
+        TEST_RESULT_STR_Z(
+            walSegmentFindOne(storageRepo(), STRDEF("9.6-1"), STRDEF("12345678123456781234567A"), 0),
+            "12345678123456781234567A-bbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbb.gz", "find single");
+        TEST_RESULT_STR(
+            walSegmentFindOne(storageRepo(), STRDEF("9.6-1"), STRDEF("123456781234567812345679"), 0), NULL, "segment in gap");
+
+        WalSegmentFind *find;
+        TEST_ASSIGN(find, walSegmentFindNew(storageRepo(), STRDEF("9.6-1"), false, 0), "new find");
+        TEST_RESULT_STR_Z(
+            walSegmentFind(find, STRDEF("123456781234567812345677")),
+            "123456781234567812345677-eeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeee", "find segment");
+        TEST_RESULT_STRLST_Z(find->bundleList, "123456781234567812345678-12345678123456781234567A.bundle\n", "bundle list");
+        TEST_RESULT_STR_Z(
+            walSegmentFind(find, STRDEF("123456781234567812345678")),
+            "123456781234567812345678-aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa.gz", "find bundled segment");
+        TEST_RESULT_STR_Z(
+            walSegmentFind(find, STRDEF("12345678123456781234567A")),
+            "12345678123456781234567A-bbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbb.gz", "find bundled segment");
+        TEST_RESULT_STR(walSegmentFind(find, STRDEF("12345678123456781234567B")), NULL, "segment after bundle");
+        TEST_RESULT_PTR(find->list, NULL, "list cleared");
+
+        HRN_STORAGE_PUT_EMPTY(
+            storageTest, "archive/db/9.6-1/1234567812345678/12345678123456781234567A-cccccccccccccccccccccccccccccccccccccccc");
+
+        TEST_RESULT_STR_Z(
+            walSegmentFindOne(storageRepo(), STRDEF("9.6-1"), STRDEF("12345678123456781234567A"), 0),
+            "12345678123456781234567A-cccccccccccccccccccccccccccccccccccccccc", "single find does not list bundles when found");
+
+        TEST_ASSIGN(find, walSegmentFindNew(storageRepo(), STRDEF("9.6-1"), false, 0), "new find");
+        TEST_ERROR(
+            walSegmentFind(find, STRDEF("12345678123456781234567A")), ArchiveDuplicateError,
+            "duplicates found in archive for WAL segment 12345678123456781234567A:"
+            " 12345678123456781234567A-cccccccccccccccccccccccccccccccccccccccc"
+            ", 123456781234567812345678-12345678123456781234567A.bundle"
+            "/12345678123456781234567A-bbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbb.gz\n"
+            "HINT: are multiple primaries archiving to this stanza?");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("index larger than first read");
+
+        nameList = strLstNew();
+
+        for (unsigned int nameIdx = 0; nameIdx < 1024; nameIdx++)
+            strLstAddFmt(nameList, "1234567812345679%08X-aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa.gz", nameIdx);
+
+        TEST_RESULT_VOID(
+            walBundleWrite(
+                storageWriteIo(
+                    storageNewWriteP(
+                        storageRepoWrite(),
+                        STRDEF(
+                            STORAGE_REPO_ARCHIVE
+                            "/9.6-1/1234567812345679/123456781234567900000000-1234567812345679000003FF.bundle"))),
+                nameList, testBundleReadList(nameList, "X")),
+            "write bundle");
+
+        TEST_ASSIGN(
+            bundleFileList,
+            walBundleIndex(
+                storageRepo(), STRDEF(STORAGE_REPO_ARCHIVE "/9.6-1/1234567812345679"),
+                STRDEF("123456781234567900000000-1234567812345679000003FF.bundle")),
+            "read index");
+        TEST_RESULT_UINT(lstSize(bundleFileList), 1024, "index size");
+        TEST_RESULT_STR_Z(
+            ((const WalBundleFile *)lstGet(bundleFileList, 1023))->name,
+            "1234567812345679000003FF-aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa.gz", "index name");
+        TEST_RESULT_UINT(((const WalBundleFile *)lstGet(bundleFileList, 1023))->offset, 1023, "index offset");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("cache is limited");
+
+        for (unsigned int bundleIdx = 0; bundleIdx <= WAL_BUNDLE_CACHE_MAX; bundleIdx++)
+        {
+            const String *const bundle = strNewFmt("1234567812345678%08X-1234567812345678%08X.bundle", bundleIdx, bundleIdx);
+
+            walBundleWrite(
+                storageWriteIo(storageNewWriteP(storageRepoWrite(), strNewFmt("%s/%s", strZ(path), strZ(bundle)))), nameList,
+                testBundleReadList(nameList, "X"));
+            walBundleIndex(storageRepo(), path, bundle);
+        }
+
+        TEST_RESULT_UINT(lstSize(walBundleLocal.cacheList), WAL_BUNDLE_CACHE_MAX, "cache size");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("invalid bundles");
+
+        HRN_STORAGE_PUT_Z(storageTest, "archive/db/9.6-1/1234567812345678/bad1.bundle", "XX");
+
+        TEST_ERROR(
+            walBundleIndex(storageRepo(), path, STRDEF("bad1.bundle")), FormatError,
+            "bundle '<REPO:ARCHIVE>/9.6-1/1234567812345678/bad1.bundle' is missing the index footer");
+
+        PackWrite *const pack = pckWriteNewP();
+        pckWriteU32P(pack, 99);
+        pckWriteEndP(pack);
+
+        const Buffer *const badIndex = pckToBuf(pckWriteResult(pack));
+        Buffer *const bad = bufNew(0);
+
+        const unsigned char badFooter[WAL_BUNDLE_FOOTER_SIZE] = {0, 0, 0, (unsigned char)bufUsed(badIndex)};
+
+        bufCat(bad, badIndex);
+        bufCat(bad, BUF(badFooter, sizeof(badFooter)));
+
+        HRN_STORAGE_PUT(storageTest, "archive/db/9.6-1/1234567812345678/bad2.bundle", bad);
+
+        TEST_ERROR(
+            walBundleIndex(storageRepo(), path, STRDEF("bad2.bundle")), FormatError,
+            "bundle '<REPO:ARCHIVE>/9.6-1/1234567812345678/bad2.bundle' has format 99 but 2 is required");
+
+        const unsigned char badSize[] = {'X', 'X', 0, 0, 0, 0xFF};
+
+        HRN_STORAGE_PUT(storageTest, "archive/db/9.6-1/1234567812345678/bad3.bundle", BUF(badSize, sizeof(badSize)));
+
+        TEST_ERROR(
+            walBundleIndex(storageRepo(), path, STRDEF("bad3.bundle")), FormatError,
+            "bundle '<REPO:ARCHIVE>/9.6-1/1234567812345678/bad3.bundle' has an index larger than the bundle");
+    }
+
     FUNCTION_HARNESS_RETURN_VOID();
 }
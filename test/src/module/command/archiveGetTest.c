@@ -90,6 +90,129 @@ testRun(void)
         TEST_STORAGE_LIST(
             storageSpool(), STORAGE_SPOOL_ARCHIVE_IN,
             "000000010000000A00000FFE\n000000010000000A00000FFF\n000000010000000A00000FFF.ok\n");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("remove wal filter fragments");
+
+        hrnCfgArgRawZ(argList, cfgOptFilter, TEST_PATH "/filter.json");
+        HRN_CFG_LOAD(cfgCmdArchiveGet, argList);
+
+        HRN_STORAGE_PUT_EMPTY(
+            storageSpoolWrite(),
+            STORAGE_SPOOL_ARCHIVE "/fragment/000000010000000A00000FFB-abcdabcdabcdabcdabcdabcdabcdabcdabcdabcd.tail");
+        HRN_STORAGE_PUT_EMPTY(
+            storageSpoolWrite(),
+            STORAGE_SPOOL_ARCHIVE "/fragment/000000010000000A00000FFC-abcdabcdabcdabcdabcdabcdabcdabcdabcdabcd.tail");
+        HRN_STORAGE_PUT_EMPTY(
+            storageSpoolWrite(),
+            STORAGE_SPOOL_ARCHIVE "/fragment/000000010000000A00000FFD-abcdabcdabcdabcdabcdabcdabcdabcdabcdabcd.tail");
+
+        TEST_RESULT_STRLST_Z(
+            queueNeed(STRDEF("000000010000000A00000FFD"), true, queueSize, walSegmentSize, PG_VERSION_11),
+            "000000010000000B00000000\n000000010000000B00000001\n000000010000000B00000002\n", "queue has wal");
+
+        TEST_STORAGE_LIST(
+            storageSpoolWrite(), STORAGE_SPOOL_ARCHIVE "/fragment",
+            "000000010000000A00000FFC-abcdabcdabcdabcdabcdabcdabcdabcdabcdabcd.tail\n"
+            "000000010000000A00000FFD-abcdabcdabcdabcdabcdabcdabcdabcdabcdabcd.tail\n", .remove = true);
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("queue stops at recovery target");
+
+        argList = strLstNew();
+        hrnCfgArgRawZ(argList, cfgOptStanza, "test1");
+        hrnCfgArgRawBool(argList, cfgOptArchiveAsync, true);
+        hrnCfgArgRawZ(argList, cfgOptPgPath, "/unused");
+        hrnCfgArgRawZ(argList, cfgOptSpoolPath, TEST_PATH "/spool");
+        hrnCfgArgRawZ(argList, cfgOptArchiveGetQueueTarget, "B/1FFFFF");
+        HRN_CFG_LOAD(cfgCmdArchiveGet, argList);
+
+        TEST_RESULT_STRLST_Z(
+            queueNeed(STRDEF("000000010000000A00000FFD"), true, queueSize, walSegmentSize, PG_VERSION_11),
+            "000000010000000B00000000\n000000010000000B00000001\n", "queue stops at target");
+
+        TEST_RESULT_STRLST_Z(
+            queueNeed(STRDEF("000000010000000B00000001"), true, queueSize, walSegmentSize, PG_VERSION_11), NULL,
+            "queue is empty after target");
+
+        TEST_RESULT_STRLST_Z(
+            queueNeed(STRDEF("000000020000000B00000005"), false, queueSize, walSegmentSize, PG_VERSION_11),
+            "000000020000000B00000005\n", "requested segment after target");
+
+        TEST_STORAGE_LIST_EMPTY(storageSpool(), STORAGE_SPOOL_ARCHIVE_IN);
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("adaptive queue size");
+
+        argList = strLstNew();
+        hrnCfgArgRawZ(argList, cfgOptStanza, "test1");
+        hrnCfgArgRawBool(argList, cfgOptArchiveAsync, true);
+        hrnCfgArgRawZ(argList, cfgOptPgPath, "/unused");
+        hrnCfgArgRawZ(argList, cfgOptSpoolPath, TEST_PATH "/spool");
+        hrnCfgArgRawZ(argList, cfgOptArchiveGetQueueMax, "16MiB");
+        hrnCfgArgRawBool(argList, cfgOptArchiveGetQueueAdapt, true);
+        HRN_CFG_LOAD(cfgCmdArchiveGet, argList);
+
+        TEST_RESULT_UINT(archiveGetQueueSize(walSegmentSize), 16 * 1024 * 1024, "no stats");
+
+        HRN_STORAGE_PUT_Z(storageSpoolWrite(), STORAGE_SPOOL_ARCHIVE "/get-replay.stat", "1\n1000");
+        TEST_RESULT_UINT(archiveGetQueueSize(walSegmentSize), 16 * 1024 * 1024, "no fetch stat");
+
+        HRN_STORAGE_PUT_Z(storageSpoolWrite(), STORAGE_SPOOL_ARCHIVE "/get-fetch.stat", "2500");
+        TEST_RESULT_UINT(archiveGetQueueSize(walSegmentSize), 8 * 1024 * 1024, "queue sized from stats");
+
+        HRN_STORAGE_PUT_Z(storageSpoolWrite(), STORAGE_SPOOL_ARCHIVE "/get-fetch.stat", "20000");
+        TEST_RESULT_UINT(archiveGetQueueSize(walSegmentSize), 16 * 1024 * 1024, "queue limited to max");
+
+        HRN_STORAGE_PUT_Z(storageSpoolWrite(), STORAGE_SPOOL_ARCHIVE "/get-replay.stat", "1\nBOGUS");
+        TEST_RESULT_UINT(archiveGetQueueSize(walSegmentSize), 16 * 1024 * 1024, "invalid replay stat");
+
+        HRN_STORAGE_PUT_Z(storageSpoolWrite(), STORAGE_SPOOL_ARCHIVE "/get-replay.stat", "1000");
+        TEST_RESULT_UINT(archiveGetQueueSize(walSegmentSize), 16 * 1024 * 1024, "replay stat missing values");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("record stats");
+
+        HRN_STORAGE_PUT_Z(storageSpoolWrite(), STORAGE_SPOOL_ARCHIVE "/get-fetch.stat", "2500");
+        TEST_RESULT_VOID(archiveGetStatFetch(1500), "record fetch");
+        TEST_STORAGE_GET(storageSpoolWrite(), STORAGE_SPOOL_ARCHIVE "/get-fetch.stat", "2250", .remove = true);
+
+        TEST_RESULT_VOID(archiveGetStatFetch(1500), "record first fetch");
+        TEST_STORAGE_GET(storageSpoolWrite(), STORAGE_SPOOL_ARCHIVE "/get-fetch.stat", "1500", .remove = true);
+
+        TimeMSec stat[ARCHIVE_GET_STAT_REPLAY_TOTAL];
+
+        HRN_STORAGE_PUT_Z(
+            storageSpoolWrite(), STORAGE_SPOOL_ARCHIVE "/get-replay.stat", zNewFmt("%" PRIu64 "\n0", timeMSec() - 100));
+        TEST_RESULT_VOID(archiveGetStatReplay(true), "record replay");
+        archiveGetStatLoad(STRDEF(ARCHIVE_GET_STAT_REPLAY_FILE), stat, ARCHIVE_GET_STAT_REPLAY_TOTAL);
+        TEST_RESULT_BOOL(stat[ARCHIVE_GET_STAT_REPLAY_INTERVAL] >= 100, true, "check interval");
+        TEST_RESULT_BOOL(stat[ARCHIVE_GET_STAT_REPLAY_INTERVAL] < ARCHIVE_GET_STAT_INTERVAL_MAX, true, "check interval");
+
+        HRN_STORAGE_PUT_Z(
+            storageSpoolWrite(), STORAGE_SPOOL_ARCHIVE "/get-replay.stat", zNewFmt("%" PRIu64 "\n7", timeMSec() - 100));
+        TEST_RESULT_VOID(archiveGetStatReplay(false), "record replay without sample");
+        archiveGetStatLoad(STRDEF(ARCHIVE_GET_STAT_REPLAY_FILE), stat, ARCHIVE_GET_STAT_REPLAY_TOTAL);
+        TEST_RESULT_UINT(stat[ARCHIVE_GET_STAT_REPLAY_INTERVAL], 7, "interval not sampled");
+
+        HRN_STORAGE_PUT_Z(storageSpoolWrite(), STORAGE_SPOOL_ARCHIVE "/get-replay.stat", "1\n7");
+        TEST_RESULT_VOID(archiveGetStatReplay(true), "record replay after pause");
+        archiveGetStatLoad(STRDEF(ARCHIVE_GET_STAT_REPLAY_FILE), stat, ARCHIVE_GET_STAT_REPLAY_TOTAL);
+        TEST_RESULT_UINT(stat[ARCHIVE_GET_STAT_REPLAY_INTERVAL], 7, "interval not sampled");
+        TEST_RESULT_BOOL(stat[ARCHIVE_GET_STAT_REPLAY_LAST] > 1, true, "last updated");
+
+        HRN_STORAGE_PUT_Z(
+            storageSpoolWrite(), STORAGE_SPOOL_ARCHIVE "/get-replay.stat", zNewFmt("%" PRIu64 "\n7", timeMSec() + 1000));
+        TEST_RESULT_VOID(archiveGetStatReplay(true), "record replay when clock moved backward");
+        archiveGetStatLoad(STRDEF(ARCHIVE_GET_STAT_REPLAY_FILE), stat, ARCHIVE_GET_STAT_REPLAY_TOTAL);
+        TEST_RESULT_UINT(stat[ARCHIVE_GET_STAT_REPLAY_INTERVAL], 7, "interval not sampled");
+
+        TEST_RESULT_VOID(storageRemoveP(storageSpoolWrite(), STRDEF(ARCHIVE_GET_STAT_REPLAY_FILE)), "remove stat");
+        TEST_RESULT_VOID(archiveGetStatReplay(true), "record first replay");
+        archiveGetStatLoad(STRDEF(ARCHIVE_GET_STAT_REPLAY_FILE), stat, ARCHIVE_GET_STAT_REPLAY_TOTAL);
+        TEST_RESULT_UINT(stat[ARCHIVE_GET_STAT_REPLAY_INTERVAL], 0, "no interval");
+
+        HRN_STORAGE_REMOVE(storageSpoolWrite(), ARCHIVE_GET_STAT_REPLAY_FILE, .errorOnMissing = true);
     }
 
     // *****************************************************************************************************************************
@@ -247,6 +370,24 @@ testRun(void)
         TEST_STORAGE_GET_EMPTY(storageSpoolWrite(), STORAGE_SPOOL_ARCHIVE_IN "/000000010000000100000001", .remove = true);
         TEST_STORAGE_LIST_EMPTY(storageSpool(), STORAGE_SPOOL_ARCHIVE_IN);
 
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("single segment records fetch latency when the queue is adaptive");
+
+        StringList *argListAdapt = strLstDup(argList);
+        hrnCfgArgRawBool(argListAdapt, cfgOptArchiveGetQueueAdapt, true);
+        HRN_CFG_LOAD(cfgCmdArchiveGet, argListAdapt, .role = cfgCmdRoleAsync);
+
+        TEST_RESULT_VOID(cmdArchiveGetAsync(), "archive async");
+
+        TEST_RESULT_LOG(
+            "P00   INFO: get 1 WAL file(s) from archive: 000000010000000100000001\n"
+            "P01 DETAIL: found 000000010000000100000001 in the repo1: 10-1 archive");
+
+        TEST_STORAGE_GET_EMPTY(storageSpoolWrite(), STORAGE_SPOOL_ARCHIVE_IN "/000000010000000100000001", .remove = true);
+        TEST_STORAGE_EXISTS(storageSpoolWrite(), STORAGE_SPOOL_ARCHIVE "/get-fetch.stat", .remove = true);
+
+        HRN_CFG_LOAD(cfgCmdArchiveGet, argList, .role = cfgCmdRoleAsync);
+
         // -------------------------------------------------------------------------------------------------------------------------
         TEST_TITLE("single segment with one invalid file");
 
@@ -735,6 +876,49 @@ testRun(void)
         TEST_STORAGE_LIST(storagePgWrite(), "pg_wal", "RECOVERYXLOG\n", .remove = true);
         TEST_STORAGE_LIST(storageSpoolWrite(), STORAGE_SPOOL_ARCHIVE_IN, "000000010000000100000002\n", .remove = true);
 
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("write WAL segments for success - adaptive queue full");
+
+        StringList *argListAdapt = strLstDup(argList);
+        hrnCfgArgRawBool(argListAdapt, cfgOptArchiveGetQueueAdapt, true);
+        HRN_CFG_LOAD(cfgCmdArchiveGet, argListAdapt, .exeBogus = true);
+
+        // Stats size the queue to four segments so two segments fill half the queue
+        HRN_STORAGE_PUT_Z(storageSpoolWrite(), STORAGE_SPOOL_ARCHIVE "/get-replay.stat", "1\n1000");
+        HRN_STORAGE_PUT_Z(storageSpoolWrite(), STORAGE_SPOOL_ARCHIVE "/get-fetch.stat", "1000");
+
+        HRN_STORAGE_PUT_Z(storageSpoolWrite(), STORAGE_SPOOL_ARCHIVE_IN "/000000010000000100000001", "SHOULD-BE-A-REAL-WAL-FILE");
+        HRN_STORAGE_PUT_Z(storageSpoolWrite(), STORAGE_SPOOL_ARCHIVE_IN "/000000010000000100000002", "SHOULD-BE-A-REAL-WAL-FILE");
+        HRN_STORAGE_PUT_Z(storageSpoolWrite(), STORAGE_SPOOL_ARCHIVE_IN "/000000010000000100000003", "SHOULD-BE-A-REAL-WAL-FILE");
+        HRN_STORAGE_PUT_Z(storageSpoolWrite(), STORAGE_SPOOL_ARCHIVE_IN "/000000010000000100000004", "SHOULD-BE-A-REAL-WAL-FILE");
+
+        TEST_RESULT_INT(cmdArchiveGet(), 0, "successful get");
+
+        TEST_RESULT_LOG("P00   INFO: found 000000010000000100000001 in the archive asynchronously");
+
+        TEST_STORAGE_LIST(storagePgWrite(), "pg_wal", "RECOVERYXLOG\n", .remove = true);
+        TEST_STORAGE_LIST(
+            storageSpoolWrite(), STORAGE_SPOOL_ARCHIVE_IN,
+            "000000010000000100000002\n000000010000000100000003\n000000010000000100000004\n", .remove = true);
+        TEST_STORAGE_EXISTS(storageSpoolWrite(), STORAGE_SPOOL_ARCHIVE "/get-replay.stat", .remove = true);
+        TEST_STORAGE_EXISTS(storageSpoolWrite(), STORAGE_SPOOL_ARCHIVE "/get-fetch.stat", .remove = true);
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("write WAL segment for success - recovery target reached");
+
+        argListAdapt = strLstDup(argList);
+        hrnCfgArgRawZ(argListAdapt, cfgOptArchiveGetQueueTarget, "1/0");
+        HRN_CFG_LOAD(cfgCmdArchiveGet, argListAdapt, .exeBogus = true);
+
+        HRN_STORAGE_PUT_Z(storageSpoolWrite(), STORAGE_SPOOL_ARCHIVE_IN "/000000010000000100000001", "SHOULD-BE-A-REAL-WAL-FILE");
+
+        TEST_RESULT_INT(cmdArchiveGet(), 0, "successful get");
+
+        TEST_RESULT_LOG("P00   INFO: found 000000010000000100000001 in the archive asynchronously");
+
+        TEST_STORAGE_LIST(storagePgWrite(), "pg_wal", "RECOVERYXLOG\n", .remove = true);
+        TEST_STORAGE_LIST_EMPTY(storageSpoolWrite(), STORAGE_SPOOL_ARCHIVE_IN);
+
         // -------------------------------------------------------------------------------------------------------------------------
         TEST_TITLE("unable to get lock");
 
@@ -1,12 +1,17 @@
 /***********************************************************************************************************************************
 Test Archive Push Command
 ***********************************************************************************************************************************/
+#include "common/compress/helper.h"
 #include "common/io/fdRead.h"
 #include "common/io/fdWrite.h"
 #include "common/time.h"
 #include "postgres/version.h"
 #include "storage/posix/storage.h"
 
+#ifdef HAVE_LIBZST
+#include "common/compress/zst/common.h"
+#endif
+
 #include "common/harnessConfig.h"
 #include "common/harnessFork.h"
 #include "common/harnessInfo.h"
@@ -642,6 +647,87 @@ testRun(void)
             .remove = true);
 
         HRN_STORAGE_MODE(storageTest, "repo2/archive/test/11-1");
+
+#ifdef HAVE_LIBZST
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("push with archive dictionary");
+
+        // Train a dictionary from records similar to the records in the WAL segment
+        Buffer *const sample = bufNew(0);
+
+        for (unsigned int recordIdx = 0; recordIdx < 16384; recordIdx++)
+        {
+            bufCat(
+                sample,
+                BUFSTR(
+                    strNewFmt(
+                        "INSERT rel 1663/%u block %u tuple {id: %u, name: 'name%u'};", 16384 + recordIdx % 7, recordIdx / 64,
+                        recordIdx * 31 % 1000, recordIdx % 13)));
+        }
+
+        Buffer *const dict = compressDictTrain(compressTypeZst, sample, 512);
+
+        walBuffer2 = bufNew(0);
+
+        for (unsigned int recordIdx = 0; recordIdx < 64; recordIdx++)
+            bufCat(walBuffer2, BUFSTR(strNewFmt("INSERT rel 1663/16384 block 7 tuple {id: %u, name: 'name3'};", recordIdx)));
+
+        HRN_PG_WAL_TO_BUFFER(walBuffer2, PG_VERSION_11);
+        walBuffer2Sha1 = strZ(strNewEncode(encodingHex, cryptoHashOne(hashTypeSha1, walBuffer2)));
+        HRN_STORAGE_PUT(storageTest, "pg/pg_wal/000000010000000100000004", walBuffer2, .comment = "write WAL");
+        HRN_STORAGE_PUT(storageTest, "pg/pg_wal/000000010000000100000005", walBuffer2, .comment = "write WAL");
+
+        argListTemp = strLstNew();
+        hrnCfgArgRawZ(argListTemp, cfgOptStanza, "test");
+        hrnCfgArgKeyRawZ(argListTemp, cfgOptPgPath, 1, TEST_PATH "/pg");
+        hrnCfgArgKeyRawZ(argListTemp, cfgOptRepoPath, 2, TEST_PATH "/repo2");
+        hrnCfgArgKeyRawStrId(argListTemp, cfgOptRepoCipherType, 2, cipherTypeAes256Cbc);
+        hrnCfgEnvKeyRawZ(cfgOptRepoCipherPass, 2, "badpassphrase");
+        hrnCfgArgKeyRawZ(argListTemp, cfgOptRepoPath, 3, TEST_PATH "/repo3");
+        hrnCfgArgRawZ(argListTemp, cfgOptCompressType, "zst");
+        hrnCfgArgRawBool(argListTemp, cfgOptArchiveDict, true);
+
+        StringList *argListDict = strLstDup(argListTemp);
+        strLstAddZ(argListDict, "pg_wal/000000010000000100000004");
+        HRN_CFG_LOAD(cfgCmdArchivePush, argListDict);
+
+        // Only repo3 has a dictionary so the dictionary is not used
+        archiveDictPut(1, STRDEF("11-1"), cipherTypeNone, NULL, dict);
+
+        TEST_RESULT_VOID(cmdArchivePush(), "push the WAL segment");
+        TEST_RESULT_LOG("P00   INFO: pushed WAL file '000000010000000100000004' to the archive");
+
+        StorageRead *read = storageNewReadP(
+            storageTest, STR(zNewFmt("repo3/archive/test/11-1/0000000100000001/000000010000000100000004-%s.zst", walBuffer2Sha1)));
+        ioFilterGroupAdd(ioReadFilterGroup(storageReadIo(read)), decompressFilterP(compressTypeZst));
+
+        TEST_RESULT_BOOL(bufEq(storageGetP(read), walBuffer2), true, "WAL compressed without dictionary");
+
+        // Both repos have the same dictionary so the dictionary is used
+        argListDict = strLstDup(argListTemp);
+        strLstAddZ(argListDict, "pg_wal/000000010000000100000005");
+        HRN_CFG_LOAD(cfgCmdArchivePush, argListDict);
+        hrnCfgEnvKeyRemoveRaw(cfgOptRepoCipherPass, 2);
+
+        archiveDictPut(0, STRDEF("11-1"), cipherTypeAes256Cbc, STRDEF("badsubpassphrase"), dict);
+
+        TEST_RESULT_VOID(cmdArchivePush(), "push the WAL segment");
+        TEST_RESULT_LOG("P00   INFO: pushed WAL file '000000010000000100000005' to the archive");
+
+        const String *const walFile = strNewFmt(
+            "repo3/archive/test/11-1/0000000100000001/000000010000000100000005-%s.zst", walBuffer2Sha1);
+
+        read = storageNewReadP(storageTest, walFile);
+        ioFilterGroupAdd(ioReadFilterGroup(storageReadIo(read)), decompressFilterP(compressTypeZst, .dict = dict));
+
+        TEST_RESULT_BOOL(bufEq(storageGetP(read), walBuffer2), true, "WAL compressed with dictionary");
+
+        read = storageNewReadP(storageTest, walFile);
+        ioFilterGroupAdd(ioReadFilterGroup(storageReadIo(read)), decompressFilterP(compressTypeZst));
+
+        TEST_ERROR_FMT(
+            storageGetP(read), FormatError, "zst frame requires dictionary %u but no dictionary was provided", zstDictId(dict));
+#endif // HAVE_LIBZST
     }
 
     // *****************************************************************************************************************************
@@ -969,9 +1055,156 @@ testRun(void)
             storageTest, zNewFmt("repo3/archive/test/9.4-1/0000000100000001/000000010000000100000003-%s", walBuffer3Sha1),
             .comment = "check repo3 for WAL 3 file");
 
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("linger after push and exit when no new WAL is ready");
+
+        HRN_STORAGE_REMOVE(storageSpoolWrite(), STORAGE_SPOOL_ARCHIVE_OUT "/000000010000000100000003.ok", .errorOnMissing = true);
+
+        argListTemp = strLstDup(argList);
+        hrnCfgArgRawZ(argListTemp, cfgOptArchivePushLinger, "1.2");
+        hrnCfgArgRawZ(argListTemp, cfgOptProtocolTimeout, "2");
+        HRN_CFG_LOAD(cfgCmdArchivePush, argListTemp, .role = cfgCmdRoleAsync);
+
+        TimeMSec lingerBegin = timeMSec();
+
+        TEST_RESULT_VOID(cmdArchivePushAsync(), "push WAL segment, linger, and keep processes alive");
+        TEST_RESULT_BOOL(timeMSec() - lingerBegin >= 1200, true, "check linger time");
+        TEST_RESULT_LOG(
+            "P00   INFO: push 1 WAL file(s) to archive: 000000010000000100000003\n"
+            "P01   WARN: WAL file '000000010000000100000003' already exists in the repo1 archive with the same checksum\n"
+            "            HINT: this is valid in some recovery scenarios but may also indicate a problem.\n"
+            "P01   WARN: WAL file '000000010000000100000003' already exists in the repo3 archive with the same checksum\n"
+            "            HINT: this is valid in some recovery scenarios but may also indicate a problem.\n"
+            "P01 DETAIL: pushed WAL file '000000010000000100000003' to the archive");
+
+        TEST_STORAGE_EXISTS(storageSpool(), STORAGE_SPOOL_ARCHIVE_OUT "/000000010000000100000003.ok", .comment = "check WAL 3 ok");
+
         // Remove the ready file to prevent WAL 3 from being considered for the next test
         HRN_STORAGE_REMOVE(storagePgWrite(), "pg_xlog/archive_status/000000010000000100000003.ready", .errorOnMissing = true);
 
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("push WAL that is ready while lingering to the archive id of a stanza-upgrade and keep processes alive");
+
+        // WAL is pushed on timeline 2 so the segments do not conflict with later tests
+        HRN_STORAGE_PUT(storagePgWrite(), "pg_xlog/000000020000000100000006", walBuffer3);
+        HRN_STORAGE_PUT(storagePgWrite(), "pg_xlog/000000020000000100000007", walBuffer3);
+        HRN_STORAGE_PUT_EMPTY(storagePgWrite(), "pg_xlog/archive_status/000000020000000100000006.ready");
+
+        // Protocol timeout is set so the noop keep-alive is sent to the local process several times while lingering
+        argListTemp = strLstDup(argList);
+        hrnCfgArgRawZ(argListTemp, cfgOptArchivePushLinger, "1.5");
+        hrnCfgArgRawZ(argListTemp, cfgOptProtocolTimeout, "0.4");
+        HRN_CFG_LOAD(cfgCmdArchivePush, argListTemp, .role = cfgCmdRoleAsync);
+
+        HRN_FORK_BEGIN()
+        {
+            HRN_FORK_CHILD_BEGIN()
+            {
+                // Upgrade the stanza and create the ready file for WAL 7 once WAL 6 has been pushed, i.e. while the async process
+                // is lingering
+                TEST_RESULT_BOOL(
+                    storageExistsP(
+                        storageSpool(), STRDEF(STORAGE_SPOOL_ARCHIVE_OUT "/000000020000000100000006.ok"), .timeout = 10000),
+                    true, "wait for WAL 6 to be pushed");
+
+                #define TEST_ARCHIVE_INFO_UPGRADE                                                                                  \
+                    "[db]\n"                                                                                                       \
+                    "db-id=2\n"                                                                                                    \
+                    "\n"                                                                                                           \
+                    "[db:history]\n"                                                                                               \
+                    "1={\"db-id\":" HRN_PG_SYSTEMID_94_Z ",\"db-version\":\"9.4\"}\n"                                              \
+                    "2={\"db-id\":" HRN_PG_SYSTEMID_94_Z ",\"db-version\":\"9.4\"}\n"
+
+                HRN_INFO_PUT(storageTest, "repo/archive/test/archive.info", TEST_ARCHIVE_INFO_UPGRADE);
+                HRN_INFO_PUT(storageTest, "repo3/archive/test/archive.info", TEST_ARCHIVE_INFO_UPGRADE);
+                HRN_STORAGE_PUT_EMPTY(storagePgWrite(), "pg_xlog/archive_status/000000020000000100000007.ready");
+            }
+            HRN_FORK_CHILD_END();
+
+            HRN_FORK_PARENT_BEGIN()
+            {
+                TEST_RESULT_VOID(cmdArchivePushAsync(), "push WAL 6, then push WAL 7 while lingering");
+            }
+            HRN_FORK_PARENT_END();
+        }
+        HRN_FORK_END();
+
+        TEST_RESULT_LOG(
+            "P00   INFO: push 1 WAL file(s) to archive: 000000020000000100000006\n"
+            "P01 DETAIL: pushed WAL file '000000020000000100000006' to the archive\n"
+            "P00   INFO: push 1 WAL file(s) to archive: 000000020000000100000007\n"
+            "P01 DETAIL: pushed WAL file '000000020000000100000007' to the archive");
+
+        TEST_STORAGE_EXISTS(storageSpool(), STORAGE_SPOOL_ARCHIVE_OUT "/000000020000000100000007.ok", .comment = "check WAL 7 ok");
+        TEST_STORAGE_EXISTS(
+            storageTest, zNewFmt("repo/archive/test/9.4-2/0000000200000001/000000020000000100000007-%s", walBuffer3Sha1),
+            .comment = "check repo1 for WAL 7 in upgraded archive id");
+        TEST_STORAGE_EXISTS(
+            storageTest, zNewFmt("repo3/archive/test/9.4-2/0000000200000001/000000020000000100000007-%s", walBuffer3Sha1),
+            .comment = "check repo3 for WAL 7 in upgraded archive id");
+        TEST_RESULT_VOID(archivePushAsyncKeepAlive(), "local process still answers noop");
+
+        // Restore the archive info so later tests push to the original archive id
+        #define TEST_ARCHIVE_INFO                                                                                                  \
+            "[db]\n"                                                                                                               \
+            "db-id=1\n"                                                                                                            \
+            "\n"                                                                                                                   \
+            "[db:history]\n"                                                                                                       \
+            "1={\"db-id\":" HRN_PG_SYSTEMID_94_Z ",\"db-version\":\"9.4\"}\n"
+
+        HRN_INFO_PUT(storageTest, "repo/archive/test/archive.info", TEST_ARCHIVE_INFO);
+        HRN_INFO_PUT(storageTest, "repo3/archive/test/archive.info", TEST_ARCHIVE_INFO);
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("stop lingering when the stop file is created");
+
+        HRN_STORAGE_PUT(storagePgWrite(), "pg_xlog/000000020000000100000008", walBuffer3);
+        HRN_STORAGE_PUT_EMPTY(storagePgWrite(), "pg_xlog/archive_status/000000020000000100000008.ready");
+
+        argListTemp = strLstDup(argList);
+        hrnCfgArgRawZ(argListTemp, cfgOptArchivePushLinger, "60");
+        HRN_CFG_LOAD(cfgCmdArchivePush, argListTemp, .role = cfgCmdRoleAsync);
+
+        lingerBegin = timeMSec();
+
+        HRN_FORK_BEGIN()
+        {
+            HRN_FORK_CHILD_BEGIN()
+            {
+                // Create the stop file once WAL 8 has been pushed
+                TEST_RESULT_BOOL(
+                    storageExistsP(
+                        storageSpool(), STRDEF(STORAGE_SPOOL_ARCHIVE_OUT "/000000020000000100000008.ok"), .timeout = 10000),
+                    true, "wait for WAL 8 to be pushed");
+
+                HRN_STORAGE_PUT_EMPTY(storagePosixNewP(HRN_PATH_STR, .write = true), strZ(lockStopFileName(STRDEF("test"))));
+            }
+            HRN_FORK_CHILD_END();
+
+            HRN_FORK_PARENT_BEGIN()
+            {
+                TEST_ERROR(cmdArchivePushAsync(), StopError, "stop file exists for stanza test");
+            }
+            HRN_FORK_PARENT_END();
+        }
+        HRN_FORK_END();
+
+        TEST_RESULT_BOOL(timeMSec() - lingerBegin < 60000, true, "check linger ended before linger time");
+        TEST_RESULT_LOG(
+            "P00   INFO: push 1 WAL file(s) to archive: 000000020000000100000008\n"
+            "P01 DETAIL: pushed WAL file '000000020000000100000008' to the archive");
+
+        TEST_STORAGE_GET(
+            storageSpoolWrite(), STORAGE_SPOOL_ARCHIVE_OUT "/global.error", "62\nstop file exists for stanza test", .remove = true,
+            .comment = "check global.error");
+
+        HRN_STORAGE_REMOVE(storagePosixNewP(HRN_PATH_STR, .write = true), strZ(lockStopFileName(STRDEF("test"))));
+
+        // Remove the ready files to prevent WAL 6-8 from being considered for the next test
+        HRN_STORAGE_REMOVE(storagePgWrite(), "pg_xlog/archive_status/000000020000000100000006.ready", .errorOnMissing = true);
+        HRN_STORAGE_REMOVE(storagePgWrite(), "pg_xlog/archive_status/000000020000000100000007.ready", .errorOnMissing = true);
+        HRN_STORAGE_REMOVE(storagePgWrite(), "pg_xlog/archive_status/000000020000000100000008.ready", .errorOnMissing = true);
+
         // Check that drop functionality works
         // -------------------------------------------------------------------------------------------------------------------------
         // Remove status files
@@ -1002,6 +1235,144 @@ testRun(void)
             "000000010000000100000002.ok\n",
             .comment = "check status files");
 
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("bundle consecutive WAL segments");
+
+        HRN_STORAGE_PATH_REMOVE(storageSpoolWrite(), STORAGE_SPOOL_ARCHIVE_OUT, .recurse = true);
+        HRN_STORAGE_PATH_CREATE(storageSpoolWrite(), STORAGE_SPOOL_ARCHIVE_OUT);
+        HRN_STORAGE_PATH_REMOVE(storagePgWrite(), "pg_xlog/archive_status", .recurse = true);
+        HRN_STORAGE_PATH_CREATE(storagePgWrite(), "pg_xlog/archive_status");
+
+        Buffer *walBuffer4 = bufNew((size_t)16 * 1024 * 1024);
+        bufUsedSet(walBuffer4, bufSize(walBuffer4));
+        memset(bufPtr(walBuffer4), 0x55, bufSize(walBuffer4));
+        HRN_PG_WAL_TO_BUFFER(walBuffer4, PG_VERSION_94);
+        const char *walBuffer4Sha1 = strZ(strNewEncode(encodingHex, cryptoHashOne(hashTypeSha1, walBuffer4)));
+
+        HRN_STORAGE_PUT(storagePgWrite(), "pg_xlog/000000010000000100000004", walBuffer4);
+        HRN_STORAGE_PUT(storagePgWrite(), "pg_xlog/000000010000000100000005", walBuffer4);
+        HRN_STORAGE_PUT_EMPTY(storagePgWrite(), "pg_xlog/archive_status/000000010000000100000004.ready");
+        HRN_STORAGE_PUT_EMPTY(storagePgWrite(), "pg_xlog/archive_status/000000010000000100000005.ready");
+
+        argListTemp = strLstDup(argList);
+        hrnCfgArgRawBool(argListTemp, cfgOptArchivePushBundle, true);
+        HRN_CFG_LOAD(cfgCmdArchivePush, argListTemp, .role = cfgCmdRoleAsync);
+
+        TEST_RESULT_VOID(cmdArchivePushAsync(), "push WAL segments in a bundle");
+        TEST_RESULT_LOG(
+            "P00   INFO: push 2 WAL file(s) to archive: 000000010000000100000004...000000010000000100000005\n"
+            "P01 DETAIL: pushed WAL file '000000010000000100000004' to the archive\n"
+            "P01 DETAIL: pushed WAL file '000000010000000100000005' to the archive");
+
+        TEST_STORAGE_LIST(
+            storageTest, "repo3/archive/test/9.4-1/0000000100000001",
+            zNewFmt(
+                "000000010000000100000001-%s\n"
+                "000000010000000100000002-%s\n"
+                "000000010000000100000003-%s\n"
+                "000000010000000100000004-000000010000000100000005.bundle\n",
+                walBuffer1Sha1, walBuffer2Sha1, walBuffer3Sha1),
+            .comment = "check repo3 for bundle");
+        TEST_STORAGE_EXISTS(
+            storageTest, "repo/archive/test/9.4-1/0000000100000001/000000010000000100000004-000000010000000100000005.bundle",
+            .comment = "check repo1 for bundle");
+
+        TEST_RESULT_STR(
+            walSegmentFind(walSegmentFindNew(storageRepoIdx(0), STRDEF("9.4-1"), true, 0), STRDEF("000000010000000100000005")),
+            strNewFmt("000000010000000100000005-%s", walBuffer4Sha1), "find bundled WAL segment");
+
+        TEST_STORAGE_LIST(
+            storageSpool(), STORAGE_SPOOL_ARCHIVE_OUT,
+            "000000010000000100000004.ok\n"
+            "000000010000000100000005.ok\n",
+            .comment = "check status files");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("bundle WAL segments that already exist");
+
+        HRN_STORAGE_PATH_REMOVE(storageSpoolWrite(), STORAGE_SPOOL_ARCHIVE_OUT, .recurse = true);
+        HRN_STORAGE_PATH_CREATE(storageSpoolWrite(), STORAGE_SPOOL_ARCHIVE_OUT);
+        HRN_STORAGE_PUT_EMPTY(storagePgWrite(), "pg_xlog/archive_status/000000010000000100000003.ready");
+
+        TEST_RESULT_VOID(cmdArchivePushAsync(), "push WAL segments in a bundle");
+        TEST_RESULT_LOG(
+            "P00   INFO: push 3 WAL file(s) to archive: 000000010000000100000003...000000010000000100000005\n"
+            "P01   WARN: WAL file '000000010000000100000003' already exists in the repo1 archive with the same checksum\n"
+            "            HINT: this is valid in some recovery scenarios but may also indicate a problem.\n"
+            "P01   WARN: WAL file '000000010000000100000004' already exists in the repo1 archive with the same checksum\n"
+            "            HINT: this is valid in some recovery scenarios but may also indicate a problem.\n"
+            "P01   WARN: WAL file '000000010000000100000005' already exists in the repo1 archive with the same checksum\n"
+            "            HINT: this is valid in some recovery scenarios but may also indicate a problem.\n"
+            "P01   WARN: WAL file '000000010000000100000003' already exists in the repo3 archive with the same checksum\n"
+            "            HINT: this is valid in some recovery scenarios but may also indicate a problem.\n"
+            "P01   WARN: WAL file '000000010000000100000004' already exists in the repo3 archive with the same checksum\n"
+            "            HINT: this is valid in some recovery scenarios but may also indicate a problem.\n"
+            "P01   WARN: WAL file '000000010000000100000005' already exists in the repo3 archive with the same checksum\n"
+            "            HINT: this is valid in some recovery scenarios but may also indicate a problem.\n"
+            "P01 DETAIL: pushed WAL file '000000010000000100000003' to the archive\n"
+            "P01 DETAIL: pushed WAL file '000000010000000100000004' to the archive\n"
+            "P01 DETAIL: pushed WAL file '000000010000000100000005' to the archive");
+
+        TEST_STORAGE_LIST(
+            storageTest, "repo3/archive/test/9.4-1/0000000100000001",
+            zNewFmt(
+                "000000010000000100000001-%s\n"
+                "000000010000000100000002-%s\n"
+                "000000010000000100000003-%s\n"
+                "000000010000000100000004-000000010000000100000005.bundle\n",
+                walBuffer1Sha1, walBuffer2Sha1, walBuffer3Sha1),
+            .comment = "no new bundle");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("bundle with an invalid WAL segment is pushed individually");
+
+        HRN_STORAGE_PATH_REMOVE(storageSpoolWrite(), STORAGE_SPOOL_ARCHIVE_OUT, .recurse = true);
+        HRN_STORAGE_PATH_CREATE(storageSpoolWrite(), STORAGE_SPOOL_ARCHIVE_OUT);
+        HRN_STORAGE_PATH_REMOVE(storagePgWrite(), "pg_xlog/archive_status", .recurse = true);
+        HRN_STORAGE_PATH_CREATE(storagePgWrite(), "pg_xlog/archive_status");
+
+        Buffer *walBufferInvalid = bufDup(walBuffer4);
+        HRN_PG_WAL_TO_BUFFER(walBufferInvalid, PG_VERSION_94, .systemId = 1);
+
+        HRN_STORAGE_PUT(storagePgWrite(), "pg_xlog/000000010000000100000006", walBuffer4);
+        HRN_STORAGE_PUT(storagePgWrite(), "pg_xlog/000000010000000100000007", walBufferInvalid);
+        HRN_STORAGE_PUT(storagePgWrite(), "pg_xlog/000000010000000100000008", walBuffer4);
+        HRN_STORAGE_PUT_EMPTY(storagePgWrite(), "pg_xlog/archive_status/000000010000000100000006.ready");
+        HRN_STORAGE_PUT_EMPTY(storagePgWrite(), "pg_xlog/archive_status/000000010000000100000007.ready");
+        HRN_STORAGE_PUT_EMPTY(storagePgWrite(), "pg_xlog/archive_status/000000010000000100000008.ready");
+
+        TEST_RESULT_VOID(cmdArchivePushAsync(), "push WAL segments individually");
+        TEST_RESULT_LOG(
+            "P00   INFO: push 3 WAL file(s) to archive: 000000010000000100000006...000000010000000100000008\n"
+            "P01   WARN: could not push WAL bundle '000000010000000100000006-000000010000000100000008.bundle' to the archive"
+            " (segments will be pushed individually): [44] raised from local-1 shim protocol: WAL file '" TEST_PATH "/pg/pg_xlog"
+            "/000000010000000100000007' version 9.4, system-id 10000000000000090401 do not match stanza version 9.4, system-id "
+            HRN_PG_SYSTEMID_94_Z "\n"
+            "P01 DETAIL: pushed WAL file '000000010000000100000006' to the archive\n"
+            "P01   WARN: could not push WAL file '000000010000000100000007' to the archive (will be retried): [44] raised from"
+            " local-1 shim protocol: WAL file '" TEST_PATH "/pg/pg_xlog/000000010000000100000007' version 9.4, system-id"
+            " 10000000000000090401 do not match stanza version 9.4, system-id " HRN_PG_SYSTEMID_94_Z "\n"
+            "P01 DETAIL: pushed WAL file '000000010000000100000008' to the archive");
+
+        TEST_STORAGE_LIST(
+            storageTest, "repo3/archive/test/9.4-1/0000000100000001",
+            zNewFmt(
+                "000000010000000100000001-%s\n"
+                "000000010000000100000002-%s\n"
+                "000000010000000100000003-%s\n"
+                "000000010000000100000004-000000010000000100000005.bundle\n"
+                "000000010000000100000006-%s\n"
+                "000000010000000100000008-%s\n",
+                walBuffer1Sha1, walBuffer2Sha1, walBuffer3Sha1, walBuffer4Sha1, walBuffer4Sha1),
+            .comment = "segments before and after the invalid segment are pushed");
+
+        TEST_STORAGE_LIST(
+            storageSpool(), STORAGE_SPOOL_ARCHIVE_OUT,
+            "000000010000000100000006.ok\n"
+            "000000010000000100000007.error\n"
+            "000000010000000100000008.ok\n",
+            .comment = "check status files");
+
         // Uninstall local command handler shim
         hrnProtocolLocalShimUninstall();
     }
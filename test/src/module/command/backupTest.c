@@ -4,6 +4,7 @@ Test Backup Command
 #include "command/stanza/create.h"
 #include "command/stanza/upgrade.h"
 #include "common/crypto/hash.h"
+#include "common/crypto/xxhash.h"
 #include "common/io/bufferRead.h"
 #include "common/io/bufferWrite.h"
 #include "postgres/interface/static.vendor.h"
@@ -69,10 +70,27 @@ testBackupValidateFile(
             THROW_FMT(AssertError, "'%s' repo checksum does match manifest", strZ(file.name));
     }
 
+    // Validate repo fast checksum
+    // -------------------------------------------------------------------------------------------------------------
+    if (file.checksumRepoFast != NULL)
+    {
+        StorageRead *read = storageNewReadP(
+            storage, strNewFmt("%s/%s", strZ(path), strZ(fileName)), .offset = file.bundleOffset,
+            .limit = VARUINT64(file.sizeRepo));
+
+        if (!bufEq(
+                xxHashOne(MANIFEST_CHECKSUM_FAST_SIZE, storageGetP(read)),
+                BUF(file.checksumRepoFast, MANIFEST_CHECKSUM_FAST_SIZE)))
+        {
+            THROW_FMT(AssertError, "'%s' repo fast checksum does match manifest", strZ(file.name));
+        }
+    }
+
     // Calculate checksum/size and decompress if needed
     // -------------------------------------------------------------------------------------------------------------
     uint64_t size = 0;
     const Buffer *checksum = NULL;
+    const Buffer *content = NULL;
 
     // If block incremental
     if (file.blockIncrMapSize != 0)
@@ -157,6 +175,7 @@ testBackupValidateFile(
         strCatFmt(result, ", m=%s}", strZ(mapLog));
 
         checksum = cryptoHashOne(hashTypeSha1, fileBuffer);
+        content = fileBuffer;
     }
     // Else normal file
     else
@@ -182,7 +201,8 @@ testBackupValidateFile(
 
         ioFilterGroupAdd(ioReadFilterGroup(storageReadIo(read)), cryptoHashNew(hashTypeSha1));
 
-        size = bufUsed(storageGetP(read));
+        content = storageGetP(read);
+        size = bufUsed(content);
         checksum = pckReadBinP(
             ioFilterGroupResultP(ioReadFilterGroup(storageReadIo(read)), CRYPTO_HASH_FILTER_TYPE));
     }
@@ -191,6 +211,15 @@ testBackupValidateFile(
     if (!bufEq(checksum, BUF(file.checksumSha1, HASH_TYPE_SHA1_SIZE)))
         THROW_FMT(AssertError, "'%s' checksum does match manifest", strZ(file.name));
 
+    // Validate fast checksum
+    if (file.checksumFast != NULL)
+    {
+        if (!bufEq(xxHashOne(MANIFEST_CHECKSUM_FAST_SIZE, content), BUF(file.checksumFast, MANIFEST_CHECKSUM_FAST_SIZE)))
+            THROW_FMT(AssertError, "'%s' fast checksum does match manifest", strZ(file.name));
+
+        strCatZ(result, file.checksumRepoFast != NULL ? ", fck=t, frck=t" : ", fck=t");
+    }
+
     // Test size and repo-size
     // -------------------------------------------------------------------------------------------------------------
     if (size != file.size)
@@ -280,6 +309,25 @@ testBackupValidateList(
             continue;
         }
 
+        // Output the size of the block index after checking that it can be read
+        if (info.type == storageTypeFile && strEqZ(info.name, BLOCK_INDEX_FILE))
+        {
+            StorageRead *const read = storageNewReadP(storage, strNewFmt("%s/%s", strZ(path), strZ(info.name)));
+            cipherBlockFilterGroupAdd(ioReadFilterGroup(storageReadIo(read)), cipherType, cipherModeDecrypt, cipherPass);
+            ioReadOpen(storageReadIo(read));
+
+            strCatFmt(result, "%s {i=%u}\n", strZ(info.name), blockIndexSize(blockIndexNewRead(storageReadIo(read))));
+            continue;
+        }
+
+        // Output only the name of the binary manifest. It is preferred when loading so the manifest being validated was loaded
+        // from it.
+        if (info.type == storageTypeFile && strEqZ(info.name, BACKUP_MANIFEST_FILE MANIFEST_BIN_EXT))
+        {
+            strCatFmt(result, "%s\n", strZ(info.name));
+            continue;
+        }
+
         switch (info.type)
         {
             case storageTypeFile:
@@ -1086,6 +1134,283 @@ testRun(void)
             "  super block {max: 2, size: 6}\n"
             "    block {no: 0, offset: 21}\n",
             "check delta");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("build explicit block map");
+
+        blockMap = blockMapNew();
+
+        blockMapItem = (BlockMapItem)
+        {
+            .reference = 1,
+            .bundleId = 2,
+            .superBlockSize = 6,
+            .offset = 10,
+            .size = 5,
+            .block = 1,
+            .checksum = {0xee, 0xee, 0x01, 0, 0, 0, 0xff, 0xff},
+        };
+
+        TEST_RESULT_VOID(blockMapAdd(blockMap, &blockMapItem), "add");
+
+        blockMapItem = (BlockMapItem)
+        {
+            .reference = 0,
+            .bundleId = 1,
+            .superBlockSize = 3,
+            .offset = 0,
+            .size = 3,
+            .block = 0,
+            .checksum = {0xee, 0xee, 0x02, 0, 0, 0, 0xff, 0xff},
+        };
+
+        TEST_RESULT_VOID(blockMapAdd(blockMap, &blockMapItem), "add");
+
+        blockMapItem = (BlockMapItem)
+        {
+            .reference = 1,
+            .bundleId = 2,
+            .superBlockSize = 6,
+            .offset = 10,
+            .size = 5,
+            .block = 0,
+            .checksum = {0xee, 0xee, 0x03, 0, 0, 0, 0xff, 0xff},
+        };
+
+        TEST_RESULT_VOID(blockMapAdd(blockMap, &blockMapItem), "add");
+
+        blockMapItem = (BlockMapItem)
+        {
+            .reference = 1,
+            .bundleId = 2,
+            .superBlockSize = 6,
+            .offset = 10,
+            .size = 5,
+            .block = 1,
+            .checksum = {0xee, 0xee, 0x01, 0, 0, 0, 0xff, 0xff},
+        };
+
+        TEST_RESULT_VOID(blockMapAdd(blockMap, &blockMapItem), "add duplicate");
+
+        blockMapItem = (BlockMapItem)
+        {
+            .reference = 1,
+            .bundleId = 3,
+            .superBlockSize = 3,
+            .offset = 7,
+            .size = 2,
+            .block = 0,
+            .checksum = {0xee, 0xee, 0x04, 0, 0, 0, 0xff, 0xff},
+        };
+
+        TEST_RESULT_VOID(blockMapAdd(blockMap, &blockMapItem), "add from another bundle");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("write explicit block map");
+
+        buffer = bufNew(256);
+        write = ioBufferWriteNewOpen(buffer);
+        TEST_RESULT_VOID(blockMapWrite(blockMap, write, 3, 8), "save");
+        ioWriteClose(write);
+
+        TEST_RESULT_STR_Z(
+            strNewEncode(encodingHex, buffer),
+            "01"                                        // Version 1
+            "05"                                        // block total 5
+
+            "00"                                        // new super block
+            "01020a0506"                                // reference 1, bundle 2, offset 10, size 5, super block size 6
+            "01"                                        // block 1
+            "eeee01000000ffff"                          // checksum
+
+            "00"                                        // new super block
+            "0001000303"                                // reference 0, bundle 1, offset 0, size 3, super block size 3
+            "00"                                        // block 0
+            "eeee02000000ffff"                          // checksum
+
+            "00"                                        // new super block
+            "01020a0506"                                // reference 1, bundle 2, offset 10, size 5, super block size 6
+            "00"                                        // block 0
+            "eeee03000000ffff"                          // checksum
+
+            "01"                                        // same super block
+            "01"                                        // block 1
+            "eeee01000000ffff"                          // checksum
+
+            "00"                                        // new super block
+            "0103070203"                                // reference 1, bundle 3, offset 7, size 2, super block size 3
+            "00"                                        // block 0
+            "eeee04000000ffff",                         // checksum
+            "compare");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("read explicit block map");
+
+        bufferCompare = bufNew(256);
+        write = ioBufferWriteNewOpen(bufferCompare);
+        TEST_RESULT_VOID(blockMapWrite(blockMapNewRead(ioBufferReadNewOpen(buffer), 3, 8), write, 3, 8), "read and save");
+        ioWriteClose(write);
+
+        TEST_RESULT_STR(strNewEncode(encodingHex, bufferCompare), strNewEncode(encodingHex, buffer), "compare");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("explicit block delta");
+
+        TEST_RESULT_STR_Z(
+            hrnBlockDeltaRender(blockMapNewRead(ioBufferReadNewOpen(buffer), 3, 8), 3, 8),
+            "read {reference: 1, bundleId: 2, offset: 10, size: 5}\n"
+            "  super block {max: 6, size: 5}\n"
+            "    block {no: 0, offset: 6}\n"
+            "    block {no: 1, offset: 0}\n"
+            "    block {no: 1, offset: 9}\n"
+            "read {reference: 1, bundleId: 3, offset: 7, size: 2}\n"
+            "  super block {max: 3, size: 2}\n"
+            "    block {no: 0, offset: 12}\n"
+            "read {reference: 0, bundleId: 1, offset: 0, size: 3}\n"
+            "  super block {max: 3, size: 3}\n"
+            "    block {no: 0, offset: 3}\n",
+            "check delta");
+    }
+
+    // *****************************************************************************************************************************
+    if (testBegin("BlockIndex"))
+    {
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("add and find blocks");
+
+        BlockIndex *blockIndex = blockIndexNew();
+
+        BlockMapItem blockMapItem =
+        {
+            .reference = 2,
+            .bundleId = 1,
+            .superBlockSize = 6,
+            .offset = 10,
+            .size = 5,
+            .block = 1,
+            .checksum = {0x01, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x0a},
+        };
+
+        TEST_RESULT_VOID(blockIndexAdd(blockIndex, 3, &blockMapItem), "add");
+
+        blockMapItem.reference = 1;
+        blockMapItem.block = 0;
+
+        TEST_RESULT_VOID(blockIndexAdd(blockIndex, 3, &blockMapItem), "add duplicate with lower reference");
+
+        blockMapItem.reference = 3;
+
+        TEST_RESULT_VOID(blockIndexAdd(blockIndex, 3, &blockMapItem), "add duplicate with higher reference");
+
+        blockMapItem.checksum[0] = 0x02;
+        blockMapItem.bundleId = 4;
+
+        TEST_RESULT_VOID(blockIndexAdd(blockIndex, 3, &blockMapItem), "add");
+        TEST_RESULT_VOID(blockIndexAdd(blockIndex, 6, &blockMapItem), "add with another block size");
+
+        const unsigned char checksumFind[XX_HASH_SIZE_MAX] = {0x01, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x0a};
+        const unsigned char checksumMissing[XX_HASH_SIZE_MAX] = {0x01, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x0b};
+
+        const BlockMapItem *blockMapItemFind = NULL;
+        TEST_ASSIGN(blockMapItemFind, blockIndexFind(blockIndex, 3, checksumFind), "find");
+        TEST_RESULT_UINT(blockMapItemFind->reference, 1, "check reference");
+        TEST_RESULT_UINT(blockMapItemFind->bundleId, 1, "check bundle id");
+        TEST_RESULT_UINT(blockMapItemFind->block, 0, "check block");
+        TEST_RESULT_UINT(blockIndexSize(blockIndex), 3, "duplicates removed");
+
+        TEST_RESULT_PTR(blockIndexFind(blockIndex, 3, checksumMissing), NULL, "missing checksum");
+        TEST_RESULT_PTR(blockIndexFind(blockIndex, 6, checksumFind), NULL, "missing block size");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("write block size");
+
+        Buffer *buffer = bufNew(256);
+        IoWrite *write = ioBufferWriteNewOpen(buffer);
+        TEST_RESULT_VOID(blockIndexWrite(blockIndex, write, 6), "write");
+        ioWriteClose(write);
+
+        TEST_RESULT_STR_Z(
+            strNewEncode(encodingHex, buffer),
+            "00"                                        // version 0
+            "00"                                        // sample level 0
+            "01"                                        // item total 1
+            "06"                                        // block size 6
+            "020000000000000000000000000000" "0a"       // checksum
+            "0304" "0a05" "0600",                       // reference 3, bundle 4, offset 10, size 5, super block size 6, block 0
+            "compare");
+
+        TEST_RESULT_UINT(blockIndexSize(blockIndexNewRead(ioBufferReadNewOpen(buffer))), 1, "read");
+
+        buffer = bufNew(256);
+        write = ioBufferWriteNewOpen(buffer);
+        TEST_RESULT_VOID(blockIndexWrite(blockIndex, write, 9), "write missing block size");
+        ioWriteClose(write);
+
+        TEST_RESULT_STR_Z(strNewEncode(encodingHex, buffer), "000000", "compare");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("write and read all");
+
+        buffer = bufNew(256);
+        write = ioBufferWriteNewOpen(buffer);
+        TEST_RESULT_VOID(blockIndexWrite(blockIndex, write, 0), "write");
+        ioWriteClose(write);
+
+        BlockIndex *blockIndexRead = blockIndexNew();
+        TEST_RESULT_VOID(blockIndexAddRead(blockIndexRead, ioBufferReadNewOpen(buffer)), "read");
+        TEST_RESULT_VOID(blockIndexAddRead(blockIndexRead, ioBufferReadNewOpen(buffer)), "read again");
+        TEST_RESULT_UINT(blockIndexSize(blockIndexRead), 6, "size before duplicates removed");
+
+        Buffer *bufferCompare = bufNew(256);
+        write = ioBufferWriteNewOpen(bufferCompare);
+        TEST_RESULT_VOID(blockIndexWrite(blockIndexRead, write, 0), "write");
+        ioWriteClose(write);
+
+        TEST_RESULT_STR(strNewEncode(encodingHex, bufferCompare), strNewEncode(encodingHex, buffer), "compare");
+
+        TEST_ERROR(
+            blockIndexNewRead(ioBufferReadNewOpen(BUFSTRDEF("\x01"))), FormatError, "block index version must be zero");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("sample when index is full");
+
+        blockIndex = blockIndexNew();
+        blockMapItem = (BlockMapItem){.bundleId = 1};
+
+        for (unsigned int itemIdx = 0; itemIdx <= BLOCK_INDEX_SIZE_MAX; itemIdx++)
+        {
+            blockMapItem.checksum[0] = (unsigned char)itemIdx;
+            blockMapItem.checksum[1] = (unsigned char)(itemIdx >> 8);
+
+            blockIndexAdd(blockIndex, 3, &blockMapItem);
+        }
+
+        TEST_RESULT_UINT(blockIndexSampleLevel(blockIndex), 1, "sample level");
+        TEST_RESULT_UINT(blockIndexSize(blockIndex), BLOCK_INDEX_SIZE_MAX / 2 + 1, "size");
+
+        blockMapItem.checksum[0] = 1;
+        blockMapItem.checksum[1] = 0;
+
+        TEST_RESULT_VOID(blockIndexAdd(blockIndex, 3, &blockMapItem), "add item not sampled");
+        TEST_RESULT_PTR(blockIndexFind(blockIndex, 3, blockMapItem.checksum), NULL, "item not sampled");
+
+        blockMapItem.checksum[0] = 2;
+
+        TEST_RESULT_PTR_NE(blockIndexFind(blockIndex, 3, blockMapItem.checksum), NULL, "item sampled");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("higher sample level is used when reading");
+
+        buffer = bufNew(0);
+        write = ioBufferWriteNewOpen(buffer);
+        TEST_RESULT_VOID(blockIndexWrite(blockIndex, write, 0), "write");
+        ioWriteClose(write);
+
+        TEST_RESULT_VOID(blockIndexAddRead(blockIndexRead, ioBufferReadNewOpen(buffer)), "read");
+        TEST_RESULT_UINT(blockIndexSampleLevel(blockIndexRead), 1, "sample level");
+        TEST_RESULT_PTR(blockIndexFind(blockIndexRead, 3, checksumFind), NULL, "item no longer sampled");
+
+        blockIndexFree(blockIndex);
     }
 
     // *****************************************************************************************************************************
@@ -1116,7 +1441,8 @@ testRun(void)
         IoWrite *write = ioBufferWriteNew(destination);
 
         TEST_RESULT_VOID(
-            ioFilterGroupAdd(ioWriteFilterGroup(write), blockIncrNew(3, 3, 6, 0, 0, 0, NULL, NULL, NULL)), "block incr");
+            ioFilterGroupAdd(ioWriteFilterGroup(write), blockIncrNew(3, 3, 6, 0, 0, 0, NULL, false, NULL, NULL, NULL)),
+            "block incr");
         TEST_RESULT_VOID(ioWriteOpen(write), "open");
         TEST_RESULT_VOID(ioWrite(write, source), "write");
         TEST_RESULT_VOID(ioWriteClose(write), "close");
@@ -1132,7 +1458,8 @@ testRun(void)
         write = ioBufferWriteNew(destination);
 
         TEST_RESULT_VOID(
-            ioFilterGroupAdd(ioWriteFilterGroup(write), blockIncrNew(3, 3, 8, 0, 0, 0, NULL, NULL, NULL)), "block incr");
+            ioFilterGroupAdd(ioWriteFilterGroup(write), blockIncrNew(3, 3, 8, 0, 0, 0, NULL, false, NULL, NULL, NULL)),
+            "block incr");
         TEST_RESULT_VOID(ioWriteOpen(write), "open");
         TEST_RESULT_VOID(ioWrite(write, source), "write");
         TEST_RESULT_VOID(ioWriteClose(write), "close");
@@ -1167,7 +1494,7 @@ testRun(void)
         TEST_RESULT_VOID(
             ioFilterGroupAdd(
                 ioWriteFilterGroup(write),
-                blockIncrNewPack(ioFilterParamList(blockIncrNew(2, 3, 8, 2, 4, 5, NULL, NULL, NULL)))),
+                blockIncrNewPack(ioFilterParamList(blockIncrNew(2, 3, 8, 2, 4, 5, NULL, false, NULL, NULL, NULL)))),
             "block incr");
         TEST_RESULT_VOID(ioWriteOpen(write), "open");
         TEST_RESULT_VOID(ioWrite(write, source), "write");
@@ -1209,7 +1536,8 @@ testRun(void)
             ioFilterGroupAdd(ioWriteFilterGroup(write), ioBufferNew()), "buffer to force internal buffer size");
         TEST_RESULT_VOID(
             ioFilterGroupAdd(
-                ioWriteFilterGroup(write), blockIncrNewPack(ioFilterParamList(blockIncrNew(3, 3, 8, 3, 0, 0, map, NULL, NULL)))),
+                ioWriteFilterGroup(write),
+                blockIncrNewPack(ioFilterParamList(blockIncrNew(3, 3, 8, 3, 0, 0, map, false, NULL, NULL, NULL)))),
             "block incr");
         TEST_RESULT_VOID(ioWriteOpen(write), "open");
         TEST_RESULT_VOID(ioWrite(write, source), "write");
@@ -1253,7 +1581,8 @@ testRun(void)
             ioFilterGroupAdd(ioWriteFilterGroup(write), ioBufferNew()), "buffer to force internal buffer size");
         TEST_RESULT_VOID(
             ioFilterGroupAdd(
-                ioWriteFilterGroup(write), blockIncrNewPack(ioFilterParamList(blockIncrNew(3, 3, 8, 3, 0, 0, map, NULL, NULL)))),
+                ioWriteFilterGroup(write),
+                blockIncrNewPack(ioFilterParamList(blockIncrNew(3, 3, 8, 3, 0, 0, map, false, NULL, NULL, NULL)))),
             "block incr");
         TEST_RESULT_VOID(ioWriteOpen(write), "open");
         TEST_RESULT_VOID(ioWrite(write, source), "write");
@@ -1276,7 +1605,8 @@ testRun(void)
             ioFilterGroupAdd(ioWriteFilterGroup(write), ioBufferNew()), "buffer to force internal buffer size");
         TEST_RESULT_VOID(
             ioFilterGroupAdd(
-                ioWriteFilterGroup(write), blockIncrNewPack(ioFilterParamList(blockIncrNew(6, 3, 8, 2, 4, 5, NULL, NULL, NULL)))),
+                ioWriteFilterGroup(write),
+                blockIncrNewPack(ioFilterParamList(blockIncrNew(6, 3, 8, 2, 4, 5, NULL, false, NULL, NULL, NULL)))),
             "block incr");
         TEST_RESULT_VOID(ioWriteOpen(write), "open");
         TEST_RESULT_VOID(ioWrite(write, source), "write");
@@ -1304,6 +1634,86 @@ testRun(void)
             "    block {no: 0, offset: 6}\n",
             "check delta");
 
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("full backup with duplicate blocks");
+
+        source = BUFSTRZ("ABCABCXYZABC12");
+        destination = bufNew(256);
+        write = ioBufferWriteNew(destination);
+
+        TEST_RESULT_VOID(
+            ioFilterGroupAdd(
+                ioWriteFilterGroup(write),
+                blockIncrNewPack(ioFilterParamList(blockIncrNew(6, 3, 8, 2, 4, 5, NULL, true, NULL, NULL, NULL)))),
+            "block incr");
+        TEST_RESULT_VOID(ioWriteOpen(write), "open");
+        TEST_RESULT_VOID(ioWrite(write, source), "write");
+        TEST_RESULT_VOID(ioWriteClose(write), "close");
+
+        PackRead *blockIncrResult = ioFilterGroupResultP(ioWriteFilterGroup(write), BLOCK_INCR_FILTER_TYPE);
+        TEST_ASSIGN(mapSize, pckReadU64P(blockIncrResult), "map size");
+
+        const Buffer *blockIndex = NULL;
+        TEST_ASSIGN(blockIndex, pckReadBinP(blockIncrResult), "block index");
+        TEST_RESULT_UINT(blockIndexSize(blockIndexNewRead(ioBufferReadNewOpen(blockIndex))), 2, "full blocks indexed");
+
+        TEST_RESULT_STR_Z(
+            strNewEncode(encodingHex, BUF(bufPtr(destination), bufUsed(destination) - (size_t)mapSize)),
+            "414243"                                    // super block 0 / block 0
+            "58595a"                                    // super block 0 / block 1
+            "3132",                                     // block 2
+            "block list");
+
+        map = BUF(bufPtr(destination) + (bufUsed(destination) - (size_t)mapSize), (size_t)mapSize);
+
+        TEST_RESULT_STR_Z(
+            hrnBlockDeltaRender(blockMapNewRead(ioBufferReadNewOpen(map), 3, 8), 3, 8),
+            "read {reference: 2, bundleId: 4, offset: 5, size: 8}\n"
+            "  super block {max: 6, size: 6}\n"
+            "    block {no: 0, offset: 0}\n"
+            "    block {no: 0, offset: 3}\n"
+            "    block {no: 0, offset: 9}\n"
+            "    block {no: 1, offset: 6}\n"
+            "  super block {max: 2, size: 2}\n"
+            "    block {no: 0, offset: 12}\n",
+            "check delta");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("diff/incr backup with blocks from the index");
+
+        source = BUFSTRZ("XYZABCABCABC12");
+        destination = bufNew(256);
+        write = ioBufferWriteNew(destination);
+
+        TEST_RESULT_VOID(
+            ioFilterGroupAdd(
+                ioWriteFilterGroup(write),
+                blockIncrNewPack(ioFilterParamList(blockIncrNew(6, 3, 8, 3, 6, 0, map, true, blockIndex, NULL, NULL)))),
+            "block incr");
+        TEST_RESULT_VOID(ioWriteOpen(write), "open");
+        TEST_RESULT_VOID(ioWrite(write, source), "write");
+        TEST_RESULT_VOID(ioWriteClose(write), "close");
+
+        blockIncrResult = ioFilterGroupResultP(ioWriteFilterGroup(write), BLOCK_INCR_FILTER_TYPE);
+        TEST_ASSIGN(mapSize, pckReadU64P(blockIncrResult), "map size");
+        TEST_RESULT_UINT(
+            blockIndexSize(blockIndexNewRead(ioBufferReadNewOpen(pckReadBinP(blockIncrResult)))), 0, "no new blocks indexed");
+        TEST_RESULT_UINT(bufUsed(destination), mapSize, "only map is stored");
+
+        map = BUF(bufPtr(destination) + (bufUsed(destination) - (size_t)mapSize), (size_t)mapSize);
+
+        TEST_RESULT_STR_Z(
+            hrnBlockDeltaRender(blockMapNewRead(ioBufferReadNewOpen(map), 3, 8), 3, 8),
+            "read {reference: 2, bundleId: 4, offset: 5, size: 8}\n"
+            "  super block {max: 6, size: 6}\n"
+            "    block {no: 0, offset: 3}\n"
+            "    block {no: 0, offset: 6}\n"
+            "    block {no: 0, offset: 9}\n"
+            "    block {no: 1, offset: 0}\n"
+            "  super block {max: 2, size: 2}\n"
+            "    block {no: 0, offset: 12}\n",
+            "check delta");
+
         // -------------------------------------------------------------------------------------------------------------------------
         TEST_TITLE("new filter from pack");
 
@@ -1311,7 +1721,7 @@ testRun(void)
             blockIncrNewPack(
                 ioFilterParamList(
                     blockIncrNew(
-                        3, 3, 8, 2, 4, 5, NULL, compressFilterP(compressTypeGz, 1, .raw = true),
+                        3, 3, 8, 2, 4, 5, NULL, false, NULL, compressFilterP(compressTypeGz, 1, .raw = true),
                         cipherBlockNewP(cipherModeEncrypt, cipherTypeAes256Cbc, BUFSTRDEF(TEST_CIPHER_PASS), .raw = true)))),
             "block incr pack");
     }
@@ -1814,6 +2224,60 @@ testRun(void)
         TEST_STORAGE_LIST_EMPTY(storageRepo(), STORAGE_REPO_BACKUP, .comment = "check backup path removed");
 
         manifestResume->pub.data.backupOptionCompressType = compressTypeNone;
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("resume with files replayed from manifest journal");
+
+        manifestSave(
+            manifestResume,
+            storageWriteIo(
+                storageNewWriteP(
+                    storageRepoWrite(), STRDEF(STORAGE_REPO_BACKUP "/20191003-105320F/" BACKUP_MANIFEST_FILE INFO_COPY_EXT))));
+
+        StringList *const fileJournal = strLstNew();
+        strLstAddZ(fileJournal, "pg_data/" PG_FILE_PGVERSION);
+
+        ManifestFile fileJournalUpdate = manifestFileFind(manifestResume, STRDEF("pg_data/" PG_FILE_PGVERSION));
+        fileJournalUpdate.size = 3;
+        fileJournalUpdate.sizeRepo = 3;
+        fileJournalUpdate.checksumSha1 = bufPtr(bufNewDecode(encodingHex, STRDEF("aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa")));
+        manifestFileUpdate(manifestResume, &fileJournalUpdate);
+
+        TEST_RESULT_VOID(backupManifestJournalSave(manifestResume, NULL, fileJournal, 0), "save first journal segment");
+
+        fileJournalUpdate = manifestFileFind(manifestResume, STRDEF("pg_data/" PG_FILE_PGVERSION));
+        fileJournalUpdate.size = 4;
+        fileJournalUpdate.sizeRepo = 24;
+        fileJournalUpdate.checksumSha1 = bufPtr(bufNewDecode(encodingHex, STRDEF("bbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbb")));
+        fileJournalUpdate.bundleId = 1;
+        fileJournalUpdate.bundleOffset = 8;
+        manifestFileUpdate(manifestResume, &fileJournalUpdate);
+
+        TEST_RESULT_VOID(backupManifestJournalSave(manifestResume, NULL, fileJournal, 1), "save second journal segment");
+        TEST_RESULT_VOID(
+            backupManifestJournalSave(manifestResume, NULL, strLstNew(), 2), "empty journal segment is not saved");
+        TEST_STORAGE_LIST(
+            storageRepo(), STORAGE_REPO_BACKUP "/20191003-105320F/" BACKUP_MANIFEST_JOURNAL_PATH, "00000000\n00000001\n");
+
+        const Manifest *manifestJournal = NULL;
+        TEST_ASSIGN(manifestJournal, backupResumeFind(manifest, NULL), "find resumable backup");
+
+        const ManifestFile fileJournalResult = manifestFileFind(manifestJournal, STRDEF("pg_data/" PG_FILE_PGVERSION));
+        TEST_RESULT_UINT(fileJournalResult.size, 4, "check size");
+        TEST_RESULT_UINT(fileJournalResult.sizeRepo, 24, "check repo size");
+        TEST_RESULT_STR_Z(
+            strNewEncode(encodingHex, BUF(fileJournalResult.checksumSha1, HASH_TYPE_SHA1_SIZE)),
+            "bbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbb", "check checksum");
+        TEST_RESULT_UINT(fileJournalResult.bundleId, 1, "check bundle id");
+        TEST_RESULT_UINT(fileJournalResult.bundleOffset, 8, "check bundle offset");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("manifest journal is removed when manifest copy is saved");
+
+        TEST_RESULT_VOID(backupManifestSaveCopy(manifestResume, NULL, false), "save manifest copy");
+        TEST_STORAGE_LIST(
+            storageRepo(), STORAGE_REPO_BACKUP "/20191003-105320F", BACKUP_MANIFEST_FILE INFO_COPY_EXT "\n",
+            .comment = "journal removed");
     }
 
     // *****************************************************************************************************************************
@@ -1832,7 +2296,8 @@ testRun(void)
 
         TEST_ERROR(
             backupJobResult(
-                (Manifest *)1, NULL, storageTest, strLstNew(), job, false, pgPageSize8, 0, NULL, &currentPercentComplete),
+                (Manifest *)1, NULL, storageTest, strLstNew(), strLstNew(), job, false, NULL, NULL, pgPageSize8, 0, NULL,
+                &currentPercentComplete),
             AssertError, "error message");
 
         // -------------------------------------------------------------------------------------------------------------------------
@@ -1867,12 +2332,71 @@ testRun(void)
 
         TEST_RESULT_VOID(
             backupJobResult(
-                manifest, STRDEF("host"), storageTest, strLstNew(), job, false, pgPageSize8, 0, &sizeProgress,
-                &currentPercentComplete),
+                manifest, STRDEF("host"), storageTest, strLstNew(), strLstNew(), job, false, NULL, NULL, pgPageSize8, 0,
+                &sizeProgress, &currentPercentComplete),
             "log noop result");
         TEST_RESULT_VOID(lockRelease(true), "release backup lock");
 
         TEST_RESULT_LOG("P00 DETAIL: match file from prior backup host:" TEST_PATH "/test (0B, 100.00%)");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("block index not sent without dedup");
+
+        BackupJobData jobDataNoDedup = {.blockIncrDedup = false};
+
+        PackWrite *param = pckWriteNewP();
+        TEST_RESULT_VOID(backupJobBlockIndex(&jobDataNoDedup, 0, param), "send");
+        pckWriteEndP(param);
+
+        PackRead *paramRead = pckReadNew(pckWriteResult(param));
+        TEST_RESULT_BOOL(pckReadBoolP(paramRead), false, "no reset");
+        TEST_RESULT_PTR(pckReadBinP(paramRead), NULL, "no update");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("full block index sent with first job and pending blocks with later jobs");
+
+        BlockMapItem blockMapItem = {.reference = 1, .bundleId = 1, .superBlockSize = 3, .size = 3, .checksum = {0x01}};
+
+        BackupJobData jobData =
+        {
+            .blockIncrDedup = true,
+            .blockIndex = blockIndexNew(),
+            .blockIndexPendingList = lstNewP(sizeof(BlockIndex *)),
+        };
+
+        blockIndexAdd(jobData.blockIndex, 3, &blockMapItem);
+
+        param = pckWriteNewP();
+        TEST_RESULT_VOID(backupJobBlockIndex(&jobData, 1, param), "send first job to process 2");
+        pckWriteEndP(param);
+
+        paramRead = pckReadNew(pckWriteResult(param));
+        TEST_RESULT_BOOL(pckReadBoolP(paramRead), true, "reset");
+        TEST_RESULT_UINT(blockIndexSize(blockIndexNewRead(ioBufferReadNewOpen(pckReadBinP(paramRead)))), 1, "full index");
+        TEST_RESULT_UINT(lstSize(jobData.blockIndexPendingList), 2, "pending list size");
+        TEST_RESULT_PTR(*(BlockIndex **)lstGet(jobData.blockIndexPendingList, 0), NULL, "process 1 has no jobs");
+
+        param = pckWriteNewP();
+        TEST_RESULT_VOID(backupJobBlockIndex(&jobData, 1, param), "send second job to process 2");
+        pckWriteEndP(param);
+
+        paramRead = pckReadNew(pckWriteResult(param));
+        TEST_RESULT_BOOL(pckReadBoolP(paramRead), false, "no reset");
+        TEST_RESULT_PTR(pckReadBinP(paramRead), NULL, "no pending blocks");
+
+        // Block stored by another process
+        blockMapItem.checksum[0] = 0x02;
+        blockIndexAdd(*(BlockIndex **)lstGet(jobData.blockIndexPendingList, 1), 3, &blockMapItem);
+
+        param = pckWriteNewP();
+        TEST_RESULT_VOID(backupJobBlockIndex(&jobData, 1, param), "send third job to process 2");
+        pckWriteEndP(param);
+
+        paramRead = pckReadNew(pckWriteResult(param));
+        TEST_RESULT_BOOL(pckReadBoolP(paramRead), false, "no reset");
+        TEST_RESULT_UINT(blockIndexSize(blockIndexNewRead(ioBufferReadNewOpen(pckReadBinP(paramRead)))), 1, "pending blocks");
+        TEST_RESULT_UINT(
+            blockIndexSize(*(BlockIndex **)lstGet(jobData.blockIndexPendingList, 1)), 0, "pending blocks cleared");
     }
 
     // Offline tests should only be used to test offline functionality and errors easily tested in offline mode
@@ -3760,6 +4284,7 @@ testRun(void)
             hrnCfgArgRawZ(argList, cfgOptRepoBlockAgeMap, "2=0");
             hrnCfgArgRawZ(argList, cfgOptRepoBlockChecksumSizeMap, "16KiB=16");
             hrnCfgArgRawZ(argList, cfgOptRepoBlockChecksumSizeMap, "8KiB=12");
+            hrnCfgArgRawBool(argList, cfgOptRepoBlockDedup, true);
             hrnCfgEnvRawZ(cfgOptRepoCipherPass, TEST_CIPHER_PASS);
             HRN_CFG_LOAD(cfgCmdBackup, argList);
 
@@ -3805,8 +4330,8 @@ testRun(void)
                 "P01 DETAIL: match file from prior backup " TEST_PATH "/pg1/PG_VERSION (2B, [PCT]) checksum [SHA1]\n"
                 "P01 DETAIL: backup file " TEST_PATH "/pg1/block-incr-grow (bundle 1/0, 48KB, [PCT]) checksum [SHA1]\n"
                 "P01 DETAIL: match file from prior backup " TEST_PATH "/pg1/block-incr-wayback (16KB, [PCT]) checksum [SHA1]\n"
-                "P01 DETAIL: backup file " TEST_PATH "/pg1/block-age-to-zero (bundle 1/128, 16KB, [PCT]) checksum [SHA1]\n"
-                "P01 DETAIL: backup file " TEST_PATH "/pg1/block-age-multiplier (bundle 1/184, 32KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/block-age-to-zero (bundle 1/144, 16KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/block-age-multiplier (bundle 1/200, 32KB, [PCT]) checksum [SHA1]\n"
                 "P01 DETAIL: backup file " TEST_PATH "/pg1/global/pg_control (bundle 1/312, 8KB, [PCT]) checksum [SHA1]\n"
                 "P00 DETAIL: reference pg_data/PG_VERSION to 20191108-080000F\n"
                 "P00 DETAIL: reference pg_data/block-incr-wayback to 20191108-080000F\n"
@@ -3822,9 +4347,10 @@ testRun(void)
                     storageRepo(), STRDEF(STORAGE_REPO_BACKUP "/latest"), .cipherType = cipherTypeAes256Cbc,
                     .cipherPass = TEST_CIPHER_PASS),
                 ".> {d=20191108-080000F_20191110-153320D}\n"
-                "bundle/1/pg_data/block-age-multiplier {s=32768, m=1:{0,1}, ts=-86400}\n"
+                "block.index {i=3}\n"
+                "bundle/1/pg_data/block-age-multiplier {s=32768, m=1:{0,0}, ts=-86400}\n"
                 "bundle/1/pg_data/block-age-to-zero {s=16384, ts=-172800}\n"
-                "bundle/1/pg_data/block-incr-grow {s=49152, m=0:{0,1},1:{0,1,2,3}, ts=-200000}\n"
+                "bundle/1/pg_data/block-incr-grow {s=49152, m=0:{0,1},1:{0,1,1,1}, ts=-200000}\n"
                 "bundle/1/pg_data/global/pg_control {s=8192}\n"
                 "pg_data/backup_label.gz {s=17, ts=+2}\n"
                 "20191108-080000F/bundle/1/pg_data/PG_VERSION {s=2, ts=-600000}\n"
@@ -3835,6 +4361,105 @@ testRun(void)
                 "compare file list");
         }
 
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("online 11 incr backup with block dedup from prior backup");
+
+        backupTimeStart = BACKUP_EPOCH + 3450000;
+
+        {
+            // Load options
+            StringList *argList = strLstNew();
+            hrnCfgArgRawZ(argList, cfgOptStanza, "test1");
+            hrnCfgArgRaw(argList, cfgOptRepoPath, repoPath);
+            hrnCfgArgRaw(argList, cfgOptPgPath, pg1Path);
+            hrnCfgArgRawZ(argList, cfgOptRepoRetentionFull, "1");
+            hrnCfgArgRawStrId(argList, cfgOptType, backupTypeIncr);
+            hrnCfgArgRawBool(argList, cfgOptRepoBundle, true);
+            hrnCfgArgRawZ(argList, cfgOptRepoBundleLimit, "4MiB");
+            hrnCfgArgRawBool(argList, cfgOptRepoBlock, true);
+            hrnCfgArgRawZ(argList, cfgOptRepoCipherType, "aes-256-cbc");
+            hrnCfgArgRawZ(argList, cfgOptRepoBlockAgeMap, "1=2");
+            hrnCfgArgRawZ(argList, cfgOptRepoBlockAgeMap, "2=0");
+            hrnCfgArgRawZ(argList, cfgOptRepoBlockChecksumSizeMap, "16KiB=16");
+            hrnCfgArgRawZ(argList, cfgOptRepoBlockChecksumSizeMap, "8KiB=12");
+            hrnCfgArgRawBool(argList, cfgOptRepoBlockDedup, true);
+            hrnCfgArgRawBool(argList, cfgOptManifestBinary, true);
+            hrnCfgEnvRawZ(cfgOptRepoCipherPass, TEST_CIPHER_PASS);
+            HRN_CFG_LOAD(cfgCmdBackup, argList);
+
+            // Copy of a file stored in the prior backup so all blocks can be found in the block index
+            Buffer *file = bufNew(BLOCK_MIN_FILE_SIZE * 3);
+            memset(bufPtr(file), 0, bufSize(file));
+            memset(bufPtr(file) + (BLOCK_MIN_SIZE * 2), 1, BLOCK_MIN_SIZE);
+            bufUsedSet(file, bufSize(file));
+
+            HRN_STORAGE_PUT(storagePgWrite(), "block-incr-copy", file, .timeModified = backupTimeStart);
+
+            // New files with the same blocks in a different order so blocks stored by the file backed up first (block-dedup-2) can
+            // be referenced by the file backed up second (block-dedup-1)
+            file = bufNew(BLOCK_MIN_FILE_SIZE);
+            memset(bufPtr(file), 2, BLOCK_MIN_SIZE);
+            memset(bufPtr(file) + BLOCK_MIN_SIZE, 3, BLOCK_MIN_SIZE);
+            bufUsedSet(file, bufSize(file));
+
+            HRN_STORAGE_PUT(storagePgWrite(), "block-dedup-2", file, .timeModified = backupTimeStart);
+
+            memset(bufPtr(file), 3, BLOCK_MIN_SIZE);
+            memset(bufPtr(file) + BLOCK_MIN_SIZE, 2, BLOCK_MIN_SIZE);
+
+            HRN_STORAGE_PUT(storagePgWrite(), "block-dedup-1", file, .timeModified = backupTimeStart);
+
+            // Run backup
+            hrnBackupPqScriptP(
+                PG_VERSION_11, backupTimeStart, .walCompressType = compressTypeNone, .cipherType = cipherTypeAes256Cbc,
+                .cipherPass = TEST_CIPHER_PASS, .walTotal = 2, .walSwitch = true);
+            TEST_RESULT_VOID(hrnCmdBackup(), "backup");
+
+            TEST_RESULT_LOG(
+                "P00   INFO: last backup label = 20191108-080000F_20191110-153320D, version = " PROJECT_VERSION "\n"
+                "P00   INFO: execute non-exclusive backup start: backup begins after the next regular checkpoint completes\n"
+                "P00   INFO: backup start archive = 0000000105DC8F1000000000, lsn = 5dc8f10/0\n"
+                "P00   INFO: check archive for segment 0000000105DC8F1000000000\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/global/pg_control (bundle 1/0, 8KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/block-incr-copy (bundle 1/120, 48KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/block-dedup-2 (bundle 1/224, 16KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/block-dedup-1 (bundle 1/336, 16KB, [PCT]) checksum [SHA1]\n"
+                "P00 DETAIL: reference pg_data/PG_VERSION to 20191108-080000F\n"
+                "P00 DETAIL: reference pg_data/block-age-multiplier to 20191108-080000F_20191110-153320D\n"
+                "P00 DETAIL: reference pg_data/block-age-to-zero to 20191108-080000F_20191110-153320D\n"
+                "P00 DETAIL: reference pg_data/block-incr-grow to 20191108-080000F_20191110-153320D\n"
+                "P00 DETAIL: reference pg_data/block-incr-wayback to 20191108-080000F\n"
+                "P00   INFO: execute non-exclusive backup stop and wait for all WAL segments to archive\n"
+                "P00   INFO: backup stop archive = 0000000105DC8F1000000001, lsn = 5dc8f10/300000\n"
+                "P00 DETAIL: wrote 'backup_label' file returned from backup stop function\n"
+                "P00   INFO: check archive for segment(s) 0000000105DC8F1000000000:0000000105DC8F1000000001\n"
+                "P00   INFO: new backup label = 20191108-080000F_20191111-052640I\n"
+                "P00   INFO: incr backup size = [SIZE], file total = 10");
+
+            TEST_RESULT_STR_Z(
+                testBackupValidateP(
+                    storageRepo(), STRDEF(STORAGE_REPO_BACKUP "/latest"), .cipherType = cipherTypeAes256Cbc,
+                    .cipherPass = TEST_CIPHER_PASS),
+                ".> {d=20191108-080000F_20191111-052640I}\n"
+                "backup.manifest.bin\n"
+                "block.index {i=5}\n"
+                "bundle/1/pg_data/block-dedup-1 {s=16384, m=2:{1,0}}\n"
+                "bundle/1/pg_data/block-dedup-2 {s=16384, m=2:{0,1}}\n"
+                "bundle/1/pg_data/block-incr-copy {s=49152, m=1:{1,1,0,1,1,1}}\n"
+                "bundle/1/pg_data/global/pg_control {s=8192}\n"
+                "pg_data/backup_label.gz {s=17, ts=+2}\n"
+                "20191108-080000F/bundle/1/pg_data/PG_VERSION {s=2, ts=-650000}\n"
+                "20191108-080000F_20191110-153320D/bundle/1/pg_data/block-age-multiplier {s=32768, m=1:{0,0}, ts=-136400}\n"
+                "20191108-080000F_20191110-153320D/bundle/1/pg_data/block-age-to-zero {s=16384, ts=-222800}\n"
+                "20191108-080000F_20191110-153320D/bundle/1/pg_data/block-incr-grow {s=49152, m=0:{0,1},1:{0,1,1,1},"
+                " ts=-250000}\n"
+                "20191108-080000F/pg_data/block-incr-wayback.pgbi {s=16384, m=0:{0,1}, ts=-222800}\n"
+                "--------\n"
+                "[backup:target]\n"
+                "pg_data={\"path\":\"" TEST_PATH "/pg1\",\"type\":\"path\"}\n",
+                "compare file list");
+        }
+
         // -------------------------------------------------------------------------------------------------------------------------
         TEST_TITLE("online 11 full backup with enc");
 
@@ -3922,6 +4547,317 @@ testRun(void)
                 "pg_data={\"path\":\"" TEST_PATH "/pg1\",\"type\":\"path\"}\n",
                 "compare file list");
         }
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("online 11 full backup with fast checksums");
+
+        backupTimeStart = BACKUP_EPOCH + 3600000;
+
+        {
+            // Load options
+            StringList *argList = strLstNew();
+            hrnCfgArgRawZ(argList, cfgOptStanza, "test1");
+            hrnCfgArgRaw(argList, cfgOptRepoPath, repoPath);
+            hrnCfgArgRaw(argList, cfgOptPgPath, pg1Path);
+            hrnCfgArgRawZ(argList, cfgOptRepoRetentionFull, "1");
+            hrnCfgArgRawStrId(argList, cfgOptType, backupTypeFull);
+            hrnCfgArgRawZ(argList, cfgOptCompressType, "gz");
+            hrnCfgArgRawBool(argList, cfgOptChecksumFast, true);
+            hrnCfgArgRawBool(argList, cfgOptChecksumPage, false);
+            hrnCfgArgRawZ(argList, cfgOptRepoCipherType, "aes-256-cbc");
+            hrnCfgEnvRawZ(cfgOptRepoCipherPass, TEST_CIPHER_PASS);
+            HRN_CFG_LOAD(cfgCmdBackup, argList);
+
+            HRN_STORAGE_PUT_Z(storagePgWrite(), "global/2", "CHANGE", .timeModified = backupTimeStart - 100000);
+
+            // Relations with valid page headers for delta-lsn. The page LSNs are equal to the start LSN of this backup.
+            Buffer *relation = bufNew(pgPageSize4 * 4);
+            memset(bufPtr(relation), 0, bufSize(relation));
+            bufUsedSet(relation, bufSize(relation));
+
+            for (unsigned int pageIdx = 0; pageIdx < 4; pageIdx++)
+            {
+                *(PageHeaderData *)(bufPtr(relation) + (pgPageSize4 * pageIdx)) = (PageHeaderData)
+                {
+                    .pd_lsn = {.xlogid = 0x5dcb3b0}, .pd_lower = 0x20, .pd_upper = 0x800, .pd_special = pgPageSize4,
+                    .pd_pagesize_version = pgPageSize4 | 4,
+                };
+            }
+
+            HRN_STORAGE_PUT(storagePgWrite(), "global/3", relation, .timeModified = backupTimeStart - 100000);
+            HRN_STORAGE_PUT(storagePgWrite(), "global/4", relation, .timeModified = backupTimeStart - 100000);
+
+            // Relation with a new page that has no LSN
+            memset(bufPtr(relation), 0, bufSize(relation));
+            HRN_STORAGE_PUT(storagePgWrite(), "global/5", relation, .timeModified = backupTimeStart - 100000);
+
+            // Run backup
+            hrnBackupPqScriptP(
+                PG_VERSION_11, backupTimeStart, .walCompressType = compressTypeNone, .cipherType = cipherTypeAes256Cbc,
+                .cipherPass = TEST_CIPHER_PASS, .walTotal = 2, .walSwitch = true);
+            TEST_RESULT_VOID(hrnCmdBackup(), "backup");
+
+            TEST_RESULT_LOG(
+                "P00   INFO: execute non-exclusive backup start: backup begins after the next regular checkpoint completes\n"
+                "P00   INFO: backup start archive = 0000000105DCB3B000000000, lsn = 5dcb3b0/0\n"
+                "P00   INFO: check archive for segment 0000000105DCB3B000000000\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/global/5 (16KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/global/4 (16KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/global/3 (16KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/global/1 (16KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/global/pg_control (8KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/global/2 (6B, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/PG_VERSION (2B, [PCT]) checksum [SHA1]\n"
+                "P00   INFO: execute non-exclusive backup stop and wait for all WAL segments to archive\n"
+                "P00   INFO: backup stop archive = 0000000105DCB3B000000001, lsn = 5dcb3b0/300000\n"
+                "P00 DETAIL: wrote 'backup_label' file returned from backup stop function\n"
+                "P00   INFO: check archive for segment(s) 0000000105DCB3B000000000:0000000105DCB3B000000001\n"
+                "P00   INFO: new backup label = 20191112-230640F\n"
+                "P00   INFO: full backup size = [SIZE], file total = 8");
+
+            TEST_RESULT_STR_Z(
+                testBackupValidateP(
+                    storageRepo(), STRDEF(STORAGE_REPO_BACKUP "/latest"), .cipherType = cipherTypeAes256Cbc,
+                    .cipherPass = TEST_CIPHER_PASS),
+                ".> {d=20191112-230640F}\n"
+                "pg_data/PG_VERSION.gz {s=2, fck=t, frck=t, ts=-100000}\n"
+                "pg_data/backup_label.gz {s=17, ts=+2}\n"
+                "pg_data/global/1.gz {s=16384, fck=t, frck=t, ts=-99999}\n"
+                "pg_data/global/2.gz {s=6, fck=t, frck=t, ts=-100000}\n"
+                "pg_data/global/3.gz {s=16384, fck=t, frck=t, ts=-100000}\n"
+                "pg_data/global/4.gz {s=16384, fck=t, frck=t, ts=-100000}\n"
+                "pg_data/global/5.gz {s=16384, fck=t, frck=t, ts=-100000}\n"
+                "pg_data/global/pg_control.gz {s=8192, fck=t, frck=t}\n"
+                "--------\n"
+                "[backup:target]\n"
+                "pg_data={\"path\":\"" TEST_PATH "/pg1\",\"type\":\"path\"}\n",
+                "compare file list");
+        }
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("online 11 diff delta backup with fast checksums");
+
+        backupTimeStart = BACKUP_EPOCH + 3700000;
+
+        {
+            // Load options
+            StringList *argList = strLstNew();
+            hrnCfgArgRawZ(argList, cfgOptStanza, "test1");
+            hrnCfgArgRaw(argList, cfgOptRepoPath, repoPath);
+            hrnCfgArgRaw(argList, cfgOptPgPath, pg1Path);
+            hrnCfgArgRawZ(argList, cfgOptRepoRetentionFull, "1");
+            hrnCfgArgRawStrId(argList, cfgOptType, backupTypeDiff);
+            hrnCfgArgRawZ(argList, cfgOptCompressType, "gz");
+            hrnCfgArgRawBool(argList, cfgOptChecksumFast, true);
+            hrnCfgArgRawBool(argList, cfgOptChecksumPage, false);
+            hrnCfgArgRawZ(argList, cfgOptRepoCipherType, "aes-256-cbc");
+            hrnCfgEnvRawZ(cfgOptRepoCipherPass, TEST_CIPHER_PASS);
+            hrnCfgArgRawBool(argList, cfgOptDelta, true);
+            HRN_CFG_LOAD(cfgCmdBackup, argList);
+
+            // Change contents without changing size or timestamp so only the checksum can detect the change
+            HRN_STORAGE_PUT_Z(storagePgWrite(), "global/2", "CHANGD", .timeModified = backupTimeStart - 200000);
+
+            // Run backup
+            hrnBackupPqScriptP(
+                PG_VERSION_11, backupTimeStart, .walCompressType = compressTypeNone, .cipherType = cipherTypeAes256Cbc,
+                .cipherPass = TEST_CIPHER_PASS, .walTotal = 2, .walSwitch = true);
+            TEST_RESULT_VOID(hrnCmdBackup(), "backup");
+
+            TEST_RESULT_LOG(
+                "P00   INFO: last backup label = 20191112-230640F, version = " PROJECT_VERSION "\n"
+                "P00   INFO: execute non-exclusive backup start: backup begins after the next regular checkpoint completes\n"
+                "P00   INFO: backup start archive = 0000000105DCCC1000000000, lsn = 5dccc10/0\n"
+                "P00   INFO: check archive for segment 0000000105DCCC1000000000\n"
+                "P01 DETAIL: match file from prior backup " TEST_PATH "/pg1/global/5 (16KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: match file from prior backup " TEST_PATH "/pg1/global/4 (16KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: match file from prior backup " TEST_PATH "/pg1/global/3 (16KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: match file from prior backup " TEST_PATH "/pg1/global/1 (16KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/global/pg_control (8KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/global/2 (6B, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: match file from prior backup " TEST_PATH "/pg1/PG_VERSION (2B, [PCT]) checksum [SHA1]\n"
+                "P00 DETAIL: reference pg_data/PG_VERSION to 20191112-230640F\n"
+                "P00 DETAIL: reference pg_data/global/1 to 20191112-230640F\n"
+                "P00 DETAIL: reference pg_data/global/3 to 20191112-230640F\n"
+                "P00 DETAIL: reference pg_data/global/4 to 20191112-230640F\n"
+                "P00 DETAIL: reference pg_data/global/5 to 20191112-230640F\n"
+                "P00   INFO: execute non-exclusive backup stop and wait for all WAL segments to archive\n"
+                "P00   INFO: backup stop archive = 0000000105DCCC1000000001, lsn = 5dccc10/300000\n"
+                "P00 DETAIL: wrote 'backup_label' file returned from backup stop function\n"
+                "P00   INFO: check archive for segment(s) 0000000105DCCC1000000000:0000000105DCCC1000000001\n"
+                "P00   INFO: new backup label = 20191112-230640F_20191114-025320D\n"
+                "P00   INFO: diff backup size = [SIZE], file total = 8");
+
+            TEST_RESULT_STR_Z(
+                testBackupValidateP(
+                    storageRepo(), STRDEF(STORAGE_REPO_BACKUP "/latest"), .cipherType = cipherTypeAes256Cbc,
+                    .cipherPass = TEST_CIPHER_PASS),
+                ".> {d=20191112-230640F_20191114-025320D}\n"
+                "pg_data/backup_label.gz {s=17, ts=+2}\n"
+                "pg_data/global/2.gz {s=6, fck=t, frck=t, ts=-200000}\n"
+                "pg_data/global/pg_control.gz {s=8192, fck=t, frck=t}\n"
+                "20191112-230640F/pg_data/PG_VERSION.gz {s=2, fck=t, frck=t, ts=-200000}\n"
+                "20191112-230640F/pg_data/global/1.gz {s=16384, fck=t, frck=t, ts=-199999}\n"
+                "20191112-230640F/pg_data/global/3.gz {s=16384, fck=t, frck=t, ts=-200000}\n"
+                "20191112-230640F/pg_data/global/4.gz {s=16384, fck=t, frck=t, ts=-200000}\n"
+                "20191112-230640F/pg_data/global/5.gz {s=16384, fck=t, frck=t, ts=-200000}\n"
+                "--------\n"
+                "[backup:target]\n"
+                "pg_data={\"path\":\"" TEST_PATH "/pg1\",\"type\":\"path\"}\n",
+                "compare file list");
+        }
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("online 11 diff delta backup with page LSNs");
+
+        backupTimeStart = BACKUP_EPOCH + 3800000;
+
+        {
+            // Load options
+            StringList *argList = strLstNew();
+            hrnCfgArgRawZ(argList, cfgOptStanza, "test1");
+            hrnCfgArgRaw(argList, cfgOptRepoPath, repoPath);
+            hrnCfgArgRaw(argList, cfgOptPgPath, pg1Path);
+            hrnCfgArgRawZ(argList, cfgOptRepoRetentionFull, "1");
+            hrnCfgArgRawStrId(argList, cfgOptType, backupTypeDiff);
+            hrnCfgArgRawZ(argList, cfgOptCompressType, "gz");
+            hrnCfgArgRawBool(argList, cfgOptChecksumPage, false);
+            hrnCfgArgRawZ(argList, cfgOptRepoCipherType, "aes-256-cbc");
+            hrnCfgEnvRawZ(cfgOptRepoCipherPass, TEST_CIPHER_PASS);
+            hrnCfgArgRawBool(argList, cfgOptDelta, true);
+            hrnCfgArgRawBool(argList, cfgOptDeltaLsn, true);
+            HRN_CFG_LOAD(cfgCmdBackup, argList);
+
+            // Change data without changing page LSNs, size, or timestamp so only page LSNs are used to determine that the file
+            // has not changed. This cannot happen in a real cluster but shows that the file is not checksummed.
+            Buffer *relation = storageGetP(storageNewReadP(storagePg(), STRDEF("global/3")));
+            bufPtr(relation)[pgPageSize4 + 0x800] = 0xFF;
+            HRN_STORAGE_PUT(storagePgWrite(), "global/3", relation, .timeModified = backupTimeStart - 300000);
+
+            // Advance the LSN of the last page so the file is copied
+            relation = storageGetP(storageNewReadP(storagePg(), STRDEF("global/4")));
+            ((PageHeaderData *)(bufPtr(relation) + pgPageSize4 * 3))->pd_lsn.xrecoff = 1;
+            HRN_STORAGE_PUT(storagePgWrite(), "global/4", relation, .timeModified = backupTimeStart - 300000);
+
+            // Run backup
+            hrnBackupPqScriptP(
+                PG_VERSION_11, backupTimeStart, .walCompressType = compressTypeNone, .cipherType = cipherTypeAes256Cbc,
+                .cipherPass = TEST_CIPHER_PASS, .walTotal = 2, .walSwitch = true);
+            TEST_RESULT_VOID(hrnCmdBackup(), "backup");
+
+            TEST_RESULT_LOG(
+                "P00   INFO: last backup label = 20191112-230640F, version = " PROJECT_VERSION "\n"
+                "P00   INFO: execute non-exclusive backup start: backup begins after the next regular checkpoint completes\n"
+                "P00   INFO: backup start archive = 0000000105DCE48000000000, lsn = 5dce480/0\n"
+                "P00   INFO: check archive for segment 0000000105DCE48000000000\n"
+                "P01 DETAIL: match file from prior backup " TEST_PATH "/pg1/global/5 (16KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/global/4 (16KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: match file from prior backup " TEST_PATH "/pg1/global/3 (16KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: match file from prior backup " TEST_PATH "/pg1/global/1 (16KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/global/pg_control (8KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/global/2 (6B, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: match file from prior backup " TEST_PATH "/pg1/PG_VERSION (2B, [PCT]) checksum [SHA1]\n"
+                "P00 DETAIL: reference pg_data/PG_VERSION to 20191112-230640F\n"
+                "P00 DETAIL: reference pg_data/global/1 to 20191112-230640F\n"
+                "P00 DETAIL: reference pg_data/global/3 to 20191112-230640F\n"
+                "P00 DETAIL: reference pg_data/global/5 to 20191112-230640F\n"
+                "P00   INFO: execute non-exclusive backup stop and wait for all WAL segments to archive\n"
+                "P00   INFO: backup stop archive = 0000000105DCE48000000001, lsn = 5dce480/300000\n"
+                "P00 DETAIL: wrote 'backup_label' file returned from backup stop function\n"
+                "P00   INFO: check archive for segment(s) 0000000105DCE48000000000:0000000105DCE48000000001\n"
+                "P00   INFO: new backup label = 20191112-230640F_20191115-064000D\n"
+                "P00   INFO: diff backup size = [SIZE], file total = 8");
+
+            TEST_RESULT_STR_Z(
+                testBackupValidateP(
+                    storageRepo(), STRDEF(STORAGE_REPO_BACKUP "/latest"), .cipherType = cipherTypeAes256Cbc,
+                    .cipherPass = TEST_CIPHER_PASS),
+                ".> {d=20191112-230640F_20191115-064000D}\n"
+                "pg_data/backup_label.gz {s=17, ts=+2}\n"
+                "pg_data/global/2.gz {s=6, ts=-300000}\n"
+                "pg_data/global/4.gz {s=16384, ts=-300000}\n"
+                "pg_data/global/pg_control.gz {s=8192}\n"
+                "20191112-230640F/pg_data/PG_VERSION.gz {s=2, fck=t, frck=t, ts=-300000}\n"
+                "20191112-230640F/pg_data/global/1.gz {s=16384, fck=t, frck=t, ts=-299999}\n"
+                "20191112-230640F/pg_data/global/3.gz {s=16384, fck=t, frck=t, ts=-300000}\n"
+                "20191112-230640F/pg_data/global/5.gz {s=16384, fck=t, frck=t, ts=-300000}\n"
+                "--------\n"
+                "[backup:target]\n"
+                "pg_data={\"path\":\"" TEST_PATH "/pg1\",\"type\":\"path\"}\n",
+                "compare file list");
+        }
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("online 11 diff delta backup with page LSNs after timeline switch");
+
+        backupTimeStart = BACKUP_EPOCH + 3900000;
+
+        {
+            // Load options
+            StringList *argList = strLstNew();
+            hrnCfgArgRawZ(argList, cfgOptStanza, "test1");
+            hrnCfgArgRaw(argList, cfgOptRepoPath, repoPath);
+            hrnCfgArgRaw(argList, cfgOptPgPath, pg1Path);
+            hrnCfgArgRawZ(argList, cfgOptRepoRetentionFull, "1");
+            hrnCfgArgRawStrId(argList, cfgOptType, backupTypeDiff);
+            hrnCfgArgRawZ(argList, cfgOptCompressType, "gz");
+            hrnCfgArgRawBool(argList, cfgOptChecksumPage, false);
+            hrnCfgArgRawZ(argList, cfgOptRepoCipherType, "aes-256-cbc");
+            hrnCfgEnvRawZ(cfgOptRepoCipherPass, TEST_CIPHER_PASS);
+            hrnCfgArgRawBool(argList, cfgOptDelta, true);
+            hrnCfgArgRawBool(argList, cfgOptDeltaLsn, true);
+            HRN_CFG_LOAD(cfgCmdBackup, argList);
+
+            // The contents of global/3 differ from the full backup but no page LSN is newer than the full backup start LSN. This is
+            // what happens when pages are rewritten after a PITR to a point before the full backup, so the file must be
+            // checksummed.
+            hrnBackupPqScriptP(
+                PG_VERSION_11, backupTimeStart, .timeline = 2, .walCompressType = compressTypeNone,
+                .cipherType = cipherTypeAes256Cbc, .cipherPass = TEST_CIPHER_PASS, .walTotal = 2, .walSwitch = true);
+            TEST_RESULT_VOID(hrnCmdBackup(), "backup");
+
+            TEST_RESULT_LOG(
+                "P00   INFO: last backup label = 20191112-230640F, version = " PROJECT_VERSION "\n"
+                "P00   INFO: execute non-exclusive backup start: backup begins after the next regular checkpoint completes\n"
+                "P00   INFO: backup start archive = 0000000205DCFCE000000000, lsn = 5dcfce0/0\n"
+                "P00   INFO: check archive for segment 0000000205DCFCE000000000\n"
+                "P00   WARN: a timeline switch has occurred since the 20191112-230640F backup, enabling delta checksum\n"
+                "            HINT: this is normal after restoring from backup or promoting a standby.\n"
+                "P01 DETAIL: match file from prior backup " TEST_PATH "/pg1/global/5 (16KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/global/4 (16KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/global/3 (16KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: match file from prior backup " TEST_PATH "/pg1/global/1 (16KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/global/pg_control (8KB, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: backup file " TEST_PATH "/pg1/global/2 (6B, [PCT]) checksum [SHA1]\n"
+                "P01 DETAIL: match file from prior backup " TEST_PATH "/pg1/PG_VERSION (2B, [PCT]) checksum [SHA1]\n"
+                "P00 DETAIL: reference pg_data/PG_VERSION to 20191112-230640F\n"
+                "P00 DETAIL: reference pg_data/global/1 to 20191112-230640F\n"
+                "P00 DETAIL: reference pg_data/global/5 to 20191112-230640F\n"
+                "P00   INFO: execute non-exclusive backup stop and wait for all WAL segments to archive\n"
+                "P00   INFO: backup stop archive = 0000000205DCFCE000000001, lsn = 5dcfce0/300000\n"
+                "P00 DETAIL: wrote 'backup_label' file returned from backup stop function\n"
+                "P00   INFO: check archive for segment(s) 0000000205DCFCE000000000:0000000205DCFCE000000001\n"
+                "P00   INFO: new backup label = 20191112-230640F_20191116-102640D\n"
+                "P00   INFO: diff backup size = [SIZE], file total = 8");
+
+            TEST_RESULT_STR_Z(
+                testBackupValidateP(
+                    storageRepo(), STRDEF(STORAGE_REPO_BACKUP "/latest"), .cipherType = cipherTypeAes256Cbc,
+                    .cipherPass = TEST_CIPHER_PASS),
+                ".> {d=20191112-230640F_20191116-102640D}\n"
+                "pg_data/backup_label.gz {s=17, ts=+2}\n"
+                "pg_data/global/2.gz {s=6, ts=-400000}\n"
+                "pg_data/global/3.gz {s=16384, ts=-400000}\n"
+                "pg_data/global/4.gz {s=16384, ts=-400000}\n"
+                "pg_data/global/pg_control.gz {s=8192}\n"
+                "20191112-230640F/pg_data/PG_VERSION.gz {s=2, fck=t, frck=t, ts=-400000}\n"
+                "20191112-230640F/pg_data/global/1.gz {s=16384, fck=t, frck=t, ts=-399999}\n"
+                "20191112-230640F/pg_data/global/5.gz {s=16384, fck=t, frck=t, ts=-400000}\n"
+                "--------\n"
+                "[backup:target]\n"
+                "pg_data={\"path\":\"" TEST_PATH "/pg1\",\"type\":\"path\"}\n",
+                "compare file list");
+        }
     }
 
     FUNCTION_HARNESS_RETURN_VOID();
@@ -247,10 +247,13 @@ testRun(void)
             "  --delta                             restore or backup using checksums\n"
             "                                      [default=n]\n"
             "  --fork                              postgreSQL fork name [default=PostgreSQL]\n"
+            "  --io-thread                         run filters on worker threads [default=n]\n"
             "  --io-timeout                        I/O timeout [default=60]\n"
             "  --lock-path                         path where lock files are stored\n"
             "                                      [default=/tmp/pgbackrest]\n"
             "  --neutral-umask                     use a neutral umask [default=y]\n"
+            "  --process-job-max                   max jobs in progress for each process\n"
+            "                                      [default=1]\n"
             "  --process-max                       max processes to use for\n"
             "                                      compress/transfer [default=1]\n"
             "  --protocol-timeout                  protocol timeout [default=1830]\n"
@@ -339,6 +342,10 @@ testRun(void)
             "  --repo-sftp-public-key-file         SFTP public key file\n"
             "  --repo-storage-ca-file              repository storage CA file\n"
             "  --repo-storage-ca-path              repository storage CA path\n"
+            "  --repo-storage-download-chunk-size  repository storage download chunk size\n"
+            "                                      [default=16MiB]\n"
+            "  --repo-storage-download-max         max chunk downloads in progress for each\n"
+            "                                      file [default=1]\n"
             "  --repo-storage-host                 repository storage host\n"
             "  --repo-storage-port                 repository storage port [default=443]\n"
             "  --repo-storage-tag                  repository storage tag(s)\n"
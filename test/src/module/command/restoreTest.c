@@ -220,7 +220,8 @@ testRun(void)
         IoWrite *write = ioBufferWriteNew(destination);
 
         ioFilterGroupAdd(
-            ioWriteFilterGroup(write), blockIncrNew(6, 3, 5, 0, 0, 0, NULL, compressFilterP(compressTypeGz, 1, .raw = true), NULL));
+            ioWriteFilterGroup(write),
+            blockIncrNew(6, 3, 5, 0, 0, 0, NULL, false, NULL, compressFilterP(compressTypeGz, 1, .raw = true), NULL));
         ioWriteOpen(write);
         ioWrite(write, source);
         ioWriteClose(write);
@@ -260,6 +261,83 @@ testRun(void)
             "    block {no: 0, offset: 6}\n"
             "    block {no: 1, offset: 9}\n",
             "check delta");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("remainder of super blocks is skipped once required blocks are read");
+
+        // Only the first block in each super block has changed
+        Buffer *blockChecksum = bufNew(4 * 5);
+
+        for (unsigned int blockIdx = 0; blockIdx < 4; blockIdx++)
+        {
+            if (blockIdx % 2 == 0)
+                memset(bufRemainsPtr(blockChecksum), 0, 5);
+            else
+                memcpy(bufRemainsPtr(blockChecksum), blockMapGet(blockMap, blockIdx)->checksum, 5);
+
+            bufUsedInc(blockChecksum, 5);
+        }
+
+        blockDelta = blockDeltaNew(blockMap, 3, 5, blockChecksum, cipherTypeNone, NULL, compressTypeGz);
+        blockDeltaRead = blockDeltaReadGet(blockDelta, 0);
+        read = ioBufferReadNewOpen(destination);
+
+        ioBufferSizeSet(1);
+
+        TEST_RESULT_STR_Z(strNewBuf(blockDeltaNext(blockDelta, blockDeltaRead, read)->block), "123", "read block");
+        TEST_RESULT_STR_Z(strNewBuf(blockDeltaNext(blockDelta, blockDeltaRead, read)->block), "789", "read block");
+        TEST_RESULT_PTR(blockDeltaNext(blockDelta, blockDeltaRead, read), NULL, "no more blocks");
+
+        ioBufferSizeSet(bufferSizeOld);
+
+        TEST_RESULT_STR_Z(
+            hrnBlockDeltaRender(blockMapNewRead(read, 3, 5), 3, 5),
+            "read {reference: 0, bundleId: 0, offset: 0, size: 28}\n"
+            "  super block {max: 6, size: 14}\n"
+            "    block {no: 0, offset: 0}\n"
+            "    block {no: 1, offset: 3}\n"
+            "  super block {max: 6, size: 14}\n"
+            "    block {no: 0, offset: 6}\n"
+            "    block {no: 1, offset: 9}\n",
+            "check delta");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("duplicate blocks are written at each offset");
+
+        source = BUFSTRZ("ABCABCXYZABC");
+        destination = bufNew(256);
+        write = ioBufferWriteNew(destination);
+
+        ioFilterGroupAdd(
+            ioWriteFilterGroup(write),
+            blockIncrNew(6, 3, 5, 0, 1, 0, NULL, true, NULL, compressFilterP(compressTypeGz, 1, .raw = true), NULL));
+        ioWriteOpen(write);
+        ioWrite(write, source);
+        ioWriteClose(write);
+
+        mapSize = pckReadU64P(ioFilterGroupResultP(ioWriteFilterGroup(write), BLOCK_INCR_FILTER_TYPE));
+        blockMap = blockMapNewRead(
+            ioBufferReadNewOpen(BUF(bufPtr(destination) + (bufUsed(destination) - (size_t)mapSize), (size_t)mapSize)), 3, 5);
+
+        blockDelta = blockDeltaNew(blockMap, 3, 5, NULL, cipherTypeNone, NULL, compressTypeGz);
+        blockDeltaRead = blockDeltaReadGet(blockDelta, 0);
+        read = ioBufferReadNewOpen(destination);
+
+        const BlockDeltaWrite *blockDeltaWrite = NULL;
+
+        TEST_ASSIGN(blockDeltaWrite, blockDeltaNext(blockDelta, blockDeltaRead, read), "next block");
+        TEST_RESULT_STR_Z(strNewBuf(blockDeltaWrite->block), "ABC", "block");
+        TEST_RESULT_UINT(blockDeltaWrite->offset, 0, "offset");
+        TEST_ASSIGN(blockDeltaWrite, blockDeltaNext(blockDelta, blockDeltaRead, read), "next block");
+        TEST_RESULT_STR_Z(strNewBuf(blockDeltaWrite->block), "ABC", "block");
+        TEST_RESULT_UINT(blockDeltaWrite->offset, 3, "offset");
+        TEST_ASSIGN(blockDeltaWrite, blockDeltaNext(blockDelta, blockDeltaRead, read), "next block");
+        TEST_RESULT_STR_Z(strNewBuf(blockDeltaWrite->block), "ABC", "block");
+        TEST_RESULT_UINT(blockDeltaWrite->offset, 9, "offset");
+        TEST_ASSIGN(blockDeltaWrite, blockDeltaNext(blockDelta, blockDeltaRead, read), "next block");
+        TEST_RESULT_STR_Z(strNewBuf(blockDeltaWrite->block), "XYZ", "block");
+        TEST_RESULT_UINT(blockDeltaWrite->offset, 6, "offset");
+        TEST_RESULT_PTR(blockDeltaNext(blockDelta, blockDeltaRead, read), NULL, "no more blocks");
     }
 
     // *****************************************************************************************************************************
@@ -306,10 +384,31 @@ testRun(void)
         TEST_ERROR(
             restoreFile(
                 strNewFmt(STORAGE_REPO_BACKUP "/%s/%s.gz", strZ(repoFileReferenceFull), strZ(repoFile1)), repoIdx, compressTypeGz,
-                0, false, false, false, STRDEF("badpass"), NULL, fileList),
+                0, false, false, false, cipherTypeAes256Cbc, STRDEF("badpass"), NULL, fileList),
             ChecksumError,
             "error restoring 'normal': actual checksum 'd1cd8a7d11daa26814b93eb604e1d49ab4b43770' does not match expected checksum"
             " 'ffffffffffffffffffffffffffffffffffffffff'");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("compressed repo file encrypted with authenticated frames");
+
+        HRN_STORAGE_PUT_Z(
+            storageRepoWrite(), zNewFmt(STORAGE_REPO_BACKUP "/%s/%s", strZ(repoFileReferenceFull), strZ(repoFile1)),
+            "acefile", .compressType = compressTypeGz, .cipherType = cipherTypeAes256Gcm, .cipherPass = "gcmpass",
+            .comment = "create a compressed encrypted repo file");
+
+        fileList = lstNewP(sizeof(RestoreFile));
+        file.checksum = bufNewDecode(encodingHex, STRDEF("d1cd8a7d11daa26814b93eb604e1d49ab4b43770"));
+        lstAdd(fileList, &file);
+
+        TEST_RESULT_UINT(
+            ((const RestoreFileResult *)lstGet(
+                restoreFile(
+                    strNewFmt(STORAGE_REPO_BACKUP "/%s/%s.gz", strZ(repoFileReferenceFull), strZ(repoFile1)), repoIdx,
+                    compressTypeGz, 0, false, false, false, cipherTypeAes256Gcm, STRDEF("gcmpass"), NULL, fileList),
+                0))->result,
+            restoreResultCopy, "restore file");
+        TEST_STORAGE_GET(storagePgWrite(), "normal", "acefile", .remove = true);
     }
 
     // *****************************************************************************************************************************
@@ -1807,6 +1906,22 @@ testRun(void)
             " --pg1-path=/pg --repo1-path=/repo --stanza=test1 archive-get %f \"%p\"'\n",
             "restore_command invokes /usr/local/bin/pg_wrapper.sh per --cmd option");
 
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("restore_command stops the archive-get queue at the lsn target");
+
+        argList = strLstDup(argBaseList);
+        hrnCfgArgRawZ(argList, cfgOptType, "lsn");
+        hrnCfgArgRawZ(argList, cfgOptTarget, "5218/5E35BBA8");
+        HRN_CFG_LOAD(cfgCmdRestore, argList);
+
+        TEST_RESULT_STR_Z(
+            restoreRecoveryConf(PG_VERSION_10, restoreLabel),
+            RECOVERY_SETTING_HEADER
+            "restore_command = '" TEST_PROJECT_EXE " --archive-get-queue-target=5218/5E35BBA8 --beta --lock-path=" HRN_PATH "/lock"
+            " --log-path=" HRN_PATH " --pg1-path=/pg --repo1-path=/repo --stanza=test1 archive-get %f \"%p\"'\n"
+            "recovery_target_lsn = '5218/5E35BBA8'\n",
+            "check recovery options");
+
         // -------------------------------------------------------------------------------------------------------------------------
         TEST_TITLE("override restore_command");
 
@@ -2816,7 +2931,7 @@ testRun(void)
             bufUsedSet(fileBuffer, bufSize(fileBuffer));
 
             IoWrite *write = storageWriteIo(storageNewWriteP(storageRepoWrite(), STRDEF(TEST_REPO_PATH "base/1/bi-no-ref.pgbi")));
-            ioFilterGroupAdd(ioWriteFilterGroup(write), blockIncrNew(8192, 8192, 11, 3, 0, 0, NULL, NULL, NULL));
+            ioFilterGroupAdd(ioWriteFilterGroup(write), blockIncrNew(8192, 8192, 11, 3, 0, 0, NULL, false, NULL, NULL, NULL));
             ioFilterGroupAdd(ioWriteFilterGroup(write), ioSizeNew());
 
             ioWriteOpen(write);
@@ -2838,7 +2953,7 @@ testRun(void)
 
             Buffer *fileUnusedMap = bufNew(0);
             write = ioBufferWriteNew(fileUnusedMap);
-            ioFilterGroupAdd(ioWriteFilterGroup(write), blockIncrNew(8192, 8192, 11, 0, 0, 0, NULL, NULL, NULL));
+            ioFilterGroupAdd(ioWriteFilterGroup(write), blockIncrNew(8192, 8192, 11, 0, 0, 0, NULL, false, NULL, NULL, NULL));
 
             ioWriteOpen(write);
             ioWrite(write, fileUnused);
@@ -2858,7 +2973,8 @@ testRun(void)
                 ioWriteFilterGroup(write),
                 blockIncrNew(
                     8192, 8192, 11, 3, 0, 0,
-                    BUF(bufPtr(fileUnusedMap) + bufUsed(fileUnusedMap) - fileUnusedMapSize, fileUnusedMapSize), NULL, NULL));
+                    BUF(bufPtr(fileUnusedMap) + bufUsed(fileUnusedMap) - fileUnusedMapSize, fileUnusedMapSize), false, NULL, NULL,
+                    NULL));
             ioFilterGroupAdd(ioWriteFilterGroup(write), ioSizeNew());
 
             ioWriteOpen(write);
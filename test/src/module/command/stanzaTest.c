@@ -547,6 +547,71 @@ testRun(void)
                 storageGetP(storageNewReadP(storageRepoIdx(0), INFO_BACKUP_PATH_FILE_STR)),
                 storageGetP(storageNewReadP(storageHrn, STRDEF("test.info")))),
             true, "test and stanza backup info files are equal");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("stanza-create with archive dictionary");
+
+        HRN_STORAGE_PATH_REMOVE(storageTest, "repo", .recurse = true);
+
+        argList = strLstDup(argListBase);
+        hrnCfgArgRawBool(argList, cfgOptArchiveDict, true);
+        HRN_CFG_LOAD(cfgCmdStanzaCreate, argList);
+
+        HRN_PG_CONTROL_PUT(storagePgWrite(), PG_VERSION_96);
+
+        TEST_RESULT_VOID(cmdStanzaCreate(), "stanza create - no WAL segment to train dictionary");
+        TEST_RESULT_LOG(
+            "P00   INFO: stanza-create for stanza 'db' on repo1\n"
+            "P00   WARN: unable to create archive dictionary: no WAL segment found in '" TEST_PATH "/pg/pg_xlog'");
+
+        // WAL segment with repetitive records that differ a bit on each page
+        Buffer *const walSegment = bufNew(16 * 1024 * 1024);
+
+        for (unsigned int pageIdx = 0; pageIdx < 16 * 1024 * 1024 / 8192; pageIdx++)
+        {
+            Buffer *const page = bufNew(8192);
+
+            while (bufRemains(page) > 0)
+            {
+                const String *const record = strNewFmt(
+                    "INSERT rel 1663/%u block %u offset %zu tuple {id: %u, name: 'name%u'};", 16384 + pageIdx % 7, pageIdx,
+                    bufUsed(page), pageIdx * 31 % 1000, pageIdx % 13);
+
+                bufCatSub(page, BUFSTR(record), 0, strSize(record) < bufRemains(page) ? strSize(record) : bufRemains(page));
+            }
+
+            bufCat(walSegment, page);
+        }
+
+#ifdef HAVE_LIBZST
+        HRN_STORAGE_PUT(storagePgWrite(), "pg_xlog/000000010000000000000001", bufNew(0), .comment = "partial segment is skipped");
+        HRN_STORAGE_PUT(storagePgWrite(), "pg_xlog/000000010000000000000002", walSegment, .timeModified = 1555160000);
+        HRN_STORAGE_PUT(
+            storagePgWrite(), "pg_xlog/000000010000000000000003", walSegment, .timeModified = 1555160001,
+            .comment = "dictionary is trained on a sample of segments");
+
+        TEST_RESULT_VOID(cmdStanzaCreate(), "stanza create - create dictionary");
+        TEST_RESULT_LOG(
+            "P00   INFO: stanza-create for stanza 'db' on repo1\n"
+            "P00   INFO: stanza 'db' already exists on repo1 and is valid\n"
+            "P00   INFO: archive dictionary created for archive id '9.6-1' on repo1");
+
+        TEST_STORAGE_EXISTS(storageTest, "repo/archive/db/9.6-1/" ARCHIVE_DICT_FILE);
+
+        TEST_RESULT_VOID(cmdStanzaCreate(), "stanza create - dictionary is not replaced");
+        TEST_RESULT_LOG(
+            "P00   INFO: stanza-create for stanza 'db' on repo1\n"
+            "P00   INFO: stanza 'db' already exists on repo1 and is valid");
+#else
+        HRN_STORAGE_PUT(storagePgWrite(), "pg_xlog/000000010000000000000002", walSegment);
+
+        TEST_ERROR(cmdStanzaCreate(), OptionInvalidValueError, PROJECT_NAME " not built with zst support");
+        TEST_RESULT_LOG(
+            "P00   INFO: stanza-create for stanza 'db' on repo1\n"
+            "P00   INFO: stanza 'db' already exists on repo1 and is valid");
+#endif
+
+        HRN_STORAGE_PATH_REMOVE(storagePgWrite(), "pg_xlog", .recurse = true);
     }
 
     // *****************************************************************************************************************************
@@ -844,7 +844,7 @@ testRun(void)
     }
 
     // *****************************************************************************************************************************
-    if (testBegin("verifyFile()"))
+    if (testBegin("verifyFile(), verifyBundle()"))
     {
         // Load Parameters
         StringList *argList = strLstDup(argListBase);
@@ -856,20 +856,24 @@ testRun(void)
         String *filePathName = strNewZ(STORAGE_REPO_ARCHIVE "/testfile");
         HRN_STORAGE_PUT_EMPTY(storageRepoWrite(), strZ(filePathName));
         TEST_RESULT_UINT(
-            verifyFile(filePathName, 0, NULL, compressTypeNone, HASH_TYPE_SHA1_ZERO_BUF, 0, NULL), verifyOk, "file ok");
+            verifyFile(filePathName, 0, NULL, compressTypeNone, HASH_TYPE_SHA1_ZERO_BUF, 0, cipherTypeNone, NULL, NULL), verifyOk,
+            "file ok");
 
         // -------------------------------------------------------------------------------------------------------------------------
         TEST_TITLE("file size invalid in archive");
 
         HRN_STORAGE_PUT_Z(storageRepoWrite(), strZ(filePathName), fileContents);
         TEST_RESULT_UINT(
-            verifyFile(filePathName, 0, NULL, compressTypeNone, fileChecksum, 0, NULL), verifySizeInvalid, "file size invalid");
+            verifyFile(filePathName, 0, NULL, compressTypeNone, fileChecksum, 0, cipherTypeNone, NULL, NULL), verifySizeInvalid,
+            "file size invalid");
 
         // -------------------------------------------------------------------------------------------------------------------------
         TEST_TITLE("file missing in archive");
 
         TEST_RESULT_UINT(
-            verifyFile(strNewFmt(STORAGE_REPO_ARCHIVE "/missingFile"), 0, NULL, compressTypeNone, fileChecksum, 0, NULL),
+            verifyFile(
+                strNewFmt(STORAGE_REPO_ARCHIVE "/missingFile"), 0, NULL, compressTypeNone, fileChecksum, 0, cipherTypeNone, NULL,
+                NULL),
             verifyFileMissing, "file missing");
 
         // -------------------------------------------------------------------------------------------------------------------------
@@ -883,11 +887,101 @@ testRun(void)
 
         strCatZ(filePathName, ".gz");
         TEST_RESULT_UINT(
-            verifyFile(filePathName, 0, NULL, compressTypeGz, fileChecksum, fileSize, STRDEF("pass")),
+            verifyFile(filePathName, 0, NULL, compressTypeGz, fileChecksum, fileSize, cipherTypeAes256Cbc, STRDEF("pass"), NULL),
             verifyOk, "file encrypted compressed ok");
         TEST_RESULT_UINT(
-            verifyFile(filePathName, 0, NULL, compressTypeGz, bufNewDecode(encodingHex, STRDEF("aa")), fileSize, STRDEF("pass")),
+            verifyFile(
+                filePathName, 0, NULL, compressTypeGz, bufNewDecode(encodingHex, STRDEF("aa")), fileSize, cipherTypeAes256Cbc,
+                STRDEF("pass"), NULL),
             verifyChecksumMismatch, "file encrypted compressed checksum mismatch");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("file encrypted with authenticated frames in backup");
+
+        filePathName = strCatZ(strNew(), STORAGE_REPO_BACKUP "/testfile-gcm");
+        HRN_STORAGE_PUT_Z(
+            storageRepoWrite(), strZ(filePathName), fileContents, .cipherType = cipherTypeAes256Gcm, .cipherPass = "pass");
+
+        TEST_RESULT_UINT(
+            verifyFile(filePathName, 0, NULL, compressTypeNone, fileChecksum, fileSize, cipherTypeAes256Gcm, STRDEF("pass"), NULL),
+            verifyOk, "file encrypted ok");
+        TEST_ERROR(
+            verifyFile(filePathName, 0, NULL, compressTypeNone, fileChecksum, fileSize, cipherTypeAes256Gcm, STRDEF("bogus"), NULL),
+            CryptoError, "unable to authenticate frame 0-0");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("files in bundle");
+
+        // The first two files are contiguous and read together. The gap before the third file requires a second read.
+        filePathName = strCatZ(strNew(), STORAGE_REPO_BACKUP "/bundle/1");
+        HRN_STORAGE_PUT_Z(storageRepoWrite(), strZ(filePathName), zNewFmt("XXX%s%sYY%s", fileContents, fileContents, fileContents));
+
+        List *fileList = lstNewP(sizeof(VerifyBundleFile));
+        lstAdd(
+            fileList,
+            &(VerifyBundleFile){
+                .offset = 3, .sizeRepo = fileSize, .compressType = compressTypeNone, .checksum = fileChecksum, .size = fileSize,
+                .cipherType = cipherTypeNone});
+        lstAdd(
+            fileList,
+            &(VerifyBundleFile){
+                .offset = 10, .sizeRepo = fileSize, .compressType = compressTypeNone,
+                .checksum = bufNewDecode(encodingHex, STRDEF("aa")), .size = fileSize, .cipherType = cipherTypeNone});
+        lstAdd(
+            fileList,
+            &(VerifyBundleFile){
+                .offset = 19, .sizeRepo = fileSize, .compressType = compressTypeNone, .checksum = fileChecksum, .size = 6,
+                .cipherType = cipherTypeNone});
+
+        List *resultList = NULL;
+
+        TEST_ASSIGN(resultList, verifyBundle(filePathName, fileList), "verify bundle");
+        TEST_RESULT_UINT(lstSize(resultList), 3, "result total");
+        TEST_RESULT_UINT(((VerifyBundleResult *)lstGet(resultList, 0))->result, verifyOk, "file ok");
+        TEST_RESULT_UINT(((VerifyBundleResult *)lstGet(resultList, 1))->result, verifyChecksumMismatch, "file checksum mismatch");
+        TEST_RESULT_UINT(((VerifyBundleResult *)lstGet(resultList, 2))->result, verifySizeInvalid, "file size invalid");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("files in missing bundle");
+
+        TEST_ASSIGN(resultList, verifyBundle(STRDEF(STORAGE_REPO_BACKUP "/bundle/2"), fileList), "verify bundle");
+        TEST_RESULT_UINT(lstSize(resultList), 3, "result total");
+        TEST_RESULT_UINT(((VerifyBundleResult *)lstGet(resultList, 0))->result, verifyFileMissing, "file missing");
+        TEST_RESULT_UINT(((VerifyBundleResult *)lstGet(resultList, 1))->result, verifyFileMissing, "file missing");
+        TEST_RESULT_UINT(((VerifyBundleResult *)lstGet(resultList, 2))->result, verifyFileMissing, "file missing");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("read error in bundle is reported for the file only");
+
+        // The second file cannot be decompressed. The files are contiguous so the third file is read after the bundle is reopened.
+        filePathName = strCatZ(strNew(), STORAGE_REPO_BACKUP "/bundle/3");
+        HRN_STORAGE_PUT_Z(storageRepoWrite(), strZ(filePathName), zNewFmt("%s%s%s", fileContents, fileContents, fileContents));
+
+        fileList = lstNewP(sizeof(VerifyBundleFile));
+        lstAdd(
+            fileList,
+            &(VerifyBundleFile){
+                .offset = 0, .sizeRepo = fileSize, .compressType = compressTypeNone, .checksum = fileChecksum, .size = fileSize,
+                .cipherType = cipherTypeNone});
+        lstAdd(
+            fileList,
+            &(VerifyBundleFile){
+                .offset = 7, .sizeRepo = fileSize, .compressType = compressTypeGz, .checksum = fileChecksum, .size = fileSize,
+                .cipherType = cipherTypeNone});
+        lstAdd(
+            fileList,
+            &(VerifyBundleFile){
+                .offset = 14, .sizeRepo = fileSize, .compressType = compressTypeNone, .checksum = fileChecksum, .size = fileSize,
+                .cipherType = cipherTypeNone});
+
+        TEST_ASSIGN(resultList, verifyBundle(filePathName, fileList), "verify bundle");
+        TEST_RESULT_UINT(lstSize(resultList), 3, "result total");
+        TEST_RESULT_UINT(((VerifyBundleResult *)lstGet(resultList, 0))->result, verifyOk, "file ok");
+        TEST_RESULT_UINT(((VerifyBundleResult *)lstGet(resultList, 1))->result, verifyOtherError, "file read error");
+        TEST_RESULT_INT(((VerifyBundleResult *)lstGet(resultList, 1))->errorCode, errorTypeCode(&FormatError), "error code");
+        TEST_RESULT_STR_Z(
+            ((VerifyBundleResult *)lstGet(resultList, 1))->errorMessage, "zlib threw error: [-3] data error", "error message");
+        TEST_RESULT_UINT(((VerifyBundleResult *)lstGet(resultList, 2))->result, verifyOk, "file ok after reopen");
     }
 
     // *****************************************************************************************************************************
@@ -1544,6 +1638,11 @@ testRun(void)
             "\n"
             "[target:file]\n"
             "pg_data/validfile={\"bni\":1,\"bno\":3,\"checksum\":\"%s\",\"size\":%u,\"timestamp\":1565282114}\n"
+            "pg_data/validfile2={\"bni\":1,\"bno\":10,\"checksum\":\"%s\",\"size\":%u,\"timestamp\":1565282114}\n"
+            "pg_data/validfile3={\"bni\":2,\"checksum\":\"%s\",\"size\":%u,\"timestamp\":1565282114}\n"
+            "pg_data/validfile4={\"bni\":3,\"checksum\":\"%s\",\"size\":%u,\"timestamp\":1565282114}\n"
+            "pg_data/readerror1={\"bni\":4,\"checksum\":\"%s\",\"size\":%u,\"timestamp\":1565282114}\n"
+            "pg_data/readerror2={\"bni\":4,\"bno\":7,\"checksum\":\"%s\",\"size\":%u,\"timestamp\":1565282114}\n"
             "pg_data/zerofile={\"size\":0,\"timestamp\":1565282114}\n"
             "pg_data/biind={\"bi\":1,\"bim\":3,\"checksum\":\"9865d483bc5a94f2e30056fc256ed3066af54d04\",\"size\":4"
             ",\"timestamp\":1565282114}\n"
@@ -1552,7 +1651,10 @@ testRun(void)
             TEST_MANIFEST_LINK_DEFAULT
             TEST_MANIFEST_PATH
             TEST_MANIFEST_PATH_DEFAULT,
-            strZ(strNewEncode(encodingHex, fileChecksum)), (unsigned int)fileSize);
+            strZ(strNewEncode(encodingHex, fileChecksum)), (unsigned int)fileSize, strZ(strNewEncode(encodingHex, fileChecksum)),
+            (unsigned int)fileSize, strZ(strNewEncode(encodingHex, fileChecksum)), (unsigned int)fileSize,
+            strZ(strNewEncode(encodingHex, fileChecksum)), (unsigned int)fileSize, strZ(strNewEncode(encodingHex, fileChecksum)),
+            (unsigned int)fileSize, strZ(strNewEncode(encodingHex, fileChecksum)), (unsigned int)fileSize);
 
         HRN_INFO_PUT(
             storageRepoWrite(), STORAGE_REPO_BACKUP "/20201119-163000F/" BACKUP_MANIFEST_FILE, strZ(manifestContent),
@@ -1562,10 +1664,16 @@ testRun(void)
             .comment = "valid manifest copy - full");
 
         HRN_STORAGE_PUT_Z(
-            storageRepoWrite(), STORAGE_REPO_BACKUP "/20201119-163000F/bundle/1", zNewFmt("XXX%s", fileContents),
-            .comment = "valid file");
+            storageRepoWrite(), STORAGE_REPO_BACKUP "/20201119-163000F/bundle/1", zNewFmt("XXX%s%s", fileContents, fileContents),
+            .comment = "valid files");
+        HRN_STORAGE_PUT_Z(
+            storageRepoWrite(), STORAGE_REPO_BACKUP "/20201119-163000F/bundle/2", fileContents, .comment = "valid file");
+        HRN_STORAGE_PUT_Z(
+            storageRepoWrite(), STORAGE_REPO_BACKUP "/20201119-163000F/bundle/3", fileContents, .comment = "valid file");
         HRN_STORAGE_PUT_Z(
             storageRepoWrite(), STORAGE_REPO_BACKUP "/20201119-163000F/pg_data/biind.pgbi", "ZZZZ", .comment = "pgbi file");
+        HRN_STORAGE_PATH_CREATE(
+            storageRepoWrite(), STORAGE_REPO_BACKUP "/20201119-163000F/bundle/4", .comment = "bundle that cannot be read");
 
         // Create WAL file with just header info and small WAL size
         Buffer *walBuffer = bufNew((size_t)(1024 * 1024));
@@ -1597,13 +1705,19 @@ testRun(void)
             "P01   INFO: invalid checksum '20181119-152900F/pg_data/PG_VERSION'\n"
             "P01   INFO: invalid size '20181119-152900F/pg_data/base/1/555_init'\n"
             "P01   INFO: file missing '20181119-152900F/pg_data/base/1/555_init.1'\n"
+            "P01   INFO: invalid result 20201119-163000F/pg_data/readerror1: [42] unable to read '" TEST_PATH "/repo/backup/db"
+            "/20201119-163000F/bundle/4': [21] Is a directory\n"
+            "P01   INFO: invalid result 20201119-163000F/pg_data/readerror2: [42] unable to read '" TEST_PATH "/repo/backup/db"
+            "/20201119-163000F/bundle/4': [21] Is a directory\n"
             "P00   INFO: stanza: db\n"
             "            status: error\n"
             "              backup: 20181119-152900F, status: invalid, total files checked: 3, total valid files: 0\n"
             "                missing: 1, checksum invalid: 1, size invalid: 1\n"
             "              backup: 20181119-152900F_20181119-152909D, status: invalid, total files checked: 1,"
             " total valid files: 0\n"
-            "                checksum invalid: 1");
+            "                checksum invalid: 1\n"
+            "              backup: 20201119-163000F, status: invalid, total files checked: 8, total valid files: 6\n"
+            "                other: 2");
     }
 
     // *****************************************************************************************************************************
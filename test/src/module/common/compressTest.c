@@ -381,16 +381,18 @@ testRun(void)
 
         char buffer[STACK_TRACE_PARAM_MAX];
 
-        ZstCompress *compress = (ZstCompress *)ioFilterDriver(zstCompressNew(14, false));
+        ZstCompress *compress = (ZstCompress *)ioFilterDriver(zstCompressNew(14, false, 0, false, NULL));
 
         compress->inputSame = true;
         compress->inputOffset = 49;
         compress->flushing = true;
 
         TEST_RESULT_VOID(FUNCTION_LOG_OBJECT_FORMAT(compress, zstCompressToLog, buffer, sizeof(buffer)), "zstCompressToLog");
-        TEST_RESULT_Z(buffer, "{level: 14, inputSame: true, inputOffset: 49, flushing: true}", "check log");
+        TEST_RESULT_Z(
+            buffer, "{level: 14, threadMax: 0, longMatch: false, dictId: 0, inputSame: true, inputOffset: 49, flushing: true}",
+            "check log");
 
-        ZstDecompress *decompress = (ZstDecompress *)ioFilterDriver(zstDecompressNew(false));
+        ZstDecompress *decompress = (ZstDecompress *)ioFilterDriver(zstDecompressNew(false, NULL));
 
         decompress->inputSame = true;
         decompress->done = true;
@@ -398,6 +400,113 @@ testRun(void)
 
         TEST_RESULT_VOID(FUNCTION_LOG_OBJECT_FORMAT(decompress, zstDecompressToLog, buffer, sizeof(buffer)), "zstDecompressToLog");
         TEST_RESULT_Z(buffer, "{inputSame: true, inputOffset: 999, frameDone false, done: true}", "check log");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("compress with threads and long distance matching");
+
+        // Random data repeated after a gap that is larger than the window used by level 1 without long distance matching
+        Buffer *const repeated = bufNew(4 * 1024 * 1024);
+        uint32_t seed = 1;
+
+        for (size_t byteIdx = 0; byteIdx < 1024 * 1024; byteIdx++)
+        {
+            seed = seed * 1103515245 + 12345;
+            bufPtr(repeated)[byteIdx] = (unsigned char)(seed >> 16);
+        }
+
+        memset(bufPtr(repeated) + 1024 * 1024, 0, 2 * 1024 * 1024);
+        memcpy(bufPtr(repeated) + 3 * 1024 * 1024, bufPtr(repeated), 1024 * 1024);
+        bufUsedSet(repeated, bufSize(repeated));
+
+        Buffer *compressedLong = NULL;
+        Buffer *compressedShort = NULL;
+
+        TEST_ASSIGN(
+            compressedShort, testCompress(compressFilterP(compressTypeZst, 1), repeated, 65536, 65536), "compress without long");
+        TEST_ASSIGN(
+            compressedLong,
+            testCompress(compressFilterP(compressTypeZst, 1, .threadMax = 2, .longMatch = true), repeated, 65536, 65536),
+            "compress with threads and long");
+        TEST_RESULT_BOOL(bufUsed(compressedLong) < bufUsed(compressedShort) * 3 / 4, true, "long is smaller");
+
+        TEST_RESULT_BOOL(
+            bufEq(repeated, testDecompress(decompressFilterP(compressTypeZst), compressedLong, 65536, 65536)), true,
+            "decompress with default settings");
+
+        PackWrite *packWrite = pckWriteNewP();
+        pckWriteI32P(packWrite, 1);
+        pckWriteBoolP(packWrite, false);
+        pckWriteU32P(packWrite, 2);
+        pckWriteBoolP(packWrite, true);
+        pckWriteEndP(packWrite);
+
+        TEST_RESULT_BOOL(
+            bufEq(
+                compressedLong,
+                testCompress(compressFilterPack(ZST_COMPRESS_FILTER_TYPE, pckWriteResult(packWrite)), repeated, 65536, 65536)),
+            true, "compress from pack");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("compress with a dictionary");
+
+        // Samples that share most of their content so a dictionary can be trained
+        Buffer *const sample = bufNew(2048 * 512);
+
+        for (size_t byteIdx = 0; byteIdx < 512; byteIdx++)
+        {
+            seed = seed * 1103515245 + 12345;
+            bufPtr(sample)[byteIdx] = (unsigned char)(seed >> 16);
+        }
+
+        for (unsigned int sampleIdx = 1; sampleIdx < 2048; sampleIdx++)
+        {
+            memcpy(bufPtr(sample) + sampleIdx * 512, bufPtr(sample), 512);
+            seed = seed * 1103515245 + 12345;
+
+            for (unsigned int changeIdx = 0; changeIdx < 8; changeIdx++)
+                bufPtr(sample)[sampleIdx * 512 + ((seed >> (changeIdx * 2)) % 512)] = (unsigned char)(sampleIdx + changeIdx);
+        }
+
+        bufUsedSet(sample, bufSize(sample));
+
+        Buffer *dict = NULL;
+
+        TEST_RESULT_PTR(zstDictTrain(BUFSTRDEF("too small"), 512), NULL, "too few samples");
+        TEST_ASSIGN(dict, compressDictTrain(compressTypeZst, sample, 512), "train dictionary");
+        TEST_RESULT_BOOL(dict != NULL && zstDictId(dict) != 0, true, "dictionary has id");
+
+        Buffer *const small = bufNewC(bufPtr(sample) + 5 * 512, 512);
+        Buffer *compressedDict = NULL;
+        Buffer *compressedNoDict = NULL;
+
+        TEST_ASSIGN(compressedDict, testCompress(compressFilterP(compressTypeZst, 3, .dict = dict), small, 1024, 1024), "compress");
+        TEST_ASSIGN(compressedNoDict, testCompress(compressFilterP(compressTypeZst, 3), small, 1024, 1024), "compress no dict");
+        TEST_RESULT_BOOL(bufUsed(compressedDict) * 4 < bufUsed(compressedNoDict), true, "dictionary is smaller");
+
+        TEST_RESULT_BOOL(
+            bufEq(small, testDecompress(decompressFilterP(compressTypeZst, .dict = dict), compressedDict, 1024, 1024)), true,
+            "decompress with dictionary");
+        TEST_RESULT_BOOL(
+            bufEq(small, testDecompress(decompressFilterP(compressTypeZst, .dict = dict), compressedNoDict, 1024, 1024)), true,
+            "dictionary is not used for frame without dictionary");
+        TEST_ERROR_FMT(
+            testDecompress(decompressFilterP(compressTypeZst), compressedDict, 1024, 1024), FormatError,
+            "zst frame requires dictionary %u but no dictionary was provided", zstDictId(dict));
+        TEST_ERROR_FMT(
+            testDecompress(decompressFilterP(compressTypeZst, .dict = BUFSTRDEF("bogus")), compressedDict, 1024, 1024),
+            FormatError, "zst frame requires dictionary %u but dictionary 0 was provided", zstDictId(dict));
+
+        packWrite = pckWriteNewP();
+        pckWriteBoolP(packWrite, false);
+        pckWriteBinP(packWrite, dict);
+        pckWriteEndP(packWrite);
+
+        TEST_RESULT_BOOL(
+            bufEq(
+                small,
+                testDecompress(
+                    compressFilterPack(ZST_DECOMPRESS_FILTER_TYPE, pckWriteResult(packWrite)), compressedDict, 1024, 1024)),
+            true, "decompress from pack");
 #else
         TEST_ERROR(compressTypePresent(compressTypeZst), OptionInvalidValueError, "pgBackRest not built with zst support");
 #endif // HAVE_LIBZST
@@ -435,6 +544,31 @@ testRun(void)
 
         TEST_RESULT_PTR(compressFilterPack(STRID5("bogus", 0x13a9de20), NULL), NULL, "no filter match");
 
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("compressFilter() ignores threads, long distance matching, and dictionaries when not supported");
+
+        const Buffer *const simple = BUFSTRDEF("A simple string");
+
+        TEST_RESULT_BOOL(
+            bufEq(
+                testCompress(
+                    compressFilterP(compressTypeGz, 1, .threadMax = 4, .longMatch = true, .dict = simple), bufDup(simple), 1024,
+                    1024),
+                testCompress(compressFilterP(compressTypeGz, 1), bufDup(simple), 1024, 1024)),
+            true, "gz output is the same");
+        TEST_RESULT_BOOL(
+            bufEq(
+                testDecompress(
+                    decompressFilterP(compressTypeGz, .dict = simple),
+                    testCompress(compressFilterP(compressTypeGz, 1), bufDup(simple), 1024, 1024), 1024, 1024),
+                simple),
+            true, "gz decompress ignores dictionary");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("compressDictTrain()");
+
+        TEST_RESULT_PTR(compressDictTrain(compressTypeGz, simple, 4), NULL, "gz does not support dictionaries");
+
         // -------------------------------------------------------------------------------------------------------------------------
         TEST_TITLE("compressExtStr()");
 
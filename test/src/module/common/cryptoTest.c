@@ -1,6 +1,7 @@
 /***********************************************************************************************************************************
 Test Block Cipher
 ***********************************************************************************************************************************/
+#include "common/crypto/cipherFrame.h"
 #include "common/io/bufferRead.h"
 #include "common/io/filter/filter.h"
 #include "common/io/io.h"
@@ -14,6 +15,34 @@ Data for testing
 #define TEST_PLAINTEXT                                              "plaintext"
 #define TEST_BUFFER_SIZE                                            256
 
+/***********************************************************************************************************************************
+Process data with a frame cipher, reading the source in inputSize chunks
+***********************************************************************************************************************************/
+static Buffer *
+testCipherFrame(IoFilter *const cipher, const Buffer *const source, const size_t inputSize)
+{
+    Buffer *const result = bufNew(0);
+    Buffer *const output = bufNew(777);
+    ioBufferSizeSet(inputSize);
+
+    IoRead *const read = ioBufferReadNew(source);
+    ioFilterGroupAdd(ioReadFilterGroup(read), cipher);
+    ioReadOpen(read);
+
+    while (!ioReadEof(read))
+    {
+        ioRead(read, output);
+        bufCat(result, output);
+        bufUsedZero(output);
+    }
+
+    ioReadClose(read);
+    ioReadFree(read);
+    bufFree(output);
+
+    return result;
+}
+
 /***********************************************************************************************************************************
 Test Run
 ***********************************************************************************************************************************/
@@ -252,6 +281,16 @@ testRun(void)
 
         ioFilterFree(blockDecryptFilter);
 
+        // Frame cipher header
+        // -------------------------------------------------------------------------------------------------------------------------
+        blockDecryptFilter = cipherBlockNewP(cipherModeDecrypt, cipherTypeAes256Cbc, testPass);
+
+        TEST_ERROR(
+            ioFilterProcessInOut(blockDecryptFilter, BUFSTRDEF(CIPHER_FRAME_MAGIC "12345678"), decryptBuffer), CryptoError,
+            "cipher header invalid: data is encrypted with aes-256-gcm");
+
+        ioFilterFree(blockDecryptFilter);
+
         // Invalid encrypted data cannot be flushed
         // -------------------------------------------------------------------------------------------------------------------------
         blockDecryptFilter = cipherBlockNewP(cipherModeDecrypt, cipherTypeAes256Cbc, testPass);
@@ -302,6 +341,164 @@ testRun(void)
         TEST_RESULT_UINT(ioFilterGroupSize(filterGroup), 1, "    check filter add");
     }
 
+    // *****************************************************************************************************************************
+    if (testBegin("CipherFrame"))
+    {
+        // Data that does not fill the last frame
+        Buffer *const plainText = bufNew(200000);
+
+        for (size_t byteIdx = 0; byteIdx < bufSize(plainText); byteIdx++)
+            bufPtr(plainText)[byteIdx] = (unsigned char)(byteIdx * 7 + byteIdx / 251);
+
+        bufUsedSet(plainText, bufSize(plainText));
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("encrypt and decrypt on one thread");
+
+        Buffer *encrypt = NULL;
+        Buffer *decrypt = NULL;
+
+        TEST_ASSIGN(encrypt, testCipherFrame(cipherFrameNewP(cipherModeEncrypt, testPass), plainText, 1000), "encrypt");
+        TEST_RESULT_UINT(
+            bufUsed(encrypt), cipherFrameHeaderSize(false) + bufUsed(plainText) + 4 * CIPHER_FRAME_TAG_SIZE, "check size");
+        TEST_RESULT_BOOL(memcmp(bufPtrConst(encrypt), "PgBRgcm1", CIPHER_FRAME_MAGIC_SIZE) == 0, true, "check magic");
+
+        TEST_ASSIGN(decrypt, testCipherFrame(cipherFrameNewP(cipherModeDecrypt, testPass), encrypt, 333), "decrypt");
+        TEST_RESULT_BOOL(bufEq(decrypt, plainText), true, "check plain text");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("encrypt and decrypt on threads");
+
+        IoFilter *filter = cipherFrameNewP(cipherModeEncrypt, testPass, .threadMax = 3);
+
+        TEST_ASSIGN(filter, cipherFrameNewPack(ioFilterParamList(filter)), "new filter from pack");
+        TEST_ASSIGN(encrypt, testCipherFrame(filter, plainText, 65536), "encrypt");
+        TEST_RESULT_UINT(
+            bufUsed(encrypt), cipherFrameHeaderSize(false) + bufUsed(plainText) + 4 * CIPHER_FRAME_TAG_SIZE, "check size");
+
+        TEST_ASSIGN(
+            decrypt, testCipherFrame(cipherFrameNewP(cipherModeDecrypt, testPass, .threadMax = 2), encrypt, 4096), "decrypt");
+        TEST_RESULT_BOOL(bufEq(decrypt, plainText), true, "check plain text");
+
+        TEST_ASSIGN(
+            decrypt, testCipherFrame(cipherFrameNewP(cipherModeDecrypt, testPass, .threadMax = 8), encrypt, 8192), "decrypt");
+        TEST_RESULT_BOOL(bufEq(decrypt, plainText), true, "check plain text with more threads than frames");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("data fills the last frame");
+
+        const Buffer *const plainTextFull = bufNewC(bufPtrConst(plainText), 2 * CIPHER_FRAME_SIZE);
+
+        TEST_ASSIGN(
+            encrypt, testCipherFrame(cipherFrameNewP(cipherModeEncrypt, testPass, .threadMax = 2), plainTextFull, 1024), "encrypt");
+        TEST_RESULT_UINT(
+            bufUsed(encrypt), cipherFrameHeaderSize(false) + bufUsed(plainTextFull) + 2 * CIPHER_FRAME_TAG_SIZE, "check size");
+
+        TEST_ASSIGN(decrypt, testCipherFrame(cipherFrameNewP(cipherModeDecrypt, testPass), encrypt, 1024), "decrypt");
+        TEST_RESULT_BOOL(bufEq(decrypt, plainTextFull), true, "check plain text");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("error on missing final frame");
+
+        TEST_ERROR(
+            testCipherFrame(
+                cipherFrameNewP(cipherModeDecrypt, testPass),
+                bufNewC(bufPtrConst(encrypt), cipherFrameOffset(1, false)), 1024),
+            CryptoError, "unable to authenticate frame 0-0");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("error on truncated frame");
+
+        TEST_ERROR(
+            testCipherFrame(
+                cipherFrameNewP(cipherModeDecrypt, testPass),
+                bufNewC(bufPtrConst(encrypt), cipherFrameOffset(1, false) + CIPHER_FRAME_TAG_SIZE - 1), 1024),
+            CryptoError, "cipher frame truncated");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("error on modified data");
+
+        Buffer *const encryptModified = bufDup(encrypt);
+        bufPtr(encryptModified)[cipherFrameOffset(1, false) + 1000] ^= 1;
+
+        TEST_ERROR(
+            testCipherFrame(cipherFrameNewP(cipherModeDecrypt, testPass, .threadMax = 2), encryptModified, 1024), CryptoError,
+            "unable to authenticate frame 1-1");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("error on wrong passphrase");
+
+        TEST_ERROR(
+            testCipherFrame(cipherFrameNewP(cipherModeDecrypt, BUFSTRDEF("badpass")), encrypt, 1024), CryptoError,
+            "unable to authenticate frame 0-0");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("decrypt starting at a frame with the header read separately");
+
+        TEST_ASSIGN(
+            encrypt, testCipherFrame(cipherFrameNewP(cipherModeEncrypt, testPass, .raw = true), plainText, 4096), "encrypt raw");
+        TEST_RESULT_UINT(
+            bufUsed(encrypt), cipherFrameHeaderSize(true) + bufUsed(plainText) + 4 * CIPHER_FRAME_TAG_SIZE, "check size");
+
+        filter = cipherFrameNewP(
+            cipherModeDecrypt, testPass, .raw = true, .header = bufNewC(bufPtrConst(encrypt), cipherFrameHeaderSize(true)),
+            .frameIdx = 2);
+
+        TEST_ASSIGN(filter, cipherFrameNewPack(ioFilterParamList(filter)), "new filter from pack");
+        TEST_ASSIGN(
+            decrypt,
+            testCipherFrame(
+                filter,
+                bufNewC(bufPtrConst(encrypt) + cipherFrameOffset(2, true), bufUsed(encrypt) - cipherFrameOffset(2, true)), 4096),
+            "decrypt");
+        TEST_RESULT_BOOL(
+            bufEq(decrypt, bufNewC(bufPtrConst(plainText) + 2 * CIPHER_FRAME_SIZE, bufUsed(plainText) - 2 * CIPHER_FRAME_SIZE)),
+            true, "check plain text");
+
+        TEST_ERROR(
+            cipherFrameNewP(cipherModeDecrypt, testPass, .header = BUFSTRDEF("BOGUS!!!1234567890123456")), CryptoError,
+            "cipher header invalid");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("encrypt and decrypt zero bytes");
+
+        TEST_ASSIGN(encrypt, testCipherFrame(cipherFrameNewP(cipherModeEncrypt, testPass), bufNew(0), 1024), "encrypt");
+        TEST_RESULT_UINT(bufUsed(encrypt), cipherFrameHeaderSize(false) + CIPHER_FRAME_TAG_SIZE, "check size");
+
+        TEST_ASSIGN(decrypt, testCipherFrame(cipherFrameNewP(cipherModeDecrypt, testPass), encrypt, 1), "decrypt");
+        TEST_RESULT_UINT(bufUsed(decrypt), 0, "check size");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("error on invalid or missing header");
+
+        TEST_ERROR(
+            testCipherFrame(cipherFrameNewP(cipherModeDecrypt, testPass), BUFSTRDEF("BOGUS!!!1234567890123456"), 1024),
+            CryptoError, "cipher header invalid");
+        TEST_ERROR(
+            testCipherFrame(cipherFrameNewP(cipherModeDecrypt, testPass), BUFSTRDEF(CIPHER_BLOCK_MAGIC "1234567890123456"), 1024),
+            CryptoError, "cipher header invalid: data is encrypted with aes-256-cbc");
+        TEST_ERROR(
+            testCipherFrame(cipherFrameNewP(cipherModeDecrypt, testPass), BUFSTRDEF("PgBRgcm1"), 1024), CryptoError,
+            "cipher header missing");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("block cipher creates frame cipher for authenticated cipher type");
+
+        TEST_RESULT_UINT(
+            ioFilterType(cipherBlockNewP(cipherModeEncrypt, cipherTypeAes256Gcm, testPass)), CIPHER_FRAME_FILTER_TYPE,
+            "frame filter");
+        TEST_RESULT_UINT(
+            ioFilterType(
+                cipherBlockFilterPack(CIPHER_FRAME_FILTER_TYPE, ioFilterParamList(cipherFrameNewP(cipherModeEncrypt, testPass)))),
+            CIPHER_FRAME_FILTER_TYPE, "frame filter from pack");
+
+        filter = cipherBlockNewP(cipherModeEncrypt, cipherTypeAes256Cbc, testPass);
+
+        TEST_RESULT_UINT(
+            ioFilterType(cipherBlockFilterPack(CIPHER_BLOCK_FILTER_TYPE, ioFilterParamList(filter))), CIPHER_BLOCK_FILTER_TYPE,
+            "block filter from pack");
+    }
+
     // *****************************************************************************************************************************
     if (testBegin("CryptoHash"))
     {
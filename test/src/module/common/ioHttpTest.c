@@ -5,6 +5,7 @@ Test HTTP
 
 #include "common/io/fdRead.h"
 #include "common/io/fdWrite.h"
+#include "common/io/http/rangeRead.h"
 #include "common/io/socket/address.h"
 #include "common/io/socket/client.h"
 #include "common/io/tls/client.h"
@@ -18,6 +19,46 @@ HTTP user agent header
 #define TEST_USER_AGENT                                                                                                            \
     HTTP_HEADER_USER_AGENT ":" PROJECT_NAME "/" PROJECT_VERSION "\r\n"
 
+/***********************************************************************************************************************************
+Range read callbacks
+***********************************************************************************************************************************/
+static HttpRequest *
+testRangeRequest(void *const data, const uint64_t offset, const uint64_t size)
+{
+    FUNCTION_HARNESS_BEGIN();
+        FUNCTION_HARNESS_PARAM_P(VOID, data);
+        FUNCTION_HARNESS_PARAM(UINT64, offset);
+        FUNCTION_HARNESS_PARAM(UINT64, size);
+    FUNCTION_HARNESS_END();
+
+    HttpRequest *result;
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        const HttpHeader *const header = httpHeaderPutRange(httpHeaderNew(NULL), offset, VARUINT64(size));
+
+        MEM_CONTEXT_PRIOR_BEGIN()
+        {
+            result = httpRequestNewP(data, HTTP_VERB_GET_STR, STRDEF("/file"), .header = header);
+        }
+        MEM_CONTEXT_PRIOR_END();
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    FUNCTION_HARNESS_RETURN(HTTP_REQUEST, result);
+}
+
+static HttpResponse *
+testRangeResponse(void *const data, HttpRequest *const request)
+{
+    FUNCTION_HARNESS_BEGIN();
+        FUNCTION_HARNESS_PARAM_P(VOID, data);
+        FUNCTION_HARNESS_PARAM(HTTP_REQUEST, request);
+    FUNCTION_HARNESS_END();
+
+    FUNCTION_HARNESS_RETURN(HTTP_RESPONSE, httpRequestResponse(request, false));
+}
+
 /***********************************************************************************************************************************
 Test Run
 ***********************************************************************************************************************************/
@@ -979,5 +1020,260 @@ testRun(void)
         TEST_RESULT_PTR_NE(statToJson(), NULL, "check");
     }
 
+    // *****************************************************************************************************************************
+    if (testBegin("HttpRangeRead"))
+    {
+        char logBuf[STACK_TRACE_PARAM_MAX];
+
+        HRN_FORK_BEGIN()
+        {
+            const unsigned int testPort = hrnServerPortNext();
+
+            // Start HTTPS test server
+            HRN_FORK_CHILD_BEGIN(.prefix = "test server", .timeout = 5000)
+            {
+                TEST_RESULT_VOID(hrnServerRunP(HRN_FORK_CHILD_READ(), hrnServerProtocolTls, testPort), "http server");
+            }
+            HRN_FORK_CHILD_END();
+
+            HRN_FORK_PARENT_BEGIN()
+            {
+                IoWrite *http = hrnServerScriptBegin(HRN_FORK_PARENT_WRITE(0));
+                HttpClient *client = NULL;
+                HttpRangeRead *rangeRead = NULL;
+                Buffer *buffer = bufNew(3);
+                String *content = strNew();
+
+                TEST_ASSIGN(
+                    client,
+                    httpClientNew(
+                        tlsClientNewP(
+                            sckClientNew(hrnServerHost(), testPort, 5000, 5000), hrnServerHost(), 0, 0, TEST_IN_CONTAINER),
+                        5000),
+                    "new client");
+
+                // -----------------------------------------------------------------------------------------------------------------
+                TEST_TITLE("single request when ranged requests are disabled");
+
+                hrnServerScriptAccept(http);
+
+                hrnServerScriptExpectZ(http, "GET /file HTTP/1.1\r\n" TEST_USER_AGENT "\r\n");
+                hrnServerScriptReplyZ(http, "HTTP/1.1 200 OK\r\ncontent-length:10\r\n\r\n0123456789");
+
+                TEST_ASSIGN(
+                    rangeRead,
+                    httpRangeReadNewP(
+                        httpRequestResponse(httpRequestNewP(client, HTTP_VERB_GET_STR, STRDEF("/file")), false), .chunkSize = 4,
+                        .requestMax = 1),
+                    "new range read");
+                TEST_RESULT_UINT(httpRangeReadRead(rangeRead, bufNew(11)), 10, "read");
+                TEST_RESULT_BOOL(httpRangeReadEof(rangeRead), true, "eof");
+                TEST_RESULT_VOID(httpRangeReadFree(rangeRead), "free");
+
+                // -----------------------------------------------------------------------------------------------------------------
+                TEST_TITLE("single request when content size is unknown");
+
+                hrnServerScriptExpectZ(http, "GET /file HTTP/1.1\r\n" TEST_USER_AGENT "\r\n");
+                hrnServerScriptReplyZ(
+                    http, "HTTP/1.1 200 OK\r\nTransfer-Encoding:chunked\r\n\r\na\r\n0123456789\r\n0\r\n\r\n");
+
+                TEST_ASSIGN(
+                    rangeRead,
+                    httpRangeReadNewP(
+                        httpRequestResponse(httpRequestNewP(client, HTTP_VERB_GET_STR, STRDEF("/file")), false), .chunkSize = 4,
+                        .requestMax = 2, .requestCallback = testRangeRequest, .responseCallback = testRangeResponse,
+                        .callbackData = client),
+                    "new range read");
+                TEST_RESULT_UINT(httpRangeReadRead(rangeRead, bufNew(11)), 10, "read");
+                TEST_RESULT_BOOL(httpRangeReadEof(rangeRead), true, "eof");
+
+                // -----------------------------------------------------------------------------------------------------------------
+                TEST_TITLE("single request when content fits in one chunk");
+
+                hrnServerScriptExpectZ(http, "GET /file HTTP/1.1\r\n" TEST_USER_AGENT "\r\n");
+                hrnServerScriptReplyZ(http, "HTTP/1.1 200 OK\r\ncontent-length:4\r\n\r\n0123");
+
+                TEST_ASSIGN(
+                    rangeRead,
+                    httpRangeReadNewP(
+                        httpRequestResponse(httpRequestNewP(client, HTTP_VERB_GET_STR, STRDEF("/file")), false), .chunkSize = 4,
+                        .requestMax = 2, .requestCallback = testRangeRequest, .responseCallback = testRangeResponse,
+                        .callbackData = client),
+                    "new range read");
+                TEST_RESULT_UINT(httpRangeReadRead(rangeRead, bufNew(5)), 4, "read");
+                TEST_RESULT_BOOL(httpRangeReadEof(rangeRead), true, "eof");
+
+                // -----------------------------------------------------------------------------------------------------------------
+                TEST_TITLE("read in chunks");
+
+                // The first response has all the content but only the first chunk is read from it. The server closes each
+                // connection after replying so it only needs to track one connection at a time.
+                hrnServerScriptExpectZ(http, "GET /file HTTP/1.1\r\n" TEST_USER_AGENT "\r\n");
+                hrnServerScriptReplyZ(http, "HTTP/1.1 200 OK\r\ncontent-length:10\r\n\r\n0123456789");
+                hrnServerScriptClose(http);
+
+                hrnServerScriptAccept(http);
+                hrnServerScriptExpectZ(http, "GET /file HTTP/1.1\r\n" TEST_USER_AGENT "range:bytes=4-7\r\n\r\n");
+                hrnServerScriptReplyZ(http, "HTTP/1.1 206 Partial Content\r\nconnection:close\r\ncontent-length:4\r\n\r\n4567");
+                hrnServerScriptClose(http);
+
+                hrnServerScriptAccept(http);
+                hrnServerScriptExpectZ(http, "GET /file HTTP/1.1\r\n" TEST_USER_AGENT "range:bytes=8-9\r\n\r\n");
+                hrnServerScriptReplyZ(http, "HTTP/1.1 206 Partial Content\r\nconnection:close\r\ncontent-length:2\r\n\r\n89");
+                hrnServerScriptClose(http);
+
+                TEST_ASSIGN(
+                    rangeRead,
+                    httpRangeReadNewP(
+                        httpRequestResponse(httpRequestNewP(client, HTTP_VERB_GET_STR, STRDEF("/file")), false), .chunkSize = 4,
+                        .requestMax = 3, .requestCallback = testRangeRequest, .responseCallback = testRangeResponse,
+                        .callbackData = client),
+                    "new range read");
+                TEST_RESULT_VOID(
+                    FUNCTION_LOG_OBJECT_FORMAT(rangeRead, httpRangeReadToLog, logBuf, sizeof(logBuf)), "httpRangeReadToLog");
+                TEST_RESULT_Z(logBuf, "{range: true, size: 10, readOffset: 0, requestTotal: 2}", "check log");
+
+                do
+                {
+                    bufUsedZero(buffer);
+                    httpRangeReadRead(rangeRead, buffer);
+                    strCat(content, strNewBuf(buffer));
+                }
+                while (!httpRangeReadEof(rangeRead));
+
+                TEST_RESULT_STR_Z(content, "0123456789", "check content");
+
+                // -----------------------------------------------------------------------------------------------------------------
+                TEST_TITLE("rest of chunk is requested again after a read error");
+
+                // The content for 4-7 is cut short after the response has started, e.g. because the server timed out while the
+                // response was waiting to be read. The request for 8-9 was sent when the response for 4-7 was started so the rest
+                // of 4-7 is requested after it.
+                hrnServerScriptAccept(http);
+                hrnServerScriptExpectZ(http, "GET /file HTTP/1.1\r\n" TEST_USER_AGENT "\r\n");
+                hrnServerScriptReplyZ(http, "HTTP/1.1 200 OK\r\nconnection:close\r\ncontent-length:10\r\n\r\n0123456789");
+                hrnServerScriptClose(http);
+
+                hrnServerScriptAccept(http);
+                hrnServerScriptExpectZ(http, "GET /file HTTP/1.1\r\n" TEST_USER_AGENT "range:bytes=4-7\r\n\r\n");
+                hrnServerScriptReplyZ(http, "HTTP/1.1 206 Partial Content\r\nconnection:close\r\ncontent-length:4\r\n\r\n45");
+                hrnServerScriptSleep(http, 250);
+                hrnServerScriptClose(http);
+
+                hrnServerScriptAccept(http);
+                hrnServerScriptExpectZ(http, "GET /file HTTP/1.1\r\n" TEST_USER_AGENT "range:bytes=8-9\r\n\r\n");
+                hrnServerScriptReplyZ(http, "HTTP/1.1 206 Partial Content\r\nconnection:close\r\ncontent-length:2\r\n\r\n89");
+                hrnServerScriptClose(http);
+
+                hrnServerScriptAccept(http);
+                hrnServerScriptExpectZ(http, "GET /file HTTP/1.1\r\n" TEST_USER_AGENT "range:bytes=4-7\r\n\r\n");
+                hrnServerScriptReplyZ(http, "HTTP/1.1 206 Partial Content\r\nconnection:close\r\ncontent-length:4\r\n\r\n4567");
+                hrnServerScriptClose(http);
+
+                TEST_ASSIGN(
+                    rangeRead,
+                    httpRangeReadNewP(
+                        httpRequestResponse(httpRequestNewP(client, HTTP_VERB_GET_STR, STRDEF("/file")), false), .chunkSize = 4,
+                        .requestMax = 2, .requestCallback = testRangeRequest, .responseCallback = testRangeResponse,
+                        .callbackData = client),
+                    "new range read");
+
+                buffer = bufNew(10);
+
+                TEST_RESULT_UINT(httpRangeReadRead(rangeRead, buffer), 10, "read");
+                TEST_RESULT_STR_Z(strNewBuf(buffer), "0123456789", "check content");
+                TEST_RESULT_BOOL(httpRangeReadEof(rangeRead), true, "eof");
+
+                // -----------------------------------------------------------------------------------------------------------------
+                TEST_TITLE("error when chunk requested again also fails");
+
+                hrnServerScriptAccept(http);
+                hrnServerScriptExpectZ(http, "GET /file HTTP/1.1\r\n" TEST_USER_AGENT "\r\n");
+                hrnServerScriptReplyZ(http, "HTTP/1.1 200 OK\r\nconnection:close\r\ncontent-length:6\r\n\r\n012345");
+                hrnServerScriptClose(http);
+
+                hrnServerScriptAccept(http);
+                hrnServerScriptExpectZ(http, "GET /file HTTP/1.1\r\n" TEST_USER_AGENT "range:bytes=4-5\r\n\r\n");
+                hrnServerScriptReplyZ(http, "HTTP/1.1 206 Partial Content\r\nconnection:close\r\ncontent-length:2\r\n\r\n4");
+                hrnServerScriptSleep(http, 250);
+                hrnServerScriptClose(http);
+
+                hrnServerScriptAccept(http);
+                hrnServerScriptExpectZ(http, "GET /file HTTP/1.1\r\n" TEST_USER_AGENT "range:bytes=4-5\r\n\r\n");
+                hrnServerScriptReplyZ(http, "HTTP/1.1 206 Partial Content\r\nconnection:close\r\ncontent-length:2\r\n\r\n4");
+                hrnServerScriptSleep(http, 250);
+                hrnServerScriptClose(http);
+
+                TEST_ASSIGN(
+                    rangeRead,
+                    httpRangeReadNewP(
+                        httpRequestResponse(httpRequestNewP(client, HTTP_VERB_GET_STR, STRDEF("/file")), false), .chunkSize = 4,
+                        .requestMax = 2, .requestCallback = testRangeRequest, .responseCallback = testRangeResponse,
+                        .callbackData = client),
+                    "new range read");
+                TEST_RESULT_UINT(httpRangeReadRead(rangeRead, bufNew(4)), 4, "read first chunk");
+                TEST_ERROR(httpRangeReadRead(rangeRead, bufNew(4)), FileReadError, "unexpected EOF reading HTTP content");
+
+                // -----------------------------------------------------------------------------------------------------------------
+                TEST_TITLE("range response has the wrong size");
+
+                hrnServerScriptAccept(http);
+                hrnServerScriptExpectZ(http, "GET /file HTTP/1.1\r\n" TEST_USER_AGENT "\r\n");
+                hrnServerScriptReplyZ(http, "HTTP/1.1 200 OK\r\ncontent-length:6\r\n\r\n012345");
+                hrnServerScriptClose(http);
+
+                hrnServerScriptAccept(http);
+                hrnServerScriptExpectZ(http, "GET /file HTTP/1.1\r\n" TEST_USER_AGENT "range:bytes=4-5\r\n\r\n");
+                hrnServerScriptReplyZ(http, "HTTP/1.1 200 OK\r\nconnection:close\r\ncontent-length:6\r\n\r\n012345");
+                hrnServerScriptClose(http);
+
+                TEST_ASSIGN(
+                    rangeRead,
+                    httpRangeReadNewP(
+                        httpRequestResponse(httpRequestNewP(client, HTTP_VERB_GET_STR, STRDEF("/file")), false), .chunkSize = 4,
+                        .requestMax = 2, .requestCallback = testRangeRequest, .responseCallback = testRangeResponse,
+                        .callbackData = client),
+                    "new range read");
+                TEST_RESULT_UINT(httpRangeReadRead(rangeRead, bufNew(4)), 4, "read first chunk");
+                TEST_ERROR(
+                    httpRangeReadRead(rangeRead, bufNew(4)), ProtocolError, "expected range response content size 2 but got 6");
+
+                // -----------------------------------------------------------------------------------------------------------------
+                TEST_TITLE("range response size is unknown");
+
+                hrnServerScriptAccept(http);
+                hrnServerScriptExpectZ(http, "GET /file HTTP/1.1\r\n" TEST_USER_AGENT "\r\n");
+                hrnServerScriptReplyZ(http, "HTTP/1.1 200 OK\r\ncontent-length:6\r\n\r\n012345");
+                hrnServerScriptClose(http);
+
+                hrnServerScriptAccept(http);
+                hrnServerScriptExpectZ(http, "GET /file HTTP/1.1\r\n" TEST_USER_AGENT "range:bytes=4-5\r\n\r\n");
+                hrnServerScriptReplyZ(
+                    http,
+                    "HTTP/1.1 206 Partial Content\r\nconnection:close\r\nTransfer-Encoding:chunked\r\n\r\n"
+                    "2\r\n45\r\n0\r\n\r\n");
+                hrnServerScriptClose(http);
+
+                TEST_ASSIGN(
+                    rangeRead,
+                    httpRangeReadNewP(
+                        httpRequestResponse(httpRequestNewP(client, HTTP_VERB_GET_STR, STRDEF("/file")), false), .chunkSize = 4,
+                        .requestMax = 2, .requestCallback = testRangeRequest, .responseCallback = testRangeResponse,
+                        .callbackData = client),
+                    "new range read");
+                TEST_ERROR(
+                    httpRangeReadRead(rangeRead, bufNew(6)), ProtocolError,
+                    "expected range response content size 2 but got unknown");
+
+                // -----------------------------------------------------------------------------------------------------------------
+                TEST_TITLE("end server process");
+
+                hrnServerScriptEnd(http);
+            }
+            HRN_FORK_PARENT_END();
+        }
+        HRN_FORK_END();
+    }
+
     FUNCTION_HARNESS_RETURN_VOID();
 }
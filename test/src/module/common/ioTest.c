@@ -3,6 +3,7 @@ Test IO
 ***********************************************************************************************************************************/
 #include <fcntl.h>
 #include <netdb.h>
+#include <unistd.h>
 
 #include "common/type/json.h"
 
@@ -248,7 +249,7 @@ testRun(void)
     FUNCTION_HARNESS_VOID();
 
     // *****************************************************************************************************************************
-    if (testBegin("ioBufferSize()/ioBufferSizeSet() and ioTimeoutMs()/ioTimeoutMsSet()"))
+    if (testBegin("ioBufferSize()/ioBufferSizeSet(), ioTimeoutMs()/ioTimeoutMsSet(), and ioThread()/ioThreadSet()"))
     {
         TEST_RESULT_UINT(ioBufferSize(), 65536, "check initial buffer size");
         TEST_RESULT_VOID(ioBufferSizeSet(16384), "set buffer size");
@@ -257,6 +258,10 @@ testRun(void)
         TEST_RESULT_UINT(ioTimeoutMs(), 60000, "check initial timeout ms");
         TEST_RESULT_VOID(ioTimeoutMsSet(77777), "set timeout ms");
         TEST_RESULT_UINT(ioTimeoutMs(), 77777, "check timeout ms");
+
+        TEST_RESULT_BOOL(ioThread(), false, "check initial thread");
+        TEST_RESULT_VOID(ioThreadSet(true), "set thread");
+        TEST_RESULT_BOOL(ioThread(), true, "check thread");
     }
 
     // *****************************************************************************************************************************
@@ -439,6 +444,8 @@ testRun(void)
         read = ioBufferReadNewOpen(BUFSTRDEF("AAAAAA123\n1234\n\n12\nBDDDEFF"));
         buffer = bufNew(6);
 
+        TEST_RESULT_BOOL(ioReadBuffered(read), false, "nothing buffered before first read");
+
         // Start with a small read
         TEST_RESULT_UINT(ioReadSmall(read, buffer), 6, "read buffer");
         TEST_RESULT_STR_Z(strNewBuf(buffer), "AAAAAA", "    check buffer");
@@ -450,12 +457,14 @@ testRun(void)
         TEST_RESULT_STR_Z(ioReadLine(read), "1234", "read line");
         TEST_RESULT_STR_Z(ioReadLine(read), "", "read line");
         TEST_RESULT_STR_Z(ioReadLine(read), "12", "read line");
+        TEST_RESULT_BOOL(ioReadBuffered(read), true, "bytes left in the line buffer");
 
         // Read what was left in the line buffer
         TEST_RESULT_UINT(ioRead(read, buffer), 0, "read buffer");
         bufUsedSet(buffer, 2);
         TEST_RESULT_UINT(ioReadSmall(read, buffer), 1, "read buffer");
         TEST_RESULT_STR_Z(strNewBuf(buffer), "AAB", "    check buffer");
+        TEST_RESULT_BOOL(ioReadBuffered(read), false, "nothing buffered");
         bufUsedSet(buffer, 0);
 
         // Now do a full buffer read from the input
@@ -809,5 +818,79 @@ testRun(void)
         TEST_RESULT_STR_Z(strNewBuf(output), "E", "check");
     }
 
+    // *****************************************************************************************************************************
+    if (testBegin("IoEvent"))
+    {
+        int pipeA[2];
+        int pipeB[2];
+        THROW_ON_SYS_ERROR(pipe(pipeA) == -1, KernelError, "unable to create pipe");
+        THROW_ON_SYS_ERROR(pipe(pipeB) == -1, KernelError, "unable to create pipe");
+
+        // Run the same tests with epoll() and poll()
+        for (unsigned int epollIdx = 0; epollIdx < 2; epollIdx++)
+        {
+            const bool epoll = epollIdx == 0;
+
+            // -------------------------------------------------------------------------------------------------------------------------
+            TEST_TITLE_FMT("wait with %s", epoll ? "epoll" : "poll");
+
+            IoEvent *event = NULL;
+            TEST_ASSIGN(event, ioEventNew(), "new event");
+            event->epoll = epoll;
+
+            TEST_RESULT_UINT(ioEventWait(event, 0), 0, "nothing to wait on");
+
+            TEST_RESULT_VOID(ioEventAdd(event, pipeA[0], 7), "add a");
+            TEST_RESULT_VOID(ioEventAdd(event, pipeB[0], 3), "add b");
+            TEST_RESULT_UINT(ioEventFdTotal(event), 2, "fd total");
+            TEST_RESULT_UINT(ioEventWait(event, 50), 0, "timeout");
+
+            TEST_RESULT_INT(write(pipeB[1], "b", 1), 1, "write b");
+            TEST_RESULT_UINT(ioEventWait(event, 1000), 1, "b is ready");
+            TEST_RESULT_UINT(ioEventReadyId(event, 0), 3, "b id");
+
+            TEST_RESULT_INT(write(pipeA[1], "a", 1), 1, "write a");
+            TEST_RESULT_UINT(ioEventWait(event, 1000), 2, "a and b are ready");
+
+            TEST_RESULT_VOID(ioEventRemove(event, pipeB[0]), "remove b");
+            TEST_RESULT_UINT(ioEventFdTotal(event), 1, "fd total");
+            TEST_RESULT_UINT(ioEventWait(event, 1000), 1, "a is ready");
+            TEST_RESULT_UINT(ioEventReadyId(event, 0), 7, "a id");
+
+            // Clear pipes for the next test
+            char readBuffer[1];
+            TEST_RESULT_INT(read(pipeA[0], readBuffer, 1), 1, "read a");
+            TEST_RESULT_INT(read(pipeB[0], readBuffer, 1), 1, "read b");
+
+            TEST_RESULT_VOID(ioEventFree(event), "free event");
+        }
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("errors");
+
+        IoEvent *event = ioEventNew();
+
+        TEST_ERROR(ioEventAdd(event, 999, 0), KernelError, "unable to add fd 999 to epoll: [9] Bad file descriptor");
+        TEST_ERROR_FMT(
+            ioEventRemove(event, pipeA[0]), KernelError, "unable to remove fd %d from epoll: [2] No such file or directory",
+            pipeA[0]);
+
+        event->epoll = false;
+        TEST_ERROR_FMT(ioEventRemove(event, pipeA[0]), AssertError, "unable to find fd %d", pipeA[0]);
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("log");
+
+        char logBuf[STACK_TRACE_PARAM_MAX];
+
+        TEST_RESULT_VOID(FUNCTION_LOG_OBJECT_FORMAT(event, ioEventToLog, logBuf, sizeof(logBuf)), "log");
+        TEST_RESULT_Z(logBuf, "{type: poll, fdTotal: 0, readyTotal: 0}", "check log");
+
+        close(pipeA[0]);
+        close(pipeA[1]);
+        close(pipeB[0]);
+        close(pipeB[1]);
+    }
+
     FUNCTION_HARNESS_RETURN_VOID();
 }
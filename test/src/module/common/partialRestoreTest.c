@@ -133,6 +133,14 @@ testRun(void)
         StringList *const argList = strLstDup(argListCommon);
         hrnCfgArgRawZ(argList, cfgOptFilter, TEST_PATH "/recovery_filter.json");
         HRN_CFG_LOAD(cfgCmdRestore, argList);
+
+        // The filter list is loaded on the first call and must outlive the context of the caller
+        MEM_CONTEXT_TEMP_BEGIN()
+        {
+            TEST_RESULT_BOOL(isRelationNeeded(20000, 1601, 16385), true, "load filter in temp context");
+        }
+        MEM_CONTEXT_TEMP_END();
+
         TEST_RESULT_BOOL(isRelationNeeded(5, 1663, 1259), true, "always true for system DB and system table");
         TEST_RESULT_BOOL(isRelationNeeded(20002, 1600, 1259), true, "system table from DB which exists in JSON");
         TEST_RESULT_BOOL(isRelationNeeded(20005, 1600, 16384), false, "user DB doesn't exist in JSON");
@@ -140,4 +148,60 @@ testRun(void)
         TEST_RESULT_BOOL(isRelationNeeded(5, 1600,  16394), false, "user table from system DB doesn't exist in JSON");
         TEST_RESULT_BOOL(isRelationNeeded(20002, 1600,  16394), false, "user table from user DB doesn't exist in JSON");
     }
+
+    if (testBegin("filterSetBuild()"))
+    {
+        TEST_TITLE("sizes keep half of the slots empty");
+        TEST_RESULT_UINT(filterSetSize(0), 8, "minimum");
+        TEST_RESULT_UINT(filterSetSize(4), 8, "exactly half");
+        TEST_RESULT_UINT(filterSetSize(5), 16, "more than half");
+        TEST_RESULT_UINT(filterSetSize(50000), 131072, "large filter");
+
+        TEST_TITLE("build sets with collisions and duplicates");
+        // Database 20000 is listed twice and the second entry repeats a table of the first. Sequential relfilenodes in the same
+        // database and tablespace are the usual case, so there are plenty of them to make sure probing wraps around the set.
+        String *const json = strCatZ(strNew(), "[{\"dbOid\": 20000, \"tables\": [");
+
+        for (unsigned int relNode = 16384; relNode < 17384; relNode++)
+            strCatFmt(json, "%s{\"relfilenode\": %u}", relNode == 16384 ? "" : ",", relNode);
+
+        strCatZ(
+            json,
+            "]}, {\"dbOid\": 20001, \"tables\": [{\"relfilenode\": 16384, \"tablespace\": 1700}]},"
+            " {\"dbOid\": 20000, \"tables\": [{\"relfilenode\": 16384}, {\"relfilenode\": 20000, \"tablespace\": 1700}]}]");
+
+        TEST_RESULT_VOID(filterSetBuild(buildFilterList(jsonReadNew(json))), "build sets");
+        TEST_RESULT_UINT(partialRestoreLocal.dbMask, 7, "database slots");
+        TEST_RESULT_UINT(partialRestoreLocal.relationMask, 2047, "relation slots");
+
+        unsigned int dbTotal = 0;
+
+        for (unsigned int slot = 0; slot <= partialRestoreLocal.dbMask; slot++)
+            dbTotal += partialRestoreLocal.dbList[slot] != 0;
+
+        TEST_RESULT_UINT(dbTotal, 2, "duplicate database stored once");
+
+        unsigned int relationTotal = 0;
+
+        for (unsigned int slot = 0; slot <= partialRestoreLocal.relationMask; slot++)
+            relationTotal += partialRestoreLocal.relationList[slot].relNode != 0;
+
+        TEST_RESULT_UINT(relationTotal, 1002, "duplicate table stored once");
+
+        TEST_TITLE("lookup");
+        TEST_RESULT_BOOL(filterSetDbExists(20000), true, "database exists");
+        TEST_RESULT_BOOL(filterSetDbExists(20001), true, "database exists");
+        TEST_RESULT_BOOL(filterSetDbExists(20002), false, "database does not exist");
+
+        unsigned int foundTotal = 0;
+
+        for (unsigned int relNode = 16000; relNode < 18000; relNode++)
+            foundTotal += filterSetRelationExists(20000, DEFAULTTABLESPACE_OID, relNode);
+
+        TEST_RESULT_UINT(foundTotal, 1000, "all tables of a range found");
+        TEST_RESULT_BOOL(filterSetRelationExists(20000, 1700, 20000), true, "table from second entry of database");
+        TEST_RESULT_BOOL(filterSetRelationExists(20000, 1700, 16384), false, "table in another tablespace");
+        TEST_RESULT_BOOL(filterSetRelationExists(20001, 1700, 16384), true, "table of another database");
+        TEST_RESULT_BOOL(filterSetRelationExists(20001, 1700, 16385), false, "table does not exist");
+    }
 }
@@ -0,0 +1,137 @@
+/***********************************************************************************************************************************
+Test Worker Threads
+***********************************************************************************************************************************/
+#include <signal.h>
+
+/***********************************************************************************************************************************
+Test job
+***********************************************************************************************************************************/
+typedef struct TestThreadJob
+{
+    unsigned int value;                                             // Value to double
+    unsigned int result;                                            // Doubled value
+    pthread_t thread;                                               // Thread the job ran on
+    bool signalBlocked;                                             // Was SIGTERM blocked on the thread?
+} TestThreadJob;
+
+static void *
+testThreadJob(void *const param)
+{
+    TestThreadJob *const job = param;
+    sigset_t signalMask;
+
+    pthread_sigmask(SIG_SETMASK, NULL, &signalMask);
+
+    job->result = job->value * 2;
+    job->thread = pthread_self();
+    job->signalBlocked = sigismember(&signalMask, SIGTERM) == 1;
+
+    return NULL;
+}
+
+/***********************************************************************************************************************************
+Test Run
+***********************************************************************************************************************************/
+static void
+testRun(void)
+{
+    FUNCTION_HARNESS_VOID();
+
+    // *****************************************************************************************************************************
+    if (testBegin("threadCreate() and threadJobRun()"))
+    {
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("create thread with signals blocked");
+
+        TestThreadJob job = {.value = 1};
+        pthread_t thread;
+
+        TEST_RESULT_INT(threadCreate(&thread, testThreadJob, &job), 0, "create thread");
+        TEST_RESULT_INT(pthread_join(thread, NULL), 0, "join thread");
+        TEST_RESULT_UINT(job.result, 2, "check result");
+        TEST_RESULT_BOOL(pthread_equal(job.thread, pthread_self()) != 0, false, "check worker thread");
+        TEST_RESULT_BOOL(job.signalBlocked, true, "check signal blocked on worker thread");
+
+        sigset_t signalMask;
+
+        pthread_sigmask(SIG_SETMASK, NULL, &signalMask);
+        TEST_RESULT_BOOL(sigismember(&signalMask, SIGTERM) == 1, false, "check signal not blocked on calling thread");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("run single job on calling thread");
+
+        job = (TestThreadJob){.value = 2};
+
+        TEST_RESULT_VOID(threadJobRun(testThreadJob, &job, sizeof(TestThreadJob), 1), "run job");
+        TEST_RESULT_UINT(job.result, 4, "check result");
+        TEST_RESULT_BOOL(pthread_equal(job.thread, pthread_self()) != 0, true, "check calling thread");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("run multiple jobs on worker threads");
+
+        TestThreadJob jobList[] = {{.value = 3}, {.value = 4}, {.value = 5}};
+
+        TEST_RESULT_VOID(threadJobRun(testThreadJob, jobList, sizeof(TestThreadJob), LENGTH_OF(jobList)), "run jobs");
+        TEST_RESULT_UINT(jobList[0].result, 6, "check result");
+        TEST_RESULT_UINT(jobList[1].result, 8, "check result");
+        TEST_RESULT_UINT(jobList[2].result, 10, "check result");
+        TEST_RESULT_BOOL(pthread_equal(jobList[0].thread, pthread_self()) != 0, true, "first job on calling thread");
+        TEST_RESULT_BOOL(pthread_equal(jobList[1].thread, pthread_self()) != 0, false, "second job on worker thread");
+        TEST_RESULT_BOOL(jobList[1].signalBlocked, true, "check signal blocked on worker thread");
+        TEST_RESULT_BOOL(pthread_equal(jobList[2].thread, pthread_self()) != 0, false, "third job on worker thread");
+    }
+
+    // *****************************************************************************************************************************
+    if (testBegin("ThreadPool"))
+    {
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("run job lists on the same workers");
+
+        ThreadPool *pool = NULL;
+
+        TEST_ASSIGN(pool, threadPoolNew(3), "new pool");
+        TEST_RESULT_UINT(pool->threadTotal, 2, "check workers");
+
+        TestThreadJob jobList[] = {{.value = 1}, {.value = 2}, {.value = 3}, {.value = 4}, {.value = 5}};
+
+        TEST_RESULT_VOID(threadPoolRun(pool, testThreadJob, jobList, sizeof(TestThreadJob), LENGTH_OF(jobList)), "run jobs");
+
+        for (unsigned int jobIdx = 0; jobIdx < LENGTH_OF(jobList); jobIdx++)
+        {
+            TEST_RESULT_UINT(jobList[jobIdx].result, jobList[jobIdx].value * 2, "check result");
+
+            // Jobs run on the calling thread or on a worker of the pool
+            TEST_RESULT_BOOL(
+                pthread_equal(jobList[jobIdx].thread, pthread_self()) != 0 ||
+                    pthread_equal(jobList[jobIdx].thread, pool->threadList[0]) != 0 ||
+                    pthread_equal(jobList[jobIdx].thread, pool->threadList[1]) != 0,
+                true, "check thread");
+        }
+
+        jobList[0] = (TestThreadJob){.value = 6};
+
+        TEST_RESULT_VOID(threadPoolRun(pool, testThreadJob, jobList, sizeof(TestThreadJob), 1), "run job again");
+        TEST_RESULT_UINT(jobList[0].result, 12, "check result");
+
+        char buffer[STACK_TRACE_PARAM_MAX];
+
+        TEST_RESULT_VOID(FUNCTION_LOG_OBJECT_FORMAT(pool, threadPoolToLog, buffer, sizeof(buffer)), "threadPoolToLog");
+        TEST_RESULT_Z(buffer, "{threadTotal: 2}", "check log");
+        TEST_RESULT_VOID(threadPoolFree(pool), "free pool");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("pool without workers runs jobs on the calling thread");
+
+        TEST_ASSIGN(pool, threadPoolNew(1), "new pool");
+        TEST_RESULT_UINT(pool->threadTotal, 0, "check workers");
+
+        jobList[0] = (TestThreadJob){.value = 7};
+
+        TEST_RESULT_VOID(threadPoolRun(pool, testThreadJob, jobList, sizeof(TestThreadJob), 1), "run job");
+        TEST_RESULT_UINT(jobList[0].result, 14, "check result");
+        TEST_RESULT_BOOL(pthread_equal(jobList[0].thread, pthread_self()) != 0, true, "check calling thread");
+        TEST_RESULT_VOID(threadPoolFree(pool), "free pool");
+    }
+
+    FUNCTION_HARNESS_RETURN_VOID();
+}
@@ -18,6 +18,18 @@ Test wal filter
 #include "postgres/interface/crc32.h"
 #include "storage/posix/storage.h"
 
+/***********************************************************************************************************************************
+Test data
+***********************************************************************************************************************************/
+#define TEST_WAL_FILE_1                                                                                                            \
+    "000000010000000000000001-abcdabcdabcdabcdabcdabcdabcdabcdabcdabcd"
+#define TEST_WAL_FILE_2                                                                                                            \
+    "000000010000000000000002-abcdabcdabcdabcdabcdabcdabcdabcdabcdabcd"
+#define TEST_WAL_FILE_3                                                                                                            \
+    "000000010000000000000003-abcdabcdabcdabcdabcdabcdabcdabcdabcdabcd"
+#define TEST_CHECKSUM                                               "abcdabcdabcdabcdabcdabcdabcdabcdabcdabcd"
+#define TEST_FRAGMENT_PATH                                          STORAGE_SPOOL_ARCHIVE "/fragment"
+
 typedef enum WalFlags
 {
     NO_SWITCH_WAL = 1 << 0, // Do not add a switch wal record at the end of the WAL.
@@ -97,6 +109,33 @@ fillLastPage(Buffer *wal, PgPageSize pageSize)
     bufUsedInc(wal, toWrite);
 }
 
+// Run a checksum job on a range of pages and return the total checksums
+static unsigned int
+testCrcJob(const Buffer *wal, unsigned int pageTotal, unsigned int pageBegin, unsigned int pageEnd, WalFilterCrc *crcList)
+{
+    WalFilterCrcJob job =
+    {
+        .input = bufPtrConst(wal),
+        .inputSize = pageTotal * DEFAULT_GDPB_XLOG_PAGE_SIZE,
+        .pageBegin = pageBegin * DEFAULT_GDPB_XLOG_PAGE_SIZE,
+        .pageEnd = pageEnd * DEFAULT_GDPB_XLOG_PAGE_SIZE,
+        .walPageSize = DEFAULT_GDPB_XLOG_PAGE_SIZE,
+        .pageMagic = GPDB6_XLOG_PAGE_HEADER_MAGIC,
+        .crcList = crcList,
+    };
+
+    walFilterCrcJob(&job);
+
+    return job.crcTotal;
+}
+
+// Checksum of a record after the header
+static pg_crc32
+testBodyCrc(const XLogRecord *record)
+{
+    return crc32cComp(crc32cInit(), XLogRecGetData(record), record->xl_tot_len - SizeOfXLogRecord);
+}
+
 static void
 testGetRelfilenode(uint8_t rmid, uint8_t info, bool expect_not_skip)
 {
@@ -1988,5 +2027,434 @@ testRun(void)
             VersionNotSupportedError, "WAL filtering is unsupported for this Postgres version");
     }
 
+    if (testBegin("cache record fragments in the spool"))
+    {
+        StringList *argBaseList = strLstNew();
+        hrnCfgArgRawZ(argBaseList, cfgOptFork, CFGOPTVAL_FORK_GPDB_Z);
+        hrnCfgArgRawZ(argBaseList, cfgOptPgPath, TEST_PATH "/pg");
+        hrnCfgArgRawZ(argBaseList, cfgOptRepoPath, TEST_PATH "/repo");
+        hrnCfgArgRawZ(argBaseList, cfgOptStanza, "test1");
+        hrnCfgArgRawBool(argBaseList, cfgOptArchiveAsync, true);
+        hrnCfgArgRawZ(argBaseList, cfgOptSpoolPath, TEST_PATH "/spool");
+        HRN_CFG_LOAD(cfgCmdArchiveGet, argBaseList);
+
+        const PgControl pgControl = {
+            .version = PG_VERSION_94,
+            .pageSize = DEFAULT_GDPB_PAGE_SIZE,
+            .walPageSize = DEFAULT_GDPB_XLOG_PAGE_SIZE,
+            .walSegmentSize = GPDB6_XLOG_SEG_SIZE
+        };
+
+        const ArchiveGetFile archiveInfo1 = {
+            .file = STRDEF("9.4-1/0000000100000000/" TEST_WAL_FILE_1),
+            .repoIdx = 0,
+            .archiveId = STRDEF("9.4-1"),
+            .cipherType = cipherTypeNone,
+            .cipherPassArchive = STRDEF("")
+        };
+
+        const ArchiveGetFile archiveInfo2 = {
+            .file = STRDEF("9.4-1/0000000100000000/" TEST_WAL_FILE_2),
+            .repoIdx = 0,
+            .archiveId = STRDEF("9.4-1"),
+            .cipherType = cipherTypeNone,
+            .cipherPassArchive = STRDEF("")
+        };
+
+        // The last record of the first segment ends in the second segment
+        Buffer *const wal1 = bufNew(DEFAULT_GDPB_XLOG_PAGE_SIZE);
+        record = hrnGpdbCreateXRecordP(
+            RM_XLOG_ID, XLOG_NOOP, DEFAULT_GDPB_XLOG_PAGE_SIZE - SizeOfXLogLongPHD - SizeOfXLogRecord - SizeOfXLogRecord, NULL);
+        hrnGpdbWalInsertXRecordP(wal1, record, NO_FLAGS, .segno = 1);
+        record = hrnGpdbCreateXRecordP(RM_XLOG_ID, XLOG_NOOP, 100, NULL);
+        hrnGpdbWalInsertXRecordP(wal1, record, INCOMPLETE_RECORD, .segno = 1);
+        fillLastPage(wal1, DEFAULT_GDPB_XLOG_PAGE_SIZE);
+
+        Buffer *const wal2 = bufNew(DEFAULT_GDPB_XLOG_PAGE_SIZE);
+        record = hrnGpdbCreateXRecordP(RM_XLOG_ID, XLOG_NOOP, 100, NULL);
+        hrnGpdbWalInsertXRecordP(wal2, record, NO_FLAGS, .segno = 2, .beginOffset = 100);
+        record = hrnGpdbCreateXRecordP(0, XLOG_SWITCH, 0, NULL);
+        hrnGpdbWalInsertXRecordP(wal2, record, NO_FLAGS, .segno = 2);
+        fillLastPage(wal2, DEFAULT_GDPB_XLOG_PAGE_SIZE);
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("read begin from prev file in the repo and cache head");
+
+        HRN_STORAGE_PUT(storageRepoWrite(), STORAGE_REPO_ARCHIVE "/9.4-1/0000000100000000/" TEST_WAL_FILE_1, wal1);
+
+        filter = walFilterNew(pgControl, &archiveInfo2);
+        result = testFilter(filter, wal2, bufSize(wal2), bufSize(wal2));
+        TEST_RESULT_BOOL(bufEq(wal2, result), true, "WAL not the same");
+
+        TEST_STORAGE_LIST(storageSpool(), TEST_FRAGMENT_PATH, TEST_WAL_FILE_2 ".head\n");
+        TEST_RESULT_BOOL(
+            bufEq(storageGetP(storageNewReadP(storageSpool(), STRDEF(TEST_FRAGMENT_PATH "/" TEST_WAL_FILE_2 ".head"))), wal2),
+            true, "head is the first page");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("read end from head in the spool and cache tail");
+
+        // The cached listing does not have the next file so the repo is listed again, but the file is not read
+        HRN_STORAGE_PUT_Z(storageRepoWrite(), STORAGE_REPO_ARCHIVE "/9.4-1/0000000100000000/" TEST_WAL_FILE_2, "BOGUS");
+
+        filter = walFilterNew(pgControl, &archiveInfo1);
+        result = testFilter(filter, wal1, bufSize(wal1), bufSize(wal1));
+        TEST_RESULT_BOOL(bufEq(wal1, result), true, "WAL not the same");
+
+        TEST_STORAGE_LIST(storageSpool(), TEST_FRAGMENT_PATH, TEST_WAL_FILE_1 ".tail\n" TEST_WAL_FILE_2 ".head\n");
+        TEST_RESULT_BOOL(
+            bufEq(storageGetP(storageNewReadP(storageSpool(), STRDEF(TEST_FRAGMENT_PATH "/" TEST_WAL_FILE_1 ".tail"))), wal1),
+            true, "tail starts from the page of the last record");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("read begin from tail in the spool");
+
+        // The cached listing has the prev file so the repo is not listed and the file is not read
+        HRN_STORAGE_REMOVE(storageRepoWrite(), STORAGE_REPO_ARCHIVE "/9.4-1/0000000100000000/" TEST_WAL_FILE_1);
+
+        filter = walFilterNew(pgControl, &archiveInfo2);
+        result = testFilter(filter, wal2, bufSize(wal2), bufSize(wal2));
+        TEST_RESULT_BOOL(bufEq(wal2, result), true, "WAL not the same");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("head does not complete the record");
+
+        Buffer *const walLong1 = bufNew(DEFAULT_GDPB_XLOG_PAGE_SIZE);
+        record = hrnGpdbCreateXRecordP(
+            RM_XLOG_ID, XLOG_NOOP, DEFAULT_GDPB_XLOG_PAGE_SIZE - SizeOfXLogLongPHD - SizeOfXLogRecord - SizeOfXLogRecord, NULL);
+        hrnGpdbWalInsertXRecordP(walLong1, record, NO_FLAGS, .segno = 1);
+        XLogRecord *const recordLong = hrnGpdbCreateXRecordP(RM_XLOG_ID, XLOG_NOOP, DEFAULT_GDPB_XLOG_PAGE_SIZE, NULL);
+        hrnGpdbWalInsertXRecordP(walLong1, recordLong, INCOMPLETE_RECORD, .segno = 1);
+
+        Buffer *const walLong2 = bufNew(DEFAULT_GDPB_XLOG_PAGE_SIZE * 2);
+        hrnGpdbWalInsertXRecordP(walLong2, recordLong, NO_FLAGS, .segno = 2, .beginOffset = DEFAULT_GDPB_XLOG_PAGE_SIZE);
+        bufUsedSet(walLong2, DEFAULT_GDPB_XLOG_PAGE_SIZE);
+
+        HRN_STORAGE_PUT(storageSpoolWrite(), TEST_FRAGMENT_PATH "/" TEST_WAL_FILE_2 ".head", walLong2);
+
+        filter = walFilterNew(pgControl, &archiveInfo1);
+        TEST_ERROR(
+            testFilter(filter, walLong1, bufSize(walLong1), bufSize(walLong1)), FormatError, "0/4007fe0 - Unexpected WAL end");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("invalid fragment");
+
+        HRN_STORAGE_PUT_Z(storageSpoolWrite(), TEST_FRAGMENT_PATH "/" TEST_WAL_FILE_1 ".tail", "BOGUS");
+
+        filter = walFilterNew(pgControl, &archiveInfo2);
+        TEST_ERROR(
+            testFilter(filter, wal2, bufSize(wal2), bufSize(wal2)), FormatError,
+            "invalid WAL fragment '" TEST_WAL_FILE_1 ".tail' size 5");
+
+        HRN_STORAGE_PUT_EMPTY(storageSpoolWrite(), TEST_FRAGMENT_PATH "/" TEST_WAL_FILE_1 ".tail");
+
+        filter = walFilterNew(pgControl, &archiveInfo2);
+        TEST_ERROR(
+            testFilter(filter, wal2, bufSize(wal2), bufSize(wal2)), FormatError,
+            "invalid WAL fragment '" TEST_WAL_FILE_1 ".tail' size 0");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("no tail when the last record ends on the page boundary");
+
+        const ArchiveGetFile archiveInfo3 = {
+            .file = STRDEF("9.4-2/0000000100000000/" TEST_WAL_FILE_3),
+            .repoIdx = 0,
+            .archiveId = STRDEF("9.4-2"),
+            .cipherType = cipherTypeNone,
+            .cipherPassArchive = STRDEF("")
+        };
+
+        Buffer *const wal3 = bufNew(DEFAULT_GDPB_XLOG_PAGE_SIZE * 4);
+        record = hrnGpdbCreateXRecordP(
+            RM_XLOG_ID, XLOG_NOOP, DEFAULT_GDPB_XLOG_PAGE_SIZE - SizeOfXLogLongPHD - SizeOfXLogRecord, NULL);
+        hrnGpdbWalInsertXRecordP(wal3, record, NO_FLAGS, .segno = 3);
+
+        filter = walFilterNew(pgControl, &archiveInfo3);
+        result = testFilter(filter, wal3, DEFAULT_GDPB_XLOG_PAGE_SIZE, DEFAULT_GDPB_XLOG_PAGE_SIZE);
+        TEST_RESULT_BOOL(bufEq(wal3, result), true, "WAL not the same");
+
+        TEST_STORAGE_LIST(
+            storageSpool(), TEST_FRAGMENT_PATH, TEST_WAL_FILE_1 ".tail\n" TEST_WAL_FILE_2 ".head\n");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("cache tail spanning input buffers");
+
+        // The last record begins on the second page and does not end in this segment
+        record = hrnGpdbCreateXRecordP(RM_XLOG_ID, XLOG_NOOP, DEFAULT_GDPB_XLOG_PAGE_SIZE * 2, NULL);
+        hrnGpdbWalInsertXRecordP(wal3, record, NO_FLAGS, .segno = 3);
+        bufUsedSet(wal3, DEFAULT_GDPB_XLOG_PAGE_SIZE * 3);
+
+        // The listing cached for another archive id is not used
+        filter = walFilterNew(pgControl, &archiveInfo3);
+        TEST_ERROR(
+            testFilter(filter, wal3, DEFAULT_GDPB_XLOG_PAGE_SIZE, DEFAULT_GDPB_XLOG_PAGE_SIZE), FormatError,
+            "no WAL files were found in the repository");
+
+        TEST_RESULT_BOOL(
+            bufEq(
+                storageGetP(storageNewReadP(storageSpool(), STRDEF(TEST_FRAGMENT_PATH "/" TEST_WAL_FILE_3 ".tail"))),
+                BUF(bufPtrConst(wal3) + DEFAULT_GDPB_XLOG_PAGE_SIZE, DEFAULT_GDPB_XLOG_PAGE_SIZE * 2)),
+            true, "tail starts from the page of the last record");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("remove fragments of files before the segment prior to the requested segment");
+
+        TEST_RESULT_VOID(walFilterFragmentClean(STRDEF("000000010000000000000002"), GPDB6_XLOG_SEG_SIZE), "clean");
+        TEST_STORAGE_LIST(
+            storageSpool(), TEST_FRAGMENT_PATH, TEST_WAL_FILE_1 ".tail\n" TEST_WAL_FILE_2 ".head\n" TEST_WAL_FILE_3 ".tail\n");
+
+        TEST_RESULT_VOID(walFilterFragmentClean(STRDEF("000000010000000000000003"), GPDB6_XLOG_SEG_SIZE), "clean");
+        TEST_STORAGE_LIST(
+            storageSpoolWrite(), TEST_FRAGMENT_PATH, TEST_WAL_FILE_2 ".head\n" TEST_WAL_FILE_3 ".tail\n", .remove = true);
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("keep the last segment of the prior major segment number");
+
+        HRN_STORAGE_PUT_EMPTY(storageSpoolWrite(), TEST_FRAGMENT_PATH "/00000001000000000000003E-" TEST_CHECKSUM ".tail");
+        HRN_STORAGE_PUT_EMPTY(storageSpoolWrite(), TEST_FRAGMENT_PATH "/00000001000000000000003F-" TEST_CHECKSUM ".tail");
+
+        TEST_RESULT_VOID(walFilterFragmentClean(STRDEF("000000010000000100000000"), GPDB6_XLOG_SEG_SIZE), "clean");
+        TEST_STORAGE_LIST(
+            storageSpoolWrite(), TEST_FRAGMENT_PATH, "00000001000000000000003F-" TEST_CHECKSUM ".tail\n", .remove = true);
+
+        HRN_STORAGE_PATH_REMOVE(storageRepoWrite(), STORAGE_REPO_ARCHIVE, .recurse = true);
+    }
+
+    // *****************************************************************************************************************************
+    if (testBegin("checksum records on worker threads"))
+    {
+        const PgControl pgControl = {
+            .version = PG_VERSION_94,
+            .pageSize = DEFAULT_GDPB_PAGE_SIZE,
+            .walPageSize = DEFAULT_GDPB_XLOG_PAGE_SIZE,
+            .walSegmentSize = GPDB6_XLOG_SEG_SIZE
+        };
+
+        const size_t pageSize = DEFAULT_GDPB_XLOG_PAGE_SIZE;
+        WalFilterCrc crcList[8];
+        XLogRecord *record1;
+        XLogRecord *record2;
+        XLogRecord *record4;
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("records continued across pages and a record with a split header");
+
+        wal = bufNew(pageSize * 3);
+
+        // Continues on the second page
+        record1 = hrnGpdbCreateXRecordP(
+            RM_XLOG_ID, XLOG_NOOP, (uint32_t) (pageSize - SizeOfXLogLongPHD - SizeOfXLogRecord + 100), NULL);
+        hrnGpdbWalInsertXRecordSimple(wal, record1);
+
+        // Leaves less space than a record header at the end of the second page
+        record2 = hrnGpdbCreateXRecordP(
+            RM_XLOG_ID, XLOG_NOOP, (uint32_t) (pageSize - SizeOfXLogShortPHD - MAXALIGN(100) - 8 - SizeOfXLogRecord), NULL);
+        hrnGpdbWalInsertXRecordSimple(wal, record2);
+
+        // Header is split between the second and third pages
+        record = hrnGpdbCreateXRecordP(RM_XLOG_ID, XLOG_NOOP, 100, NULL);
+        hrnGpdbWalInsertXRecordSimple(wal, record);
+
+        record4 = hrnGpdbCreateXRecordP(RM_XLOG_ID, XLOG_NOOP, 100, NULL);
+        hrnGpdbWalInsertXRecordSimple(wal, record4);
+        fillLastPage(wal, pgPageSize32);
+
+        TEST_RESULT_UINT(testCrcJob(wal, 3, 0, 3, crcList), 3, "all pages");
+        TEST_RESULT_PTR(crcList[0].record, bufPtrConst(wal) + SizeOfXLogLongPHD, "first record");
+        TEST_RESULT_UINT(crcList[0].bodyCrc, testBodyCrc(record1), "first record checksum");
+        TEST_RESULT_PTR(
+            crcList[1].record, bufPtrConst(wal) + pageSize + SizeOfXLogShortPHD + MAXALIGN(100), "second record");
+        TEST_RESULT_UINT(crcList[1].bodyCrc, testBodyCrc(record2), "second record checksum");
+        TEST_RESULT_UINT(crcList[2].bodyCrc, testBodyCrc(record4), "record after split header checksum");
+
+        TEST_RESULT_UINT(testCrcJob(wal, 3, 1, 2, crcList), 1, "skip continued record on second page");
+        TEST_RESULT_PTR(
+            crcList[0].record, bufPtrConst(wal) + pageSize + SizeOfXLogShortPHD + MAXALIGN(100), "second record");
+
+        TEST_RESULT_UINT(testCrcJob(wal, 1, 0, 1, crcList), 0, "record continues past the input");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("record spanning a page");
+
+        wal = bufNew(pageSize * 3);
+
+        record = hrnGpdbCreateXRecordP(RM_XLOG_ID, XLOG_NOOP, (uint32_t) pageSize * 2, NULL);
+        hrnGpdbWalInsertXRecordSimple(wal, record);
+        record2 = hrnGpdbCreateXRecordP(RM_XLOG_ID, XLOG_NOOP, 100, NULL);
+        hrnGpdbWalInsertXRecordSimple(wal, record2);
+        fillLastPage(wal, pgPageSize32);
+
+        TEST_RESULT_UINT(testCrcJob(wal, 3, 1, 2, crcList), 0, "no record begins on the page");
+        TEST_RESULT_UINT(testCrcJob(wal, 3, 1, 3, crcList), 1, "record after spanning record");
+        TEST_RESULT_UINT(crcList[0].bodyCrc, testBodyCrc(record2), "record checksum");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("continued record ends on the page boundary");
+
+        wal = bufNew(pageSize * 3);
+
+        record = hrnGpdbCreateXRecordP(
+            RM_XLOG_ID, XLOG_NOOP, (uint32_t) (pageSize * 2 - SizeOfXLogLongPHD - SizeOfXLogShortPHD - 4 - SizeOfXLogRecord), NULL);
+        hrnGpdbWalInsertXRecordSimple(wal, record);
+        record2 = hrnGpdbCreateXRecordP(RM_XLOG_ID, XLOG_NOOP, 100, NULL);
+        hrnGpdbWalInsertXRecordSimple(wal, record2);
+        fillLastPage(wal, pgPageSize32);
+
+        TEST_RESULT_UINT(testCrcJob(wal, 3, 1, 3, crcList), 1, "record on next page");
+        TEST_RESULT_PTR(crcList[0].record, bufPtrConst(wal) + pageSize * 2 + SizeOfXLogShortPHD, "record");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("invalid continuation page");
+
+        wal = bufNew(pageSize * 2);
+
+        record = hrnGpdbCreateXRecordP(RM_XLOG_ID, XLOG_NOOP, 100, NULL);
+        hrnGpdbWalInsertXRecordSimple(wal, record);
+        record = hrnGpdbCreateXRecordP(RM_XLOG_ID, XLOG_NOOP, (uint32_t) pageSize, NULL);
+        hrnGpdbWalInsertXRecordP(wal, record, WRONG_REM_LEN);
+        fillLastPage(wal, pgPageSize32);
+
+        TEST_RESULT_UINT(testCrcJob(wal, 2, 0, 2, crcList), 1, "stop at wrong remaining length");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("continuation flag after a record ending on the page boundary");
+
+        wal = bufNew(pageSize * 2);
+
+        record = hrnGpdbCreateXRecordP(RM_XLOG_ID, XLOG_NOOP, (uint32_t) (pageSize - SizeOfXLogLongPHD - SizeOfXLogRecord), NULL);
+        hrnGpdbWalInsertXRecordSimple(wal, record);
+        record = hrnGpdbCreateXRecordP(RM_XLOG_ID, XLOG_NOOP, 100, NULL);
+        hrnGpdbWalInsertXRecordP(wal, record, COND_FLAG);
+        fillLastPage(wal, pgPageSize32);
+
+        TEST_RESULT_UINT(testCrcJob(wal, 2, 0, 2, crcList), 1, "stop at continuation flag");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("overwritten contrecord and wrong magic");
+
+        wal = bufNew(pageSize);
+
+        record = hrnGpdbCreateXRecordP(RM_XLOG_ID, XLOG_NOOP, 100, NULL);
+        hrnGpdbWalInsertXRecordP(wal, record, OVERWRITE);
+        fillLastPage(wal, pgPageSize32);
+
+        TEST_RESULT_UINT(testCrcJob(wal, 1, 0, 1, crcList), 0, "skip overwritten page");
+
+        wal = bufNew(pageSize);
+
+        hrnGpdbWalInsertXRecordP(wal, record, NO_FLAGS, .magic = 0x1234);
+        fillLastPage(wal, pgPageSize32);
+
+        TEST_RESULT_UINT(testCrcJob(wal, 1, 0, 1, crcList), 0, "stop at wrong magic");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("filter with records checksummed on worker threads");
+
+        const String *jsonstr = STRDEF(
+            "[\n"
+            "  {\n"
+            "    \"dbOid\": 20000,\n"
+            "    \"tables\": [\n"
+            "      {\n"
+            "        \"tablespace\": 1600,\n"
+            "        \"relfilenode\": 16384\n"
+            "      }\n"
+            "    ]\n"
+            "  }\n"
+            "]");
+
+        const Storage *storageTest = storagePosixNewP(TEST_PATH_STR, .write = true);
+        HRN_STORAGE_PUT_Z(storageTest, "recovery_filter.json", strZ(jsonstr));
+
+        StringList *argList = strLstNew();
+        hrnCfgArgRawZ(argList, cfgOptStanza, "test1");
+        hrnCfgArgRawZ(argList, cfgOptPgPath, TEST_PATH "/pg");
+        hrnCfgArgRawZ(argList, cfgOptFork, CFGOPTVAL_FORK_GPDB_Z);
+        hrnCfgArgRawZ(argList, cfgOptFilter, TEST_PATH "/recovery_filter.json");
+        HRN_CFG_LOAD(cfgCmdRestore, argList);
+
+        // Records that pass and records that are filtered with sizes from a fraction of a page to more than a page
+        const RelFileNode nodePass = {1600, 20000, 16384};
+        const RelFileNode nodeFilter = {2000, 20003, 1000};
+        const uint32_t bodySizeList[] = {sizeof(RelFileNode), 1000, 5000, (uint32_t) pageSize + 1000};
+        unsigned char *const body = memNew(pageSize + 1000);
+
+        memset(body, 0, pageSize + 1000);
+        wal = bufNew(pageSize * 128);
+        Buffer *const expectWal = bufNew(pageSize * 128);
+
+        for (unsigned int recordIdx = 0; recordIdx < 300; recordIdx++)
+        {
+            const uint32_t bodySize = bodySizeList[recordIdx % LENGTH_OF(bodySizeList)];
+            const bool pass = recordIdx % 3 != 0;
+
+            memcpy(body, pass ? &nodePass : &nodeFilter, sizeof(RelFileNode));
+
+            record = hrnGpdbCreateXRecordP(RM_HEAP_ID, XLOG_HEAP_INSERT, bodySize, body);
+            hrnGpdbWalInsertXRecordSimple(wal, record);
+
+            record = hrnGpdbCreateXRecordP(pass ? RM_HEAP_ID : RM_XLOG_ID, pass ? XLOG_HEAP_INSERT : XLOG_NOOP, bodySize, body);
+            hrnGpdbWalInsertXRecordSimple(expectWal, record);
+        }
+
+        record = hrnGpdbCreateXRecordP(RM_XLOG_ID, XLOG_SWITCH, 0, NULL);
+        hrnGpdbWalInsertXRecordSimple(wal, record);
+        hrnGpdbWalInsertXRecordSimple(expectWal, record);
+        fillLastPage(wal, pgPageSize32);
+        fillLastPage(expectWal, pgPageSize32);
+
+        ioThreadSet(true);
+
+        // We run filtering in the child process to clear the filter list after the test is completed.
+        HRN_FORK_BEGIN()
+        {
+            HRN_FORK_CHILD_BEGIN()
+            {
+                filter = walFilterNew(pgControl, NULL);
+                WalFilterState *const walFilter = ioFilterDriver(filter);
+
+                TEST_RESULT_UINT(walFilter->threadMax, WAL_FILTER_THREAD_MAX, "thread max");
+
+                // Too few pages for more than one job
+                const Buffer *const input = BUF(bufPtrConst(wal), pageSize * (WAL_FILTER_THREAD_PAGE_MIN * 2 - 1));
+
+                TEST_RESULT_VOID(walFilterCrcRun(walFilter, input), "run");
+                TEST_RESULT_UINT(walFilter->crcJobTotal, 0, "no jobs");
+
+                // Records are found in order
+                TEST_RESULT_VOID(walFilterCrcRun(walFilter, BUF(bufPtrConst(wal), pageSize * 16)), "run");
+                TEST_RESULT_UINT(walFilter->crcJobTotal, 2, "jobs");
+
+                TEST_RESULT_VOID(walFilterCrcRun(walFilter, BUF(bufPtrConst(wal), pageSize * 32)), "run");
+                TEST_RESULT_UINT(walFilter->crcJobTotal, 4, "more jobs");
+
+                walFilter->recordStart = NULL;
+                TEST_RESULT_PTR(walFilterCrcFind(walFilter), NULL, "no record start");
+
+                walFilter->recordStart = bufPtrConst(wal) + SizeOfXLogLongPHD;
+                TEST_RESULT_PTR(walFilterCrcFind(walFilter), &walFilter->crcJobList[0].crcList[0].bodyCrc, "first record");
+
+                walFilter->recordStart = bufPtrConst(wal) + SizeOfXLogLongPHD + 8;
+                TEST_RESULT_PTR(walFilterCrcFind(walFilter), NULL, "not a record start");
+
+                walFilter->recordStart = bufPtrConst(wal) + pageSize * 32;
+                TEST_RESULT_PTR(walFilterCrcFind(walFilter), NULL, "past the last record");
+
+                ioFilterFree(filter);
+
+                // The filtered WAL is the same as without threads, with input large enough and small enough for jobs
+                Buffer *result = testFilter(walFilterNew(pgControl, NULL), wal, pageSize * 64, pageSize * 64);
+                TEST_RESULT_BOOL(bufEq(expectWal, result), true, "filtered wal is different from expected");
+
+                result = testFilter(walFilterNew(pgControl, NULL), wal, pageSize * 4, pageSize);
+                TEST_RESULT_BOOL(bufEq(expectWal, result), true, "filtered wal is different from expected");
+            }
+            HRN_FORK_CHILD_END();
+        }
+        HRN_FORK_END();
+
+        ioThreadSet(false);
+    }
+
     FUNCTION_HARNESS_RETURN_VOID();
 }
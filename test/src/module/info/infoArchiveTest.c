@@ -164,5 +164,31 @@ testRun(void)
         HRN_STORAGE_REMOVE(storageTest, INFO_ARCHIVE_FILE, .errorOnMissing = true, .comment = "remove main so only copy exists");
         TEST_ASSIGN(infoArchive, infoArchiveLoadFile(storageTest, STRDEF(INFO_ARCHIVE_FILE), cipherTypeNone, NULL), "load copy");
         TEST_RESULT_UINT(infoPgDataCurrent(infoArchivePg(infoArchive)).systemId, 6569239123849665999, "check file loaded");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("save and load archive info file with cipher type");
+
+        infoArchive = infoArchiveNew(PG_VERSION_10, 6569239123849665999, STRDEF("subpass"));
+        TEST_RESULT_UINT(infoArchiveCipherType(infoArchive), cipherTypeAes256Cbc, "cipher type defaults to aes-256-cbc");
+        TEST_RESULT_VOID(
+            infoArchiveSaveFile(infoArchive, storageTest, STRDEF(INFO_ARCHIVE_FILE), cipherTypeAes256Gcm, STRDEF("pass")),
+            "save archive info");
+
+        TEST_ASSIGN(
+            infoArchive, infoArchiveLoadFile(storageTest, STRDEF(INFO_ARCHIVE_FILE), cipherTypeAes256Gcm, STRDEF("pass")), "load");
+        TEST_RESULT_STR_Z(infoArchiveCipherPass(infoArchive), "subpass", "check cipher pass");
+        TEST_RESULT_UINT(infoArchiveCipherType(infoArchive), cipherTypeAes256Gcm, "check cipher type");
+
+        TEST_ERROR(
+            infoArchiveLoadFile(storageTest, STRDEF(INFO_ARCHIVE_FILE), cipherTypeAes256Cbc, STRDEF("pass")), CryptoError,
+            "unable to load info file '" TEST_PATH "/archive.info' or '" TEST_PATH "/archive.info.copy':\n"
+            "CryptoError: cipher header invalid: data is encrypted with aes-256-gcm\n"
+            "HINT: is or was the repo encrypted?\n"
+            "CryptoError: cipher header invalid: data is encrypted with aes-256-gcm\n"
+            "HINT: is or was the repo encrypted?\n"
+            "HINT: archive.info cannot be opened but is required to push/get WAL segments.\n"
+            "HINT: is archive_command configured correctly in postgresql.conf?\n"
+            "HINT: has a stanza-create been performed?\n"
+            "HINT: use --no-archive-check to disable archive checks during backup if you have an alternate archiving scheme.");
     }
 }
@@ -197,12 +197,44 @@ testRun(void)
             infoNewLoad(ioBufferReadNew(contentLoad), harnessInfoLoadNewCallback, callbackContent), "info with content and cipher");
         TEST_RESULT_STR_Z(callbackContent, "[c] key=1\n[d] key=1\n", "    check callback content");
         TEST_RESULT_STR_Z(infoCipherPass(info), "somepass", "    check cipher pass set");
+        TEST_RESULT_UINT(infoCipherType(info), cipherTypeAes256Cbc, "    check cipher type defaults to aes-256-cbc");
         TEST_RESULT_STR_Z(infoBackrestVersion(info), PROJECT_VERSION, "    check backrest version");
 
         contentSave = bufNew(0);
 
         TEST_RESULT_VOID(infoSave(info, ioBufferWriteNew(contentSave), testInfoSaveCallback, strNewZ("1")), "info save");
         TEST_RESULT_STR(strNewBuf(contentSave), strNewBuf(contentLoad), "   check save");
+
+        TEST_RESULT_VOID(infoCipherTypeCheck(info, cipherTypeAes256Cbc, STRDEF("test.info")), "cipher type matches");
+        TEST_ERROR(
+            infoCipherTypeCheck(info, cipherTypeAes256Gcm, STRDEF("test.info")), CryptoError,
+            "cipher type 'aes-256-gcm' does not match 'aes-256-cbc' stored in 'test.info'\n"
+            "HINT: the repo cipher type cannot be changed after the stanza has been created.");
+
+        // File with content and cipher type
+        // -------------------------------------------------------------------------------------------------------------------------
+        contentLoad = harnessInfoChecksumZ(
+            "[c]\n"
+            "key=1\n"
+            "\n"
+            "[cipher]\n"
+            "cipher-pass=\"somepass\"\n"
+            "cipher-type=\"aes-256-gcm\"\n"
+            "\n"
+            "[d]\n"
+            "key=1\n");
+
+        TEST_ASSIGN(
+            info, infoNewLoad(ioBufferReadNew(contentLoad), harnessInfoLoadNewCallback, strNew()), "info with cipher type");
+        TEST_RESULT_UINT(infoCipherType(info), cipherTypeAes256Gcm, "    check cipher type");
+
+        contentSave = bufNew(0);
+
+        TEST_RESULT_VOID(infoSave(info, ioBufferWriteNew(contentSave), testInfoSaveCallback, strNewZ("1")), "info save");
+        TEST_RESULT_STR(strNewBuf(contentSave), strNewBuf(contentLoad), "   check save");
+
+        TEST_RESULT_VOID(infoCipherTypeSet(info, cipherTypeAes256Cbc), "set cipher type");
+        TEST_RESULT_VOID(infoCipherTypeCheck(info, cipherTypeAes256Cbc, STRDEF("test.info")), "cipher type matches");
     }
 
     // *****************************************************************************************************************************
@@ -18,6 +18,20 @@ Special string constants
 ***********************************************************************************************************************************/
 #define SHRUG_EMOJI                                                 "¯\\_(ツ)_/¯"
 
+/***********************************************************************************************************************************
+Add a file if missing and return the relation identity as db/tablespace/relfilenode/fork/segment after it has been packed
+***********************************************************************************************************************************/
+static const char *
+testManifestRelation(Manifest *const manifest, const char *const name)
+{
+    if (!manifestFileExists(manifest, STR(name)))
+        HRN_MANIFEST_FILE_ADD(manifest, .name = name);
+
+    const ManifestFile file = manifestFileFind(manifest, STR(name));
+
+    return zNewFmt("%u/%u/%u/%u/%u", file.dbId, file.tablespaceId, file.relFileNode, file.relFork, file.relSegNo);
+}
+
 /***********************************************************************************************************************************
 Test Run
 ***********************************************************************************************************************************/
@@ -40,6 +54,65 @@ testRun(void)
         TEST_RESULT_UINT(sizeof(ManifestPath), TEST_64BIT() ? 32 : 16, "check size of ManifestPath");
     }
 
+    // *****************************************************************************************************************************
+    if (testBegin("manifestFileRelation()"))
+    {
+        Manifest *manifest = NULL;
+
+        OBJ_NEW_BASE_BEGIN(Manifest, .childQty = MEM_CONTEXT_QTY_MAX)
+        {
+            manifest = manifestNewInternal();
+        }
+        OBJ_NEW_END();
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("relations");
+
+        TEST_RESULT_Z(testManifestRelation(manifest, "pg_data/base/16384/16385"), "16384/1663/16385/0/0", "main fork");
+        TEST_RESULT_Z(testManifestRelation(manifest, "pg_data/base/16384/16385.12"), "16384/1663/16385/0/12", "segment");
+        TEST_RESULT_Z(testManifestRelation(manifest, "pg_data/base/16384/16385_fsm"), "16384/1663/16385/1/0", "fsm fork");
+        TEST_RESULT_Z(testManifestRelation(manifest, "pg_data/base/16384/16385_vm.1"), "16384/1663/16385/2/1", "vm fork segment");
+        TEST_RESULT_Z(testManifestRelation(manifest, "pg_data/base/16384/16386_init"), "16384/1663/16386/3/0", "init fork");
+        TEST_RESULT_Z(testManifestRelation(manifest, "pg_data/global/1262"), "0/1664/1262/0/0", "global relation");
+        TEST_RESULT_Z(
+            testManifestRelation(manifest, "pg_tblspc/16387/PG_9.4_201409291/16384/4294967295.1"),
+            "16384/16387/4294967295/0/1", "tablespace relation");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("files in a database path that are not relations");
+
+        TEST_RESULT_Z(testManifestRelation(manifest, "pg_data/base/16384/PG_VERSION"), "16384/1663/0/0/0", "PG_VERSION");
+        TEST_RESULT_Z(
+            testManifestRelation(manifest, "pg_tblspc/16387/PG_9.4_201409291/16384/PG_VERSION"), "16384/16387/0/0/0", "tablespace");
+        TEST_RESULT_Z(testManifestRelation(manifest, "pg_data/global/pg_control"), "0/1664/0/0/0", "pg_control");
+        TEST_RESULT_Z(testManifestRelation(manifest, "pg_data/base/16384/16388."), "16384/1663/0/0/0", "missing segment");
+        TEST_RESULT_Z(testManifestRelation(manifest, "pg_data/base/16384/16388.0"), "16384/1663/0/0/0", "zero segment");
+        TEST_RESULT_Z(testManifestRelation(manifest, "pg_data/base/16384/16388_fsmx"), "16384/1663/0/0/0", "invalid fork");
+        TEST_RESULT_Z(testManifestRelation(manifest, "pg_data/base/16384/4294967296"), "16384/1663/0/0/0", "oid too large");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("files not in a database path");
+
+        TEST_RESULT_Z(testManifestRelation(manifest, "pg_data/16385"), "0/0/0/0/0", "pg_data");
+        TEST_RESULT_Z(testManifestRelation(manifest, "pg_data/base/pgsql_tmp/16385"), "0/0/0/0/0", "base");
+        TEST_RESULT_Z(testManifestRelation(manifest, "pg_data/base/16384/sub/16385"), "0/0/0/0/0", "database subpath");
+        TEST_RESULT_Z(testManifestRelation(manifest, "pg_data/global/sub/1262"), "0/0/0/0/0", "global subpath");
+        TEST_RESULT_Z(
+            testManifestRelation(manifest, "pg_tblspc/bogus/PG_9.4_201409291/16384/16385"), "0/0/0/0/0", "invalid tablespace");
+        TEST_RESULT_Z(testManifestRelation(manifest, "pg_tblspc/16387/PG_9.4_201409291"), "0/0/0/0/0", "tablespace version");
+        TEST_RESULT_Z(
+            testManifestRelation(manifest, "pg_tblspc/16387/PG_9.4_201409291/16385"), "0/0/0/0/0", "tablespace version file");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("identity is kept on update");
+
+        ManifestFile file = manifestFileFind(manifest, STRDEF("pg_data/base/16384/16385.12"));
+        file.relFileNode = 0;
+        manifestFileUpdate(manifest, &file);
+
+        TEST_RESULT_Z(testManifestRelation(manifest, "pg_data/base/16384/16385.12"), "16384/1663/16385/0/12", "check identity");
+    }
+
     // *****************************************************************************************************************************
     if (testBegin("manifestNewBuild()"))
     {
@@ -1489,6 +1562,7 @@ testRun(void)
         TEST_RESULT_STR_Z(manifestData(manifest)->backupLabel, "20190808-163540F", "check manifest data");
 
         TEST_RESULT_STR_Z(manifestCipherSubPass(manifest), "somepass", "check cipher subpass");
+        TEST_RESULT_UINT(manifestCipherType(manifest), cipherTypeAes256Cbc, "check cipher type");
 
         TEST_RESULT_VOID(
             manifestTargetUpdate(manifest, MANIFEST_TARGET_PGDATA_STR, STRDEF("/pg/base"), NULL), "update target no change");
@@ -1575,6 +1649,7 @@ testRun(void)
             "[target:file]\n"                                                                                                      \
             "pg_data/=equal=more=={\"mode\":\"0640\",\"size\":0,\"timestamp\":1565282120}\n"                                       \
             "pg_data/PG_VERSION={\"checksum\":\"184473f470864e067ee3a22e64b47b0a1c356f29\""                                        \
+                ",\"fck\":\"bbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbb\",\"frck\":\"cccccccccccccccccccccccccccccccc\""                      \
                 ",\"rck\":\"aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa\",\"reference\":\"20190818-084502F_20190819-084506D\""        \
                 ",\"size\":4,\"timestamp\":1565282114}\n"                                                                          \
             "pg_data/base/16384/17000={\"bi\":4,\"bni\":1,\"checksum\":\"e0101dd8ffb910c9c202ca35b5f828bcb9697bed\""               \
@@ -1778,6 +1853,8 @@ testRun(void)
         TEST_RESULT_STR_Z(manifestCipherSubPass(manifest), NULL, "check cipher subpass");
         TEST_RESULT_VOID(manifestCipherSubPassSet(manifest, STRDEF("supersecret")), "cipher subpass set");
         TEST_RESULT_STR_Z(manifestCipherSubPass(manifest), "supersecret", "check cipher subpass");
+        TEST_RESULT_VOID(manifestCipherTypeSet(manifest, cipherTypeAes256Gcm), "cipher type set");
+        TEST_RESULT_UINT(manifestCipherType(manifest), cipherTypeAes256Gcm, "check cipher type");
 
         // Absolute target paths
         TEST_RESULT_STR_Z(manifestTargetPath(manifest, manifestTargetBase(manifest)), "/pg/base", "base target path");
@@ -1934,6 +2011,7 @@ testRun(void)
             "\n"
             "[cipher]\n"
             "cipher-pass=\"supersecret\"\n"
+            "cipher-type=\"aes-256-gcm\"\n"
             TEST_MANIFEST_DB
             TEST_MANIFEST_METADATA
             TEST_MANIFEST_FILE
@@ -1945,6 +2023,36 @@ testRun(void)
 
         TEST_RESULT_STR(strNewBuf(contentSave), strNewBuf(contentCompare), "check save");
 
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("binary manifest save and load");
+
+        Buffer *contentSaveBin = bufNew(0);
+        TEST_RESULT_VOID(manifestSaveBin(manifest, ioBufferWriteNew(contentSaveBin)), "save binary manifest");
+
+        Manifest *manifestBin = NULL;
+        TEST_ASSIGN(manifestBin, manifestNewLoadBin(ioBufferReadNewOpen(contentSaveBin)), "load binary manifest");
+
+        contentSave = bufNew(0);
+        TEST_RESULT_VOID(manifestSave(manifestBin, ioBufferWriteNew(contentSave)), "save manifest");
+        TEST_RESULT_STR(strNewBuf(contentSave), strNewBuf(contentCompare), "check save");
+        TEST_RESULT_UINT(manifestFileTotal(manifestBin), manifestFileTotal(manifest), "check file total");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("binary manifest load errors");
+
+        *(bufPtr(contentSaveBin) + bufUsed(contentSaveBin) - 2) ^= 0xFF;
+
+        TEST_ERROR(
+            manifestNewLoadBin(ioBufferReadNewOpen(contentSaveBin)), ChecksumError, "invalid binary manifest file table checksum");
+
+        PackWrite *const packBogus = pckWriteNewP();
+        pckWriteU32P(packBogus, 999);
+        pckWriteEndP(packBogus);
+
+        TEST_ERROR(
+            manifestNewLoadBin(ioBufferReadNewOpen(pckToBuf(pckWriteResult(packBogus)))), FormatError,
+            "expected binary manifest format 1 but found 999");
+
         TEST_RESULT_VOID(manifestFileRemove(manifest, STRDEF("pg_data/PG_VERSION")), "remove file");
         TEST_ERROR(
             manifestFileRemove(manifest, STRDEF("pg_data/PG_VERSION")), AssertError,
@@ -2051,6 +2159,27 @@ testRun(void)
         TEST_ASSIGN(manifest, manifestLoadFile(storageTest, STRDEF(BACKUP_MANIFEST_FILE), cipherTypeNone, NULL), "load main");
         TEST_RESULT_UINT(manifestData(manifest)->pgSystemId, 1000000000000000094, "check file loaded");
 
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("binary manifest is preferred");
+
+        manifest->pub.data.pgSystemId = 1000000000000000095;
+
+        manifestSaveBin(
+            manifest, storageWriteIo(storageNewWriteP(storageTest, STRDEF(BACKUP_MANIFEST_FILE MANIFEST_BIN_EXT))));
+        TEST_ASSIGN(manifest, manifestLoadFile(storageTest, STRDEF(BACKUP_MANIFEST_FILE), cipherTypeNone, NULL), "load binary");
+        TEST_RESULT_UINT(manifestData(manifest)->pgSystemId, 1000000000000000095, "check binary file loaded");
+        TEST_RESULT_UINT(manifestFileTotal(manifest), 1, "check file total");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("corrupt binary manifest falls back to text manifest");
+
+        HRN_STORAGE_PUT_Z(storageTest, BACKUP_MANIFEST_FILE MANIFEST_BIN_EXT, "BOGUS", .comment = "write corrupt binary manifest");
+        TEST_ASSIGN(manifest, manifestLoadFile(storageTest, STRDEF(BACKUP_MANIFEST_FILE), cipherTypeNone, NULL), "load text");
+        TEST_RESULT_UINT(manifestData(manifest)->pgSystemId, 1000000000000000094, "check text file loaded");
+        TEST_RESULT_LOG(
+            "P00   WARN: unable to load 'backup.manifest.bin', loading text manifest instead: expected binary manifest format 1 but"
+            " found 0");
+
         TEST_RESULT_VOID(manifestFree(manifest), "free manifest");
         TEST_RESULT_VOID(manifestFree(NULL), "free null manifest");
     }
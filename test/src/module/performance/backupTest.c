@@ -0,0 +1,133 @@
+/***********************************************************************************************************************************
+Backup Performance
+
+Compare the cost of the checks used by delta backup to determine whether a relation file has changed since the prior backup.
+
+Generally speaking, the starting values should be high enough to "blow up" in terms of execution time if there are performance
+problems without taking very long if everything is running smoothly. These starting values can then be scaled up for profiling and
+stress testing as needed.
+***********************************************************************************************************************************/
+#include "common/harnessConfig.h"
+#include "common/harnessStorage.h"
+
+#include "common/crypto/hash.h"
+#include "common/crypto/xxhash.h"
+#include "common/io/filter/size.h"
+#include "common/time.h"
+#include "storage/posix/storage.h"
+
+/***********************************************************************************************************************************
+Read a file through a checksum filter the same way as the checksum delta
+***********************************************************************************************************************************/
+static void
+testChecksum(const String *const pgFile, IoFilter *const filter)
+{
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        IoRead *const read = storageReadIo(storageNewReadP(storagePg(), pgFile));
+        ioFilterGroupAdd(ioReadFilterGroup(read), filter);
+        ioFilterGroupAdd(ioReadFilterGroup(read), ioSizeNew());
+        ioReadDrain(read);
+    }
+    MEM_CONTEXT_TEMP_END();
+}
+
+/***********************************************************************************************************************************
+Test Run
+***********************************************************************************************************************************/
+static void
+testRun(void)
+{
+    FUNCTION_HARNESS_VOID();
+
+    // *****************************************************************************************************************************
+    if (testBegin("backupFilePageLsn()"))
+    {
+        // 128MiB per scale, the size of a large relation segment with the default scale of 8
+        ASSERT(TEST_SCALE <= 1024);
+        const unsigned int pageTotal = 16384 * TEST_SCALE;
+        const unsigned int iteration = 4;
+
+        StringList *argList = strLstNew();
+        hrnCfgArgRawZ(argList, cfgOptStanza, "test");
+        hrnCfgArgRawZ(argList, cfgOptRepoPath, TEST_PATH "/repo");
+        hrnCfgArgRawZ(argList, cfgOptPgPath, TEST_PATH "/pg");
+        HRN_CFG_LOAD(cfgCmdBackup, argList);
+
+        // Write a relation with valid page headers and an LSN of 2 on every page
+        Buffer *const relation = bufNew((size_t)pageTotal * pgPageSize8);
+
+        for (unsigned int pageIdx = 0; pageIdx < pageTotal; pageIdx++)
+        {
+            unsigned char *const page = bufPtr(relation) + (size_t)pageIdx * pgPageSize8;
+
+            for (unsigned int byteIdx = 0; byteIdx < pgPageSize8; byteIdx++)
+                page[byteIdx] = (unsigned char)((pageIdx + byteIdx) * 2654435761U >> 24);
+
+            *(PageHeaderData *)page = (PageHeaderData)
+            {
+                .pd_lsn = {.xrecoff = 2},
+                .pd_lower = offsetof(PageHeaderData, pd_linp),
+                .pd_upper = pgPageSize8,
+                .pd_special = pgPageSize8,
+                .pd_pagesize_version = pgPageSize8 | BACKUP_FILE_PAGE_LAYOUT_VERSION,
+            };
+        }
+
+        bufUsedSet(relation, bufSize(relation));
+
+        const String *const pgFile = STRDEF(TEST_PATH "/pg/base/1/16384");
+        HRN_STORAGE_PUT(storagePgWrite(), "base/1/16384", relation);
+
+        BackupFile file = {.pgFile = pgFile, .pgFileSize = bufUsed(relation)};
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE_FMT("%u iteration(s) of %zuMiB", iteration, bufUsed(relation) / (1024 * 1024));
+
+        uint64_t lsnUnchangedTotal = 1;
+        uint64_t lsnChangedTotal = 1;
+        uint64_t xxHashTotal = 1;
+        uint64_t sha1Total = 1;
+
+        for (unsigned int idx = 0; idx < iteration; idx++)
+        {
+            // Every page must be read to show that the file is unchanged
+            file.pgFileLsnLimit = 2;
+            TimeMSec timeBegin = timeMSec();
+            ASSERT(backupFilePageLsn(&file, pgPageSize8) == backupFilePageLsnUnchanged);
+            lsnUnchangedTotal += timeMSec() - timeBegin;
+
+            // Scanning stops at the first page that is newer than the limit
+            file.pgFileLsnLimit = 1;
+            timeBegin = timeMSec();
+            ASSERT(backupFilePageLsn(&file, pgPageSize8) == backupFilePageLsnChanged);
+            lsnChangedTotal += timeMSec() - timeBegin;
+
+            timeBegin = timeMSec();
+            testChecksum(pgFile, xxHashNew(MANIFEST_CHECKSUM_FAST_SIZE));
+            xxHashTotal += timeMSec() - timeBegin;
+
+            timeBegin = timeMSec();
+            testChecksum(pgFile, cryptoHashNew(hashTypeSha1));
+            sha1Total += timeMSec() - timeBegin;
+        }
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("results");
+
+        #define TEST_RESULT(name, total)                                                                                           \
+            TEST_LOG_FMT(                                                                                                          \
+                "%s time %" PRIu64 "ms, avg time %" PRIu64 "ms, avg throughput: %" PRIu64 "MB/s", name, total, total / iteration, \
+                (uint64_t)iteration * bufUsed(relation) * 1000 / total / 1000000);
+
+        TEST_RESULT("page lsn (unchanged)", lsnUnchangedTotal);
+        TEST_RESULT("page lsn (changed)", lsnChangedTotal);
+        TEST_RESULT("xxhash checksum", xxHashTotal);
+        TEST_RESULT("sha1 checksum", sha1Total);
+        TEST_LOG_FMT(
+            "page lsn (unchanged) speedup over xxhash: %" PRIu64 ".%02" PRIu64 "x", xxHashTotal / lsnUnchangedTotal,
+            xxHashTotal * 100 / lsnUnchangedTotal % 100);
+    }
+
+    FUNCTION_HARNESS_RETURN_VOID();
+}
@@ -0,0 +1,141 @@
+/***********************************************************************************************************************************
+Partial Restore Performance
+
+Test the performance of the relation filter used by partial restore for every WAL record and every manifest file.
+
+Generally speaking, the starting values should be high enough to "blow up" in terms of execution time if there are performance
+problems without taking very long if everything is running smoothly. These starting values can then be scaled up for profiling and
+stress testing as needed.
+***********************************************************************************************************************************/
+#include "common/harnessConfig.h"
+
+#include "common/time.h"
+#include "storage/posix/storage.h"
+
+/***********************************************************************************************************************************
+Lookup using sorted lists that was used before the hash sets were added, to compare against
+***********************************************************************************************************************************/
+static bool
+testRelationNeededList(const List *const filterList, const Oid dbNode, const Oid spcNode, const Oid relNode)
+{
+    if (pgDbIsSystemId(dbNode) && pgDbIsSystemId(relNode))
+        return true;
+
+    const DataBase *const db = lstFind(filterList, &dbNode);
+
+    if (db == NULL)
+        return false;
+
+    return pgDbIsSystemId(relNode) || lstExists(db->tables, &(Table){.spcNode = spcNode, .relNode = relNode});
+}
+
+/***********************************************************************************************************************************
+Test Run
+***********************************************************************************************************************************/
+static void
+testRun(void)
+{
+    FUNCTION_HARNESS_VOID();
+
+    // *****************************************************************************************************************************
+    if (testBegin("isRelationNeeded()"))
+    {
+        ASSERT(TEST_SCALE <= 1024 * 1024);
+        const unsigned int lookupTotal = 1000000 * TEST_SCALE;
+
+        // Filter tens of thousands of tables in a few databases, which is where the cost of the lookup starts to matter
+        const unsigned int dbTotal = 4;
+        const unsigned int tableTotal = 50000;
+
+        String *const json = strCatChr(strNew(), '[');
+
+        for (unsigned int dbIdx = 0; dbIdx < dbTotal; dbIdx++)
+        {
+            strCatFmt(json, "%s{\"dbOid\":%u,\"tables\":[", dbIdx == 0 ? "" : ",", 16384 + dbIdx);
+
+            for (unsigned int tableIdx = 0; tableIdx < tableTotal / dbTotal; tableIdx++)
+                strCatFmt(json, "%s{\"relfilenode\":%u}", tableIdx == 0 ? "" : ",", 16384 + tableIdx * 2);
+
+            strCatZ(json, "]}");
+        }
+
+        strCatChr(json, ']');
+        storagePutP(storageNewWriteP(storagePosixNewP(TEST_PATH_STR, .write = true), STRDEF("filter.json")), BUFSTR(json));
+
+        StringList *argList = strLstNew();
+        hrnCfgArgRawZ(argList, cfgOptStanza, "test");
+        hrnCfgArgRawZ(argList, cfgOptPgPath, TEST_PATH "/pg");
+        hrnCfgArgRawZ(argList, cfgOptFilter, TEST_PATH "/filter.json");
+        HRN_CFG_LOAD(cfgCmdRestore, argList);
+
+        const List *const filterList = buildFilterList(jsonReadNew(json));
+
+        // Half of the lookups are for databases in the filter and half of those are for tables in the filter
+        typedef struct TestRelation
+        {
+            Oid dbNode;
+            Oid relNode;
+        } TestRelation;
+
+        const unsigned int relationTotal = 65536;
+        TestRelation *const relationList = memNew(sizeof(TestRelation) * relationTotal);
+        unsigned int neededTotal = 0;
+
+        for (unsigned int relationIdx = 0; relationIdx < relationTotal; relationIdx++)
+        {
+            const unsigned int random = (relationIdx * 2654435761U) >> 7;
+
+            relationList[relationIdx] = (TestRelation)
+            {
+                .dbNode = 16384 + random % (dbTotal * 2),
+                .relNode = 16384 + random % (tableTotal / dbTotal * 2),
+            };
+
+            // Make sure the implementations agree before timing them
+            const bool needed = isRelationNeeded(
+                relationList[relationIdx].dbNode, DEFAULTTABLESPACE_OID, relationList[relationIdx].relNode);
+            ASSERT(
+                needed ==
+                    testRelationNeededList(
+                        filterList, relationList[relationIdx].dbNode, DEFAULTTABLESPACE_OID, relationList[relationIdx].relNode));
+
+            neededTotal += needed;
+        }
+
+        TEST_LOG_FMT("%u of %u relations needed", neededTotal, relationTotal);
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE_FMT("%u lookups with %u tables", lookupTotal, tableTotal);
+
+        TimeMSec timeBegin = timeMSec();
+        unsigned int result = 0;
+
+        for (unsigned int lookupIdx = 0; lookupIdx < lookupTotal; lookupIdx++)
+        {
+            const TestRelation *const relation = &relationList[lookupIdx % relationTotal];
+            result += testRelationNeededList(filterList, relation->dbNode, DEFAULTTABLESPACE_OID, relation->relNode);
+        }
+
+        // Add 1ms just in case something takes 0ms to run
+        uint64_t total = timeMSec() - timeBegin + 1;
+
+        TEST_LOG_FMT(
+            "list time %" PRIu64 "ms, lookups/sec: %" PRIu64 ", needed %u", total, (uint64_t)lookupTotal * 1000 / total, result);
+
+        timeBegin = timeMSec();
+        result = 0;
+
+        for (unsigned int lookupIdx = 0; lookupIdx < lookupTotal; lookupIdx++)
+        {
+            const TestRelation *const relation = &relationList[lookupIdx % relationTotal];
+            result += isRelationNeeded(relation->dbNode, DEFAULTTABLESPACE_OID, relation->relNode);
+        }
+
+        total = timeMSec() - timeBegin + 1;
+
+        TEST_LOG_FMT(
+            "hash time %" PRIu64 "ms, lookups/sec: %" PRIu64 ", needed %u", total, (uint64_t)lookupTotal * 1000 / total, result);
+    }
+
+    FUNCTION_HARNESS_RETURN_VOID();
+}
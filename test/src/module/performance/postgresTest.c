@@ -0,0 +1,107 @@
+/***********************************************************************************************************************************
+PostgreSQL Performance
+
+Test the performance of PostgreSQL-specific calculations, e.g. the checksums used to validate WAL and pg_control.
+
+Generally speaking, the starting values should be high enough to "blow up" in terms of execution time if there are performance
+problems without taking very long if everything is running smoothly. These starting values can then be scaled up for profiling and
+stress testing as needed.
+***********************************************************************************************************************************/
+#include "common/time.h"
+#include "storage/posix/storage.h"
+
+/***********************************************************************************************************************************
+Byte-wise CRC-32C calculation used before hardware support was added, to compare against
+***********************************************************************************************************************************/
+static uint32_t
+testCrc32cCompByte(uint32_t crc, const unsigned char *data, size_t size)
+{
+    while (size--)
+        crc = crc32c_lookup[(crc ^ *data++) & 0xFF] ^ (crc >> 8);
+
+    return crc;
+}
+
+/***********************************************************************************************************************************
+Test Run
+***********************************************************************************************************************************/
+static void
+testRun(void)
+{
+    FUNCTION_HARNESS_VOID();
+
+    // *****************************************************************************************************************************
+    if (testBegin("crc32cComp()"))
+    {
+        // 1MB of sample table pages
+        ASSERT(TEST_SCALE <= 1024 * 1024);
+        const uint64_t iteration = 256 * TEST_SCALE;
+
+        const Buffer *const block = storageGetP(
+            storageNewReadP(storagePosixNewP(HRN_PATH_REPO_STR), STRDEF("test/data/filecopy.table.bin")));
+        ASSERT(bufUsed(block) == 1024 * 1024);
+
+        // Select implementation and make sure all implementations agree before timing them
+        const uint32_t expected = crc32cComp(crc32cInit(), bufPtrConst(block), bufUsed(block));
+        ASSERT(testCrc32cCompByte(crc32cInit(), bufPtrConst(block), bufUsed(block)) == expected);
+        ASSERT(crc32cCompSb8(crc32cInit(), bufPtrConst(block), bufUsed(block)) == expected);
+
+        // Sizes are a typical small WAL record and a full page image
+        const size_t sizeList[] = {128, 8192};
+
+        typedef struct TestCrc32cImpl
+        {
+            const char *name;
+            uint32_t (*comp)(uint32_t crc, const unsigned char *data, size_t size);
+        } TestCrc32cImpl;
+
+        const TestCrc32cImpl implList[] =
+        {
+            {.name = "byte", .comp = testCrc32cCompByte},
+            {.name = "slice-by-8", .comp = crc32cCompSb8},
+#if defined(CRC32C_X86_64)
+            {.name = "sse4.2", .comp = __builtin_cpu_supports("sse4.2") ? crc32cCompSse42 : NULL},
+            {.name = "sse4.2+pclmul", .comp = crc32cCompImpl == crc32cCompSse42Clmul ? crc32cCompSse42Clmul : NULL},
+#elif defined(CRC32C_AARCH64)
+            {.name = "armv8", .comp = crc32cCompImpl == crc32cCompArmv8 ? crc32cCompArmv8 : NULL},
+#endif
+        };
+
+        for (unsigned int sizeIdx = 0; sizeIdx < LENGTH_OF(sizeList); sizeIdx++)
+        {
+            const size_t size = sizeList[sizeIdx];
+
+            // -------------------------------------------------------------------------------------------------------------------------
+            TEST_TITLE_FMT("%" PRIu64 "MiB in %zu byte chunks", iteration, size);
+
+            for (unsigned int implIdx = 0; implIdx < LENGTH_OF(implList); implIdx++)
+            {
+                const TestCrc32cImpl *const impl = &implList[implIdx];
+
+                if (impl->comp == NULL)
+                {
+                    TEST_LOG_FMT("%s not supported", impl->name);
+                    continue;
+                }
+
+                const TimeMSec timeBegin = timeMSec();
+                uint32_t crc = crc32cInit();
+
+                for (uint64_t iterationIdx = 0; iterationIdx < iteration; iterationIdx++)
+                {
+                    for (size_t offset = 0; offset < bufUsed(block); offset += size)
+                        crc = impl->comp(crc, bufPtrConst(block) + offset, size);
+                }
+
+                // Add 1ms just in case something takes 0ms to run
+                const uint64_t total = timeMSec() - timeBegin + 1;
+
+                TEST_LOG_FMT(
+                    "%s time %" PRIu64 "ms, throughput: %" PRIu64 "MB/s, crc %08x", impl->name, total,
+                    iteration * 1024 * 1024 * 1000 / total / 1000000, crc32cFinish(crc));
+            }
+        }
+    }
+
+    FUNCTION_HARNESS_RETURN_VOID();
+}
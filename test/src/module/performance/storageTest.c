@@ -13,7 +13,10 @@ stress testing as needed.
 
 #include "common/compress/gz/compress.h"
 #include "common/compress/lz4/compress.h"
+#include "common/crypto/cipherBlock.h"
+#include "common/crypto/cipherFrame.h"
 #include "common/crypto/hash.h"
+#include "common/crypto/xxhash.h"
 #include "common/io/bufferRead.h"
 #include "common/io/bufferWrite.h"
 #include "common/io/fdRead.h"
@@ -204,6 +207,48 @@ testRun(void)
             HRN_FORK_PARENT_END();
         }
         HRN_FORK_END();
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE_FMT("list %d hundred thousand local files with stat on threads", TEST_SCALE);
+
+        // Create files in a single path since large flat paths are where stat dominates listing time
+        ASSERT(TEST_SCALE <= 100);
+        const unsigned int localFileTotal = 100000 * TEST_SCALE;
+        const Storage *const storageWrite = storagePosixNewP(TEST_PATH_STR, .write = true);
+
+        for (unsigned int fileIdx = 0; fileIdx < localFileTotal; fileIdx++)
+            storagePutP(storageNewWriteP(storageWrite, strNewFmt("list/%u", fileIdx)), NULL);
+
+        TimeMSec listTotal[2] = {0};
+        const unsigned int listThreadMax[2] = {1, 4};
+
+        for (unsigned int listIdx = 0; listIdx < LENGTH_OF(listThreadMax); listIdx++)
+        {
+            MEM_CONTEXT_TEMP_BEGIN()
+            {
+                Storage *const storageList = storagePosixNewP(TEST_PATH_STR, .listThreadMax = listThreadMax[listIdx]);
+                uint64_t fileTotal = 0;
+                const TimeMSec timeBegin = timeMSec();
+
+                StorageIterator *const storageItr = storageNewItrP(storageList, STRDEF("list"), .level = storageInfoLevelDetail);
+
+                while (storageItrMore(storageItr))
+                {
+                    storageItrNext(storageItr);
+                    fileTotal++;
+                }
+
+                listTotal[listIdx] = timeMSec() - timeBegin;
+
+                TEST_RESULT_UINT(fileTotal, localFileTotal, zNewFmt("check total with %u thread(s)", listThreadMax[listIdx]));
+                TEST_LOG_FMT("list with %u thread(s) in %" PRIu64 "ms", listThreadMax[listIdx], listTotal[listIdx]);
+            }
+            MEM_CONTEXT_TEMP_END();
+        }
+
+        TEST_LOG_FMT(
+            "list speedup on threads: %" PRIu64 ".%02" PRIu64 "x", listTotal[0] / (listTotal[1] + 1),
+            listTotal[0] * 100 / (listTotal[1] + 1) % 100);
     }
 
     // *****************************************************************************************************************************
@@ -271,7 +316,11 @@ testRun(void)
         uint64_t md5Total = 1;
         uint64_t sha1Total = 1;
         uint64_t sha256Total = 1;
+        uint64_t xxHashTotal = 1;
         uint64_t gzip6Total = 1;
+        uint64_t aes256CbcTotal = 1;
+        uint64_t aes256GcmTotal = 1;
+        uint64_t aes256GcmThreadTotal = 1;
 
 #ifdef HAVE_LIBLZ4
         uint64_t lz41Total = 1;
@@ -289,6 +338,17 @@ testRun(void)
             }
             MEM_CONTEXT_TEMP_END();
 
+            // -------------------------------------------------------------------------------------------------------------------------
+            TEST_LOG_FMT("xxhash iteration %u", idx + 1);
+
+            MEM_CONTEXT_TEMP_BEGIN()
+            {
+                BENCHMARK_BEGIN();
+                BENCHMARK_FILTER_ADD(xxHashNew(XX_HASH_SIZE_MAX));
+                BENCHMARK_END(xxHashTotal);
+            }
+            MEM_CONTEXT_TEMP_END();
+
             // -------------------------------------------------------------------------------------------------------------------------
             TEST_LOG_FMT("md5 iteration %u", idx + 1);
 
@@ -333,6 +393,39 @@ testRun(void)
             }
             MEM_CONTEXT_TEMP_END();
 
+            // -------------------------------------------------------------------------------------------------------------------------
+            TEST_LOG_FMT("aes-256-cbc iteration %u", idx + 1);
+
+            MEM_CONTEXT_TEMP_BEGIN()
+            {
+                BENCHMARK_BEGIN();
+                BENCHMARK_FILTER_ADD(cipherBlockNewP(cipherModeEncrypt, cipherTypeAes256Cbc, BUFSTRDEF("x")));
+                BENCHMARK_END(aes256CbcTotal);
+            }
+            MEM_CONTEXT_TEMP_END();
+
+            // -------------------------------------------------------------------------------------------------------------------------
+            TEST_LOG_FMT("aes-256-gcm iteration %u", idx + 1);
+
+            MEM_CONTEXT_TEMP_BEGIN()
+            {
+                BENCHMARK_BEGIN();
+                BENCHMARK_FILTER_ADD(cipherBlockNewP(cipherModeEncrypt, cipherTypeAes256Gcm, BUFSTRDEF("x")));
+                BENCHMARK_END(aes256GcmTotal);
+            }
+            MEM_CONTEXT_TEMP_END();
+
+            // -------------------------------------------------------------------------------------------------------------------------
+            TEST_LOG_FMT("aes-256-gcm on threads iteration %u", idx + 1);
+
+            MEM_CONTEXT_TEMP_BEGIN()
+            {
+                BENCHMARK_BEGIN();
+                BENCHMARK_FILTER_ADD(cipherFrameNewP(cipherModeEncrypt, BUFSTRDEF("x"), .threadMax = 4));
+                BENCHMARK_END(aes256GcmThreadTotal);
+            }
+            MEM_CONTEXT_TEMP_END();
+
             // -------------------------------------------------------------------------------------------------------------------------
 #ifdef HAVE_LIBLZ4
             TEST_LOG_FMT("lz4 -1 iteration %u", idx + 1);
@@ -359,7 +452,17 @@ testRun(void)
         TEST_RESULT("md5", md5Total);
         TEST_RESULT("sha1", sha1Total);
         TEST_RESULT("sha256", sha256Total);
+        TEST_RESULT("xxhash", xxHashTotal);
+        TEST_LOG_FMT(
+            "xxhash speedup over sha1: %" PRIu64 ".%02" PRIu64 "x", sha1Total / xxHashTotal,
+            sha1Total * 100 / xxHashTotal % 100);
         TEST_RESULT("gzip -6", gzip6Total);
+        TEST_RESULT("aes-256-cbc", aes256CbcTotal);
+        TEST_RESULT("aes-256-gcm", aes256GcmTotal);
+        TEST_RESULT("aes-256-gcm on threads", aes256GcmThreadTotal);
+        TEST_LOG_FMT(
+            "aes-256-gcm on threads speedup over aes-256-cbc: %" PRIu64 ".%02" PRIu64 "x", aes256CbcTotal / aes256GcmThreadTotal,
+            aes256CbcTotal * 100 / aes256GcmThreadTotal % 100);
 
 #ifdef HAVE_LIBLZ4
         TEST_RESULT("lz4 -1", lz41Total);
@@ -20,8 +20,12 @@ running out of memory on the test systems or taking an undue amount of time. It
 #include "common/type/object.h"
 #include "info/manifest.h"
 #include "postgres/version.h"
+#include "protocol/parallel.h"
+#include "protocol/server.h"
 #include "storage/posix/storage.h"
 
+#include "common/harnessConfig.h"
+#include "common/harnessFork.h"
 #include "common/harnessInfo.h"
 #include "common/harnessStorage.h"
 
@@ -131,6 +135,47 @@ storageTestManifestNewBuildList(THIS_VOID, const String *path, StorageInfoLevel
     return result;
 }
 
+/***********************************************************************************************************************************
+Send one job per manifest file to test protocolParallel() with many small files
+***********************************************************************************************************************************/
+#define TEST_PROTOCOL_COMMAND_FILE                                  STRID5("file", 0x2b1260)
+
+typedef struct TestParallelManifestData
+{
+    const Manifest *manifest;                                       // Manifest to get files from
+    unsigned int fileIdx;                                           // Next file to send
+} TestParallelManifestData;
+
+static ProtocolParallelJob *
+testParallelManifestCallback(void *const data, const unsigned int clientIdx)
+{
+    (void)clientIdx;
+    TestParallelManifestData *const jobData = data;
+
+    if (jobData->fileIdx < manifestFileTotal(jobData->manifest))
+    {
+        const ManifestFile file = manifestFile(jobData->manifest, jobData->fileIdx);
+        ProtocolCommand *const command = protocolCommandNew(TEST_PROTOCOL_COMMAND_FILE);
+        PackWrite *const param = protocolCommandParam(command);
+
+        pckWriteStrP(param, file.name);
+        pckWriteU64P(param, file.size);
+
+        return protocolParallelJobNew(VARUINT(jobData->fileIdx++), command);
+    }
+
+    return NULL;
+}
+
+// Return the size so the result is about as small as the result of copying a small file that has not changed
+static void
+testParallelManifestFileProtocol(PackRead *const param, ProtocolServer *const server)
+{
+    pckReadStrP(param);
+    protocolServerDataPut(server, pckWriteU64P(protocolPackNew(), pckReadU64P(param)));
+    protocolServerDataEndPut(server);
+}
+
 /***********************************************************************************************************************************
 Test Run
 ***********************************************************************************************************************************/
@@ -239,6 +284,12 @@ testRun(void)
     {
         ASSERT(TEST_SCALE <= 1000000);
 
+        // Load config since the manifest build depends on the pg fork
+        StringList *argList = strLstNew();
+        hrnCfgArgRawZ(argList, cfgOptStanza, "test");
+        hrnCfgArgRawZ(argList, cfgOptPgPath, "/pg");
+        HRN_CFG_LOAD(cfgCmdBackup, argList);
+
         // Create a storage driver to test manifest build with an arbitrary number of files
         StorageTestManifestNewBuild *driver = NULL;
 
@@ -254,6 +305,7 @@ testRun(void)
         }
         OBJ_NEW_END();
 
+        driver->interface.feature = 1 << storageFeaturePath;
         driver->interface.info = storageTestManifestNewBuildInfo;
         driver->interface.list = storageTestManifestNewBuildList;
 
@@ -291,6 +343,17 @@ testRun(void)
 
         TEST_LOG_FMT("completed in %ums", (unsigned int)(timeMSec() - timeBegin));
 
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("save binary manifest");
+
+        Buffer *contentSaveBin = bufNew(0);
+        timeBegin = timeMSec();
+
+        manifestSaveBin(manifest, ioBufferWriteNew(contentSaveBin));
+
+        TEST_LOG_FMT("completed in %ums", (unsigned int)(timeMSec() - timeBegin));
+        TEST_LOG_FMT("text size %zu, binary size %zu", bufUsed(contentSave), bufUsed(contentSaveBin));
+
         memContextFree(testContext);
 
         // -------------------------------------------------------------------------------------------------------------------------
@@ -306,11 +369,38 @@ testRun(void)
         }
         MEM_CONTEXT_END();
 
-        TEST_LOG_FMT("completed in %ums", (unsigned int)(timeMSec() - timeBegin));
+        const TimeMSec loadTime = timeMSec() - timeBegin;
+
+        TEST_LOG_FMT("completed in %ums", (unsigned int)loadTime);
         // TEST_LOG_FMT("memory used %zu", memContextSize(testContext));
 
         TEST_RESULT_UINT(manifestFileTotal(manifest), driver->fileTotal, "   check file total");
 
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("load binary manifest");
+
+        MemContext *const testContextBin = memContextNewP("test", .childQty = MEM_CONTEXT_QTY_MAX);
+        memContextKeep();
+        Manifest *manifestBin = NULL;
+        timeBegin = timeMSec();
+
+        MEM_CONTEXT_BEGIN(testContextBin)
+        {
+            manifestBin = manifestNewLoadBin(ioBufferReadNewOpen(contentSaveBin));
+        }
+        MEM_CONTEXT_END();
+
+        const TimeMSec loadBinTime = timeMSec() - timeBegin;
+
+        TEST_LOG_FMT("completed in %ums", (unsigned int)loadBinTime);
+        TEST_LOG_FMT(
+            "binary load speedup over text: %" PRIu64 ".%02" PRIu64 "x", (loadTime + 1) / (loadBinTime + 1),
+            (loadTime + 1) * 100 / (loadBinTime + 1) % 100);
+
+        TEST_RESULT_UINT(manifestFileTotal(manifestBin), driver->fileTotal, "   check file total");
+
+        memContextFree(testContextBin);
+
         // -------------------------------------------------------------------------------------------------------------------------
         TEST_TITLE("find all files");
 
@@ -354,6 +444,118 @@ testRun(void)
         TEST_LOG_FMT("completed in %ums", (unsigned int)(timeMSec() - timeBegin));
     }
 
+    // Small files dominate the job count for many clusters so the round trip for each job is more important than the work done
+    // *****************************************************************************************************************************
+    if (testBegin("protocolParallel() with a small-file-heavy manifest"))
+    {
+        ASSERT(TEST_SCALE <= 1000);
+
+        // Load a configuration so the PostgreSQL interface can be found when building the manifest
+        StringList *argList = strLstNew();
+        hrnCfgArgRawZ(argList, cfgOptStanza, "test");
+        hrnCfgArgRawZ(argList, cfgOptPgPath, "/pg");
+        HRN_CFG_LOAD(cfgCmdBackup, argList);
+
+        // Create a manifest with only small files
+        StorageTestManifestNewBuild *driver = NULL;
+
+        OBJ_NEW_BASE_BEGIN(StorageTestManifestNewBuild, .childQty = MEM_CONTEXT_QTY_MAX)
+        {
+            driver = OBJ_NEW_ALLOC();
+
+            *driver = (StorageTestManifestNewBuild)
+            {
+                .interface = storageInterfaceTestDummy,
+                .fileTotal = 20000 * (unsigned int)TEST_SCALE,
+            };
+        }
+        OBJ_NEW_END();
+
+        driver->interface.info = storageTestManifestNewBuildInfo;
+        driver->interface.feature = 1 << storageFeaturePath | 1 << storageFeatureInfoDetail;
+        driver->interface.list = storageTestManifestNewBuildList;
+
+        const Storage *const storagePg = storageNew(
+            strIdFromZ("test"), STRDEF("/pg"), 0, 0, false, NULL, driver, driver->interface);
+        const Manifest *const manifest = manifestNewBuild(
+            storagePg, PG_VERSION_15, 999999999, 0, false, false, false, false, NULL, NULL, NULL);
+
+        TEST_RESULT_UINT(manifestFileTotal(manifest), driver->fileTotal, "check file total");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE_FMT("send %u small files with one and several jobs in progress", manifestFileTotal(manifest));
+
+        HRN_FORK_BEGIN(.timeout = 60000)
+        {
+            HRN_FORK_CHILD_BEGIN()
+            {
+                ProtocolServer *const server = protocolServerNew(
+                    STRDEF("parallel test server"), STRDEF("test"), HRN_FORK_CHILD_READ(), HRN_FORK_CHILD_WRITE());
+
+                static const ProtocolServerHandler commandHandler[] =
+                {
+                    {.command = TEST_PROTOCOL_COMMAND_FILE, .handler = testParallelManifestFileProtocol},
+                };
+
+                protocolServerProcess(server, NULL, commandHandler, LENGTH_OF(commandHandler));
+            }
+            HRN_FORK_CHILD_END();
+
+            HRN_FORK_PARENT_BEGIN()
+            {
+                ProtocolClient *const client = protocolClientNew(
+                    STRDEF("parallel test client"), STRDEF("test"), HRN_FORK_PARENT_READ(0), HRN_FORK_PARENT_WRITE(0));
+
+                TimeMSec jobTotal[2] = {0};
+                const unsigned int jobMax[2] = {1, 4};
+
+                for (unsigned int jobIdx = 0; jobIdx < LENGTH_OF(jobMax); jobIdx++)
+                {
+                    MEM_CONTEXT_TEMP_BEGIN()
+                    {
+                        TestParallelManifestData data = {.manifest = manifest};
+                        ProtocolParallel *const parallel = protocolParallelNewP(
+                            60000, testParallelManifestCallback, &data, .jobMax = jobMax[jobIdx]);
+                        protocolParallelClientAdd(parallel, client);
+
+                        uint64_t sizeTotal = 0;
+                        const TimeMSec timeBegin = timeMSec();
+
+                        do
+                        {
+                            unsigned int completed = protocolParallelProcess(parallel);
+
+                            for (unsigned int resultIdx = 0; resultIdx < completed; resultIdx++)
+                            {
+                                ProtocolParallelJob *const job = protocolParallelResult(parallel);
+
+                                sizeTotal += pckReadU64P(protocolParallelJobResult(job));
+                                protocolParallelJobFree(job);
+                            }
+                        }
+                        while (!protocolParallelDone(parallel));
+
+                        jobTotal[jobIdx] = timeMSec() - timeBegin;
+
+                        TEST_RESULT_UINT(
+                            sizeTotal, (uint64_t)manifestFileTotal(manifest) * 8192,
+                            zNewFmt("check size with %u job(s)", jobMax[jobIdx]));
+                        TEST_LOG_FMT("sent with %u job(s) in %" PRIu64 "ms", jobMax[jobIdx], jobTotal[jobIdx]);
+                    }
+                    MEM_CONTEXT_TEMP_END();
+                }
+
+                TEST_LOG_FMT(
+                    "speedup with jobs in progress: %" PRIu64 ".%02" PRIu64 "x", jobTotal[0] / (jobTotal[1] + 1),
+                    jobTotal[0] * 100 / (jobTotal[1] + 1) % 100);
+
+                protocolClientFree(client);
+            }
+            HRN_FORK_PARENT_END();
+        }
+        HRN_FORK_END();
+    }
+
     // *****************************************************************************************************************************
     if (testBegin("SocketClient"))
     {
@@ -0,0 +1,186 @@
+/***********************************************************************************************************************************
+WAL Filter Performance
+
+Test the performance of filtering GPDB WAL segments for partial restore.
+
+Generally speaking, the starting values should be high enough to "blow up" in terms of execution time if there are performance
+problems without taking very long if everything is running smoothly. These starting values can then be scaled up for profiling and
+stress testing as needed.
+***********************************************************************************************************************************/
+#include "common/harnessConfig.h"
+#include "common/harnessFork.h"
+#include "common/harnessWal.h"
+
+#include "common/io/bufferRead.h"
+#include "common/io/io.h"
+#include "common/time.h"
+#include "common/walFilter/versions/xlogInfoGPDB6.h"
+#include "common/walFilter/walFilter.h"
+#include "postgres/version.h"
+#include "storage/posix/storage.h"
+
+/***********************************************************************************************************************************
+Filter a segment and return the size of the result
+***********************************************************************************************************************************/
+static uint64_t
+testWalFilter(const PgControl pgControl, const Buffer *const wal)
+{
+    uint64_t result = 0;
+
+    MEM_CONTEXT_TEMP_BEGIN()
+    {
+        IoRead *const read = ioBufferReadNew(wal);
+        ioFilterGroupAdd(ioReadFilterGroup(read), walFilterNew(pgControl, NULL));
+        ioReadOpen(read);
+
+        Buffer *const output = bufNew(ioBufferSize());
+
+        while (!ioReadEof(read))
+        {
+            ioRead(read, output);
+            result += bufUsed(output);
+            bufUsedZero(output);
+        }
+
+        ioReadClose(read);
+    }
+    MEM_CONTEXT_TEMP_END();
+
+    return result;
+}
+
+/***********************************************************************************************************************************
+Test Run
+***********************************************************************************************************************************/
+static void
+testRun(void)
+{
+    FUNCTION_HARNESS_VOID();
+
+    // *****************************************************************************************************************************
+    if (testBegin("walFilterProcess()"))
+    {
+        // One segment is a realistic unit of work since archive-get filters each segment independently
+        ASSERT(TEST_SCALE <= 1024);
+        const uint64_t iteration = TEST_SCALE;
+        const unsigned int tableTotal = 20;
+
+        const PgControl pgControl =
+        {
+            .version = PG_VERSION_94,
+            .pageSize = DEFAULT_GDPB_PAGE_SIZE,
+            .walPageSize = DEFAULT_GDPB_XLOG_PAGE_SIZE,
+            .walSegmentSize = GPDB6_XLOG_SEG_SIZE,
+        };
+
+        // Keep half of the tables so half of the records are replaced with noop records
+        String *const filter = strCatZ(strNew(), "[{\"dbOid\":16384,\"tables\":[");
+
+        for (unsigned int tableIdx = 0; tableIdx < tableTotal; tableIdx += 2)
+            strCatFmt(filter, "%s{\"relfilenode\":%u}", tableIdx == 0 ? "" : ",", 16385 + tableIdx);
+
+        strCatZ(filter, "]}]");
+        storagePutP(storageNewWriteP(storagePosixNewP(TEST_PATH_STR, .write = true), STRDEF("filter.json")), BUFSTR(filter));
+
+        StringList *argList = strLstNew();
+        hrnCfgArgRawZ(argList, cfgOptStanza, "test");
+        hrnCfgArgRawZ(argList, cfgOptPgPath, TEST_PATH "/pg");
+        hrnCfgArgRawZ(argList, cfgOptRepoPath, TEST_PATH "/repo");
+        hrnCfgArgRawZ(argList, cfgOptFork, CFGOPTVAL_FORK_GPDB_Z);
+        hrnCfgArgRawZ(argList, cfgOptFilter, TEST_PATH "/filter.json");
+        HRN_CFG_LOAD(cfgCmdArchiveGet, argList);
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("build segment");
+
+        // Mostly heap records with a small tuple and a full page image now and then, which is typical for an insert workload
+        Buffer *const wal = bufNew(GPDB6_XLOG_SEG_SIZE);
+        unsigned char body[DEFAULT_GDPB_PAGE_SIZE / 4] = {0};
+        unsigned int recordTotal = 0;
+
+        while (bufUsed(wal) < GPDB6_XLOG_SEG_SIZE - sizeof(body) - DEFAULT_GDPB_XLOG_PAGE_SIZE)
+        {
+            const RelFileNode node = {.spcNode = 1663, .dbNode = 16384, .relNode = 16385 + recordTotal % tableTotal};
+            memcpy(body, &node, sizeof(node));
+
+            XLogRecord *const record = hrnGpdbCreateXRecordP(
+                RM_HEAP_ID, XLOG_HEAP_INSERT, recordTotal % 64 == 63 ? sizeof(body) : 120, body);
+            hrnGpdbWalInsertXRecordSimple(wal, record);
+            memFree(record);
+
+            recordTotal++;
+        }
+
+        hrnGpdbWalInsertXRecordSimple(wal, hrnGpdbCreateXRecordP(RM_XLOG_ID, XLOG_SWITCH, 0, NULL));
+        memset(bufRemainsPtr(wal), 0, bufSize(wal) - bufUsed(wal));
+        bufUsedSet(wal, bufSize(wal));
+
+        TEST_LOG_FMT("%u records", recordTotal);
+
+        // Output size matches the input since filtered records are rewritten in place
+        ASSERT(testWalFilter(pgControl, wal) == bufUsed(wal));
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE_FMT("filter %" PRIu64 " segment(s)", iteration);
+
+        TimeMSec timeBegin = timeMSec();
+
+        for (uint64_t iterationIdx = 0; iterationIdx < iteration; iterationIdx++)
+            testWalFilter(pgControl, wal);
+
+        // Add 1ms just in case something takes 0ms to run
+        uint64_t total = timeMSec() - timeBegin + 1;
+
+        TEST_LOG_FMT(
+            "time %" PRIu64 "ms, throughput: %" PRIu64 "MB/s", total,
+            iteration * GPDB6_XLOG_SEG_SIZE * 1000 / total / 1000000);
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        // With io-thread enabled the records are checksummed on worker threads. This only helps when spare cores are available.
+        TEST_TITLE_FMT("filter %" PRIu64 " segment(s) with io-thread", iteration);
+
+        ioThreadSet(true);
+        timeBegin = timeMSec();
+
+        for (uint64_t iterationIdx = 0; iterationIdx < iteration; iterationIdx++)
+            testWalFilter(pgControl, wal);
+
+        total = timeMSec() - timeBegin + 1;
+        ioThreadSet(false);
+
+        TEST_LOG_FMT(
+            "time %" PRIu64 "ms, throughput: %" PRIu64 "MB/s", total,
+            iteration * GPDB6_XLOG_SEG_SIZE * 1000 / total / 1000000);
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        // Archive-get filters segments in parallel using local processes so measure how throughput scales with the process count
+        for (unsigned int processTotal = 2; processTotal <= HRN_FORK_CHILD_MAX; processTotal *= 2)
+        {
+            TEST_TITLE_FMT("filter %" PRIu64 " segment(s) in each of %u processes", iteration, processTotal);
+
+            timeBegin = timeMSec();
+
+            HRN_FORK_BEGIN(.timeout = 600000)
+            {
+                for (unsigned int processIdx = 0; processIdx < processTotal; processIdx++)
+                {
+                    HRN_FORK_CHILD_BEGIN()
+                    {
+                        for (uint64_t iterationIdx = 0; iterationIdx < iteration; iterationIdx++)
+                            testWalFilter(pgControl, wal);
+                    }
+                    HRN_FORK_CHILD_END();
+                }
+            }
+            HRN_FORK_END();
+
+            total = timeMSec() - timeBegin + 1;
+
+            TEST_LOG_FMT(
+                "time %" PRIu64 "ms, aggregate throughput: %" PRIu64 "MB/s", total,
+                processTotal * iteration * GPDB6_XLOG_SEG_SIZE * 1000 / total / 1000000);
+        }
+    }
+
+    FUNCTION_HARNESS_RETURN_VOID();
+}
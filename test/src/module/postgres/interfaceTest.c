@@ -736,5 +736,64 @@ testRun(void)
         TEST_RESULT_UINT(info.checkpoint, 0xDEAD, "check invalid checkpoint");
     }
 
+    // *****************************************************************************************************************************
+    if (testBegin("crc32cOne() and crc32cComp()"))
+    {
+        TEST_TITLE("check value");
+
+        TEST_RESULT_UINT(crc32cOne((const unsigned char *)"123456789", 9), 0xE3069283, "crc32c");
+        TEST_RESULT_UINT(crc32One((const unsigned char *)"123456789", 9), 0xC40ED0B0, "crc32");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("all implementations match byte-wise calculation");
+
+        unsigned char data[8192 * 2 + 16];
+
+        for (unsigned int dataIdx = 0; dataIdx < sizeof(data); dataIdx++)
+            data[dataIdx] = (unsigned char)(dataIdx * 7919 + (dataIdx >> 8));
+
+        const size_t sizeList[] = {0, 1, 7, 8, 9, 63, 767, 768, 769, 2305, 8192, 8192 * 2};
+        bool match = true;
+
+        for (unsigned int sizeIdx = 0; sizeIdx < LENGTH_OF(sizeList); sizeIdx++)
+        {
+            // Use offsets to test unaligned input
+            for (unsigned int offset = 0; offset < 16; offset += 5)
+            {
+                const unsigned char *const buffer = data + offset;
+                const size_t size = sizeList[sizeIdx];
+                uint32_t expected = crc32cInit();
+
+                for (size_t bufferIdx = 0; bufferIdx < size; bufferIdx++)
+                    expected = crc32c_lookup[(expected ^ buffer[bufferIdx]) & 0xFF] ^ (expected >> 8);
+
+                match &= crc32cComp(crc32cInit(), buffer, size) == expected;
+                match &= crc32cCompSb8(crc32cInit(), buffer, size) == expected;
+
+#if defined(CRC32C_X86_64)
+                if (__builtin_cpu_supports("sse4.2"))
+                    match &= crc32cCompSse42(crc32cInit(), buffer, size) == expected;
+
+                if (crc32cCompImpl == crc32cCompSse42Clmul)
+                    match &= crc32cCompSse42Clmul(crc32cInit(), buffer, size) == expected;
+#elif defined(CRC32C_AARCH64)
+                if (crc32cCompImpl == crc32cCompArmv8)
+                    match &= crc32cCompArmv8(crc32cInit(), buffer, size) == expected;
+#endif
+            }
+        }
+
+        TEST_RESULT_BOOL(match, true, "crc32c matches");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("calculation in steps");
+
+        uint32_t crc = crc32cInit();
+        crc = crc32cComp(crc, data, 100);
+        crc = crc32cComp(crc, data + 100, 8092);
+
+        TEST_RESULT_UINT(crc32cFinish(crc), crc32cOne(data, 8192), "crc32c matches");
+    }
+
     FUNCTION_HARNESS_RETURN_VOID();
 }
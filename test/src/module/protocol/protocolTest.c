@@ -1,6 +1,8 @@
 /***********************************************************************************************************************************
 Test Protocol
 ***********************************************************************************************************************************/
+#include <limits.h>
+
 #include "common/io/bufferRead.h"
 #include "common/io/bufferWrite.h"
 #include "common/io/fdRead.h"
@@ -982,7 +984,7 @@ testRun(void)
             {
                 TestParallelJobCallback data = {.jobList = lstNewP(sizeof(ProtocolParallelJob *))};
                 ProtocolParallel *parallel = NULL;
-                TEST_ASSIGN(parallel, protocolParallelNew(2000, testParallelJobCallback, &data), "create parallel");
+                TEST_ASSIGN(parallel, protocolParallelNewP(2000, testParallelJobCallback, &data), "create parallel");
                 TEST_RESULT_VOID(
                     FUNCTION_LOG_OBJECT_FORMAT(parallel, protocolParallelToLog, logBuf, sizeof(logBuf)), "protocolParallelToLog");
                 TEST_RESULT_Z(logBuf, "{state: pending, clientTotal: 0, jobTotal: 0}", "check log");
@@ -1103,7 +1105,7 @@ testRun(void)
                 TEST_TITLE("process zero jobs");
 
                 data = (TestParallelJobCallback){.jobList = lstNewP(sizeof(ProtocolParallelJob *))};
-                TEST_ASSIGN(parallel, protocolParallelNew(2000, testParallelJobCallback, &data), "create parallel");
+                TEST_ASSIGN(parallel, protocolParallelNewP(2000, testParallelJobCallback, &data), "create parallel");
                 TEST_RESULT_VOID(protocolParallelClientAdd(parallel, client[0]), "add client");
 
                 TEST_RESULT_INT(protocolParallelProcess(parallel), 0, "process zero jobs");
@@ -1120,6 +1122,237 @@ testRun(void)
             HRN_FORK_PARENT_END();
         }
         HRN_FORK_END();
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("queued jobs");
+
+        HRN_FORK_BEGIN(.timeout = 5000)
+        {
+            HRN_FORK_CHILD_BEGIN(.prefix = "local server")
+            {
+                ProtocolServer *server = NULL;
+                TEST_ASSIGN(
+                    server,
+                    protocolServerNew(STRDEF("local server 1"), STRDEF("test"), HRN_FORK_CHILD_READ(), HRN_FORK_CHILD_WRITE()),
+                    "local server 1");
+
+                TEST_RESULT_UINT(protocolServerCommandGet(server).id, strIdFromZ("c-one"), "c-one command get");
+                TEST_RESULT_UINT(protocolServerCommandGet(server).id, strIdFromZ("c2"), "c2 command get");
+                TEST_RESULT_UINT(protocolServerCommandGet(server).id, strIdFromZ("c-three"), "c-three command get");
+
+                // Put all results with a single write so they are buffered together by the client
+                Buffer *const resultBuffer = bufNew(0);
+                IoWrite *const resultWrite = ioBufferWriteNew(resultBuffer);
+                ioWriteOpen(resultWrite);
+
+                ProtocolServer *serverResult = NULL;
+                TEST_ASSIGN(
+                    serverResult, protocolServerNew(STRDEF("local server 1"), STRDEF("test"), HRN_FORK_CHILD_READ(), resultWrite),
+                    "buffered server");
+                bufUsedZero(resultBuffer);
+
+                TEST_RESULT_VOID(protocolServerDataPut(serverResult, pckWriteU32P(protocolPackNew(), 1)), "data put");
+                TEST_RESULT_VOID(protocolServerDataEndPut(serverResult), "data end put");
+                TEST_RESULT_VOID(protocolServerError(serverResult, 39, STRDEF("very serious error"), STRDEF("stack")), "error put");
+                TEST_RESULT_VOID(protocolServerDataPut(serverResult, pckWriteU32P(protocolPackNew(), 3)), "data put");
+                TEST_RESULT_VOID(protocolServerDataEndPut(serverResult), "data end put");
+
+                TEST_RESULT_VOID(ioWrite(HRN_FORK_CHILD_WRITE(), resultBuffer), "write results");
+                TEST_RESULT_VOID(ioWriteFlush(HRN_FORK_CHILD_WRITE()), "flush results");
+
+                TEST_RESULT_UINT(protocolServerCommandGet(server).id, strIdFromZ("c-four"), "c-four command get");
+                TEST_RESULT_VOID(protocolServerDataPut(server, pckWriteU32P(protocolPackNew(), 4)), "data put");
+                TEST_RESULT_VOID(protocolServerDataEndPut(server), "data end put");
+
+                // Wait for exit
+                TEST_RESULT_UINT(protocolServerCommandGet(server).id, PROTOCOL_COMMAND_EXIT, "wait for exit");
+            }
+            HRN_FORK_CHILD_END();
+
+            HRN_FORK_PARENT_BEGIN(.prefix = "local client")
+            {
+                TestParallelJobCallback data = {.jobList = lstNewP(sizeof(ProtocolParallelJob *))};
+                ProtocolParallel *parallel = NULL;
+                TEST_ASSIGN(parallel, protocolParallelNewP(2000, testParallelJobCallback, &data, .jobMax = 3), "create parallel");
+
+                ProtocolClient *client = NULL;
+                TEST_ASSIGN(
+                    client,
+                    protocolClientNew(STRDEF("local client 0"), STRDEF("test"), HRN_FORK_PARENT_READ(0), HRN_FORK_PARENT_WRITE(0)),
+                    "local client new");
+                TEST_RESULT_VOID(protocolParallelClientAdd(parallel, client), "local client add");
+
+                const char *const commandList[] = {"c-one", "c2", "c-three", "c-four"};
+
+                for (unsigned int commandIdx = 0; commandIdx < LENGTH_OF(commandList); commandIdx++)
+                {
+                    ProtocolParallelJob *const job = protocolParallelJobNew(
+                        VARUINT(commandIdx + 1), protocolCommandNew(strIdFromZ(commandList[commandIdx])));
+                    lstAdd(data.jobList, &job);
+                }
+
+                // -----------------------------------------------------------------------------------------------------------------
+                TEST_TITLE("error on queue when command data is expected");
+
+                ProtocolClient clientError =
+                {
+                    .pub = {.read = ioBufferReadNew(bufNew(0))},
+                    .name = STRDEF("test"),
+                    .state = protocolClientStateCommandDataGet,
+                };
+
+                TEST_ERROR(
+                    protocolClientCommandQueue(&clientError, protocolCommandNew(strIdFromZ("c-one"))), ProtocolError,
+                    "client state is 'cmd-data-get' but expected 'data-get'");
+
+                // -----------------------------------------------------------------------------------------------------------------
+                TEST_TITLE("queue jobs up to the max");
+
+                TEST_RESULT_INT(protocolParallelProcess(parallel), 0, "process jobs");
+                TEST_RESULT_UINT(data.jobIdx, 3, "check jobs queued");
+
+                // -----------------------------------------------------------------------------------------------------------------
+                TEST_TITLE("buffered results are read in order");
+
+                TEST_RESULT_INT(protocolParallelProcess(parallel), 3, "process jobs");
+                TEST_RESULT_UINT(data.jobIdx, 4, "check last job queued");
+
+                ProtocolParallelJob *job = NULL;
+                TEST_ASSIGN(job, protocolParallelResult(parallel), "get result");
+                TEST_RESULT_UINT(varUInt(protocolParallelJobKey(job)), 1, "check key is 1");
+                TEST_RESULT_UINT(pckReadU32P(protocolParallelJobResult(job)), 1, "check result is 1");
+
+                TEST_ASSIGN(job, protocolParallelResult(parallel), "get result");
+                TEST_RESULT_UINT(varUInt(protocolParallelJobKey(job)), 2, "check key is 2");
+                TEST_RESULT_STR_Z(
+                    protocolParallelJobErrorMessage(job), "raised from local client 0: very serious error", "check error message");
+
+                TEST_ASSIGN(job, protocolParallelResult(parallel), "get result");
+                TEST_RESULT_UINT(varUInt(protocolParallelJobKey(job)), 3, "check key is 3");
+                TEST_RESULT_UINT(pckReadU32P(protocolParallelJobResult(job)), 3, "check result is 3");
+
+                TEST_RESULT_PTR(protocolParallelResult(parallel), NULL, "check no more results");
+
+                // -----------------------------------------------------------------------------------------------------------------
+                TEST_TITLE("result for last job");
+
+                TEST_RESULT_INT(protocolParallelProcess(parallel), 1, "process jobs");
+
+                TEST_ASSIGN(job, protocolParallelResult(parallel), "get result");
+                TEST_RESULT_UINT(varUInt(protocolParallelJobKey(job)), 4, "check key is 4");
+                TEST_RESULT_UINT(pckReadU32P(protocolParallelJobResult(job)), 4, "check result is 4");
+
+                TEST_RESULT_BOOL(protocolParallelDone(parallel), true, "check done");
+
+                TEST_RESULT_VOID(protocolParallelFree(parallel), "free parallel");
+                TEST_RESULT_VOID(protocolClientFree(client), "free client");
+            }
+            HRN_FORK_PARENT_END();
+        }
+        HRN_FORK_END();
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("large commands are not queued");
+
+        HRN_FORK_BEGIN(.timeout = 5000)
+        {
+            HRN_FORK_CHILD_BEGIN(.prefix = "local server")
+            {
+                ProtocolServer *server = NULL;
+                TEST_ASSIGN(
+                    server,
+                    protocolServerNew(STRDEF("local server 1"), STRDEF("test"), HRN_FORK_CHILD_READ(), HRN_FORK_CHILD_WRITE()),
+                    "local server 1");
+
+                // Commands put directly by the client
+                const char *const commandList[] = {"c-one", "c2", "c-big"};
+
+                for (unsigned int commandIdx = 0; commandIdx < LENGTH_OF(commandList); commandIdx++)
+                {
+                    TEST_RESULT_UINT(
+                        protocolServerCommandGet(server).id, strIdFromZ(commandList[commandIdx]), "command get");
+                    TEST_RESULT_VOID(protocolServerDataPut(server, pckWriteU32P(protocolPackNew(), commandIdx + 1)), "data put");
+                    TEST_RESULT_VOID(protocolServerDataEndPut(server), "data end put");
+                }
+
+                // Commands put by the parallel executor
+                for (unsigned int commandIdx = 0; commandIdx < 2; commandIdx++)
+                {
+                    TEST_RESULT_UINT(
+                        protocolServerCommandGet(server).id, strIdFromZ(commandIdx == 0 ? "c-one" : "c-big"), "command get");
+                    TEST_RESULT_VOID(protocolServerDataPut(server, pckWriteU32P(protocolPackNew(), commandIdx + 1)), "data put");
+                    TEST_RESULT_VOID(protocolServerDataEndPut(server), "data end put");
+                }
+
+                // Wait for exit
+                TEST_RESULT_UINT(protocolServerCommandGet(server).id, PROTOCOL_COMMAND_EXIT, "wait for exit");
+            }
+            HRN_FORK_CHILD_END();
+
+            HRN_FORK_PARENT_BEGIN(.prefix = "local client")
+            {
+                ProtocolClient *client = NULL;
+                TEST_ASSIGN(
+                    client,
+                    protocolClientNew(STRDEF("local client 0"), STRDEF("test"), HRN_FORK_PARENT_READ(0), HRN_FORK_PARENT_WRITE(0)),
+                    "local client new");
+
+                // Command with a parameter that does not fit in the pipe buffer
+                ProtocolCommand *commandBig = protocolCommandNew(strIdFromZ("c-big"));
+                pckWriteStrP(protocolCommandParam(commandBig), strNewFmt("%*s", PIPE_BUF, ""));
+
+                // -----------------------------------------------------------------------------------------------------------------
+                TEST_TITLE("queue commands on the client");
+
+                TEST_RESULT_BOOL(protocolClientCommandQueue(client, protocolCommandNew(strIdFromZ("c-one"))), true, "put c-one");
+                TEST_RESULT_BOOL(protocolClientCommandQueue(client, commandBig), false, "c-big not queued");
+                TEST_RESULT_BOOL(protocolClientCommandQueue(client, protocolCommandNew(strIdFromZ("c2"))), true, "queue c2");
+
+                TEST_RESULT_UINT(pckReadU32P(protocolClientDataGet(client)), 1, "c-one result");
+                TEST_RESULT_VOID(protocolClientDataEndGet(client), "c-one end");
+                TEST_RESULT_UINT(pckReadU32P(protocolClientDataGet(client)), 2, "c2 result");
+                TEST_RESULT_VOID(protocolClientDataEndGet(client), "c2 end");
+
+                TEST_RESULT_BOOL(protocolClientCommandQueue(client, commandBig), true, "put c-big when idle");
+                TEST_RESULT_UINT(pckReadU32P(protocolClientDataGet(client)), 3, "c-big result");
+                TEST_RESULT_VOID(protocolClientDataEndGet(client), "c-big end");
+
+                // -----------------------------------------------------------------------------------------------------------------
+                TEST_TITLE("hold job until it can be queued");
+
+                TestParallelJobCallback data = {.jobList = lstNewP(sizeof(ProtocolParallelJob *))};
+                ProtocolParallel *parallel = NULL;
+                TEST_ASSIGN(parallel, protocolParallelNewP(2000, testParallelJobCallback, &data, .jobMax = 2), "create parallel");
+                TEST_RESULT_VOID(protocolParallelClientAdd(parallel, client), "local client add");
+
+                ProtocolParallelJob *job = protocolParallelJobNew(VARUINT(1), protocolCommandNew(strIdFromZ("c-one")));
+                lstAdd(data.jobList, &job);
+
+                commandBig = protocolCommandNew(strIdFromZ("c-big"));
+                pckWriteStrP(protocolCommandParam(commandBig), strNewFmt("%*s", PIPE_BUF, ""));
+                job = protocolParallelJobNew(VARUINT(2), commandBig);
+                lstAdd(data.jobList, &job);
+
+                TEST_RESULT_INT(protocolParallelProcess(parallel), 0, "process jobs");
+                TEST_RESULT_UINT(data.jobIdx, 2, "both jobs fetched");
+
+                TEST_RESULT_INT(protocolParallelProcess(parallel), 1, "process jobs");
+                TEST_ASSIGN(job, protocolParallelResult(parallel), "get result");
+                TEST_RESULT_UINT(varUInt(protocolParallelJobKey(job)), 1, "check key is 1");
+
+                TEST_RESULT_INT(protocolParallelProcess(parallel), 1, "process jobs");
+                TEST_ASSIGN(job, protocolParallelResult(parallel), "get result");
+                TEST_RESULT_UINT(varUInt(protocolParallelJobKey(job)), 2, "check key is 2");
+                TEST_RESULT_UINT(pckReadU32P(protocolParallelJobResult(job)), 2, "check result is 2");
+
+                TEST_RESULT_BOOL(protocolParallelDone(parallel), true, "check done");
+
+                TEST_RESULT_VOID(protocolParallelFree(parallel), "free parallel");
+                TEST_RESULT_VOID(protocolClientFree(client), "free client");
+            }
+            HRN_FORK_PARENT_END();
+        }
+        HRN_FORK_END();
     }
 
     // *****************************************************************************************************************************
@@ -32,6 +32,7 @@ typedef struct TestRequestParam
     VAR_PARAM_HEADER;
     const char *content;
     const char *blobType;
+    const char *ifMatch;
     const char *range;
     const char *tag;
 } TestRequestParam;
@@ -87,6 +88,10 @@ testRequest(IoWrite *write, const char *verb, const char *path, TestRequestParam
     // Add host
     strCatFmt(request, "host:%s\r\n", strZ(hrnServerHost()));
 
+    // Add if-match
+    if (param.ifMatch != NULL)
+        strCatFmt(request, "if-match:%s\r\n", param.ifMatch);
+
     // Add range
     if (param.range != NULL)
         strCatFmt(request, "range:bytes=%s\r\n", param.range);
@@ -398,8 +403,8 @@ testRun(void)
             (StorageAzure *)storageDriver(
                 storageAzureNew(
                     STRDEF("/repo"), false, NULL, TEST_CONTAINER_STR, TEST_ACCOUNT_STR, storageAzureKeyTypeShared,
-                    TEST_KEY_SHARED_STR, 16, NULL, STRDEF("blob.core.windows.net"), storageAzureUriStyleHost, 443, 1000, true, NULL,
-                    NULL)),
+                    TEST_KEY_SHARED_STR, 16, 16, 1, NULL, STRDEF("blob.core.windows.net"), storageAzureUriStyleHost, 443, 1000,
+                    true, NULL, NULL)),
             "new azure storage - shared key");
 
         // -------------------------------------------------------------------------------------------------------------------------
@@ -415,6 +420,22 @@ testRun(void)
             ", x-ms-version: '2019-12-12', authorization: 'SharedKey account:wZCOnSPB1KkkdjaQMcThkkKyUlfS0pPjwaIfd1cUh4Y='}",
             "check headers");
 
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("auth with if-match and range");
+
+        header = httpHeaderAdd(httpHeaderNew(NULL), HTTP_HEADER_CONTENT_LENGTH_STR, ZERO_STR);
+        httpHeaderAdd(header, HTTP_HEADER_IF_MATCH_STR, STRDEF("\"0x8D\""));
+        httpHeaderAdd(header, HTTP_HEADER_RANGE_STR, STRDEF("bytes=16-31"));
+
+        TEST_RESULT_VOID(storageAzureAuth(storage, HTTP_VERB_GET_STR, STRDEF("/path/file"), NULL, dateTime, header), "auth");
+        TEST_RESULT_VOID(FUNCTION_LOG_OBJECT_FORMAT(header, httpHeaderToLog, logBuf, sizeof(logBuf)), "httpHeaderToLog");
+        TEST_RESULT_Z(
+            logBuf,
+            "{content-length: '0', if-match: '\"0x8D\"', range: 'bytes=16-31', host: 'account.blob.core.windows.net'"
+            ", date: 'Sun, 21 Jun 2020 12:46:19 GMT', x-ms-version: '2019-12-12'"
+            ", authorization: 'SharedKey account:azTdfPbZ6IQhv9qUb5/PX5k4y9Bmnnj+m7wlmKMT0e8='}",
+            "check headers");
+
         // -------------------------------------------------------------------------------------------------------------------------
         TEST_TITLE("auth with md5 and query");
 
@@ -440,7 +461,8 @@ testRun(void)
             (StorageAzure *)storageDriver(
                 storageAzureNew(
                     STRDEF("/repo"), false, NULL, TEST_CONTAINER_STR, TEST_ACCOUNT_STR, storageAzureKeyTypeSas, TEST_KEY_SAS_STR,
-                    16, NULL, STRDEF("blob.core.usgovcloudapi.net"), storageAzureUriStyleHost, 443, 1000, true, NULL, NULL)),
+                    16, 16, 1, NULL, STRDEF("blob.core.usgovcloudapi.net"), storageAzureUriStyleHost, 443, 1000, true, NULL,
+                    NULL)),
             "new azure storage - sas key");
 
         query = httpQueryAdd(httpQueryNewP(), STRDEF("a"), STRDEF("b"));
@@ -526,6 +548,26 @@ testRun(void)
                     strNewBuf(storageGetP(storageNewReadP(storage, STRDEF("file.txt"), .offset = 1, .limit = VARUINT64(21)))),
                     "this is a sample file", "get file");
 
+                // -----------------------------------------------------------------------------------------------------------------
+                TEST_TITLE("get file with concurrent ranged requests");
+
+                driver->downloadChunkSize = 16;
+                driver->downloadMax = 2;
+
+                testRequestP(service, HTTP_VERB_GET, "/file.txt", .range = "1-21");
+                testResponseP(service, .header = "etag:\"0x8D\"", .content = "this is a sample file");
+                hrnServerScriptClose(service);
+
+                hrnServerScriptAccept(service);
+                testRequestP(service, HTTP_VERB_GET, "/file.txt", .ifMatch = "\"0x8D\"", .range = "17-21");
+                testResponseP(service, .code = 206, .content = " file");
+
+                TEST_RESULT_STR_Z(
+                    strNewBuf(storageGetP(storageNewReadP(storage, STRDEF("file.txt"), .offset = 1, .limit = VARUINT64(21)))),
+                    "this is a sample file", "get file");
+
+                driver->downloadMax = 1;
+
                 // -----------------------------------------------------------------------------------------------------------------
                 TEST_TITLE("get zero-length file");
 
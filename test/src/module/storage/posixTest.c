@@ -375,11 +375,13 @@ testRun(void)
         // -------------------------------------------------------------------------------------------------------------------------
         TEST_TITLE("helper function - storagePosixListEntry()");
 
+        StorageList *list = storageLstNew(storageInfoLevelBasic);
+
         TEST_RESULT_VOID(
             storagePosixListEntry(
-                (StoragePosix *)storageDriver(storageTest), storageLstNew(storageInfoLevelBasic), STRDEF("pg"), "missing",
-                storageInfoLevelBasic),
+                list, STRDEF("pg"), -1, &(StoragePosixListStat){.name = "missing", .errNo = ENOENT}, storageInfoLevelBasic),
             "missing path");
+        TEST_RESULT_UINT(storageLstSize(list), 0, "entry not added");
 
         // -------------------------------------------------------------------------------------------------------------------------
         TEST_TITLE("path with only dot");
@@ -518,6 +520,36 @@ testRun(void)
             storageTest, "pg",
             "path/file {s=8, t=1656434296}\n",
             .level = storageInfoLevelBasic, .expression = "\\/file$");
+
+        // -------------------------------------------------------------------------------------------------------------------------
+        TEST_TITLE("stat entries on threads");
+
+        Storage *const storageThread = storagePosixNewP(TEST_PATH_STR, .write = true, .listThreadMax = 3);
+
+        for (unsigned int fileIdx = 0; fileIdx < 2500; fileIdx++)
+            HRN_STORAGE_PUT_EMPTY(storageThread, zNewFmt("thread/file%04u", fileIdx));
+
+        HRN_SYSTEM("ln -s ../file " TEST_PATH "/thread/link");
+
+        StorageList *threadList = NULL;
+        TEST_ASSIGN(
+            threadList, storageInterfaceListP(storageDriver(storageThread), STRDEF(TEST_PATH "/thread"), storageInfoLevelDetail),
+            "list");
+        TEST_RESULT_UINT(storageLstSize(threadList), 2501, "check size");
+
+        unsigned int fileTotal = 0;
+
+        for (unsigned int listIdx = 0; listIdx < storageLstSize(threadList); listIdx++)
+        {
+            const StorageInfo info = storageLstGet(threadList, listIdx);
+
+            if (info.type == storageTypeLink)
+                TEST_RESULT_STR_Z(info.linkDestination, "../file", "check link destination");
+            else if (info.type == storageTypeFile && info.size == 0)
+                fileTotal++;
+        }
+
+        TEST_RESULT_UINT(fileTotal, 2500, "check files");
     }
 
     // *****************************************************************************************************************************
@@ -27,6 +27,7 @@ typedef struct TestRequestParam
     const char *content;
     const char *accessKey;
     const char *securityToken;
+    const char *ifMatch;
     const char *range;
     const char *kms;
     const char *sseC;
@@ -72,6 +73,9 @@ testRequest(IoWrite *write, Storage *s3, const char *verb, const char *path, Tes
 
         strCatZ(request, "host;");
 
+        if (param.ifMatch != NULL)
+            strCatZ(request, "if-match;");
+
         if (param.range != NULL)
             strCatZ(request, "range;");
 
@@ -118,6 +122,10 @@ testRequest(IoWrite *write, Storage *s3, const char *verb, const char *path, Tes
     else
         strCatFmt(request, "host:%s\r\n", strZ(hrnServerHost()));
 
+    // Add if-match
+    if (param.ifMatch != NULL)
+        strCatFmt(request, "if-match:%s\r\n", param.ifMatch);
+
     // Add range
     if (param.range != NULL)
         strCatFmt(request, "range:bytes=%s\r\n", param.range);
@@ -458,6 +466,7 @@ testRun(void)
                 TEST_RESULT_STR(s3->path, path, "check path");
                 TEST_RESULT_BOOL(storageFeature(s3, storageFeaturePath), false, "check path feature");
                 TEST_RESULT_UINT(driver->partSize, 5 * 1024 * 1024, "check part size");
+                TEST_RESULT_UINT(driver->downloadChunkSize, 16 * 1024 * 1024, "check download chunk size");
 
                 // -----------------------------------------------------------------------------------------------------------------
                 TEST_TITLE("coverage for noop functions");
@@ -493,6 +502,61 @@ testRun(void)
                     strNewBuf(storageGetP(storageNewReadP(s3, STRDEF("file.txt"), .offset = 1, .limit = VARUINT64(21)))),
                     "this is a sample file", "get file");
 
+                // -----------------------------------------------------------------------------------------------------------------
+                TEST_TITLE("get file with concurrent ranged requests");
+
+                driver->downloadChunkSize = 8;
+                driver->downloadMax = 2;
+
+                // Only the first chunk is read from the first response. The server closes each connection after replying so it
+                // only needs to track one connection at a time.
+                testRequestP(service, s3, HTTP_VERB_GET, "/file.txt", .range = "1-21");
+                testResponseP(service, .header = "etag:\"AAA\"", .content = "this is a sample file");
+                hrnServerScriptClose(service);
+
+                hrnServerScriptAccept(service);
+                testRequestP(service, s3, HTTP_VERB_GET, "/file.txt", .ifMatch = "\"AAA\"", .range = "9-16");
+                testResponseP(service, .code = 206, .header = "connection:close", .content = "a sample");
+                hrnServerScriptClose(service);
+
+                hrnServerScriptAccept(service);
+                testRequestP(service, s3, HTTP_VERB_GET, "/file.txt", .ifMatch = "\"AAA\"", .range = "17-21");
+                testResponseP(service, .code = 206, .content = " file");
+
+                TEST_RESULT_STR_Z(
+                    strNewBuf(storageGetP(storageNewReadP(s3, STRDEF("file.txt"), .offset = 1, .limit = VARUINT64(21)))),
+                    "this is a sample file", "get file");
+
+                // -----------------------------------------------------------------------------------------------------------------
+                TEST_TITLE("error when file is replaced during ranged requests");
+
+                driver->downloadChunkSize = 16;
+
+                testRequestP(service, s3, HTTP_VERB_GET, "/file.txt", .range = "1-21");
+                testResponseP(service, .header = "etag:\"AAA\"", .content = "this is a sample file");
+                hrnServerScriptClose(service);
+
+                hrnServerScriptAccept(service);
+                testRequestP(service, s3, HTTP_VERB_GET, "/file.txt", .ifMatch = "\"AAA\"", .range = "17-21");
+                testResponseP(service, .code = 412);
+
+                TEST_ERROR(
+                    storageGetP(storageNewReadP(s3, STRDEF("file.txt"), .offset = 1, .limit = VARUINT64(21))), ProtocolError,
+                    "HTTP request failed with 412:\n"
+                    "*** Path/Query ***:\n"
+                    "GET /file.txt\n"
+                    "*** Request Headers ***:\n"
+                    "authorization: <redacted>\n"
+                    "content-length: 0\n"
+                    "host: bucket." S3_TEST_HOST "\n"
+                    "if-match: \"AAA\"\n"
+                    "range: bytes=17-21\n"
+                    "x-amz-content-sha256: e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855\n"
+                    "x-amz-date: <redacted>\n"
+                    "x-amz-security-token: <redacted>");
+
+                driver->downloadMax = 1;
+
                 // -----------------------------------------------------------------------------------------------------------------
                 TEST_TITLE("get zero-length file");
 
@@ -302,6 +302,7 @@ testRun(void)
                         "        lib_lz4,\n"
                         "        lib_pq,\n"
                         "        lib_ssh2,\n"
+                        "        lib_thread,\n"
                         "        lib_xml,\n"
                         "        lib_yaml,\n"
                         "        lib_z,\n"
@@ -425,6 +426,7 @@ testRun(void)
                         "        lib_lz4,\n"
                         "        lib_pq,\n"
                         "        lib_ssh2,\n"
+                        "        lib_thread,\n"
                         "        lib_xml,\n"
                         "        lib_yaml,\n"
                         "        lib_z,\n"
@@ -643,6 +645,7 @@ testRun(void)
                         "        lib_lz4,\n"
                         "        lib_pq,\n"
                         "        lib_ssh2,\n"
+                        "        lib_thread,\n"
                         "        lib_xml,\n"
                         "        lib_yaml,\n"
                         "        lib_z,\n"
@@ -805,6 +808,7 @@ testRun(void)
                         "        lib_lz4,\n"
                         "        lib_pq,\n"
                         "        lib_ssh2,\n"
+                        "        lib_thread,\n"
                         "        lib_xml,\n"
                         "        lib_yaml,\n"
                         "        lib_z,\n"
@@ -966,6 +970,7 @@ testRun(void)
                         "        lib_lz4,\n"
                         "        lib_pq,\n"
                         "        lib_ssh2,\n"
+                        "        lib_thread,\n"
                         "        lib_xml,\n"
                         "        lib_yaml,\n"
                         "        lib_z,\n"